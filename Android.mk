@@ -370,6 +370,12 @@ LOCAL_CFLAGS += -DENABLE_ANDROID_JSC_JIT=1
 endif
 endif
 
+# Use the thread-caching FastMalloc instead of the system malloc if the
+# ENABLE_FAST_MALLOC environment variable is set to true
+ifeq ($(ENABLE_FAST_MALLOC),true)
+LOCAL_CFLAGS += -DANDROID_FAST_MALLOC=1
+endif
+
 ifeq ($(TARGET_ARCH),arm)
 LOCAL_CFLAGS += -Darm
 # remove this warning: "note: the mangling of 'va_list' has changed in GCC 4.4"
@@ -439,8 +445,10 @@ LOCAL_SHARED_LIBRARIES := \
 	libicui18n \
 	libmedia \
 	libEGL \
+	libETC1 \
 	libGLESv2 \
 	libgui \
+	libjpeg \
 	libz
 
 ifeq ($(PLATFORM_VERSION),3.1.4.1.5.9.2.6.5)
@@ -463,7 +471,7 @@ ifeq ($(SUPPORT_COMPLEX_SCRIPTS),true)
 LOCAL_C_INCLUDES := $(LOCAL_C_INCLUDES) \
 	external/harfbuzz/src \
 	external/harfbuzz/contrib
-LOCAL_SHARED_LIBRARIES += libharfbuzz libjpeg
+LOCAL_SHARED_LIBRARIES += libharfbuzz
 LOCAL_CFLAGS += -DSUPPORT_COMPLEX_SCRIPTS=1
 endif
 
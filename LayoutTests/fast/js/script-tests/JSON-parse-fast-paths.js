@@ -0,0 +1,69 @@
+description("Tests JSON.parse on strings with and without escapes, on repeated property names and on integers of different lengths.");
+
+// Parses the text and serializes the result again, with non-ASCII
+// characters escaped so that the results are plain ASCII.
+function roundTrip(text)
+{
+    return JSON.stringify(JSON.parse(text)).replace(/[\u0080-\uffff]/g, function(character) {
+        return "\\u" + (0x10000 + character.charCodeAt(0)).toString(16).substring(1);
+    });
+}
+
+function parseFails(text)
+{
+    try {
+        JSON.parse(text);
+    } catch (e) {
+        return e instanceof SyntaxError;
+    }
+    return false;
+}
+
+function shouldRoundTrip(text, expected)
+{
+    shouldBe("roundTrip(" + JSON.stringify(text) + ")", JSON.stringify(expected));
+}
+
+debug("Strings:");
+shouldRoundTrip('"abc"', '"abc"');
+shouldRoundTrip('""', '""');
+shouldRoundTrip('["abc", "", "d"]', '["abc","","d"]');
+shouldRoundTrip('"a\\nb"', '"a\\nb"');
+shouldRoundTrip('"\\"ab"', '"\\"ab"');
+shouldRoundTrip('"ab\\\\"', '"ab\\\\"');
+shouldRoundTrip('"\\u0041b\\u0063"', '"Abc"');
+shouldBe("roundTrip('\"caf\\u00e9 \\u2603\"')", "'\"caf\\\\u00e9 \\\\u2603\"'");
+shouldBe("JSON.parse('\"abc\"').length", "3");
+shouldBe("JSON.parse('[\"xyz\"]')[0].charAt(2)", "'z'");
+shouldBeTrue("parseFails('\"abc')");
+shouldBeTrue("parseFails('\"a\\nb\"')");
+shouldBeTrue("parseFails('\"a\\\\qb\"')");
+
+debug("");
+debug("Property names:");
+shouldRoundTrip('{"a":1,"b":2,"a":3}', '{"a":3,"b":2}');
+shouldRoundTrip('[{"ab":1,"ac":2,"b":3},{"ab":4,"ac":5,"b":6}]', '[{"ab":1,"ac":2,"b":3},{"ab":4,"ac":5,"b":6}]');
+shouldRoundTrip('[{"name":1,"nick":2},{"nick":3,"name":4}]', '[{"name":1,"nick":2},{"nick":3,"name":4}]');
+shouldRoundTrip('{"":1,"x":2}', '{"":1,"x":2}');
+shouldRoundTrip('{"a\\u0062":1,"ab":2}', '{"ab":2}');
+shouldBe("roundTrip('{\"\\u00e9t\\u00e9\":1,\"\\u00e9\":2}')", "'{\"\\\\u00e9t\\\\u00e9\":1,\"\\\\u00e9\":2}'");
+shouldRoundTrip('{"0":"a","1":"b"}', '{"0":"a","1":"b"}');
+shouldBe("JSON.parse('[{\"ab\":1},{\"ac\":2}]')[1].ab", "undefined");
+shouldBe("JSON.parse('[{\"ab\":1},{\"ac\":2}]')[1].ac", "2");
+
+debug("");
+debug("Numbers:");
+shouldRoundTrip('[0,7,-7,42]', '[0,7,-7,42]');
+shouldRoundTrip('[123456789,999999999,-999999999]', '[123456789,999999999,-999999999]');
+shouldRoundTrip('[1000000000,-1000000000,2147483647,2147483648,4294967296]', '[1000000000,-1000000000,2147483647,2147483648,4294967296]');
+shouldRoundTrip('[12345678901234567890]', '[12345678901234567000]');
+shouldRoundTrip('[1.5,-0.25,10.0,1e3,12E-1,5e+0]', '[1.5,-0.25,10,1000,1.2,5]');
+shouldBe("JSON.parse('-0')", "-0");
+shouldBe("JSON.parse('0')", "0");
+shouldBe("JSON.parse('[999999999]')[0] + 1", "1000000000");
+shouldBeTrue("parseFails('01')");
+shouldBeTrue("parseFails('-')");
+shouldBeTrue("parseFails('1.')");
+shouldBeTrue("parseFails('+1')");
+
+var successfullyParsed = true;
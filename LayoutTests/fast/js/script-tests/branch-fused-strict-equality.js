@@ -0,0 +1,74 @@
+description("Tests that strict equality and inequality give the same result when the comparison is fused with the branch that follows it as when it is not.");
+
+// Forward branches on a comparison into a temporary are fused.
+function ifStrictEqual(a, b)
+{
+    if (a === b)
+        return true;
+    return false;
+}
+
+function ifNotStrictEqual(a, b)
+{
+    if (a !== b)
+        return false;
+    return true;
+}
+
+function conditionalStrictEqual(a, b)
+{
+    return a === b ? true : false;
+}
+
+function logicalStrictEqual(a, b)
+{
+    return !!(a === b && b === a);
+}
+
+// Loop conditions branch backwards and are not fused.
+function doWhileNotStrictEqual(a, b)
+{
+    var count = 0;
+    do {
+        ++count;
+    } while (a !== b && count < 3);
+    return count === 1;
+}
+
+// A comparison stored in a variable is not fused either.
+function storedStrictEqual(a, b)
+{
+    var equal = a === b;
+    if (equal)
+        return true;
+    return false;
+}
+
+var functions = ["ifStrictEqual", "ifNotStrictEqual", "conditionalStrictEqual", "logicalStrictEqual", "doWhileNotStrictEqual", "storedStrictEqual"];
+
+var object = {};
+var pairs = [
+    ["1", "1", true],
+    ["1", "2", false],
+    ["1", "1.0", true],
+    ["0.5", "0.5", true],
+    ["0", "-0", true],
+    ["NaN", "NaN", false],
+    ["2147483647 + 1", "2147483648", true],
+    ["1", "'1'", false],
+    ["'ab'", "'a'.concat('b')", true],
+    ["null", "undefined", false],
+    ["undefined", "void 0", true],
+    ["true", "1", false],
+    ["object", "object", true],
+    ["object", "{}", false]
+];
+
+for (var i = 0; i < pairs.length; ++i) {
+    if (i)
+        debug("");
+    for (var j = 0; j < functions.length; ++j)
+        shouldBe(functions[j] + "(" + pairs[i][0] + ", " + pairs[i][1] + ")", "" + pairs[i][2]);
+}
+
+var successfullyParsed = true;
@@ -0,0 +1,96 @@
+description("Tests that running a regular expression again over the same string from the same offset gives the same result, and that match arrays answer property reads before and after they are filled in.");
+
+// The test harness runs regular expressions of its own, so the RegExp
+// statics are read right after each match.
+function lastMatchState()
+{
+    return [RegExp.lastMatch, RegExp.$1, RegExp.leftContext, RegExp.rightContext].join("|");
+}
+
+var re = /(a+)(b)?(c)/;
+var s = "xxaacyy";
+
+debug("Testing, then matching the same string:");
+var tested = re.test(s);
+var m = s.match(re);
+var state = lastMatchState();
+shouldBeTrue("tested");
+shouldBe("m.length", "4");
+shouldBe("m.index", "2");
+shouldBe("m.input", "s");
+shouldBe("m[0]", "'aac'");
+shouldBe("m[1]", "'aa'");
+shouldBeUndefined("m[2]");
+shouldBe("m[3]", "'c'");
+shouldBeUndefined("m[4]");
+shouldBe("state", "'aac|aa|xx|yy'");
+
+debug("");
+debug("The same expression over another string:");
+var t = "aaaac";
+s.match(re);
+m = t.match(re);
+state = lastMatchState();
+shouldBe("m[0]", "'aaaac'");
+shouldBe("m.index", "0");
+shouldBe("m.input", "t");
+shouldBe("state", "'aaaac|aaaa||'");
+
+debug("");
+debug("Another expression over the same string:");
+s.match(re);
+m = s.match(/(x)(a)/);
+shouldBe("m[0]", "'xa'");
+shouldBe("m.length", "3");
+shouldBe("m.index", "1");
+
+debug("");
+debug("The same string from another offset:");
+var g = /a(.)/g;
+var u = "a1a2";
+var results = [];
+for (var i = 0; i < 4; ++i) {
+    var result = g.exec(u);
+    results.push((result ? result[1] : "null") + "@" + g.lastIndex);
+}
+shouldBe("results.join()", "'1@2,2@4,null@0,1@2'");
+shouldBe("u.replace(g, '$1')", "'12'");
+
+debug("");
+debug("A failed match is not reused:");
+var f = /z(.)/;
+s.match(re);
+var matched = f.test(s);
+state = lastMatchState();
+shouldBeFalse("matched");
+shouldBeNull("s.match(f)");
+shouldBe("state", "'aac|aa|xx|yy'");
+
+debug("");
+debug("Match arrays are filled in by other reads and by writes:");
+m = re.exec(s);
+shouldBe("m.join()", "'aac,aa,,c'");
+m = re.exec(s);
+shouldBeTrue("Object.keys(m).indexOf('input') != -1");
+m = re.exec(s);
+shouldBeTrue("m.hasOwnProperty('input')");
+shouldBeFalse("m.hasOwnProperty('4')");
+m = re.exec(s);
+m[1] = "changed";
+shouldBe("m[1]", "'changed'");
+shouldBe("m[0]", "'aac'");
+shouldBe("m.index", "2");
+m = re.exec(s);
+m.index = 7;
+shouldBe("m.index", "7");
+shouldBe("m[3]", "'c'");
+m = re.exec(s);
+m.length = 1;
+shouldBe("m.length", "1");
+shouldBeUndefined("m[1]");
+m = re.exec(s);
+m.extra = true;
+shouldBeTrue("m.extra");
+shouldBe("m.input", "s");
+
+var successfullyParsed = true;
@@ -0,0 +1,112 @@
+description("Tests reading characters from strings built by concatenation, before and after they are flattened, and joining arrays of strings.");
+
+var pieces = ["ab", "cd", "ef", "gh", "ij", "kl"];
+
+// Builds a new string out of the first count pieces each time it is
+// called, so that every test reads a string that was never flattened.
+function rope(count)
+{
+    var result = pieces[0];
+    for (var i = 1; i < count; ++i)
+        result += pieces[i];
+    return result;
+}
+
+function charAtAll(string)
+{
+    var result = [];
+    for (var i = 0; i < string.length; ++i)
+        result.push(string.charAt(i));
+    return result.join("");
+}
+
+function charCodeAtAll(string)
+{
+    var result = 0;
+    for (var i = 0; i < string.length; ++i)
+        result = result * 31 + string.charCodeAt(i) | 0;
+    return result;
+}
+
+function indexAll(string)
+{
+    var result = [];
+    for (var i = 0; i < string.length; ++i)
+        result.push(string[i]);
+    return result.join("");
+}
+
+function indexOfAll(string)
+{
+    var result = [];
+    for (var i = 0; i < string.length; ++i)
+        result.push(string.indexOf(string.charAt(i)));
+    return result.join();
+}
+
+// Ropes of up to four pieces are read in place, longer ones are flattened.
+for (var count = 2; count <= pieces.length; ++count) {
+    debug("");
+    debug("A string made of " + count + " pieces:");
+    var flat = pieces.slice(0, count).join("");
+    shouldBe("charAtAll(rope(" + count + "))", "'" + flat + "'");
+    shouldBe("indexAll(rope(" + count + "))", "'" + flat + "'");
+    shouldBe("charCodeAtAll(rope(" + count + "))", "charCodeAtAll('" + flat + "')");
+    shouldBe("indexOfAll(rope(" + count + "))", "indexOfAll('" + flat + "')");
+}
+
+debug("");
+debug("Out of range and non-integer positions:");
+shouldBe("rope(3).charAt(6)", "''");
+shouldBe("rope(3).charAt(-1)", "''");
+shouldBe("rope(3).charAt(1.5)", "'b'");
+shouldBe("rope(3).charAt('2')", "'c'");
+shouldBeNaN("rope(3).charCodeAt(6)");
+shouldBeNaN("rope(3).charCodeAt(-1)");
+shouldBe("rope(3).charCodeAt(4294967295)", "NaN");
+shouldBeUndefined("rope(3)[6]");
+shouldBe("rope(3).charAt()", "'a'");
+
+debug("");
+debug("Searching a string made of pieces:");
+shouldBe("rope(4).indexOf('e')", "4");
+shouldBe("rope(4).indexOf('e', 4)", "4");
+shouldBe("rope(4).indexOf('e', 5)", "-1");
+shouldBe("rope(4).indexOf('h', 3)", "7");
+shouldBe("rope(4).indexOf('z')", "-1");
+shouldBe("rope(4).indexOf('a', 100)", "-1");
+shouldBe("rope(4).indexOf('a', 4294967295)", "-1");
+shouldBe("rope(4).indexOf('a', -5)", "0");
+shouldBe("rope(4).indexOf('c', 2.5)", "2");
+shouldBe("rope(6).indexOf('k', 1)", "10");
+shouldBe("rope(4).indexOf('de')", "3");
+shouldBe("rope(4).indexOf('')", "0");
+shouldBe("rope(4).indexOf('', 3)", "3");
+
+debug("");
+debug("Appending and reading in a loop:");
+var built = "";
+var builtCharacters = "";
+for (var i = 0; i < 100; ++i) {
+    built += String.fromCharCode(65 + i % 26);
+    builtCharacters += built.charAt(i);
+}
+shouldBe("builtCharacters", "built");
+shouldBe("built.charCodeAt(99)", "86");
+shouldBe("built.indexOf('Z')", "25");
+
+debug("");
+debug("Joining arrays:");
+shouldBe("['ab', 'cd', 'ef'].join()", "'ab,cd,ef'");
+shouldBe("['ab', 'cd', 'ef'].join('')", "'abcdef'");
+shouldBe("['ab', 'cd', 'ef'].join('--')", "'ab--cd--ef'");
+shouldBe("['ab', rope(3), 'ef'].join(rope(2))", "'ababcdabcdefabcdef'");
+shouldBe("['ab', 1, 'ef'].join()", "'ab,1,ef'");
+shouldBe("['ab', null, undefined, 'ef'].join()", "'ab,,,ef'");
+shouldBe("['ab', , 'ef'].join()", "'ab,,ef'");
+shouldBe("['ab'].join('-')", "'ab'");
+shouldBe("[].join('-')", "''");
+shouldBe("['', ''].join()", "','");
+shouldBe("[{ toString: function() { return 'object'; } }, 'ab'].join()", "'object,ab'");
+
+var successfullyParsed = true;
@@ -0,0 +1,64 @@
+description("Tests regular expressions with back references. Case sensitive, unquantified back references are compiled; case insensitive and quantified ones use the interpreter, and both must agree.");
+
+// Describes a match as its index followed by the captures, so that an
+// undefined capture can be told from an empty one.
+function match(re, string)
+{
+    var result = re.exec(string);
+    if (!result)
+        return "null";
+    var captures = [];
+    for (var i = 0; i < result.length; ++i)
+        captures.push(result[i] === undefined ? "undefined" : "'" + result[i] + "'");
+    return result.index + ": " + captures.join(", ");
+}
+
+debug("Back references:");
+shouldBe("match(/(a)\\1/, 'aa')", "\"0: 'aa', 'a'\"");
+shouldBe("match(/(a)\\1/, 'xaab')", "\"1: 'aa', 'a'\"");
+shouldBe("match(/(a)\\1/, 'ab')", "'null'");
+shouldBe("match(/(a)\\1/, 'a')", "'null'");
+shouldBe("match(/(a+)\\1/, 'aaaaa')", "\"0: 'aaaa', 'aa'\"");
+shouldBe("match(/(a*)b\\1/, 'aabaa')", "\"0: 'aabaa', 'aa'\"");
+shouldBe("match(/(a*)b\\1/, 'aaba')", "\"1: 'aba', 'a'\"");
+shouldBe("match(/(\\w+)\\s+\\1\\b/, 'the the end')", "\"0: 'the the', 'the'\"");
+shouldBe("match(/(a)(b)\\2\\1/, 'xabba')", "\"1: 'abba', 'a', 'b'\"");
+shouldBe("match(/(a)\\1c|a/, 'aab')", "\"0: 'a', undefined\"");
+
+debug("");
+debug("Back references to subpatterns that did not take part in the match:");
+shouldBe("match(/(?:(a)|b)\\1/, 'b')", "\"0: 'b', undefined\"");
+shouldBe("match(/(?:(a)|b)\\1c/, 'abc')", "\"1: 'bc', undefined\"");
+shouldBe("match(/(?:(a)|b)\\1/, 'aa')", "\"0: 'aa', 'a'\"");
+shouldBe("match(/\\1(a)/, 'a')", "\"0: 'a', 'a'\"");
+shouldBe("match(/(a\\1)/, 'aa')", "\"0: 'a', 'a'\"");
+
+debug("");
+debug("Case insensitive back references:");
+shouldBe("match(/(a)\\1/i, 'aA')", "\"0: 'aA', 'a'\"");
+shouldBe("match(/(a)\\1/i, 'Aa')", "\"0: 'Aa', 'A'\"");
+shouldBe("match(/(a)\\1/i, 'ab')", "'null'");
+shouldBe("match(/(\\w+) \\1/i, 'Hello HELLO')", "\"0: 'Hello HELLO', 'Hello'\"");
+
+debug("");
+debug("Quantified back references:");
+shouldBe("match(/(a)\\1+/, 'aaab')", "\"0: 'aaa', 'a'\"");
+shouldBe("match(/(a)\\1*b/, 'ab')", "\"0: 'ab', 'a'\"");
+shouldBe("match(/(a)\\1{2}/, 'aaaa')", "\"0: 'aaa', 'a'\"");
+shouldBe("match(/([ab])\\1+?/, 'abb')", "\"1: 'bb', 'b'\"");
+
+debug("");
+debug("Compiled and interpreted back references agree where case does not matter:");
+var patterns = ["(1)\\1", "(1+)\\1", "(1*)2\\1", "(?:(1)|2)\\1", "(1)(2)\\2\\1", "(\\d)\\1-", "(1)\\1|1", "(.)\\1(.)\\2"];
+var inputs = ["11", "1111 2", "11211", "2", "12", "x1221", "3-33-", "1", "112233", ""];
+for (var i = 0; i < patterns.length; ++i) {
+    for (var j = 0; j < inputs.length; ++j) {
+        var compiled = match(new RegExp(patterns[i]), inputs[j]);
+        var interpreted = match(new RegExp(patterns[i], "i"), inputs[j]);
+        if (compiled !== interpreted)
+            testFailed("/" + patterns[i] + "/ on '" + inputs[j] + "' gave " + compiled + ", and " + interpreted + " when case insensitive");
+    }
+}
+testPassed("all " + patterns.length * inputs.length + " pairs agree");
+
+var successfullyParsed = true;
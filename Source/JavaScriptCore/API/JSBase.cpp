@@ -35,6 +35,7 @@
 #include <interpreter/CallFrame.h>
 #include <runtime/InitializeThreading.h>
 #include <runtime/Completion.h>
+#include <runtime/JSArray.h>
 #include <runtime/JSGlobalObject.h>
 #include <runtime/JSLock.h>
 #include <runtime/JSObject.h>
@@ -111,3 +112,45 @@ void JSReportExtraMemoryCost(JSContextRef ctx, size_t size)
     APIEntryShim entryShim(exec);
     exec->globalData().heap.reportExtraMemoryCost(size);
 }
+
+JSValueRef JSGetGarbageCollectionLog(JSContextRef ctx)
+{
+    ExecState* exec = toJS(ctx);
+    APIEntryShim entryShim(exec);
+
+    const Deque<GCEvent>& log = exec->globalData().heap.gcEventLog();
+    JSArray* result = constructEmptyArray(exec);
+    unsigned index = 0;
+    Deque<GCEvent>::const_iterator end = log.end();
+    for (Deque<GCEvent>::const_iterator it = log.begin(); it != end; ++it) {
+        JSObject* entry = constructEmptyObject(exec);
+        entry->putDirect(exec->globalData(), Identifier(exec, "isFullCollection"), jsBoolean(it->isFullCollection));
+        entry->putDirect(exec->globalData(), Identifier(exec, "startTime"), jsNumber(it->startTime * 1000));
+        entry->putDirect(exec->globalData(), Identifier(exec, "endTime"), jsNumber(it->endTime * 1000));
+        entry->putDirect(exec->globalData(), Identifier(exec, "conservativeScanTime"), jsNumber(it->conservativeScanTime * 1000));
+        entry->putDirect(exec->globalData(), Identifier(exec, "markTime"), jsNumber(it->markTime * 1000));
+        entry->putDirect(exec->globalData(), Identifier(exec, "weakHandleTime"), jsNumber(it->weakHandleTime * 1000));
+        entry->putDirect(exec->globalData(), Identifier(exec, "sweepTime"), jsNumber(it->sweepTime * 1000));
+        entry->putDirect(exec->globalData(), Identifier(exec, "sizeBefore"), jsNumber(it->sizeBefore));
+        entry->putDirect(exec->globalData(), Identifier(exec, "sizeAfter"), jsNumber(it->sizeAfter));
+        result->put(exec, index++, entry);
+    }
+    return toRef(exec, result);
+}
+
+JSValueRef JSGetHeapCensus(JSContextRef ctx)
+{
+    ExecState* exec = toJS(ctx);
+    APIEntryShim entryShim(exec);
+
+    OwnPtr<HeapCensus> census = exec->globalData().heap.census();
+    JSObject* result = constructEmptyObject(exec);
+    HeapCensus::iterator end = census->end();
+    for (HeapCensus::iterator it = census->begin(); it != end; ++it) {
+        JSObject* entry = constructEmptyObject(exec);
+        entry->putDirect(exec->globalData(), Identifier(exec, "count"), jsNumber(it->second.count));
+        entry->putDirect(exec->globalData(), Identifier(exec, "bytes"), jsNumber(it->second.bytes));
+        result->putDirect(exec->globalData(), Identifier(exec, it->first), entry);
+    }
+    return toRef(exec, result);
+}
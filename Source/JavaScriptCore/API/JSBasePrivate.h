@@ -45,6 +45,27 @@ region.
 */
 JS_EXPORT void JSReportExtraMemoryCost(JSContextRef ctx, size_t size) AVAILABLE_IN_WEBKIT_VERSION_4_0;
 
+/*!
+@function
+@abstract Gets a log of the garbage collector's most recent collections.
+@param ctx The execution context to use.
+@result An array of objects, oldest first. Each has the properties startTime,
+endTime, conservativeScanTime, markTime, weakHandleTime and sweepTime, in
+milliseconds; sizeBefore and sizeAfter, in bytes; and isFullCollection.
+*/
+JS_EXPORT JSValueRef JSGetGarbageCollectionLog(JSContextRef ctx) AVAILABLE_IN_WEBKIT_VERSION_4_0;
+
+/*!
+@function
+@abstract Counts the live objects in the JavaScript heap by class.
+@param ctx The execution context to use.
+@result An object mapping each class name to an object with the properties
+count and bytes.
+@discussion The census walks the whole heap, so it is meant for diagnostics.
+Objects that died since the last collection may still be counted.
+*/
+JS_EXPORT JSValueRef JSGetHeapCensus(JSContextRef ctx) AVAILABLE_IN_WEBKIT_VERSION_4_0;
+
 #ifdef __cplusplus
 }
 #endif
@@ -85,6 +85,7 @@ LOCAL_SRC_FILES := \
 	profiler/ProfileGenerator.cpp \
 	profiler/ProfileNode.cpp \
 	profiler/Profiler.cpp \
+	profiler/SamplingProfiler.cpp \
 	\
 	runtime/ArgList.cpp \
 	runtime/Arguments.cpp \
@@ -187,6 +188,7 @@ LOCAL_SRC_FILES := \
 	wtf/StackBounds.cpp \
 	wtf/TCSystemAlloc.cpp \
 	wtf/ThreadIdentifierDataPthreads.cpp \
+	wtf/ThreadPool.cpp \
 	wtf/Threading.cpp \
 	wtf/ThreadingPthreads.cpp \
 	wtf/TypeTraits.cpp \
@@ -1005,6 +1005,20 @@ void CodeBlock::dump(ExecState* exec, const Vector<Instruction>::const_iterator&
             printf("[%4d] jnlesseq\t\t %s, %s, %d(->%d)\n", location, registerName(exec, r0).data(), registerName(exec, r1).data(), offset, location + offset);
             break;
         }
+        case op_jstricteq: {
+            int r0 = (++it)->u.operand;
+            int r1 = (++it)->u.operand;
+            int offset = (++it)->u.operand;
+            printf("[%4d] jstricteq\t\t %s, %s, %d(->%d)\n", location, registerName(exec, r0).data(), registerName(exec, r1).data(), offset, location + offset);
+            break;
+        }
+        case op_jnstricteq: {
+            int r0 = (++it)->u.operand;
+            int r1 = (++it)->u.operand;
+            int offset = (++it)->u.operand;
+            printf("[%4d] jnstricteq\t\t %s, %s, %d(->%d)\n", location, registerName(exec, r0).data(), registerName(exec, r1).data(), offset, location + offset);
+            break;
+        }
         case op_loop_if_less: {
             int r0 = (++it)->u.operand;
             int r1 = (++it)->u.operand;
@@ -1379,6 +1393,10 @@ CodeBlock::CodeBlock(ScriptExecutable* ownerExecutable, CodeType codeType, JSGlo
     , m_codeType(codeType)
     , m_source(sourceProvider)
     , m_sourceOffset(sourceOffset)
+#if ENABLE(JIT)
+    , m_wasExecuted(0)
+    , m_jitCodeAge(0)
+#endif
     , m_symbolTable(symTab)
 {
     ASSERT(m_source);
@@ -1393,6 +1411,13 @@ CodeBlock::~CodeBlock()
 #if ENABLE(JIT)
     for (size_t size = m_structureStubInfos.size(), i = 0; i < size; ++i)
         m_structureStubInfos[i].deref();
+
+    for (size_t size = m_callLinkInfos.size(), i = 0; i < size; ++i) {
+        CallLinkInfo* callLinkInfo = &m_callLinkInfos[i];
+        if (callLinkInfo->calleeCodeBlock)
+            callLinkInfo->calleeCodeBlock->removeCaller(callLinkInfo);
+    }
+    unlinkCallers();
 #endif // ENABLE(JIT)
 
 #if DUMP_CODE_BLOCK_STATISTICS
@@ -1400,6 +1425,21 @@ CodeBlock::~CodeBlock()
 #endif
 }
 
+#if ENABLE(JIT)
+void CodeBlock::unlinkCallers()
+{
+    size_t size = m_linkedCallerList.size();
+    for (size_t i = 0; i < size; ++i) {
+        CallLinkInfo* currentCaller = m_linkedCallerList[i];
+#if ENABLE(JIT_OPTIMIZE_CALL)
+        JIT::unlinkCallOrConstruct(currentCaller);
+#endif
+        currentCaller->setUnlinked();
+    }
+    m_linkedCallerList.clear();
+}
+#endif
+
 void CodeBlock::markStructures(MarkStack& markStack, Instruction* vPC) const
 {
     Interpreter* interpreter = m_globalData->interpreter;
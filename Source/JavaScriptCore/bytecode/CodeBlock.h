@@ -59,6 +59,7 @@ namespace JSC {
         hasSeenShouldRepatch
     };
 
+    class CodeBlock;
     class ExecState;
 
     enum CodeType { GlobalCode, EvalCode, FunctionCode };
@@ -96,7 +97,10 @@ namespace JSC {
 #if ENABLE(JIT)
     struct CallLinkInfo {
         CallLinkInfo()
-            : hasSeenShouldRepatch(false)
+            : ownerCodeBlock(0)
+            , calleeCodeBlock(0)
+            , position(0)
+            , hasSeenShouldRepatch(false)
         {
         }
 
@@ -104,9 +108,19 @@ namespace JSC {
         CodeLocationDataLabelPtr hotPathBegin;
         CodeLocationNearCall hotPathOther;
         WriteBarrier<JSFunction> callee;
+        // The code block whose code this call is linked to, and where this
+        // call sits in that code block's list of linked callers. Native
+        // callees have no code block and are never unlinked.
+        CodeBlock* ownerCodeBlock;
+        CodeBlock* calleeCodeBlock;
+        unsigned position;
         bool hasSeenShouldRepatch;
         
-        void setUnlinked() { callee.clear(); }
+        void setUnlinked()
+        {
+            callee.clear();
+            calleeCodeBlock = 0;
+        }
         bool isLinked() { return callee; }
 
         bool seenOnce()
@@ -291,6 +305,45 @@ namespace JSC {
 #if ENABLE(JIT)
         JITCode& getJITCode() { return m_isConstructor ? ownerExecutable()->generatedJITCodeForConstruct() : ownerExecutable()->generatedJITCodeForCall(); }
         ExecutablePool* executablePool() { return getJITCode().getExecutablePool(); }
+        size_t jitCodeSize() { return getJITCode().size(); }
+
+        void addCaller(CallLinkInfo* caller)
+        {
+            caller->calleeCodeBlock = this;
+            caller->position = m_linkedCallerList.size();
+            m_linkedCallerList.append(caller);
+        }
+
+        void removeCaller(CallLinkInfo* caller)
+        {
+            unsigned pos = caller->position;
+            unsigned lastPos = m_linkedCallerList.size() - 1;
+            ASSERT(m_linkedCallerList[pos] == caller);
+            if (pos != lastPos) {
+                m_linkedCallerList[pos] = m_linkedCallerList[lastPos];
+                m_linkedCallerList[pos]->position = pos;
+            }
+            m_linkedCallerList.shrink(lastPos);
+        }
+
+        // Repatches every call linked to this code block back to the slow
+        // path, so that this code block's JIT code can be thrown away while
+        // the callers' code stays around.
+        void unlinkCallers();
+
+        // The JIT'd prologue of function code sets this every time the code
+        // runs; ageJITCode() clears it, and counts the passes in between
+        // which the code did not run.
+        void* addressOfWasExecuted() { return &m_wasExecuted; }
+        unsigned ageJITCode()
+        {
+            if (m_wasExecuted) {
+                m_wasExecuted = 0;
+                m_jitCodeAge = 0;
+            } else
+                ++m_jitCodeAge;
+            return m_jitCodeAge;
+        }
 #endif
 
         ScriptExecutable* ownerExecutable() const { return m_ownerExecutable.get(); }
@@ -520,6 +573,9 @@ namespace JSC {
         Vector<GlobalResolveInfo> m_globalResolveInfos;
         Vector<CallLinkInfo> m_callLinkInfos;
         Vector<MethodCallLinkInfo> m_methodCallLinkInfos;
+        Vector<CallLinkInfo*> m_linkedCallerList;
+        uint32_t m_wasExecuted;
+        unsigned m_jitCodeAge;
 #endif
 
         Vector<unsigned> m_jumpTargets;
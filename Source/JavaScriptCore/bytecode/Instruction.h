@@ -36,7 +36,7 @@
 #include "StructureChain.h"
 #include <wtf/VectorTraits.h>
 
-#define POLYMORPHIC_LIST_CACHE_SIZE 8
+#define POLYMORPHIC_LIST_CACHE_SIZE 16
 
 namespace JSC {
 
@@ -28,6 +28,7 @@
 #include "JSGlobalObject.h"
 #include "Parser.h"
 #include "Protect.h"
+#include "SamplingProfiler.h"
 
 namespace {
 
@@ -117,6 +118,11 @@ void Debugger::recompileAllJSFunctions(JSGlobalData* globalData)
     if (globalData->dynamicGlobalObject)
         return;
 
+#if ENABLE(SAMPLING_PROFILER)
+    if (globalData->samplingProfiler)
+        globalData->samplingProfiler->processSamples();
+#endif
+
     Recompiler recompiler(this);
     globalData->heap.forEach(recompiler);
 }
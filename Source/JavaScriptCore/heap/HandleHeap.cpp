@@ -67,6 +67,18 @@ void HandleHeap::markStrongHandles(HeapRootMarker& heapRootMarker)
         heapRootMarker.mark(node->slot());
 }
 
+// Eden collections cannot see wrappers that are only reachable through the
+// C++ object graph of an old wrapper, so they keep every weak referent alive
+// until the next full collection.
+void HandleHeap::markWeakHandlesAsRoots(HeapRootMarker& heapRootMarker)
+{
+    Node* end = m_weakList.end();
+    for (Node* node = m_weakList.begin(); node != end; node = node->next()) {
+        ASSERT(isValidWeakNode(node));
+        heapRootMarker.mark(node->slot());
+    }
+}
+
 void HandleHeap::markWeakHandles(HeapRootMarker& heapRootMarker)
 {
     MarkStack& markStack = heapRootMarker.markStack();
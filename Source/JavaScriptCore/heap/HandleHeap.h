@@ -63,6 +63,7 @@ public:
 
     void markStrongHandles(HeapRootMarker&);
     void markWeakHandles(HeapRootMarker&);
+    void markWeakHandlesAsRoots(HeapRootMarker&);
     void finalizeWeakHandles();
 
     void writeBarrier(HandleSlot, const JSValue&);
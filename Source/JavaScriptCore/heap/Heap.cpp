@@ -29,8 +29,10 @@
 #include "JSGlobalObject.h"
 #include "JSLock.h"
 #include "JSONObject.h"
+#include "SamplingProfiler.h"
 #include "Tracing.h"
 #include <algorithm>
+#include <wtf/CurrentTime.h>
 
 #define COLLECT_ON_EVERY_SLOW_ALLOCATION 0
 
@@ -47,9 +49,19 @@ Heap::Heap(JSGlobalData* globalData)
     , m_activityCallback(DefaultGCActivityCallback::create(this))
     , m_globalData(globalData)
     , m_machineThreads(this)
-    , m_markStack(globalData->jsArrayVPtr)
+    , m_sharedData(globalData->jsArrayVPtr)
+    , m_markStack(globalData->jsArrayVPtr, m_sharedData)
     , m_handleHeap(globalData)
     , m_extraCost(0)
+    , m_gcObserver(0)
+#if ENABLE(GGC)
+    , m_sizeAfterLastFullCollection(0)
+    , m_shouldDoFullCollection(true)
+#endif
+#if ENABLE(INCREMENTAL_GC)
+    , m_isMarkingIncrementally(false)
+    , m_sizeBeforeIncrementalMarking(0)
+#endif
 {
     m_markedSpace.setHighWaterMark(minBytesPerCycle);
     (*m_activityCallback)();
@@ -70,6 +82,12 @@ void Heap::destroy()
 
     ASSERT(!m_globalData->dynamicGlobalObject);
     ASSERT(m_operationInProgress == NoOperation);
+
+#if ENABLE(INCREMENTAL_GC)
+    // Leaves the mark stack empty and the mark bits complete for the sweep below.
+    if (m_isMarkingIncrementally)
+        reset(DoNotSweep);
+#endif
     
     // The global object is not GC protected at this point, so sweeping may delete it
     // (and thus the global data) before other objects that may use the global data.
@@ -119,7 +137,16 @@ void* Heap::allocateSlowCase(size_t bytes)
     ASSERT(m_operationInProgress == NoOperation);
 #endif
 
-    reset(DoNotSweep);
+#if ENABLE(INCREMENTAL_GC)
+    // A full collection that is due is begun rather than run. The mutator
+    // gets half as much room again to allocate in while marking proceeds in
+    // slices, and only finishes the collection here if it uses all of it.
+    if (!m_isMarkingIncrementally && m_shouldDoFullCollection) {
+        startIncrementalMarking();
+        m_markedSpace.setHighWaterMark(m_markedSpace.highWaterMark() + m_markedSpace.highWaterMark() / 2);
+    } else
+#endif
+        reset(DoNotSweep);
 
     m_operationInProgress = Allocation;
     void* result = m_markedSpace.allocate(bytes);
@@ -190,7 +217,88 @@ inline RegisterFile& Heap::registerFile()
     return m_globalData->interpreter->registerFile();
 }
 
-void Heap::markRoots()
+#if ENABLE(GGC)
+void Heap::addToRememberedSet(const JSCell* cell)
+{
+    ASSERT(m_operationInProgress != Collection);
+    m_rememberedSet.append(cell);
+}
+#endif
+
+#if ENABLE(INCREMENTAL_GC)
+class ChildrenAppender {
+public:
+    ChildrenAppender(MarkStack& markStack)
+        : m_markStack(markStack)
+    {
+    }
+
+    void operator()(JSCell* cell) { m_markStack.appendChildren(cell); }
+
+private:
+    MarkStack& m_markStack;
+};
+
+void Heap::startIncrementalMarking()
+{
+    ASSERT(!m_isMarkingIncrementally);
+    ASSERT(m_operationInProgress == NoOperation);
+    m_operationInProgress = Collection;
+
+    m_markedSpace.canonicalizeCellLivenessData();
+    m_sizeBeforeIncrementalMarking = m_markedSpace.size();
+    m_markedSpace.willStartIncrementalMarking();
+    m_markedSpace.clearMarks();
+    m_isMarkingIncrementally = true;
+
+    // The stacks change too quickly to be worth scanning now; markRoots()
+    // scans them, and every other root, again once marking is done.
+    HeapRootMarker heapRootMarker(m_markStack);
+    markProtectedObjects(heapRootMarker);
+    m_handleHeap.markStrongHandles(heapRootMarker);
+    m_markStack.drainUntil(0);
+
+    m_operationInProgress = NoOperation;
+
+    m_activityCallback->didStartIncrementalMarking();
+}
+
+// Sends the marker back to cells that were written to after it traced them.
+void Heap::revisitRememberedCells()
+{
+    for (size_t i = 0; i < m_rememberedSet.size(); ++i) {
+        const JSCell* cell = m_rememberedSet[i];
+        MarkedBlock::blockFor(cell)->forget(cell);
+        // A cell remembered before marking began that has not been reached
+        // yet will be traced in full if it is.
+        if (Heap::isMarked(cell))
+            m_markStack.appendChildren(cell);
+    }
+    m_rememberedSet.clear();
+}
+
+bool Heap::markIncrementally(double timeLimit)
+{
+    ASSERT(m_isMarkingIncrementally);
+    ASSERT(m_operationInProgress == NoOperation);
+    double deadline = currentTime() + timeLimit;
+
+    m_operationInProgress = Collection;
+    revisitRememberedCells();
+    bool hasMoreToMark = m_markStack.drainUntil(deadline);
+    m_operationInProgress = NoOperation;
+
+    if (hasMoreToMark)
+        return true;
+
+    // What is left is rescanning the roots and whatever changed since the
+    // last slice, which is short compared to marking the whole heap.
+    reset(DoSweep);
+    return false;
+}
+#endif
+
+void Heap::markRoots(CollectionType collectionType, GCEvent& event)
 {
 #ifndef NDEBUG
     if (m_globalData->isSharedInstance()) {
@@ -201,55 +309,96 @@ void Heap::markRoots()
 
     void* dummy;
 
+#if ENABLE(SAMPLING_PROFILER)
+    // Buffered samples refer to CodeBlocks that this collection may free.
+    if (m_globalData->samplingProfiler)
+        m_globalData->samplingProfiler->processSamples();
+#endif
+
     ASSERT(m_operationInProgress == NoOperation);
     if (m_operationInProgress != NoOperation)
         CRASH();
 
     m_operationInProgress = Collection;
 
+    m_markedSpace.canonicalizeCellLivenessData();
+#if ENABLE(INCREMENTAL_GC)
+    if (m_isMarkingIncrementally)
+        event.sizeBefore = m_sizeBeforeIncrementalMarking;
+    else
+#endif
+        event.sizeBefore = m_markedSpace.size();
+
     MarkStack& markStack = m_markStack;
     HeapRootMarker heapRootMarker(markStack);
     
     // We gather conservative roots before clearing mark bits because
     // conservative gathering uses the mark bits from our last mark pass to
     // determine whether a reference is valid.
+    double phaseStart = currentTime();
     ConservativeRoots machineThreadRoots(this);
     m_machineThreads.gatherConservativeRoots(machineThreadRoots, &dummy);
 
     ConservativeRoots registerFileRoots(this);
     registerFile().gatherConservativeRoots(registerFileRoots);
+    event.conservativeScanTime = currentTime() - phaseStart;
+    phaseStart = currentTime();
 
-    m_markedSpace.clearMarks();
+    if (collectionType == FullCollection) {
+#if ENABLE(INCREMENTAL_GC)
+        // Incremental marking cleared the marks when it began.
+        if (!m_isMarkingIncrementally)
+#endif
+            m_markedSpace.clearMarks();
+    }
+#if ENABLE(GGC)
+    else {
+        // Old cells keep their marks, so marking stops at them and only the
+        // young generation gets traced.
+        m_markedSpace.clearNewlyAllocatedMarks();
+    }
+#endif
 
+    // The strong roots are all pushed up front so that one parallel drain
+    // has enough work to spread across the marking threads.
     markStack.append(machineThreadRoots);
-    markStack.drain();
-
     markStack.append(registerFileRoots);
-    markStack.drain();
-
     markProtectedObjects(heapRootMarker);
-    markStack.drain();
-    
     markTempSortVectors(heapRootMarker);
-    markStack.drain();
-
     if (m_markListSet && m_markListSet->size())
         MarkedArgumentBuffer::markLists(heapRootMarker, *m_markListSet);
     if (m_globalData->exception)
         heapRootMarker.mark(&m_globalData->exception);
-    markStack.drain();
-
     m_handleHeap.markStrongHandles(heapRootMarker);
-    markStack.drain();
-
     m_handleStack.mark(heapRootMarker);
-    markStack.drain();
+#if ENABLE(INCREMENTAL_GC)
+    if (m_isMarkingIncrementally) {
+        // DOM wrappers report their opaque roots from the DOM tree, which
+        // may have been rearranged since they were visited.
+        markStack.revisitOpaqueRootOwners();
+        revisitRememberedCells();
+        // Cells allocated since marking began were never traced.
+        ChildrenAppender childrenAppender(markStack);
+        m_markedSpace.forEachCellAllocatedDuringIncrementalMarking(childrenAppender);
+    }
+#endif
+#if ENABLE(GGC)
+    if (collectionType == EdenCollection) {
+        m_handleHeap.markWeakHandlesAsRoots(heapRootMarker);
+        // Old cells that were handed a pointer to a young cell since the last collection.
+        for (size_t i = 0; i < m_rememberedSet.size(); ++i)
+            markStack.appendChildren(m_rememberedSet[i]);
+    }
+#endif
+    markStack.drainInParallel();
 
     // Mark the small strings cache as late as possible, since it will clear
     // itself if nothing else has marked it.
     // FIXME: Change the small strings cache to use Weak<T>.
     m_globalData->smallStrings.markChildren(heapRootMarker);
     markStack.drain();
+    event.markTime = currentTime() - phaseStart;
+    phaseStart = currentTime();
     
     // Weak handles must be marked last, because their owners use the set of
     // opaque roots to determine reachability.
@@ -257,11 +406,26 @@ void Heap::markRoots()
     do {
         lastOpaqueRootCount = markStack.opaqueRootCount();
         m_handleHeap.markWeakHandles(heapRootMarker);
-        markStack.drain();
+        markStack.drainInParallel();
     // If the set of opaque roots has grown, more weak handles may have become reachable.
     } while (lastOpaqueRootCount != markStack.opaqueRootCount());
+    event.weakHandleTime = currentTime() - phaseStart;
 
     markStack.reset();
+    m_sharedData.reset();
+
+#if ENABLE(INCREMENTAL_GC)
+    if (m_isMarkingIncrementally) {
+        m_markedSpace.didFinishIncrementalMarking();
+        m_isMarkingIncrementally = false;
+    }
+#endif
+
+#if ENABLE(GGC)
+    // Everything that survived is old from now on.
+    m_markedSpace.promoteNewlyAllocated();
+    m_rememberedSet.clear();
+#endif
 
     m_operationInProgress = NoOperation;
 }
@@ -311,7 +475,6 @@ public:
     PassOwnPtr<TypeCountSet> take();
     
 private:
-    const char* typeName(JSCell*);
     OwnPtr<TypeCountSet> m_typeCountSet;
 };
 
@@ -320,7 +483,7 @@ inline TypeCounter::TypeCounter()
 {
 }
 
-inline const char* TypeCounter::typeName(JSCell* cell)
+static inline const char* typeName(JSCell* cell)
 {
     if (cell->isString())
         return "string";
@@ -376,6 +539,40 @@ PassOwnPtr<TypeCountSet> Heap::objectTypeCounts()
     return typeCounter.take();
 }
 
+class CensusTaker {
+public:
+    CensusTaker();
+    void operator()(JSCell*);
+    PassOwnPtr<HeapCensus> take();
+
+private:
+    OwnPtr<HeapCensus> m_census;
+};
+
+inline CensusTaker::CensusTaker()
+    : m_census(new HeapCensus)
+{
+}
+
+inline void CensusTaker::operator()(JSCell* cell)
+{
+    HeapCensusEntry& entry = m_census->add(typeName(cell), HeapCensusEntry()).first->second;
+    entry.count++;
+    entry.bytes += MarkedBlock::blockFor(cell)->cellSize();
+}
+
+inline PassOwnPtr<HeapCensus> CensusTaker::take()
+{
+    return m_census.release();
+}
+
+PassOwnPtr<HeapCensus> Heap::census()
+{
+    CensusTaker censusTaker;
+    forEach(censusTaker);
+    return censusTaker.take();
+}
+
 bool Heap::isBusy()
 {
     return m_operationInProgress != NoOperation;
@@ -391,22 +588,55 @@ void Heap::reset(SweepToggle sweepToggle)
     ASSERT(globalData()->identifierTable == wtfThreadData().currentIdentifierTable());
     JAVASCRIPTCORE_GC_BEGIN();
 
-    markRoots();
+    GCEvent event;
+    event.startTime = currentTime();
+
+    CollectionType collectionType = FullCollection;
+#if ENABLE(GGC)
+    // Explicit collections are asked for to free memory, which only a full
+    // collection does reliably.
+    if (sweepToggle == DoNotSweep && !m_shouldDoFullCollection)
+        collectionType = EdenCollection;
+#endif
+#if ENABLE(INCREMENTAL_GC)
+    if (m_isMarkingIncrementally)
+        collectionType = FullCollection;
+#endif
+
+    event.isFullCollection = collectionType == FullCollection;
+
+    markRoots(collectionType, event);
+    double phaseStart = currentTime();
     m_handleHeap.finalizeWeakHandles();
+    event.weakHandleTime += currentTime() - phaseStart;
 
     JAVASCRIPTCORE_GC_MARKED();
 
     m_markedSpace.reset();
     m_extraCost = 0;
 
+#if ENABLE(JIT)
+    // Cells that were not marked may be swept from here on, and their
+    // Structures' addresses reused.
+    m_globalData->jitStubs->megamorphicCache().clear();
+#endif
+
 #if ENABLE(JSC_ZOMBIES)
     sweepToggle = DoSweep;
 #endif
 
+    phaseStart = currentTime();
     if (sweepToggle == DoSweep) {
+#if ENABLE(JSC_ZOMBIES)
         m_markedSpace.sweep();
+#endif
+        // Blocks with no live cells are released now. Dead cells in the rest
+        // are finalized by sweepIncrementally(), or by the allocator when it
+        // reuses them, so the pause only pays for marking.
         m_markedSpace.shrink();
+        m_markedSpace.scheduleSweep();
     }
+    event.sweepTime = currentTime() - phaseStart;
 
     // To avoid pathological GC churn in large heaps, we set the allocation high
     // water mark to be proportional to the current size of the heap. The exact
@@ -415,11 +645,39 @@ void Heap::reset(SweepToggle sweepToggle)
     size_t proportionalBytes = 2 * m_markedSpace.size();
     m_markedSpace.setHighWaterMark(max(proportionalBytes, minBytesPerCycle));
 
+#if ENABLE(GGC)
+    // Eden collections never free old cells, so once the old generation has
+    // doubled since the last full collection it is time to trace it again.
+    if (collectionType == FullCollection)
+        m_sizeAfterLastFullCollection = m_markedSpace.size();
+    m_shouldDoFullCollection = m_markedSpace.size() > 2 * m_sizeAfterLastFullCollection;
+#endif
+
+    event.sizeAfter = m_markedSpace.size();
+    event.endTime = currentTime();
+    recordGCEvent(event);
+
     JAVASCRIPTCORE_GC_END();
 
     (*m_activityCallback)();
 }
 
+void Heap::recordGCEvent(const GCEvent& event)
+{
+    if (m_gcEventLog.size() == gcEventLogCapacity)
+        m_gcEventLog.removeFirst();
+    m_gcEventLog.append(event);
+
+    if (m_gcObserver)
+        m_gcObserver->didCollect(event);
+}
+
+bool Heap::sweepIncrementally(double timeLimit)
+{
+    ASSERT(m_operationInProgress == NoOperation);
+    return m_markedSpace.sweepSomeBlocks(currentTime() + timeLimit);
+}
+
 void Heap::setActivityCallback(PassOwnPtr<GCActivityCallback> activityCallback)
 {
     m_activityCallback = activityCallback;
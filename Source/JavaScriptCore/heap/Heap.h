@@ -26,8 +26,10 @@
 #include "HandleStack.h"
 #include "MarkStack.h"
 #include "MarkedSpace.h"
+#include <wtf/Deque.h>
 #include <wtf/Forward.h>
 #include <wtf/HashCountedSet.h>
+#include <wtf/HashMap.h>
 #include <wtf/HashSet.h>
 
 namespace JSC {
@@ -51,6 +53,38 @@ namespace JSC {
 
     enum OperationInProgress { NoOperation, Allocation, Collection };
 
+    // One collection, as recorded in the heap's event log. Times are in
+    // seconds; the phase times add up to roughly endTime - startTime.
+    struct GCEvent {
+        bool isFullCollection;
+        double startTime;
+        double endTime;
+        double conservativeScanTime;
+        double markTime;
+        double weakHandleTime;
+        double sweepTime;
+        size_t sizeBefore;
+        size_t sizeAfter;
+    };
+
+    class GCObserver {
+    public:
+        virtual ~GCObserver() { }
+        virtual void didCollect(const GCEvent&) = 0;
+    };
+
+    struct HeapCensusEntry {
+        HeapCensusEntry()
+            : count(0)
+            , bytes(0)
+        {
+        }
+
+        size_t count;
+        size_t bytes;
+    };
+    typedef HashMap<const char*, HeapCensusEntry> HeapCensus;
+
     class Heap {
         WTF_MAKE_NONCOPYABLE(Heap);
     public:
@@ -76,6 +110,23 @@ namespace JSC {
         void* allocate(size_t);
         void collectAllGarbage();
 
+        // Finalizes dead cells left behind by collectAllGarbage() for at most
+        // timeLimit seconds. Returns true if there is more to do.
+        bool sweepIncrementally(double timeLimit);
+
+#if ENABLE(INCREMENTAL_GC)
+        // Once allocation makes a full collection due, its marking is spread
+        // out over calls to markIncrementally(), each of which marks for at
+        // most timeLimit seconds. The call that runs out of cells to mark
+        // finishes the collection and returns false.
+        bool isMarkingIncrementally() const { return m_isMarkingIncrementally; }
+        bool markIncrementally(double timeLimit);
+#endif
+
+#if ENABLE(GGC)
+        void addToRememberedSet(const JSCell*);
+#endif
+
         void reportExtraMemoryCost(size_t cost);
 
         void protect(JSValue);
@@ -91,6 +142,11 @@ namespace JSC {
         size_t protectedGlobalObjectCount();
         PassOwnPtr<TypeCountSet> protectedObjectTypeCounts();
         PassOwnPtr<TypeCountSet> objectTypeCounts();
+        PassOwnPtr<HeapCensus> census();
+
+        // The most recent collections, oldest first.
+        const Deque<GCEvent>& gcEventLog() const { return m_gcEventLog; }
+        void setGCObserver(GCObserver* observer) { m_gcObserver = observer; }
 
         void pushTempSortVector(Vector<ValueStringPair>*);
         void popTempSortVector(Vector<ValueStringPair>*);
@@ -109,16 +165,24 @@ namespace JSC {
 
         static const size_t minExtraCost = 256;
         static const size_t maxExtraCost = 1024 * 1024;
+        static const size_t gcEventLogCapacity = 64;
 
         void* allocateSlowCase(size_t);
         void reportExtraMemoryCostSlowCase(size_t);
 
-        void markRoots();
+        enum CollectionType { EdenCollection, FullCollection };
+        void markRoots(CollectionType, GCEvent&);
         void markProtectedObjects(HeapRootMarker&);
         void markTempSortVectors(HeapRootMarker&);
 
         enum SweepToggle { DoNotSweep, DoSweep };
         void reset(SweepToggle);
+        void recordGCEvent(const GCEvent&);
+
+#if ENABLE(INCREMENTAL_GC)
+        void startIncrementalMarking();
+        void revisitRememberedCells();
+#endif
 
         RegisterFile& registerFile();
 
@@ -135,11 +199,25 @@ namespace JSC {
         JSGlobalData* m_globalData;
         
         MachineThreads m_machineThreads;
+        MarkStackThreadSharedData m_sharedData;
         MarkStack m_markStack;
         HandleHeap m_handleHeap;
         HandleStack m_handleStack;
 
         size_t m_extraCost;
+
+        Deque<GCEvent> m_gcEventLog;
+        GCObserver* m_gcObserver;
+
+#if ENABLE(GGC)
+        Vector<const JSCell*> m_rememberedSet;
+        size_t m_sizeAfterLastFullCollection;
+        bool m_shouldDoFullCollection;
+#endif
+#if ENABLE(INCREMENTAL_GC)
+        bool m_isMarkingIncrementally;
+        size_t m_sizeBeforeIncrementalMarking;
+#endif
     };
 
     inline bool Heap::isMarked(const JSCell* cell)
@@ -33,19 +33,118 @@
 #include "JSObject.h"
 #include "ScopeChain.h"
 #include "Structure.h"
+#include <algorithm>
+#include <wtf/CurrentTime.h>
+
+using namespace std;
 
 namespace JSC {
 
 size_t MarkStack::s_pageSize = 0;
 
+#if ENABLE(PARALLEL_GC)
+// Past a handful of threads, markers spend their time contending for the
+// shared stack rather than marking.
+static const size_t maximumNumberOfMarkingThreads = 4;
+
+// Handing out fewer cells than this costs more in locking than it saves.
+static const size_t minimumNumberOfCellsToDonate = 128;
+#endif
+
+MarkStackThreadSharedData::MarkStackThreadSharedData(void* jsArrayVPtr)
+#if ENABLE(PARALLEL_GC)
+    : m_jsArrayVPtr(jsArrayVPtr)
+    , m_numberOfActiveParallelMarkers(0)
+    , m_parallelMarkersShouldExit(false)
+#endif
+{
+#if ENABLE(PARALLEL_GC)
+    // The thread that triggers collection is always one of the markers.
+    size_t numberOfHelpers = min(MarkStack::numberOfProcessors(), maximumNumberOfMarkingThreads) - 1;
+    for (size_t i = 0; i < numberOfHelpers; ++i) {
+        if (ThreadIdentifier thread = createThread(markingThreadStartFunc, this, "JavaScriptCore::Marking"))
+            m_markingThreads.append(thread);
+    }
+#else
+    UNUSED_PARAM(jsArrayVPtr);
+#endif
+}
+
+MarkStackThreadSharedData::~MarkStackThreadSharedData()
+{
+#if ENABLE(PARALLEL_GC)
+    {
+        MutexLocker locker(m_markingLock);
+        m_parallelMarkersShouldExit = true;
+        m_markingCondition.broadcast();
+    }
+    for (size_t i = 0; i < m_markingThreads.size(); ++i)
+        waitForThreadCompletion(m_markingThreads[i], 0);
+#endif
+}
+
+void MarkStackThreadSharedData::reset()
+{
+#if ENABLE(PARALLEL_GC)
+    ASSERT(m_sharedMarkStack.isEmpty());
+    ASSERT(!m_numberOfActiveParallelMarkers);
+    m_sharedMarkStack.shrinkAllocation(MarkStack::pageSize());
+#endif
+    m_opaqueRoots.clear();
+}
+
+#if ENABLE(PARALLEL_GC)
+void* MarkStackThreadSharedData::markingThreadStartFunc(void* shared)
+{
+    static_cast<MarkStackThreadSharedData*>(shared)->markingThreadMain();
+    return 0;
+}
+
+void MarkStackThreadSharedData::markingThreadMain()
+{
+    MarkStack markStack(m_jsArrayVPtr, *this);
+    markStack.m_isInParallelMode = true;
+    markStack.drainFromShared(MarkStack::SlaveDrain);
+}
+#endif
+
 void MarkStack::reset()
 {
     ASSERT(s_pageSize);
+    ASSERT(m_opaqueRoots.isEmpty());
     m_values.shrinkAllocation(s_pageSize);
     m_markSets.shrinkAllocation(s_pageSize);
+}
+
+void MarkStack::mergeOpaqueRoots()
+{
+    if (m_opaqueRoots.isEmpty())
+        return;
+    {
+#if ENABLE(PARALLEL_GC)
+        MutexLocker locker(m_shared.m_opaqueRootsLock);
+#endif
+        HashSet<void*>::iterator end = m_opaqueRoots.end();
+        for (HashSet<void*>::iterator it = m_opaqueRoots.begin(); it != end; ++it)
+            m_shared.m_opaqueRoots.add(*it);
+    }
     m_opaqueRoots.clear();
 }
 
+// The two functions below are only used by the thread that started the
+// collection, after draining, when the other marking threads are idle.
+bool MarkStack::containsOpaqueRoot(void* root)
+{
+    mergeOpaqueRoots();
+    return m_shared.m_opaqueRoots.contains(root);
+}
+
+int MarkStack::opaqueRootCount()
+{
+    mergeOpaqueRoots();
+    return m_shared.m_opaqueRoots.size();
+}
+
 void MarkStack::append(ConservativeRoots& conservativeRoots)
 {
     JSCell** roots = conservativeRoots.roots();
@@ -54,6 +153,15 @@ void MarkStack::append(ConservativeRoots& conservativeRoots)
         internalAppend(roots[i]);
 }
 
+#if ENABLE(GGC)
+void MarkStack::appendChildren(const JSCell* cell)
+{
+    ASSERT(Heap::isMarked(cell));
+    if (cell->structure()->typeInfo().type() >= CompoundType)
+        m_values.append(const_cast<JSCell*>(cell));
+}
+#endif
+
 inline void MarkStack::markChildren(JSCell* cell)
 {
     ASSERT(Heap::isMarked(cell));
@@ -124,12 +232,151 @@ void MarkStack::drain()
 
             markChildren(cell);
         }
-        while (!m_values.isEmpty())
+        while (!m_values.isEmpty()) {
             markChildren(m_values.removeLast());
+#if ENABLE(PARALLEL_GC)
+            if (m_isInParallelMode)
+                donateKnownParallel();
+#endif
+        }
     }
 #if !ASSERT_DISABLED
     m_isDraining = false;
 #endif
 }
 
+#if ENABLE(INCREMENTAL_GC)
+bool MarkStack::drainUntil(double deadline)
+{
+    static const unsigned cellsPerDeadlineCheck = 100;
+
+    while (true) {
+        // Mark sets point into storage that the mutator may reallocate, so
+        // they are always finished before the slice ends.
+        while (!m_markSets.isEmpty()) {
+            MarkSet& current = m_markSets.last();
+            JSValue value = *current.m_values++;
+            if (current.m_values == current.m_end)
+                m_markSets.removeLast();
+
+            JSCell* cell;
+            if (!value || !value.isCell() || Heap::testAndSetMarked(cell = value.asCell()))
+                continue;
+            m_currentCell = cell;
+            markChildren(cell);
+            m_currentCell = 0;
+        }
+
+        if (m_values.isEmpty())
+            return false;
+
+        for (unsigned i = 0; i < cellsPerDeadlineCheck && !m_values.isEmpty() && m_markSets.isEmpty(); ++i) {
+            JSCell* cell = m_values.removeLast();
+            m_currentCell = cell;
+            markChildren(cell);
+            m_currentCell = 0;
+        }
+
+        if (m_markSets.isEmpty() && currentTime() >= deadline)
+            return !m_values.isEmpty();
+    }
+}
+
+void MarkStack::revisitOpaqueRootOwners()
+{
+    m_opaqueRoots.clear();
+    {
+#if ENABLE(PARALLEL_GC)
+        MutexLocker locker(m_shared.m_opaqueRootsLock);
+#endif
+        m_shared.m_opaqueRoots.clear();
+    }
+
+    // Nothing is swept while marking is in progress, so the owners are all
+    // still allocated, and they were marked when they were visited.
+    HashSet<const JSCell*>::iterator end = m_opaqueRootOwners.end();
+    for (HashSet<const JSCell*>::iterator it = m_opaqueRootOwners.begin(); it != end; ++it)
+        appendChildren(*it);
+    m_opaqueRootOwners.clear();
+}
+#endif
+
+void MarkStack::drainInParallel()
+{
+#if ENABLE(PARALLEL_GC)
+    if (!m_shared.m_markingThreads.isEmpty()) {
+        m_isInParallelMode = true;
+        drain();
+        drainFromShared(MasterDrain);
+        m_isInParallelMode = false;
+        return;
+    }
+#endif
+    drain();
+}
+
+#if ENABLE(PARALLEL_GC)
+void MarkStack::donateKnownParallel()
+{
+    if (m_values.size() < minimumNumberOfCellsToDonate)
+        return;
+
+    // Only give work away once the shared stack has run dry, which means some
+    // thread is idle or about to be. The unlocked read is just a hint.
+    if (!m_shared.m_sharedMarkStack.isEmpty())
+        return;
+    if (!m_shared.m_markingLock.tryLock())
+        return;
+    if (m_shared.m_sharedMarkStack.isEmpty()) {
+        m_values.transferHalfTo(m_shared.m_sharedMarkStack);
+        m_shared.m_markingCondition.broadcast();
+    }
+    m_shared.m_markingLock.unlock();
+}
+
+void MarkStack::drainFromShared(SharedDrainMode sharedDrainMode)
+{
+    {
+        MutexLocker locker(m_shared.m_markingLock);
+        m_shared.m_numberOfActiveParallelMarkers++;
+    }
+    while (true) {
+        // Publish our opaque roots before going idle, so that they are all in
+        // the shared set by the time the master sees marking terminate.
+        mergeOpaqueRoots();
+
+        {
+            MutexLocker locker(m_shared.m_markingLock);
+            m_shared.m_numberOfActiveParallelMarkers--;
+
+            if (sharedDrainMode == MasterDrain) {
+                while (true) {
+                    // Marking is done when nobody is working and nothing is left to steal.
+                    if (!m_shared.m_numberOfActiveParallelMarkers && m_shared.m_sharedMarkStack.isEmpty())
+                        return;
+                    if (!m_shared.m_sharedMarkStack.isEmpty())
+                        break;
+                    m_shared.m_markingCondition.wait(m_shared.m_markingLock);
+                }
+            } else {
+                ASSERT(sharedDrainMode == SlaveDrain);
+                // If we were the last one working, wake the master so it can notice.
+                if (!m_shared.m_numberOfActiveParallelMarkers && m_shared.m_sharedMarkStack.isEmpty())
+                    m_shared.m_markingCondition.broadcast();
+                while (m_shared.m_sharedMarkStack.isEmpty() && !m_shared.m_parallelMarkersShouldExit)
+                    m_shared.m_markingCondition.wait(m_shared.m_markingLock);
+                if (m_shared.m_parallelMarkersShouldExit)
+                    return;
+            }
+
+            // Take half of what is shared and leave the rest for other idle threads.
+            m_shared.m_sharedMarkStack.transferHalfTo(m_values);
+            m_shared.m_numberOfActiveParallelMarkers++;
+        }
+
+        drain();
+    }
+}
+#endif
+
 } // namespace JSC
@@ -33,11 +33,13 @@
 #include <wtf/Vector.h>
 #include <wtf/Noncopyable.h>
 #include <wtf/OSAllocator.h>
+#include <wtf/Threading.h>
 
 namespace JSC {
 
     class ConservativeRoots;
     class JSGlobalData;
+    class MarkStackThreadSharedData;
     class Register;
     
     enum MarkSetProperties { MayContainNullValues, NoNullValues };
@@ -45,8 +47,15 @@ namespace JSC {
     class MarkStack {
         WTF_MAKE_NONCOPYABLE(MarkStack);
     public:
-        MarkStack(void* jsArrayVPtr)
+        MarkStack(void* jsArrayVPtr, MarkStackThreadSharedData& shared)
             : m_jsArrayVPtr(jsArrayVPtr)
+            , m_shared(shared)
+#if ENABLE(PARALLEL_GC)
+            , m_isInParallelMode(false)
+#endif
+#if ENABLE(INCREMENTAL_GC)
+            , m_currentCell(0)
+#endif
 #if !ASSERT_DISABLED
             , m_isCheckingForDefaultMarkViolation(false)
             , m_isDraining(false)
@@ -58,6 +67,7 @@ namespace JSC {
         {
             ASSERT(m_markSets.isEmpty());
             ASSERT(m_values.isEmpty());
+            ASSERT(m_opaqueRoots.isEmpty());
         }
 
         void deprecatedAppend(JSCell**);
@@ -71,16 +81,35 @@ namespace JSC {
         }
         
         void append(ConservativeRoots&);
+#if ENABLE(GGC)
+        void appendChildren(const JSCell*); // Visits the children of a cell that is already marked.
+#endif
 
-        bool addOpaqueRoot(void* root) { return m_opaqueRoots.add(root).second; }
-        bool containsOpaqueRoot(void* root) { return m_opaqueRoots.contains(root); }
-        int opaqueRootCount() { return m_opaqueRoots.size(); }
+        bool addOpaqueRoot(void* root)
+        {
+#if ENABLE(INCREMENTAL_GC)
+            if (m_currentCell)
+                m_opaqueRootOwners.add(m_currentCell);
+#endif
+            return m_opaqueRoots.add(root).second;
+        }
+        bool containsOpaqueRoot(void* root);
+        int opaqueRootCount();
 
         void drain();
+        void drainInParallel(); // Like drain(), but shares the work with the heap's marking threads.
+#if ENABLE(INCREMENTAL_GC)
+        bool drainUntil(double deadline); // Returns true if there is more to do.
+        // Opaque roots found between slices may be stale by the final pause,
+        // since the DOM has no write barrier. This forgets them all and sends
+        // the marker back to every cell that reported one.
+        void revisitOpaqueRootOwners();
+#endif
         void reset();
 
     private:
         friend class HeapRootMarker; // Allowed to mark a JSValue* or JSCell** directly.
+        friend class MarkStackThreadSharedData;
         void append(JSValue*);
         void append(JSValue*, size_t count);
         void append(JSCell**);
@@ -89,6 +118,16 @@ namespace JSC {
         void internalAppend(JSValue);
         void markChildren(JSCell*);
 
+        void mergeOpaqueRoots();
+
+#if ENABLE(PARALLEL_GC)
+        enum SharedDrainMode { MasterDrain, SlaveDrain };
+        void drainFromShared(SharedDrainMode);
+        void donateKnownParallel();
+
+        static size_t numberOfProcessors();
+#endif
+
         struct MarkSet {
             MarkSet(JSValue* values, JSValue* end, MarkSetProperties properties)
                 : m_values(values)
@@ -164,6 +203,14 @@ namespace JSC {
 
             inline size_t size() { return m_top; }
 
+            // Moves the newest half of the entries, rounding up, onto another
+            // stack. This is how marking threads hand work to each other.
+            void transferHalfTo(MarkStackArray& other)
+            {
+                for (size_t count = (m_top + 1) / 2; count; --count)
+                    other.append(removeLast());
+            }
+
             inline void shrinkAllocation(size_t size)
             {
                 ASSERT(size <= m_allocated);
@@ -193,7 +240,17 @@ namespace JSC {
         MarkStackArray<MarkSet> m_markSets;
         MarkStackArray<JSCell*> m_values;
         static size_t s_pageSize;
-        HashSet<void*> m_opaqueRoots; // Handle-owning data structures not visible to the garbage collector.
+        HashSet<void*> m_opaqueRoots; // Merged into m_shared before anyone asks about them.
+        MarkStackThreadSharedData& m_shared;
+#if ENABLE(PARALLEL_GC)
+        bool m_isInParallelMode;
+#endif
+#if ENABLE(INCREMENTAL_GC)
+        // The cell drainUntil() is visiting, and the cells that have added
+        // opaque roots during incremental marking.
+        const JSCell* m_currentCell;
+        HashSet<const JSCell*> m_opaqueRootOwners;
+#endif
 
 #if !ASSERT_DISABLED
     public:
@@ -202,6 +259,39 @@ namespace JSC {
 #endif
     };
 
+    // State shared by all the threads that mark one Heap. Helper threads sleep
+    // on m_markingCondition until a parallel drain starts. During the drain each
+    // thread works from its own MarkStack and only takes m_markingLock to donate
+    // cells to, or steal cells from, m_sharedMarkStack.
+    class MarkStackThreadSharedData {
+        WTF_MAKE_NONCOPYABLE(MarkStackThreadSharedData);
+    public:
+        MarkStackThreadSharedData(void* jsArrayVPtr);
+        ~MarkStackThreadSharedData();
+
+        void reset();
+
+    private:
+        friend class MarkStack;
+
+#if ENABLE(PARALLEL_GC)
+        static void* markingThreadStartFunc(void*);
+        void markingThreadMain();
+
+        void* m_jsArrayVPtr;
+        Vector<ThreadIdentifier> m_markingThreads;
+
+        Mutex m_markingLock;
+        ThreadCondition m_markingCondition;
+        MarkStack::MarkStackArray<JSCell*> m_sharedMarkStack;
+        unsigned m_numberOfActiveParallelMarkers;
+        bool m_parallelMarkersShouldExit;
+
+        Mutex m_opaqueRootsLock;
+#endif
+        HashSet<void*> m_opaqueRoots; // Handle-owning data structures not visible to the garbage collector.
+    };
+
     inline void MarkStack::append(JSValue* slot, size_t count)
     {
         if (!count)
@@ -38,6 +38,14 @@ void MarkStack::initializePagesize()
     MarkStack::s_pageSize = getpagesize();
 }
 
+#if ENABLE(PARALLEL_GC)
+size_t MarkStack::numberOfProcessors()
+{
+    long result = sysconf(_SC_NPROCESSORS_ONLN);
+    return result > 0 ? result : 1;
+}
+#endif
+
 }
 
 #endif
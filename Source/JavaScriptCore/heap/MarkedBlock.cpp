@@ -49,8 +49,7 @@ void MarkedBlock::destroy(MarkedBlock* block)
 }
 
 MarkedBlock::MarkedBlock(const PageAllocationAligned& allocation, JSGlobalData* globalData, size_t cellSize)
-    : m_nextAtom(firstAtom())
-    , m_allocation(allocation)
+    : m_allocation(allocation)
     , m_heap(&globalData->heap)
     , m_prev(0)
     , m_next(0)
@@ -63,6 +62,50 @@ MarkedBlock::MarkedBlock(const PageAllocationAligned& allocation, JSGlobalData*
         new (&atoms()[i]) JSCell(*globalData, dummyMarkableCellStructure);
 }
 
+#if ENABLE(GGC)
+void MarkedBlock::rememberSlowCase(const void* p)
+{
+    m_heap->addToRememberedSet(static_cast<const JSCell*>(p));
+}
+#endif
+
+MarkedBlock::FreeCell* MarkedBlock::sweepToFreeList()
+{
+    FreeCell* head = 0;
+    FreeCell** tail = &head; // Appending keeps the list in address order.
+    for (size_t i = firstAtom(); i < m_endAtom; i += m_atomsPerCell) {
+        if (m_marks.testAndSet(i))
+            continue;
+#if ENABLE(GGC)
+        m_newlyAllocated.set(i);
+#endif
+        JSCell* cell = reinterpret_cast<JSCell*>(&atoms()[i]);
+        cell->~JSCell();
+        FreeCell* freeCell = reinterpret_cast<FreeCell*>(cell);
+        *tail = freeCell;
+        tail = &freeCell->next;
+    }
+    *tail = 0;
+    return head;
+}
+
+void MarkedBlock::canonicalizeFreeList(FreeCell* head)
+{
+    Structure* dummyMarkableCellStructure = m_heap->globalData()->dummyMarkableCellStructure.get();
+
+    FreeCell* next;
+    for (FreeCell* freeCell = head; freeCell; freeCell = next) {
+        ASSERT(blockFor(freeCell) == this);
+        next = freeCell->next;
+        size_t i = atomNumber(freeCell);
+        m_marks.clear(i);
+#if ENABLE(GGC)
+        m_newlyAllocated.clear(i);
+#endif
+        new (freeCell) JSCell(*m_heap->globalData(), dummyMarkableCellStructure);
+    }
+}
+
 void MarkedBlock::sweep()
 {
     Structure* dummyMarkableCellStructure = m_heap->globalData()->dummyMarkableCellStructure.get();
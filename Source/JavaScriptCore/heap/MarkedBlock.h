@@ -40,6 +40,11 @@ namespace JSC {
     public:
         static const size_t atomSize = sizeof(double); // Ensures natural alignment for all built-in types.
 
+        // Overlays the header of a dead cell while it waits on a free list.
+        struct FreeCell {
+            FreeCell* next;
+        };
+
         static MarkedBlock* create(JSGlobalData*, size_t cellSize);
         static void destroy(MarkedBlock*);
 
@@ -54,8 +59,11 @@ namespace JSC {
         MarkedBlock* prev() const;
         MarkedBlock* next() const;
         
-        void* allocate();
-        void reset();
+        // Finalizes the dead cells and threads them into a free list for the
+        // allocator. Cells on the list count as marked until they are handed
+        // back with canonicalizeFreeList().
+        FreeCell* sweepToFreeList();
+        void canonicalizeFreeList(FreeCell*);
         void sweep();
         
         bool isEmpty();
@@ -73,6 +81,26 @@ namespace JSC {
         bool isMarked(const void*);
         bool testAndSetMarked(const void*);
         void setMarked(const void*);
+
+#if ENABLE(GGC)
+        // A cell is young from its allocation until the next collection it
+        // survives. Old cells keep their mark bits across eden collections.
+        bool isNewlyAllocated(const void*);
+        void clearNewlyAllocatedMarks();
+        void promoteNewlyAllocated();
+
+        // Puts an old cell that now points at a young one in its heap's remembered set.
+        void remember(const void*);
+#endif
+#if ENABLE(INCREMENTAL_GC)
+        void forget(const void*); // Lets a cell be remembered again once its children have been revisited.
+
+        // Marking clears the mark bits the conservative scan relies on, so the
+        // cells that were alive when an incremental collection began are kept
+        // aside until it ends.
+        void snapshotMarks() { m_marksAtCycleStart = m_marks; }
+        void clearMarksSnapshot() { m_marksAtCycleStart.clearAll(); }
+#endif
         
         template <typename Functor> void forEach(Functor&);
 
@@ -89,10 +117,20 @@ namespace JSC {
         MarkedBlock(const PageAllocationAligned&, JSGlobalData*, size_t cellSize);
         Atom* atoms();
 
-        size_t m_nextAtom;
+#if ENABLE(GGC)
+        void rememberSlowCase(const void*);
+#endif
+
         size_t m_endAtom; // This is a fuzzy end. Always test for < m_endAtom.
         size_t m_atomsPerCell;
         WTF::Bitmap<blockSize / atomSize> m_marks;
+#if ENABLE(GGC)
+        WTF::Bitmap<blockSize / atomSize> m_newlyAllocated;
+        WTF::Bitmap<blockSize / atomSize> m_remembered;
+#endif
+#if ENABLE(INCREMENTAL_GC)
+        WTF::Bitmap<blockSize / atomSize> m_marksAtCycleStart;
+#endif
         PageAllocationAligned m_allocation;
         Heap* m_heap;
         MarkedBlock* m_prev;
@@ -144,11 +182,6 @@ namespace JSC {
         return m_next;
     }
 
-    inline void MarkedBlock::reset()
-    {
-        m_nextAtom = firstAtom();
-    }
-
     inline bool MarkedBlock::isEmpty()
     {
         return m_marks.isEmpty();
@@ -187,6 +220,10 @@ namespace JSC {
         // in a zombie state.
 
         ASSERT(p && isAtomAligned(p));
+#if ENABLE(INCREMENTAL_GC)
+        if (m_marksAtCycleStart.get(atomNumber(p)))
+            return true;
+#endif
         return isMarked(p);
     }
 
@@ -202,7 +239,12 @@ namespace JSC {
 
     inline bool MarkedBlock::testAndSetMarked(const void* p)
     {
+#if ENABLE(PARALLEL_GC)
+        // Marking threads race to set bits in the same bitmap word.
+        return m_marks.concurrentTestAndSet(atomNumber(p));
+#else
         return m_marks.testAndSet(atomNumber(p));
+#endif
     }
 
     inline void MarkedBlock::setMarked(const void* p)
@@ -210,6 +252,37 @@ namespace JSC {
         m_marks.set(atomNumber(p));
     }
 
+#if ENABLE(GGC)
+    inline bool MarkedBlock::isNewlyAllocated(const void* p)
+    {
+        return m_newlyAllocated.get(atomNumber(p));
+    }
+
+    inline void MarkedBlock::clearNewlyAllocatedMarks()
+    {
+        m_marks.exclude(m_newlyAllocated);
+    }
+
+    inline void MarkedBlock::promoteNewlyAllocated()
+    {
+        m_newlyAllocated.clearAll();
+        m_remembered.clearAll();
+    }
+
+    inline void MarkedBlock::remember(const void* p)
+    {
+        if (!m_remembered.testAndSet(atomNumber(p)))
+            rememberSlowCase(p);
+    }
+#endif
+
+#if ENABLE(INCREMENTAL_GC)
+    inline void MarkedBlock::forget(const void* p)
+    {
+        m_remembered.clear(atomNumber(p));
+    }
+#endif
+
     template <typename Functor> inline void MarkedBlock::forEach(Functor& functor)
     {
         for (size_t i = firstAtom(); i < m_endAtom; i += m_atomsPerCell) {
@@ -26,6 +26,7 @@
 #include "JSLock.h"
 #include "JSObject.h"
 #include "ScopeChain.h"
+#include <wtf/CurrentTime.h>
 
 namespace JSC {
 
@@ -35,6 +36,9 @@ MarkedSpace::MarkedSpace(JSGlobalData* globalData)
     : m_waterMark(0)
     , m_highWaterMark(0)
     , m_globalData(globalData)
+#if ENABLE(INCREMENTAL_GC)
+    , m_isMarkingIncrementally(false)
+#endif
 {
     for (size_t cellSize = preciseStep; cellSize < preciseCutoff; cellSize += preciseStep)
         sizeClassFor(cellSize).cellSize = cellSize;
@@ -45,6 +49,7 @@ MarkedSpace::MarkedSpace(JSGlobalData* globalData)
 
 void MarkedSpace::destroy()
 {
+    canonicalizeCellLivenessData();
     clearMarks();
     shrink();
     ASSERT(!size());
@@ -54,8 +59,11 @@ MarkedBlock* MarkedSpace::allocateBlock(SizeClass& sizeClass)
 {
     MarkedBlock* block = MarkedBlock::create(globalData(), sizeClass.cellSize);
     sizeClass.blockList.append(block);
-    sizeClass.nextBlock = block;
     m_blocks.add(block);
+#if ENABLE(INCREMENTAL_GC)
+    if (m_isMarkingIncrementally)
+        m_blocksAllocatedDuringIncrementalMarking.append(block);
+#endif
 
     return block;
 }
@@ -74,21 +82,46 @@ void MarkedSpace::freeBlocks(DoublyLinkedList<MarkedBlock>& blocks)
 
 void* MarkedSpace::allocateFromSizeClass(SizeClass& sizeClass)
 {
-    for (MarkedBlock*& block = sizeClass.nextBlock ; block; block = block->next()) {
-        if (void* result = block->allocate())
-            return result;
+    ASSERT(!sizeClass.firstFreeCell);
 
+    MarkedBlock::FreeCell* firstFreeCell = 0;
+    while (!firstFreeCell && sizeClass.nextBlock) {
+        MarkedBlock* block = sizeClass.nextBlock;
+        sizeClass.nextBlock = block->next();
         m_waterMark += block->capacity();
+        firstFreeCell = block->sweepToFreeList();
     }
 
-    if (m_waterMark < m_highWaterMark)
-        return allocateBlock(sizeClass)->allocate();
+    if (!firstFreeCell) {
+        if (m_waterMark >= m_highWaterMark)
+            return 0;
+        MarkedBlock* block = allocateBlock(sizeClass);
+        m_waterMark += block->capacity();
+        firstFreeCell = block->sweepToFreeList();
+        ASSERT(firstFreeCell);
+    }
+
+    sizeClass.firstFreeCell = firstFreeCell->next;
+    return firstFreeCell;
+}
+
+// Cells waiting on a free list are marked so that nothing reuses them. Before
+// anyone looks at mark bits to decide what is alive, they go back to being
+// ordinary free cells.
+void MarkedSpace::canonicalizeCellLivenessData()
+{
+    for (size_t cellSize = preciseStep; cellSize < preciseCutoff; cellSize += preciseStep)
+        sizeClassFor(cellSize).canonicalizeCellLivenessData();
 
-    return 0;
+    for (size_t cellSize = impreciseStep; cellSize < impreciseCutoff; cellSize += impreciseStep)
+        sizeClassFor(cellSize).canonicalizeCellLivenessData();
 }
 
 void MarkedSpace::shrink()
 {
+    // Some of the queued blocks may be about to go away.
+    m_blocksToSweep.clear();
+
     // We record a temporary list of empties to avoid modifying m_blocks while iterating it.
     DoublyLinkedList<MarkedBlock> empties;
 
@@ -114,6 +147,22 @@ void MarkedSpace::clearMarks()
         (*it)->clearMarks();
 }
 
+#if ENABLE(GGC)
+void MarkedSpace::clearNewlyAllocatedMarks()
+{
+    BlockIterator end = m_blocks.end();
+    for (BlockIterator it = m_blocks.begin(); it != end; ++it)
+        (*it)->clearNewlyAllocatedMarks();
+}
+
+void MarkedSpace::promoteNewlyAllocated()
+{
+    BlockIterator end = m_blocks.end();
+    for (BlockIterator it = m_blocks.begin(); it != end; ++it)
+        (*it)->promoteNewlyAllocated();
+}
+#endif
+
 void MarkedSpace::sweep()
 {
     BlockIterator end = m_blocks.end();
@@ -121,6 +170,55 @@ void MarkedSpace::sweep()
         (*it)->sweep();
 }
 
+void MarkedSpace::scheduleSweep()
+{
+    m_blocksToSweep.clear();
+    BlockIterator end = m_blocks.end();
+    for (BlockIterator it = m_blocks.begin(); it != end; ++it)
+        m_blocksToSweep.append(*it);
+}
+
+bool MarkedSpace::sweepSomeBlocks(double deadline)
+{
+    while (!m_blocksToSweep.isEmpty()) {
+        m_blocksToSweep.last()->sweep();
+        m_blocksToSweep.removeLast();
+        if (currentTime() >= deadline)
+            break;
+    }
+    return !m_blocksToSweep.isEmpty();
+}
+
+#if ENABLE(INCREMENTAL_GC)
+void MarkedSpace::willStartIncrementalMarking()
+{
+    ASSERT(!m_isMarkingIncrementally);
+    m_isMarkingIncrementally = true;
+    m_blocksToSweep.clear();
+
+    for (size_t cellSize = preciseStep; cellSize < preciseCutoff; cellSize += preciseStep)
+        sizeClassFor(cellSize).nextBlock = 0;
+
+    for (size_t cellSize = impreciseStep; cellSize < impreciseCutoff; cellSize += impreciseStep)
+        sizeClassFor(cellSize).nextBlock = 0;
+
+    BlockIterator end = m_blocks.end();
+    for (BlockIterator it = m_blocks.begin(); it != end; ++it)
+        (*it)->snapshotMarks();
+}
+
+void MarkedSpace::didFinishIncrementalMarking()
+{
+    ASSERT(m_isMarkingIncrementally);
+    m_isMarkingIncrementally = false;
+    m_blocksAllocatedDuringIncrementalMarking.clear();
+
+    BlockIterator end = m_blocks.end();
+    for (BlockIterator it = m_blocks.begin(); it != end; ++it)
+        (*it)->clearMarksSnapshot();
+}
+#endif
+
 size_t MarkedSpace::objectCount() const
 {
     size_t result = 0;
@@ -157,10 +255,6 @@ void MarkedSpace::reset()
 
     for (size_t cellSize = impreciseStep; cellSize < impreciseCutoff; cellSize += impreciseStep)
         sizeClassFor(cellSize).reset();
-
-    BlockIterator end = m_blocks.end();
-    for (BlockIterator it = m_blocks.begin(); it != end; ++it)
-        (*it)->reset();
 }
 
 } // namespace JSC
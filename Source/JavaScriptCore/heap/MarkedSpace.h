@@ -66,11 +66,30 @@ namespace JSC {
         void* allocate(size_t);
 
         void clearMarks();
+        void canonicalizeCellLivenessData();
+#if ENABLE(GGC)
+        void clearNewlyAllocatedMarks();
+        void promoteNewlyAllocated();
+#endif
         void markRoots();
         void reset();
         void sweep();
         void shrink();
 
+        // Queues every block for sweepSomeBlocks(). The allocator finalizes
+        // dead cells it reuses on its own, so this only hurries along the rest.
+        void scheduleSweep();
+        bool sweepSomeBlocks(double deadline); // Returns true if blocks remain.
+
+#if ENABLE(INCREMENTAL_GC)
+        // No block may be swept while marking is spread across the mutator's
+        // run, so the allocator only takes fresh blocks until it ends. Every
+        // cell they hand out counts as marked.
+        void willStartIncrementalMarking();
+        void didFinishIncrementalMarking();
+        template<typename Functor> void forEachCellAllocatedDuringIncrementalMarking(Functor&);
+#endif
+
         size_t size() const;
         size_t capacity() const;
         size_t objectCount() const;
@@ -95,7 +114,9 @@ namespace JSC {
         struct SizeClass {
             SizeClass();
             void reset();
+            void canonicalizeCellLivenessData();
 
+            MarkedBlock::FreeCell* firstFreeCell;
             MarkedBlock* nextBlock;
             DoublyLinkedList<MarkedBlock> blockList;
             size_t cellSize;
@@ -112,6 +133,11 @@ namespace JSC {
         SizeClass m_preciseSizeClasses[preciseCount];
         SizeClass m_impreciseSizeClasses[impreciseCount];
         HashSet<MarkedBlock*> m_blocks;
+        Vector<MarkedBlock*> m_blocksToSweep;
+#if ENABLE(INCREMENTAL_GC)
+        Vector<MarkedBlock*> m_blocksAllocatedDuringIncrementalMarking;
+        bool m_isMarkingIncrementally;
+#endif
         size_t m_waterMark;
         size_t m_highWaterMark;
         JSGlobalData* m_globalData;
@@ -151,22 +177,41 @@ namespace JSC {
 
     template <typename Functor> inline void MarkedSpace::forEach(Functor& functor)
     {
+        canonicalizeCellLivenessData();
         BlockIterator end = m_blocks.end();
         for (BlockIterator it = m_blocks.begin(); it != end; ++it)
             (*it)->forEach(functor);
     }
     
+#if ENABLE(INCREMENTAL_GC)
+    template <typename Functor> inline void MarkedSpace::forEachCellAllocatedDuringIncrementalMarking(Functor& functor)
+    {
+        for (size_t i = 0; i < m_blocksAllocatedDuringIncrementalMarking.size(); ++i)
+            m_blocksAllocatedDuringIncrementalMarking[i]->forEach(functor);
+    }
+#endif
+
     inline MarkedSpace::SizeClass::SizeClass()
-        : nextBlock(0)
+        : firstFreeCell(0)
+        , nextBlock(0)
         , cellSize(0)
     {
     }
 
     inline void MarkedSpace::SizeClass::reset()
     {
+        ASSERT(!firstFreeCell);
         nextBlock = blockList.head();
     }
 
+    inline void MarkedSpace::SizeClass::canonicalizeCellLivenessData()
+    {
+        if (!firstFreeCell)
+            return;
+        MarkedBlock::blockFor(firstFreeCell)->canonicalizeFreeList(firstFreeCell);
+        firstFreeCell = 0;
+    }
+
 } // namespace JSC
 
 #endif // MarkedSpace_h
@@ -713,6 +713,34 @@ NEVER_INLINE HandlerInfo* Interpreter::throwException(CallFrame*& callFrame, JSV
     return handler;
 }
 
+#if ENABLE(SAMPLING_PROFILER)
+// Publishes the frame a re-entry into JavaScript starts at for the sampling
+// profiler, and restores the caller's frame when the re-entry returns.
+class TopCallFrameSetter {
+public:
+    TopCallFrameSetter(JSGlobalData& globalData, CallFrame* callFrame)
+        : m_globalData(globalData)
+        , m_oldCallFrame(globalData.topCallFrame)
+    {
+        globalData.topCallFrame = callFrame;
+    }
+
+    ~TopCallFrameSetter()
+    {
+        m_globalData.topCallFrame = m_oldCallFrame;
+    }
+
+private:
+    JSGlobalData& m_globalData;
+    CallFrame* m_oldCallFrame;
+};
+#else
+class TopCallFrameSetter {
+public:
+    TopCallFrameSetter(JSGlobalData&, CallFrame*) { }
+};
+#endif
+
 static inline JSValue checkedReturn(JSValue returnValue)
 {
     ASSERT(returnValue);
@@ -760,6 +788,7 @@ JSValue Interpreter::execute(ProgramExecutable* program, CallFrame* callFrame, S
     JSValue result;
     {
         SamplingTool::CallRecord callRecord(m_sampler.get());
+        TopCallFrameSetter topCallFrameSetter(callFrame->globalData(), newCallFrame);
 
         m_reentryDepth++;  
 #if ENABLE(JIT)
@@ -831,6 +860,7 @@ JSValue Interpreter::executeCall(CallFrame* callFrame, JSObject* function, CallT
         JSValue result;
         {
             SamplingTool::CallRecord callRecord(m_sampler.get());
+            TopCallFrameSetter topCallFrameSetter(callFrame->globalData(), newCallFrame);
 
             m_reentryDepth++;  
 #if ENABLE(JIT)
@@ -920,6 +950,7 @@ JSObject* Interpreter::executeConstruct(CallFrame* callFrame, JSObject* construc
         JSValue result;
         {
             SamplingTool::CallRecord callRecord(m_sampler.get());
+            TopCallFrameSetter topCallFrameSetter(callFrame->globalData(), newCallFrame);
 
             m_reentryDepth++;  
 #if ENABLE(JIT)
@@ -1022,6 +1053,7 @@ JSValue Interpreter::execute(CallFrameClosure& closure)
     JSValue result;
     {
         SamplingTool::CallRecord callRecord(m_sampler.get());
+        TopCallFrameSetter topCallFrameSetter(*closure.globalData, closure.newCallFrame);
         
         m_reentryDepth++;  
 #if ENABLE(JIT)
@@ -1128,6 +1160,7 @@ JSValue Interpreter::execute(EvalExecutable* eval, CallFrame* callFrame, JSObjec
     JSValue result;
     {
         SamplingTool::CallRecord callRecord(m_sampler.get());
+        TopCallFrameSetter topCallFrameSetter(callFrame->globalData(), newCallFrame);
 
         m_reentryDepth++;
         
@@ -1215,6 +1248,9 @@ NEVER_INLINE void Interpreter::tryCachePutByID(CallFrame* callFrame, CodeBlock*
     Structure* structure = baseCell->structure();
 
     if (structure->isUncacheableDictionary()) {
+        // Cache against the flattened Structure next time; the slot's offset is stale now.
+        if (baseCell->isObject() && asObject(baseCell)->tryFlattenUncacheableDictionary(callFrame->globalData()))
+            return;
         vPC[0] = getOpcode(op_put_by_id_generic);
         return;
     }
@@ -1303,6 +1339,10 @@ NEVER_INLINE void Interpreter::tryCacheGetByID(CallFrame* callFrame, CodeBlock*
     Structure* structure = baseValue.asCell()->structure();
 
     if (structure->isUncacheableDictionary()) {
+        // Cache against the flattened Structure next time; the slot's offset is stale now.
+        JSCell* baseCell = baseValue.asCell();
+        if (baseCell->isObject() && asObject(baseCell)->tryFlattenUncacheableDictionary(callFrame->globalData()))
+            return;
         vPC[0] = getOpcode(op_get_by_id_generic);
         return;
     }
@@ -1480,6 +1520,12 @@ JSValue Interpreter::privateExecute(ExecutionFlag flag, RegisterFile* registerFi
     #define SAMPLE(codeBlock, vPC)
 #endif
 
+#if ENABLE(SAMPLING_PROFILER)
+    #define PUBLISH_CALL_FRAME() globalData->topCallFrame = callFrame
+#else
+    #define PUBLISH_CALL_FRAME()
+#endif
+
 #if ENABLE(COMPUTED_GOTO_INTERPRETER)
     #define NEXT_INSTRUCTION() SAMPLE(codeBlock, vPC); goto *vPC->u.opcode
 #if ENABLE(OPCODE_STATS)
@@ -3651,6 +3697,46 @@ skip_id_custom_self:
         vPC += OPCODE_LENGTH(op_jless);
         NEXT_INSTRUCTION();
     }
+    DEFINE_OPCODE(op_jstricteq) {
+        /* jstricteq src1(r) src2(r) target(offset)
+
+           Checks whether register src1 and register src2 are strictly
+           equal, as with the ECMAScript '===' operator, and then jumps to
+           offset target from the current instruction, if and only if the
+           result of the comparison is true.
+        */
+        JSValue src1 = callFrame->r(vPC[1].u.operand).jsValue();
+        JSValue src2 = callFrame->r(vPC[2].u.operand).jsValue();
+        int target = vPC[3].u.operand;
+
+        if (JSValue::strictEqual(callFrame, src1, src2)) {
+            vPC += target;
+            NEXT_INSTRUCTION();
+        }
+
+        vPC += OPCODE_LENGTH(op_jstricteq);
+        NEXT_INSTRUCTION();
+    }
+    DEFINE_OPCODE(op_jnstricteq) {
+        /* jnstricteq src1(r) src2(r) target(offset)
+
+           Checks whether register src1 and register src2 are strictly
+           equal, as with the ECMAScript '===' operator, and then jumps to
+           offset target from the current instruction, if and only if the
+           result of the comparison is false.
+        */
+        JSValue src1 = callFrame->r(vPC[1].u.operand).jsValue();
+        JSValue src2 = callFrame->r(vPC[2].u.operand).jsValue();
+        int target = vPC[3].u.operand;
+
+        if (!JSValue::strictEqual(callFrame, src1, src2)) {
+            vPC += target;
+            NEXT_INSTRUCTION();
+        }
+
+        vPC += OPCODE_LENGTH(op_jnstricteq);
+        NEXT_INSTRUCTION();
+    }
     DEFINE_OPCODE(op_jnlesseq) {
         /* jnlesseq src1(r) src2(r) target(offset)
 
@@ -3889,6 +3975,7 @@ skip_id_custom_self:
             }
 
             callFrame->init(newCodeBlock, vPC + OPCODE_LENGTH(op_call), callDataScopeChain, previousCallFrame, argCount, asFunction(v));
+            PUBLISH_CALL_FRAME();
             codeBlock = newCodeBlock;
             ASSERT(codeBlock == callFrame->codeBlock());
             vPC = newCodeBlock->instructions().begin();
@@ -4048,6 +4135,7 @@ skip_id_custom_self:
             }
 
             callFrame->init(newCodeBlock, vPC + OPCODE_LENGTH(op_call_varargs), callDataScopeChain, previousCallFrame, argCount, asFunction(v));
+            PUBLISH_CALL_FRAME();
             codeBlock = newCodeBlock;
             ASSERT(codeBlock == callFrame->codeBlock());
             vPC = newCodeBlock->instructions().begin();
@@ -4157,6 +4245,7 @@ skip_id_custom_self:
         if (callFrame->hasHostCallFrameFlag())
             return returnValue;
 
+        PUBLISH_CALL_FRAME();
         functionReturnValue = returnValue;
         codeBlock = callFrame->codeBlock();
         ASSERT(codeBlock == callFrame->codeBlock());
@@ -4198,6 +4287,7 @@ skip_id_custom_self:
         if (callFrame->hasHostCallFrameFlag())
             return returnValue;
 
+        PUBLISH_CALL_FRAME();
         functionReturnValue = returnValue;
         codeBlock = callFrame->codeBlock();
         ASSERT(codeBlock == callFrame->codeBlock());
@@ -4389,6 +4479,7 @@ skip_id_custom_self:
             }
 
             callFrame->init(newCodeBlock, vPC + OPCODE_LENGTH(op_construct), callDataScopeChain, previousCallFrame, argCount, asFunction(v));
+            PUBLISH_CALL_FRAME();
             codeBlock = newCodeBlock;
             vPC = newCodeBlock->instructions().begin();
 #if ENABLE(OPCODE_STATS)
@@ -4773,6 +4864,7 @@ skip_id_custom_self:
             return throwError(globalObject->globalExec(), exceptionValue);
         }
 
+        PUBLISH_CALL_FRAME();
         codeBlock = callFrame->codeBlock();
         vPC = codeBlock->instructions().begin() + handler->target;
         NEXT_INSTRUCTION();
@@ -4784,6 +4876,7 @@ skip_id_custom_self:
     #undef NEXT_INSTRUCTION
     #undef DEFINE_OPCODE
     #undef CHECK_FOR_EXCEPTION
+    #undef PUBLISH_CALL_FRAME
     #undef CHECK_FOR_TIMEOUT
 #endif // ENABLE(INTERPRETER)
 }
@@ -77,6 +77,12 @@ size_t ExecutableAllocator::committedByteCount()
     return 0;
 } 
 
+ExecutableAllocator::Statistics ExecutableAllocator::statistics()
+{
+    Statistics statistics = { 0, 0, 0 };
+    return statistics;
+}
+
 #endif
 
 #if ENABLE(ASSEMBLER_WX_EXCLUSIVE)
@@ -331,6 +331,16 @@ public:
 #endif
     static size_t committedByteCount();
 
+    struct Statistics {
+        size_t reservedBytes;
+        size_t committedBytes;
+        // The longest run of free pages left in the reservation. When it is
+        // much smaller than what is reserved but not committed, the pool is
+        // fragmented and large allocations may no longer fit.
+        size_t largestFreeBlock;
+    };
+    static Statistics statistics();
+
 private:
 
 #if ENABLE(ASSEMBLER_WX_EXCLUSIVE)
@@ -146,6 +146,19 @@ public:
         return !~m_allocated;
     }
 
+    size_t largestFreeBlock()
+    {
+        unsigned longestRun = 0;
+        unsigned currentRun = 0;
+        for (unsigned i = 0; i < entries; ++i) {
+            if (m_allocated & (1ull << i))
+                currentRun = 0;
+            else if (++currentRun > longestRun)
+                longestRun = currentRun;
+        }
+        return static_cast<size_t>(longestRun) << log2SubregionSize;
+    }
+
     static size_t size()
     {
         return regionSize;
@@ -213,6 +226,11 @@ public:
         return m_ptr && m_ptr->isFull();
     }
 
+    size_t largestFreeBlock()
+    {
+        return m_ptr ? m_ptr->largestFreeBlock() : size();
+    }
+
     static size_t size()
     {
         return NextLevel::size();
@@ -334,6 +352,29 @@ public:
         return !~m_full;
     }
 
+    size_t largestFreeBlock()
+    {
+        // Free runs are only counted within a single level, a run that
+        // straddles the edge of a partially allocated subregion is seen as
+        // two smaller ones, which is what the allocator would see as well.
+        size_t largestSuballocationBlock = 0;
+        unsigned longestRun = 0;
+        unsigned currentRun = 0;
+        BitField allocated = m_full | m_hasSuballocation;
+        for (unsigned i = 0; i < entries; ++i) {
+            BitField bit = 1ull << i;
+            if (!(allocated & bit)) {
+                if (++currentRun > longestRun)
+                    longestRun = currentRun;
+                continue;
+            }
+            currentRun = 0;
+            if ((m_hasSuballocation & bit) && !(m_full & bit))
+                largestSuballocationBlock = std::max(largestSuballocationBlock, m_suballocations[i].largestFreeBlock());
+        }
+        return std::max(largestSuballocationBlock, static_cast<size_t>(longestRun) << log2SubregionSize);
+    }
+
     static size_t size()
     {
         return regionSize;
@@ -455,6 +496,11 @@ public:
         return m_reservation.committed();
     }
 
+    size_t largestFreeBlock()
+    {
+        return m_pages.largestFreeBlock();
+    }
+
     bool isValid() const
     {
         return !!m_reservation;
@@ -491,6 +537,18 @@ size_t ExecutableAllocator::committedByteCount()
     return allocator ? allocator->allocated() : 0;
 }   
 
+ExecutableAllocator::Statistics ExecutableAllocator::statistics()
+{
+    SpinLockHolder lockHolder(&spinlock);
+    Statistics statistics = { 0, 0, 0 };
+    if (allocator && allocator->isValid()) {
+        statistics.reservedBytes = FixedVMPoolPageTables::size();
+        statistics.committedBytes = allocator->allocated();
+        statistics.largestFreeBlock = allocator->largestFreeBlock();
+    }
+    return statistics;
+}
+
 void ExecutableAllocator::intializePageSize()
 {
     ExecutableAllocator::pageSize = getpagesize();
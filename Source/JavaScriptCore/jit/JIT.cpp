@@ -250,7 +250,9 @@ void JIT::privateCompileMainPass()
         DEFINE_OP(op_jless)
         DEFINE_OP(op_jlesseq)
         DEFINE_OP(op_jnlesseq)
+        DEFINE_OP(op_jnstricteq)
         DEFINE_OP(op_jsr)
+        DEFINE_OP(op_jstricteq)
         DEFINE_OP(op_jtrue)
         DEFINE_OP(op_load_varargs)
         DEFINE_OP(op_loop)
@@ -406,6 +408,8 @@ void JIT::privateCompileSlowCases()
         DEFINE_SLOWCASE_OP(op_jless)
         DEFINE_SLOWCASE_OP(op_jlesseq)
         DEFINE_SLOWCASE_OP(op_jnlesseq)
+        DEFINE_SLOWCASE_OP(op_jnstricteq)
+        DEFINE_SLOWCASE_OP(op_jstricteq)
         DEFINE_SLOWCASE_OP(op_jtrue)
         DEFINE_SLOWCASE_OP(op_load_varargs)
         DEFINE_SLOWCASE_OP(op_loop_if_less)
@@ -480,6 +484,9 @@ JITCode JIT::privateCompile(CodePtr* functionEntryArityCheck)
         // In the case of a fast linked call, we do not set this up in the caller.
         emitPutImmediateToCallFrameHeader(m_codeBlock, RegisterFile::CodeBlock);
 
+        // Lets JSGlobalData::releaseColdJITCode() tell which code has run lately.
+        store32(TrustedImm32(1), m_codeBlock->addressOfWasExecuted());
+
         addPtr(Imm32(m_codeBlock->m_numCalleeRegisters * sizeof(Register)), callFrameRegister, regT1);
         registerFileCheck = branchPtr(Below, AbsoluteAddress(m_globalData->interpreter->registerFile().addressOfEnd()), regT1);
     }
@@ -573,6 +580,7 @@ JITCode JIT::privateCompile(CodePtr* functionEntryArityCheck)
 #if ENABLE(JIT_OPTIMIZE_CALL)
     for (unsigned i = 0; i < m_codeBlock->numberOfCallLinkInfos(); ++i) {
         CallLinkInfo& info = m_codeBlock->callLinkInfo(i);
+        info.ownerCodeBlock = m_codeBlock;
         info.callReturnLocation = patchBuffer.locationOfNearCall(m_callStructureStubCompilationInfo[i].callReturnLocation);
         info.hotPathBegin = patchBuffer.locationOf(m_callStructureStubCompilationInfo[i].hotPathBegin);
         info.hotPathOther = patchBuffer.locationOfNearCall(m_callStructureStubCompilationInfo[i].hotPathOther);
@@ -603,6 +611,8 @@ void JIT::linkCall(JSFunction* callee, CodeBlock* callerCodeBlock, CodeBlock* ca
     if (!calleeCodeBlock || (callerArgCount == calleeCodeBlock->m_numParameters)) {
         ASSERT(!callLinkInfo->isLinked());
         callLinkInfo->callee.set(*globalData, callerCodeBlock->ownerExecutable(), callee);
+        if (calleeCodeBlock)
+            calleeCodeBlock->addCaller(callLinkInfo);
         repatchBuffer.repatch(callLinkInfo->hotPathBegin, callee);
         repatchBuffer.relink(callLinkInfo->hotPathOther, code);
     }
@@ -620,6 +630,8 @@ void JIT::linkConstruct(JSFunction* callee, CodeBlock* callerCodeBlock, CodeBloc
     if (!calleeCodeBlock || (callerArgCount == calleeCodeBlock->m_numParameters)) {
         ASSERT(!callLinkInfo->isLinked());
         callLinkInfo->callee.set(*globalData, callerCodeBlock->ownerExecutable(), callee);
+        if (calleeCodeBlock)
+            calleeCodeBlock->addCaller(callLinkInfo);
         repatchBuffer.repatch(callLinkInfo->hotPathBegin, callee);
         repatchBuffer.relink(callLinkInfo->hotPathOther, code);
     }
@@ -627,6 +639,15 @@ void JIT::linkConstruct(JSFunction* callee, CodeBlock* callerCodeBlock, CodeBloc
     // patch the call so we do not continue to try to link.
     repatchBuffer.relink(callLinkInfo->callReturnLocation, globalData->jitStubs->ctiVirtualConstruct());
 }
+
+void JIT::unlinkCallOrConstruct(CallLinkInfo* callLinkInfo)
+{
+    // Make the hot path check fail from now on. The slow case has already
+    // been relinked to the virtual call stub, which picks up whatever code
+    // the callee has at the time of the call, compiling it if needed.
+    RepatchBuffer repatchBuffer(callLinkInfo->ownerCodeBlock);
+    repatchBuffer.repatch(callLinkInfo->hotPathBegin, 0);
+}
 #endif // ENABLE(JIT_OPTIMIZE_CALL)
 
 } // namespace JSC
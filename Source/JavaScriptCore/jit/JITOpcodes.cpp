@@ -1036,6 +1036,34 @@ void JIT::emit_op_nstricteq(Instruction* currentInstruction)
     compileOpStrictEq(currentInstruction, OpNStrictEq);
 }
 
+void JIT::compileOpStrictEqJump(Instruction* currentInstruction, CompileOpStrictEqType type)
+{
+    unsigned src1 = currentInstruction[1].u.operand;
+    unsigned src2 = currentInstruction[2].u.operand;
+    unsigned target = currentInstruction[3].u.operand;
+
+    emitGetVirtualRegisters(src1, regT0, src2, regT1);
+
+    // Jump to a slow case if either operand is a number, or if both are JSCell*s.
+    move(regT0, regT2);
+    orPtr(regT1, regT2);
+    addSlowCase(emitJumpIfJSCell(regT2));
+    addSlowCase(emitJumpIfImmediateNumber(regT2));
+
+    addJump(branchPtr(type == OpStrictEq ? Equal : NotEqual, regT1, regT0), target);
+    RECORD_JUMP_TARGET(target);
+}
+
+void JIT::emit_op_jstricteq(Instruction* currentInstruction)
+{
+    compileOpStrictEqJump(currentInstruction, OpStrictEq);
+}
+
+void JIT::emit_op_jnstricteq(Instruction* currentInstruction)
+{
+    compileOpStrictEqJump(currentInstruction, OpNStrictEq);
+}
+
 void JIT::emit_op_to_jsnumber(Instruction* currentInstruction)
 {
     int srcVReg = currentInstruction[2].u.operand;
@@ -1472,6 +1500,29 @@ void JIT::emitSlow_op_nstricteq(Instruction* currentInstruction, Vector<SlowCase
     stubCall.call(currentInstruction[1].u.operand);
 }
 
+void JIT::compileOpStrictEqJumpSlowCase(Instruction* currentInstruction, Vector<SlowCaseEntry>::iterator& iter, CompileOpStrictEqType type)
+{
+    unsigned target = currentInstruction[3].u.operand;
+
+    linkSlowCase(iter);
+    linkSlowCase(iter);
+    JITStubCall stubCall(this, cti_op_stricteq);
+    stubCall.addArgument(regT0);
+    stubCall.addArgument(regT1);
+    stubCall.call();
+    emitJumpSlowToHot(branchPtr(type == OpStrictEq ? Equal : NotEqual, regT0, TrustedImmPtr(JSValue::encode(jsBoolean(true)))), target);
+}
+
+void JIT::emitSlow_op_jstricteq(Instruction* currentInstruction, Vector<SlowCaseEntry>::iterator& iter)
+{
+    compileOpStrictEqJumpSlowCase(currentInstruction, iter, OpStrictEq);
+}
+
+void JIT::emitSlow_op_jnstricteq(Instruction* currentInstruction, Vector<SlowCaseEntry>::iterator& iter)
+{
+    compileOpStrictEqJumpSlowCase(currentInstruction, iter, OpNStrictEq);
+}
+
 void JIT::emitSlow_op_check_has_instance(Instruction* currentInstruction, Vector<SlowCaseEntry>::iterator& iter)
 {
     unsigned baseVal = currentInstruction[1].u.operand;
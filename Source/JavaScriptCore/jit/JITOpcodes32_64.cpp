@@ -1178,6 +1178,61 @@ void JIT::emitSlow_op_stricteq(Instruction* currentInstruction, Vector<SlowCaseE
     stubCall.call(dst);
 }
 
+void JIT::compileOpStrictEqJump(Instruction* currentInstruction, CompileOpStrictEqType type)
+{
+    unsigned src1 = currentInstruction[1].u.operand;
+    unsigned src2 = currentInstruction[2].u.operand;
+    unsigned target = currentInstruction[3].u.operand;
+
+    emitLoadTag(src1, regT0);
+    emitLoadTag(src2, regT1);
+
+    // Jump to a slow case if either operand is double, or if both operands are
+    // cells and/or Int32s.
+    move(regT0, regT2);
+    and32(regT1, regT2);
+    addSlowCase(branch32(Below, regT2, TrustedImm32(JSValue::LowestTag)));
+    addSlowCase(branch32(AboveOrEqual, regT2, TrustedImm32(JSValue::CellTag)));
+
+    addJump(branch32(type == OpStrictEq ? Equal : NotEqual, regT0, regT1), target);
+}
+
+void JIT::compileOpStrictEqJumpSlowCase(Instruction* currentInstruction, Vector<SlowCaseEntry>::iterator& iter, CompileOpStrictEqType type)
+{
+    unsigned src1 = currentInstruction[1].u.operand;
+    unsigned src2 = currentInstruction[2].u.operand;
+    unsigned target = currentInstruction[3].u.operand;
+
+    linkSlowCase(iter);
+    linkSlowCase(iter);
+
+    JITStubCall stubCall(this, cti_op_stricteq);
+    stubCall.addArgument(src1);
+    stubCall.addArgument(src2);
+    stubCall.call();
+    emitJumpSlowToHot(branchTest32(type == OpStrictEq ? NonZero : Zero, regT0), target);
+}
+
+void JIT::emit_op_jstricteq(Instruction* currentInstruction)
+{
+    compileOpStrictEqJump(currentInstruction, OpStrictEq);
+}
+
+void JIT::emitSlow_op_jstricteq(Instruction* currentInstruction, Vector<SlowCaseEntry>::iterator& iter)
+{
+    compileOpStrictEqJumpSlowCase(currentInstruction, iter, OpStrictEq);
+}
+
+void JIT::emit_op_jnstricteq(Instruction* currentInstruction)
+{
+    compileOpStrictEqJump(currentInstruction, OpNStrictEq);
+}
+
+void JIT::emitSlow_op_jnstricteq(Instruction* currentInstruction, Vector<SlowCaseEntry>::iterator& iter)
+{
+    compileOpStrictEqJumpSlowCase(currentInstruction, iter, OpNStrictEq);
+}
+
 void JIT::emit_op_nstricteq(Instruction* currentInstruction)
 {
     compileOpStrictEq(currentInstruction, OpNStrictEq);
@@ -820,6 +820,9 @@ NEVER_INLINE void JITThunks::tryCachePutByID(CallFrame* callFrame, CodeBlock* co
     Structure* structure = baseCell->structure();
 
     if (structure->isUncacheableDictionary()) {
+        // Cache against the flattened Structure next time; the slot's offset is stale now.
+        if (baseCell->isObject() && asObject(baseCell)->tryFlattenUncacheableDictionary(callFrame->globalData()))
+            return;
         ctiPatchCallByReturnAddress(codeBlock, returnAddress, FunctionPtr(direct ? cti_op_put_by_id_direct_generic : cti_op_put_by_id_generic));
         return;
     }
@@ -888,6 +891,9 @@ NEVER_INLINE void JITThunks::tryCacheGetByID(CallFrame* callFrame, CodeBlock* co
     Structure* structure = baseCell->structure();
 
     if (structure->isUncacheableDictionary()) {
+        // Cache against the flattened Structure next time; the slot's offset is stale now.
+        if (baseCell->isObject() && asObject(baseCell)->tryFlattenUncacheableDictionary(callFrame->globalData()))
+            return;
         ctiPatchCallByReturnAddress(codeBlock, returnAddress, FunctionPtr(cti_op_get_by_id_generic));
         return;
     }
@@ -1412,6 +1418,37 @@ DEFINE_STUB_FUNCTION(void, op_put_by_id_direct_generic)
     CHECK_FOR_EXCEPTION_AT_END();
 }
 
+// Sites that have given up on inline caching look own properties up in a
+// cache shared by every site, keyed on the base's Structure and the name.
+static JSValue getByIdThroughMegamorphicCache(CallFrame* callFrame, JSValue baseValue, const Identifier& propertyName)
+{
+#if ENABLE(SAMPLING_COUNTERS)
+    static SamplingCounter megamorphicCacheHits("get_by_id megamorphic cache hits");
+    static SamplingCounter megamorphicCacheMisses("get_by_id megamorphic cache misses");
+#endif
+    MegamorphicCache& cache = callFrame->globalData().jitStubs->megamorphicCache();
+
+    Structure* structure = baseValue.isCell() ? baseValue.asCell()->structure() : 0;
+    size_t offset;
+    if (structure && cache.get(structure, propertyName.impl(), offset)) {
+#if ENABLE(SAMPLING_COUNTERS)
+        megamorphicCacheHits.count();
+#endif
+        return asObject(baseValue)->getDirectOffset(offset);
+    }
+#if ENABLE(SAMPLING_COUNTERS)
+    megamorphicCacheMisses.count();
+#endif
+
+    PropertySlot slot(baseValue);
+    JSValue result = baseValue.get(callFrame, propertyName, slot);
+
+    // Dictionaries can change their layout without changing Structure.
+    if (structure && slot.isCacheableValue() && slot.slotBase() == baseValue && !structure->isDictionary())
+        cache.put(structure, propertyName.impl(), slot.cachedOffset());
+    return result;
+}
+
 DEFINE_STUB_FUNCTION(EncodedJSValue, op_get_by_id_generic)
 {
     STUB_INIT_STACK_FRAME(stackFrame);
@@ -1419,9 +1456,7 @@ DEFINE_STUB_FUNCTION(EncodedJSValue, op_get_by_id_generic)
     CallFrame* callFrame = stackFrame.callFrame;
     Identifier& ident = stackFrame.args[1].identifier();
 
-    JSValue baseValue = stackFrame.args[0].jsValue();
-    PropertySlot slot(baseValue);
-    JSValue result = baseValue.get(callFrame, ident, slot);
+    JSValue result = getByIdThroughMegamorphicCache(callFrame, stackFrame.args[0].jsValue(), ident);
 
     CHECK_FOR_EXCEPTION_AT_END();
     return JSValue::encode(result);
@@ -1640,8 +1675,13 @@ DEFINE_STUB_FUNCTION(EncodedJSValue, op_get_by_id_self_fail)
             stubInfo->u.getByIdSelfList.listSize++;
             JIT::compileGetByIdSelfList(callFrame->scopeChain()->globalData, codeBlock, stubInfo, polymorphicStructureList, listIndex, baseValue.asCell()->structure(), ident, slot, slot.cachedOffset());
 
-            if (listIndex == (POLYMORPHIC_LIST_CACHE_SIZE - 1))
+            if (listIndex == (POLYMORPHIC_LIST_CACHE_SIZE - 1)) {
+#if ENABLE(SAMPLING_COUNTERS)
+                static SamplingCounter megamorphicSelfSites("get_by_id self sites gone megamorphic");
+                megamorphicSelfSites.count();
+#endif
                 ctiPatchCallByReturnAddress(codeBlock, STUB_RETURN_ADDRESS, FunctionPtr(cti_op_get_by_id_generic));
+            }
         }
     } else
         ctiPatchCallByReturnAddress(callFrame->codeBlock(), STUB_RETURN_ADDRESS, FunctionPtr(cti_op_get_by_id_generic));
@@ -1752,8 +1792,13 @@ DEFINE_STUB_FUNCTION(EncodedJSValue, op_get_by_id_proto_list)
         if (listIndex < POLYMORPHIC_LIST_CACHE_SIZE) {
             JIT::compileGetByIdProtoList(callFrame->scopeChain()->globalData, callFrame, codeBlock, stubInfo, prototypeStructureList, listIndex, structure, slotBaseObject->structure(), propertyName, slot, offset);
 
-            if (listIndex == (POLYMORPHIC_LIST_CACHE_SIZE - 1))
+            if (listIndex == (POLYMORPHIC_LIST_CACHE_SIZE - 1)) {
+#if ENABLE(SAMPLING_COUNTERS)
+                static SamplingCounter megamorphicProtoSites("get_by_id prototype sites gone megamorphic");
+                megamorphicProtoSites.count();
+#endif
                 ctiPatchCallByReturnAddress(codeBlock, STUB_RETURN_ADDRESS, FunctionPtr(cti_op_get_by_id_proto_list_full));
+            }
         }
     } else if (size_t count = normalizePrototypeChain(callFrame, baseValue, slot.slotBase(), propertyName, offset)) {
         ASSERT(!baseValue.asCell()->structure()->isDictionary());
@@ -1764,8 +1809,13 @@ DEFINE_STUB_FUNCTION(EncodedJSValue, op_get_by_id_proto_list)
             StructureChain* protoChain = structure->prototypeChain(callFrame);
             JIT::compileGetByIdChainList(callFrame->scopeChain()->globalData, callFrame, codeBlock, stubInfo, prototypeStructureList, listIndex, structure, protoChain, count, propertyName, slot, offset);
 
-            if (listIndex == (POLYMORPHIC_LIST_CACHE_SIZE - 1))
+            if (listIndex == (POLYMORPHIC_LIST_CACHE_SIZE - 1)) {
+#if ENABLE(SAMPLING_COUNTERS)
+                static SamplingCounter megamorphicChainSites("get_by_id prototype chain sites gone megamorphic");
+                megamorphicChainSites.count();
+#endif
                 ctiPatchCallByReturnAddress(codeBlock, STUB_RETURN_ADDRESS, FunctionPtr(cti_op_get_by_id_proto_list_full));
+            }
         }
     } else
         ctiPatchCallByReturnAddress(codeBlock, STUB_RETURN_ADDRESS, FunctionPtr(cti_op_get_by_id_proto_fail));
@@ -32,6 +32,7 @@
 
 #include "CallData.h"
 #include "MacroAssemblerCodeRef.h"
+#include "MegamorphicCache.h"
 #include "Register.h"
 #include "ThunkGenerators.h"
 #include <wtf/HashMap.h>
@@ -301,6 +302,8 @@ namespace JSC {
 
         void clearHostFunctionStubs();
 
+        MegamorphicCache& megamorphicCache() { return m_megamorphicCache; }
+
     private:
         typedef HashMap<ThunkGenerator, MacroAssemblerCodePtr> CTIStubMap;
         CTIStubMap m_ctiStubMap;
@@ -309,6 +312,7 @@ namespace JSC {
         RefPtr<ExecutablePool> m_executablePool;
 
         TrampolineStructure m_trampolineStructure;
+        MegamorphicCache m_megamorphicCache;
     };
 
 extern "C" {
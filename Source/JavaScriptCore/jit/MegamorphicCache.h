@@ -0,0 +1,88 @@
+/*
+ * Copyright 2012, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef MegamorphicCache_h
+#define MegamorphicCache_h
+
+#if ENABLE(JIT)
+
+#include <string.h>
+#include <wtf/Forward.h>
+#include <wtf/Noncopyable.h>
+
+namespace JSC {
+
+class Structure;
+
+// A direct-mapped cache of (Structure, property name) -> storage offset for
+// own properties, consulted by get_by_id sites that have seen too many
+// structures to be worth specializing. Entries hold raw Structure pointers,
+// so the heap clears the cache before anything it marked dead can be reused.
+class MegamorphicCache {
+    WTF_MAKE_NONCOPYABLE(MegamorphicCache);
+public:
+    MegamorphicCache() { clear(); }
+
+    bool get(Structure* structure, StringImpl* name, size_t& offset) const
+    {
+        const Entry& entry = m_entries[index(structure, name)];
+        if (entry.structure != structure || entry.name != name)
+            return false;
+        offset = entry.offset;
+        return true;
+    }
+
+    void put(Structure* structure, StringImpl* name, size_t offset)
+    {
+        Entry& entry = m_entries[index(structure, name)];
+        entry.structure = structure;
+        entry.name = name;
+        entry.offset = offset;
+    }
+
+    void clear() { memset(m_entries, 0, sizeof(m_entries)); }
+
+private:
+    static const size_t numberOfEntries = 512;
+
+    static size_t index(Structure* structure, StringImpl* name)
+    {
+        return ((reinterpret_cast<uintptr_t>(structure) >> 4) ^ (reinterpret_cast<uintptr_t>(name) >> 3)) & (numberOfEntries - 1);
+    }
+
+    struct Entry {
+        Structure* structure;
+        StringImpl* name;
+        size_t offset;
+    };
+
+    Entry m_entries[numberOfEntries];
+};
+
+} // namespace JSC
+
+#endif // ENABLE(JIT)
+
+#endif // MegamorphicCache_h
@@ -33,6 +33,7 @@ using namespace JSC;
 #include "JSGlobalData.h"
 #include "NodeInfo.h"
 #include "ASTBuilder.h"
+#include "SamplingTool.h"
 #include "SourceProvider.h"
 #include "SourceProviderCacheItem.h"
 #include <wtf/HashFunctions.h>
@@ -1313,6 +1314,12 @@ template <JSParser::FunctionRequirements requirements, bool nameIsInContainingSc
 
     if (const SourceProviderCacheItem* cachedInfo = TreeBuilder::CanUseFunctionCache ? findCachedFunctionInfo(openBracePos) : 0) {
         // If we know about this function already, we can use the cached info and skip the parser to the end of the function.
+#if ENABLE(SAMPLING_COUNTERS)
+        static SamplingCounter skippedFunctionBodies("Function bodies skipped using the SourceProviderCache");
+        static SamplingCounter skippedCharacters("Characters skipped using the SourceProviderCache");
+        skippedFunctionBodies.count();
+        skippedCharacters.count(cachedInfo->closeBracePos - openBracePos);
+#endif
         body = context.createFunctionBody(strictMode());
 
         functionScope->restoreFunctionInfo(cachedInfo);
@@ -60,6 +60,11 @@ Profiler* Profiler::profiler()
     return s_sharedProfiler;
 }   
 
+unsigned Profiler::createProfileUID()
+{
+    return ++ProfilesUID;
+}
+
 void Profiler::startProfiling(ExecState* exec, const UString& title)
 {
     ASSERT_ARG(title, !title.isNull());
@@ -75,7 +80,7 @@ void Profiler::startProfiling(ExecState* exec, const UString& title)
     }
 
     s_sharedEnabledProfilerReference = this;
-    RefPtr<ProfileGenerator> profileGenerator = ProfileGenerator::create(exec, title, ++ProfilesUID);
+    RefPtr<ProfileGenerator> profileGenerator = ProfileGenerator::create(exec, title, createProfileUID());
     m_currentProfiles.append(profileGenerator);
 }
 
@@ -55,6 +55,7 @@ namespace JSC {
 
         static Profiler* profiler(); 
         static CallIdentifier createCallIdentifier(ExecState* exec, JSValue, const UString& sourceURL, int lineNumber);
+        static unsigned createProfileUID();
 
         void startProfiling(ExecState*, const UString& title);
         PassRefPtr<Profile> stopProfiling(ExecState*, const UString& title);
@@ -0,0 +1,277 @@
+/*
+ * Copyright 2012, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "SamplingProfiler.h"
+
+#if ENABLE(SAMPLING_PROFILER)
+
+#include "CallFrame.h"
+#include "CodeBlock.h"
+#include "Executable.h"
+#include "Interpreter.h"
+#include "JSGlobalData.h"
+#include "Profiler.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <wtf/HashMap.h>
+#include <wtf/text/CString.h>
+
+namespace JSC {
+
+static const char* GlobalCodeExecution = "(program)";
+static const char* AnonymousFunction = "(anonymous function)";
+static const char* NonJSExecution = "(idle)";
+
+SamplingProfiler* volatile SamplingProfiler::s_activeProfiler = 0;
+
+SamplingProfiler::SamplingProfiler(JSGlobalData& globalData)
+    : m_globalData(globalData)
+    , m_sampleTime(0.0)
+    , m_sampleCount(0)
+    , m_droppedSamples(0)
+    , m_isRunning(false)
+    , m_intervalInMicroseconds(defaultIntervalInMicroseconds)
+    , m_profiledThread(0)
+    , m_samplerThread(0)
+{
+}
+
+SamplingProfiler::~SamplingProfiler()
+{
+    if (m_isRunning)
+        stop();
+}
+
+void SamplingProfiler::start(const UString& title, unsigned intervalInMicroseconds)
+{
+    ASSERT(!m_isRunning);
+    // SIGPROF has a single handler, so only one thread is profiled at a time.
+    if (m_isRunning || s_activeProfiler)
+        return;
+
+    // The handler is left installed so that a signal still in flight when a
+    // profiler stops is ignored instead of terminating the process.
+    static bool handlerInstalled = false;
+    if (!handlerInstalled) {
+        struct sigaction action;
+        memset(&action, 0, sizeof(action));
+        action.sa_handler = signalHandler;
+        action.sa_flags = SA_RESTART;
+        sigemptyset(&action.sa_mask);
+        sigaction(SIGPROF, &action, 0);
+        handlerInstalled = true;
+    }
+
+    if (!m_frames) {
+        m_frames = adoptArrayPtr(new CodeBlock*[sampleCapacity * maximumStackDepth]);
+        m_depths = adoptArrayPtr(new unsigned[sampleCapacity]);
+    }
+    m_sampleCount = 0;
+    m_droppedSamples = 0;
+
+    m_profile = Profile::create(title, Profiler::createProfileUID());
+    // Node times are built from sample counts, not from the nodes' timers.
+    m_profile->head()->setStartTime(0.0);
+    m_intervalInMicroseconds = intervalInMicroseconds ? intervalInMicroseconds : defaultIntervalInMicroseconds;
+    m_sampleTime = m_intervalInMicroseconds / 1000.0;
+    m_profiledThread = pthread_self();
+
+    m_isRunning = true;
+    s_activeProfiler = this;
+    m_samplerThread = createThread(threadStartFunc, this, "JavaScriptCore::SamplingProfiler");
+}
+
+PassRefPtr<Profile> SamplingProfiler::stop()
+{
+    ASSERT(m_isRunning);
+    ASSERT(pthread_equal(m_profiledThread, pthread_self()));
+    if (!m_isRunning)
+        return 0;
+
+    m_isRunning = false;
+    waitForThreadCompletion(m_samplerThread, 0);
+    s_activeProfiler = 0;
+    processSamples();
+
+    // Self times fall out of the sample counts; scale both into milliseconds
+    // only afterwards so that rounding cannot make a child outweigh its parent.
+    m_profile->forEach(&ProfileNode::stopProfiling);
+    ProfileNode* head = m_profile->head();
+    for (ProfileNode* node = head; node; node = node->traverseNextNodePreOrder()) {
+        node->setTotalTime(node->actualTotalTime() * m_sampleTime);
+        node->setSelfTime(node->actualSelfTime() * m_sampleTime);
+    }
+
+    // Samples taken while no JavaScript was on the stack.
+    if (double idleTime = head->selfTime()) {
+        RefPtr<ProfileNode> idleNode = ProfileNode::create(0, CallIdentifier(NonJSExecution, UString(), 0), head, head);
+        idleNode->setStartTime(0.0);
+        idleNode->setTotalTime(idleTime);
+        idleNode->setSelfTime(idleTime);
+        head->setSelfTime(0.0);
+        head->addChild(idleNode.release());
+    }
+
+    if (m_droppedSamples)
+        fprintf(stderr, "SamplingProfiler: %d samples dropped, the sample buffer was full\n", static_cast<int>(m_droppedSamples));
+    if (const char* path = getenv("JSC_SAMPLING_PROFILE_PATH"))
+        writeProfile(m_profile.get(), path);
+
+    return m_profile.release();
+}
+
+void* SamplingProfiler::threadStartFunc(void* argument)
+{
+    SamplingProfiler* profiler = static_cast<SamplingProfiler*>(argument);
+    while (profiler->m_isRunning) {
+        usleep(profiler->m_intervalInMicroseconds);
+        if (profiler->m_isRunning)
+            pthread_kill(profiler->m_profiledThread, SIGPROF);
+    }
+    return 0;
+}
+
+void SamplingProfiler::signalHandler(int)
+{
+    // Runs on the profiled thread, so the profiler cannot be stopped under it.
+    if (SamplingProfiler* profiler = s_activeProfiler)
+        profiler->takeSample();
+}
+
+void SamplingProfiler::takeSample()
+{
+    unsigned sampleIndex = m_sampleCount;
+    if (sampleIndex == sampleCapacity) {
+        ++m_droppedSamples;
+        return;
+    }
+
+    // Only the innermost maximumStackDepth frames are kept, and the walk stops
+    // at the first frame that does not lie within the RegisterFile.
+    CodeBlock** frames = m_frames.get() + sampleIndex * maximumStackDepth;
+    RegisterFile& registerFile = m_globalData.interpreter->registerFile();
+    unsigned depth = 0;
+    for (CallFrame* callFrame = m_globalData.topCallFrame; callFrame && depth < maximumStackDepth; callFrame = callFrame->callerFrame()->removeHostCallFrameFlag()) {
+        if (callFrame->registers() - RegisterFile::CallFrameHeaderSize < registerFile.start() || callFrame->registers() > registerFile.end())
+            break;
+        if (CodeBlock* codeBlock = callFrame->codeBlock())
+            frames[depth++] = codeBlock;
+    }
+
+    m_depths[sampleIndex] = depth;
+    m_sampleCount = sampleIndex + 1;
+}
+
+static CallIdentifier createCallIdentifier(CodeBlock* codeBlock)
+{
+    ScriptExecutable* executable = codeBlock->ownerExecutable();
+    if (codeBlock->codeType() != FunctionCode)
+        return CallIdentifier(GlobalCodeExecution, executable->sourceURL(), executable->lineNo());
+
+    const UString& name = static_cast<FunctionExecutable*>(executable)->name().ustring();
+    return CallIdentifier(name.isEmpty() ? UString(AnonymousFunction) : name, executable->sourceURL(), executable->lineNo());
+}
+
+static ProfileNode* childNode(ProfileNode* parent, const CallIdentifier& callIdentifier)
+{
+    const Vector<RefPtr<ProfileNode> >& children = parent->children();
+    for (size_t i = 0; i < children.size(); ++i) {
+        if (children[i]->callIdentifier() == callIdentifier)
+            return children[i].get();
+    }
+
+    RefPtr<ProfileNode> child = ProfileNode::create(0, callIdentifier, parent->head() ? parent->head() : parent, parent);
+    child->setStartTime(0.0);
+    parent->addChild(child);
+    return child.get();
+}
+
+void SamplingProfiler::processSamples()
+{
+    if (!m_profile)
+        return;
+
+    // The handler appends on this same thread; keep it out while the buffer
+    // is read and emptied.
+    sigset_t profilingSignal;
+    sigset_t previousMask;
+    sigemptyset(&profilingSignal);
+    sigaddset(&profilingSignal, SIGPROF);
+    pthread_sigmask(SIG_BLOCK, &profilingSignal, &previousMask);
+
+    HashMap<CodeBlock*, CallIdentifier> callIdentifiers;
+    ProfileNode* head = m_profile->head();
+    unsigned sampleCount = m_sampleCount;
+    for (unsigned i = 0; i < sampleCount; ++i) {
+        CodeBlock** frames = m_frames.get() + i * maximumStackDepth;
+        ProfileNode* node = head;
+        node->setActualTotalTime(node->actualTotalTime() + 1);
+        for (unsigned depth = m_depths[i]; depth--;) {
+            HashMap<CodeBlock*, CallIdentifier>::iterator it = callIdentifiers.find(frames[depth]);
+            if (it == callIdentifiers.end())
+                it = callIdentifiers.add(frames[depth], createCallIdentifier(frames[depth])).first;
+            node = childNode(node, it->second);
+            node->setActualTotalTime(node->actualTotalTime() + 1);
+        }
+    }
+    m_sampleCount = 0;
+
+    pthread_sigmask(SIG_SETMASK, &previousMask, 0);
+}
+
+static void writeProfileNode(FILE* file, const ProfileNode* node, unsigned indentLevel)
+{
+    const CallIdentifier& callIdentifier = node->callIdentifier();
+    fprintf(file, "%10.1f %10.1f  ", node->totalTime(), node->selfTime());
+    for (unsigned i = 0; i < indentLevel; ++i)
+        fputs("  ", file);
+    fprintf(file, "%s %s:%u\n", callIdentifier.m_name.utf8().data(), callIdentifier.m_url.utf8().data(), callIdentifier.m_lineNumber);
+
+    const Vector<RefPtr<ProfileNode> >& children = node->children();
+    for (size_t i = 0; i < children.size(); ++i)
+        writeProfileNode(file, children[i].get(), indentLevel + 1);
+}
+
+bool SamplingProfiler::writeProfile(const Profile* profile, const char* path)
+{
+    FILE* file = fopen(path, "w");
+    if (!file)
+        return false;
+
+    fprintf(file, "Profile \"%s\"\n\n  total ms    self ms  function\n", profile->title().utf8().data());
+    const Vector<RefPtr<ProfileNode> >& children = profile->head()->children();
+    for (size_t i = 0; i < children.size(); ++i)
+        writeProfileNode(file, children[i].get(), 0);
+
+    fclose(file);
+    return true;
+}
+
+} // namespace JSC
+
+#endif // ENABLE(SAMPLING_PROFILER)
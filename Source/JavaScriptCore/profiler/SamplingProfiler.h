@@ -0,0 +1,106 @@
+/*
+ * Copyright 2012, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SamplingProfiler_h
+#define SamplingProfiler_h
+
+#if ENABLE(SAMPLING_PROFILER)
+
+#include "Profile.h"
+#include <pthread.h>
+#include <signal.h>
+#include <wtf/Noncopyable.h>
+#include <wtf/OwnArrayPtr.h>
+#include <wtf/PassRefPtr.h>
+#include <wtf/RefPtr.h>
+#include <wtf/Threading.h>
+
+namespace JSC {
+
+    class CodeBlock;
+    class JSGlobalData;
+    class UString;
+
+    // Samples the JavaScript stack of the thread that owns a JSGlobalData.
+    // A helper thread sends SIGPROF to that thread at a fixed interval, and the
+    // signal handler copies the CodeBlocks of the frames reachable from
+    // JSGlobalData::topCallFrame into a preallocated buffer; it neither
+    // allocates nor takes locks. The buffer is folded into a Profile on the
+    // profiled thread, by stop() and before every garbage collection, while
+    // the recorded CodeBlocks are known to be alive.
+    class SamplingProfiler {
+        WTF_MAKE_NONCOPYABLE(SamplingProfiler); WTF_MAKE_FAST_ALLOCATED;
+    public:
+        static const unsigned defaultIntervalInMicroseconds = 1000;
+        static const unsigned maximumStackDepth = 32;
+        static const unsigned sampleCapacity = 2048;
+
+        explicit SamplingProfiler(JSGlobalData&);
+        ~SamplingProfiler();
+
+        bool isRunning() const { return m_isRunning; }
+        const UString& title() const { return m_profile->title(); }
+        unsigned droppedSamples() const { return m_droppedSamples; }
+
+        // Both must be called on the thread that runs JavaScript for the
+        // JSGlobalData.
+        void start(const UString& title, unsigned intervalInMicroseconds = defaultIntervalInMicroseconds);
+        PassRefPtr<Profile> stop();
+
+        // Folds the buffered samples into the profile. Must run before any
+        // CodeBlock recorded since the last call can be destroyed.
+        void processSamples();
+
+        // Writes a Profile as an indented call tree of total and self times.
+        static bool writeProfile(const Profile*, const char* path);
+
+    private:
+        static void* threadStartFunc(void*);
+        static void signalHandler(int);
+
+        void takeSample();
+
+        JSGlobalData& m_globalData;
+        RefPtr<Profile> m_profile;
+        double m_sampleTime;
+
+        OwnArrayPtr<CodeBlock*> m_frames;
+        OwnArrayPtr<unsigned> m_depths;
+        volatile sig_atomic_t m_sampleCount;
+        volatile sig_atomic_t m_droppedSamples;
+
+        volatile bool m_isRunning;
+        unsigned m_intervalInMicroseconds;
+        pthread_t m_profiledThread;
+        ThreadIdentifier m_samplerThread;
+
+        static SamplingProfiler* volatile s_activeProfiler;
+    };
+
+} // namespace JSC
+
+#endif // ENABLE(SAMPLING_PROFILER)
+
+#endif // SamplingProfiler_h
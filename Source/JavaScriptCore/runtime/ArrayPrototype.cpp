@@ -286,6 +286,21 @@ EncodedJSValue JSC_HOST_CALL arrayProtoFuncJoin(ExecState* exec)
     if (isJSArray(&exec->globalData(), thisObj)) {
         JSArray* array = asArray(thisObj);
 
+        // When joining an array of strings, the length of the result is known
+        // up front, so the buffer can be allocated once rather than grown.
+        if (length > 1) {
+            uint64_t resultLength = static_cast<uint64_t>(separator.isNull() ? 1 : separator.length()) * (length - 1);
+            unsigned i = 0;
+            for (; i < length && array->canGetIndex(i); ++i) {
+                JSValue element = array->getIndex(i);
+                if (!element.isString())
+                    break;
+                resultLength += asString(element)->length();
+            }
+            if (i == length && resultLength <= std::numeric_limits<unsigned>::max())
+                strBuffer.reserveCapacity(static_cast<unsigned>(resultLength));
+        }
+
         if (length) {
             if (!array->canGetIndex(k)) 
                 goto skipFirstLoop;
@@ -342,6 +342,28 @@ void FunctionExecutable::discardCode()
 #endif
 }
 
+#if ENABLE(JIT)
+size_t FunctionExecutable::jitCodeSize()
+{
+    size_t size = 0;
+    if (m_codeBlockForCall && !!m_jitCodeForCall)
+        size += m_codeBlockForCall->jitCodeSize();
+    if (m_codeBlockForConstruct && !!m_jitCodeForConstruct)
+        size += m_codeBlockForConstruct->jitCodeSize();
+    return size;
+}
+
+unsigned FunctionExecutable::ageJITCode()
+{
+    unsigned age = std::numeric_limits<unsigned>::max();
+    if (m_codeBlockForCall && !!m_jitCodeForCall)
+        age = std::min(age, m_codeBlockForCall->ageJITCode());
+    if (m_codeBlockForConstruct && !!m_jitCodeForConstruct)
+        age = std::min(age, m_codeBlockForConstruct->ageJITCode());
+    return age;
+}
+#endif
+
 FunctionExecutable* FunctionExecutable::fromGlobalCode(const Identifier& functionName, ExecState* exec, Debugger* debugger, const SourceCode& source, JSObject** exception)
 {
     JSGlobalObject* lexicalGlobalObject = exec->lexicalGlobalObject();
@@ -370,6 +370,12 @@ namespace JSC {
         SharedSymbolTable* symbolTable() const { return m_symbolTable; }
 
         void discardCode();
+#if ENABLE(JIT)
+        // The size of the JIT code generated for calls and for construction,
+        // and the number of CodeBlock::ageJITCode() passes since either ran.
+        size_t jitCodeSize();
+        unsigned ageJITCode();
+#endif
         void markChildren(MarkStack&);
         static FunctionExecutable* fromGlobalCode(const Identifier&, ExecState*, Debugger*, const SourceCode&, JSObject** exception);
         static Structure* createStructure(JSGlobalData& globalData, JSValue proto) { return Structure::create(globalData, proto, TypeInfo(CompoundType, StructureFlags), AnonymousSlotCount, 0); }
@@ -45,6 +45,7 @@ public:
     virtual ~GCActivityCallback() {}
     virtual void operator()() {}
     virtual void synchronize() {}
+    virtual void didStartIncrementalMarking() {} // The heap wants Heap::markIncrementally() called soon.
 
 protected:
     GCActivityCallback() {}
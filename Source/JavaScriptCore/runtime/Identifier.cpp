@@ -40,13 +40,18 @@ namespace JSC {
 IdentifierTable::~IdentifierTable()
 {
     HashSet<StringImpl*>::iterator end = m_table.end();
-    for (HashSet<StringImpl*>::iterator iter = m_table.begin(); iter != end; ++iter)
-        (*iter)->setIsIdentifier(false);
+    for (HashSet<StringImpl*>::iterator iter = m_table.begin(); iter != end; ++iter) {
+        if (!(*iter)->isStatic())
+            (*iter)->setIsIdentifier(false);
+    }
 }
 std::pair<HashSet<StringImpl*>::iterator, bool> IdentifierTable::add(StringImpl* value)
 {
     std::pair<HashSet<StringImpl*>::iterator, bool> result = m_table.add(value);
-    (*result.first)->setIsIdentifier(true);
+    // Atoms shared between threads can be in the tables of several threads, so
+    // they are always looked up in the table instead of being flagged.
+    if (!(*result.first)->isStatic())
+        (*result.first)->setIsIdentifier(true);
     return result;
 }
 template<typename U, typename V>
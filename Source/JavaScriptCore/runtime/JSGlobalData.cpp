@@ -51,7 +51,10 @@
 #include "Nodes.h"
 #include "Parser.h"
 #include "RegExpCache.h"
+#include "SamplingProfiler.h"
 #include "StrictEvalActivation.h"
+#include <algorithm>
+#include <wtf/CurrentTime.h>
 #include <wtf/WTFThreadData.h>
 #if ENABLE(REGEXP_TRACING)
 #include "RegExp.h"
@@ -88,6 +91,54 @@ inline void Recompiler::operator()(JSCell* cell)
     function->jsExecutable()->discardCode();
 }
 
+#if ENABLE(JIT)
+struct ColdCode {
+    FunctionExecutable* executable;
+    size_t size;
+    unsigned age;
+};
+
+static bool isColder(const ColdCode& a, const ColdCode& b)
+{
+    if (a.age != b.age)
+        return a.age > b.age;
+    return a.size > b.size;
+}
+
+// Ages the JIT code of every function once, and collects the code that has
+// not run since the previous pass.
+class ColdCodeFinder {
+public:
+    void operator()(JSCell*);
+
+    Vector<ColdCode>& coldCode() { return m_coldCode; }
+
+private:
+    HashSet<FunctionExecutable*> m_visited;
+    Vector<ColdCode> m_coldCode;
+};
+
+inline void ColdCodeFinder::operator()(JSCell* cell)
+{
+    if (!cell->inherits(&JSFunction::s_info))
+        return;
+    JSFunction* function = asFunction(cell);
+    if (function->executable()->isHostFunction())
+        return;
+    FunctionExecutable* executable = function->jsExecutable();
+    if (!m_visited.add(executable).second)
+        return;
+    size_t size = executable->jitCodeSize();
+    if (!size)
+        return;
+    unsigned age = executable->ageJITCode();
+    if (!age)
+        return;
+    ColdCode coldCode = { executable, size, age };
+    m_coldCode.append(coldCode);
+}
+#endif
+
 } // namespace
 
 namespace JSC {
@@ -162,6 +213,9 @@ JSGlobalData::JSGlobalData(GlobalDataType globalDataType, ThreadStackType thread
     , parser(new Parser)
     , interpreter(0)
     , heap(this)
+#if ENABLE(SAMPLING_PROFILER)
+    , topCallFrame(0)
+#endif
     , globalObjectCount(0)
     , dynamicGlobalObject(0)
     , cachedUTCOffset(NaN)
@@ -173,6 +227,9 @@ JSGlobalData::JSGlobalData(GlobalDataType globalDataType, ThreadStackType thread
 #ifndef NDEBUG
     , exclusiveThread(0)
 #endif
+#if ENABLE(JIT)
+    , m_lastColdJITCodeRelease(0)
+#endif
 {
     interpreter = new Interpreter(*this);
     if (globalDataType == Default)
@@ -269,6 +326,11 @@ JSGlobalData::~JSGlobalData()
 {
     // By the time this is destroyed, heap.destroy() must already have been called.
 
+#if ENABLE(SAMPLING_PROFILER)
+    // The profiler walks the interpreter's RegisterFile.
+    samplingProfiler.clear();
+#endif
+
     delete interpreter;
 #ifndef NDEBUG
     // Zeroing out to make the behavior more predictable when someone attempts to use a deleted instance.
@@ -401,11 +463,60 @@ void JSGlobalData::recompileAllJSFunctions()
     // If JavaScript is running, it's not safe to recompile, since we'll end
     // up throwing away code that is live on the stack.
     ASSERT(!dynamicGlobalObject);
-    
+
+#if ENABLE(SAMPLING_PROFILER)
+    // Discarding code frees CodeBlocks that buffered samples refer to.
+    if (samplingProfiler)
+        samplingProfiler->processSamples();
+#endif
+
     Recompiler recompiler;
     heap.forEach(recompiler);
 }
 
+#if ENABLE(JIT)
+size_t JSGlobalData::releaseColdJITCode(size_t bytesToRelease)
+{
+    // Discarding code unlinks the calls other code blocks had linked to it,
+    // but code that is on the stack can not go away.
+    ASSERT(!dynamicGlobalObject);
+
+#if ENABLE(SAMPLING_PROFILER)
+    if (samplingProfiler)
+        samplingProfiler->processSamples();
+#endif
+
+    ColdCodeFinder finder;
+    heap.forEach(finder);
+
+    Vector<ColdCode>& coldCode = finder.coldCode();
+    std::sort(coldCode.begin(), coldCode.end(), isColder);
+
+    // Small functions share executable pools, the memory only goes back to
+    // the system once all of the code in a pool has been released.
+    size_t released = 0;
+    for (size_t i = 0; i < coldCode.size() && released < bytesToRelease; ++i) {
+        coldCode[i].executable->discardCode();
+        released += coldCode[i].size;
+    }
+    return released;
+}
+
+void JSGlobalData::relieveExecutableMemoryPressure()
+{
+    // Each pass ages the code, so passes need to be far enough apart for
+    // the code that is in use to run in between.
+    static const double minimumReleaseInterval = 1;
+
+    double now = currentTime();
+    if (now - m_lastColdJITCodeRelease < minimumReleaseInterval)
+        return;
+    m_lastColdJITCodeRelease = now;
+
+    releaseColdJITCode(ExecutableAllocator::committedByteCount() / 4);
+}
+#endif
+
 #if ENABLE(REGEXP_TRACING)
 void JSGlobalData::addRegExpToTrace(PassRefPtr<RegExp> regExp)
 {
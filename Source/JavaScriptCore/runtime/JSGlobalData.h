@@ -67,6 +67,9 @@ namespace JSC {
     class NativeExecutable;
     class Parser;
     class RegExpCache;
+#if ENABLE(SAMPLING_PROFILER)
+    class SamplingProfiler;
+#endif
     class Stringifier;
     class Structure;
     class UString;
@@ -225,6 +228,13 @@ namespace JSC {
         ReturnAddressPtr exceptionLocation;
 #endif
 
+#if ENABLE(SAMPLING_PROFILER)
+        // The innermost interpreter frame, or the frame that entered JIT code;
+        // read by the SamplingProfiler's signal handler.
+        ExecState* topCallFrame;
+        OwnPtr<SamplingProfiler> samplingProfiler;
+#endif
+
         HashMap<OpaqueJSClass*, OpaqueJSClassContextData*> opaqueJSClassData;
 
         unsigned globalObjectCount;
@@ -260,6 +270,17 @@ namespace JSC {
         void stopSampling();
         void dumpSampleData(ExecState* exec);
         void recompileAllJSFunctions();
+#if ENABLE(JIT)
+        // Throws away the JIT code of the functions that have not run for the
+        // longest time until about bytesToRelease bytes of code are gone; they
+        // are compiled again the next time they are called. Like
+        // recompileAllJSFunctions(), this must not be called while JavaScript
+        // is running. Returns the number of bytes of code released.
+        size_t releaseColdJITCode(size_t bytesToRelease);
+        // Called on entry while the executable pool is under pressure;
+        // releases a share of the cold code, at most once a second.
+        void relieveExecutableMemoryPressure();
+#endif
         RegExpCache* regExpCache() { return m_regExpCache; }
 #if ENABLE(REGEXP_TRACING)
         void addRegExpToTrace(PassRefPtr<RegExp> regExp);
@@ -275,6 +296,9 @@ namespace JSC {
         void createNativeThunk();
 #if ENABLE(JIT) && ENABLE(INTERPRETER)
         bool m_canUseJIT;
+#endif
+#if ENABLE(JIT)
+        double m_lastColdJITCodeRelease;
 #endif
         StackBounds m_stack;
     };
@@ -228,6 +228,20 @@ namespace JSC {
             m_structure->flattenDictionaryStructure(globalData, this);
         }
 
+        // Deleting a property leaves an object as an uncacheable dictionary, which
+        // defeats property access caching for good. Small objects are flattened
+        // back so the caller can cache against them on the next access; large
+        // ones are likely being used as hash tables and are left alone.
+        static const unsigned maximumFlattenableDictionarySize = 64;
+        bool tryFlattenUncacheableDictionary(JSGlobalData& globalData)
+        {
+            ASSERT(m_structure->isUncacheableDictionary());
+            if (m_structure->propertyStorageSize() > maximumFlattenableDictionarySize)
+                return false;
+            flattenDictionaryObject(globalData);
+            return true;
+        }
+
         void putAnonymousValue(JSGlobalData& globalData, unsigned index, JSValue value)
         {
             ASSERT(index < m_structure->anonymousSlotCount());
@@ -162,6 +162,69 @@ JSString* JSString::substringFromRope(ExecState* exec, unsigned substringStart,
     return new (globalData) JSString(globalData, substringFibers[0], substringFibers[1], substringFibers[2]);
 }
 
+// Like substringFromRope, this gives up on ropes made of more than a few
+// fibers, which are cheaper to flatten once than to walk on every access.
+bool JSString::tryGetCharacterFromRope(unsigned i, UChar& character)
+{
+    ASSERT(isRope());
+    ASSERT(i < m_length);
+
+    unsigned fiberCount = 0;
+    unsigned fiberEnd = 0;
+
+    RopeIterator end;
+    for (RopeIterator it(m_other.m_fibers.data(), m_fiberCount); it != end; ++it) {
+        if (++fiberCount > substringFromRopeCutoff)
+            return false;
+        StringImpl* fiberString = *it;
+        unsigned fiberStart = fiberEnd;
+        fiberEnd = fiberStart + fiberString->length();
+        if (i < fiberEnd) {
+            character = fiberString->characters()[i - fiberStart];
+            return true;
+        }
+    }
+    ASSERT_NOT_REACHED();
+    return false;
+}
+
+UChar JSString::characterAt(ExecState* exec, unsigned i)
+{
+    ASSERT(i < m_length);
+    if (isRope()) {
+        UChar character;
+        if (tryGetCharacterFromRope(i, character))
+            return character;
+        resolveRope(exec);
+        if (exec->exception())
+            return 0;
+    }
+    return m_value.characters()[i];
+}
+
+// Searching for a single character reads the rope once either way, so
+// this walks the fibers however many there are instead of copying them.
+size_t JSString::find(ExecState*, UChar character, unsigned start)
+{
+    if (!isRope())
+        return m_value.find(character, start);
+
+    unsigned fiberEnd = 0;
+
+    RopeIterator end;
+    for (RopeIterator it(m_other.m_fibers.data(), m_fiberCount); it != end; ++it) {
+        StringImpl* fiberString = *it;
+        unsigned fiberStart = fiberEnd;
+        fiberEnd = fiberStart + fiberString->length();
+        if (fiberEnd <= start)
+            continue;
+        size_t position = fiberString->find(character, start > fiberStart ? start - fiberStart : 0);
+        if (position != notFound)
+            return fiberStart + position;
+    }
+    return notFound;
+}
+
 JSValue JSString::replaceCharacter(ExecState* exec, UChar character, const UString& replacement)
 {
     if (!isRope()) {
@@ -217,6 +280,9 @@ JSValue JSString::replaceCharacter(ExecState* exec, UChar character, const UStri
 JSString* JSString::getIndexSlowCase(ExecState* exec, unsigned i)
 {
     ASSERT(isRope());
+    UChar character;
+    if (tryGetCharacterFromRope(i, character))
+        return jsSingleCharacterString(exec, character);
     resolveRope(exec);
     // Return a safe no-value result, this should never be used, since the excetion will be thrown.
     if (exec->exception())
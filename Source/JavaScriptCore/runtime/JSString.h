@@ -347,6 +347,11 @@ namespace JSC {
         JSString* getIndex(ExecState*, unsigned);
         JSString* getIndexSlowCase(ExecState*, unsigned);
 
+        // These read a rope without flattening it when that is cheap, which
+        // it usually is for a string that has just been appended to.
+        UChar characterAt(ExecState*, unsigned);
+        size_t find(ExecState*, UChar, unsigned start);
+
         JSValue replaceCharacter(ExecState*, UChar, const UString& replacement);
 
         static Structure* createStructure(JSGlobalData& globalData, JSValue proto) { return Structure::create(globalData, proto, TypeInfo(StringType, OverridesGetOwnPropertySlot | NeedsThisConversion), AnonymousSlotCount, 0); }
@@ -360,6 +365,7 @@ namespace JSC {
 
         void resolveRope(ExecState*) const;
         JSString* substringFromRope(ExecState*, unsigned offset, unsigned length);
+        bool tryGetCharacterFromRope(unsigned, UChar&);
 
         void appendStringInConstruct(unsigned& index, const UString& string)
         {
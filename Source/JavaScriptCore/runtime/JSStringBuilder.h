@@ -40,6 +40,11 @@ public:
     {
     }
 
+    void reserveCapacity(unsigned capacity)
+    {
+        m_okay &= buffer.tryReserveCapacity(capacity);
+    }
+
     void append(const UChar u)
     {
         m_okay &= buffer.tryAppend(&u, 1);
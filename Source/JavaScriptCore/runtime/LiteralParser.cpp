@@ -141,7 +141,22 @@ template <LiteralParser::ParserMode mode> static inline bool isSafeStringCharact
 template <LiteralParser::ParserMode mode> inline LiteralParser::TokenType LiteralParser::Lexer::lexString(LiteralParserToken& token)
 {
     ++m_ptr;
-    const UChar* runStart;
+    const UChar* runStart = m_ptr;
+
+    // Most strings, and nearly all property names, contain no escapes. Those
+    // are left in the source until the parser knows what it needs them for.
+    while (m_ptr < m_end && isSafeStringCharacter<mode>(*m_ptr))
+        ++m_ptr;
+    if (m_ptr < m_end && *m_ptr == '"') {
+        token.stringToken = UString();
+        token.stringBuffer = runStart;
+        token.stringLength = m_ptr - runStart;
+        token.type = TokString;
+        token.end = ++m_ptr;
+        return TokString;
+    }
+    m_ptr = runStart;
+
     UStringBuilder builder;
     do {
         runStart = m_ptr;
@@ -208,6 +223,8 @@ template <LiteralParser::ParserMode mode> inline LiteralParser::TokenType Litera
         return TokError;
 
     token.stringToken = builder.toUString();
+    token.stringBuffer = token.stringToken.characters();
+    token.stringLength = token.stringToken.length();
     token.type = TokString;
     token.end = ++m_ptr;
     return TokString;
@@ -243,6 +260,24 @@ LiteralParser::TokenType LiteralParser::Lexer::lexNumber(LiteralParserToken& tok
     } else
         return TokError;
 
+    // Integers that fit in an int are converted directly, without strtod.
+    const int maximumFastIntegerDigits = 9;
+    if ((m_ptr >= m_end || (*m_ptr != '.' && *m_ptr != 'e' && *m_ptr != 'E')) && m_ptr - token.start <= maximumFastIntegerDigits + 1) {
+        const UChar* digit = token.start;
+        bool negative = *digit == '-';
+        if (negative)
+            ++digit;
+        if (m_ptr - digit <= maximumFastIntegerDigits) {
+            int result = 0;
+            for (; digit < m_ptr; ++digit)
+                result = result * 10 + (*digit - '0');
+            token.type = TokNumber;
+            token.end = m_ptr;
+            token.numberToken = negative ? -static_cast<double>(result) : result;
+            return TokNumber;
+        }
+    }
+
     // ('.' [0-9]+)?
     if (m_ptr < m_end && *m_ptr == '.') {
         ++m_ptr;
@@ -287,6 +322,27 @@ LiteralParser::TokenType LiteralParser::Lexer::lexNumber(LiteralParserToken& tok
     return TokNumber;
 }
 
+// JSON documents tend to repeat the same few property names many times over,
+// so the last name seen for each leading character is kept, as are all single
+// character names, saving most of the lookups in the identifier table.
+Identifier LiteralParser::makeIdentifier(const UChar* characters, size_t length)
+{
+    if (!length || characters[0] >= maximumCachableCharacter)
+        return Identifier(m_exec, characters, length);
+
+    if (length == 1) {
+        Identifier& identifier = m_shortIdentifiers[characters[0]];
+        if (identifier.isNull())
+            identifier = Identifier(m_exec, characters, length);
+        return identifier;
+    }
+
+    Identifier& identifier = m_recentIdentifiers[characters[0]];
+    if (identifier.isNull() || !Identifier::equal(identifier.impl(), characters, length))
+        identifier = Identifier(m_exec, characters, length);
+    return identifier;
+}
+
 JSValue LiteralParser::parse(ParserState initialState)
 {
     ParserState state = initialState;
@@ -345,7 +401,7 @@ JSValue LiteralParser::parse(ParserState initialState)
                         return JSValue();
                     
                     m_lexer.next();
-                    identifierStack.append(Identifier(m_exec, identifierToken.stringToken));
+                    identifierStack.append(makeIdentifier(identifierToken.stringBuffer, identifierToken.stringLength));
                     stateStack.append(DoParseObjectEndExpression);
                     goto startParseExpression;
                 } else if (type != TokRBrace) 
@@ -367,7 +423,7 @@ JSValue LiteralParser::parse(ParserState initialState)
                     return JSValue();
 
                 m_lexer.next();
-                identifierStack.append(Identifier(m_exec, identifierToken.stringToken));
+                identifierStack.append(makeIdentifier(identifierToken.stringBuffer, identifierToken.stringLength));
                 stateStack.append(DoParseObjectEndExpression);
                 goto startParseExpression;
             }
@@ -394,7 +450,10 @@ JSValue LiteralParser::parse(ParserState initialState)
                     case TokString: {
                         Lexer::LiteralParserToken stringToken = m_lexer.currentToken();
                         m_lexer.next();
-                        lastValue = jsString(m_exec, stringToken.stringToken);
+                        if (stringToken.stringToken.isNull())
+                            lastValue = jsString(m_exec, UString(stringToken.stringBuffer, stringToken.stringLength));
+                        else
+                            lastValue = jsString(m_exec, stringToken.stringToken);
                         break;
                     }
                     case TokNumber: {
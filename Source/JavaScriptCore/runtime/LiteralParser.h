@@ -26,6 +26,7 @@
 #ifndef LiteralParser_h
 #define LiteralParser_h
 
+#include "Identifier.h"
 #include "JSGlobalObjectFunctions.h"
 #include "JSValue.h"
 #include "UString.h"
@@ -66,7 +67,11 @@ namespace JSC {
                 TokenType type;
                 const UChar* start;
                 const UChar* end;
+                // stringToken is null when the string has no escapes; its
+                // characters are then only in the source.
                 UString stringToken;
+                const UChar* stringBuffer;
+                unsigned stringLength;
                 double numberToken;
             };
             Lexer(const UString& s, ParserMode mode)
@@ -100,10 +105,14 @@ namespace JSC {
         
         class StackGuard;
         JSValue parse(ParserState);
+        Identifier makeIdentifier(const UChar* characters, size_t length);
 
         ExecState* m_exec;
         LiteralParser::Lexer m_lexer;
         ParserMode m_mode;
+        static const unsigned maximumCachableCharacter = 128;
+        Identifier m_shortIdentifiers[maximumCachableCharacter];
+        Identifier m_recentIdentifiers[maximumCachableCharacter];
     };
 }
 
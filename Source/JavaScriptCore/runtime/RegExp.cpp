@@ -111,7 +111,7 @@ RegExp::RegExpState RegExp::compile(JSGlobalData* globalData)
     RegExpState res = ByteCode;
 
 #if ENABLE(YARR_JIT)
-    if (!pattern.m_containsBackreferences && globalData->canUseJIT()) {
+    if (globalData->canUseJIT()) {
         Yarr::jitCompile(pattern, globalData, m_representation->m_regExpJITCode);
 #if ENABLE(YARR_JIT_DEBUG)
         if (!m_representation->m_regExpJITCode.isFallBack())
@@ -254,7 +254,7 @@ void RegExp::matchCompareWithInterpreter(const UString& s, int startOffset, int*
 
         const size_t jitAddrSize = 20;
         char jitAddr[jitAddrSize];
-        if (m_state == JITCode)
+        if (m_state != JITCode)
             snprintf(jitAddr, jitAddrSize, "fallback");
         else
             snprintf(jitAddr, jitAddrSize, "0x%014lx", reinterpret_cast<unsigned long int>(codeBlock.getAddr()));
@@ -128,6 +128,47 @@ RegExpMatchesArray::~RegExpMatchesArray()
     delete static_cast<RegExpConstructorPrivate*>(subclassData());
 }
 
+bool RegExpMatchesArray::getUnfilledPropertySlot(ExecState* exec, const Identifier& propertyName, PropertySlot& slot)
+{
+    RegExpConstructorPrivate* d = static_cast<RegExpConstructorPrivate*>(subclassData());
+    ASSERT(d);
+
+    if (propertyName == exec->propertyNames().length) {
+        slot.setValue(jsNumber(d->lastNumSubPatterns + 1));
+        return true;
+    }
+    if (propertyName == exec->propertyNames().index) {
+        slot.setValue(jsNumber(d->lastOvector()[0]));
+        return true;
+    }
+    if (propertyName == exec->propertyNames().input) {
+        slot.setValue(jsString(exec, d->input));
+        return true;
+    }
+
+    bool isArrayIndex;
+    unsigned i = propertyName.toArrayIndex(isArrayIndex);
+    if (isArrayIndex)
+        return getUnfilledPropertySlot(exec, i, slot);
+    return false;
+}
+
+bool RegExpMatchesArray::getUnfilledPropertySlot(ExecState* exec, unsigned i, PropertySlot& slot)
+{
+    RegExpConstructorPrivate* d = static_cast<RegExpConstructorPrivate*>(subclassData());
+    ASSERT(d);
+
+    if (i > d->lastNumSubPatterns)
+        return false;
+
+    int start = d->lastOvector()[2 * i];
+    if (start >= 0)
+        slot.setValue(jsSubstring(exec, d->lastInput, start, d->lastOvector()[2 * i + 1] - start));
+    else
+        slot.setValue(jsUndefined());
+    return true;
+}
+
 void RegExpMatchesArray::fillArrayInstance(ExecState* exec)
 {
     RegExpConstructorPrivate* d = static_cast<RegExpConstructorPrivate*>(subclassData());
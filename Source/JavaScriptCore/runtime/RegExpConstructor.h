@@ -39,6 +39,7 @@ namespace JSC {
             : lastNumSubPatterns(0)
             , multiline(false)
             , lastOvectorIndex(0)
+            , lastStartOffset(0)
         {
         }
 
@@ -47,12 +48,22 @@ namespace JSC {
         Vector<int, 32>& tempOvector() { return ovector[lastOvectorIndex ? 0 : 1]; }
         void changeLastOvector() { lastOvectorIndex = lastOvectorIndex ? 0 : 1; }
 
+        // The last successful match is reused when the same regular expression
+        // is run again over the same string from the same offset, as in
+        // "if (re.test(s)) m = s.match(re);".
+        bool isLastMatch(RegExp* regExp, const UString& s, int startOffset) const
+        {
+            return regExp == lastRegExp.get() && s.impl() == lastInput.impl() && startOffset == lastStartOffset;
+        }
+
         UString input;
         UString lastInput;
         Vector<int, 32> ovector[2];
         unsigned lastNumSubPatterns : 30;
         bool multiline : 1;
         unsigned lastOvectorIndex : 1;
+        RefPtr<RegExp> lastRegExp;
+        int lastStartOffset;
     };
 
     class RegExpConstructor : public InternalFunction {
@@ -111,6 +122,15 @@ namespace JSC {
     */
     ALWAYS_INLINE void RegExpConstructor::performMatch(RegExp* r, const UString& s, int startOffset, int& position, int& length, int** ovector)
     {
+        if (d->isLastMatch(r, s, startOffset)) {
+            position = d->lastOvector()[0];
+            length = d->lastOvector()[1] - position;
+            if (ovector)
+                *ovector = d->lastOvector().data();
+            d->input = s;
+            return;
+        }
+
         position = r->match(s, startOffset, &d->tempOvector());
 
         if (ovector)
@@ -125,6 +145,8 @@ namespace JSC {
             d->lastInput = s;
             d->changeLastOvector();
             d->lastNumSubPatterns = r->numSubpatterns();
+            d->lastRegExp = r;
+            d->lastStartOffset = startOffset;
         }
     }
 
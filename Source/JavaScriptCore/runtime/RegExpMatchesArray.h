@@ -32,15 +32,21 @@ namespace JSC {
     private:
         virtual bool getOwnPropertySlot(ExecState* exec, const Identifier& propertyName, PropertySlot& slot)
         {
-            if (subclassData())
+            if (subclassData()) {
+                if (getUnfilledPropertySlot(exec, propertyName, slot))
+                    return true;
                 fillArrayInstance(exec);
+            }
             return JSArray::getOwnPropertySlot(exec, propertyName, slot);
         }
 
         virtual bool getOwnPropertySlot(ExecState* exec, unsigned propertyName, PropertySlot& slot)
         {
-            if (subclassData())
+            if (subclassData()) {
+                if (getUnfilledPropertySlot(exec, propertyName, slot))
+                    return true;
                 fillArrayInstance(exec);
+            }
             return JSArray::getOwnPropertySlot(exec, propertyName, slot);
         }
 
@@ -86,6 +92,12 @@ namespace JSC {
             JSArray::getOwnPropertyNames(exec, arr, mode);
         }
 
+        // Reads of the length, index, input and captures are answered straight
+        // from the match result, so that the captures that are never read are
+        // never turned into strings.
+        bool getUnfilledPropertySlot(ExecState*, const Identifier& propertyName, PropertySlot&);
+        bool getUnfilledPropertySlot(ExecState*, unsigned propertyName, PropertySlot&);
+
         void fillArrayInstance(ExecState*);
 };
 
@@ -486,9 +486,16 @@ EncodedJSValue JSC_HOST_CALL stringProtoFuncCharAt(ExecState* exec)
     JSValue thisValue = exec->hostThisValue();
     if (thisValue.isUndefinedOrNull()) // CheckObjectCoercible
         return throwVMTypeError(exec);
+    JSValue a0 = exec->argument(0);
+    if (thisValue.isString() && a0.isUInt32()) {
+        JSString* string = asString(thisValue);
+        uint32_t i = a0.asUInt32();
+        if (string->canGetIndex(i))
+            return JSValue::encode(string->getIndex(exec, i));
+        return JSValue::encode(jsEmptyString(exec));
+    }
     UString s = thisValue.toThisString(exec);
     unsigned len = s.length();
-    JSValue a0 = exec->argument(0);
     if (a0.isUInt32()) {
         uint32_t i = a0.asUInt32();
         if (i < len)
@@ -506,9 +513,16 @@ EncodedJSValue JSC_HOST_CALL stringProtoFuncCharCodeAt(ExecState* exec)
     JSValue thisValue = exec->hostThisValue();
     if (thisValue.isUndefinedOrNull()) // CheckObjectCoercible
         return throwVMTypeError(exec);
+    JSValue a0 = exec->argument(0);
+    if (thisValue.isString() && a0.isUInt32()) {
+        JSString* string = asString(thisValue);
+        uint32_t i = a0.asUInt32();
+        if (i < string->length())
+            return JSValue::encode(jsNumber(string->characterAt(exec, i)));
+        return JSValue::encode(jsNaN());
+    }
     UString s = thisValue.toThisString(exec);
     unsigned len = s.length();
-    JSValue a0 = exec->argument(0);
     if (a0.isUInt32()) {
         uint32_t i = a0.asUInt32();
         if (i < len)
@@ -540,11 +554,21 @@ EncodedJSValue JSC_HOST_CALL stringProtoFuncIndexOf(ExecState* exec)
     JSValue thisValue = exec->hostThisValue();
     if (thisValue.isUndefinedOrNull()) // CheckObjectCoercible
         return throwVMTypeError(exec);
-    UString s = thisValue.toThisString(exec);
-    int len = s.length();
 
     JSValue a0 = exec->argument(0);
     JSValue a1 = exec->argument(1);
+    if (thisValue.isString() && a0.isString() && asString(a0)->length() == 1 && (a1.isUndefined() || a1.isUInt32())) {
+        JSString* string = asString(thisValue);
+        unsigned pos = a1.isUndefined() ? 0 : min<uint32_t>(a1.asUInt32(), string->length());
+        size_t result = string->find(exec, asString(a0)->characterAt(exec, 0), pos);
+        if (result == notFound)
+            return JSValue::encode(jsNumber(-1));
+        return JSValue::encode(jsNumber(result));
+    }
+
+    UString s = thisValue.toThisString(exec);
+    int len = s.length();
+
     UString u2 = a0.toString(exec);
     int pos;
     if (a1.isUndefined())
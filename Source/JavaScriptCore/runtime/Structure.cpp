@@ -31,6 +31,7 @@
 #include "JSPropertyNameIterator.h"
 #include "Lookup.h"
 #include "PropertyNameArray.h"
+#include "SamplingTool.h"
 #include "StructureChain.h"
 #include <wtf/RefCountedLeakCounter.h>
 #include <wtf/RefPtr.h>
@@ -446,7 +447,16 @@ Structure* Structure::getterSetterTransition(JSGlobalData& globalData, Structure
 Structure* Structure::toDictionaryTransition(JSGlobalData& globalData, Structure* structure, DictionaryKind kind)
 {
     ASSERT(!structure->isUncacheableDictionary());
-    
+
+#if ENABLE(SAMPLING_COUNTERS)
+    static SamplingCounter cacheableDictionaries("Structures turned into cacheable dictionaries");
+    static SamplingCounter uncacheableDictionaries("Structures turned into uncacheable dictionaries");
+    if (kind == CachedDictionaryKind)
+        cacheableDictionaries.count();
+    else
+        uncacheableDictionaries.count();
+#endif
+
     Structure* transition = create(globalData, structure);
 
     structure->materializePropertyMapIfNecessary(globalData);
@@ -553,6 +563,10 @@ Structure* Structure::flattenDictionaryStructure(JSGlobalData& globalData, JSObj
     ASSERT(isDictionary());
     if (isUncacheableDictionary()) {
         ASSERT(m_propertyTable);
+#if ENABLE(SAMPLING_COUNTERS)
+        static SamplingCounter flattenedDictionaries("Uncacheable dictionaries flattened");
+        flattenedDictionaries.count();
+#endif
 
         unsigned anonymousSlotCount = m_anonymousSlotCount;
         size_t propertyCount = m_propertyTable->size();
@@ -27,17 +27,51 @@
 #define WriteBarrier_h
 
 #include "JSValue.h"
+#if ENABLE(GGC)
+#include "JSValueInlineMethods.h"
+#include "MarkedBlock.h"
+#endif
 
 namespace JSC {
 class JSCell;
 class JSGlobalData;
 
-inline void writeBarrier(JSGlobalData&, const JSCell*, JSValue)
+inline void writeBarrier(JSGlobalData&, const JSCell* owner, JSCell* value)
 {
+#if ENABLE(GGC)
+    if (!owner || !value)
+        return;
+    MarkedBlock* valueBlock = MarkedBlock::blockFor(value);
+    MarkedBlock* ownerBlock = MarkedBlock::blockFor(owner);
+    // Young cells are scanned by every collection, so only a store that makes
+    // an old cell point at a young one has to be remembered.
+    if (valueBlock->isNewlyAllocated(value) && !ownerBlock->isNewlyAllocated(owner)) {
+        ownerBlock->remember(owner);
+        return;
+    }
+#if ENABLE(INCREMENTAL_GC)
+    // Outside of incremental marking every live cell is marked. During it, a
+    // store of an unmarked cell into one that may already have been traced
+    // has to send the marker back to the owner.
+    if (!valueBlock->isMarked(value) && ownerBlock->isMarked(owner))
+        ownerBlock->remember(owner);
+#endif
+#else
+    UNUSED_PARAM(owner);
+    UNUSED_PARAM(value);
+#endif
 }
 
-inline void writeBarrier(JSGlobalData&, const JSCell*, JSCell*)
+inline void writeBarrier(JSGlobalData& globalData, const JSCell* owner, JSValue value)
 {
+#if ENABLE(GGC)
+    if (value.isCell())
+        writeBarrier(globalData, owner, value.asCell());
+#else
+    UNUSED_PARAM(globalData);
+    UNUSED_PARAM(owner);
+    UNUSED_PARAM(value);
+#endif
 }
 
 typedef enum { } Unknown;
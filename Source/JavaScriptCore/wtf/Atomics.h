@@ -107,6 +107,72 @@ inline int atomicDecrement(int volatile* addend) { return __gnu_cxx::__exchange_
 
 #endif
 
+#if OS(WINDOWS)
+inline bool weakCompareAndSwap(unsigned volatile* location, unsigned expected, unsigned newValue)
+{
+    return static_cast<unsigned>(InterlockedCompareExchange(reinterpret_cast<long volatile*>(location), newValue, expected)) == expected;
+}
+#elif OS(DARWIN)
+inline bool weakCompareAndSwap(unsigned volatile* location, unsigned expected, unsigned newValue)
+{
+    return OSAtomicCompareAndSwap32Barrier(expected, newValue, reinterpret_cast<int32_t volatile*>(location));
+}
+#elif OS(ANDROID)
+inline bool weakCompareAndSwap(unsigned volatile* location, unsigned expected, unsigned newValue)
+{
+    // android_atomic_cmpxchg() returns 0 when the swap happened.
+    return !android_atomic_cmpxchg(expected, newValue, reinterpret_cast<int32_t volatile*>(location));
+}
+#elif COMPILER(GCC) && !OS(SYMBIAN)
+inline bool weakCompareAndSwap(unsigned volatile* location, unsigned expected, unsigned newValue)
+{
+    return __sync_bool_compare_and_swap(location, expected, newValue);
+}
+#endif
+
+#if OS(WINDOWS)
+inline bool weakCompareAndSwap(void* volatile* location, void* expected, void* newValue)
+{
+    return InterlockedCompareExchangePointer(location, newValue, expected) == expected;
+}
+
+inline void memoryBarrier() { MemoryBarrier(); }
+#elif OS(DARWIN)
+inline bool weakCompareAndSwap(void* volatile* location, void* expected, void* newValue)
+{
+    return OSAtomicCompareAndSwapPtrBarrier(expected, newValue, location);
+}
+
+inline void memoryBarrier() { OSMemoryBarrier(); }
+#elif OS(ANDROID)
+inline bool weakCompareAndSwap(void* volatile* location, void* expected, void* newValue)
+{
+    return !android_atomic_cmpxchg(reinterpret_cast<int32_t>(expected), reinterpret_cast<int32_t>(newValue), reinterpret_cast<int32_t volatile*>(location));
+}
+
+// android_atomic_cmpxchg() only has release semantics, so callers that need
+// a store to be visible before a later load must fence explicitly.
+inline void memoryBarrier() { __sync_synchronize(); }
+#elif COMPILER(GCC) && !OS(SYMBIAN)
+inline bool weakCompareAndSwap(void* volatile* location, void* expected, void* newValue)
+{
+    return __sync_bool_compare_and_swap(location, expected, newValue);
+}
+
+inline void memoryBarrier() { __sync_synchronize(); }
+#endif
+
+// x86 never reorders loads with other loads or stores with older loads, so
+// only the compiler needs fencing there. Elsewhere these are full barriers;
+// storeStoreFence() also keeps earlier loads ahead of later stores.
+#if (CPU(X86) || CPU(X86_64)) && COMPILER(GCC)
+inline void loadLoadFence() { asm volatile("" ::: "memory"); }
+inline void storeStoreFence() { asm volatile("" ::: "memory"); }
+#else
+inline void loadLoadFence() { memoryBarrier(); }
+inline void storeStoreFence() { memoryBarrier(); }
+#endif
+
 } // namespace WTF
 
 #if USE(LOCKFREE_THREADSAFEREFCOUNTED)
@@ -0,0 +1,150 @@
+/*
+ * Copyright 2012, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef BumpArena_h
+#define BumpArena_h
+
+#include <wtf/AlwaysInline.h>
+#include <wtf/Assertions.h>
+#include <wtf/FastAllocBase.h>
+#include <wtf/FastMalloc.h>
+#include <wtf/Noncopyable.h>
+#include <wtf/StdLibExtras.h>
+#include <algorithm>
+#include <string.h>
+
+namespace WTF {
+
+// A BumpArena hands out memory for objects that all die together at the end
+// of a short phase of work. Allocation is a pointer increment; nothing is
+// freed individually. clear() releases every allocation at once but holds on
+// to the first chunk, so a phase that repeats (a parser handling one
+// declaration after another) stops touching malloc after its first round.
+//
+// Objects placed in an arena must not own anything that their destructor
+// would not release; callers that need destructors to run must run them
+// before calling clear().
+class BumpArena {
+    WTF_MAKE_NONCOPYABLE(BumpArena); WTF_MAKE_FAST_ALLOCATED;
+public:
+    explicit BumpArena(size_t chunkSize = defaultChunkSize)
+        : m_chunkSize(chunkSize)
+        , m_firstChunk(0)
+        , m_overflowChunks(0)
+        , m_current(0)
+        , m_end(0)
+        , m_allocationCount(0)
+        , m_bytesAllocated(0)
+    {
+    }
+
+    ~BumpArena()
+    {
+        freeOverflowChunks();
+        fastFree(m_firstChunk);
+    }
+
+    void* allocate(size_t size)
+    {
+        size = roundUpToMultipleOf<alignment>(size);
+        ++m_allocationCount;
+        m_bytesAllocated += size;
+        if (static_cast<size_t>(m_end - m_current) >= size) {
+            void* result = m_current;
+            m_current += size;
+            return result;
+        }
+        return allocateSlowCase(size);
+    }
+
+    void clear()
+    {
+        freeOverflowChunks();
+        if (!m_firstChunk)
+            return;
+#ifndef NDEBUG
+        // Make stale pointers into the arena fail loudly.
+        memset(m_firstChunk->payload(), 0xbb, m_firstChunk->size);
+#endif
+        m_current = m_firstChunk->payload();
+        m_end = m_current + m_firstChunk->size;
+    }
+
+    // Totals since the arena was created, for allocation-count measurements.
+    size_t allocationCount() const { return m_allocationCount; }
+    size_t bytesAllocated() const { return m_bytesAllocated; }
+
+    static const size_t defaultChunkSize = 4096;
+
+private:
+    static const size_t alignment = 8;
+
+    struct Chunk {
+        Chunk* next;
+        size_t size;
+
+        char* payload() { return reinterpret_cast<char*>(this) + headerSize; }
+    };
+    static const size_t headerSize = (sizeof(Chunk) + alignment - 1) & ~(alignment - 1);
+
+    NEVER_INLINE void* allocateSlowCase(size_t size)
+    {
+        size_t payloadSize = std::max(m_chunkSize - headerSize, size);
+        Chunk* chunk = static_cast<Chunk*>(fastMalloc(headerSize + payloadSize));
+        chunk->size = payloadSize;
+        if (!m_firstChunk) {
+            chunk->next = 0;
+            m_firstChunk = chunk;
+        } else {
+            chunk->next = m_overflowChunks;
+            m_overflowChunks = chunk;
+        }
+        m_current = chunk->payload() + size;
+        m_end = chunk->payload() + payloadSize;
+        return chunk->payload();
+    }
+
+    void freeOverflowChunks()
+    {
+        while (Chunk* chunk = m_overflowChunks) {
+            m_overflowChunks = chunk->next;
+            fastFree(chunk);
+        }
+    }
+
+    size_t m_chunkSize;
+    Chunk* m_firstChunk;
+    Chunk* m_overflowChunks;
+    char* m_current;
+    char* m_end;
+    size_t m_allocationCount;
+    size_t m_bytesAllocated;
+};
+
+} // namespace WTF
+
+using WTF::BumpArena;
+
+#endif // BumpArena_h
@@ -0,0 +1,856 @@
+/*
+ * Copyright 2012, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef WTF_ControlByteHashTable_h
+#define WTF_ControlByteHashTable_h
+
+#include "HashTable.h"
+#include <string.h>
+
+#if CPU(X86_64) || (CPU(X86) && defined(__SSE2__))
+#define CONTROL_BYTE_GROUP_SSE2 1
+#include <emmintrin.h>
+#else
+#define CONTROL_BYTE_GROUP_SSE2 0
+#endif
+
+#if !CONTROL_BYTE_GROUP_SSE2 && CPU(ARM_NEON)
+#define CONTROL_BYTE_GROUP_NEON 1
+#include <arm_neon.h>
+#else
+#define CONTROL_BYTE_GROUP_NEON 0
+#endif
+
+namespace WTF {
+
+    // An open addressing table that keeps one control byte per bucket next to the
+    // buckets. A full bucket's byte holds 7 bits of its hash, so a probe compares a
+    // whole group of control bytes at once and only looks at the buckets whose bits
+    // match. Probing stops at the first group with an empty bucket.
+    //
+    // A removed bucket is marked empty again unless some probe may have passed over
+    // it while its group was full, so churn leaves far fewer tombstones behind than
+    // in HashTable, and the table can be filled to 7/8 instead of 1/2.
+    //
+    // Use it for a HashMap or HashSet by wrapping the key traits in
+    // ControlByteHashTraits. Unlike HashTable, the buckets never hold the deleted
+    // value, and iterators are not tracked in debug builds.
+
+    typedef int8_t ControlByte;
+
+    static const ControlByte emptyControlByte = -128;
+    static const ControlByte deletedControlByte = -2;
+
+    inline bool isFullControlByte(ControlByte control) { return control >= 0; }
+
+    inline unsigned countTrailingZeros(uint32_t bits)
+    {
+        ASSERT(bits);
+#if COMPILER(GCC)
+        return __builtin_ctz(bits);
+#else
+        unsigned count = 0;
+        for (; !(bits & 1); bits >>= 1)
+            ++count;
+        return count;
+#endif
+    }
+
+    inline unsigned countTrailingZeros(uint64_t bits)
+    {
+        ASSERT(bits);
+#if COMPILER(GCC)
+        return __builtin_ctzll(bits);
+#else
+        unsigned count = 0;
+        for (; !(bits & 1); bits >>= 1)
+            ++count;
+        return count;
+#endif
+    }
+
+    inline unsigned countLeadingZeros(uint32_t bits)
+    {
+        ASSERT(bits);
+#if COMPILER(GCC)
+        return __builtin_clz(bits);
+#else
+        unsigned count = 0;
+        for (; !(bits & 0x80000000u); bits <<= 1)
+            ++count;
+        return count;
+#endif
+    }
+
+    inline unsigned countLeadingZeros(uint64_t bits)
+    {
+        ASSERT(bits);
+#if COMPILER(GCC)
+        return __builtin_clzll(bits);
+#else
+        unsigned count = 0;
+        for (; !(bits & 0x8000000000000000ull); bits <<= 1)
+            ++count;
+        return count;
+#endif
+    }
+
+    // The buckets of a group that matched, lowest bucket first. Each bucket takes
+    // 1 << shift bits, of which only the highest can be set.
+    template<typename Bits, unsigned shift, unsigned width> class ControlByteMatch {
+    public:
+        explicit ControlByteMatch(Bits bits) : m_bits(bits) { }
+
+        bool any() const { return m_bits; }
+        unsigned lowestIndex() const { return countTrailingZeros(m_bits) >> shift; }
+        void clearLowest() { m_bits &= m_bits - 1; }
+
+        // The number of buckets that did not match before the first and after the
+        // last bucket that did.
+        unsigned leadingNonMatches() const { return (countLeadingZeros(m_bits) - (sizeof(Bits) * 8 - (width << shift))) >> shift; }
+        unsigned trailingNonMatches() const { return lowestIndex(); }
+
+    private:
+        Bits m_bits;
+    };
+
+#if CONTROL_BYTE_GROUP_SSE2
+
+    class ControlByteGroup {
+    public:
+        static const unsigned width = 16;
+        typedef ControlByteMatch<uint32_t, 0, width> Match;
+
+        explicit ControlByteGroup(const ControlByte* control)
+            : m_control(_mm_loadu_si128(reinterpret_cast<const __m128i*>(control)))
+        {
+        }
+
+        Match match(ControlByte tag) const { return Match(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(tag), m_control))); }
+        Match matchEmpty() const { return match(emptyControlByte); }
+        // Empty and deleted are the only negative control bytes.
+        Match matchEmptyOrDeleted() const { return Match(_mm_movemask_epi8(m_control)); }
+
+    private:
+        __m128i m_control;
+    };
+
+#else
+
+    // Groups of 8 control bytes are matched 64 bits at a time, setting the high
+    // bit of each matching byte.
+    class ControlByteGroup {
+    public:
+        static const unsigned width = 8;
+        typedef ControlByteMatch<uint64_t, 3, width> Match;
+
+        explicit ControlByteGroup(const ControlByte* control)
+        {
+#if CONTROL_BYTE_GROUP_NEON
+            m_control = vld1_s8(control);
+#elif CPU(BIG_ENDIAN) || CPU(MIDDLE_ENDIAN)
+            m_control = 0;
+            for (unsigned i = 0; i < width; ++i)
+                m_control |= static_cast<uint64_t>(static_cast<uint8_t>(control[i])) << (i * 8);
+#else
+            memcpy(&m_control, control, sizeof(m_control));
+#endif
+        }
+
+#if CONTROL_BYTE_GROUP_NEON
+        Match match(ControlByte tag) const { return Match(highBits(vceq_s8(m_control, vdup_n_s8(tag)))); }
+        Match matchEmpty() const { return match(emptyControlByte); }
+        Match matchEmptyOrDeleted() const { return Match(highBits(vclt_s8(m_control, vdup_n_s8(0)))); }
+#else
+        // This can report a bucket whose byte is one above a real match, which
+        // only costs a key comparison.
+        Match match(ControlByte tag) const
+        {
+            uint64_t bits = m_control ^ (lowBits * static_cast<uint8_t>(tag));
+            return Match((bits - lowBits) & ~bits & highBits);
+        }
+        // Bit 1 is only clear in the empty byte among the negative ones.
+        Match matchEmpty() const { return Match(m_control & (~m_control << 6) & highBits); }
+        Match matchEmptyOrDeleted() const { return Match(m_control & highBits); }
+#endif
+
+    private:
+#if CONTROL_BYTE_GROUP_NEON
+        static uint64_t highBits(uint8x8_t matches) { return vget_lane_u64(vreinterpret_u64_u8(matches), 0) & 0x8080808080808080ull; }
+
+        int8x8_t m_control;
+#else
+        static const uint64_t lowBits = 0x0101010101010101ull;
+        static const uint64_t highBits = 0x8080808080808080ull;
+
+        uint64_t m_control;
+#endif
+    };
+
+#endif
+
+    template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
+    class ControlByteHashTable;
+    template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
+    class ControlByteHashTableIterator;
+
+    template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
+    class ControlByteHashTableConstIterator {
+    private:
+        typedef ControlByteHashTableIterator<Key, Value, Extractor, HashFunctions, Traits, KeyTraits> iterator;
+        typedef ControlByteHashTableConstIterator<Key, Value, Extractor, HashFunctions, Traits, KeyTraits> const_iterator;
+        typedef Value ValueType;
+        typedef const ValueType& ReferenceType;
+        typedef const ValueType* PointerType;
+
+        friend class ControlByteHashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>;
+        friend class ControlByteHashTableIterator<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>;
+
+        void skipEmptyBuckets()
+        {
+            while (m_position != m_endPosition && !isFullControlByte(*m_control)) {
+                ++m_position;
+                ++m_control;
+            }
+        }
+
+        ControlByteHashTableConstIterator(PointerType position, PointerType endPosition, const ControlByte* control)
+            : m_position(position), m_endPosition(endPosition), m_control(control)
+        {
+            skipEmptyBuckets();
+        }
+
+        ControlByteHashTableConstIterator(PointerType position, PointerType endPosition, const ControlByte* control, HashItemKnownGoodTag)
+            : m_position(position), m_endPosition(endPosition), m_control(control)
+        {
+        }
+
+    public:
+        ControlByteHashTableConstIterator()
+            : m_position(0), m_endPosition(0), m_control(0)
+        {
+        }
+
+        PointerType get() const { return m_position; }
+        ReferenceType operator*() const { return *get(); }
+        PointerType operator->() const { return get(); }
+
+        const_iterator& operator++()
+        {
+            ASSERT(m_position != m_endPosition);
+            ++m_position;
+            ++m_control;
+            skipEmptyBuckets();
+            return *this;
+        }
+
+        // postfix ++ intentionally omitted
+
+        bool operator==(const const_iterator& other) const { return m_position == other.m_position; }
+        bool operator!=(const const_iterator& other) const { return m_position != other.m_position; }
+
+    private:
+        PointerType m_position;
+        PointerType m_endPosition;
+        const ControlByte* m_control;
+    };
+
+    template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
+    class ControlByteHashTableIterator {
+    private:
+        typedef ControlByteHashTableIterator<Key, Value, Extractor, HashFunctions, Traits, KeyTraits> iterator;
+        typedef ControlByteHashTableConstIterator<Key, Value, Extractor, HashFunctions, Traits, KeyTraits> const_iterator;
+        typedef Value ValueType;
+        typedef ValueType& ReferenceType;
+        typedef ValueType* PointerType;
+
+        friend class ControlByteHashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>;
+
+        ControlByteHashTableIterator(PointerType pos, PointerType end, const ControlByte* control) : m_iterator(pos, end, control) { }
+        ControlByteHashTableIterator(PointerType pos, PointerType end, const ControlByte* control, HashItemKnownGoodTag tag) : m_iterator(pos, end, control, tag) { }
+
+    public:
+        ControlByteHashTableIterator() { }
+
+        PointerType get() const { return const_cast<PointerType>(m_iterator.get()); }
+        ReferenceType operator*() const { return *get(); }
+        PointerType operator->() const { return get(); }
+
+        iterator& operator++() { ++m_iterator; return *this; }
+
+        // postfix ++ intentionally omitted
+
+        bool operator==(const iterator& other) const { return m_iterator == other.m_iterator; }
+        bool operator!=(const iterator& other) const { return m_iterator != other.m_iterator; }
+
+        operator const_iterator() const { return m_iterator; }
+
+    private:
+        const_iterator m_iterator;
+    };
+
+    template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
+    class ControlByteHashTable {
+    public:
+        typedef ControlByteHashTableIterator<Key, Value, Extractor, HashFunctions, Traits, KeyTraits> iterator;
+        typedef ControlByteHashTableConstIterator<Key, Value, Extractor, HashFunctions, Traits, KeyTraits> const_iterator;
+        typedef Traits ValueTraits;
+        typedef Key KeyType;
+        typedef Value ValueType;
+        typedef IdentityHashTranslator<Key, Value, HashFunctions> IdentityTranslatorType;
+
+        ControlByteHashTable();
+        ~ControlByteHashTable() { deallocateTable(m_table, m_tableSize); }
+
+        ControlByteHashTable(const ControlByteHashTable&);
+        void swap(ControlByteHashTable&);
+        ControlByteHashTable& operator=(const ControlByteHashTable&);
+
+        iterator begin() { return iterator(m_table, m_table + m_tableSize, m_control); }
+        iterator end() { return makeKnownGoodIterator(m_table + m_tableSize); }
+        const_iterator begin() const { return const_iterator(m_table, m_table + m_tableSize, m_control); }
+        const_iterator end() const { return makeKnownGoodConstIterator(m_table + m_tableSize); }
+
+        int size() const { return m_keyCount; }
+        int capacity() const { return m_tableSize; }
+        bool isEmpty() const { return !m_keyCount; }
+
+        pair<iterator, bool> add(const ValueType& value) { return add<KeyType, ValueType, IdentityTranslatorType>(Extractor::extract(value), value); }
+
+        // Same as HashTable::add() and HashTable::addPassingHashCode().
+        template<typename T, typename Extra, typename HashTranslator> pair<iterator, bool> add(const T& key, const Extra&);
+        template<typename T, typename Extra, typename HashTranslator> pair<iterator, bool> addPassingHashCode(const T& key, const Extra&);
+
+        iterator find(const KeyType& key) { return find<KeyType, IdentityTranslatorType>(key); }
+        const_iterator find(const KeyType& key) const { return find<KeyType, IdentityTranslatorType>(key); }
+        bool contains(const KeyType& key) const { return contains<KeyType, IdentityTranslatorType>(key); }
+
+        template <typename T, typename HashTranslator> iterator find(const T&);
+        template <typename T, typename HashTranslator> const_iterator find(const T&) const;
+        template <typename T, typename HashTranslator> bool contains(const T&) const;
+
+        void remove(const KeyType&);
+        void remove(iterator);
+        void removeWithoutEntryConsistencyCheck(iterator);
+        void removeWithoutEntryConsistencyCheck(const_iterator);
+        void clear();
+
+        ValueType* lookup(const Key& key) { return lookup<Key, IdentityTranslatorType>(key); }
+        template<typename T, typename HashTranslator> ValueType* lookup(const T&);
+
+#if !ASSERT_DISABLED
+        void checkTableConsistency() const;
+#else
+        static void checkTableConsistency() { }
+#endif
+#if CHECK_HASHTABLE_CONSISTENCY
+        void internalCheckTableConsistency() const { checkTableConsistency(); }
+        void internalCheckTableConsistencyExceptSize() const { checkTableConsistencyExceptSize(); }
+#else
+        static void internalCheckTableConsistencyExceptSize() { }
+        static void internalCheckTableConsistency() { }
+#endif
+
+    private:
+        typedef ControlByteGroup Group;
+        typedef Group::Match Match;
+
+        static ValueType* allocateTable(int size);
+        static void deallocateTable(ValueType* table, int size);
+        static ControlByte* controlBytes(ValueType* table, int size) { return reinterpret_cast<ControlByte*>(table + size); }
+
+        // The low bits of the hash pick the first group, the high bits go in the
+        // control byte so that they tell apart keys that start in the same group.
+        // Bit 31 is left out, string hashes always clear it.
+        static ControlByte controlTag(unsigned hash) { return static_cast<ControlByte>((hash >> 24) & 0x7f); }
+
+        typedef pair<ValueType*, bool> LookupType;
+        typedef pair<LookupType, unsigned> FullLookupType;
+
+        template<typename T, typename HashTranslator> FullLookupType fullLookupForWriting(const T&);
+        int findInsertionIndex(unsigned hash) const;
+        ValueType* prepareInsertion(ValueType*, unsigned hash);
+        void setControl(int index, ControlByte);
+
+        void remove(ValueType*);
+
+        bool shouldExpand() const { return (m_keyCount + m_deletedCount + 1) * 8 > m_tableSize * 7; }
+        bool mustRehashInPlace() const { return m_keyCount * 32 <= m_tableSize * 25; }
+        bool shouldShrink() const { return m_keyCount * m_minLoad < m_tableSize && m_tableSize > m_minTableSize; }
+        void expand();
+        void shrink() { rehash(m_tableSize / 2); }
+
+        void rehash(int newTableSize);
+
+        static void initializeBucket(ValueType& bucket) { new (&bucket) ValueType(Traits::emptyValue()); }
+
+        iterator makeKnownGoodIterator(ValueType* pos) { return iterator(pos, m_table + m_tableSize, m_control + (pos - m_table), HashItemKnownGood); }
+        const_iterator makeKnownGoodConstIterator(ValueType* pos) const { return const_iterator(pos, m_table + m_tableSize, m_control + (pos - m_table), HashItemKnownGood); }
+
+#if !ASSERT_DISABLED
+        void checkTableConsistencyExceptSize() const;
+#else
+        static void checkTableConsistencyExceptSize() { }
+#endif
+
+        // A table is never smaller than a group, so a group is never loaded twice in
+        // a probe. The control bytes of the first buckets but one are copied after
+        // the last bucket, so that a group can start at any bucket.
+        static const int m_minTableSize = Group::width < 16 ? 16 : Group::width;
+        static const int m_minLoad = 6;
+
+        ValueType* m_table;
+        ControlByte* m_control;
+        int m_tableSize;
+        int m_tableSizeMask;
+        int m_keyCount;
+        int m_deletedCount;
+    };
+
+    template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
+    inline ControlByteHashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>::ControlByteHashTable()
+        : m_table(0)
+        , m_control(0)
+        , m_tableSize(0)
+        , m_tableSizeMask(0)
+        , m_keyCount(0)
+        , m_deletedCount(0)
+    {
+    }
+
+    template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
+    template<typename T, typename HashTranslator>
+    inline Value* ControlByteHashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>::lookup(const T& key)
+    {
+        if (!m_table)
+            return 0;
+
+        unsigned h = HashTranslator::hash(key);
+        ControlByte tag = controlTag(h);
+        int sizeMask = m_tableSizeMask;
+        int offset = h & sizeMask;
+
+        for (int stride = Group::width; ; stride += Group::width) {
+            Group group(m_control + offset);
+            for (Match matches = group.match(tag); matches.any(); matches.clearLowest()) {
+                ValueType* entry = m_table + ((offset + matches.lowestIndex()) & sizeMask);
+                if (HashTranslator::equal(Extractor::extract(*entry), key))
+                    return entry;
+            }
+            if (group.matchEmpty().any())
+                return 0;
+            offset = (offset + stride) & sizeMask;
+        }
+    }
+
+    template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
+    template<typename T, typename HashTranslator>
+    inline typename ControlByteHashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>::FullLookupType ControlByteHashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>::fullLookupForWriting(const T& key)
+    {
+        ASSERT(m_table);
+
+        unsigned h = HashTranslator::hash(key);
+        ControlByte tag = controlTag(h);
+        int sizeMask = m_tableSizeMask;
+        int offset = h & sizeMask;
+        ValueType* insertionEntry = 0;
+
+        for (int stride = Group::width; ; stride += Group::width) {
+            Group group(m_control + offset);
+            for (Match matches = group.match(tag); matches.any(); matches.clearLowest()) {
+                ValueType* entry = m_table + ((offset + matches.lowestIndex()) & sizeMask);
+                if (HashTranslator::equal(Extractor::extract(*entry), key))
+                    return FullLookupType(LookupType(entry, true), h);
+            }
+            if (!insertionEntry) {
+                Match available = group.matchEmptyOrDeleted();
+                if (available.any())
+                    insertionEntry = m_table + ((offset + available.lowestIndex()) & sizeMask);
+            }
+            if (group.matchEmpty().any())
+                return FullLookupType(LookupType(insertionEntry, false), h);
+            offset = (offset + stride) & sizeMask;
+        }
+    }
+
+    template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
+    int ControlByteHashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>::findInsertionIndex(unsigned h) const
+    {
+        int sizeMask = m_tableSizeMask;
+        int offset = h & sizeMask;
+        for (int stride = Group::width; ; stride += Group::width) {
+            Match available = Group(m_control + offset).matchEmptyOrDeleted();
+            if (available.any())
+                return (offset + available.lowestIndex()) & sizeMask;
+            offset = (offset + stride) & sizeMask;
+        }
+    }
+
+    template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
+    inline void ControlByteHashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>::setControl(int index, ControlByte control)
+    {
+        m_control[index] = control;
+        if (index < static_cast<int>(Group::width) - 1)
+            m_control[m_tableSize + index] = control;
+    }
+
+    template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
+    inline Value* ControlByteHashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>::prepareInsertion(ValueType* entry, unsigned h)
+    {
+        int index = entry - m_table;
+        // Reusing a deleted bucket does not make probes any longer, so only an
+        // empty one can make the table grow. That is done before inserting, so
+        // the new entry does not have to be looked up again.
+        if (m_control[index] == emptyControlByte && shouldExpand()) {
+            expand();
+            index = findInsertionIndex(h);
+        }
+        if (m_control[index] == deletedControlByte)
+            --m_deletedCount;
+        setControl(index, controlTag(h));
+        ++m_keyCount;
+        return m_table + index;
+    }
+
+    template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
+    template<typename T, typename Extra, typename HashTranslator>
+    inline pair<typename ControlByteHashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>::iterator, bool> ControlByteHashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>::add(const T& key, const Extra& extra)
+    {
+        if (!m_table)
+            expand();
+
+        internalCheckTableConsistency();
+
+        FullLookupType lookupResult = fullLookupForWriting<T, HashTranslator>(key);
+        if (lookupResult.first.second)
+            return std::make_pair(makeKnownGoodIterator(lookupResult.first.first), false);
+
+        ValueType* entry = prepareInsertion(lookupResult.first.first, lookupResult.second);
+        HashTranslator::translate(*entry, key, extra);
+
+        internalCheckTableConsistency();
+
+        return std::make_pair(makeKnownGoodIterator(entry), true);
+    }
+
+    template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
+    template<typename T, typename Extra, typename HashTranslator>
+    inline pair<typename ControlByteHashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>::iterator, bool> ControlByteHashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>::addPassingHashCode(const T& key, const Extra& extra)
+    {
+        if (!m_table)
+            expand();
+
+        internalCheckTableConsistency();
+
+        FullLookupType lookupResult = fullLookupForWriting<T, HashTranslator>(key);
+        if (lookupResult.first.second)
+            return std::make_pair(makeKnownGoodIterator(lookupResult.first.first), false);
+
+        unsigned h = lookupResult.second;
+        ValueType* entry = prepareInsertion(lookupResult.first.first, h);
+        HashTranslator::translate(*entry, key, extra, h);
+
+        internalCheckTableConsistency();
+
+        return std::make_pair(makeKnownGoodIterator(entry), true);
+    }
+
+    template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
+    template <typename T, typename HashTranslator>
+    typename ControlByteHashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>::iterator ControlByteHashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>::find(const T& key)
+    {
+        ValueType* entry = lookup<T, HashTranslator>(key);
+        if (!entry)
+            return end();
+
+        return makeKnownGoodIterator(entry);
+    }
+
+    template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
+    template <typename T, typename HashTranslator>
+    typename ControlByteHashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>::const_iterator ControlByteHashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>::find(const T& key) const
+    {
+        ValueType* entry = const_cast<ControlByteHashTable*>(this)->lookup<T, HashTranslator>(key);
+        if (!entry)
+            return end();
+
+        return makeKnownGoodConstIterator(entry);
+    }
+
+    template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
+    template <typename T, typename HashTranslator>
+    bool ControlByteHashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>::contains(const T& key) const
+    {
+        return const_cast<ControlByteHashTable*>(this)->lookup<T, HashTranslator>(key);
+    }
+
+    template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
+    void ControlByteHashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>::remove(ValueType* pos)
+    {
+        int index = pos - m_table;
+        pos->~ValueType();
+        initializeBucket(*pos);
+
+        // A probe for another key only went past this bucket if every bucket of
+        // its group was full. If no group that holds this bucket can have been
+        // full, no probe depends on it and it can be empty again.
+        Match emptyBefore = Group(m_control + ((index - Group::width) & m_tableSizeMask)).matchEmpty();
+        Match emptyAfter = Group(m_control + index).matchEmpty();
+        bool wasNeverFull = emptyBefore.any() && emptyAfter.any()
+            && emptyBefore.leadingNonMatches() + emptyAfter.trailingNonMatches() < Group::width;
+        if (wasNeverFull)
+            setControl(index, emptyControlByte);
+        else {
+            setControl(index, deletedControlByte);
+            ++m_deletedCount;
+        }
+        --m_keyCount;
+
+        if (shouldShrink())
+            shrink();
+
+        internalCheckTableConsistency();
+    }
+
+    template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
+    inline void ControlByteHashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>::remove(iterator it)
+    {
+        if (it == end())
+            return;
+
+        internalCheckTableConsistency();
+        remove(const_cast<ValueType*>(it.m_iterator.m_position));
+    }
+
+    template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
+    inline void ControlByteHashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>::removeWithoutEntryConsistencyCheck(iterator it)
+    {
+        if (it == end())
+            return;
+
+        remove(const_cast<ValueType*>(it.m_iterator.m_position));
+    }
+
+    template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
+    inline void ControlByteHashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>::removeWithoutEntryConsistencyCheck(const_iterator it)
+    {
+        if (it == end())
+            return;
+
+        remove(const_cast<ValueType*>(it.m_position));
+    }
+
+    template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
+    inline void ControlByteHashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>::remove(const KeyType& key)
+    {
+        remove(find(key));
+    }
+
+    template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
+    Value* ControlByteHashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>::allocateTable(int size)
+    {
+        // The control bytes follow the buckets in the same block.
+        size_t controlSize = size + Group::width - 1;
+        size_t allocationSize = size * sizeof(ValueType) + controlSize;
+        ValueType* result;
+        if (Traits::emptyValueIsZero)
+            result = static_cast<ValueType*>(fastZeroedMalloc(allocationSize));
+        else {
+            result = static_cast<ValueType*>(fastMalloc(allocationSize));
+            for (int i = 0; i < size; i++)
+                initializeBucket(result[i]);
+        }
+        memset(controlBytes(result, size), emptyControlByte, controlSize);
+        return result;
+    }
+
+    template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
+    void ControlByteHashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>::deallocateTable(ValueType* table, int size)
+    {
+        // Buckets that are not full hold the empty value, which is destroyed too.
+        if (Traits::needsDestruction) {
+            for (int i = 0; i < size; ++i)
+                table[i].~ValueType();
+        }
+        fastFree(table);
+    }
+
+    template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
+    void ControlByteHashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>::expand()
+    {
+        int newSize;
+        if (m_tableSize == 0)
+            newSize = m_minTableSize;
+        else if (mustRehashInPlace())
+            newSize = m_tableSize;
+        else
+            newSize = m_tableSize * 2;
+
+        rehash(newSize);
+    }
+
+    template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
+    void ControlByteHashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>::rehash(int newTableSize)
+    {
+        internalCheckTableConsistencyExceptSize();
+
+        int oldTableSize = m_tableSize;
+        ValueType* oldTable = m_table;
+        ControlByte* oldControl = m_control;
+
+        m_tableSize = newTableSize;
+        m_tableSizeMask = newTableSize - 1;
+        m_table = allocateTable(newTableSize);
+        m_control = controlBytes(m_table, newTableSize);
+
+        for (int i = 0; i != oldTableSize; ++i) {
+            if (!isFullControlByte(oldControl[i]))
+                continue;
+            unsigned h = HashFunctions::hash(Extractor::extract(oldTable[i]));
+            int index = findInsertionIndex(h);
+            setControl(index, controlTag(h));
+            Mover<ValueType, Traits::needsDestruction>::move(oldTable[i], m_table[index]);
+        }
+
+        m_deletedCount = 0;
+
+        deallocateTable(oldTable, oldTableSize);
+
+        internalCheckTableConsistency();
+    }
+
+    template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
+    void ControlByteHashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>::clear()
+    {
+        deallocateTable(m_table, m_tableSize);
+        m_table = 0;
+        m_control = 0;
+        m_tableSize = 0;
+        m_tableSizeMask = 0;
+        m_keyCount = 0;
+        m_deletedCount = 0;
+    }
+
+    template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
+    ControlByteHashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>::ControlByteHashTable(const ControlByteHashTable& other)
+        : m_table(0)
+        , m_control(0)
+        , m_tableSize(0)
+        , m_tableSizeMask(0)
+        , m_keyCount(0)
+        , m_deletedCount(0)
+    {
+        const_iterator end = other.end();
+        for (const_iterator it = other.begin(); it != end; ++it)
+            add(*it);
+    }
+
+    template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
+    void ControlByteHashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>::swap(ControlByteHashTable& other)
+    {
+        std::swap(m_table, other.m_table);
+        std::swap(m_control, other.m_control);
+        std::swap(m_tableSize, other.m_tableSize);
+        std::swap(m_tableSizeMask, other.m_tableSizeMask);
+        std::swap(m_keyCount, other.m_keyCount);
+        std::swap(m_deletedCount, other.m_deletedCount);
+    }
+
+    template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
+    ControlByteHashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>& ControlByteHashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>::operator=(const ControlByteHashTable& other)
+    {
+        ControlByteHashTable tmp(other);
+        swap(tmp);
+        return *this;
+    }
+
+#if !ASSERT_DISABLED
+
+    template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
+    void ControlByteHashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>::checkTableConsistency() const
+    {
+        checkTableConsistencyExceptSize();
+        ASSERT(!m_table || (m_keyCount + m_deletedCount) * 8 <= m_tableSize * 7);
+        ASSERT(!shouldShrink());
+    }
+
+    template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
+    void ControlByteHashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits>::checkTableConsistencyExceptSize() const
+    {
+        if (!m_table)
+            return;
+
+        int count = 0;
+        int deletedCount = 0;
+        for (int j = 0; j < m_tableSize; ++j) {
+            if (j < static_cast<int>(Group::width) - 1)
+                ASSERT(m_control[m_tableSize + j] == m_control[j]);
+
+            if (m_control[j] == emptyControlByte)
+                continue;
+
+            if (m_control[j] == deletedControlByte) {
+                ++deletedCount;
+                continue;
+            }
+
+            const ValueType* entry = m_table + j;
+            ASSERT(m_control[j] == controlTag(HashFunctions::hash(Extractor::extract(*entry))));
+            const_iterator it = find(Extractor::extract(*entry));
+            ASSERT_UNUSED(it, entry == it.m_position);
+            ++count;
+
+            ValueCheck<Key>::checkConsistency(Extractor::extract(*entry));
+        }
+
+        ASSERT(count == m_keyCount);
+        ASSERT(deletedCount == m_deletedCount);
+        ASSERT(m_tableSize >= m_minTableSize);
+        ASSERT(m_tableSize == m_tableSizeMask + 1);
+        ASSERT(m_control == controlBytes(m_table, m_tableSize));
+    }
+
+#endif // ASSERT_DISABLED
+
+    // Key traits that make a HashMap or HashSet use a ControlByteHashTable.
+    template<typename BaseTraits> struct ControlByteHashTraits : BaseTraits {
+    };
+
+    // The table a HashMap or HashSet is built on, picked by its key traits.
+    template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename KeyTraits>
+    struct HashTableForKeyTraits {
+        typedef HashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits> Type;
+    };
+
+    template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits, typename BaseKeyTraits>
+    struct HashTableForKeyTraits<Key, Value, Extractor, HashFunctions, Traits, ControlByteHashTraits<BaseKeyTraits> > {
+        typedef ControlByteHashTable<Key, Value, Extractor, HashFunctions, Traits, ControlByteHashTraits<BaseKeyTraits> > Type;
+    };
+
+} // namespace WTF
+
+using WTF::ControlByteHashTraits;
+
+#endif // WTF_ControlByteHashTable_h
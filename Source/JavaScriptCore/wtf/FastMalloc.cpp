@@ -380,6 +380,11 @@ FastMallocStatistics fastMallocStatistics()
     return statistics;
 }
 
+size_t fastMallocThreadStatistics(FastMallocThreadStatistics*, size_t)
+{
+    return 0;
+}
+
 size_t fastMallocSize(const void* p)
 {
 #if OS(DARWIN)
@@ -639,10 +644,20 @@ static const int kMaxFreeListLength = 256;
 
 // Lower and upper bounds on the per-thread cache sizes
 static const size_t kMinThreadCacheSize = kMaxSize * 2;
+#if OS(ANDROID)
+// Android devices have little memory and a handful of threads that allocate
+// (WebCore, textures, network), so each cache is kept small.
+static const size_t kMaxThreadCacheSize = 512 << 10;
+#else
 static const size_t kMaxThreadCacheSize = 2 << 20;
+#endif
 
 // Default bound on the total amount of thread caches
+#if OS(ANDROID)
+static const size_t kDefaultOverallThreadCacheSize = 4 << 20;
+#else
 static const size_t kDefaultOverallThreadCacheSize = 16 << 20;
+#endif
 
 // For all span-lengths < kMaxPages we keep an exact-size list.
 // REQUIRED: kMaxPages >= kMinSystemAlloc;
@@ -1285,7 +1300,11 @@ template <> class MapSelector<32> {
 
 // Time delay before the page heap scavenger will consider returning pages to
 // the OS.
+#if OS(ANDROID)
+static const int kScavengeDelayInSeconds = 1;
+#else
 static const int kScavengeDelayInSeconds = 2;
+#endif
 
 // Approximate percentage of free committed pages to return to the OS in one
 // scavenge.
@@ -1296,7 +1315,12 @@ static const int kMinSpanListsWithSpans = 32;
 
 // Number of free committed pages that we want to keep around.  The minimum number of pages used when there
 // is 1 span in each of the first kMinSpanListsWithSpans spanlists.  Currently 528 pages.
+#if OS(ANDROID)
+// On Android only 512KB are kept; anything above that is madvised away.
+static const size_t kMinimumFreeCommittedPageCount = 128;
+#else
 static const size_t kMinimumFreeCommittedPageCount = kMinSpanListsWithSpans * ((1.0f+kMinSpanListsWithSpans) / 2.0f);
+#endif
 
 #endif
 
@@ -2246,6 +2270,10 @@ class TCMalloc_ThreadCache {
   uint32_t      rnd_;                   // Cheap random number generator
   size_t        bytes_until_sample_;    // Bytes until we sample next
 
+  // Trips to the central cache, each of which takes its lock
+  size_t        central_fetches_;
+  size_t        central_releases_;
+
   // Allocate a new heap. REQUIRES: pageheap_lock is held.
   static inline TCMalloc_ThreadCache* NewHeap(ThreadIdentifier tid);
 
@@ -2265,6 +2293,9 @@ class TCMalloc_ThreadCache {
   // Total byte size in cache
   size_t Size() const { return size_; }
 
+  size_t central_fetches() const { return central_fetches_; }
+  size_t central_releases() const { return central_releases_; }
+
   ALWAYS_INLINE void* Allocate(size_t size);
   void Deallocate(void* ptr, size_t size_class);
 
@@ -2864,6 +2895,8 @@ void TCMalloc_ThreadCache::Init(ThreadIdentifier tid) {
   prev_ = NULL;
   tid_  = tid;
   in_setspecific_ = false;
+  central_fetches_ = 0;
+  central_releases_ = 0;
   for (size_t cl = 0; cl < kNumClasses; ++cl) {
     list_[cl].Init();
   }
@@ -2916,6 +2949,7 @@ ALWAYS_INLINE void TCMalloc_ThreadCache::FetchFromCentralCache(size_t cl, size_t
   central_cache[cl].RemoveRange(&start, &end, &fetch_count);
   list_[cl].PushRange(fetch_count, start, end);
   size_ += allocationSize * fetch_count;
+  ++central_fetches_;
 }
 
 // Remove some objects of class "cl" from thread heap and add to central cache
@@ -2924,6 +2958,7 @@ inline void TCMalloc_ThreadCache::ReleaseToCentralCache(size_t cl, int N) {
   FreeList* src = &list_[cl];
   if (N > src->length()) N = src->length();
   size_ -= N*ByteSizeForClass(cl);
+  ++central_releases_;
 
   // We return prepackaged chains of the correct size to the central cache.
   // TODO: Use the same format internally in the thread caches?
@@ -4276,6 +4311,21 @@ FastMallocStatistics fastMallocStatistics()
     return statistics;
 }
 
+size_t fastMallocThreadStatistics(FastMallocThreadStatistics* statistics, size_t capacity)
+{
+    SpinLockHolder lockHolder(&pageheap_lock);
+    size_t threadCount = 0;
+    for (TCMalloc_ThreadCache* threadCache = thread_heaps; threadCache; threadCache = threadCache->next_) {
+        if (threadCount < capacity) {
+            statistics[threadCount].cacheBytes = threadCache->Size();
+            statistics[threadCount].centralCacheFetches = threadCache->central_fetches();
+            statistics[threadCount].centralCacheReleases = threadCache->central_releases();
+        }
+        ++threadCount;
+    }
+    return threadCount;
+}
+
 size_t fastMallocSize(const void* ptr)
 {
     const PageID p = reinterpret_cast<uintptr_t>(ptr) >> kPageShift;
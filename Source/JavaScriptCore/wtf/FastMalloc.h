@@ -89,6 +89,16 @@ namespace WTF {
     };
     FastMallocStatistics fastMallocStatistics();
 
+    struct FastMallocThreadStatistics {
+        size_t cacheBytes;
+        // Refills from and returns to the central cache, each under its lock.
+        size_t centralCacheFetches;
+        size_t centralCacheReleases;
+    };
+    // Fills in up to capacity entries, one per thread that has a cache, and
+    // returns the number of such threads. Returns 0 with the system malloc.
+    size_t fastMallocThreadStatistics(FastMallocThreadStatistics*, size_t capacity);
+
     // This defines a type which holds an unsigned integer and is the same
     // size as the minimally aligned memory allocation.
     typedef unsigned long long AllocAlignmentInteger;
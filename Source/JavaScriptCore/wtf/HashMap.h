@@ -21,7 +21,7 @@
 #ifndef WTF_HashMap_h
 #define WTF_HashMap_h
 
-#include "HashTable.h"
+#include "ControlByteHashTable.h"
 
 namespace WTF {
 
@@ -44,8 +44,8 @@ namespace WTF {
     private:
         typedef HashArg HashFunctions;
 
-        typedef HashTable<KeyType, ValueType, PairFirstExtractor<ValueType>,
-            HashFunctions, ValueTraits, KeyTraits> HashTableType;
+        typedef typename HashTableForKeyTraits<KeyType, ValueType, PairFirstExtractor<ValueType>,
+            HashFunctions, ValueTraits, KeyTraits>::Type HashTableType;
 
     public:
         typedef HashTableIteratorAdapter<HashTableType, ValueType> iterator;
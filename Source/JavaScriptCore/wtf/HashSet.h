@@ -22,7 +22,7 @@
 #define WTF_HashSet_h
 
 #include "FastAllocBase.h"
-#include "HashTable.h"
+#include "ControlByteHashTable.h"
 
 namespace WTF {
 
@@ -45,8 +45,8 @@ namespace WTF {
         typedef typename ValueTraits::TraitType ValueType;
 
     private:
-        typedef HashTable<ValueType, ValueType, IdentityExtractor<ValueType>,
-            HashFunctions, ValueTraits, ValueTraits> HashTableType;
+        typedef typename HashTableForKeyTraits<ValueType, ValueType, IdentityExtractor<ValueType>,
+            HashFunctions, ValueTraits, ValueTraits>::Type HashTableType;
 
     public:
         typedef HashTableConstIteratorAdapter<HashTableType, ValueType> iterator;
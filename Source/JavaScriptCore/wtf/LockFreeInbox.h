@@ -0,0 +1,130 @@
+/*
+ * Copyright 2012, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef LockFreeInbox_h
+#define LockFreeInbox_h
+
+#include <wtf/Assertions.h>
+#include <wtf/Atomics.h>
+#include <wtf/Deque.h>
+#include <wtf/Noncopyable.h>
+
+namespace WTF {
+
+// A LockFreeInbox lets any number of threads hand values to a consumer
+// without taking a lock. It is a fixed ring of slots, each stamped with a
+// sequence number: a producer claims a slot by advancing the tail with a
+// compare-and-swap, fills it, then publishes it by bumping the slot's
+// sequence. tryPush() fails when the ring is full; callers then take the
+// lock that guards their Deque and alternate takeAll() and tryPush() until
+// the push succeeds. Values must not bypass the ring, or a producer's later
+// value could overtake an earlier one still waiting behind a slot that
+// another producer has claimed but not yet filled.
+//
+// Only one thread may call takeAll() at a time, typically by holding the
+// lock that guards the Deque.
+template<typename T, size_t capacity>
+class LockFreeInbox {
+    WTF_MAKE_NONCOPYABLE(LockFreeInbox);
+public:
+    LockFreeInbox()
+        : m_tail(0)
+        , m_head(0)
+        , m_contendedPushCount(0)
+    {
+        COMPILE_ASSERT(capacity && !(capacity & (capacity - 1)), LockFreeInbox_capacity_is_power_of_two);
+        for (unsigned i = 0; i < capacity; ++i)
+            m_slots[i].sequence = i;
+    }
+
+    // On success the value is visible to the consumer, and the push is a full
+    // memory barrier.
+    bool tryPush(const T& value)
+    {
+        unsigned position = m_tail;
+        Slot* slot;
+        while (true) {
+            slot = &m_slots[position & mask];
+            int difference = static_cast<int>(slot->sequence - position);
+            if (!difference) {
+                if (weakCompareAndSwap(&m_tail, position, position + 1))
+                    break;
+                atomicIncrement(&m_contendedPushCount);
+            } else if (difference < 0)
+                return false;
+            position = m_tail;
+        }
+
+        slot->value = value;
+        storeStoreFence();
+        slot->sequence = position + 1;
+        memoryBarrier();
+        return true;
+    }
+
+    // Appends every published value to the deque, oldest first, and returns
+    // how many were moved. Stops early at a slot that a producer has claimed
+    // but not yet filled; that producer's barrier lets it notice a waiting
+    // consumer afterwards.
+    size_t takeAll(Deque<T>& deque)
+    {
+        size_t count = 0;
+        while (true) {
+            Slot& slot = m_slots[m_head & mask];
+            if (slot.sequence != m_head + 1)
+                break;
+            loadLoadFence();
+            deque.append(slot.value);
+            slot.value = T();
+            storeStoreFence();
+            slot.sequence = m_head + capacity;
+            ++m_head;
+            ++count;
+        }
+        return count;
+    }
+
+    // Number of pushes that lost a race with another producer and retried.
+    unsigned contendedPushCount() const { return static_cast<unsigned>(m_contendedPushCount); }
+
+private:
+    static const unsigned mask = capacity - 1;
+
+    struct Slot {
+        unsigned volatile sequence;
+        T value;
+    };
+
+    Slot m_slots[capacity];
+    unsigned volatile m_tail;
+    unsigned m_head;
+    int volatile m_contendedPushCount;
+};
+
+} // namespace WTF
+
+using WTF::LockFreeInbox;
+
+#endif // LockFreeInbox_h
@@ -31,6 +31,7 @@
 
 #include "CurrentTime.h"
 #include "Deque.h"
+#include "LockFreeInbox.h"
 #include "StdLibExtras.h"
 #include "Threading.h"
 
@@ -86,6 +87,50 @@ static FunctionQueue& functionQueue()
     return staticFunctionQueue;
 }
 
+// Threads queue calls here without taking mainThreadFunctionQueueMutex();
+// they are moved to functionQueue() in batches with the mutex held.
+typedef LockFreeInbox<FunctionWithContext, 256> IncomingFunctions;
+
+static IncomingFunctions& incomingFunctions()
+{
+    DEFINE_STATIC_LOCAL(IncomingFunctions, staticIncomingFunctions, ());
+    return staticIncomingFunctions;
+}
+
+// Set while a dispatch is scheduled but has not started draining yet, so that
+// a burst of calls from other threads schedules the main thread only once.
+static unsigned volatile dispatchScheduled;
+
+static unsigned batchCount;
+static unsigned dispatchedCallCount;
+
+// Must be called with mainThreadFunctionQueueMutex() held.
+static bool takeIncomingFunctions()
+{
+    if (!incomingFunctions().takeAll(functionQueue()))
+        return false;
+    ++batchCount;
+    return true;
+}
+
+static void scheduleDispatchIfNeeded()
+{
+    if (!dispatchScheduled && weakCompareAndSwap(&dispatchScheduled, 0, 1))
+        scheduleDispatchFunctionsOnMainThread();
+}
+
+// Must be called with mainThreadFunctionQueueMutex() held.
+static void queueFunctionWithLock(const FunctionWithContext& invocation)
+{
+    // Draining frees slots; if it frees none, another thread has claimed the
+    // oldest slot and is still filling it.
+    while (!incomingFunctions().tryPush(invocation)) {
+        if (!takeIncomingFunctions())
+            yield();
+    }
+    scheduleDispatchIfNeeded();
+}
+
 
 #if !PLATFORM(MAC)
 
@@ -101,6 +146,7 @@ void initializeMainThread()
 #endif
 
     mainThreadFunctionQueueMutex();
+    incomingFunctions();
     initializeMainThreadPlatform();
 }
 
@@ -111,6 +157,7 @@ static pthread_once_t initializeMainThreadKeyOnce = PTHREAD_ONCE_INIT;
 static void initializeMainThreadOnce()
 {
     mainThreadFunctionQueueMutex();
+    incomingFunctions();
     initializeMainThreadPlatform();
 }
 
@@ -122,6 +169,7 @@ void initializeMainThread()
 static void initializeMainThreadToProcessMainThreadOnce()
 {
     mainThreadFunctionQueueMutex();
+    incomingFunctions();
     initializeMainThreadToProcessMainThreadPlatform();
 }
 
@@ -141,16 +189,24 @@ void dispatchFunctionsFromMainThread()
     if (callbacksPaused)
         return;
 
+    // Calls queued after this point schedule another dispatch, but the loop
+    // below keeps picking them up until both queues are empty.
+    dispatchScheduled = 0;
+    memoryBarrier();
+
     double startTime = currentTime();
 
     FunctionWithContext invocation;
     while (true) {
         {
             MutexLocker locker(mainThreadFunctionQueueMutex());
-            if (!functionQueue().size())
+            if (functionQueue().isEmpty())
+                takeIncomingFunctions();
+            if (functionQueue().isEmpty())
                 break;
             invocation = functionQueue().takeFirst();
         }
+        ++dispatchedCallCount;
 
         invocation.function(invocation.context);
         if (invocation.syncFlag)
@@ -170,14 +226,13 @@ void dispatchFunctionsFromMainThread()
 void callOnMainThread(MainThreadFunction* function, void* context)
 {
     ASSERT(function);
-    bool needToSchedule = false;
-    {
+    FunctionWithContext invocation(function, context);
+    if (!incomingFunctions().tryPush(invocation)) {
         MutexLocker locker(mainThreadFunctionQueueMutex());
-        needToSchedule = functionQueue().size() == 0;
-        functionQueue().append(FunctionWithContext(function, context));
+        queueFunctionWithLock(invocation);
+        return;
     }
-    if (needToSchedule)
-        scheduleDispatchFunctionsOnMainThread();
+    scheduleDispatchIfNeeded();
 }
 
 void callOnMainThreadAndWait(MainThreadFunction* function, void* context)
@@ -191,10 +246,10 @@ void callOnMainThreadAndWait(MainThreadFunction* function, void* context)
 
     ThreadCondition syncFlag;
     Mutex& functionQueueMutex = mainThreadFunctionQueueMutex();
+    // The main thread only picks up queued calls while holding the mutex, so it
+    // cannot run this one and signal before we start waiting.
     MutexLocker locker(functionQueueMutex);
-    functionQueue().append(FunctionWithContext(function, context, &syncFlag));
-    if (functionQueue().size() == 1)
-        scheduleDispatchFunctionsOnMainThread();
+    queueFunctionWithLock(FunctionWithContext(function, context, &syncFlag));
     syncFlag.wait(functionQueueMutex);
 }
 
@@ -203,6 +258,7 @@ void cancelCallOnMainThread(MainThreadFunction* function, void* context)
     ASSERT(function);
 
     MutexLocker locker(mainThreadFunctionQueueMutex());
+    takeIncomingFunctions();
 
     FunctionWithContextFinder pred(FunctionWithContext(function, context));
 
@@ -216,6 +272,17 @@ void cancelCallOnMainThread(MainThreadFunction* function, void* context)
     }
 }
 
+MainThreadQueueStatistics mainThreadQueueStatistics()
+{
+    ASSERT(isMainThread());
+
+    MainThreadQueueStatistics statistics;
+    statistics.contendedCalls = incomingFunctions().contendedPushCount();
+    statistics.batches = batchCount;
+    statistics.dispatchedCalls = dispatchedCallCount;
+    return statistics;
+}
+
 void setMainThreadCallbacksPaused(bool paused)
 {
     ASSERT(isMainThread());
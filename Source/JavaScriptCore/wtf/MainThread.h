@@ -48,6 +48,13 @@ void setMainThreadCallbacksPaused(bool paused);
 
 bool isMainThread();
 
+struct MainThreadQueueStatistics {
+    unsigned contendedCalls; // Calls that raced another thread queueing at the same moment.
+    unsigned batches; // Times the main thread picked up all newly queued calls at once.
+    unsigned dispatchedCalls;
+};
+MainThreadQueueStatistics mainThreadQueueStatistics();
+
 // NOTE: these functions are internal to the callOnMainThread implementation.
 void initializeMainThreadPlatform();
 void scheduleDispatchFunctionsOnMainThread();
@@ -68,4 +75,6 @@ using WTF::callOnMainThreadAndWait;
 using WTF::cancelCallOnMainThread;
 using WTF::setMainThreadCallbacksPaused;
 using WTF::isMainThread;
+using WTF::mainThreadQueueStatistics;
+using WTF::MainThreadQueueStatistics;
 #endif // MainThread_h
@@ -33,6 +33,7 @@
 #include <limits>
 #include <wtf/Assertions.h>
 #include <wtf/Deque.h>
+#include <wtf/LockFreeInbox.h>
 #include <wtf/Noncopyable.h>
 #include <wtf/Threading.h>
 
@@ -47,11 +48,15 @@ namespace WTF {
     // The queue takes ownership of messages and transfer it to the new owner
     // when messages are fetched from the queue.
     // Essentially, MessageQueue acts as a queue of OwnPtr<DataType>.
+    // append() normally does not take the queue's lock: messages land in a
+    // lock-free inbox that readers move into m_queue while holding the lock,
+    // and the lock is only taken to wake a reader that is actually waiting or
+    // when the inbox is full.
     template<typename DataType>
     class MessageQueue {
         WTF_MAKE_NONCOPYABLE(MessageQueue);
     public:
-        MessageQueue() : m_killed(false) { }
+        MessageQueue() : m_waiterCount(0), m_killed(false) { }
         ~MessageQueue();
 
         void append(PassOwnPtr<DataType>);
@@ -74,27 +79,57 @@ namespace WTF {
 
         static double infiniteTime() { return std::numeric_limits<double>::max(); }
 
+        // Number of appends that had to retry because another thread appended at the same time.
+        unsigned contendedAppendCount() const { return m_incoming.contendedPushCount(); }
+
     private:
         static bool alwaysTruePredicate(DataType*) { return true; }
 
+        // Must be called with m_mutex held.
+        void takeIncoming() { m_incoming.takeAll(m_queue); }
+
+        // Must be called with m_mutex held.
+        void appendWithLock(DataType* message)
+        {
+            // Draining frees slots; if it frees none, another producer has
+            // claimed the oldest slot and is still filling it.
+            while (!m_incoming.tryPush(message)) {
+                if (!m_incoming.takeAll(m_queue))
+                    yield();
+            }
+        }
+
         mutable Mutex m_mutex;
         ThreadCondition m_condition;
+        LockFreeInbox<DataType*, 64> m_incoming;
         Deque<DataType*> m_queue;
+        int volatile m_waiterCount;
         bool m_killed;
     };
 
     template<typename DataType>
     MessageQueue<DataType>::~MessageQueue()
     {
+        takeIncoming();
         deleteAllValues(m_queue);
     }
 
     template<typename DataType>
     inline void MessageQueue<DataType>::append(PassOwnPtr<DataType> message)
     {
-        MutexLocker lock(m_mutex);
-        m_queue.append(message.leakPtr());
-        m_condition.signal();
+        DataType* leakedMessage = message.leakPtr();
+        if (!m_incoming.tryPush(leakedMessage)) {
+            MutexLocker lock(m_mutex);
+            appendWithLock(leakedMessage);
+            m_condition.signal();
+            return;
+        }
+        // The push is a full barrier, and waiters count themselves before they
+        // look at the inbox, so either we see the waiter or it sees the message.
+        if (m_waiterCount) {
+            MutexLocker lock(m_mutex);
+            m_condition.signal();
+        }
     }
 
     // Returns true if the queue was empty before the item was added.
@@ -102,8 +137,9 @@ namespace WTF {
     inline bool MessageQueue<DataType>::appendAndCheckEmpty(PassOwnPtr<DataType> message)
     {
         MutexLocker lock(m_mutex);
+        takeIncoming();
         bool wasEmpty = m_queue.isEmpty();
-        m_queue.append(message.leakPtr());
+        appendWithLock(message.leakPtr());
         m_condition.signal();
         return wasEmpty;
     }
@@ -112,6 +148,7 @@ namespace WTF {
     inline void MessageQueue<DataType>::prepend(PassOwnPtr<DataType> message)
     {
         MutexLocker lock(m_mutex);
+        takeIncoming();
         m_queue.prepend(message.leakPtr());
         m_condition.signal();
     }
@@ -132,9 +169,16 @@ namespace WTF {
         MutexLocker lock(m_mutex);
         bool timedOut = false;
 
-        DequeConstIterator<DataType*> found = m_queue.end();
-        while (!m_killed && !timedOut && (found = m_queue.findIf(predicate)) == m_queue.end())
-            timedOut = !m_condition.timedWait(m_mutex, absoluteTime);
+        takeIncoming();
+        DequeConstIterator<DataType*> found = m_queue.findIf(predicate);
+        if (!m_killed && found == m_queue.end()) {
+            // Only readers that are about to sleep make append() take the lock.
+            atomicIncrement(&m_waiterCount);
+            memoryBarrier();
+            while (!m_killed && !timedOut && (takeIncoming(), found = m_queue.findIf(predicate)) == m_queue.end())
+                timedOut = !m_condition.timedWait(m_mutex, absoluteTime);
+            atomicDecrement(&m_waiterCount);
+        }
 
         ASSERT(!timedOut || absoluteTime != infiniteTime());
 
@@ -161,6 +205,7 @@ namespace WTF {
         MutexLocker lock(m_mutex);
         if (m_killed)
             return 0;
+        takeIncoming();
         if (m_queue.isEmpty())
             return 0;
 
@@ -172,6 +217,7 @@ namespace WTF {
     inline void MessageQueue<DataType>::removeIf(Predicate& predicate)
     {
         MutexLocker lock(m_mutex);
+        takeIncoming();
         // See bug 31657 for why this loop looks so weird
         while (true) {
             DequeConstIterator<DataType*> found = m_queue.findIf(predicate);
@@ -190,6 +236,7 @@ namespace WTF {
         MutexLocker lock(m_mutex);
         if (m_killed)
             return true;
+        takeIncoming();
         return m_queue.isEmpty();
     }
 
@@ -679,7 +679,10 @@
 
 #define LOG_DISABLED 1
 // This must be defined before we include FastMalloc.h in config.h.
+// ANDROID_FAST_MALLOC is set by the makefile when ENABLE_FAST_MALLOC is true.
+#if !defined(ANDROID_FAST_MALLOC) || !ANDROID_FAST_MALLOC
 #define USE_SYSTEM_MALLOC 1
+#endif
 
 // USE defines
 #define WTF_USE_PTHREADS 1
@@ -941,6 +944,7 @@
 
 #define HAVE_ERRNO_H 1
 #define HAVE_LANGINFO_H 0
+#define HAVE_MADV_DONTNEED 1
 #define HAVE_MMAP 1
 #define HAVE_SBRK 1
 #define HAVE_STRINGS_H 1
@@ -1060,6 +1064,13 @@
 #define ENABLE_SAMPLING_THREAD 1
 #endif
 
+/* The sampling profiler interrupts the JavaScript thread with SIGPROF and is
+   cheap enough to leave compiled in; until it is started it only costs a
+   store per JavaScript call. */
+#if !defined(ENABLE_SAMPLING_PROFILER) && OS(LINUX)
+#define ENABLE_SAMPLING_PROFILER 1
+#endif
+
 #if !defined(ENABLE_GEOLOCATION)
 #define ENABLE_GEOLOCATION 0
 #endif
@@ -1123,8 +1134,10 @@
 #define ENABLE_JIT 1
 #endif
 
-/* Currently only implemented for JSVALUE64, only tested on PLATFORM(MAC) */
-#if ENABLE(JIT) && USE(JSVALUE64) && PLATFORM(MAC)
+/* Currently only implemented for JSVALUE64 on x86-64, only tested on PLATFORM(MAC).
+   ARMv7 uses the JSVALUE32_64 representation, which the DFG's register allocation
+   and code generation would have to learn before it could be enabled there. */
+#if ENABLE(JIT) && USE(JSVALUE64) && CPU(X86_64) && PLATFORM(MAC)
 #define ENABLE_DFG_JIT 1
 /* Enabled with restrictions to circumvent known performance regressions. */
 #define ENABLE_DFG_JIT_RESTRICTIONS 1
@@ -1275,6 +1288,23 @@
 
 #define ENABLE_JSC_ZOMBIES 0
 
+/* Parallel marking needs helper threads and a compare-and-swap on the mark bitmaps. */
+#if !defined(ENABLE_PARALLEL_GC) && (PLATFORM(MAC) || PLATFORM(IOS) || PLATFORM(ANDROID)) && !ENABLE(SINGLE_THREADED)
+#define ENABLE_PARALLEL_GC 1
+#endif
+
+/* Generational collection needs every store of a cell into the heap to go through a
+   write barrier. The JIT's inline property and array stores do not emit one yet. */
+#if !defined(ENABLE_GGC) && !ENABLE(JIT)
+#define ENABLE_GGC 1
+#endif
+
+/* Incremental marking finds stores into cells it has already traced through the
+   generational write barrier. */
+#if !defined(ENABLE_INCREMENTAL_GC) && ENABLE(GGC)
+#define ENABLE_INCREMENTAL_GC 1
+#endif
+
 /* FIXME: Eventually we should enable this for all platforms and get rid of the define. */
 #if PLATFORM(MAC) || PLATFORM(WIN) || PLATFORM(QT)
 #define WTF_USE_PLATFORM_STRATEGIES 1
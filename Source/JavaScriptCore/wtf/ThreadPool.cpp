@@ -0,0 +1,197 @@
+/*
+ * Copyright 2012, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "ThreadPool.h"
+
+#include "StdLibExtras.h"
+#include <algorithm>
+
+#if OS(WINDOWS)
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#if OS(ANDROID) || OS(LINUX)
+#include <sys/resource.h>
+#endif
+
+namespace WTF {
+
+#if OS(ANDROID) || OS(LINUX)
+// Linux applies setpriority() with PRIO_PROCESS and 0 to the calling thread
+// only. These match ANDROID_PRIORITY_NORMAL and ANDROID_PRIORITY_BACKGROUND.
+static void setCurrentThreadPriority(TaskPriority priority)
+{
+    setpriority(PRIO_PROCESS, 0, priority == TaskPriorityBackground ? 10 : 0);
+}
+#else
+static void setCurrentThreadPriority(TaskPriority)
+{
+}
+#endif
+
+ThreadPool& ThreadPool::shared()
+{
+    AtomicallyInitializedStatic(ThreadPool&, pool = *new ThreadPool);
+    return pool;
+}
+
+unsigned ThreadPool::numberOfProcessorCores()
+{
+#if OS(WINDOWS)
+    SYSTEM_INFO systemInfo;
+    GetSystemInfo(&systemInfo);
+    return std::max<unsigned>(systemInfo.dwNumberOfProcessors, 1);
+#else
+    long result = sysconf(_SC_NPROCESSORS_ONLN);
+    return result > 0 ? result : 1;
+#endif
+}
+
+ThreadPool::ThreadPool()
+    : m_maximumThreadCount(numberOfProcessorCores())
+    , m_threadCount(0)
+    , m_idleThreadCount(0)
+{
+}
+
+void ThreadPool::dispatch(TaskKind& kind, TaskFunction* function, void* context, TaskGroup* group)
+{
+    Task task = { &kind, function, context, group };
+
+    MutexLocker locker(m_lock);
+    m_queues[kind.m_priority].append(task);
+    if (group)
+        ++group->m_pendingCount;
+
+    if (m_idleThreadCount) {
+        m_taskQueued.signal();
+        return;
+    }
+    if (m_threadCount >= m_maximumThreadCount)
+        return;
+    if (ThreadIdentifier thread = createThread(workerThreadStart, this, "WTF::ThreadPool")) {
+        detachThread(thread);
+        ++m_threadCount;
+    }
+}
+
+void ThreadPool::wait(TaskGroup& group)
+{
+    MutexLocker locker(m_lock);
+    while (group.m_pendingCount) {
+        Task task;
+        if (!takeTask(task, &group)) {
+            m_taskFinished.wait(m_lock);
+            continue;
+        }
+        m_lock.unlock();
+        task.function(task.context);
+        m_lock.lock();
+        finishTask(task);
+    }
+}
+
+void ThreadPool::setMaximumThreadCount(unsigned count)
+{
+    MutexLocker locker(m_lock);
+    m_maximumThreadCount = std::max(count, 1U);
+    // Idle workers above the limit wake up to exit.
+    m_taskQueued.broadcast();
+}
+
+unsigned ThreadPool::maximumThreadCount() const
+{
+    MutexLocker locker(m_lock);
+    return m_maximumThreadCount;
+}
+
+void* ThreadPool::workerThreadStart(void* pool)
+{
+    static_cast<ThreadPool*>(pool)->workerThreadBody();
+    return 0;
+}
+
+void ThreadPool::workerThreadBody()
+{
+    TaskPriority threadPriority = TaskPriorityDefault;
+
+    MutexLocker locker(m_lock);
+    while (m_threadCount <= m_maximumThreadCount) {
+        Task task;
+        if (!takeTask(task, 0)) {
+            ++m_idleThreadCount;
+            m_taskQueued.wait(m_lock);
+            --m_idleThreadCount;
+            continue;
+        }
+
+        m_lock.unlock();
+        TaskPriority priority = task.kind->m_priority == TaskPriorityBackground ? TaskPriorityBackground : TaskPriorityDefault;
+        if (priority != threadPriority) {
+            setCurrentThreadPriority(priority);
+            threadPriority = priority;
+        }
+        task.function(task.context);
+        m_lock.lock();
+        finishTask(task);
+    }
+    --m_threadCount;
+}
+
+bool ThreadPool::takeTask(Task& result, TaskGroup* onlyFromGroup)
+{
+    for (unsigned priority = 0; priority < numberOfPriorities; ++priority) {
+        Deque<Task>& queue = m_queues[priority];
+        Deque<Task>::iterator end = queue.end();
+        for (Deque<Task>::iterator it = queue.begin(); it != end; ++it) {
+            if (onlyFromGroup && it->group != onlyFromGroup)
+                continue;
+            if (it->kind->m_runningCount >= it->kind->m_maximumConcurrency)
+                continue;
+            result = *it;
+            queue.remove(it);
+            ++result.kind->m_runningCount;
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::finishTask(const Task& task)
+{
+    --task.kind->m_runningCount;
+    if (task.group)
+        --task.group->m_pendingCount;
+    // A task held back by its kind's limit may be able to run now, either on
+    // an idle worker or on a thread waiting for its group.
+    if (m_idleThreadCount)
+        m_taskQueued.signal();
+    m_taskFinished.broadcast();
+}
+
+} // namespace WTF
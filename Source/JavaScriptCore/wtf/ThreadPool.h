@@ -0,0 +1,142 @@
+/*
+ * Copyright 2012, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef ThreadPool_h
+#define ThreadPool_h
+
+#include <wtf/Deque.h>
+#include <wtf/Noncopyable.h>
+#include <wtf/Threading.h>
+
+namespace WTF {
+
+typedef void TaskFunction(void* context);
+
+enum TaskPriority {
+    TaskPriorityUserBlocking, // Someone is waiting on the result right now.
+    TaskPriorityDefault,
+    TaskPriorityBackground // Speculative work; runs at a lower thread priority where supported.
+};
+
+// One kind of work, such as font decoding. Limiting how many of its tasks
+// may run at once keeps a busy subsystem from taking every worker, and lets
+// work that serializes on a lock of its own ask for a single worker.
+class TaskKind {
+    WTF_MAKE_NONCOPYABLE(TaskKind);
+public:
+    TaskKind(const char* name, TaskPriority priority, unsigned maximumConcurrency)
+        : m_name(name)
+        , m_priority(priority)
+        , m_maximumConcurrency(maximumConcurrency)
+        , m_runningCount(0)
+    {
+    }
+
+    const char* name() const { return m_name; }
+    TaskPriority priority() const { return m_priority; }
+
+private:
+    friend class ThreadPool;
+
+    const char* m_name;
+    TaskPriority m_priority;
+    unsigned m_maximumConcurrency;
+    unsigned m_runningCount; // Guarded by the pool's lock.
+};
+
+// Counts the unfinished tasks of a batch so that the thread which queued
+// them can wait for all of them with ThreadPool::wait().
+class TaskGroup {
+    WTF_MAKE_NONCOPYABLE(TaskGroup);
+public:
+    TaskGroup() : m_pendingCount(0) { }
+    ~TaskGroup() { ASSERT(!m_pendingCount); }
+
+private:
+    friend class ThreadPool;
+
+    unsigned m_pendingCount; // Guarded by the pool's lock.
+};
+
+// The worker threads shared by everything in the process that has work to
+// do off the calling thread. Workers are started on demand, up to one per
+// core, and run the most urgent queued task whose kind is under its limit.
+class ThreadPool {
+    WTF_MAKE_NONCOPYABLE(ThreadPool);
+public:
+    static ThreadPool& shared();
+
+    static unsigned numberOfProcessorCores();
+
+    void dispatch(TaskKind&, TaskFunction*, void* context, TaskGroup* = 0);
+
+    // Returns once every task of the group has run. Tasks of the group that
+    // no worker has started yet are run on the calling thread meanwhile.
+    void wait(TaskGroup&);
+
+    // Lets the embedder run fewer workers, for example while the device is
+    // thermally throttled. Workers above the limit exit after their task.
+    void setMaximumThreadCount(unsigned);
+    unsigned maximumThreadCount() const;
+
+private:
+    struct Task {
+        TaskKind* kind;
+        TaskFunction* function;
+        void* context;
+        TaskGroup* group;
+    };
+
+    static const unsigned numberOfPriorities = TaskPriorityBackground + 1;
+
+    ThreadPool();
+
+    static void* workerThreadStart(void*);
+    void workerThreadBody();
+
+    // These must be called with m_lock held.
+    bool takeTask(Task&, TaskGroup* onlyFromGroup);
+    void finishTask(const Task&);
+
+    mutable Mutex m_lock;
+    ThreadCondition m_taskQueued;
+    ThreadCondition m_taskFinished;
+    Deque<Task> m_queues[numberOfPriorities];
+    unsigned m_maximumThreadCount;
+    unsigned m_threadCount;
+    unsigned m_idleThreadCount;
+};
+
+} // namespace WTF
+
+using WTF::TaskGroup;
+using WTF::TaskKind;
+using WTF::TaskPriority;
+using WTF::TaskPriorityBackground;
+using WTF::TaskPriorityDefault;
+using WTF::TaskPriorityUserBlocking;
+using WTF::ThreadPool;
+
+#endif // ThreadPool_h
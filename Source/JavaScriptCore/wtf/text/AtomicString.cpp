@@ -35,11 +35,18 @@ using namespace Unicode;
 
 COMPILE_ASSERT(sizeof(AtomicString) == sizeof(String), atomic_string_and_string_must_be_same_size);
 
+// Strings come and go from the table all the time, so it is kept in a table
+// that does not fill up with deleted buckets.
+typedef HashSet<StringImpl*, StringHash, ControlByteHashTraits<HashTraits<StringImpl*> > > AtomicStringTableSet;
+
 class AtomicStringTable {
 public:
     static AtomicStringTable* create()
     {
         AtomicStringTable* table = new AtomicStringTable;
+#if !ASSERT_DISABLED
+        atomicIncrement(&s_liveTableCount);
+#endif
 
         WTFThreadData& data = wtfThreadData();
         data.m_atomicStringTable = table;
@@ -48,36 +55,91 @@ public:
         return table;
     }
 
-    HashSet<StringImpl*>& table()
+    AtomicStringTableSet& table()
     {
         return m_table;
     }
 
+    // True on the thread whose atoms were shared, they are all in its own table.
+    bool holdsSharedAtoms() const { return m_holdsSharedAtoms; }
+    void setHoldsSharedAtoms() { m_holdsSharedAtoms = true; }
+
+#if !ASSERT_DISABLED
+    static int liveTableCount() { return s_liveTableCount; }
+#endif
+
 private:
+    AtomicStringTable()
+        : m_holdsSharedAtoms(false)
+    {
+    }
+
     static void destroy(AtomicStringTable* table)
     {
-        HashSet<StringImpl*>::iterator end = table->m_table.end();
-        for (HashSet<StringImpl*>::iterator iter = table->m_table.begin(); iter != end; ++iter)
-            (*iter)->setIsAtomic(false);
+        AtomicStringTableSet::iterator end = table->m_table.end();
+        for (AtomicStringTableSet::iterator iter = table->m_table.begin(); iter != end; ++iter) {
+            if (!(*iter)->isStatic())
+                (*iter)->setIsAtomic(false);
+        }
         delete table;
+#if !ASSERT_DISABLED
+        atomicDecrement(&s_liveTableCount);
+#endif
     }
 
-    HashSet<StringImpl*> m_table;
+    AtomicStringTableSet m_table;
+    bool m_holdsSharedAtoms;
+#if !ASSERT_DISABLED
+    static int volatile s_liveTableCount;
+#endif
 };
 
-static inline HashSet<StringImpl*>& stringTable()
+#if !ASSERT_DISABLED
+int volatile AtomicStringTable::s_liveTableCount;
+#endif
+
+static inline AtomicStringTable& atomicStringTable()
 {
     // Once possible we should make this non-lazy (constructed in WTFThreadData's constructor).
     AtomicStringTable* table = wtfThreadData().atomicStringTable();
     if (UNLIKELY(!table))
         table = AtomicStringTable::create();
-    return table->table();
+    return *table;
+}
+
+static inline AtomicStringTableSet& stringTable()
+{
+    return atomicStringTable().table();
+}
+
+// The atoms shared by all threads, see AtomicString::shareExistingAtoms(). The
+// set is filled before the pointer is published and never changes afterwards,
+// so it is read without a lock.
+static AtomicStringTableSet* volatile sharedAtoms;
+
+// Returns the shared atoms if the calling thread has to look them up before
+// its own table, 0 otherwise.
+static inline AtomicStringTableSet* sharedAtomsToLookUp()
+{
+    AtomicStringTableSet* atoms = sharedAtoms;
+    if (LIKELY(!atoms) || atomicStringTable().holdsSharedAtoms())
+        return 0;
+    // Pairs with the storeStoreFence() in shareExistingAtoms(), so the
+    // contents of the set are seen once the pointer is.
+    loadLoadFence();
+    return atoms;
 }
 
 template<typename T, typename HashTranslator>
 static inline PassRefPtr<StringImpl> addToStringTable(const T& value)
 {
-    pair<HashSet<StringImpl*>::iterator, bool> addResult = stringTable().add<T, HashTranslator>(value);
+    if (AtomicStringTableSet* atoms = sharedAtomsToLookUp()) {
+        AtomicStringTableSet::iterator shared = atoms->find<T, HashTranslator>(value);
+        if (shared != atoms->end())
+            return *shared;
+    }
+
+    pair<AtomicStringTableSet::iterator, bool> addResult = stringTable().add<T, HashTranslator>(value);
 
     // If the string is newly-translated, then we need to adopt it.
     // The boolean in the pair tells us if that is so.
@@ -192,6 +254,32 @@ struct UCharBufferTranslator {
     }
 };
 
+struct LCharBuffer {
+    const LChar* s;
+    unsigned length;
+};
+
+// Atomizes Latin-1 input without first widening it into a temporary UChar buffer;
+// the characters are only widened once, when a new StringImpl is actually created.
+struct LCharBufferTranslator {
+    static unsigned hash(const LCharBuffer& buf)
+    {
+        return StringHasher::computeHash(buf.s, buf.length);
+    }
+
+    static bool equal(StringImpl* const& str, const LCharBuffer& buf)
+    {
+        return WTF::equal(str, buf.s, buf.length);
+    }
+
+    static void translate(StringImpl*& location, const LCharBuffer& buf, unsigned hash)
+    {
+        location = StringImpl::create(buf.s, buf.length).leakRef();
+        location->setHash(hash);
+        location->setIsAtomic(true);
+    }
+};
+
 struct HashAndCharacters {
     unsigned hash;
     const UChar* characters;
@@ -277,6 +365,18 @@ PassRefPtr<StringImpl> AtomicString::add(const UChar* s, unsigned length)
     return addToStringTable<UCharBuffer, UCharBufferTranslator>(buffer);
 }
 
+PassRefPtr<StringImpl> AtomicString::add(const LChar* s, unsigned length)
+{
+    if (!s)
+        return 0;
+
+    if (!length)
+        return StringImpl::empty();
+
+    LCharBuffer buffer = { s, length };
+    return addToStringTable<LCharBuffer, LCharBufferTranslator>(buffer);
+}
+
 PassRefPtr<StringImpl> AtomicString::add(const UChar* s, unsigned length, unsigned existingHash)
 {
     ASSERT(s);
@@ -313,6 +413,12 @@ PassRefPtr<StringImpl> AtomicString::addSlowCase(StringImpl* r)
     if (!r->length())
         return StringImpl::empty();
 
+    if (AtomicStringTableSet* atoms = sharedAtomsToLookUp()) {
+        AtomicStringTableSet::iterator shared = atoms->find(r);
+        if (shared != atoms->end())
+            return *shared;
+    }
+
     StringImpl* result = *stringTable().add(r).first;
     if (result == r)
         r->setIsAtomic(true);
@@ -328,7 +434,13 @@ AtomicStringImpl* AtomicString::find(const UChar* s, unsigned length, unsigned e
         return static_cast<AtomicStringImpl*>(StringImpl::empty());
 
     HashAndCharacters buffer = { existingHash, s, length }; 
-    HashSet<StringImpl*>::iterator iterator = stringTable().find<HashAndCharacters, HashAndCharactersTranslator>(buffer);
+    if (AtomicStringTableSet* atoms = sharedAtomsToLookUp()) {
+        AtomicStringTableSet::iterator shared = atoms->find<HashAndCharacters, HashAndCharactersTranslator>(buffer);
+        if (shared != atoms->end())
+            return static_cast<AtomicStringImpl*>(*shared);
+    }
+
+    AtomicStringTableSet::iterator iterator = stringTable().find<HashAndCharacters, HashAndCharactersTranslator>(buffer);
     if (iterator == stringTable().end())
         return 0;
     return static_cast<AtomicStringImpl*>(*iterator);
@@ -339,6 +451,29 @@ void AtomicString::remove(StringImpl* r)
     stringTable().remove(r);
 }
 
+void AtomicString::shareExistingAtoms()
+{
+    if (sharedAtoms)
+        return;
+
+    // Atoms another thread made before now would not be the shared ones.
+    AtomicStringTable& table = atomicStringTable();
+    ASSERT(AtomicStringTable::liveTableCount() == 1);
+    AtomicStringTableSet* atoms = new AtomicStringTableSet;
+    AtomicStringTableSet::iterator end = table.table().end();
+    for (AtomicStringTableSet::iterator iter = table.table().begin(); iter != end; ++iter) {
+        // Whether a string is an identifier is only known to the JavaScript
+        // heap of one thread, such strings stay with it.
+        if ((*iter)->isIdentifier())
+            continue;
+        (*iter)->setIsStatic();
+        atoms->add(*iter);
+    }
+    table.setHoldsSharedAtoms();
+    storeStoreFence();
+    sharedAtoms = atoms;
+}
+
 AtomicString AtomicString::lower() const
 {
     // Note: This is a hot function in the Dromaeo benchmark.
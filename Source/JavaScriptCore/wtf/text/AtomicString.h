@@ -43,6 +43,7 @@ public:
     AtomicString() { }
     AtomicString(const char* s) : m_string(add(s)) { }
     AtomicString(const UChar* s, unsigned length) : m_string(add(s, length)) { }
+    AtomicString(const LChar* s, unsigned length) : m_string(add(s, length)) { }
     AtomicString(const UChar* s, unsigned length, unsigned existingHash) : m_string(add(s, length, existingHash)) { }
     AtomicString(const UChar* s) : m_string(add(s)) { }
     ATOMICSTRING_CONVERSION AtomicString(StringImpl* imp) : m_string(add(imp)) { }
@@ -55,6 +56,13 @@ public:
 
     static AtomicStringImpl* find(const UChar* s, unsigned length, unsigned existingHash);
 
+    // Makes the atoms of the calling thread the atoms of every thread: an
+    // AtomicString made on any thread from one of these strings gets the same
+    // StringImpl, so it can be handed to another thread and compared there.
+    // The strings are never destroyed afterwards. Only the first call does
+    // anything, and it has to come before other threads make AtomicStrings.
+    static void shareExistingAtoms();
+
     operator const String&() const { return m_string; }
     const String& string() const { return m_string; };
 
@@ -118,6 +126,7 @@ private:
     
     static PassRefPtr<StringImpl> add(const char*);
     static PassRefPtr<StringImpl> add(const UChar*, unsigned length);
+    static PassRefPtr<StringImpl> add(const LChar*, unsigned length);
     static PassRefPtr<StringImpl> add(const UChar*, unsigned length, unsigned existingHash);
     static PassRefPtr<StringImpl> add(const UChar*);
     ALWAYS_INLINE PassRefPtr<StringImpl> add(StringImpl* r)
@@ -101,17 +101,15 @@ PassRefPtr<StringImpl> StringImpl::create(const UChar* characters, unsigned leng
     return string.release();
 }
 
-PassRefPtr<StringImpl> StringImpl::create(const char* characters, unsigned length)
+PassRefPtr<StringImpl> StringImpl::create(const LChar* characters, unsigned length)
 {
     if (!characters || !length)
         return empty();
 
     UChar* data;
     RefPtr<StringImpl> string = createUninitialized(length, data);
-    for (unsigned i = 0; i != length; ++i) {
-        unsigned char c = characters[i];
-        data[i] = c;
-    }
+    for (unsigned i = 0; i != length; ++i)
+        data[i] = characters[i];
     return string.release();
 }
 
@@ -134,10 +132,9 @@ PassRefPtr<StringImpl> StringImpl::create(const UChar* characters, unsigned leng
 
 SharedUChar* StringImpl::sharedBuffer()
 {
-    if (m_length < minLengthToShare)
+    // Static strings are shared as they are, they are never changed.
+    if (m_length < minLengthToShare || isStatic())
         return 0;
-    // All static strings are smaller that the minimim length to share.
-    ASSERT(!isStatic());
 
     BufferOwnership ownership = bufferOwnership();
 
@@ -954,6 +951,25 @@ bool equal(const StringImpl* a, const char* b)
     return !b[length];
 }
 
+bool equal(const StringImpl* a, const LChar* b, unsigned length)
+{
+    if (!a)
+        return !b;
+    if (!b)
+        return !a;
+
+    if (a->length() != length)
+        return false;
+
+    const UChar* as = a->characters();
+    for (unsigned i = 0; i != length; ++i) {
+        if (as[i] != b[i])
+            return false;
+    }
+
+    return true;
+}
+
 bool equalIgnoringCase(StringImpl* a, StringImpl* b)
 {
     return CaseFoldingHash::equal(a, b);
@@ -1071,6 +1087,9 @@ PassRefPtr<StringImpl> StringImpl::threadsafeCopy() const
 
 PassRefPtr<StringImpl> StringImpl::crossThreadString()
 {
+    if (isStatic())
+        return this;
+
     if (SharedUChar* sharedBuffer = this->sharedBuffer())
         return adoptRef(new StringImpl(m_data, m_length, sharedBuffer->crossThreadCopy()));
 
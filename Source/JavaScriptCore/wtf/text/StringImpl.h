@@ -54,6 +54,7 @@ namespace WTF {
 struct CStringTranslator;
 struct HashAndCharactersTranslator;
 struct HashAndUTF8CharactersTranslator;
+struct LCharBufferTranslator;
 struct UCharBufferTranslator;
 
 enum TextCaseSensitivity { TextCaseSensitive, TextCaseInsensitive };
@@ -68,6 +69,7 @@ class StringImpl : public StringImplBase {
     friend struct WTF::CStringTranslator;
     friend struct WTF::HashAndCharactersTranslator;
     friend struct WTF::HashAndUTF8CharactersTranslator;
+    friend struct WTF::LCharBufferTranslator;
     friend struct WTF::UCharBufferTranslator;
     friend class AtomicStringImpl;
 private:
@@ -144,7 +146,8 @@ public:
     ~StringImpl();
 
     static PassRefPtr<StringImpl> create(const UChar*, unsigned length);
-    static PassRefPtr<StringImpl> create(const char*, unsigned length);
+    static PassRefPtr<StringImpl> create(const LChar*, unsigned length);
+    static PassRefPtr<StringImpl> create(const char* characters, unsigned length) { return create(reinterpret_cast<const LChar*>(characters), length); }
     static PassRefPtr<StringImpl> create(const char*);
     static PassRefPtr<StringImpl> create(const UChar*, unsigned length, PassRefPtr<SharedUChar> sharedBuffer);
     static ALWAYS_INLINE PassRefPtr<StringImpl> create(PassRefPtr<StringImpl> rep, unsigned offset, unsigned length)
@@ -235,6 +238,10 @@ public:
             m_refCountAndFlags &= ~s_refCountFlagIsAtomic;
     }
 
+    bool isStatic() const { return m_refCountAndFlags & s_refCountFlagStatic; }
+    // After this the string is never destroyed, and may be referenced from any thread.
+    void setIsStatic() { m_refCountAndFlags |= s_refCountFlagStatic; }
+
     unsigned hash() const { if (!m_hash) m_hash = StringHasher::computeHash(m_data, m_length); return m_hash; }
     unsigned existingHash() const { ASSERT(m_hash); return m_hash; }
 
@@ -329,7 +336,6 @@ private:
     static PassRefPtr<StringImpl> createStrippingNullCharactersSlowCase(const UChar*, unsigned length);
     
     BufferOwnership bufferOwnership() const { return static_cast<BufferOwnership>(m_refCountAndFlags & s_refCountMaskBufferOwnership); }
-    bool isStatic() const { return m_refCountAndFlags & s_refCountFlagStatic; }
     const UChar* m_data;
     union {
         void* m_buffer;
@@ -341,6 +347,7 @@ private:
 
 bool equal(const StringImpl*, const StringImpl*);
 bool equal(const StringImpl*, const char*);
+bool equal(const StringImpl*, const LChar*, unsigned length);
 inline bool equal(const char* a, StringImpl* b) { return equal(b, a); }
 
 bool equalIgnoringCase(StringImpl*, StringImpl*);
@@ -41,4 +41,8 @@
 
 COMPILE_ASSERT(sizeof(UChar) == 2, UCharIsTwoBytes);
 
+// Latin-1 code unit. Strings made only of characters below U+0100 can be
+// handed around as LChar buffers and widened to UChar when stored.
+typedef unsigned char LChar;
+
 #endif // WTF_UNICODE_H
@@ -1417,6 +1417,61 @@ class YarrGenerator : private MacroAssembler {
         state.setBacktrackLabel(backtrackBegin);
     }
 
+    void generateBackReference(TermGenerationState& state)
+    {
+        const RegisterID characterOrLength = regT0;
+        const RegisterID patternIndex = regT1;
+        PatternTerm& term = state.term();
+        Address patternStart(output, (term.backReferenceSubpatternId << 1) * sizeof(int));
+        Address patternEnd(output, ((term.backReferenceSubpatternId << 1) + 1) * sizeof(int));
+
+        // The frame holds how far the back reference moved the index, so
+        // that backtracking through it can move it back.
+        storeToFrame(TrustedImm32(0), term.frameLocation);
+
+        // A subpattern that did not take part in the match matches the empty
+        // string.
+        load32(patternStart, patternIndex);
+        Jump unmatchedSubpattern = branch32(Equal, patternIndex, TrustedImm32(-1));
+
+        load32(patternEnd, characterOrLength);
+        sub32(patternIndex, characterOrLength);
+        add32(characterOrLength, index);
+        Jump notEnoughInput = branch32(Above, index, length);
+        sub32(characterOrLength, index);
+        storeToFrame(characterOrLength, term.frameLocation);
+
+        // Walk the index along with the subpattern, it ends up past the
+        // back reference.
+        Label loop(this);
+        Jump matched = branch32(Equal, patternIndex, patternEnd);
+        load16(BaseIndex(input, patternIndex, TimesTwo), characterOrLength);
+        Jump mismatch = branch16(NotEqual, BaseIndex(input, index, TimesTwo, state.inputOffset() * sizeof(UChar)), characterOrLength);
+        add32(TrustedImm32(1), patternIndex);
+        add32(TrustedImm32(1), index);
+        jump(loop);
+
+        mismatch.link(this);
+        load32(patternStart, characterOrLength);
+        sub32(characterOrLength, patternIndex);
+        sub32(patternIndex, index);
+        state.jumpToBacktrack(this);
+
+        notEnoughInput.link(this);
+        sub32(characterOrLength, index);
+        state.jumpToBacktrack(this);
+
+        Label backtrackBegin(this);
+        loadFromFrame(term.frameLocation, characterOrLength);
+        sub32(characterOrLength, index);
+        state.jumpToBacktrack(this);
+
+        unmatchedSubpattern.link(this);
+        matched.link(this);
+
+        state.setBacktrackLabel(backtrackBegin);
+    }
+
     void generateCharacterClassSingle(TermGenerationState& state)
     {
         const RegisterID character = regT0;
@@ -1897,7 +1952,12 @@ class YarrGenerator : private MacroAssembler {
             break;
 
         case PatternTerm::TypeBackReference:
-            m_shouldFallBack = true;
+            // Case insensitive matches need Unicode case folding, and a
+            // quantified back reference can match in more than one way.
+            if (!m_pattern.m_ignoreCase && term.quantityType == QuantifierFixedCount && term.quantityCount == 1)
+                generateBackReference(state);
+            else
+                m_shouldFallBack = true;
             break;
 
         case PatternTerm::TypeForwardReference:
@@ -1918,6 +1978,66 @@ class YarrGenerator : private MacroAssembler {
         }
     }
 
+    void matchFirstCharacter(PatternTerm& term, int inputOffset, JumpList& found)
+    {
+        const RegisterID character = regT0;
+
+        readCharacter(inputOffset, character);
+        if (term.type == PatternTerm::TypePatternCharacter) {
+            UChar ch = term.patternCharacter;
+            if (m_pattern.m_ignoreCase && isASCIIAlpha(ch)) {
+                or32(TrustedImm32(32), character);
+                found.append(branch32(Equal, character, Imm32(Unicode::toLower(ch))));
+            } else {
+                ASSERT(!m_pattern.m_ignoreCase || (Unicode::toLower(ch) == Unicode::toUpper(ch)));
+                found.append(branch32(Equal, character, Imm32(ch)));
+            }
+        } else if (term.invert()) {
+            JumpList notFound;
+            matchCharacterClass(character, notFound, term.characterClass);
+            found.append(jump());
+            notFound.link(this);
+        } else
+            matchCharacterClass(character, found, term.characterClass);
+    }
+
+    // If every match has to start with a given character or character class,
+    // skip over the start positions where it is not found in a tight loop
+    // rather than trying to match the whole alternative at each of them.
+    // The index has been moved on by countChecked, the minimum size of the
+    // alternative, and the input has been checked for it.
+    void generateFirstCharacterScan(PatternAlternative* alternative, int countChecked, JumpList& notEnoughInput)
+    {
+        if (!alternative->m_terms.size() || !countChecked)
+            return;
+
+        PatternTerm& term = alternative->m_terms[0];
+        if (term.inputPosition || term.quantityType != QuantifierFixedCount)
+            return;
+        if (term.type != PatternTerm::TypePatternCharacter && term.type != PatternTerm::TypeCharacterClass)
+            return;
+
+        JumpList foundAtStart;
+        matchFirstCharacter(term, -countChecked, foundAtStart);
+
+        JumpList foundLater;
+        Label scanLoop(this);
+        add32(TrustedImm32(1), index);
+        notEnoughInput.append(branch32(Above, index, length));
+        matchFirstCharacter(term, -countChecked, foundLater);
+        jump(scanLoop);
+
+        // Keep the start position in step, when it is being tracked.
+        foundLater.link(this);
+        if (!m_pattern.m_body->m_hasFixedSize) {
+            move(index, regT0);
+            sub32(Imm32(countChecked), regT0);
+            store32(regT0, Address(output));
+        }
+
+        foundAtStart.link(this);
+    }
+
     void generateDisjunction(PatternDisjunction* disjunction)
     {
         TermGenerationState state(disjunction, 0);
@@ -1950,8 +2070,11 @@ class YarrGenerator : private MacroAssembler {
             countCheckedForCurrentAlternative = countToCheckForFirstAlternative;
         }
 
-        if (setRepeatAlternativeLabels)
+        if (setRepeatAlternativeLabels) {
             firstAlternativeInputChecked = Label(this);
+            if (disjunction->m_alternatives.size() == 1)
+                generateFirstCharacterScan(state.alternative(), countToCheckForFirstAlternative, notEnoughInputForPreviousAlternative);
+        }
 
         while (state.alternativeValid()) {
             PatternAlternative* alternative = state.alternative();
@@ -208,6 +208,7 @@ LOCAL_SRC_FILES += \
 	bindings/js/ScriptState.cpp \
 	bindings/js/ScriptValue.cpp \
 	bindings/js/SerializedScriptValue.cpp \
+	bindings/js/StringSourceProvider.cpp \
 	bindings/js/WorkerScriptController.cpp \
 	\
 	bindings/ScriptControllerBase.cpp \
@@ -614,6 +614,7 @@ LOCAL_SRC_FILES := $(LOCAL_SRC_FILES) \
 	platform/android/SSLKeyGeneratorAndroid.cpp \
 	platform/android/SystemTimeAndroid.cpp \
 	platform/android/TemporaryLinkStubs.cpp \
+	platform/android/TraceEventAndroid.cpp \
 	platform/android/WidgetAndroid.cpp \
 	\
 	platform/animation/Animation.cpp \
@@ -667,7 +668,9 @@ LOCAL_SRC_FILES := $(LOCAL_SRC_FILES) \
 	platform/graphics/android/FontCacheAndroid.cpp \
 	platform/graphics/android/FontCustomPlatformData.cpp \
 	platform/graphics/android/FontDataAndroid.cpp \
+	platform/graphics/android/FontDecoder.cpp \
 	platform/graphics/android/FontPlatformDataAndroid.cpp \
+	platform/graphics/android/FrameTimings.cpp \
 	platform/graphics/android/GaneshContext.cpp \
 	platform/graphics/android/GaneshRenderer.cpp \
 	platform/graphics/android/GLExtras.cpp \
@@ -679,6 +682,7 @@ LOCAL_SRC_FILES := $(LOCAL_SRC_FILES) \
 	platform/graphics/android/GraphicsLayerAndroid.cpp \
 	platform/graphics/android/ImageAndroid.cpp \
 	platform/graphics/android/ImageBufferAndroid.cpp \
+	platform/graphics/android/ImagePredecoder.cpp \
 	platform/graphics/android/ImageSourceAndroid.cpp \
 	platform/graphics/android/ImagesManager.cpp \
 	platform/graphics/android/ImageTexture.cpp \
@@ -686,6 +690,8 @@ LOCAL_SRC_FILES := $(LOCAL_SRC_FILES) \
 	platform/graphics/android/LayerAndroid.cpp \
 	platform/graphics/android/MediaLayer.cpp \
 	platform/graphics/android/MediaTexture.cpp \
+	platform/graphics/android/OperationQueue.cpp \
+	platform/graphics/android/PaintStripOperation.cpp \
 	platform/graphics/android/PaintTileOperation.cpp \
 	platform/graphics/android/PaintedSurface.cpp \
 	platform/graphics/android/PathAndroid.cpp \
@@ -698,7 +704,10 @@ LOCAL_SRC_FILES := $(LOCAL_SRC_FILES) \
 	platform/graphics/android/SharedBufferStream.cpp \
 	platform/graphics/android/ShaderProgram.cpp \
 	platform/graphics/android/SharedTexture.cpp \
+	platform/graphics/android/TextureAtlas.cpp \
+	platform/graphics/android/TextureBudget.cpp \
 	platform/graphics/android/TextureInfo.cpp \
+	platform/graphics/android/TexturePool.cpp \
 	platform/graphics/android/TexturesGenerator.cpp \
 	platform/graphics/android/TilesManager.cpp \
 	platform/graphics/android/TilesProfiler.cpp \
@@ -772,13 +781,15 @@ LOCAL_SRC_FILES := $(LOCAL_SRC_FILES) \
 	platform/image-decoders/skia/ImageDecoderSkia.cpp \
 	platform/image-decoders/gif/GIFImageDecoder.cpp \
 	platform/image-decoders/gif/GIFImageReader.cpp \
+	platform/image-decoders/jpeg/JPEGImageDecoder.cpp \
 	platform/image-decoders/png/PNGImageDecoder.cpp \
 	\
 	platform/image-encoders/skia/JPEGImageEncoder.cpp \
 	platform/image-encoders/skia/PNGImageEncoder.cpp \
 	\
 	platform/leveldb/LevelDBDatabase.cpp \
-	platform/leveldb/LevelDBIterator.cpp \
+	platform/leveldb/LevelDBTransaction.cpp \
+	platform/leveldb/LevelDBWriteBatch.cpp \
 	\
 	platform/mock/DeviceOrientationClientMock.cpp \
 	platform/mock/GeolocationClientMock.cpp \
@@ -362,6 +362,7 @@ v8 {
         bindings/js/ScriptState.cpp \
         bindings/js/ScriptValue.cpp \
         bindings/js/SerializedScriptValue.cpp \
+        bindings/js/StringSourceProvider.cpp \
         bridge/IdentifierRep.cpp \
         bridge/NP_jsobject.cpp \
         bridge/c/CRuntimeObject.cpp \
@@ -36,6 +36,16 @@ using namespace JSC;
 
 namespace WebCore {
 
+// Dead cells are finalized a slice at a time after a collection, so that
+// neither the collection pause nor any single slice is long.
+static const double sweepTimeSlice = 0.005;
+
+#if ENABLE(INCREMENTAL_GC)
+// Marking slices run between other tasks on the main thread and are kept well
+// inside a frame.
+static const double markingTimeSlice = 0.005;
+#endif
+
 static void* collect(void*)
 {
     JSLock lock(SilenceAssertionsOnly);
@@ -51,6 +61,10 @@ GCController& gcController()
 
 GCController::GCController()
     : m_GCTimer(this, &GCController::gcTimerFired)
+    , m_sweepTimer(this, &GCController::sweepTimerFired)
+#if ENABLE(INCREMENTAL_GC)
+    , m_markingTimer(this, &GCController::markingTimerFired)
+#endif
 {
 }
 
@@ -63,13 +77,45 @@ void GCController::garbageCollectSoon()
 void GCController::gcTimerFired(Timer<GCController>*)
 {
     collect(0);
+    m_sweepTimer.startOneShot(0);
+}
+
+void GCController::sweepTimerFired(Timer<GCController>*)
+{
+    JSLock lock(SilenceAssertionsOnly);
+    Heap& heap = JSDOMWindow::commonJSGlobalData()->heap;
+    if (heap.isBusy() || heap.sweepIncrementally(sweepTimeSlice))
+        m_sweepTimer.startOneShot(0);
 }
 
+#if ENABLE(INCREMENTAL_GC)
+void GCController::markIncrementallySoon()
+{
+    if (!m_markingTimer.isActive())
+        m_markingTimer.startOneShot(0);
+}
+
+void GCController::markingTimerFired(Timer<GCController>*)
+{
+    JSLock lock(SilenceAssertionsOnly);
+    Heap& heap = JSDOMWindow::commonJSGlobalData()->heap;
+    // An allocation or an explicit collection may have finished the job already.
+    if (!heap.isMarkingIncrementally())
+        return;
+    if (heap.isBusy() || heap.markIncrementally(markingTimeSlice))
+        m_markingTimer.startOneShot(0);
+    else
+        m_sweepTimer.startOneShot(0);
+}
+#endif
+
 void GCController::garbageCollectNow()
 {
     JSLock lock(SilenceAssertionsOnly);
-    if (!JSDOMWindow::commonJSGlobalData()->heap.isBusy())
+    if (!JSDOMWindow::commonJSGlobalData()->heap.isBusy()) {
         collect(0);
+        m_sweepTimer.startOneShot(0);
+    }
 }
 
 void GCController::garbageCollectOnAlternateThreadForDebugging(bool waitUntilDone)
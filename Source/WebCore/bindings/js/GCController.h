@@ -40,11 +40,23 @@ namespace WebCore {
 
         void garbageCollectOnAlternateThreadForDebugging(bool waitUntilDone); // Used for stress testing.
 
+#if ENABLE(INCREMENTAL_GC)
+        void markIncrementallySoon();
+#endif
+
     private:
         GCController(); // Use gcController() instead
         void gcTimerFired(Timer<GCController>*);
+        void sweepTimerFired(Timer<GCController>*);
+#if ENABLE(INCREMENTAL_GC)
+        void markingTimerFired(Timer<GCController>*);
+#endif
         
         Timer<GCController> m_GCTimer;
+        Timer<GCController> m_sweepTimer;
+#if ENABLE(INCREMENTAL_GC)
+        Timer<GCController> m_markingTimer;
+#endif
     };
 
     // Function to obtain the global GC controller.
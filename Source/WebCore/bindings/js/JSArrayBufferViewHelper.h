@@ -34,11 +34,29 @@
 #include <interpreter/CallFrame.h>
 #include <runtime/ArgList.h>
 #include <runtime/Error.h>
+#include <runtime/JSArray.h>
 #include <runtime/JSObject.h>
 #include <runtime/JSValue.h>
 
 namespace WebCore {
 
+// Typed arrays are most often filled from plain JS arrays, so those are read
+// directly from their storage rather than through a property lookup for each
+// element.
+inline uint32_t arrayLikeLength(JSC::ExecState* exec, JSC::JSObject* array)
+{
+    if (JSC::isJSArray(&exec->globalData(), array))
+        return JSC::asArray(array)->length();
+    return array->get(exec, exec->propertyNames().length).toUInt32(exec);
+}
+
+inline JSC::JSValue arrayLikeIndex(JSC::ExecState* exec, JSC::JSObject* array, unsigned index)
+{
+    if (JSC::isJSArray(&exec->globalData(), array) && JSC::asArray(array)->canGetIndex(index))
+        return JSC::asArray(array)->getIndex(index);
+    return array->get(exec, index);
+}
+
 template <class T>
 JSC::JSValue setWebGLArrayHelper(JSC::ExecState* exec, T* impl, T* (*conversionFunc)(JSC::JSValue))
 {
@@ -63,14 +81,14 @@ JSC::JSValue setWebGLArrayHelper(JSC::ExecState* exec, T* impl, T* (*conversionF
         uint32_t offset = 0;
         if (exec->argumentCount() == 2)
             offset = exec->argument(1).toInt32(exec);
-        uint32_t length = array->get(exec, JSC::Identifier(exec, "length")).toInt32(exec);
+        uint32_t length = arrayLikeLength(exec, array);
         if (offset > impl->length()
             || offset + length > impl->length()
             || offset + length < offset)
             setDOMException(exec, INDEX_SIZE_ERR);
         else {
             for (uint32_t i = 0; i < length; i++) {
-                JSC::JSValue v = array->get(exec, i);
+                JSC::JSValue v = arrayLikeIndex(exec, array, i);
                 if (exec->hadException())
                     return JSC::jsUndefined();
                 impl->set(i + offset, v.toNumber(exec));
@@ -134,7 +152,7 @@ PassRefPtr<C> constructArrayBufferView(JSC::ExecState* exec)
             return view;
     
         JSC::JSObject* srcArray = asObject(exec->argument(0));
-        uint32_t length = srcArray->get(exec, JSC::Identifier(exec, "length")).toUInt32(exec);
+        uint32_t length = arrayLikeLength(exec, srcArray);
         RefPtr<C> array = C::create(length);
         if (!array) {
             setDOMException(exec, INDEX_SIZE_ERR);
@@ -142,7 +160,7 @@ PassRefPtr<C> constructArrayBufferView(JSC::ExecState* exec)
         }
 
         for (unsigned i = 0; i < length; ++i) {
-            JSC::JSValue v = srcArray->get(exec, i);
+            JSC::JSValue v = arrayLikeIndex(exec, srcArray, i);
             array->set(i, v.toNumber(exec));
         }
         return array;
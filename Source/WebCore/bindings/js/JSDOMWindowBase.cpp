@@ -27,6 +27,7 @@
 #include "Console.h"
 #include "DOMWindow.h"
 #include "Frame.h"
+#include "GCController.h"
 #include "InspectorController.h"
 #include "JSDOMWindowCustom.h"
 #include "JSNode.h"
@@ -36,6 +37,7 @@
 #include "SecurityOrigin.h"
 #include "Settings.h"
 #include "WebCoreJSClientData.h"
+#include <runtime/GCActivityCallback.h>
 #include <wtf/Threading.h>
 #include <wtf/text/StringConcatenate.h>
 
@@ -43,6 +45,15 @@ using namespace JSC;
 
 namespace WebCore {
 
+#if ENABLE(INCREMENTAL_GC) && !USE(CF)
+// The default activity callback does nothing on these platforms, so the DOM's
+// GC timers drive incremental marking instead.
+class DOMGCActivityCallback : public GCActivityCallback {
+public:
+    virtual void didStartIncrementalMarking() { gcController().markIncrementallySoon(); }
+};
+#endif
+
 const ClassInfo JSDOMWindowBase::s_info = { "Window", &JSDOMGlobalObject::s_info, 0, 0 };
 
 JSDOMWindowBase::JSDOMWindowBase(JSGlobalData& globalData, Structure* structure, PassRefPtr<DOMWindow> window, JSDOMWindowShell* shell)
@@ -180,6 +191,9 @@ JSGlobalData* JSDOMWindowBase::commonJSGlobalData()
         globalData->exclusiveThread = currentThread();
 #endif
         initNormalWorldClientData(globalData);
+#if ENABLE(INCREMENTAL_GC) && !USE(CF)
+        globalData->heap.setActivityCallback(adoptPtr(new DOMGCActivityCallback));
+#endif
     }
 
     return globalData;
@@ -47,6 +47,10 @@
 #include <runtime/JSLock.h>
 #include <wtf/Threading.h>
 
+#if PLATFORM(ANDROID)
+#include "TraceEventAndroid.h"
+#endif
+
 using namespace JSC;
 using namespace std;
 
@@ -56,6 +60,7 @@ void ScriptController::initializeThreading()
 {
     JSC::initializeThreading();
     WTF::initializeMainThread();
+    Frame::initializeSharedNames();
 }
 
 ScriptController::ScriptController(Frame* frame)
@@ -117,6 +122,9 @@ JSDOMWindowShell* ScriptController::createWindowShell(DOMWrapperWorld* world)
 
 ScriptValue ScriptController::evaluateInWorld(const ScriptSourceCode& sourceCode, DOMWrapperWorld* world)
 {
+#if PLATFORM(ANDROID)
+    ANDROID_TRACE_EVENT("jsc", "ScriptController::evaluateInWorld");
+#endif
     const SourceCode& jsSourceCode = sourceCode.jsSourceCode();
     String sourceURL = ustringToString(jsSourceCode.provider()->url());
 
@@ -34,6 +34,7 @@
 #if ENABLE(INSPECTOR)
 
 #include "JSDOMWindow.h"
+#include "ScriptGCEventListener.h"
 #include <heap/Heap.h>
 #include <runtime/JSGlobalData.h>
 #include <wtf/CurrentTime.h>
@@ -42,6 +43,50 @@ namespace WebCore {
 
 using namespace JSC;
 
+class HeapGCObserver : public GCObserver {
+public:
+    HeapGCObserver(const Vector<ScriptGCEventListener*>& listeners)
+        : m_listeners(listeners)
+    {
+    }
+
+    virtual void didCollect(const GCEvent& event)
+    {
+        size_t collectedBytes = event.sizeBefore > event.sizeAfter ? event.sizeBefore - event.sizeAfter : 0;
+        Vector<ScriptGCEventListener*> listeners(m_listeners);
+        for (size_t i = 0; i < listeners.size(); ++i)
+            listeners[i]->didGC(event.startTime * 1000, event.endTime * 1000, collectedBytes);
+    }
+
+private:
+    const Vector<ScriptGCEventListener*>& m_listeners;
+};
+
+ScriptGCEvent::GCEventListeners& ScriptGCEvent::eventListeners()
+{
+    DEFINE_STATIC_LOCAL(GCEventListeners, listeners, ());
+    return listeners;
+}
+
+void ScriptGCEvent::addEventListener(ScriptGCEventListener* eventListener)
+{
+    ASSERT(eventListener);
+    DEFINE_STATIC_LOCAL(HeapGCObserver, observer, (eventListeners()));
+    if (eventListeners().isEmpty())
+        JSDOMWindow::commonJSGlobalData()->heap.setGCObserver(&observer);
+    eventListeners().append(eventListener);
+}
+
+void ScriptGCEvent::removeEventListener(ScriptGCEventListener* eventListener)
+{
+    ASSERT(eventListener);
+    size_t i = eventListeners().find(eventListener);
+    ASSERT(i != notFound);
+    eventListeners().remove(i);
+    if (eventListeners().isEmpty())
+        JSDOMWindow::commonJSGlobalData()->heap.setGCObserver(0);
+}
+
 void ScriptGCEvent::getHeapSize(size_t& usedHeapSize, size_t& totalHeapSize, size_t& heapSizeLimit)
 {
     JSGlobalData* globalData = JSDOMWindow::commonJSGlobalData();
@@ -33,6 +33,8 @@
 
 #if ENABLE(INSPECTOR)
 
+#include <wtf/Vector.h>
+
 namespace WebCore {
 
 class ScriptGCEventListener;
@@ -40,9 +42,13 @@ class ScriptGCEventListener;
 class ScriptGCEvent
 {
 public:
-    static void addEventListener(ScriptGCEventListener*) { }
-    static void removeEventListener(ScriptGCEventListener*) { }
+    static void addEventListener(ScriptGCEventListener*);
+    static void removeEventListener(ScriptGCEventListener*);
     static void getHeapSize(size_t& usedHeapSize, size_t& totalHeapSize, size_t& heapSizeLimit);
+
+private:
+    typedef Vector<ScriptGCEventListener*> GCEventListeners;
+    static GCEventListeners& eventListeners();
 };
 
 } // namespace WebCore
@@ -33,6 +33,7 @@
 #include "GCController.h"
 #include "JSDOMBinding.h"
 #include <profiler/Profiler.h>
+#include <profiler/SamplingProfiler.h>
 
 namespace WebCore {
 
@@ -41,6 +42,29 @@ void ScriptProfiler::collectGarbage()
     gcController().garbageCollectNow();
 }
 
+#if ENABLE(SAMPLING_PROFILER)
+// The sampling profiler does not instrument calls, so profiles record no call
+// counts, but profiling barely slows the page down. It runs one profile at a
+// time; nested profiles are ignored.
+void ScriptProfiler::start(ScriptState* state, const String& title)
+{
+    JSC::JSGlobalData& globalData = state->globalData();
+    if (!globalData.samplingProfiler)
+        globalData.samplingProfiler = adoptPtr(new JSC::SamplingProfiler(globalData));
+    if (!globalData.samplingProfiler->isRunning())
+        globalData.samplingProfiler->start(stringToUString(title));
+}
+
+PassRefPtr<ScriptProfile> ScriptProfiler::stop(ScriptState* state, const String& title)
+{
+    JSC::SamplingProfiler* profiler = state->globalData().samplingProfiler.get();
+    if (!profiler || !profiler->isRunning())
+        return 0;
+    if (!title.isNull() && profiler->title() != stringToUString(title))
+        return 0;
+    return ScriptProfile::create(profiler->stop());
+}
+#else
 void ScriptProfiler::start(ScriptState* state, const String& title)
 {
     JSC::Profiler::profiler()->startProfiling(state, stringToUString(title));
@@ -51,6 +75,7 @@ PassRefPtr<ScriptProfile> ScriptProfiler::stop(ScriptState* state, const String&
     RefPtr<JSC::Profile> profile = JSC::Profiler::profiler()->stopProfiling(state, stringToUString(title));
     return ScriptProfile::create(profile);
 }
+#endif
 
 } // namespace WebCore
 
@@ -47,6 +47,7 @@
 #include <runtime/PropertyNameArray.h>
 #include <runtime/RegExp.h>
 #include <runtime/RegExpObject.h>
+#include <runtime/Structure.h>
 #include <wtf/ByteArray.h>
 #include <wtf/HashTraits.h>
 #include <wtf/Vector.h>
@@ -96,10 +97,12 @@ enum SerializationTag {
  *
  * Initial version was 1.
  * Version 2. added the ObjectReferenceTag and support for serialization of cyclic graphs.
+ * Version 3. added Latin-1 StringData, flagged by the high bit of the length.
  */
-static const unsigned int CurrentVersion = 2;
+static const unsigned int CurrentVersion = 3;
 static const unsigned int TerminatorTag = 0xFFFFFFFF;
 static const unsigned int StringPoolTag = 0xFFFFFFFE;
+static const unsigned int StringDataIs8BitFlag = 0x80000000;
 
 /*
  * Object serialization is performed according to the following grammar, all tags
@@ -141,6 +144,7 @@ static const unsigned int StringPoolTag = 0xFFFFFFFE;
  * StringData :-
  *      StringPoolTag <cpIndex:IndexType>
  *      (not (TerminatorTag | StringPoolTag))<length:uint32_t><characters:UChar{length}> // Added to constant pool when seen, string length 0xFFFFFFFF is disallowed
+ *      (not (TerminatorTag | StringPoolTag))<length | StringDataIs8BitFlag:uint32_t><characters:LChar{length}> // As above, for strings with no character above U+00FF
  *
  * File :-
  *    FileTag FileData
@@ -277,6 +281,11 @@ private:
         write(CurrentVersion);
     }
 
+    ~CloneSerializer()
+    {
+        deleteAllValues(m_structureProperties);
+    }
+
     SerializationReturnCode serialize(JSValue in);
 
     bool isArray(JSValue value)
@@ -344,6 +353,48 @@ private:
         return jsNull();
     }
 
+    // Plain objects are enumerated from their Structure: the names and
+    // storage offsets of their properties are computed once per Structure
+    // and then shared by every object with that shape, so reading a member
+    // is a direct load instead of a property lookup.
+    struct StructureProperties {
+        Structure* structure;
+        RefPtr<PropertyNameArrayData> names;
+        Vector<size_t> offsets;
+    };
+
+    const StructureProperties* structureProperties(JSObject* object)
+    {
+        if (object->classInfo() != &JSObject::s_info)
+            return 0;
+        Structure* structure = object->structure();
+        if (structure->isDictionary() || structure->hasGetterSetterProperties())
+            return 0;
+
+        StructurePropertiesMap::iterator iter = m_structureProperties.find(structure);
+        if (iter != m_structureProperties.end())
+            return iter->second;
+
+        PropertyNameArray names(m_exec);
+        structure->getPropertyNames(m_exec->globalData(), names, ExcludeDontEnumProperties);
+        OwnPtr<StructureProperties> properties = adoptPtr(new StructureProperties);
+        properties->structure = structure;
+        properties->offsets.reserveInitialCapacity(names.size());
+        for (size_t i = 0; i < names.size(); ++i) {
+            size_t offset = structure->get(m_exec->globalData(), names[i]);
+            if (offset == notFound)
+                return 0;
+            properties->offsets.uncheckedAppend(offset);
+        }
+        properties->names = names.releaseData();
+        // Keep the Structure alive so its address cannot be reused by a
+        // different shape while it is a key in the cache.
+        m_gcBuffer.append(structure);
+        StructureProperties* result = properties.leakPtr();
+        m_structureProperties.set(structure, result);
+        return result;
+    }
+
     JSValue getProperty(JSObject* object, const Identifier& propertyName)
     {
         PropertySlot slot(object);
@@ -544,40 +595,70 @@ private:
             write(static_cast<uint32_t>(i));
     }
 
-    void write(const Identifier& ident)
+    static bool charactersAreAllLatin1(const UChar* characters, unsigned length)
+    {
+        UChar orAllCharacters = 0;
+        for (unsigned i = 0; i < length; ++i)
+            orAllCharacters |= characters[i];
+        return !(orAllCharacters & ~0xFF);
+    }
+
+    // The constant pool is keyed on the StringImpl itself, so repeated
+    // property names (which are identifiers) and repeated references to
+    // the same string value are written once, without having to atomize
+    // or hash the contents of every string value.
+    void writeStringData(StringImpl* impl)
     {
-        UString str = ident.ustring();
-        pair<StringConstantPool::iterator, bool> iter = m_constantPool.add(str.impl(), m_constantPool.size());
+        pair<StringConstantPool::iterator, bool> iter = m_constantPool.add(impl, m_constantPool.size());
         if (!iter.second) {
             write(StringPoolTag);
             writeStringIndex(iter.first->second);
             return;
         }
 
-        // This condition is unlikely to happen as they would imply an ~8gb
-        // string but we should guard against it anyway
-        if (str.length() >= StringPoolTag) {
+        unsigned length = impl->length();
+        const UChar* characters = impl->characters();
+
+        // Lengths share the uint32_t with the StringPoolTag and TerminatorTag
+        // markers and the 8-bit flag; guard against an ~4gb string colliding
+        // with them.
+        if (length >= StringPoolTag - StringDataIs8BitFlag) {
             fail();
             return;
         }
 
+        if (charactersAreAllLatin1(characters, length)) {
+            writeLittleEndian<uint32_t>(m_buffer, length | StringDataIs8BitFlag);
+            size_t start = m_buffer.size();
+            m_buffer.grow(start + length);
+            uint8_t* out = m_buffer.data() + start;
+            for (unsigned i = 0; i < length; ++i)
+                out[i] = static_cast<uint8_t>(characters[i]);
+            return;
+        }
+
         // Guard against overflow
-        if (str.length() > (numeric_limits<uint32_t>::max() - sizeof(uint32_t)) / sizeof(UChar)) {
+        if (length > (numeric_limits<uint32_t>::max() - sizeof(uint32_t)) / sizeof(UChar)) {
             fail();
             return;
         }
 
-        writeLittleEndian<uint32_t>(m_buffer, str.length());
-        if (!writeLittleEndian<uint16_t>(m_buffer, reinterpret_cast<const uint16_t*>(str.characters()), str.length()))
+        writeLittleEndian<uint32_t>(m_buffer, length);
+        if (!writeLittleEndian<uint16_t>(m_buffer, reinterpret_cast<const uint16_t*>(characters), length))
             fail();
     }
 
+    void write(const Identifier& ident)
+    {
+        writeStringData(ident.impl());
+    }
+
     void write(const UString& str)
     {
         if (str.isNull())
             write(m_emptyIdentifier);
         else
-            write(Identifier(m_exec, str));
+            writeStringData(str.impl());
     }
 
     void write(const String& str)
@@ -585,7 +666,7 @@ private:
         if (str.isEmpty())
             write(m_emptyIdentifier);
         else
-            write(Identifier(m_exec, str.impl()));
+            writeStringData(str.impl());
     }
 
     void write(const File* file)
@@ -603,8 +684,10 @@ private:
     Vector<uint8_t>& m_buffer;
     typedef HashMap<JSObject*, uint32_t> ObjectPool;
     ObjectPool m_objectPool;
-    typedef HashMap<RefPtr<StringImpl>, uint32_t, IdentifierRepHash> StringConstantPool;
+    typedef HashMap<RefPtr<StringImpl>, uint32_t, PtrHash<RefPtr<StringImpl> > > StringConstantPool;
     StringConstantPool m_constantPool;
+    typedef HashMap<Structure*, StructureProperties*> StructurePropertiesMap;
+    StructurePropertiesMap m_structureProperties;
     Identifier m_emptyIdentifier;
 };
 
@@ -613,6 +696,7 @@ SerializationReturnCode CloneSerializer::serialize(JSValue in)
     Vector<uint32_t, 16> indexStack;
     Vector<uint32_t, 16> lengthStack;
     Vector<PropertyNameArray, 16> propertyStack;
+    Vector<const StructureProperties*, 16> structurePropertiesStack;
     Vector<JSObject*, 16> inputObjectStack;
     Vector<JSArray*, 16> inputArrayStack;
     Vector<WalkerState, 16> stateStack;
@@ -687,7 +771,12 @@ SerializationReturnCode CloneSerializer::serialize(JSValue in)
                 inputObjectStack.append(inObject);
                 indexStack.append(0);
                 propertyStack.append(PropertyNameArray(m_exec));
-                inObject->getOwnPropertyNames(m_exec, propertyStack.last());
+                const StructureProperties* properties = structureProperties(inObject);
+                structurePropertiesStack.append(properties);
+                if (properties)
+                    propertyStack.last().setData(properties->names);
+                else
+                    inObject->getOwnPropertyNames(m_exec, propertyStack.last());
                 // fallthrough
             }
             objectStartVisitMember:
@@ -706,9 +795,16 @@ SerializationReturnCode CloneSerializer::serialize(JSValue in)
                     inputObjectStack.removeLast();
                     indexStack.removeLast();
                     propertyStack.removeLast();
+                    structurePropertiesStack.removeLast();
                     break;
                 }
-                inValue = getProperty(object, properties[index]);
+                // Serializing an earlier member may have run a getter that
+                // reshaped this object, in which case fall back to a lookup.
+                const StructureProperties* cachedProperties = structurePropertiesStack.last();
+                if (cachedProperties && object->structure() == cachedProperties->structure)
+                    inValue = object->getDirectOffset(cachedProperties->offsets[index]);
+                else
+                    inValue = getProperty(object, properties[index]);
                 if (shouldTerminate())
                     return ExistingExceptionError;
 
@@ -808,9 +904,19 @@ private:
         }
         const UString& ustring() { return m_string; }
 
+        // Property names recur once per object of the same shape; atomize
+        // them the first time only.
+        const Identifier& identifier(ExecState* exec)
+        {
+            if (m_identifier.isNull())
+                m_identifier = Identifier(exec, m_string);
+            return m_identifier;
+        }
+
     private:
         UString m_string;
         JSValue m_jsString;
+        Identifier m_identifier;
     };
 
     struct CachedStringRef {
@@ -955,6 +1061,15 @@ private:
 
     static bool readString(const uint8_t*& ptr, const uint8_t* end, UString& str, unsigned length)
     {
+        if (length & StringDataIs8BitFlag) {
+            length &= ~StringDataIs8BitFlag;
+            if (static_cast<unsigned>(end - ptr) < length)
+                return false;
+            str = UString(reinterpret_cast<const char*>(ptr), length);
+            ptr += length;
+            return true;
+        }
+
         if (length >= numeric_limits<int32_t>::max() / sizeof(UChar))
             return false;
 
@@ -1282,11 +1397,11 @@ DeserializationResult CloneDeserializer::deserialize()
             }
 
             if (JSValue terminal = readTerminal()) {
-                putProperty(outputObjectStack.last(), Identifier(m_exec, cachedString->ustring()), terminal);
+                putProperty(outputObjectStack.last(), cachedString->identifier(m_exec), terminal);
                 goto objectStartVisitMember;
             }
             stateStack.append(ObjectEndVisitMember);
-            propertyNameStack.append(Identifier(m_exec, cachedString->ustring()));
+            propertyNameStack.append(cachedString->identifier(m_exec));
             goto stateUnknown;
         }
         case ObjectEndVisitMember: {
@@ -0,0 +1,133 @@
+/*
+ * Copyright 2012, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "StringSourceProvider.h"
+
+#include <parser/SourceProviderCache.h>
+#include <wtf/HashMap.h>
+#include <wtf/MainThread.h>
+#include <wtf/RefCounted.h>
+#include <wtf/StdLibExtras.h>
+#include <wtf/text/StringHash.h>
+
+namespace WebCore {
+
+class SharedSourceProviderCache : public RefCounted<SharedSourceProviderCache> {
+public:
+    static PassRefPtr<SharedSourceProviderCache> create() { return adoptRef(new SharedSourceProviderCache); }
+
+    JSC::SourceProviderCache* cache() { return &m_cache; }
+
+private:
+    SharedSourceProviderCache() { }
+
+    JSC::SourceProviderCache m_cache;
+};
+
+// The parser only caches function bodies longer than 64 characters, so
+// shorter scripts would gain nothing from sharing.
+static const unsigned minimumSharedSourceLength = 512;
+static const unsigned maximumSharedCaches = 64;
+// The map keeps its keys alive, so the source it retains is bounded too.
+static const unsigned maximumSharedSourceLength = 1024 * 1024;
+
+typedef HashMap<String, RefPtr<SharedSourceProviderCache> > SharedCacheMap;
+
+static SharedCacheMap& sharedCaches()
+{
+    DEFINE_STATIC_LOCAL(SharedCacheMap, caches, ());
+    return caches;
+}
+
+static unsigned sharedSourceLength;
+
+static bool hasRoomFor(const String& source)
+{
+    return sharedCaches().size() < maximumSharedCaches && sharedSourceLength + source.length() <= maximumSharedSourceLength;
+}
+
+static PassRefPtr<SharedSourceProviderCache> sharedCacheFor(const String& source)
+{
+    // Workers parse on their own threads.
+    if (source.length() < minimumSharedSourceLength || !isMainThread())
+        return 0;
+
+    SharedCacheMap& caches = sharedCaches();
+    SharedCacheMap::iterator it = caches.find(source);
+    if (it != caches.end())
+        return it->second;
+
+    if (!hasRoomFor(source)) {
+        // Drop the caches no live provider is using.
+        Vector<String> unused;
+        SharedCacheMap::iterator end = caches.end();
+        for (it = caches.begin(); it != end; ++it) {
+            if (it->second->hasOneRef())
+                unused.append(it->first);
+        }
+        for (size_t i = 0; i < unused.size(); ++i) {
+            sharedSourceLength -= unused[i].length();
+            caches.remove(unused[i]);
+        }
+        if (!hasRoomFor(source))
+            return 0;
+    }
+
+    RefPtr<SharedSourceProviderCache> cache = SharedSourceProviderCache::create();
+    caches.set(source, cache);
+    sharedSourceLength += source.length();
+    return cache.release();
+}
+
+PassRefPtr<StringSourceProvider> StringSourceProvider::create(const String& source, const String& url, const TextPosition1& startPosition)
+{
+    return adoptRef(new StringSourceProvider(source, url, startPosition, sharedCacheFor(source)));
+}
+
+StringSourceProvider::StringSourceProvider(const String& source, const String& url, const TextPosition1& startPosition, PassRefPtr<SharedSourceProviderCache> sharedCache)
+    : ScriptSourceProvider(stringToUString(url), sharedCache ? sharedCache->cache() : 0)
+    , m_startPosition(startPosition)
+    , m_source(source)
+    , m_sharedCache(sharedCache)
+{
+}
+
+StringSourceProvider::~StringSourceProvider()
+{
+}
+
+void StringSourceProvider::clearSharedCaches()
+{
+    ASSERT(isMainThread());
+    SharedCacheMap& caches = sharedCaches();
+    SharedCacheMap::iterator end = caches.end();
+    for (SharedCacheMap::iterator it = caches.begin(); it != end; ++it)
+        it->second->cache()->clear();
+    caches.clear();
+    sharedSourceLength = 0;
+}
+
+} // namespace WebCore
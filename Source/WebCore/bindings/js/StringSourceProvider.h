@@ -35,12 +35,17 @@
 
 namespace WebCore {
 
+    class SharedSourceProviderCache;
+
     class StringSourceProvider : public ScriptSourceProvider {
     public:
-        static PassRefPtr<StringSourceProvider> create(const String& source, const String& url, const TextPosition1& startPosition = TextPosition1::minimumPosition())
-        {
-            return adoptRef(new StringSourceProvider(source, url, startPosition));
-        }
+        // Providers for the same source text share the parser's cache of function
+        // bodies, so that running a script again in another global object can
+        // skip over every function it has already seen.
+        static PassRefPtr<StringSourceProvider> create(const String& source, const String& url, const TextPosition1& startPosition = TextPosition1::minimumPosition());
+        virtual ~StringSourceProvider();
+
+        static void clearSharedCaches();
 
         virtual TextPosition1 startPosition() const { return m_startPosition; }
         JSC::UString getRange(int start, int end) const { return JSC::UString(m_source.characters() + start, end - start); }
@@ -49,15 +54,11 @@ namespace WebCore {
         const String& source() const { return m_source; }
 
     private:
-        StringSourceProvider(const String& source, const String& url, const TextPosition1& startPosition)
-            : ScriptSourceProvider(stringToUString(url))
-            , m_startPosition(startPosition)
-            , m_source(source)
-        {
-        }
+        StringSourceProvider(const String& source, const String& url, const TextPosition1& startPosition, PassRefPtr<SharedSourceProviderCache>);
         
         TextPosition1 m_startPosition;
         String m_source;
+        RefPtr<SharedSourceProviderCache> m_sharedCache;
     };
 
     inline JSC::SourceCode makeSource(const String& source, const String& url = String(), int firstLine = 1)
@@ -522,6 +522,13 @@ sub GetterExpressionPrefix
         $functionName = "getIntegralAttribute";
     } elsif ($attribute->signature->type eq "unsigned long") {
         $functionName = "getUnsignedIntegralAttribute";
+    } elsif ($contentAttributeName eq "WebCore::HTMLNames::idAttr") {
+        $functionName = "getIdAttribute";
+        $contentAttributeName = "";
+    } elsif ($interfaceName !~ /^SVG/) {
+        # Only the style attribute and the animated SVG attributes need to be
+        # synchronized before they are read, no reflected string can be one.
+        $functionName = "fastGetAttribute";
     } else {
         $functionName = "getAttribute";
     }
@@ -626,7 +626,7 @@ webkit_dom_test_obj_get_reflected_string_attr(WebKitDOMTestObj* self)
     g_return_val_if_fail(self, 0);
     WebCore::JSMainThreadNullState state;
     WebCore::TestObj * item = WebKit::core(self);
-    gchar* res = convertToUTF8String(item->getAttribute(WebCore::HTMLNames::reflectedstringattrAttr));
+    gchar* res = convertToUTF8String(item->fastGetAttribute(WebCore::HTMLNames::reflectedstringattrAttr));
     return res;
 }
 
@@ -746,7 +746,7 @@ webkit_dom_test_obj_get_reflected_string_attr(WebKitDOMTestObj* self)
     g_return_val_if_fail(self, 0);
     WebCore::JSMainThreadNullState state;
     WebCore::TestObj * item = WebKit::core(self);
-    gchar* res = convertToUTF8String(item->getAttribute(WebCore::HTMLNames::customContentStringAttrAttr));
+    gchar* res = convertToUTF8String(item->fastGetAttribute(WebCore::HTMLNames::customContentStringAttrAttr));
     return res;
 }
 
@@ -1368,7 +1368,7 @@ static void webkit_dom_test_obj_get_property(GObject* object, guint prop_id, GVa
     }
     case PROP_REFLECTED_STRING_ATTR:
     {
-        g_value_take_string(value, convertToUTF8String(coreSelf->getAttribute(WebCore::HTMLNames::reflectedstringattrAttr)));
+        g_value_take_string(value, convertToUTF8String(coreSelf->fastGetAttribute(WebCore::HTMLNames::reflectedstringattrAttr)));
         break;
     }
     case PROP_REFLECTED_INTEGRAL_ATTR:
@@ -1398,7 +1398,7 @@ static void webkit_dom_test_obj_get_property(GObject* object, guint prop_id, GVa
     }
     case PROP_REFLECTED_STRING_ATTR:
     {
-        g_value_take_string(value, convertToUTF8String(coreSelf->getAttribute(WebCore::HTMLNames::customContentStringAttrAttr)));
+        g_value_take_string(value, convertToUTF8String(coreSelf->fastGetAttribute(WebCore::HTMLNames::customContentStringAttrAttr)));
         break;
     }
     case PROP_REFLECTED_CUSTOM_INTEGRAL_ATTR:
@@ -76,6 +76,7 @@ void ScriptController::initializeThreading()
     if (!initializedThreading) {
         WTF::initializeThreading();
         WTF::initializeMainThread();
+        Frame::initializeSharedNames();
         initializedThreading = true;
     }
 }
@@ -31,20 +31,44 @@
 #include "config.h"
 #include "SerializedScriptValue.h"
 
+#include "ArrayBuffer.h"
+#include "ArrayBufferView.h"
 #include "Blob.h"
 #include "ByteArray.h"
 #include "CanvasPixelArray.h"
+#include "DOMDataStore.h"
+#include "DataView.h"
 #include "ExceptionCode.h"
 #include "File.h"
 #include "FileList.h"
+#include "Float32Array.h"
 #include "ImageData.h"
+#include "Int16Array.h"
+#include "Int32Array.h"
+#include "Int8Array.h"
 #include "SharedBuffer.h"
+#include "Uint16Array.h"
+#include "Uint32Array.h"
+#include "Uint8Array.h"
+#include "Uint8ClampedArray.h"
+#include "V8ArrayBuffer.h"
+#include "V8ArrayBufferView.h"
 #include "V8Binding.h"
 #include "V8Blob.h"
+#include "V8DOMMap.h"
+#include "V8DataView.h"
 #include "V8File.h"
 #include "V8FileList.h"
+#include "V8Float32Array.h"
 #include "V8ImageData.h"
+#include "V8Int16Array.h"
+#include "V8Int32Array.h"
+#include "V8Int8Array.h"
 #include "V8Proxy.h"
+#include "V8Uint16Array.h"
+#include "V8Uint32Array.h"
+#include "V8Uint8Array.h"
+#include "V8Uint8ClampedArray.h"
 #include "V8Utilities.h"
 
 #include <wtf/Assertions.h>
@@ -81,6 +105,22 @@ enum SerializationTag {
     ObjectTag = '{',
     SparseArrayTag = '@',
     RegExpTag = 'R',
+    ArrayBufferTag = 'B', // byteLength:uint32_t, raw data -> ArrayBuffer (copied)
+    ArrayBufferTransferTag = 't', // index:uint32_t -> ArrayBuffer (adopted from the transfer list)
+    ArrayBufferViewTag = 'V', // subtag:byte, byteOffset:uint32_t, byteLength:uint32_t, then an ArrayBuffer record
+};
+
+// Subtags identifying the concrete type of a serialized ArrayBufferView.
+enum ArrayBufferViewSubTag {
+    ByteArrayTag = 'b',
+    UnsignedByteArrayTag = 'B',
+    UnsignedByteClampedArrayTag = 'C',
+    ShortArrayTag = 'w',
+    UnsignedShortArrayTag = 'W',
+    IntArrayTag = 'd',
+    UnsignedIntArrayTag = 'D',
+    FloatArrayTag = 'f',
+    DataViewTag = '?'
 };
 
 static bool shouldCheckForCycles(int depth)
@@ -228,6 +268,50 @@ public:
         doWriteUint32(static_cast<uint32_t>(flags));
     }
 
+    void writeArrayBuffer(const ArrayBuffer& arrayBuffer)
+    {
+        append(ArrayBufferTag);
+        doWriteUint32(arrayBuffer.byteLength());
+        append(static_cast<const uint8_t*>(arrayBuffer.data()), arrayBuffer.byteLength());
+    }
+
+    void writeTransferredArrayBuffer(uint32_t index)
+    {
+        append(ArrayBufferTransferTag);
+        doWriteUint32(index);
+    }
+
+    // Must be followed by the record of the view's buffer.
+    bool writeArrayBufferView(const ArrayBufferView& view)
+    {
+        ArrayBufferViewSubTag subTag;
+        if (view.isByteArray())
+            subTag = ByteArrayTag;
+        else if (view.isUnsignedByteClampedArray())
+            subTag = UnsignedByteClampedArrayTag;
+        else if (view.isUnsignedByteArray())
+            subTag = UnsignedByteArrayTag;
+        else if (view.isShortArray())
+            subTag = ShortArrayTag;
+        else if (view.isUnsignedShortArray())
+            subTag = UnsignedShortArrayTag;
+        else if (view.isIntArray())
+            subTag = IntArrayTag;
+        else if (view.isUnsignedIntArray())
+            subTag = UnsignedIntArrayTag;
+        else if (view.isFloatArray())
+            subTag = FloatArrayTag;
+        else if (view.isDataView())
+            subTag = DataViewTag;
+        else
+            return false;
+        append(ArrayBufferViewTag);
+        append(static_cast<uint8_t>(subTag));
+        doWriteUint32(view.byteOffset());
+        doWriteUint32(view.byteLength());
+        return true;
+    }
+
     void writeArray(uint32_t length)
     {
         append(ArrayTag);
@@ -344,9 +428,10 @@ public:
         JSFailure
     };
 
-    Serializer(Writer& writer, v8::TryCatch& tryCatch)
+    Serializer(Writer& writer, const ArrayBufferArray* transferredArrayBuffers, v8::TryCatch& tryCatch)
         : m_writer(writer)
         , m_tryCatch(tryCatch)
+        , m_transferredArrayBuffers(transferredArrayBuffers)
         , m_depth(0)
         , m_status(Success)
     {
@@ -663,6 +748,37 @@ private:
         m_writer.writeRegExp(regExp->GetSource(), regExp->GetFlags());
     }
 
+    void writeArrayBufferRecord(ArrayBuffer* arrayBuffer)
+    {
+        if (m_transferredArrayBuffers) {
+            size_t index = m_transferredArrayBuffers->find(arrayBuffer);
+            if (index != notFound) {
+                m_writer.writeTransferredArrayBuffer(index);
+                return;
+            }
+        }
+        m_writer.writeArrayBuffer(*arrayBuffer);
+    }
+
+    void writeArrayBuffer(v8::Handle<v8::Value> value)
+    {
+        ArrayBuffer* arrayBuffer = V8ArrayBuffer::toNative(value.As<v8::Object>());
+        if (!arrayBuffer)
+            return;
+        writeArrayBufferRecord(arrayBuffer);
+    }
+
+    void writeArrayBufferView(v8::Handle<v8::Value> value)
+    {
+        ArrayBufferView* view = V8ArrayBufferView::toNative(value.As<v8::Object>());
+        if (!view)
+            return;
+        RefPtr<ArrayBuffer> arrayBuffer = view->buffer();
+        if (!arrayBuffer || !m_writer.writeArrayBufferView(*view))
+            return;
+        writeArrayBufferRecord(arrayBuffer.get());
+    }
+
     static StateBase* newArrayState(v8::Handle<v8::Array> array, StateBase* next)
     {
         // FIXME: use plain Array state when we can quickly check that
@@ -678,6 +794,7 @@ private:
 
     Writer& m_writer;
     v8::TryCatch& m_tryCatch;
+    const ArrayBufferArray* m_transferredArrayBuffers;
     int m_depth;
     Status m_status;
 };
@@ -716,6 +833,10 @@ Serializer::StateBase* Serializer::doSerialize(v8::Handle<v8::Value> value, Stat
         writeImageData(value);
     else if (value->IsRegExp())
         writeRegExp(value);
+    else if (V8ArrayBuffer::HasInstance(value))
+        writeArrayBuffer(value);
+    else if (V8ArrayBufferView::HasInstance(value))
+        writeArrayBufferView(value);
     else if (value->IsObject())
         return push(newObjectState(value.As<v8::Object>(), next));
     return 0;
@@ -735,10 +856,11 @@ public:
 // restoring information about saved objects of composite types.
 class Reader {
 public:
-    Reader(const uint8_t* buffer, int length)
+    Reader(const uint8_t* buffer, int length, const ArrayBufferArray* transferredArrayBuffers)
         : m_buffer(buffer)
         , m_length(length)
         , m_position(0)
+        , m_transferredArrayBuffers(transferredArrayBuffers)
     {
         ASSERT(length >= 0);
     }
@@ -815,6 +937,18 @@ public:
             if (!readRegExp(value))
                 return false;
             break;
+        case ArrayBufferTag:
+        case ArrayBufferTransferTag: {
+            RefPtr<ArrayBuffer> arrayBuffer;
+            if (!doReadArrayBuffer(tag, &arrayBuffer))
+                return false;
+            *value = toV8(arrayBuffer.release());
+            break;
+        }
+        case ArrayBufferViewTag:
+            if (!readArrayBufferView(value))
+                return false;
+            break;
         case ObjectTag: {
             uint32_t numProperties;
             if (!doReadUint32(&numProperties))
@@ -998,6 +1132,88 @@ private:
         return true;
     }
 
+    bool doReadArrayBuffer(SerializationTag tag, RefPtr<ArrayBuffer>* arrayBuffer)
+    {
+        if (tag == ArrayBufferTransferTag) {
+            uint32_t index;
+            if (!doReadUint32(&index))
+                return false;
+            if (!m_transferredArrayBuffers || index >= m_transferredArrayBuffers->size())
+                return false;
+            *arrayBuffer = m_transferredArrayBuffers->at(index);
+            return true;
+        }
+        ASSERT(tag == ArrayBufferTag);
+        uint32_t byteLength;
+        if (!doReadUint32(&byteLength))
+            return false;
+        if (byteLength > m_length - m_position)
+            return false;
+        *arrayBuffer = ArrayBuffer::create(m_buffer + m_position, byteLength);
+        m_position += byteLength;
+        return arrayBuffer->get();
+    }
+
+    template<class ViewType, class ElementType>
+    static bool createTypedArray(PassRefPtr<ArrayBuffer> arrayBuffer, uint32_t byteOffset, uint32_t byteLength, v8::Handle<v8::Value>* value)
+    {
+        if (byteLength % sizeof(ElementType))
+            return false;
+        RefPtr<ViewType> view = ViewType::create(arrayBuffer, byteOffset, byteLength / sizeof(ElementType));
+        if (!view)
+            return false;
+        *value = toV8(view.release());
+        return true;
+    }
+
+    bool readArrayBufferView(v8::Handle<v8::Value>* value)
+    {
+        if (m_position >= m_length)
+            return false;
+        uint8_t subTag = m_buffer[m_position++];
+        uint32_t byteOffset;
+        uint32_t byteLength;
+        if (!doReadUint32(&byteOffset))
+            return false;
+        if (!doReadUint32(&byteLength))
+            return false;
+        SerializationTag bufferTag;
+        if (!readTag(&bufferTag))
+            return false;
+        if (bufferTag != ArrayBufferTag && bufferTag != ArrayBufferTransferTag)
+            return false;
+        RefPtr<ArrayBuffer> arrayBuffer;
+        if (!doReadArrayBuffer(bufferTag, &arrayBuffer))
+            return false;
+        switch (subTag) {
+        case ByteArrayTag:
+            return createTypedArray<Int8Array, signed char>(arrayBuffer.release(), byteOffset, byteLength, value);
+        case UnsignedByteArrayTag:
+            return createTypedArray<Uint8Array, unsigned char>(arrayBuffer.release(), byteOffset, byteLength, value);
+        case UnsignedByteClampedArrayTag:
+            return createTypedArray<Uint8ClampedArray, unsigned char>(arrayBuffer.release(), byteOffset, byteLength, value);
+        case ShortArrayTag:
+            return createTypedArray<Int16Array, short>(arrayBuffer.release(), byteOffset, byteLength, value);
+        case UnsignedShortArrayTag:
+            return createTypedArray<Uint16Array, unsigned short>(arrayBuffer.release(), byteOffset, byteLength, value);
+        case IntArrayTag:
+            return createTypedArray<Int32Array, int>(arrayBuffer.release(), byteOffset, byteLength, value);
+        case UnsignedIntArrayTag:
+            return createTypedArray<Uint32Array, unsigned int>(arrayBuffer.release(), byteOffset, byteLength, value);
+        case FloatArrayTag:
+            return createTypedArray<Float32Array, float>(arrayBuffer.release(), byteOffset, byteLength, value);
+        case DataViewTag: {
+            RefPtr<DataView> dataView = DataView::create(arrayBuffer.release(), byteOffset, byteLength);
+            if (!dataView)
+                return false;
+            *value = toV8(dataView.release());
+            return true;
+        }
+        default:
+            return false;
+        }
+    }
+
     template<class T>
     bool doReadUintHelper(T* value)
     {
@@ -1037,6 +1253,7 @@ private:
     const uint8_t* m_buffer;
     const unsigned m_length;
     unsigned m_position;
+    const ArrayBufferArray* m_transferredArrayBuffers;
 };
 
 class Deserializer : public CompositeCreator {
@@ -1135,6 +1352,40 @@ private:
     Vector<v8::Local<v8::Value> > m_stack;
 };
 
+// Drops the external array data V8 caches on the wrappers of a view whose
+// buffer has been transferred, so script sees a zero-length array instead
+// of reading through a stale pointer. Every world, isolated ones included,
+// may have its own wrapper for the view.
+static void neuterBinding(ArrayBufferView* view)
+{
+    v8::ExternalArrayType arrayType;
+    if (view->isByteArray())
+        arrayType = v8::kExternalByteArray;
+    else if (view->isUnsignedByteClampedArray())
+        arrayType = v8::kExternalPixelArray;
+    else if (view->isUnsignedByteArray())
+        arrayType = v8::kExternalUnsignedByteArray;
+    else if (view->isShortArray())
+        arrayType = v8::kExternalShortArray;
+    else if (view->isUnsignedShortArray())
+        arrayType = v8::kExternalUnsignedShortArray;
+    else if (view->isIntArray())
+        arrayType = v8::kExternalIntArray;
+    else if (view->isUnsignedIntArray())
+        arrayType = v8::kExternalUnsignedIntArray;
+    else if (view->isFloatArray())
+        arrayType = v8::kExternalFloatArray;
+    else
+        return;
+
+    DOMDataList& stores = DOMDataStore::allStores();
+    for (size_t i = 0; i < stores.size(); ++i) {
+        v8::Handle<v8::Object> wrapper = stores[i]->domObjectMap().get(view);
+        if (!wrapper.IsEmpty())
+            wrapper->SetIndexedPropertiesToExternalArrayData(0, arrayType, 0);
+    }
+}
+
 } // namespace
 
 void SerializedScriptValue::deserializeAndSetProperty(v8::Handle<v8::Object> object, const char* propertyName,
@@ -1154,13 +1405,18 @@ void SerializedScriptValue::deserializeAndSetProperty(v8::Handle<v8::Object> obj
 
 PassRefPtr<SerializedScriptValue> SerializedScriptValue::create(v8::Handle<v8::Value> value, bool& didThrow)
 {
-    return adoptRef(new SerializedScriptValue(value, didThrow));
+    return adoptRef(new SerializedScriptValue(value, 0, didThrow));
+}
+
+PassRefPtr<SerializedScriptValue> SerializedScriptValue::create(v8::Handle<v8::Value> value, ArrayBufferArray* arrayBuffers, bool& didThrow)
+{
+    return adoptRef(new SerializedScriptValue(value, arrayBuffers, didThrow));
 }
 
 PassRefPtr<SerializedScriptValue> SerializedScriptValue::create(v8::Handle<v8::Value> value)
 {
     bool didThrow;
-    return adoptRef(new SerializedScriptValue(value, didThrow));
+    return adoptRef(new SerializedScriptValue(value, 0, didThrow));
 }
 
 PassRefPtr<SerializedScriptValue> SerializedScriptValue::createFromWire(String data)
@@ -1208,6 +1464,7 @@ SerializedScriptValue* SerializedScriptValue::undefinedValue()
 PassRefPtr<SerializedScriptValue> SerializedScriptValue::release()
 {
     RefPtr<SerializedScriptValue> result = adoptRef(new SerializedScriptValue(m_data));
+    result->m_arrayBufferContentsArray = m_arrayBufferContentsArray.release();
     m_data = String().crossThreadString();
     return result.release();
 }
@@ -1216,14 +1473,29 @@ SerializedScriptValue::SerializedScriptValue()
 {
 }
 
-SerializedScriptValue::SerializedScriptValue(v8::Handle<v8::Value> value, bool& didThrow)
+SerializedScriptValue::~SerializedScriptValue()
+{
+}
+
+SerializedScriptValue::SerializedScriptValue(v8::Handle<v8::Value> value, ArrayBufferArray* arrayBuffers, bool& didThrow)
 {
     didThrow = false;
+    if (arrayBuffers) {
+        for (size_t i = 0; i < arrayBuffers->size(); ++i) {
+            ArrayBuffer* arrayBuffer = arrayBuffers->at(i).get();
+            // A buffer can only be transferred once per message.
+            if (arrayBuffer->isNeutered() || arrayBuffers->find(arrayBuffer) != i) {
+                didThrow = true;
+                throwError(INVALID_STATE_ERR);
+                return;
+            }
+        }
+    }
     Writer writer;
     Serializer::Status status;
     {
         v8::TryCatch tryCatch;
-        Serializer serializer(writer, tryCatch);
+        Serializer serializer(writer, arrayBuffers, tryCatch);
         status = serializer.serialize(value);
         if (status == Serializer::JSException) {
             // If there was a JS exception thrown, re-throw it.
@@ -1248,6 +1520,24 @@ SerializedScriptValue::SerializedScriptValue(v8::Handle<v8::Value> value, bool&
     }
     ASSERT(status == Serializer::Success);
     m_data = String(StringImpl::adopt(writer.data())).crossThreadString();
+    if (arrayBuffers && !arrayBuffers->isEmpty())
+        m_arrayBufferContentsArray = transferArrayBuffers(*arrayBuffers, didThrow);
+}
+
+PassOwnPtr<SerializedScriptValue::ArrayBufferContentsArray> SerializedScriptValue::transferArrayBuffers(ArrayBufferArray& arrayBuffers, bool& didThrow)
+{
+    OwnPtr<ArrayBufferContentsArray> contents = adoptPtr(new ArrayBufferContentsArray(arrayBuffers.size()));
+    Vector<RefPtr<ArrayBufferView> > neuteredViews;
+    for (size_t i = 0; i < arrayBuffers.size(); ++i) {
+        if (!arrayBuffers[i]->transfer(contents->at(i), neuteredViews)) {
+            didThrow = true;
+            throwError(INVALID_STATE_ERR);
+            return PassOwnPtr<ArrayBufferContentsArray>();
+        }
+    }
+    for (size_t i = 0; i < neuteredViews.size(); ++i)
+        neuterBinding(neuteredViews[i].get());
+    return contents.release();
 }
 
 SerializedScriptValue::SerializedScriptValue(String wireData)
@@ -1259,8 +1549,15 @@ v8::Handle<v8::Value> SerializedScriptValue::deserialize()
 {
     if (!m_data.impl())
         return v8::Null();
+    // The first deserialization adopts the transferred contents; later ones
+    // share the same buffers.
+    if (m_arrayBufferContentsArray) {
+        for (size_t i = 0; i < m_arrayBufferContentsArray->size(); ++i)
+            m_arrayBuffers.append(ArrayBuffer::create(m_arrayBufferContentsArray->at(i)));
+        m_arrayBufferContentsArray.clear();
+    }
     COMPILE_ASSERT(sizeof(BufferValueType) == 2, BufferValueTypeIsTwoBytes);
-    Reader reader(reinterpret_cast<const uint8_t*>(m_data.impl()->characters()), 2 * m_data.length());
+    Reader reader(reinterpret_cast<const uint8_t*>(m_data.impl()->characters()), 2 * m_data.length(), &m_arrayBuffers);
     Deserializer deserializer(reader);
     return deserializer.deserialize();
 }
@@ -33,10 +33,18 @@
 
 #include "ScriptValue.h"
 #include <v8.h>
+#include <wtf/OwnPtr.h>
+#include <wtf/RefPtr.h>
 #include <wtf/Threading.h>
+#include <wtf/Vector.h>
 
 namespace WebCore {
 
+class ArrayBuffer;
+class ArrayBufferContents;
+
+typedef Vector<RefPtr<ArrayBuffer>, 1> ArrayBufferArray;
+
 class SerializedScriptValue : public ThreadSafeRefCounted<SerializedScriptValue> {
 public:
     static void deserializeAndSetProperty(v8::Handle<v8::Object>, const char* propertyName,
@@ -50,6 +58,10 @@ public:
     // the caller must not invoke any V8 operations until control returns to
     // V8. When serialization is successful, |didThrow| is false.
     static PassRefPtr<SerializedScriptValue> create(v8::Handle<v8::Value> value, bool& didThrow);
+    // Like the above, but the buffers in |arrayBuffers| are transferred
+    // instead of copied: on success they and all their views are neutered
+    // and the receiving side adopts their contents.
+    static PassRefPtr<SerializedScriptValue> create(v8::Handle<v8::Value>, ArrayBufferArray*, bool& didThrow);
     static PassRefPtr<SerializedScriptValue> create(v8::Handle<v8::Value>);
     static PassRefPtr<SerializedScriptValue> createFromWire(String data);
     static PassRefPtr<SerializedScriptValue> create(String data);
@@ -60,6 +72,8 @@ public:
 
     PassRefPtr<SerializedScriptValue> release();
 
+    ~SerializedScriptValue();
+
     String toWireString() const { return m_data; }
 
     // Deserializes the value (in the current context). Returns a null value in
@@ -72,11 +86,19 @@ private:
         WireData
     };
 
+    typedef Vector<ArrayBufferContents, 1> ArrayBufferContentsArray;
+
     SerializedScriptValue();
-    SerializedScriptValue(v8::Handle<v8::Value>, bool& didThrow);
+    SerializedScriptValue(v8::Handle<v8::Value>, ArrayBufferArray*, bool& didThrow);
     explicit SerializedScriptValue(String wireData);
 
+    static PassOwnPtr<ArrayBufferContentsArray> transferArrayBuffers(ArrayBufferArray&, bool& didThrow);
+
     String m_data;
+    // Contents of transferred buffers, owned until the value is first
+    // deserialized on the receiving side.
+    OwnPtr<ArrayBufferContentsArray> m_arrayBufferContentsArray;
+    ArrayBufferArray m_arrayBuffers;
 };
 
 } // namespace WebCore
@@ -58,6 +58,10 @@
 #include <wtf/StdLibExtras.h>
 #include <wtf/UnusedParam.h>
 
+#if PLATFORM(ANDROID)
+#include "TraceEventAndroid.h"
+#endif
+
 namespace WebCore {
 
 #ifndef NDEBUG
@@ -428,6 +432,10 @@ private:
 // Create object groups for DOM tree nodes.
 void V8GCController::gcPrologue()
 {
+#if PLATFORM(ANDROID)
+    // Ends in gcEpilogue(), so the event spans the collection itself.
+    TraceEventAndroid::begin("v8", "GC");
+#endif
     v8::HandleScope scope;
 
 #ifndef NDEBUG
@@ -523,6 +531,9 @@ void V8GCController::gcEpilogue()
 
     enumerateGlobalHandles();
 #endif
+#if PLATFORM(ANDROID)
+    TraceEventAndroid::end("v8", "GC");
+#endif
 }
 
 void V8GCController::checkMemoryUsage()
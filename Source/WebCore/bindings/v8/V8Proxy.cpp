@@ -88,6 +88,7 @@
 #endif
 
 #if PLATFORM(ANDROID)
+#include "TraceEventAndroid.h"
 #include <wtf/text/CString.h>
 #endif
 
@@ -352,6 +353,9 @@ bool V8Proxy::executingScript() const
 v8::Local<v8::Value> V8Proxy::evaluate(const ScriptSourceCode& source, Node* node)
 {
     ASSERT(v8::Context::InContext());
+#if PLATFORM(ANDROID)
+    ANDROID_TRACE_EVENT("v8", "V8Proxy::evaluate");
+#endif
 
     V8GCController::checkMemoryUsage();
 
@@ -470,6 +474,9 @@ v8::Local<v8::Value> V8Proxy::runScriptInternal(v8::Handle<v8::Script> script, b
 
 v8::Local<v8::Value> V8Proxy::callFunction(v8::Handle<v8::Function> function, v8::Handle<v8::Object> receiver, int argc, v8::Handle<v8::Value> args[])
 {
+#if PLATFORM(ANDROID)
+    ANDROID_TRACE_EVENT("v8", "V8Proxy::callFunction");
+#endif
 #ifdef ANDROID_INSTRUMENT
     android::TimeCounter::start(android::TimeCounter::JavaScriptExecuteTimeCounter);
 #endif
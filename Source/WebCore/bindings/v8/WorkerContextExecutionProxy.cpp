@@ -49,7 +49,11 @@
 #include "WorkerContext.h"
 #include "WorkerScriptController.h"
 #include "WrapperTypeInfo.h"
+#include <wtf/HashMap.h>
+#include <wtf/Threading.h>
+#include <wtf/Vector.h>
 #include <wtf/text/CString.h>
+#include <wtf/text/StringHash.h>
 
 namespace WebCore {
 
@@ -79,6 +83,76 @@ static void v8MessageHandler(v8::Handle<v8::Message> message, v8::Handle<v8::Val
     isReportingException = false;
 }
 
+// Worker scripts never come from a CachedScript, so V8Proxy::precompileScript() cannot help them.
+// Pages tend to start many short-lived workers running the same script, so the preparse data is
+// kept in a process-wide table shared by all worker threads instead, keyed by script URL and
+// checked against the source hash so that a changed script is preparsed again.
+struct WorkerScriptPreparseData {
+    WTF_MAKE_NONCOPYABLE(WorkerScriptPreparseData); WTF_MAKE_FAST_ALLOCATED;
+public:
+    WorkerScriptPreparseData(unsigned sourceHash, unsigned sourceLength, const char* data, int length)
+        : m_sourceHash(sourceHash)
+        , m_sourceLength(sourceLength)
+    {
+        m_data.append(data, length);
+    }
+
+    unsigned m_sourceHash;
+    unsigned m_sourceLength;
+    Vector<char> m_data;
+};
+
+typedef HashMap<String, WorkerScriptPreparseData*> WorkerScriptPreparseDataMap;
+
+static const int minWorkerPreparseLength = 1024;
+static const unsigned maxWorkerPreparseEntries = 32;
+
+static Mutex& workerScriptPreparseDataMutex()
+{
+    AtomicallyInitializedStatic(Mutex&, mutex = *new Mutex);
+    return mutex;
+}
+
+static WorkerScriptPreparseDataMap& workerScriptPreparseDataMap()
+{
+    // Only accessed with workerScriptPreparseDataMutex() held.
+    DEFINE_STATIC_LOCAL(WorkerScriptPreparseDataMap, map, ());
+    return map;
+}
+
+static PassOwnPtr<v8::ScriptData> preparseWorkerScript(v8::Handle<v8::String> code, const String& script, const String& fileName)
+{
+    if (fileName.isEmpty() || code->Length() < minWorkerPreparseLength)
+        return PassOwnPtr<v8::ScriptData>();
+
+    unsigned sourceHash = script.impl()->hash();
+    {
+        MutexLocker lock(workerScriptPreparseDataMutex());
+        WorkerScriptPreparseData* cached = workerScriptPreparseDataMap().get(fileName);
+        if (cached && cached->m_sourceHash == sourceHash && cached->m_sourceLength == script.length())
+            return adoptPtr(v8::ScriptData::New(cached->m_data.data(), cached->m_data.size()));
+    }
+
+    // Preparse outside the lock; two workers racing on the same script just do the work twice.
+    OwnPtr<v8::ScriptData> scriptData = adoptPtr(v8::ScriptData::PreCompile(code));
+    if (!scriptData || scriptData->HasError())
+        return scriptData.release();
+
+    MutexLocker lock(workerScriptPreparseDataMutex());
+    WorkerScriptPreparseDataMap& map = workerScriptPreparseDataMap();
+    WorkerScriptPreparseDataMap::iterator it = map.find(fileName);
+    if (it != map.end()) {
+        delete it->second;
+        map.remove(it);
+    } else if (map.size() >= maxWorkerPreparseEntries) {
+        it = map.begin();
+        delete it->second;
+        map.remove(it);
+    }
+    map.set(fileName.crossThreadString(), new WorkerScriptPreparseData(sourceHash, script.length(), scriptData->Data(), scriptData->Length()));
+    return scriptData.release();
+}
+
 WorkerContextExecutionProxy::WorkerContextExecutionProxy(WorkerContext* workerContext)
     : m_workerContext(workerContext)
     , m_recursion(0)
@@ -200,7 +274,8 @@ ScriptValue WorkerContextExecutionProxy::evaluate(const String& script, const St
     v8::TryCatch exceptionCatcher;
 
     v8::Local<v8::String> scriptString = v8ExternalString(script);
-    v8::Handle<v8::Script> compiledScript = V8Proxy::compileScript(scriptString, fileName, scriptStartPosition);
+    OwnPtr<v8::ScriptData> scriptData = preparseWorkerScript(scriptString, script, fileName);
+    v8::Handle<v8::Script> compiledScript = V8Proxy::compileScript(scriptString, fileName, scriptStartPosition, scriptData.get());
     v8::Local<v8::Value> result = runScript(compiledScript);
 
     if (!exceptionCatcher.CanContinue()) {
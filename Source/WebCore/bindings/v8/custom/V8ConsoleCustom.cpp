@@ -76,8 +76,12 @@ v8::Handle<v8::Value> V8Console::assertCallback(const v8::Arguments& args)
 {
     INC_STATS("DOM.Console.assertCallback");
     Console* imp = V8Console::toNative(args.Holder());
-    RefPtr<ScriptCallStack> callStack(createScriptCallStack(ScriptCallStack::maxCallStackSizeToCapture));
     bool condition = args[0]->BooleanValue();
+    // Passing assertions are not reported, so don't pay for capturing them.
+    if (condition)
+        return v8::Handle<v8::Value>();
+    size_t maxStackSize = imp->shouldCaptureFullStackTrace() ? ScriptCallStack::maxCallStackSizeToCapture : 1;
+    RefPtr<ScriptCallStack> callStack(createScriptCallStack(maxStackSize));
     RefPtr<ScriptArguments> scriptArguments(createScriptArguments(args, 1));
     imp->assertCondition(condition, scriptArguments.release(), callStack);
     return v8::Handle<v8::Value>();
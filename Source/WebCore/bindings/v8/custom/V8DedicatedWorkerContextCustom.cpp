@@ -33,6 +33,7 @@
 #if ENABLE(WORKERS)
 #include "V8DedicatedWorkerContext.h"
 
+#include "ArrayBuffer.h"
 #include "DedicatedWorkerContext.h"
 #include "WorkerContextExecutionProxy.h"
 #include "V8Binding.h"
@@ -46,15 +47,16 @@ v8::Handle<v8::Value> V8DedicatedWorkerContext::postMessageCallback(const v8::Ar
 {
     INC_STATS(L"DOM.DedicatedWorkerContext.postMessage");
     DedicatedWorkerContext* workerContext = V8DedicatedWorkerContext::toNative(args.Holder());
-    bool didThrow = false;
-    RefPtr<SerializedScriptValue> message = SerializedScriptValue::create(args[0], didThrow);
-    if (didThrow)
-        return v8::Undefined();
     MessagePortArray portArray;
+    ArrayBufferArray arrayBufferArray;
     if (args.Length() > 1) {
-        if (!getMessagePortArray(args[1], portArray))
+        if (!extractTransferables(args[1], portArray, arrayBufferArray))
             return v8::Undefined();
     }
+    bool didThrow = false;
+    RefPtr<SerializedScriptValue> message = SerializedScriptValue::create(args[0], &arrayBufferArray, didThrow);
+    if (didThrow)
+        return v8::Undefined();
     ExceptionCode ec = 0;
     workerContext->postMessage(message.release(), &portArray, ec);
     return throwError(ec);
@@ -30,9 +30,11 @@
 
 #include "config.h"
 
+#include "ArrayBuffer.h"
 #include "ExceptionCode.h"
 #include "MessagePort.h"
 #include "SerializedScriptValue.h"
+#include "V8ArrayBuffer.h"
 #include "V8Binding.h"
 #include "V8MessagePortCustom.h"
 #include "V8MessagePort.h"
@@ -62,10 +64,22 @@ v8::Handle<v8::Value> V8MessagePort::postMessageCallback(const v8::Arguments& ar
 
 bool getMessagePortArray(v8::Local<v8::Value> value, MessagePortArray& portArray)
 {
-    if (isUndefinedOrNull(value)) {
-        portArray.resize(0);
-        return true;
+    ArrayBufferArray arrayBuffers;
+    if (!extractTransferables(value, portArray, arrayBuffers))
+        return false;
+    if (!arrayBuffers.isEmpty()) {
+        throwError("MessagePortArray argument must contain only MessagePorts");
+        return false;
     }
+    return true;
+}
+
+bool extractTransferables(v8::Local<v8::Value> value, MessagePortArray& portArray, ArrayBufferArray& arrayBuffers)
+{
+    portArray.resize(0);
+    arrayBuffers.resize(0);
+    if (isUndefinedOrNull(value))
+        return true;
 
     if (!value->IsObject()) {
         throwError("MessagePortArray argument must be an object");
@@ -86,7 +100,7 @@ bool getMessagePortArray(v8::Local<v8::Value> value, MessagePortArray& portArray
         }
         length = sequenceLength->Uint32Value();
     }
-    portArray.resize(length);
+    portArray.reserveInitialCapacity(length);
 
     for (unsigned int i = 0; i < length; ++i) {
         v8::Local<v8::Value> port = ports->Get(v8::Integer::New(i));
@@ -96,11 +110,14 @@ bool getMessagePortArray(v8::Local<v8::Value> value, MessagePortArray& portArray
             return false;
         }
         // Validation of Objects implementing an interface, per WebIDL spec 4.1.15.
-        if (!V8MessagePort::HasInstance(port)) {
-            throwError("MessagePortArray argument must contain only MessagePorts");
+        if (V8MessagePort::HasInstance(port))
+            portArray.append(V8MessagePort::toNative(v8::Handle<v8::Object>::Cast(port)));
+        else if (V8ArrayBuffer::HasInstance(port))
+            arrayBuffers.append(V8ArrayBuffer::toNative(v8::Handle<v8::Object>::Cast(port)));
+        else {
+            throwError("MessagePortArray argument must contain only MessagePorts and ArrayBuffers");
             return false;
         }
-        portArray[i] = V8MessagePort::toNative(v8::Handle<v8::Object>::Cast(port));
     }
     return true;
 }
@@ -35,6 +35,7 @@
 #include <v8.h>
 
 #include "MessagePort.h"
+#include "SerializedScriptValue.h"
 
 namespace WebCore {
 
@@ -43,6 +44,10 @@ namespace WebCore {
     // Returns true if the array was filled, or false if the passed value was not of an appropriate type.
     bool getMessagePortArray(v8::Local<v8::Value>, MessagePortArray&);
 
+    // Like getMessagePortArray(), but the sequence may also contain ArrayBuffers, which are collected into
+    // the ArrayBufferArray so that they can be transferred rather than copied.
+    bool extractTransferables(v8::Local<v8::Value>, MessagePortArray&, ArrayBufferArray&);
+
 } // namespace WebCore
 
 #endif // V8MessagePortCustom_h
@@ -35,6 +35,7 @@
 
 #include "Worker.h"
 
+#include "ArrayBuffer.h"
 #include "ExceptionCode.h"
 #include "Frame.h"
 #include "SerializedScriptValue.h"
@@ -91,15 +92,16 @@ v8::Handle<v8::Value> V8Worker::postMessageCallback(const v8::Arguments& args)
 {
     INC_STATS("DOM.Worker.postMessage");
     Worker* worker = V8Worker::toNative(args.Holder());
-    bool didThrow = false;
-    RefPtr<SerializedScriptValue> message = SerializedScriptValue::create(args[0], didThrow);
-    if (didThrow)
-        return v8::Undefined();
     MessagePortArray portArray;
+    ArrayBufferArray arrayBufferArray;
     if (args.Length() > 1) {
-        if (!getMessagePortArray(args[1], portArray))
+        if (!extractTransferables(args[1], portArray, arrayBufferArray))
             return v8::Undefined();
     }
+    bool didThrow = false;
+    RefPtr<SerializedScriptValue> message = SerializedScriptValue::create(args[0], &arrayBufferArray, didThrow);
+    if (didThrow)
+        return v8::Undefined();
     ExceptionCode ec = 0;
     worker->postMessage(message.release(), &portArray, ec);
     return throwError(ec);
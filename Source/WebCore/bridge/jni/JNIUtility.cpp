@@ -352,7 +352,11 @@ jvalue getJNIField(jobject obj, JavaType type, const char* name, const char* sig
 
 jvalue callJNIMethod(jobject object, JavaType returnType, const char* name, const char* signature, jvalue* args)
 {
-    jmethodID methodId = getMethodID(object, name, signature);
+    return callJNIMethod(object, returnType, getMethodID(object, name, signature), args);
+}
+
+jvalue callJNIMethod(jobject object, JavaType returnType, jmethodID methodId, jvalue* args)
+{
     jvalue result;
     switch (returnType) {
     case JavaTypeVoid:
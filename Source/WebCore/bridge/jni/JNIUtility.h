@@ -54,6 +54,7 @@ const char* signatureFromJavaType(JavaType);
 
 jvalue getJNIField(jobject, JavaType, const char* name, const char* signature);
 jvalue callJNIMethod(jobject, JavaType returnType, const char* name, const char* signature, jvalue* args);
+jvalue callJNIMethod(jobject, JavaType returnType, jmethodID, jvalue* args);
 
 jmethodID getMethodID(jobject, const char* name, const char* sig);
 JNIEnv* getJNIEnv();
@@ -47,6 +47,7 @@ public:
     virtual String name() const = 0;
     virtual RuntimeType returnTypeClassName() const = 0;
     virtual String parameterAt(int) const = 0;
+    virtual JavaType parameterTypeAt(int) const = 0;
     virtual const char* signature() const = 0;
     virtual JavaType returnType() const = 0;
     virtual bool isStatic() const = 0;
@@ -70,7 +70,9 @@ JavaMethodJobject::JavaMethodJobject(JNIEnv* env, jobject aMethod)
             jstring parameterName = static_cast<jstring>(callJNIMethod<jobject>(aParameter, "getName", "()Ljava/lang/String;"));
             if (!parameterName)
                 parameterName = env->NewStringUTF("<Unknown>");
-            m_parameters.append(JavaString(env, parameterName).impl());
+            JavaString parameter(env, parameterName);
+            m_parameters.append(parameter.impl());
+            m_parameterTypes.append(javaTypeFromClassName(parameter.utf8()));
             env->DeleteLocalRef(aParameter);
             env->DeleteLocalRef(parameterName);
         }
@@ -79,6 +81,7 @@ JavaMethodJobject::JavaMethodJobject(JNIEnv* env, jobject aMethod)
 
     // Created lazily.
     m_signature = 0;
+    m_methodID = 0;
 
     jclass modifierClass = env->FindClass("java/lang/reflect/Modifier");
     int modifiers = callJNIMethod<jint>(aMethod, "getModifiers", "()I");
@@ -164,4 +167,11 @@ const char* JavaMethodJobject::signature() const
     return m_signature;
 }
 
+jmethodID JavaMethodJobject::methodID(jobject obj) const
+{
+    if (!m_methodID)
+        m_methodID = getMethodID(obj, m_name.utf8(), signature());
+    return m_methodID;
+}
+
 #endif // ENABLE(JAVA_BRIDGE)
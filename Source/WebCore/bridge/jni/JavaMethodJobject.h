@@ -47,6 +47,7 @@ public:
     virtual String name() const { return m_name.impl(); }
     virtual RuntimeType returnTypeClassName() const { return m_returnTypeClassName.utf8(); }
     virtual String parameterAt(int i) const { return m_parameters[i]; }
+    virtual JavaType parameterTypeAt(int i) const { return m_parameterTypes[i]; }
     virtual const char* signature() const;
     virtual JavaType returnType() const { return m_returnType; }
     virtual bool isStatic() const { return m_isStatic; }
@@ -54,13 +55,19 @@ public:
     // Method implementation
     virtual int numParameters() const { return m_parameters.size(); }
 
+    // Looked up the first time the method is called on obj, which must be an
+    // instance of the class the method was reflected from.
+    jmethodID methodID(jobject obj) const;
+
 private:
     Vector<String> m_parameters;
+    Vector<JavaType> m_parameterTypes;
     JavaString m_name;
     mutable char* m_signature;
     JavaString m_returnTypeClassName;
     JavaType m_returnType;
     bool m_isStatic;
+    mutable jmethodID m_methodID;
 };
 
 } // namespace Bindings
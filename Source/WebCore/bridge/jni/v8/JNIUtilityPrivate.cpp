@@ -42,8 +42,11 @@ namespace Bindings {
 
 JavaValue convertNPVariantToJavaValue(NPVariant value, const String& javaClass)
 {
-    CString javaClassName = javaClass.utf8();
-    JavaType javaType = javaTypeFromClassName(javaClassName.data());
+    return convertNPVariantToJavaValue(value, javaTypeFromClassName(javaClass.utf8().data()), javaClass);
+}
+
+JavaValue convertNPVariantToJavaValue(NPVariant value, JavaType javaType, const String& javaClass)
+{
     JavaValue result;
     result.m_type = javaType;
     NPVariantType type = value.type;
@@ -59,6 +62,7 @@ JavaValue convertNPVariantToJavaValue(NPVariant value, const String& javaClass)
         // FIXME: This is a hack. We should not be using JNI here. We should
         // represent the JavaValue without JNI.
         {
+            CString javaClassName = javaClass.utf8();
             JNIEnv* env = getJNIEnv();
             jobject javaArray;
             NPObject* object = NPVARIANT_IS_OBJECT(value) ? NPVARIANT_TO_OBJECT(value) : 0;
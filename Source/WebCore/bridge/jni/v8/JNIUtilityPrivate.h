@@ -39,6 +39,9 @@ namespace Bindings {
 class JavaValue;
 
 JavaValue convertNPVariantToJavaValue(NPVariant, const String& javaClass);
+// Used when the caller already knows the JavaType of javaClass, so that the
+// class name only needs converting for array parameters.
+JavaValue convertNPVariantToJavaValue(NPVariant, JavaType, const String& javaClass);
 void convertJavaValueToNPVariant(JavaValue, NPVariant*);
 
 JavaValue jvalueToJavaValue(const jvalue&, const JavaType&);
@@ -32,7 +32,7 @@
 #include "JNIUtilityPrivate.h"
 #include "JavaClassJobjectV8.h"
 #include "JavaFieldV8.h"
-#include "JavaMethod.h"
+#include "JavaMethodJobject.h"
 
 #include <wtf/OwnArrayPtr.h>
 #include <wtf/PassOwnPtr.h>
@@ -72,7 +72,10 @@ JavaValue JavaInstanceJobject::invokeMethod(const JavaMethod* method, JavaValue*
     OwnArrayPtr<jvalue> jvalueArgs = adoptArrayPtr(new jvalue[numParams]);
     for (unsigned int i = 0; i < numParams; ++i)
         jvalueArgs[i] = javaValueToJvalue(args[i]);
-    jvalue result = callJNIMethod(javaInstance(), method->returnType(), method->name().utf8().data(), method->signature(), jvalueArgs.get());
+    // All methods are reflected by JavaClassJobject, so this is safe.
+    jobject obj = javaInstance();
+    jmethodID methodID = static_cast<const JavaMethodJobject*>(method)->methodID(obj);
+    jvalue result = callJNIMethod(obj, method->returnType(), methodID, jvalueArgs.get());
     return jvalueToJavaValue(result, method->returnType());
 }
 
@@ -37,10 +37,62 @@
 #include "JavaValueV8.h"
 #include "npruntime_impl.h"
 
+#ifdef ANDROID_INSTRUMENT
+#include <utils/Log.h>
+#include <wtf/CurrentTime.h>
+#include <wtf/HashMap.h>
+#include <wtf/StdLibExtras.h>
+#include <wtf/text/CString.h>
+#include <wtf/text/StringHash.h>
+#endif
+
 namespace JSC {
 
 namespace Bindings {
 
+#ifdef ANDROID_INSTRUMENT
+// Per-method totals for calls made from JavaScript into Java objects. Only
+// touched on the WebCore thread, which is where all bridge calls happen.
+struct JavaBridgeMethodStats {
+    JavaBridgeMethodStats() : calls(0), conversionTime(0), jniTime(0) { }
+    unsigned calls;
+    double conversionTime; // NPVariant <-> JavaValue, in seconds
+    double jniTime; // the JNI call itself, in seconds
+};
+
+typedef HashMap<String, JavaBridgeMethodStats> JavaBridgeStatsMap;
+
+static JavaBridgeStatsMap& javaBridgeStats()
+{
+    DEFINE_STATIC_LOCAL(JavaBridgeStatsMap, stats, ());
+    return stats;
+}
+
+static void recordJavaBridgeCall(const JavaMethod* method, double conversionTime, double jniTime)
+{
+    String key = method->name();
+    key.append(method->signature());
+    JavaBridgeStatsMap::iterator it = javaBridgeStats().add(key, JavaBridgeMethodStats()).first;
+    it->second.calls++;
+    it->second.conversionTime += conversionTime;
+    it->second.jniTime += jniTime;
+}
+
+void dumpJavaBridgeProfile()
+{
+    LOGD("+----------------------------------------+--------+----------+----------+\n");
+    LOGD("| Java bridge method                     | Calls  | Conv ms  | JNI ms   |\n");
+    LOGD("+----------------------------------------+--------+----------+----------+\n");
+    JavaBridgeStatsMap& stats = javaBridgeStats();
+    for (JavaBridgeStatsMap::iterator it = stats.begin(); it != stats.end(); ++it) {
+        LOGD("| %-38s | %6u | %8.2f | %8.2f |\n", it->first.utf8().data(), it->second.calls,
+            it->second.conversionTime * 1000, it->second.jniTime * 1000);
+    }
+    LOGD("+----------------------------------------+--------+----------+----------+\n");
+    stats.clear();
+}
+#endif // ANDROID_INSTRUMENT
+
 static NPObject* AllocJavaNPObject(NPP, NPClass*)
 {
     JavaNPObject* obj = static_cast<JavaNPObject*>(malloc(sizeof(JavaNPObject)));
@@ -142,16 +194,34 @@ bool JavaNPObjectInvoke(NPObject* obj, NPIdentifier identifier, const NPVariant*
         return false;
     }
 
+#ifdef ANDROID_INSTRUMENT
+    double startTime = currentTime();
+#endif
+
+    // The parameter types were resolved when the method was reflected, so
+    // primitive and String parameters never need their class name converted.
     JavaValue* jArgs = new JavaValue[argCount];
-    for (unsigned int i = 0; i < argCount; i++)
-        jArgs[i] = convertNPVariantToJavaValue(args[i], jMethod->parameterAt(i));
+    for (unsigned int i = 0; i < argCount; i++) {
+        JavaType type = jMethod->parameterTypeAt(i);
+        jArgs[i] = convertNPVariantToJavaValue(args[i], type, type == JavaTypeArray ? jMethod->parameterAt(i) : String());
+    }
 
+#ifdef ANDROID_INSTRUMENT
+    double invokeTime = currentTime();
+#endif
     JavaValue jResult = instance->invokeMethod(jMethod, jArgs);
+#ifdef ANDROID_INSTRUMENT
+    double returnTime = currentTime();
+#endif
     instance->end();
     delete[] jArgs;
 
     VOID_TO_NPVARIANT(*result);
     convertJavaValueToNPVariant(jResult, result);
+#ifdef ANDROID_INSTRUMENT
+    double endTime = currentTime();
+    recordJavaBridgeCall(jMethod, (invokeTime - startTime) + (endTime - returnTime), returnTime - invokeTime);
+#endif
     return true;
 }
 
@@ -51,6 +51,11 @@ bool JavaNPObjectInvoke(NPObject*, NPIdentifier methodName, const NPVariant* arg
 bool JavaNPObjectHasProperty(NPObject*, NPIdentifier name);
 bool JavaNPObjectGetProperty(NPObject*, NPIdentifier name, NPVariant* result);
 
+#ifdef ANDROID_INSTRUMENT
+// Logs, then resets, the per-method call counts and timings of the bridge.
+void dumpJavaBridgeProfile();
+#endif
+
 } // namespace Bindings
 
 } // namespace JSC
@@ -177,6 +177,9 @@ SimpleFontData* CSSFontFaceSource::getFontData(const FontDescription& fontDescri
         // Kick off the load now.
         if (CachedResourceLoader* cachedResourceLoader = fontSelector->cachedResourceLoader())
             m_font->beginLoadIfNeeded(cachedResourceLoader);
+#if PLATFORM(ANDROID)
+        fontSelector->webFontLoadStarted();
+#endif
         // FIXME: m_string is a URL so it makes no sense to pass it as a family name.
         SimpleFontData* tempData = fontCache()->getCachedFontData(fontDescription, m_string);
         if (!tempData)
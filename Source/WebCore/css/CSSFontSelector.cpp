@@ -58,6 +58,10 @@ namespace WebCore {
 
 CSSFontSelector::CSSFontSelector(Document* document)
     : m_document(document)
+#if PLATFORM(ANDROID)
+    , m_webFontLoadTimer(this, &CSSFontSelector::webFontLoadTimerFired)
+    , m_webFontLoadTimedOut(false)
+#endif
 {
     // FIXME: An old comment used to say there was no need to hold a reference to m_document
     // because "we are guaranteed to be destroyed before the document". But there does not
@@ -379,6 +383,26 @@ void CSSFontSelector::fontCacheInvalidated()
     dispatchInvalidationCallbacks();
 }
 
+#if PLATFORM(ANDROID)
+void CSSFontSelector::webFontLoadStarted()
+{
+    if (m_webFontLoadTimedOut || m_webFontLoadTimer.isActive())
+        return;
+    if (!m_document || !m_document->settings())
+        return;
+    m_webFontLoadTimer.startOneShot(m_document->settings()->webFontLoadTimeout());
+}
+
+void CSSFontSelector::webFontLoadTimerFired(Timer<CSSFontSelector>*)
+{
+    // Layout already used the fallback metrics, but text in fonts that are
+    // still loading has to be restyled to be repainted; only that text is,
+    // as Fonts that use a loading font never compare equal.
+    m_webFontLoadTimedOut = true;
+    dispatchInvalidationCallbacks();
+}
+#endif
+
 static FontData* fontDataForGenericFamily(Document* document, const FontDescription& fontDescription, const AtomicString& familyName)
 {
     if (!document || !document->frame())
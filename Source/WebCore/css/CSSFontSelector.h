@@ -27,6 +27,9 @@
 #define CSSFontSelector_h
 
 #include "FontSelector.h"
+#if PLATFORM(ANDROID)
+#include "Timer.h"
+#endif
 #include <wtf/Forward.h>
 #include <wtf/HashMap.h>
 #include <wtf/HashSet.h>
@@ -66,16 +69,30 @@ public:
     virtual void registerForInvalidationCallbacks(FontSelectorClient*);
     virtual void unregisterForInvalidationCallbacks(FontSelectorClient*);
 
+#if PLATFORM(ANDROID)
+    // Starts the wait after which text set in web fonts that haven't
+    // arrived is painted with the fallback font.
+    void webFontLoadStarted();
+    virtual bool drawsTextWhileLoadingFonts() const { return m_webFontLoadTimedOut; }
+#endif
+
 private:
     CSSFontSelector(Document*);
 
     void dispatchInvalidationCallbacks();
+#if PLATFORM(ANDROID)
+    void webFontLoadTimerFired(Timer<CSSFontSelector>*);
+#endif
 
     Document* m_document;
     HashMap<String, Vector<RefPtr<CSSFontFace> >*, CaseFoldingHash> m_fontFaces;
     HashMap<String, Vector<RefPtr<CSSFontFace> >*, CaseFoldingHash> m_locallyInstalledFontFaces;
     HashMap<String, HashMap<unsigned, RefPtr<CSSSegmentedFontFace> >*, CaseFoldingHash> m_fonts;
     HashSet<FontSelectorClient*> m_clients;
+#if PLATFORM(ANDROID)
+    Timer<CSSFontSelector> m_webFontLoadTimer;
+    bool m_webFontLoadTimedOut;
+#endif
 };
 
 } // namespace WebCore
@@ -325,8 +325,7 @@ webkit_value:
             int oldParsedProperties = p->m_numParsedProperties;
             if (!p->parseValue(p->m_id, p->m_important))
                 p->rollbackLastProperties(p->m_numParsedProperties - oldParsedProperties);
-            delete p->m_valueList;
-            p->m_valueList = 0;
+            p->clearValueList();
         }
     }
 ;
@@ -1294,8 +1293,7 @@ declaration:
                 p->rollbackLastProperties(p->m_numParsedProperties - oldParsedProperties);
             else
                 isPropertyParsed = true;
-            delete p->m_valueList;
-            p->m_valueList = 0;
+            p->clearValueList();
         }
         p->markPropertyEnd($5, isPropertyParsed);
     }
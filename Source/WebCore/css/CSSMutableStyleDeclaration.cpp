@@ -636,8 +636,20 @@ void CSSMutableStyleDeclaration::parseDeclaration(const String& styleDeclaration
     ASSERT(!m_iteratorCount);
 
     m_properties.clear();
+
+    Document* document = m_node ? m_node->document() : 0;
+    if (document) {
+        if (CSSMutableStyleDeclaration* cachedDeclaration = document->cachedInlineStyleDeclaration(styleDeclaration, useStrictParsing())) {
+            m_properties = cachedDeclaration->m_properties;
+            setNeedsStyleRecalc();
+            return;
+        }
+    }
+
     CSSParser parser(useStrictParsing());
     parser.parseDeclaration(this, styleDeclaration);
+    if (document)
+        document->addInlineStyleDeclarationToCache(styleDeclaration, this);
     setNeedsStyleRecalc();
 }
 
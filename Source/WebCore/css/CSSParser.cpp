@@ -428,12 +428,82 @@ static bool parseSimpleLengthValue(CSSMutableStyleDeclaration* declaration, int
     return true;
 }
 
+static bool parseSimpleNumberValue(CSSMutableStyleDeclaration* declaration, int propertyId, const String& string, bool important)
+{
+    if (propertyId != CSSPropertyOpacity)
+        return false;
+    const UChar* characters = string.characters();
+    unsigned length = string.length();
+    if (!characters || !length)
+        return false;
+
+    bool ok;
+    double number = charactersToDouble(characters, length, &ok);
+    if (!ok)
+        return false;
+
+    CSSStyleSheet* stylesheet = static_cast<CSSStyleSheet*>(declaration->stylesheet());
+    if (!stylesheet || !stylesheet->document())
+        return false;
+    CSSProperty property(propertyId, stylesheet->document()->cssPrimitiveValueCache()->createValue(number, CSSPrimitiveValue::CSS_NUMBER), important);
+    declaration->addParsedProperty(property);
+    return true;
+}
+
+// Keep these in sync with the corresponding cases in CSSParser::parseValue(int, bool).
+static bool isValidKeywordPropertyAndValue(int propertyId, int valueID)
+{
+    switch (propertyId) {
+    case CSSPropertyDisplay:
+#if ENABLE(WCSS)
+        return (valueID >= CSSValueInline && valueID <= CSSValueWapMarquee) || valueID == CSSValueNone;
+#else
+        return (valueID >= CSSValueInline && valueID <= CSSValueWebkitInlineBox) || valueID == CSSValueNone;
+#endif
+    case CSSPropertyVisibility:
+        return valueID == CSSValueVisible || valueID == CSSValueHidden || valueID == CSSValueCollapse;
+    case CSSPropertyPosition:
+        return valueID == CSSValueStatic || valueID == CSSValueRelative || valueID == CSSValueAbsolute || valueID == CSSValueFixed;
+    case CSSPropertyFloat:
+        return valueID == CSSValueLeft || valueID == CSSValueRight || valueID == CSSValueNone || valueID == CSSValueCenter;
+    default:
+        return false;
+    }
+}
+
+static bool parseKeywordValue(CSSMutableStyleDeclaration* declaration, int propertyId, const String& string, bool important)
+{
+    if (!string.length())
+        return false;
+    if (propertyId != CSSPropertyDisplay && propertyId != CSSPropertyVisibility
+        && propertyId != CSSPropertyPosition && propertyId != CSSPropertyFloat)
+        return false;
+
+    CSSParserString cssString;
+    cssString.characters = const_cast<UChar*>(string.characters());
+    cssString.length = string.length();
+    int valueID = cssValueKeywordID(cssString);
+    if (!isValidKeywordPropertyAndValue(propertyId, valueID))
+        return false;
+
+    CSSStyleSheet* stylesheet = static_cast<CSSStyleSheet*>(declaration->stylesheet());
+    if (!stylesheet || !stylesheet->document())
+        return false;
+    CSSProperty property(propertyId, stylesheet->document()->cssPrimitiveValueCache()->createIdentifierValue(valueID), important);
+    declaration->addParsedProperty(property);
+    return true;
+}
+
 bool CSSParser::parseValue(CSSMutableStyleDeclaration* declaration, int propertyId, const String& string, bool important, bool strict)
 {
     if (parseSimpleLengthValue(declaration, propertyId, string, important, strict))
         return true;
     if (parseColorValue(declaration, propertyId, string, important, strict))
         return true;
+    if (parseSimpleNumberValue(declaration, propertyId, string, important))
+        return true;
+    if (parseKeywordValue(declaration, propertyId, string, important))
+        return true;
     CSSParser parser(strict);
     return parser.parseValue(declaration, propertyId, string, important);
 }
@@ -6260,7 +6330,7 @@ PassOwnPtr<Vector<OwnPtr<CSSParserSelector> > > CSSParser::sinkFloatingSelectorV
 
 CSSParserValueList* CSSParser::createFloatingValueList()
 {
-    CSSParserValueList* list = new CSSParserValueList;
+    CSSParserValueList* list = new (m_valueArena) CSSParserValueList;
     m_floatingValueLists.add(list);
     return list;
 }
@@ -6276,7 +6346,7 @@ CSSParserValueList* CSSParser::sinkFloatingValueList(CSSParserValueList* list)
 
 CSSParserFunction* CSSParser::createFloatingFunction()
 {
-    CSSParserFunction* function = new CSSParserFunction;
+    CSSParserFunction* function = new (m_valueArena) CSSParserFunction;
     m_floatingFunctions.add(function);
     return function;
 }
@@ -6299,9 +6369,20 @@ CSSParserValue& CSSParser::sinkFloatingValue(CSSParserValue& value)
     return value;
 }
 
+void CSSParser::clearValueList()
+{
+    delete m_valueList;
+    m_valueList = 0;
+    // With nothing floating either, no live object is left in the arena.
+    if (m_floatingValueLists.isEmpty() && m_floatingFunctions.isEmpty())
+        m_valueArena.clear();
+}
+
 MediaQueryExp* CSSParser::createFloatingMediaQueryExp(const AtomicString& mediaFeature, CSSParserValueList* values)
 {
     m_floatingMediaQueryExp = MediaQueryExp::create(mediaFeature, values);
+    // The expression copied what it needs out of the values.
+    delete sinkFloatingValueList(values);
     return m_floatingMediaQueryExp.get();
 }
 
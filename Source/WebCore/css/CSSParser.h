@@ -195,6 +195,7 @@ namespace WebCore {
         CSSParserFunction* sinkFloatingFunction(CSSParserFunction*);
 
         CSSParserValue& sinkFloatingValue(CSSParserValue&);
+        void clearValueList();
 
         MediaList* createMediaList();
         CSSRule* createCharsetRule(const CSSParserString&);
@@ -326,6 +327,7 @@ namespace WebCore {
         HashSet<Vector<OwnPtr<CSSParserSelector> >*> m_floatingSelectorVectors;
         HashSet<CSSParserValueList*> m_floatingValueLists;
         HashSet<CSSParserFunction*> m_floatingFunctions;
+        BumpArena m_valueArena;
 
         OwnPtr<MediaQuery> m_floatingMediaQuery;
         OwnPtr<MediaQueryExp> m_floatingMediaQueryExp;
@@ -22,6 +22,7 @@
 #define CSSParserValues_h
 
 #include "CSSSelector.h"
+#include <wtf/BumpArena.h>
 #include <wtf/text/AtomicString.h>
 
 namespace WebCore {
@@ -61,9 +62,15 @@ struct CSSParserValue {
     PassRefPtr<CSSValue> createCSSValue();
 };
 
+// Value lists and functions only live while the parser works on a single
+// declaration, so they are carved out of CSSParser's arena. Deleting one runs
+// its destructor; the memory comes back when the parser clears the arena.
 class CSSParserValueList {
-    WTF_MAKE_FAST_ALLOCATED;
 public:
+    void* operator new(size_t size, BumpArena& arena) { return arena.allocate(size); }
+    void operator delete(void*) { }
+    void operator delete(void*, BumpArena&) { }
+
     CSSParserValueList()
         : m_current(0)
     {
@@ -89,8 +96,10 @@ private:
 };
 
 struct CSSParserFunction {
-    WTF_MAKE_FAST_ALLOCATED;
-public:
+    void* operator new(size_t size, BumpArena& arena) { return arena.allocate(size); }
+    void operator delete(void*) { }
+    void operator delete(void*, BumpArena&) { }
+
     CSSParserString name;
     OwnPtr<CSSParserValueList> args;
 };
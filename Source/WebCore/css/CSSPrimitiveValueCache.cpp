@@ -35,6 +35,7 @@ CSSPrimitiveValueCache::CSSPrimitiveValueCache()
     , m_pixelZero(CSSPrimitiveValue::create(0, CSSPrimitiveValue::CSS_PX))
     , m_percentZero(CSSPrimitiveValue::create(0, CSSPrimitiveValue::CSS_PERCENTAGE))
     , m_numberZero(CSSPrimitiveValue::create(0, CSSPrimitiveValue::CSS_NUMBER))
+    , m_emsZero(CSSPrimitiveValue::create(0, CSSPrimitiveValue::CSS_EMS))
 {
 }
 
@@ -105,6 +106,11 @@ PassRefPtr<CSSPrimitiveValue> CSSPrimitiveValueCache::createValue(double value,
             return m_numberZero;
         cache = &m_numberValueCache;
         break;
+    case CSSPrimitiveValue::CSS_EMS:
+        if (intValue == 0)
+            return m_emsZero;
+        cache = &m_emsValueCache;
+        break;
     default:
         return CSSPrimitiveValue::create(value, type);
     }
@@ -62,9 +62,11 @@ private:
     RefPtr<CSSPrimitiveValue> m_pixelZero;
     RefPtr<CSSPrimitiveValue> m_percentZero;
     RefPtr<CSSPrimitiveValue> m_numberZero;
+    RefPtr<CSSPrimitiveValue> m_emsZero;
     IntegerValueCache m_pixelValueCache;
     IntegerValueCache m_percentValueCache;
     IntegerValueCache m_numberValueCache;
+    IntegerValueCache m_emsValueCache;
 };
 
 }
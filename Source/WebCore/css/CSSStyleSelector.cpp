@@ -101,6 +101,11 @@
 #include <wtf/StdLibExtras.h>
 #include <wtf/Vector.h>
 
+#ifdef ANDROID_INSTRUMENT
+#include <wtf/CurrentTime.h>
+#include <wtf/text/StringBuilder.h>
+#endif
+
 #if USE(PLATFORM_STRATEGIES)
 #include "PlatformStrategies.h"
 #include "VisitedLinkStrategy.h"
@@ -324,7 +329,10 @@ public:
     RuleSet();
     ~RuleSet();
     
-    typedef HashMap<AtomicStringImpl*, Vector<RuleData>*> AtomRuleMap;
+    // Most lookups are for ids and classes no rule mentions, which the control
+    // bytes turn away without touching the buckets.
+    typedef HashMap<AtomicStringImpl*, Vector<RuleData>*, PtrHash<AtomicStringImpl*>,
+        ControlByteHashTraits<HashTraits<AtomicStringImpl*> > > AtomRuleMap;
     
     void addRulesFromSheet(CSSStyleSheet*, const MediaQueryEvaluator&, CSSStyleSelector* = 0);
 
@@ -435,6 +443,7 @@ CSSStyleSelector::CSSStyleSelector(Document* document, StyleSheetList* styleShee
     , m_element(0)
     , m_styledElement(0)
     , m_elementLinkState(NotInsideLink)
+    , m_canCacheMatchedProperties(false)
     , m_fontSelector(CSSFontSelector::create(document))
     , m_applyProperty(CSSStyleApplyProperty::sharedCSSStyleApplyProperty())
 {
@@ -532,7 +541,8 @@ CSSStyleSelector::~CSSStyleSelector()
 }
     
 CSSStyleSelector::Features::Features() 
-    : usesFirstLineRules(false)
+    : usesClassAttributeSelectors(false)
+    , usesFirstLineRules(false)
     , usesBeforeAfterRules(false)
     , usesLinkRules(false)
 {
@@ -746,6 +756,86 @@ inline bool CSSStyleSelector::fastRejectSelector(const RuleData& ruleData) const
     return false;
 }
 
+#ifdef ANDROID_INSTRUMENT
+struct SelectorStatistics {
+    SelectorStatistics()
+        : attempts(0)
+        , fastRejects(0)
+        , matches(0)
+        , time(0)
+    {
+    }
+
+    String selectorText;
+    unsigned attempts;
+    unsigned fastRejects;
+    unsigned matches;
+    double time;
+};
+
+// Keyed by selector pointer. Style sheets can go away between reports, so the
+// text is captured on first use and the selector is never dereferenced later.
+typedef HashMap<const CSSSelector*, SelectorStatistics> SelectorStatisticsMap;
+
+static SelectorStatisticsMap& selectorStatistics()
+{
+    DEFINE_STATIC_LOCAL(SelectorStatisticsMap, statistics, ());
+    return statistics;
+}
+
+static void recordSelectorStatistics(const RuleData& ruleData, bool fastRejected, bool matched, double time)
+{
+    pair<SelectorStatisticsMap::iterator, bool> entry = selectorStatistics().add(ruleData.selector(), SelectorStatistics());
+    SelectorStatistics& statistics = entry.first->second;
+    if (entry.second)
+        statistics.selectorText = ruleData.selector()->selectorText();
+    ++statistics.attempts;
+    if (fastRejected)
+        ++statistics.fastRejects;
+    if (matched)
+        ++statistics.matches;
+    statistics.time += time;
+}
+
+static inline bool compareSelectorStatisticsByTime(const SelectorStatistics* a, const SelectorStatistics* b)
+{
+    return a->time > b->time;
+}
+
+String CSSStyleSelector::reportSelectorStatistics()
+{
+    static const unsigned maximumReportedSelectors = 100;
+
+    SelectorStatisticsMap& statistics = selectorStatistics();
+    Vector<const SelectorStatistics*> sorted;
+    sorted.reserveCapacity(statistics.size());
+    SelectorStatisticsMap::const_iterator end = statistics.end();
+    for (SelectorStatisticsMap::const_iterator it = statistics.begin(); it != end; ++it)
+        sorted.append(&it->second);
+    std::sort(sorted.begin(), sorted.end(), compareSelectorStatisticsByTime);
+
+    StringBuilder report;
+    report.append("time (ms)\tattempts\tfast rejects\tmatches\tselector\n");
+    unsigned count = std::min<unsigned>(sorted.size(), maximumReportedSelectors);
+    for (unsigned i = 0; i < count; ++i) {
+        const SelectorStatistics* entry = sorted[i];
+        report.append(String::number(entry->time * 1000));
+        report.append('\t');
+        report.append(String::number(entry->attempts));
+        report.append('\t');
+        report.append(String::number(entry->fastRejects));
+        report.append('\t');
+        report.append(String::number(entry->matches));
+        report.append('\t');
+        report.append(entry->selectorText);
+        report.append('\n');
+    }
+
+    statistics.clear();
+    return report.toString();
+}
+#endif
+
 void CSSStyleSelector::matchRulesForList(const Vector<RuleData>* rules, int& firstRuleIndex, int& lastRuleIndex, bool includeEmptyRules)
 {
     if (!rules)
@@ -757,9 +847,20 @@ void CSSStyleSelector::matchRulesForList(const Vector<RuleData>* rules, int& fir
     unsigned size = rules->size();
     for (unsigned i = 0; i < size; ++i) {
         const RuleData& ruleData = rules->at(i);
+#ifdef ANDROID_INSTRUMENT
+        double startTime = currentTime();
+        if (canUseFastReject && fastRejectSelector(ruleData)) {
+            recordSelectorStatistics(ruleData, true, false, currentTime() - startTime);
+            continue;
+        }
+        bool matched = checkSelector(ruleData);
+        recordSelectorStatistics(ruleData, false, matched, currentTime() - startTime);
+        if (matched) {
+#else
         if (canUseFastReject && fastRejectSelector(ruleData))
             continue;
         if (checkSelector(ruleData)) {
+#endif
             // If the rule has no properties to apply, then ignore it in the non-debug mode.
             CSSStyleRule* rule = ruleData.rule();
             CSSMutableStyleDeclaration* decl = rule->declaration();
@@ -1440,7 +1541,26 @@ PassRefPtr<RenderStyle> CSSStyleSelector::styleForElement(Element* e, RenderStyl
 
     // Reset the value back before applying properties, so that -webkit-link knows what color to use.
     m_checker.m_matchVisitedPseudoClass = matchVisitedPseudoClass;
-    
+
+    // The applied values only depend on the matched declarations and the parent style, unless the element is a
+    // link (visited colors), the document element (it sets document wide state), or has an inline style that
+    // can be mutated in place.
+    int ruleRanges[] = { firstUARule, lastUARule, firstUserRule, lastUserRule, firstAuthorRule, lastAuthorRule };
+    unsigned matchedPropertiesHash = 0;
+    m_canCacheMatchedProperties = !resolveForRootDefault && !matchVisitedPseudoClass && !visitedStyle && !m_matchedDecls.isEmpty()
+        && m_parentStyle != style() && m_parentStyle->insideLink() == NotInsideLink && !e->isLink() && !e->isSVGElement()
+        && e != e->document()->documentElement() && !(m_styledElement && m_styledElement->inlineStyleDecl());
+    if (m_canCacheMatchedProperties) {
+        matchedPropertiesHash = computeMatchedPropertiesHash();
+        if (const MatchedPropertiesCacheItem* cacheItem = findFromMatchedPropertiesCache(matchedPropertiesHash, ruleRanges)) {
+            m_style->inheritFrom(cacheItem->renderStyle.get());
+            m_style->copyNonInheritedFrom(cacheItem->renderStyle.get());
+            // Only styles without UA appearance are cached.
+            m_hasUAAppearance = false;
+            return finishStyleForElement(e, matchVisitedPseudoClass);
+        }
+    }
+
     // Now we have all of the matched rules in the appropriate order.  Walk the rules and apply
     // high-priority properties first, i.e., those properties that other properties depend on.
     // The order is (1) high-priority not important, (2) high-priority important, (3) normal not important
@@ -1480,22 +1600,31 @@ PassRefPtr<RenderStyle> CSSStyleSelector::styleForElement(Element* e, RenderStyl
     // go ahead and update it a second time.
     if (m_fontDirty)
         updateFont();
-    
-    // Clean up our style object's display and text decorations (among other fixups).
-    adjustRenderStyle(style(), m_parentStyle, e);
 
     // Start loading images referenced by this style.
     loadPendingImages();
 
-    // If we have first-letter pseudo style, do not share this style
-    if (m_style->hasPseudoStyle(FIRST_LETTER))
-        m_style->setUnique();
+    // Themed controls need the border and background cached above, which only exist while applying.
+    if (m_canCacheMatchedProperties && !m_hasUAAppearance && !m_style->unique())
+        addToMatchedPropertiesCache(matchedPropertiesHash, ruleRanges, RenderStyle::clone(style()));
 
     if (visitedStyle) {
         // Add the visited style off the main style.
         m_style->addCachedPseudoStyle(visitedStyle.release());
     }
 
+    return finishStyleForElement(e, matchVisitedPseudoClass);
+}
+
+PassRefPtr<RenderStyle> CSSStyleSelector::finishStyleForElement(Element* e, bool matchVisitedPseudoClass)
+{
+    // Clean up our style object's display and text decorations (among other fixups).
+    adjustRenderStyle(style(), m_parentStyle, e);
+
+    // If we have first-letter pseudo style, do not share this style
+    if (m_style->hasPseudoStyle(FIRST_LETTER))
+        m_style->setUnique();
+
     if (!matchVisitedPseudoClass)
         initElement(0); // Clear out for the next resolve.
 
@@ -1503,6 +1632,53 @@ PassRefPtr<RenderStyle> CSSStyleSelector::styleForElement(Element* e, RenderStyl
     return m_style.release();
 }
 
+unsigned CSSStyleSelector::computeMatchedPropertiesHash() const
+{
+    ASSERT(!m_matchedDecls.isEmpty());
+    unsigned hash = StringHasher::hashMemory(m_matchedDecls.data(), m_matchedDecls.size() * sizeof(CSSMutableStyleDeclaration*));
+    // Zero and -1 are the empty and deleted values of the cache. Entries are verified on lookup, so folding them is safe.
+    if (!hash || hash == static_cast<unsigned>(-1))
+        hash = 1;
+    return hash;
+}
+
+const CSSStyleSelector::MatchedPropertiesCacheItem* CSSStyleSelector::findFromMatchedPropertiesCache(unsigned hash, const int ruleRanges[6]) const
+{
+    MatchedPropertiesCache::const_iterator it = m_matchedPropertiesCache.find(hash);
+    if (it == m_matchedPropertiesCache.end())
+        return 0;
+    const MatchedPropertiesCacheItem& cacheItem = it->second;
+    if (cacheItem.parentRenderStyle != m_parentStyle || cacheItem.rootElementStyle != m_rootElementStyle)
+        return 0;
+    if (memcmp(cacheItem.ruleRanges, ruleRanges, sizeof(cacheItem.ruleRanges)))
+        return 0;
+    size_t size = m_matchedDecls.size();
+    if (cacheItem.declarations.size() != size)
+        return 0;
+    for (size_t i = 0; i < size; ++i) {
+        if (cacheItem.declarations[i] != m_matchedDecls[i])
+            return 0;
+    }
+    return &cacheItem;
+}
+
+void CSSStyleSelector::addToMatchedPropertiesCache(unsigned hash, const int ruleRanges[6], PassRefPtr<RenderStyle> renderStyle)
+{
+    // The cache keeps parent styles alive, so start over rather than letting it grow without bound.
+    if (m_matchedPropertiesCache.size() >= maximumMatchedPropertiesCacheSize)
+        m_matchedPropertiesCache.clear();
+
+    MatchedPropertiesCacheItem cacheItem;
+    cacheItem.declarations.reserveInitialCapacity(m_matchedDecls.size());
+    for (size_t i = 0; i < m_matchedDecls.size(); ++i)
+        cacheItem.declarations.uncheckedAppend(m_matchedDecls[i]);
+    memcpy(cacheItem.ruleRanges, ruleRanges, sizeof(cacheItem.ruleRanges));
+    cacheItem.renderStyle = renderStyle;
+    cacheItem.parentRenderStyle = m_parentStyle;
+    cacheItem.rootElementStyle = m_rootElementStyle;
+    m_matchedPropertiesCache.set(hash, cacheItem);
+}
+
 PassRefPtr<RenderStyle> CSSStyleSelector::styleForKeyframe(const RenderStyle* elementStyle, const WebKitCSSKeyframeRule* keyframeRule, KeyframeValue& keyframe)
 {
     if (keyframeRule->style())
@@ -2076,11 +2252,27 @@ static inline bool selectorTagMatches(const Element* element, const CSSSelector*
 
 static inline bool isFastCheckableSelector(const CSSSelector* selector)
 {
+    // Attribute checks on the element being styled have side effects (they mark the style as affected by
+    // attribute selectors), so they are only handled here once we have moved up to an ancestor.
+    bool inTopCompoundSelector = true;
     for (; selector; selector = selector->tagHistory()) {
         if (selector->relation() != CSSSelector::Descendant && selector->relation() != CSSSelector::Child && selector->relation() != CSSSelector::SubSelector)
             return false;
-        if (selector->m_match != CSSSelector::None && selector->m_match != CSSSelector::Id && selector->m_match != CSSSelector::Class)
+        switch (selector->m_match) {
+        case CSSSelector::None:
+        case CSSSelector::Id:
+        case CSSSelector::Class:
+            break;
+        case CSSSelector::Set:
+        case CSSSelector::Exact:
+            if (inTopCompoundSelector)
+                return false;
+            break;
+        default:
             return false;
+        }
+        if (selector->relation() != CSSSelector::SubSelector)
+            inTopCompoundSelector = false;
     }
     return true;
 }
@@ -2090,7 +2282,7 @@ inline bool fastCheckSingleSelector(const CSSSelector*& selector, const Element*
 {
     AtomicStringImpl* value = selector->value().impl();
     for (; element; element = element->parentElement()) {
-        if (ValueChecker::checkValue(element, value) && selectorTagMatches(element, selector)) {
+        if (ValueChecker::checkValue(element, selector, value) && selectorTagMatches(element, selector)) {
             if (selector->relation() == CSSSelector::Descendant)
                 topChildOrSubselector = 0;
             else if (!topChildOrSubselector) {
@@ -2120,24 +2312,44 @@ inline bool fastCheckSingleSelector(const CSSSelector*& selector, const Element*
     return false;
 }
 
+static bool htmlAttributeHasCaseInsensitiveValue(const QualifiedName& attr);
+
 struct ClassCheck {
-    static bool checkValue(const Element* element, AtomicStringImpl* value) 
+    static bool checkValue(const Element* element, const CSSSelector*, AtomicStringImpl* value) 
     {
         return element->hasClass() && static_cast<const StyledElement*>(element)->classNames().contains(value);
     }
 };
 struct IdCheck {
-    static bool checkValue(const Element* element, AtomicStringImpl* value) 
+    static bool checkValue(const Element* element, const CSSSelector*, AtomicStringImpl* value) 
     {
         return element->hasID() && element->idForStyleResolution().impl() == value;
     }
 };
 struct TagCheck {
-    static bool checkValue(const Element*, AtomicStringImpl*)
+    static bool checkValue(const Element*, const CSSSelector*, AtomicStringImpl*)
     {
         return true;
     }
 };
+struct AttributeSetCheck {
+    static bool checkValue(const Element* element, const CSSSelector* selector, AtomicStringImpl*)
+    {
+        return !element->getAttribute(selector->attribute()).isNull();
+    }
+};
+struct AttributeExactCheck {
+    static bool checkValue(const Element* element, const CSSSelector* selector, AtomicStringImpl*)
+    {
+        const QualifiedName& attr = selector->attribute();
+        const AtomicString& value = element->getAttribute(attr);
+        if (value.isNull())
+            return false;
+        if (element->document()->isHTMLDocument() && htmlAttributeHasCaseInsensitiveValue(attr))
+            return equalIgnoringCase(selector->value(), value);
+        return selector->value() == value;
+    }
+};
 
 bool CSSStyleSelector::SelectorChecker::fastCheckSelector(const CSSSelector* selector, const Element* element)
 {
@@ -2157,7 +2369,8 @@ bool CSSStyleSelector::SelectorChecker::fastCheckSelector(const CSSSelector* sel
 
     selector = selector->tagHistory();
 
-    // We know this compound selector has descendant, child and subselector combinators only and all components are simple.
+    // We know this compound selector has descendant, child and subselector combinators only and all components are simple
+    // (tag, id, class, or on ancestors an attribute presence or exact value check).
     while (selector) {
         switch (selector->m_match) {
         case CSSSelector::Class:
@@ -2172,6 +2385,14 @@ bool CSSStyleSelector::SelectorChecker::fastCheckSelector(const CSSSelector* sel
             if (!fastCheckSingleSelector<TagCheck>(selector, element, topChildOrSubselector, topChildOrSubselectorMatchElement))
                 return false;
             break;
+        case CSSSelector::Set:
+            if (!fastCheckSingleSelector<AttributeSetCheck>(selector, element, topChildOrSubselector, topChildOrSubselectorMatchElement))
+                return false;
+            break;
+        case CSSSelector::Exact:
+            if (!fastCheckSingleSelector<AttributeExactCheck>(selector, element, topChildOrSubselector, topChildOrSubselectorMatchElement))
+                return false;
+            break;
         default:
             ASSERT_NOT_REACHED();
         }
@@ -3221,6 +3442,10 @@ static inline void collectFeaturesFromSelector(CSSStyleSelector::Features& featu
 {
     if (selector->m_match == CSSSelector::Id && !selector->value().isEmpty())
         features.idsInRules.add(selector->value().impl());
+    else if (selector->m_match == CSSSelector::Class && !selector->value().isEmpty())
+        features.classesInRules.add(selector->value().impl());
+    else if (selector->hasAttribute() && selector->m_match != CSSSelector::Class && selector->attribute().localName() == classAttr.localName())
+        features.usesClassAttributeSelectors = true;
     switch (selector->pseudoType()) {
     case CSSSelector::PseudoFirstLine:
         features.usesFirstLineRules = true;
@@ -7141,6 +7366,11 @@ bool CSSStyleSelector::hasSelectorForAttribute(const AtomicString &attrname) con
     return m_selectorAttrs.contains(attrname.impl());
 }
 
+bool CSSStyleSelector::hasSelectorForClass(const AtomicString& className) const
+{
+    return m_features.usesClassAttributeSelectors || m_features.classesInRules.contains(className.impl());
+}
+
 void CSSStyleSelector::addViewportDependentMediaQueryResult(const MediaQueryExp* expr, bool result)
 {
     m_viewportDependentMediaQueryResults.append(new MediaQueryResult(*expr, result));
@@ -7177,6 +7407,27 @@ void CSSStyleSelector::SelectorChecker::visitedStateChanged(LinkHash visitedHash
     }
 }
 
+void CSSStyleSelector::SelectorChecker::visitedStateChanged(const HashSet<LinkHash, LinkHashHash>& visitedHashes)
+{
+    bool anyLinkChecked = false;
+    HashSet<LinkHash, LinkHashHash>::const_iterator end = visitedHashes.end();
+    for (HashSet<LinkHash, LinkHashHash>::const_iterator it = visitedHashes.begin(); it != end; ++it) {
+        if (m_linksCheckedForVisitedState.contains(*it)) {
+            anyLinkChecked = true;
+            break;
+        }
+    }
+    if (!anyLinkChecked)
+        return;
+
+    // Hash each link once, whatever the number of links that changed.
+    for (Node* node = m_document; node; node = node->traverseNextNode()) {
+        const AtomicString* attr = linkAttribute(node);
+        if (attr && visitedHashes.contains(visitedLinkHash(m_document->baseURL(), *attr)))
+            node->setNeedsStyleRecalc();
+    }
+}
+
 static TransformOperation::OperationType getTransformOperationType(WebKitCSSTransformValue::TransformOperationType type)
 {
     switch (type) {
@@ -165,6 +165,8 @@ public:
         Color getColorFromPrimitiveValue(CSSPrimitiveValue*) const;
 
         bool hasSelectorForAttribute(const AtomicString&) const;
+        // Whether a rule could match differently when an element gains or loses this class.
+        bool hasSelectorForClass(const AtomicString&) const;
  
         CSSFontSelector* fontSelector() const { return m_fontSelector.get(); }
 
@@ -174,6 +176,7 @@ public:
 
         void allVisitedStateChanged() { m_checker.allVisitedStateChanged(); }
         void visitedStateChanged(LinkHash visitedHash) { m_checker.visitedStateChanged(visitedHash); }
+        void visitedStateChanged(const HashSet<LinkHash, LinkHashHash>& visitedHashes) { m_checker.visitedStateChanged(visitedHashes); }
 
         void addKeyframeStyle(PassRefPtr<WebKitCSSKeyframesRule> rule);
         void addPageStyle(PassRefPtr<CSSPageRule>);
@@ -185,11 +188,19 @@ public:
 
         static bool createTransformOperations(CSSValue* inValue, RenderStyle* inStyle, RenderStyle* rootStyle, TransformOperations& outOperations);
 
+#ifdef ANDROID_INSTRUMENT
+        // Per-selector match attempts, fast rejects, matches and time, accumulated
+        // across all style selectors since the last report. Reporting resets the counts.
+        static String reportSelectorStatistics();
+#endif
+
         struct Features {
             Features();
             ~Features();
             HashSet<AtomicStringImpl*> idsInRules;
+            HashSet<AtomicStringImpl*> classesInRules;
             OwnPtr<RuleSet> siblingRules;
+            bool usesClassAttributeSelectors;
             bool usesFirstLineRules;
             bool usesBeforeAfterRules;
             bool usesLinkRules;
@@ -268,6 +279,7 @@ public:
             EInsideLink determineLinkStateSlowCase(Element* element) const;
             void allVisitedStateChanged();
             void visitedStateChanged(LinkHash visitedHash);
+            void visitedStateChanged(const HashSet<LinkHash, LinkHashHash>& visitedHashes);
 
             Document* m_document;
             bool m_strictParsing;
@@ -286,6 +298,23 @@ public:
         void updateFont();
         void cacheBorderAndBackground();
 
+        // Elements that match exactly the same declarations under the same parent style compute the same
+        // property values, so the result of applying them is cached and copied instead of reapplied.
+        struct MatchedPropertiesCacheItem {
+            Vector<RefPtr<CSSMutableStyleDeclaration> > declarations;
+            int ruleRanges[6];
+            RefPtr<RenderStyle> renderStyle;
+            RefPtr<RenderStyle> parentRenderStyle;
+            RefPtr<RenderStyle> rootElementStyle;
+        };
+        typedef HashMap<unsigned, MatchedPropertiesCacheItem> MatchedPropertiesCache;
+        static const unsigned maximumMatchedPropertiesCacheSize = 1024;
+
+        PassRefPtr<RenderStyle> finishStyleForElement(Element*, bool matchVisitedPseudoClass);
+        unsigned computeMatchedPropertiesHash() const;
+        const MatchedPropertiesCacheItem* findFromMatchedPropertiesCache(unsigned hash, const int ruleRanges[6]) const;
+        void addToMatchedPropertiesCache(unsigned hash, const int ruleRanges[6], PassRefPtr<RenderStyle>);
+
         void mapFillAttachment(CSSPropertyID, FillLayer*, CSSValue*);
         void mapFillClip(CSSPropertyID, FillLayer*, CSSValue*);
         void mapFillComposite(CSSPropertyID, FillLayer*, CSSValue*);
@@ -354,6 +383,9 @@ public:
         CSSValue* m_lineHeightValue;
         bool m_fontDirty;
         bool m_matchAuthorAndUserStyles;
+        bool m_canCacheMatchedProperties;
+
+        MatchedPropertiesCache m_matchedPropertiesCache;
         
         RefPtr<CSSFontSelector> m_fontSelector;
         HashSet<AtomicStringImpl*> m_selectorAttrs;
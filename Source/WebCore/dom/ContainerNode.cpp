@@ -792,7 +792,8 @@ void ContainerNode::childrenChanged(bool changedByParser, Node* beforeChange, No
     Node::childrenChanged(changedByParser, beforeChange, afterChange, childCountDelta);
     if (!changedByParser && childCountDelta)
         document()->nodeChildrenChanged(this);
-    if (document()->hasNodeListCaches())
+    // A zero delta means a child's text changed, which no node list depends on.
+    if (childCountDelta && document()->hasNodeListCaches())
         notifyNodeListsChildrenChanged();
 }
 
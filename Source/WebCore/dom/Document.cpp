@@ -36,6 +36,7 @@
 #include "Attribute.h"
 #include "CDATASection.h"
 #include "CSSPrimitiveValueCache.h"
+#include "CSSSelectorList.h"
 #include "CSSStyleSelector.h"
 #include "CSSStyleSheet.h"
 #include "CSSValueKeywords.h"
@@ -202,6 +203,10 @@
 #include "TimeCounter.h"
 #endif
 
+#if PLATFORM(ANDROID)
+#include "TraceEventAndroid.h"
+#endif
+
 #if ENABLE(TOUCH_EVENTS)
 #if USE(V8)
 #include "RuntimeEnabledFeatures.h"
@@ -404,6 +409,7 @@ Document::Document(Frame* frame, const KURL& url, bool isXHTML, bool isHTML)
     , m_compatibilityMode(NoQuirksMode)
     , m_compatibilityModeLocked(false)
     , m_domTreeVersion(++s_globalTreeVersion)
+    , m_domStructureVersion(m_domTreeVersion)
 #ifdef ANDROID_STYLE_VERSION
     , m_styleVersion(0)
 #endif
@@ -494,6 +500,7 @@ Document::Document(Frame* frame, const KURL& url, bool isXHTML, bool isHTML)
 
     m_textColor = Color::black;
     m_listenerTypes = 0;
+    memset(m_mutationListenerCounts, 0, sizeof(m_mutationListenerCounts));
     setInDocument();
     m_inStyleRecalc = false;
     m_closeAfterStyleRecalc = false;
@@ -564,6 +571,8 @@ Document::~Document()
 
     m_decoder = 0;
 
+    deleteAllValues(m_querySelectorListCache);
+
     for (size_t i = 0; i < m_nameCollectionInfo.size(); ++i)
         deleteAllValues(m_nameCollectionInfo[i]);
 
@@ -664,6 +673,8 @@ void Document::setCompatibilityMode(CompatibilityMode mode)
         // All user stylesheets have to reparse using the different mode.
         clearPageUserSheet();
         clearPageGroupUserSheets();
+        deleteAllValues(m_querySelectorListCache);
+        m_querySelectorListCache.clear();
     }
 }
 
@@ -1471,6 +1482,9 @@ void Document::recalcStyle(StyleChange change)
     if (m_inStyleRecalc)
         return; // Guard against re-entrancy. -dwh
     
+#if PLATFORM(ANDROID)
+    ANDROID_TRACE_EVENT("webcore", "Document::recalcStyle");
+#endif
     if (m_hasDirtyStyleSelector)
         recalcStyleSelector();
 
@@ -1702,6 +1716,48 @@ PassRefPtr<CSSPrimitiveValueCache> Document::cssPrimitiveValueCache() const
     return m_cssPrimitiveValueCache;
 }
 
+CSSMutableStyleDeclaration* Document::cachedInlineStyleDeclaration(const String& styleText, bool strictParsing) const
+{
+    if (styleText.isNull())
+        return 0;
+    CSSMutableStyleDeclaration* declaration = m_inlineStyleDeclarationCache.get(styleText).get();
+    if (!declaration || declaration->useStrictParsing() != strictParsing)
+        return 0;
+    return declaration;
+}
+
+void Document::addInlineStyleDeclarationToCache(const String& styleText, const CSSMutableStyleDeclaration* declaration)
+{
+    if (styleText.isNull())
+        return;
+
+    // Just wipe out the cache and start rebuilding if it gets too big.
+    const unsigned maximumInlineStyleDeclarationCacheSize = 512;
+    if (m_inlineStyleDeclarationCache.size() >= maximumInlineStyleDeclarationCacheSize)
+        m_inlineStyleDeclarationCache.clear();
+
+    // The cached copy has no node or parent, so CSSOM writes to the element's own
+    // declaration never reach it. The values themselves are immutable and shared.
+    RefPtr<CSSMutableStyleDeclaration> copy = CSSMutableStyleDeclaration::create();
+    *copy = *declaration;
+    m_inlineStyleDeclarationCache.set(styleText, copy.release());
+}
+
+const CSSSelectorList* Document::addQuerySelectorListToCache(const String& selectors, PassOwnPtr<CSSSelectorList> selectorList)
+{
+    const unsigned maximumQuerySelectorListCacheSize = 256;
+    if (m_querySelectorListCache.size() >= maximumQuerySelectorListCacheSize) {
+        deleteAllValues(m_querySelectorListCache);
+        m_querySelectorListCache.clear();
+    }
+
+    CSSSelectorList* list = selectorList.leakPtr();
+    pair<QuerySelectorListCache::iterator, bool> result = m_querySelectorListCache.add(selectors, list);
+    if (!result.second)
+        delete list;
+    return result.first->second;
+}
+
 void Document::createStyleSelector()
 {
     bool matchAuthorAndUserStyles = true;
@@ -3643,23 +3699,37 @@ PassRefPtr<Event> Document::createEvent(const String& eventType, ExceptionCode&
     return 0;
 }
 
-void Document::addListenerTypeIfNeeded(const AtomicString& eventType)
+// The mutation listener types are the low bits of ListenerType, so the index
+// of a type's counter is its bit position.
+static int mutationListenerTypeIndex(const AtomicString& eventType)
 {
     if (eventType == eventNames().DOMSubtreeModifiedEvent)
-        addListenerType(DOMSUBTREEMODIFIED_LISTENER);
-    else if (eventType == eventNames().DOMNodeInsertedEvent)
-        addListenerType(DOMNODEINSERTED_LISTENER);
-    else if (eventType == eventNames().DOMNodeRemovedEvent)
-        addListenerType(DOMNODEREMOVED_LISTENER);
-    else if (eventType == eventNames().DOMNodeRemovedFromDocumentEvent)
-        addListenerType(DOMNODEREMOVEDFROMDOCUMENT_LISTENER);
-    else if (eventType == eventNames().DOMNodeInsertedIntoDocumentEvent)
-        addListenerType(DOMNODEINSERTEDINTODOCUMENT_LISTENER);
-    else if (eventType == eventNames().DOMAttrModifiedEvent)
-        addListenerType(DOMATTRMODIFIED_LISTENER);
-    else if (eventType == eventNames().DOMCharacterDataModifiedEvent)
-        addListenerType(DOMCHARACTERDATAMODIFIED_LISTENER);
-    else if (eventType == eventNames().overflowchangedEvent)
+        return 0;
+    if (eventType == eventNames().DOMNodeInsertedEvent)
+        return 1;
+    if (eventType == eventNames().DOMNodeRemovedEvent)
+        return 2;
+    if (eventType == eventNames().DOMNodeRemovedFromDocumentEvent)
+        return 3;
+    if (eventType == eventNames().DOMNodeInsertedIntoDocumentEvent)
+        return 4;
+    if (eventType == eventNames().DOMAttrModifiedEvent)
+        return 5;
+    if (eventType == eventNames().DOMCharacterDataModifiedEvent)
+        return 6;
+    return -1;
+}
+
+void Document::addListenerTypeIfNeeded(const AtomicString& eventType)
+{
+    int mutationIndex = mutationListenerTypeIndex(eventType);
+    if (mutationIndex >= 0) {
+        ++m_mutationListenerCounts[mutationIndex];
+        addListenerType(static_cast<ListenerType>(1 << mutationIndex));
+        return;
+    }
+
+    if (eventType == eventNames().overflowchangedEvent)
         addListenerType(OVERFLOWCHANGED_LISTENER);
     else if (eventType == eventNames().webkitAnimationStartEvent)
         addListenerType(ANIMATIONSTART_LISTENER);
@@ -3685,6 +3755,15 @@ void Document::addListenerTypeIfNeeded(const AtomicString& eventType)
 #endif
 }
 
+void Document::removeListenerTypeIfNeeded(const AtomicString& eventType)
+{
+    int mutationIndex = mutationListenerTypeIndex(eventType);
+    if (mutationIndex < 0 || !m_mutationListenerCounts[mutationIndex])
+        return;
+    if (!--m_mutationListenerCounts[mutationIndex])
+        m_listenerTypes &= ~(1 << mutationIndex);
+}
+
 CSSStyleDeclaration* Document::getOverrideStyle(Element*, const String&)
 {
     return 0;
@@ -4839,6 +4918,18 @@ MediaCanStartListener* Document::takeAnyMediaCanStartListener()
     return listener;
 }
 
+void Document::addDeferredFrameElement(HTMLFrameElementBase* element)
+{
+    ASSERT(!m_deferredFrameElements.contains(element));
+    m_deferredFrameElements.add(element);
+}
+
+void Document::removeDeferredFrameElement(HTMLFrameElementBase* element)
+{
+    ASSERT(m_deferredFrameElements.contains(element));
+    m_deferredFrameElements.remove(element);
+}
+
 #if ENABLE(XHTMLMP)
 bool Document::isXHTMLMPDocument() const
 {
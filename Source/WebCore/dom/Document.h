@@ -51,7 +51,9 @@ namespace WebCore {
 class AXObjectCache;
 class Attr;
 class CDATASection;
+class CSSMutableStyleDeclaration;
 class CSSPrimitiveValueCache;
+class CSSSelectorList;
 class CSSStyleDeclaration;
 class CSSStyleSelector;
 class CSSStyleSheet;
@@ -87,6 +89,7 @@ class HTMLAllCollection;
 class HTMLDocument;
 class HTMLElement;
 class HTMLFormElement;
+class HTMLFrameElementBase;
 class HTMLFrameOwnerElement;
 class HTMLHeadElement;
 class HTMLInputElement;
@@ -426,6 +429,14 @@ public:
     virtual bool isFrameSet() const { return false; }
     
     PassRefPtr<CSSPrimitiveValueCache> cssPrimitiveValueCache() const;
+
+    // Parsed style attributes, shared between elements whose attribute text is identical.
+    CSSMutableStyleDeclaration* cachedInlineStyleDeclaration(const String& styleText, bool strictParsing) const;
+    void addInlineStyleDeclarationToCache(const String& styleText, const CSSMutableStyleDeclaration*);
+
+    // Parsed querySelector() arguments. Only valid selector lists are cached.
+    const CSSSelectorList* cachedQuerySelectorList(const String& selectors) const { return m_querySelectorListCache.get(selectors); }
+    const CSSSelectorList* addQuerySelectorListToCache(const String& selectors, PassOwnPtr<CSSSelectorList>);
     
     CSSStyleSelector* styleSelectorIfExists() const { return m_styleSelector.get(); }
 
@@ -750,6 +761,9 @@ public:
     bool hasListenerType(ListenerType listenerType) const { return (m_listenerTypes & listenerType); }
     void addListenerType(ListenerType listenerType) { m_listenerTypes = m_listenerTypes | listenerType; }
     void addListenerTypeIfNeeded(const AtomicString& eventType);
+    // Mutation event listeners are counted, so their types clear again once the
+    // last one is removed and DOM changes stop paying for mutation events.
+    void removeListenerTypeIfNeeded(const AtomicString& eventType);
 
     CSSStyleDeclaration* getOverrideStyle(Element*, const String& pseudoElt);
 
@@ -901,9 +915,14 @@ public:
     TransformSource* transformSource() const { return m_transformSource.get(); }
 #endif
 
-    void incDOMTreeVersion() { m_domTreeVersion = ++s_globalTreeVersion; }
+    void incDOMTreeVersion() { m_domTreeVersion = m_domStructureVersion = ++s_globalTreeVersion; }
     uint64_t domTreeVersion() const { return m_domTreeVersion; }
 
+    // Text changes bump domTreeVersion() but not domStructureVersion(), so
+    // caches that only depend on elements and attributes survive them.
+    void incDOMTreeVersionForCharacterDataChange() { m_domTreeVersion = ++s_globalTreeVersion; }
+    uint64_t domStructureVersion() const { return m_domStructureVersion; }
+
 #ifdef ANDROID_STYLE_VERSION
     void incStyleVersion() { ++m_styleVersion; }
     unsigned styleVersion() const { return m_styleVersion; }
@@ -1062,6 +1081,13 @@ public:
     void removeMediaCanStartListener(MediaCanStartListener*);
     MediaCanStartListener* takeAnyMediaCanStartListener();
 
+    // Frame elements whose load has been postponed until they scroll near the
+    // viewport. See Settings::deferOffscreenFrameLoads().
+    void addDeferredFrameElement(HTMLFrameElementBase*);
+    void removeDeferredFrameElement(HTMLFrameElementBase*);
+    const HashSet<HTMLFrameElementBase*>& deferredFrameElements() const { return m_deferredFrameElements; }
+    bool hasDeferredFrameElements() const { return !m_deferredFrameElements.isEmpty(); }
+
     const QualifiedName& idAttributeName() const { return m_idAttributeName; }
     
 #if ENABLE(FULLSCREEN_API)
@@ -1164,6 +1190,10 @@ private:
     bool m_hasDirtyStyleSelector;
     
     mutable RefPtr<CSSPrimitiveValueCache> m_cssPrimitiveValueCache;
+    typedef HashMap<String, RefPtr<CSSMutableStyleDeclaration> > InlineStyleDeclarationCache;
+    InlineStyleDeclarationCache m_inlineStyleDeclarationCache;
+    typedef HashMap<String, CSSSelectorList*> QuerySelectorListCache;
+    QuerySelectorListCache m_querySelectorListCache;
 
     Frame* m_frame;
     OwnPtr<CachedResourceLoader> m_cachedResourceLoader;
@@ -1228,6 +1258,7 @@ private:
     mutable RefPtr<Element> m_documentElement;
 
     uint64_t m_domTreeVersion;
+    uint64_t m_domStructureVersion;
     static uint64_t s_globalTreeVersion;
 #ifdef ANDROID_STYLE_VERSION
     unsigned m_styleVersion;
@@ -1237,6 +1268,8 @@ private:
     HashSet<Range*> m_ranges;
 
     unsigned short m_listenerTypes;
+    static const unsigned numberOfMutationListenerTypes = 7;
+    unsigned m_mutationListenerCounts[numberOfMutationListenerTypes];
 
     RefPtr<StyleSheetList> m_styleSheets; // All of the stylesheets that are currently in effect for our media type and stylesheet set.
     
@@ -1390,6 +1423,7 @@ private:
     RefPtr<DocumentWeakReference> m_weakReference;
 
     HashSet<MediaCanStartListener*> m_mediaCanStartListeners;
+    HashSet<HTMLFrameElementBase*> m_deferredFrameElements;
 
     QualifiedName m_idAttributeName;
     
@@ -25,12 +25,16 @@
 
 #include "Document.h"
 #include "HTMLDocumentParser.h"
+#include "HTMLNames.h"
 #include "Page.h"
 #include "Settings.h"
+#include "Text.h"
 #include "XMLDocumentParser.h"
 
 namespace WebCore {
 
+using namespace HTMLNames;
+
 DocumentFragment::DocumentFragment(Document* document)
     : ContainerNode(document)
 {
@@ -75,8 +79,41 @@ PassRefPtr<Node> DocumentFragment::cloneNode(bool deep)
     return clone.release();
 }
 
+// Scripts often set innerHTML to plain text. In an ordinary HTML context such markup
+// always parses to at most one text node, so there is no need to set up a tokenizer
+// and tree builder for it. Contexts whose insertion modes treat text specially
+// (tables, head, frameset and foreign content) go through the full parser.
+static bool isPlainTextForFragmentContext(const String& source, Element* contextElement)
+{
+    if (!contextElement || !contextElement->isHTMLElement())
+        return false;
+    if (contextElement->hasTagName(htmlTag) || contextElement->hasTagName(headTag) || contextElement->hasTagName(framesetTag)
+        || contextElement->hasTagName(tableTag) || contextElement->hasTagName(tbodyTag) || contextElement->hasTagName(theadTag)
+        || contextElement->hasTagName(tfootTag) || contextElement->hasTagName(trTag) || contextElement->hasTagName(colgroupTag))
+        return false;
+
+    unsigned length = source.length();
+    if (length > Text::defaultLengthLimit)
+        return false;
+    const UChar* characters = source.characters();
+    // A leading newline is dropped in some contexts, like <pre> and <textarea>.
+    if (length && characters[0] == '\n')
+        return false;
+    for (unsigned i = 0; i < length; ++i) {
+        UChar c = characters[i];
+        if (c == '<' || c == '&' || c == '\r' || !c)
+            return false;
+    }
+    return true;
+}
+
 void DocumentFragment::parseHTML(const String& source, Element* contextElement, FragmentScriptingPermission scriptingPermission)
 {
+    if (isPlainTextForFragmentContext(source, contextElement)) {
+        if (!source.isEmpty())
+            parserAddChild(Text::create(document(), source));
+        return;
+    }
     HTMLDocumentParser::parseDocumentFragment(source, this, contextElement, scriptingPermission);
 }
 
@@ -1091,17 +1091,33 @@ void Element::recalcStyle(StyleChange change)
     bool hasParentStyle = parentNodeForRenderingAndStyle() ? parentNodeForRenderingAndStyle()->renderStyle() : false;
     bool hasDirectAdjacentRules = currentStyle && currentStyle->childrenAffectedByDirectAdjacentRules();
 
+    bool willResolveStyle = hasParentStyle && (change >= Inherit || needsStyleRecalc());
+#ifdef ANDROID_STYLE_VERSION
+    // With no stylesheets pending, the style resolved below is the one we would get by ignoring
+    // pending stylesheets, so check it for display changes instead of resolving the style twice.
+    bool checkDisplayDiffOfResolvedStyle = false;
+#endif
     if ((change > NoChange || needsStyleRecalc())) {
 #ifdef ANDROID_STYLE_VERSION
-        RefPtr<RenderStyle> newStyle = document()->styleForElementIgnoringPendingStylesheets(this);
-        if (displayDiff(currentStyle.get(), newStyle.get()))
-            document()->incStyleVersion();
+        // Without a parent style this element sits in a subtree that is not rendered, so its display
+        // cannot change what is on screen. Leave its style to computedStyle() if anything asks for it.
+        if (willResolveStyle && document()->haveStylesheetsLoaded())
+            checkDisplayDiffOfResolvedStyle = true;
+        else if (hasParentStyle) {
+            RefPtr<RenderStyle> newStyle = document()->styleForElementIgnoringPendingStylesheets(this);
+            if (displayDiff(currentStyle.get(), newStyle.get()))
+                document()->incStyleVersion();
+        }
 #endif
         if (hasRareData())
             rareData()->resetComputedStyle();
     }
-    if (hasParentStyle && (change >= Inherit || needsStyleRecalc())) {
+    if (willResolveStyle) {
         RefPtr<RenderStyle> newStyle = document()->styleSelector()->styleForElement(this);
+#ifdef ANDROID_STYLE_VERSION
+        if (checkDisplayDiffOfResolvedStyle && displayDiff(currentStyle.get(), newStyle.get()))
+            document()->incStyleVersion();
+#endif
         StyleChange ch = diff(currentStyle.get(), newStyle.get());
         if (ch == Detach || !currentStyle) {
             if (attached())
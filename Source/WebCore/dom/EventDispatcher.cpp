@@ -47,6 +47,10 @@
 
 #include <wtf/RefPtr.h>
 
+#ifdef ANDROID_INSTRUMENT
+#include "TimeCounter.h"
+#endif
+
 namespace WebCore {
 
 static HashSet<Node*>* gNodesDispatchingSimulatedClicks = 0;
@@ -278,6 +282,13 @@ void EventDispatcher::ensureEventAncestors(Event* event)
 
 bool EventDispatcher::dispatchEvent(PassRefPtr<Event> event)
 {
+#ifdef ANDROID_INSTRUMENT
+    // Events dispatched from inside a handler are counted as part of the outer event.
+    static unsigned dispatchDepth = 0;
+    if (!dispatchDepth++)
+        android::TimeCounter::start(android::TimeCounter::EventDispatchTimeCounter);
+#endif
+
     event->setTarget(eventTargetRespectingSVGTargetRules(m_node.get()));
 
     ASSERT(!eventDispatchForbidden());
@@ -366,6 +377,11 @@ doneWithDefault:
     event->setCurrentTarget(0);
     InspectorInstrumentation::didDispatchEvent(cookie);
 
+#ifdef ANDROID_INSTRUMENT
+    if (!--dispatchDepth)
+        android::TimeCounter::record(android::TimeCounter::EventDispatchTimeCounter, __FUNCTION__);
+#endif
+
     return !event->defaultPrevented();
 }
 
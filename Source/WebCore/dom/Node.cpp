@@ -459,6 +459,17 @@ void Node::setDocument(Document* document)
         document->addNodeListCache();
     }
 
+    if (EventTargetData* data = eventTargetData()) {
+        EventListenerMap::iterator end = data->eventListenerMap.end();
+        for (EventListenerMap::iterator it = data->eventListenerMap.begin(); it != end; ++it) {
+            for (size_t i = 0; i < it->second->size(); ++i) {
+                if (m_document)
+                    m_document->removeListenerTypeIfNeeded(it->first);
+                document->addListenerTypeIfNeeded(it->first);
+            }
+        }
+    }
+
     if (m_document) {
         m_document->moveNodeIteratorsToNewDocument(this, document);
         m_document->guardDeref();
@@ -1760,77 +1771,49 @@ PassRefPtr<NodeList> Node::getElementsByClassName(const String& classNames)
     return list.release();
 }
 
-PassRefPtr<Element> Node::querySelector(const String& selectors, ExceptionCode& ec)
+static const CSSSelectorList* parseQuerySelectors(Document* document, const String& selectors, ExceptionCode& ec)
 {
     if (selectors.isEmpty()) {
         ec = SYNTAX_ERR;
         return 0;
     }
-    bool strictParsing = !document()->inQuirksMode();
-    CSSParser p(strictParsing);
 
-    CSSSelectorList querySelectorList;
-    p.parseSelector(selectors, document(), querySelectorList);
+    if (const CSSSelectorList* cachedSelectorList = document->cachedQuerySelectorList(selectors))
+        return cachedSelectorList;
 
-    if (!querySelectorList.first() || querySelectorList.hasUnknownPseudoElements()) {
+    CSSParser p(!document->inQuirksMode());
+
+    OwnPtr<CSSSelectorList> querySelectorList = adoptPtr(new CSSSelectorList);
+    p.parseSelector(selectors, document, *querySelectorList);
+
+    if (!querySelectorList->first() || querySelectorList->hasUnknownPseudoElements()) {
         ec = SYNTAX_ERR;
         return 0;
     }
 
-    // throw a NAMESPACE_ERR if the selector includes any namespace prefixes.
-    if (querySelectorList.selectorsNeedNamespaceResolution()) {
+    // Throw a NAMESPACE_ERR if the selector includes any namespace prefixes.
+    if (querySelectorList->selectorsNeedNamespaceResolution()) {
         ec = NAMESPACE_ERR;
         return 0;
     }
 
-    CSSStyleSelector::SelectorChecker selectorChecker(document(), strictParsing);
+    return document->addQuerySelectorListToCache(selectors, querySelectorList.release());
+}
 
-    // FIXME: we could also optimize for the the [id="foo"] case
-    if (strictParsing && inDocument() && querySelectorList.hasOneSelector() && querySelectorList.first()->m_match == CSSSelector::Id) {
-        Element* element = document()->getElementById(querySelectorList.first()->value());
-        if (element && (isDocumentNode() || element->isDescendantOf(this)) && selectorChecker.checkSelector(querySelectorList.first(), element))
-            return element;
+PassRefPtr<Element> Node::querySelector(const String& selectors, ExceptionCode& ec)
+{
+    const CSSSelectorList* querySelectorList = parseQuerySelectors(document(), selectors, ec);
+    if (!querySelectorList)
         return 0;
-    }
-
-    // FIXME: We can speed this up by implementing caching similar to the one use by getElementById
-    for (Node* n = firstChild(); n; n = n->traverseNextNode(this)) {
-        if (n->isElementNode()) {
-            Element* element = static_cast<Element*>(n);
-            for (CSSSelector* selector = querySelectorList.first(); selector; selector = CSSSelectorList::next(selector)) {
-                if (selectorChecker.checkSelector(selector, element))
-                    return element;
-            }
-        }
-    }
-    
-    return 0;
+    return firstSelectorMatch(this, *querySelectorList);
 }
 
 PassRefPtr<NodeList> Node::querySelectorAll(const String& selectors, ExceptionCode& ec)
 {
-    if (selectors.isEmpty()) {
-        ec = SYNTAX_ERR;
-        return 0;
-    }
-    bool strictParsing = !document()->inQuirksMode();
-    CSSParser p(strictParsing);
-
-    CSSSelectorList querySelectorList;
-    p.parseSelector(selectors, document(), querySelectorList);
-
-    if (!querySelectorList.first() || querySelectorList.hasUnknownPseudoElements()) {
-        ec = SYNTAX_ERR;
-        return 0;
-    }
-
-    // Throw a NAMESPACE_ERR if the selector includes any namespace prefixes.
-    if (querySelectorList.selectorsNeedNamespaceResolution()) {
-        ec = NAMESPACE_ERR;
+    const CSSSelectorList* querySelectorList = parseQuerySelectors(document(), selectors, ec);
+    if (!querySelectorList)
         return 0;
-    }
-
-    return createSelectorNodeList(this, querySelectorList);
+    return createSelectorNodeList(this, *querySelectorList);
 }
 
 Document *Node::ownerDocument() const
@@ -2630,8 +2613,8 @@ static inline bool tryRemoveEventListener(Node* targetNode, const AtomicString&
     if (!targetNode->EventTarget::removeEventListener(eventType, listener, useCapture))
         return false;
 
-    // FIXME: Notify Document that the listener has vanished. We need to keep track of a number of
-    // listeners for each type, not just a bool - see https://bugs.webkit.org/show_bug.cgi?id=33861
+    if (Document* document = targetNode->document())
+        document->removeListenerTypeIfNeeded(eventType);
 
     return true;
 }
@@ -2750,9 +2733,12 @@ void Node::dispatchSubtreeModifiedEvent()
 {
     ASSERT(!eventDispatchForbidden());
     
-    document()->incDOMTreeVersion();
-
-    notifyNodeListsAttributeChanged(); // FIXME: Can do better some day. Really only care about the name attribute changing.
+    if (isCharacterDataNode())
+        document()->incDOMTreeVersionForCharacterDataChange();
+    else {
+        document()->incDOMTreeVersion();
+        notifyNodeListsAttributeChanged(); // FIXME: Can do better some day. Really only care about the name attribute changing.
+    }
     
     if (!document()->hasListenerType(Document::DOMSUBTREEMODIFIED_LISTENER))
         return;
@@ -32,6 +32,7 @@
 #include "ScopedEventQueue.h"
 
 #include "Event.h"
+#include "EventNames.h"
 #include "EventTarget.h"
 
 namespace WebCore {
@@ -58,16 +59,23 @@ void ScopedEventQueue::initialize()
 
 void ScopedEventQueue::enqueueEvent(PassRefPtr<Event> event)
 {
-    if (m_scopingLevel)
-        m_queuedEvents.append(event);
-    else
+    if (!m_scopingLevel) {
         dispatchEvent(event);
+        return;
+    }
+
+    // DOMSubtreeModified may stand for several changes, so a target that
+    // already has one queued doesn't need another.
+    if (event->type() == eventNames().DOMSubtreeModifiedEvent && !m_queuedSubtreeModifiedTargets.add(event->target()).second)
+        return;
+    m_queuedEvents.append(event);
 }
 
 void ScopedEventQueue::dispatchAllEvents()
 {
     Vector<RefPtr<Event> > queuedEvents;
     queuedEvents.swap(m_queuedEvents);
+    m_queuedSubtreeModifiedTargets.clear();
 
     for (size_t i = 0; i < queuedEvents.size(); i++)
         dispatchEvent(queuedEvents[i].release());
@@ -31,6 +31,7 @@
 #ifndef ScopedEventQueue_h
 #define ScopedEventQueue_h
 
+#include <wtf/HashSet.h>
 #include <wtf/Noncopyable.h>
 #include <wtf/PassOwnPtr.h>
 #include <wtf/PassRefPtr.h>
@@ -39,6 +40,7 @@
 namespace WebCore {
 
 class Event;
+class EventTarget;
 
 class ScopedEventQueue {
     WTF_MAKE_NONCOPYABLE(ScopedEventQueue);
@@ -59,6 +61,7 @@ private:
     void dispatchEvent(PassRefPtr<Event>) const;
 
     Vector<RefPtr<Event> > m_queuedEvents;
+    HashSet<EventTarget*> m_queuedSubtreeModifiedTargets;
     unsigned m_scopingLevel;
 
     static ScopedEventQueue* s_instance;
@@ -41,34 +41,101 @@ namespace WebCore {
 
 using namespace HTMLNames;
 
-PassRefPtr<StaticNodeList> createSelectorNodeList(Node* rootNode, const CSSSelectorList& querySelectorList)
+static CSSSelector* idSelectorInRightmostCompound(CSSSelector* selector)
+{
+    for (; selector; selector = selector->tagHistory()) {
+        if (selector->m_match == CSSSelector::Id)
+            return selector;
+        if (selector->relation() != CSSSelector::SubSelector)
+            break;
+    }
+    return 0;
+}
+
+// Uses a unique id further left in the selector to narrow the subtree that can
+// contain matches, e.g. "#list li" only needs to look inside #list. Returns 0
+// when nothing can match.
+static Node* traversalRootForSelector(Node* rootNode, CSSSelector* selector)
+{
+    Document* document = rootNode->document();
+    bool inAdjacentChain = false;
+    for (; selector; selector = selector->tagHistory()) {
+        if (selector->m_match == CSSSelector::Id && !document->containsMultipleElementsWithId(selector->value())) {
+            Element* element = document->getElementById(selector->value());
+            if (!element)
+                return 0;
+            if (!rootNode->isDocumentNode() && !element->isDescendantOf(rootNode))
+                return rootNode;
+            return inAdjacentChain ? element->parentNode() : element;
+        }
+        switch (selector->relation()) {
+        case CSSSelector::SubSelector:
+            break;
+        case CSSSelector::Descendant:
+        case CSSSelector::Child:
+            inAdjacentChain = false;
+            break;
+        case CSSSelector::DirectAdjacent:
+        case CSSSelector::IndirectAdjacent:
+            inAdjacentChain = true;
+            break;
+        case CSSSelector::ShadowDescendant:
+            return rootNode;
+        }
+    }
+    return rootNode;
+}
+
+static void collectSelectorMatches(Node* rootNode, const CSSSelectorList& querySelectorList, bool firstMatchOnly, Vector<RefPtr<Node> >& nodes)
 {
-    Vector<RefPtr<Node> > nodes;
     Document* document = rootNode->document();
     CSSSelector* onlySelector = querySelectorList.hasOneSelector() ? querySelectorList.first() : 0;
     bool strictParsing = !document->inQuirksMode();
 
     CSSStyleSelector::SelectorChecker selectorChecker(document, strictParsing);
 
-    if (strictParsing && rootNode->inDocument() && onlySelector && onlySelector->m_match == CSSSelector::Id && !document->containsMultipleElementsWithId(onlySelector->value())) {
-        Element* element = document->getElementById(onlySelector->value());
-        if (element && (rootNode->isDocumentNode() || element->isDescendantOf(rootNode)) && selectorChecker.checkSelector(onlySelector, element))
-            nodes.append(element);
-    } else {
-        for (Node* n = rootNode->firstChild(); n; n = n->traverseNextNode(rootNode)) {
-            if (n->isElementNode()) {
-                Element* element = static_cast<Element*>(n);
-                for (CSSSelector* selector = querySelectorList.first(); selector; selector = CSSSelectorList::next(selector)) {
-                    if (selectorChecker.checkSelector(selector, element)) {
-                        nodes.append(n);
-                        break;
-                    }
+    Node* traversalRoot = rootNode;
+    if (strictParsing && rootNode->inDocument() && onlySelector) {
+        CSSSelector* idSelector = idSelectorInRightmostCompound(onlySelector);
+        if (idSelector && !document->containsMultipleElementsWithId(idSelector->value())) {
+            Element* element = document->getElementById(idSelector->value());
+            if (element && (rootNode->isDocumentNode() || element->isDescendantOf(rootNode)) && selectorChecker.checkSelector(onlySelector, element))
+                nodes.append(element);
+            return;
+        }
+        if (!idSelector)
+            traversalRoot = traversalRootForSelector(rootNode, onlySelector);
+        if (!traversalRoot)
+            return;
+    }
+
+    for (Node* n = traversalRoot->firstChild(); n; n = n->traverseNextNode(traversalRoot)) {
+        if (n->isElementNode()) {
+            Element* element = static_cast<Element*>(n);
+            for (CSSSelector* selector = querySelectorList.first(); selector; selector = CSSSelectorList::next(selector)) {
+                if (selectorChecker.checkSelector(selector, element)) {
+                    nodes.append(n);
+                    if (firstMatchOnly)
+                        return;
+                    break;
                 }
             }
         }
     }
-    
+}
+
+PassRefPtr<StaticNodeList> createSelectorNodeList(Node* rootNode, const CSSSelectorList& querySelectorList)
+{
+    Vector<RefPtr<Node> > nodes;
+    collectSelectorMatches(rootNode, querySelectorList, false, nodes);
     return StaticNodeList::adopt(nodes);
 }
 
+Element* firstSelectorMatch(Node* rootNode, const CSSSelectorList& querySelectorList)
+{
+    Vector<RefPtr<Node> > nodes;
+    collectSelectorMatches(rootNode, querySelectorList, true, nodes);
+    return nodes.isEmpty() ? 0 : static_cast<Element*>(nodes[0].get());
+}
+
 } // namespace WebCore
@@ -34,10 +34,12 @@
 namespace WebCore {
 
     class CSSSelectorList;
+    class Element;
     class Node;
     class StaticNodeList;
 
     PassRefPtr<StaticNodeList> createSelectorNodeList(Node* rootNode, const CSSSelectorList&);
+    Element* firstSelectorMatch(Node* rootNode, const CSSSelectorList&);
 
 } // namespace WebCore
 
@@ -210,6 +210,22 @@ bool StyledElement::mapToEntry(const QualifiedName& attrName, MappedAttributeEnt
     return true;
 }
 
+static bool classChangeAffectsStyle(CSSStyleSelector* styleSelector, const Vector<AtomicString, 8>& oldClasses, const SpaceSplitString* newClasses)
+{
+    // Only classes that were added or removed can change which rules match.
+    size_t newClassCount = newClasses ? newClasses->size() : 0;
+    for (size_t i = 0; i < newClassCount; ++i) {
+        const AtomicString& newClass = (*newClasses)[i];
+        if (oldClasses.find(newClass) == notFound && styleSelector->hasSelectorForClass(newClass))
+            return true;
+    }
+    for (size_t i = 0; i < oldClasses.size(); ++i) {
+        if ((!newClasses || !newClasses->contains(oldClasses[i])) && styleSelector->hasSelectorForClass(oldClasses[i]))
+            return true;
+    }
+    return false;
+}
+
 void StyledElement::classAttributeChanged(const AtomicString& newClassString)
 {
     const UChar* characters = newClassString.characters();
@@ -219,6 +235,16 @@ void StyledElement::classAttributeChanged(const AtomicString& newClassString)
         if (isNotHTMLSpace(characters[i]))
             break;
     }
+
+    // The view source style sheet is not part of the collected rule features, so always recalc there.
+    bool canSkipStyleRecalc = attached() && document()->attached() && !document()->usesViewSourceStyles();
+    Vector<AtomicString, 8> oldClasses;
+    if (canSkipStyleRecalc && this->hasClass()) {
+        const SpaceSplitString& oldClassNames = classNames();
+        for (size_t j = 0; j < oldClassNames.size(); ++j)
+            oldClasses.append(oldClassNames[j]);
+    }
+
     bool hasClass = i < length;
     setHasClass(hasClass);
     if (hasClass) {
@@ -227,7 +253,8 @@ void StyledElement::classAttributeChanged(const AtomicString& newClassString)
             static_cast<ClassList*>(classList)->reset(newClassString);
     } else if (attributeMap())
         attributeMap()->clearClass();
-    setNeedsStyleRecalc();
+    if (!canSkipStyleRecalc || classChangeAffectsStyle(document()->styleSelector(), oldClasses, hasClass ? &classNames() : 0))
+        setNeedsStyleRecalc();
     dispatchSubtreeModifiedEvent();
 }
 
@@ -322,10 +322,12 @@ void MarkupAccumulator::appendElement(Vector<UChar>& out, Element* element, Name
 {
     appendOpenTag(out, element, namespaces);
 
-    NamedNodeMap* attributes = element->attributes();
-    unsigned length = attributes->length();
-    for (unsigned int i = 0; i < length; i++)
-        appendAttribute(out, element, *attributes->attributeItem(i), namespaces);
+    // Don't create an attribute map just to find it empty.
+    if (NamedNodeMap* attributes = element->attributes(true)) {
+        unsigned length = attributes->length();
+        for (unsigned int i = 0; i < length; i++)
+            appendAttribute(out, element, *attributes->attributeItem(i), namespaces);
+    }
 
     appendCloseTag(out, element);
 }
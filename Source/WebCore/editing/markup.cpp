@@ -98,8 +98,8 @@ static void completeURLs(Node* node, const String& baseURL)
     for (Node* n = node; n != end; n = n->traverseNextNode()) {
         if (n->isElementNode()) {
             Element* e = static_cast<Element*>(n);
-            NamedNodeMap* attributes = e->attributes();
-            unsigned length = attributes->length();
+            NamedNodeMap* attributes = e->attributes(true);
+            unsigned length = attributes ? attributes->length() : 0;
             for (unsigned i = 0; i < length; i++) {
                 Attribute* attribute = attributes->attributeItem(i);
                 if (e->isURLAttribute(attribute))
@@ -257,8 +257,8 @@ void StyledMarkupAccumulator::appendElement(Vector<UChar>& out, Element* element
     bool documentIsHTML = element->document()->isHTMLDocument();
     appendOpenTag(out, element, 0);
 
-    NamedNodeMap* attributes = element->attributes();
-    unsigned length = attributes->length();
+    NamedNodeMap* attributes = element->attributes(true);
+    unsigned length = attributes ? attributes->length() : 0;
     for (unsigned int i = 0; i < length; i++) {
         Attribute* attribute = attributes->attributeItem(i);
         // We'll handle the style attribute separately, below.
@@ -749,7 +749,7 @@ static void fillContainerFromString(ContainerNode* paragraph, const String& stri
 
 bool isPlainTextMarkup(Node *node)
 {
-    if (!node->isElementNode() || !node->hasTagName(divTag) || static_cast<Element*>(node)->attributes()->length())
+    if (!node->isElementNode() || !node->hasTagName(divTag) || static_cast<Element*>(node)->hasAttributes())
         return false;
     
     if (node->childNodeCount() == 1 && (node->firstChild()->isTextNode() || (node->firstChild()->firstChild())))
@@ -27,6 +27,7 @@
 #include "CachedPage.h"
 
 #include "CachedFramePlatformData.h"
+#include "CachedResourceLoader.h"
 #include "DocumentLoader.h"
 #include "ExceptionCode.h"
 #include "EventNames.h"
@@ -272,4 +273,33 @@ int CachedFrame::descendantFrameCount() const
     return count;
 }
 
+unsigned CachedFrame::estimatedSize() const
+{
+    unsigned size = 0;
+    if (m_document) {
+        const CachedResourceLoader::DocumentResourceMap& resources = m_document->cachedResourceLoader()->allCachedResources();
+        CachedResourceLoader::DocumentResourceMap::const_iterator end = resources.end();
+        for (CachedResourceLoader::DocumentResourceMap::const_iterator it = resources.begin(); it != end; ++it)
+            size += it->second->size();
+    }
+
+    for (size_t i = 0; i < m_childFrames.size(); ++i)
+        size += m_childFrames[i]->estimatedSize();
+
+    return size;
+}
+
+void CachedFrame::destroyDecodedData()
+{
+    if (m_document) {
+        const CachedResourceLoader::DocumentResourceMap& resources = m_document->cachedResourceLoader()->allCachedResources();
+        CachedResourceLoader::DocumentResourceMap::const_iterator end = resources.end();
+        for (CachedResourceLoader::DocumentResourceMap::const_iterator it = resources.begin(); it != end; ++it)
+            it->second->destroyDecodedData();
+    }
+
+    for (size_t i = 0; i < m_childFrames.size(); ++i)
+        m_childFrames[i]->destroyDecodedData();
+}
+
 } // namespace WebCore
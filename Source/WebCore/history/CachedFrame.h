@@ -87,6 +87,11 @@ public:
 
     int descendantFrameCount() const;
 
+    // Bytes of subresources held by this frame's document and its subframes'.
+    unsigned estimatedSize() const;
+    // Decoded images and scripts are decoded again once the frame is shown.
+    void destroyDecodedData();
+
 private:
     CachedFrame(Frame*);
 };
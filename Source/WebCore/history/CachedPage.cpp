@@ -50,6 +50,7 @@ PassRefPtr<CachedPage> CachedPage::create(Page* page)
 CachedPage::CachedPage(Page* page)
     : m_timeStamp(currentTime())
     , m_cachedMainFrame(CachedFrame::create(page->mainFrame()))
+    , m_estimatedSize(m_cachedMainFrame->estimatedSize())
     , m_needStyleRecalcForVisitedLinks(false)
 {
 #ifndef NDEBUG
@@ -88,6 +89,11 @@ void CachedPage::restore(Page* page)
             if (CSSStyleSelector* styleSelector = frame->document()->styleSelector())
                 styleSelector->allVisitedStateChanged();
         }
+    } else if (!m_visitedLinksChanged.isEmpty()) {
+        for (Frame* frame = page->mainFrame(); frame; frame = frame->tree()->traverseNext()) {
+            if (CSSStyleSelector* styleSelector = frame->document()->styleSelector())
+                styleSelector->visitedStateChanged(m_visitedLinksChanged);
+        }
     }
 
     clear();
@@ -99,6 +105,31 @@ void CachedPage::clear()
     m_cachedMainFrame->clear();
     m_cachedMainFrame = 0;
     m_needStyleRecalcForVisitedLinks = false;
+    m_visitedLinksChanged.clear();
+}
+
+void CachedPage::markForVistedLinkStyleRecalc(LinkHash visitedHash)
+{
+    // Past this many links a single pass over all of them is no slower.
+    static const unsigned maxVisitedLinksChanged = 64;
+
+    if (m_needStyleRecalcForVisitedLinks)
+        return;
+    if (m_visitedLinksChanged.size() >= maxVisitedLinksChanged) {
+        m_visitedLinksChanged.clear();
+        m_needStyleRecalcForVisitedLinks = true;
+        return;
+    }
+    m_visitedLinksChanged.add(visitedHash);
+}
+
+void CachedPage::destroyDecodedData()
+{
+    if (!m_cachedMainFrame)
+        return;
+
+    m_cachedMainFrame->destroyDecodedData();
+    m_estimatedSize = m_cachedMainFrame->estimatedSize();
 }
 
 void CachedPage::destroy()
@@ -27,6 +27,8 @@
 #define CachedPage_h
 
 #include "CachedFrame.h"
+#include "LinkHash.h"
+#include <wtf/HashSet.h>
 
 namespace WebCore {
     
@@ -47,17 +49,27 @@ public:
     DocumentLoader* documentLoader() const { return m_cachedMainFrame->documentLoader(); }
 
     double timeStamp() const { return m_timeStamp; }
+
+    // Attributed size, shared subresources are counted for every page.
+    unsigned estimatedSize() const { return m_estimatedSize; }
+    void destroyDecodedData();
     
     CachedFrame* cachedMainFrame() { return m_cachedMainFrame.get(); }
 
     void markForVistedLinkStyleRecalc() { m_needStyleRecalcForVisitedLinks = true; }
+    void markForVistedLinkStyleRecalc(LinkHash);
 
 private:
     CachedPage(Page*);
 
     double m_timeStamp;
     RefPtr<CachedFrame> m_cachedMainFrame;
+    unsigned m_estimatedSize;
     bool m_needStyleRecalcForVisitedLinks;
+    // Links that became visited while the page was cached. Only these need
+    // their style recomputed on restore, unless there are so many of them
+    // that m_needStyleRecalcForVisitedLinks has been set instead.
+    HashSet<LinkHash, LinkHashHash> m_visitedLinksChanged;
 };
 
 } // namespace WebCore
@@ -56,6 +56,11 @@ namespace WebCore {
 
 static const double autoreleaseInterval = 3;
 
+// FIXME: This should not be hardcoded, it should come from
+// WebKitBackForwardCacheExpirationIntervalKey in WebKit.
+// Or we should remove WebKitBackForwardCacheExpirationIntervalKey.
+static const double cachedPageExpirationInterval = 1800;
+
 #ifndef NDEBUG
 
 static String& pageCacheLogPrefix(int indentLevel)
@@ -238,6 +243,8 @@ PageCache* pageCache()
 PageCache::PageCache()
     : m_capacity(0)
     , m_size(0)
+    , m_memoryCapacity(0)
+    , m_estimatedSize(0)
     , m_head(0)
     , m_tail(0)
     , m_autoreleaseTimer(this, &PageCache::releaseAutoreleasedPagesNowOrReschedule)
@@ -328,6 +335,13 @@ void PageCache::setCapacity(int capacity)
     prune();
 }
 
+void PageCache::setMemoryCapacity(unsigned memoryCapacity)
+{
+    m_memoryCapacity = memoryCapacity;
+
+    prune();
+}
+
 int PageCache::frameCount() const
 {
     int frameCount = 0;
@@ -351,6 +365,12 @@ void PageCache::markPagesForVistedLinkStyleRecalc()
         current->m_cachedPage->markForVistedLinkStyleRecalc();
 }
 
+void PageCache::markPagesForVistedLinkStyleRecalc(LinkHash visitedHash)
+{
+    for (HistoryItem* current = m_head; current; current = current->m_next)
+        current->m_cachedPage->markForVistedLinkStyleRecalc(visitedHash);
+}
+
 void PageCache::add(PassRefPtr<HistoryItem> prpItem, Page* page)
 {
     ASSERT(prpItem);
@@ -366,6 +386,7 @@ void PageCache::add(PassRefPtr<HistoryItem> prpItem, Page* page)
     item->m_cachedPage = CachedPage::create(page);
     addToLRUList(item);
     ++m_size;
+    m_estimatedSize += item->m_cachedPage->estimatedSize();
     
     prune();
 }
@@ -376,10 +397,7 @@ CachedPage* PageCache::get(HistoryItem* item)
         return 0;
 
     if (CachedPage* cachedPage = item->m_cachedPage.get()) {
-        // FIXME: 1800 should not be hardcoded, it should come from
-        // WebKitBackForwardCacheExpirationIntervalKey in WebKit.
-        // Or we should remove WebKitBackForwardCacheExpirationIntervalKey.
-        if (currentTime() - cachedPage->timeStamp() <= 1800)
+        if (currentTime() - cachedPage->timeStamp() <= cachedPageExpirationInterval)
             return cachedPage;
         
         LOG(PageCache, "Not restoring page for %s from back/forward cache because cache entry has expired", item->url().string().ascii().data());
@@ -394,6 +412,8 @@ void PageCache::remove(HistoryItem* item)
     if (!item || !item->m_cachedPage)
         return;
 
+    ASSERT(m_estimatedSize >= item->m_cachedPage->estimatedSize());
+    m_estimatedSize -= item->m_cachedPage->estimatedSize();
     autorelease(item->m_cachedPage.release());
     removeFromLRUList(item);
     --m_size;
@@ -407,6 +427,28 @@ void PageCache::prune()
         ASSERT(m_tail && m_tail->m_cachedPage);
         remove(m_tail);
     }
+
+    // The tail is the oldest entry; get() would refuse an expired one anyway.
+    double now = currentTime();
+    while (m_tail && now - m_tail->m_cachedPage->timeStamp() > cachedPageExpirationInterval)
+        remove(m_tail);
+
+    if (!m_memoryCapacity || m_estimatedSize <= m_memoryCapacity)
+        return;
+
+    // Decoded images and scripts come back lazily when the page is restored,
+    // so shed them before whole pages.
+    for (HistoryItem* current = m_tail; current && m_estimatedSize > m_memoryCapacity; current = current->m_prev) {
+        CachedPage* cachedPage = current->m_cachedPage.get();
+        m_estimatedSize -= cachedPage->estimatedSize();
+        cachedPage->destroyDecodedData();
+        m_estimatedSize += cachedPage->estimatedSize();
+    }
+
+    while (m_tail && m_estimatedSize > m_memoryCapacity) {
+        LOG(PageCache, "Evicting page for %s from back/forward cache, %u bytes over budget", m_tail->url().string().ascii().data(), m_estimatedSize - m_memoryCapacity);
+        remove(m_tail);
+    }
 }
 
 void PageCache::addToLRUList(HistoryItem* item)
@@ -27,6 +27,7 @@
 #define PageCache_h
 
 #include "HistoryItem.h"
+#include "LinkHash.h"
 #include "Timer.h"
 #include <wtf/Forward.h>
 #include <wtf/HashSet.h>
@@ -48,6 +49,13 @@ namespace WebCore {
 
         void setCapacity(int); // number of pages to cache
         int capacity() { return m_capacity; }
+
+        // Estimated bytes the cached pages may hold on to, 0 for no limit.
+        // Over budget, the least recently used pages first give up their
+        // decoded data, then are evicted.
+        void setMemoryCapacity(unsigned);
+        unsigned memoryCapacity() const { return m_memoryCapacity; }
+        unsigned estimatedSize() const { return m_estimatedSize; }
         
         void add(PassRefPtr<HistoryItem>, Page*); // Prunes if capacity() is exceeded.
         void remove(HistoryItem*);
@@ -60,6 +68,7 @@ namespace WebCore {
         int autoreleasedPageCount() const;
 
         void markPagesForVistedLinkStyleRecalc();
+        void markPagesForVistedLinkStyleRecalc(LinkHash);
 
     private:
         typedef HashSet<RefPtr<CachedPage> > CachedPageSet;
@@ -79,6 +88,8 @@ namespace WebCore {
 
         int m_capacity;
         int m_size;
+        unsigned m_memoryCapacity;
+        unsigned m_estimatedSize;
 
         // LRU List
         HistoryItem* m_head;
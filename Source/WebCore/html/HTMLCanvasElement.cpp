@@ -79,6 +79,10 @@ static const int DefaultHeight = 150;
 #if PLATFORM(ANDROID)
 //TODO::VA::Make this robust later (prototyping)... needs to be protected by ifdefs for android
 int HTMLCanvasElement::s_canvas_id = 0;
+
+// Smaller canvases are cheaper to leave in the page's tiles than to give a
+// composited layer and textures of their own.
+static const int MinGpuCanvasArea = 256 * 256;
 #endif
 
 // Firefox limits width/height to 32767 pixels, but slows down dramatically before it
@@ -407,6 +411,9 @@ LayerAndroid* HTMLCanvasElement::platformLayer()
 
 bool HTMLCanvasElement::canUseGpuRendering()
 {
+    if (width() * height() < MinGpuCanvasArea)
+        return false;
+
     ImageBuffer* imageBuffer = buffer();
     if(imageBuffer)
         return (imageBuffer->drawsUsingRecording() && m_canUseGpuRendering && m_supportedCompositing && m_gpuCanvasEnabled);
@@ -41,6 +41,7 @@
 #include "RenderFrame.h"
 #include "ScriptController.h"
 #include "ScriptEventListener.h"
+#include "SecurityOrigin.h"
 #include "Settings.h"
 
 namespace WebCore {
@@ -55,9 +56,16 @@ HTMLFrameElementBase::HTMLFrameElementBase(const QualifiedName& tagName, Documen
     , m_checkInDocumentTimer(this, &HTMLFrameElementBase::checkInDocumentTimerFired)
     , m_viewSource(false)
     , m_remainsAliveOnRemovalFromTree(false)
+    , m_loadDeferred(false)
 {
 }
 
+HTMLFrameElementBase::~HTMLFrameElementBase()
+{
+    if (m_loadDeferred)
+        document()->removeDeferredFrameElement(this);
+}
+
 bool HTMLFrameElementBase::isURLAllowed() const
 {
     if (m_URL.isEmpty())
@@ -107,6 +115,42 @@ void HTMLFrameElementBase::openURL(bool lockHistory, bool lockBackForwardList)
         contentFrame()->setInViewSourceMode(viewSourceMode());
 }
 
+bool HTMLFrameElementBase::shouldDeferLoad() const
+{
+    if (!hasTagName(iframeTag) || m_URL.isEmpty())
+        return false;
+
+    Frame* parentFrame = document()->frame();
+    if (!parentFrame || !parentFrame->page() || parentFrame != parentFrame->page()->mainFrame())
+        return false;
+
+    Settings* settings = parentFrame->settings();
+    if (!settings || !settings->deferOffscreenFrameLoads())
+        return false;
+
+    // Only defer frames whose document script in this page could never reach,
+    // so that a missing contentDocument is indistinguishable from a slow load.
+    const KURL& completeURL = document()->completeURL(m_URL);
+    if (!completeURL.protocolInHTTPFamily())
+        return false;
+    return !document()->securityOrigin()->canRequest(completeURL);
+}
+
+void HTMLFrameElementBase::cancelDeferredLoad()
+{
+    ASSERT(m_loadDeferred);
+    m_loadDeferred = false;
+    document()->removeDeferredFrameElement(this);
+}
+
+void HTMLFrameElementBase::loadDeferredFrame()
+{
+    if (!m_loadDeferred)
+        return;
+    cancelDeferredLoad();
+    setNameAndOpenURL();
+}
+
 void HTMLFrameElementBase::parseMappedAttribute(Attribute* attr)
 {
     if (attr->name() == srcAttr)
@@ -187,6 +231,12 @@ void HTMLFrameElementBase::insertedIntoDocument()
     // this and attach() will ASSERT(!attached())
     ASSERT(!renderer()); // This recalc is unecessary if we already have a renderer.
     lazyAttach(DoNotSetAttached);
+
+    if (shouldDeferLoad()) {
+        m_loadDeferred = true;
+        document()->addDeferredFrameElement(this);
+        return;
+    }
     setNameAndOpenURL();
 }
 
@@ -213,6 +263,12 @@ void HTMLFrameElementBase::setLocation(const String& str)
 
     m_URL = AtomicString(str);
 
+    if (m_loadDeferred) {
+        if (shouldDeferLoad())
+            return;
+        cancelDeferredLoad();
+    }
+
     if (inDocument())
         openURL(false, false);
 }
@@ -277,6 +333,9 @@ void HTMLFrameElementBase::checkInDocumentTimerFired(Timer<HTMLFrameElementBase>
 
 void HTMLFrameElementBase::willRemove()
 {
+    if (m_loadDeferred)
+        cancelDeferredLoad();
+
     if (m_remainsAliveOnRemovalFromTree)
         return;
 
@@ -43,12 +43,18 @@ public:
     int height() const;
 
     void setRemainsAliveOnRemovalFromTree(bool);
+
+    // Starts a load that insertedIntoDocument() postponed because the frame
+    // was off screen. FrameView calls this once the frame nears the viewport.
+    bool loadDeferred() const { return m_loadDeferred; }
+    void loadDeferredFrame();
 #if ENABLE(FULLSCREEN_API)
     virtual bool allowFullScreen() const;
 #endif
 
 protected:
     HTMLFrameElementBase(const QualifiedName&, Document*);
+    virtual ~HTMLFrameElementBase();
 
     bool isURLAllowed() const;
 
@@ -71,6 +77,9 @@ private:
     void setNameAndOpenURL();
     void openURL(bool lockHistory = true, bool lockBackForwardList = true);
 
+    bool shouldDeferLoad() const;
+    void cancelDeferredLoad();
+
     AtomicString m_URL;
     AtomicString m_frameName;
 
@@ -93,6 +102,7 @@ private:
 
     bool m_viewSource;
     bool m_remainsAliveOnRemovalFromTree;
+    bool m_loadDeferred;
 };
 
 } // namespace WebCore
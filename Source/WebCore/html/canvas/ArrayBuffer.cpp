@@ -28,6 +28,7 @@
 #include "config.h"
 #include "ArrayBuffer.h"
 
+#include "ArrayBufferView.h"
 #include <wtf/RefPtr.h>
 
 namespace WebCore {
@@ -65,25 +66,32 @@ PassRefPtr<ArrayBuffer> ArrayBuffer::create(const void* source, unsigned byteLen
     return buffer.release();
 }
 
+PassRefPtr<ArrayBuffer> ArrayBuffer::create(ArrayBufferContents& contents)
+{
+    RefPtr<ArrayBuffer> buffer = adoptRef(new ArrayBuffer(static_cast<void*>(0), 0));
+    contents.transfer(buffer->m_contents);
+    return buffer.release();
+}
+
 ArrayBuffer::ArrayBuffer(void* data, unsigned sizeInBytes)
-    : m_sizeInBytes(sizeInBytes)
-    , m_data(data)
+    : m_contents(data, sizeInBytes)
+    , m_firstView(0)
 {
 }
 
 void* ArrayBuffer::data()
 {
-    return m_data;
+    return m_contents.m_data;
 }
 
 const void* ArrayBuffer::data() const
 {
-    return m_data;
+    return m_contents.m_data;
 }
 
 unsigned ArrayBuffer::byteLength() const
 {
-    return m_sizeInBytes;
+    return m_contents.m_sizeInBytes;
 }
 
 PassRefPtr<ArrayBuffer> ArrayBuffer::slice(int begin, int end) const
@@ -110,7 +118,49 @@ unsigned ArrayBuffer::clampIndex(int index) const
     return clampValue(index, 0, currentLength);
 }
 
+bool ArrayBuffer::transfer(ArrayBufferContents& result, Vector<RefPtr<ArrayBufferView> >& neuteredViews)
+{
+    if (isNeutered())
+        return false;
+
+    m_contents.transfer(result);
+
+    while (m_firstView) {
+        ArrayBufferView* current = m_firstView;
+        removeView(current);
+        current->neuter();
+        neuteredViews.append(current);
+    }
+    return true;
+}
+
+void ArrayBuffer::addView(ArrayBufferView* view)
+{
+    ASSERT(this == view->m_buffer);
+    view->m_prevView = 0;
+    view->m_nextView = m_firstView;
+    if (m_firstView)
+        m_firstView->m_prevView = view;
+    m_firstView = view;
+}
+
+void ArrayBuffer::removeView(ArrayBufferView* view)
+{
+    ASSERT(this == view->m_buffer);
+    if (view->m_nextView)
+        view->m_nextView->m_prevView = view->m_prevView;
+    if (view->m_prevView)
+        view->m_prevView->m_nextView = view->m_nextView;
+    if (m_firstView == view)
+        m_firstView = view->m_nextView;
+    view->m_prevView = view->m_nextView = 0;
+}
+
 ArrayBuffer::~ArrayBuffer()
+{
+}
+
+ArrayBufferContents::~ArrayBufferContents()
 {
     WTF::fastFree(m_data);
 }
@@ -28,16 +28,61 @@
 #ifndef ArrayBuffer_h
 #define ArrayBuffer_h
 
+#include <wtf/Noncopyable.h>
 #include <wtf/PassRefPtr.h>
 #include <wtf/RefCounted.h>
+#include <wtf/Vector.h>
 
 namespace WebCore {
 
+class ArrayBuffer;
+class ArrayBufferView;
+
+// The backing store of an ArrayBuffer, detached from any particular buffer
+// object so that it can be handed to another thread without a copy.
+class ArrayBufferContents {
+    WTF_MAKE_NONCOPYABLE(ArrayBufferContents);
+  public:
+    ArrayBufferContents()
+        : m_data(0)
+        , m_sizeInBytes(0)
+    {
+    }
+
+    ~ArrayBufferContents();
+
+    void* data() const { return m_data; }
+    unsigned sizeInBytes() const { return m_sizeInBytes; }
+
+  private:
+    friend class ArrayBuffer;
+
+    ArrayBufferContents(void* data, unsigned sizeInBytes)
+        : m_data(data)
+        , m_sizeInBytes(sizeInBytes)
+    {
+    }
+
+    void transfer(ArrayBufferContents& other)
+    {
+        ASSERT(!other.m_data);
+        other.m_data = m_data;
+        other.m_sizeInBytes = m_sizeInBytes;
+        m_data = 0;
+        m_sizeInBytes = 0;
+    }
+
+    void* m_data;
+    unsigned m_sizeInBytes;
+};
+
 class ArrayBuffer : public RefCounted<ArrayBuffer> {
   public:
     static PassRefPtr<ArrayBuffer> create(unsigned numElements, unsigned elementByteSize);
     static PassRefPtr<ArrayBuffer> create(ArrayBuffer*);
     static PassRefPtr<ArrayBuffer> create(const void* source, unsigned byteLength);
+    // Takes ownership of the backing store in |contents|, leaving it empty.
+    static PassRefPtr<ArrayBuffer> create(ArrayBufferContents&);
 
     void* data();
     const void* data() const;
@@ -46,6 +91,16 @@ class ArrayBuffer : public RefCounted<ArrayBuffer> {
     PassRefPtr<ArrayBuffer> slice(int begin, int end) const;
     PassRefPtr<ArrayBuffer> slice(int begin) const;
 
+    // Moves the backing store into |result| and neuters this buffer and
+    // every view onto it, appending the views to |neuteredViews| so the
+    // bindings can drop their cached pointers too. Fails if the buffer
+    // has already been neutered.
+    bool transfer(ArrayBufferContents& result, Vector<RefPtr<ArrayBufferView> >& neuteredViews);
+    bool isNeutered() const { return !m_contents.m_data; }
+
+    void addView(ArrayBufferView*);
+    void removeView(ArrayBufferView*);
+
     ~ArrayBuffer();
 
   private:
@@ -55,8 +110,8 @@ class ArrayBuffer : public RefCounted<ArrayBuffer> {
     PassRefPtr<ArrayBuffer> sliceImpl(unsigned begin, unsigned end) const;
     unsigned clampIndex(int index) const;
 
-    unsigned m_sizeInBytes;
-    void* m_data;
+    ArrayBufferContents m_contents;
+    ArrayBufferView* m_firstView;
 };
 
 } // namespace WebCore
@@ -34,12 +34,24 @@ ArrayBufferView::ArrayBufferView(PassRefPtr<ArrayBuffer> buffer,
                        unsigned byteOffset)
         : m_byteOffset(byteOffset)
         , m_buffer(buffer)
+        , m_prevView(0)
+        , m_nextView(0)
 {
     m_baseAddress = m_buffer ? (static_cast<char*>(m_buffer->data()) + m_byteOffset) : 0;
+    if (m_buffer)
+        m_buffer->addView(this);
 }
 
 ArrayBufferView::~ArrayBufferView()
 {
+    if (m_buffer)
+        m_buffer->removeView(this);
+}
+
+void ArrayBufferView::neuter()
+{
+    m_baseAddress = 0;
+    m_byteOffset = 0;
 }
 
 void ArrayBufferView::setImpl(ArrayBufferView* array, unsigned byteOffset, ExceptionCode& ec)
@@ -72,6 +72,10 @@ class ArrayBufferView : public RefCounted<ArrayBufferView> {
   protected:
     ArrayBufferView(PassRefPtr<ArrayBuffer> buffer, unsigned byteOffset);
 
+    // Called when the underlying buffer's contents are transferred away.
+    // Subclasses must also zero their own length.
+    virtual void neuter();
+
     void setImpl(ArrayBufferView* array, unsigned byteOffset, ExceptionCode& ec);
 
     void setRangeImpl(const char* data, size_t dataByteLength, unsigned byteOffset, ExceptionCode& ec);
@@ -126,7 +130,10 @@ class ArrayBufferView : public RefCounted<ArrayBufferView> {
     unsigned m_byteOffset;
 
   private:
+    friend class ArrayBuffer;
     RefPtr<ArrayBuffer> m_buffer;
+    ArrayBufferView* m_prevView;
+    ArrayBufferView* m_nextView;
 };
 
 } // namespace WebCore
@@ -72,6 +72,12 @@ protected:
     {
     }
 
+    virtual void neuter()
+    {
+        ArrayBufferView::neuter();
+        m_length = 0;
+    }
+
     template <class Subclass>
     static PassRefPtr<Subclass> create(unsigned length)
     {
@@ -397,6 +397,8 @@ void WebGLRenderingContext::initializeNewContext()
     m_unpackColorspaceConversion = GraphicsContext3D::BROWSER_DEFAULT_WEBGL;
     m_boundArrayBuffer = 0;
     m_currentProgram = 0;
+    m_renderingStateCacheValid = false;
+    m_renderableElementCount = 0;
     m_framebufferBinding = 0;
     m_renderbufferBinding = 0;
     m_stencilMask = 0xFFFFFFFF;
@@ -844,6 +846,7 @@ void WebGLRenderingContext::bufferData(GC3Denum target, GC3Dsizeiptr size, GC3De
     WebGLBuffer* buffer = validateBufferDataParameters(target, usage);
     if (!buffer)
         return;
+    invalidateRenderingStateCache();
     if (size < 0) {
         m_context->synthesizeGLError(GraphicsContext3D::INVALID_VALUE);
         return;
@@ -867,6 +870,7 @@ void WebGLRenderingContext::bufferData(GC3Denum target, ArrayBuffer* data, GC3De
     WebGLBuffer* buffer = validateBufferDataParameters(target, usage);
     if (!buffer)
         return;
+    invalidateRenderingStateCache();
     if (!data) {
         m_context->synthesizeGLError(GraphicsContext3D::INVALID_VALUE);
         return;
@@ -892,6 +896,7 @@ void WebGLRenderingContext::bufferData(GC3Denum target, ArrayBufferView* data, G
     WebGLBuffer* buffer = validateBufferDataParameters(target, usage);
     if (!buffer)
         return;
+    invalidateRenderingStateCache();
     if (!data) {
         m_context->synthesizeGLError(GraphicsContext3D::INVALID_VALUE);
         return;
@@ -1271,6 +1276,7 @@ void WebGLRenderingContext::deleteBuffer(WebGLBuffer* buffer)
 {
     if (!deleteObject(buffer))
         return;
+    invalidateRenderingStateCache();
     if (m_boundArrayBuffer == buffer)
         m_boundArrayBuffer = 0;
     RefPtr<WebGLBuffer> elementArrayBuffer = m_boundVertexArrayObject->getElementArrayBuffer();
@@ -1402,6 +1408,7 @@ void WebGLRenderingContext::disableVertexAttribArray(GC3Duint index, ExceptionCo
 
     WebGLVertexArrayObjectOES::VertexAttribState& state = m_boundVertexArrayObject->getVertexAttribState(index);
     state.enabled = false;
+    invalidateRenderingStateCache();
 
     if (index > 0 || isGLES2Compliant()) {
         m_context->disableVertexAttribArray(index);
@@ -1540,17 +1547,32 @@ bool WebGLRenderingContext::validateRenderingState(int numElementsRequired)
     if (!m_currentProgram)
         return false;
 
+    // Games issue many draws between state changes, so the walk over the
+    // vertex attributes is only redone once something it depends on changes.
+    if (!m_renderingStateCacheValid) {
+        m_renderableElementCount = computeRenderableElementCount();
+        m_renderingStateCacheValid = true;
+    }
+
+    if (m_renderableElementCount < 0)
+        return false;
+
+    if (numElementsRequired <= 0)
+        return true;
+
+    return numElementsRequired <= m_renderableElementCount;
+}
+
+int WebGLRenderingContext::computeRenderableElementCount()
+{
     // Look in each enabled vertex attrib and check if they've been bound to a buffer.
     for (unsigned i = 0; i < m_maxVertexAttribs; ++i) {
         const WebGLVertexArrayObjectOES::VertexAttribState& state = m_boundVertexArrayObject->getVertexAttribState(i);
         if (state.enabled
             && (!state.bufferBinding || !state.bufferBinding->object()))
-            return false;
+            return -1;
     }
 
-    if (numElementsRequired <= 0)
-        return true;
-
     // Look in each consumed vertex attrib (by the current program) and find the smallest buffer size
     int smallestNumElements = INT_MAX;
     int numActiveAttribLocations = m_currentProgram->numActiveAttribLocations();
@@ -1576,7 +1598,7 @@ bool WebGLRenderingContext::validateRenderingState(int numElementsRequired)
     if (smallestNumElements == INT_MAX)
         smallestNumElements = 0;
 
-    return numElementsRequired <= smallestNumElements;
+    return smallestNumElements;
 }
 
 bool WebGLRenderingContext::validateWebGLObject(WebGLObject* object)
@@ -1744,6 +1766,7 @@ void WebGLRenderingContext::enableVertexAttribArray(GC3Duint index, ExceptionCod
 
     WebGLVertexArrayObjectOES::VertexAttribState& state = m_boundVertexArrayObject->getVertexAttribState(index);
     state.enabled = true;
+    invalidateRenderingStateCache();
 
     m_context->enableVertexAttribArray(index);
     cleanupAfterGraphicsCall(false);
@@ -2819,6 +2842,8 @@ void WebGLRenderingContext::linkProgram(WebGLProgram* program, ExceptionCode& ec
     program->setLinkStatus(static_cast<bool>(value));
     // Need to cache link status before caching active attribute locations.
     program->cacheActiveAttribLocations();
+    if (program == m_currentProgram)
+        invalidateRenderingStateCache();
     cleanupAfterGraphicsCall(false);
 }
 
@@ -3859,6 +3884,7 @@ void WebGLRenderingContext::useProgram(WebGLProgram* program, ExceptionCode& ec)
         if (m_currentProgram)
             m_currentProgram->onDetached();
         m_currentProgram = program;
+        invalidateRenderingStateCache();
         m_context->useProgram(objectOrZero(program));
         if (program)
             program->onAttached();
@@ -3979,6 +4005,7 @@ void WebGLRenderingContext::vertexAttribPointer(GC3Duint index, GC3Dint size, GC
 
     WebGLVertexArrayObjectOES::VertexAttribState& state = m_boundVertexArrayObject->getVertexAttribState(index);
     state.bufferBinding = m_boundArrayBuffer;
+    invalidateRenderingStateCache();
     state.bytesPerElement = bytesPerElement;
     state.size = size;
     state.type = type;
@@ -365,6 +365,10 @@ public:
     bool validateIndexArrayPrecise(GC3Dsizei count, GC3Denum type, GC3Dintptr offset, int& numElementsRequired);
     // If numElements <= 0, we only check if each enabled vertex attribute is bound to a buffer.
     bool validateRenderingState(int numElements);
+    // Recomputed by validateRenderingState() after any change to the current
+    // program, the vertex attribute state or the size of a buffer.
+    void invalidateRenderingStateCache() { m_renderingStateCacheValid = false; }
+    int computeRenderableElementCount();
 
     bool validateWebGLObject(WebGLObject*);
 
@@ -396,6 +400,7 @@ public:
     RefPtr<WebGLVertexArrayObjectOES> m_boundVertexArrayObject;
     void setBoundVertexArrayObject(PassRefPtr<WebGLVertexArrayObjectOES> arrayObject)
     {
+        invalidateRenderingStateCache();
         if (arrayObject)
             m_boundVertexArrayObject = arrayObject;
         else
@@ -428,6 +433,9 @@ public:
     bool m_vertexAttrib0UsedBefore;
 
     RefPtr<WebGLProgram> m_currentProgram;
+    bool m_renderingStateCacheValid;
+    // -1 if an enabled vertex attribute has no buffer.
+    int m_renderableElementCount;
     RefPtr<WebGLFramebuffer> m_framebufferBinding;
     RefPtr<WebGLRenderbuffer> m_renderbufferBinding;
     class TextureUnitState {
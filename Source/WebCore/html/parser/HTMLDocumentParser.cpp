@@ -45,6 +45,10 @@
 #include "TimeCounter.h"
 #endif
 
+#if PLATFORM(ANDROID)
+#include "TraceEventAndroid.h"
+#endif
+
 namespace WebCore {
 
 using namespace HTMLNames;
@@ -253,6 +257,9 @@ void HTMLDocumentParser::pumpTokenizer(SynchronousMode mode)
     // ASSERT that this object is both attached to the Document and protected.
     ASSERT(refCount() >= 2);
 
+#if PLATFORM(ANDROID)
+    ANDROID_TRACE_EVENT("webcore", "HTMLDocumentParser::pumpTokenizer");
+#endif
     PumpSession session(m_pumpSessionNestingLevel);
 
     // We tell the InspectorInstrumentation about every pump, even if we
@@ -291,7 +298,12 @@ void HTMLDocumentParser::pumpTokenizer(SynchronousMode mode)
     if (session.needsYield)
         m_parserScheduler->scheduleForResume();
 
-    if (isWaitingForScripts()) {
+    // A yield leaves the rest of the received input untouched until the scheduler resumes us.
+    // Scan ahead over it, as we do when blocked on a script, so that the resources it references
+    // start loading while layout and script run. Only start from a point between tokens.
+    bool shouldScanAheadOfYield = session.needsYield && m_tokenizer->state() == HTMLTokenizer::DataState;
+
+    if (isWaitingForScripts() || shouldScanAheadOfYield) {
         ASSERT(m_tokenizer->state() == HTMLTokenizer::DataState);
         if (!m_preloadScanner) {
             m_preloadScanner.set(new HTMLPreloadScanner(document()));
@@ -38,11 +38,22 @@
 #include "HTMLParserIdioms.h"
 #include "MediaList.h"
 #include "MediaQueryEvaluator.h"
+#if PLATFORM(ANDROID)
+#include "IntSize.h"
+#include "ResourceHandle.h"
+#endif
 
 namespace WebCore {
 
 using namespace HTMLNames;
 
+#if PLATFORM(ANDROID)
+// The first few images of a document are taken to be the ones its first
+// paint shows, unless the markup says they are icons or spacers.
+static const unsigned cMaxCriticalImages = 3;
+static const int cMinCriticalImageArea = 64 * 64;
+#endif
+
 namespace {
 
 class PreloadTask {
@@ -52,6 +63,9 @@ public:
         , m_linkIsStyleSheet(false)
         , m_linkMediaAttributeIsScreen(true)
         , m_inputIsImage(false)
+#if PLATFORM(ANDROID)
+        , m_isCriticalImage(false)
+#endif
     {
         processAttributes(token.attributes());
     }
@@ -75,6 +89,12 @@ public:
             if (m_tagName == scriptTag || m_tagName == imgTag) {
                 if (attributeName == srcAttr)
                     setUrlToLoad(attributeValue);
+#if PLATFORM(ANDROID)
+                else if (attributeName == widthAttr)
+                    m_sizeHint.setWidth(attributeValue.toInt());
+                else if (attributeName == heightAttr)
+                    m_sizeHint.setHeight(attributeValue.toInt());
+#endif
             } else if (m_tagName == linkTag) {
                 if (attributeName == hrefAttr)
                     setUrlToLoad(attributeValue);
@@ -127,6 +147,18 @@ public:
 
         CachedResourceLoader* cachedResourceLoader = document->cachedResourceLoader();
         ResourceRequest request = document->completeURL(m_urlToLoad);
+#if PLATFORM(ANDROID)
+        // Body images and deferred scripts may not be requested for a while,
+        // start resolving their hosts now.
+        if (document->isDNSPrefetchEnabled())
+            ResourceHandle::prepareForURL(request.url());
+#endif
+#if PLATFORM(ANDROID)
+        if (m_isCriticalImage) {
+            cachedResourceLoader->preloadCriticalImage(request, m_sizeHint);
+            return;
+        }
+#endif
         if (m_tagName == scriptTag)
             cachedResourceLoader->preload(CachedResource::Script, request, m_charset, scanningBody);
         else if (m_tagName == imgTag || (m_tagName == inputTag && m_inputIsImage))
@@ -137,6 +169,19 @@ public:
 
     const AtomicString& tagName() const { return m_tagName; }
 
+#if PLATFORM(ANDROID)
+    bool mayBeCriticalImage() const
+    {
+        if (m_tagName != imgTag || m_urlToLoad.isEmpty())
+            return false;
+        // Without both dimensions there is nothing to go on, assume it's big.
+        if (m_sizeHint.width() <= 0 || m_sizeHint.height() <= 0)
+            return true;
+        return m_sizeHint.width() * m_sizeHint.height() >= cMinCriticalImageArea;
+    }
+    void setIsCriticalImage() { m_isCriticalImage = true; }
+#endif
+
 private:
     AtomicString m_tagName;
     String m_urlToLoad;
@@ -144,6 +189,10 @@ private:
     bool m_linkIsStyleSheet;
     bool m_linkMediaAttributeIsScreen;
     bool m_inputIsImage;
+#if PLATFORM(ANDROID)
+    IntSize m_sizeHint;
+    bool m_isCriticalImage;
+#endif
 };
 
 } // namespace
@@ -154,6 +203,9 @@ HTMLPreloadScanner::HTMLPreloadScanner(Document* document)
     , m_tokenizer(HTMLTokenizer::create(HTMLDocumentParser::usePreHTML5ParserQuirks(document)))
     , m_bodySeen(false)
     , m_inStyle(false)
+#if PLATFORM(ANDROID)
+    , m_criticalImageCount(0)
+#endif
 {
 }
 
@@ -195,6 +247,13 @@ void HTMLPreloadScanner::processToken()
     if (task.tagName() == styleTag)
         m_inStyle = true;
 
+#if PLATFORM(ANDROID)
+    if (m_criticalImageCount < cMaxCriticalImages && task.mayBeCriticalImage()) {
+        task.setIsCriticalImage();
+        m_criticalImageCount++;
+    }
+#endif
+
     task.preload(m_document, scanningBody());
 }
 
@@ -57,6 +57,9 @@ private:
     HTMLToken m_token;
     bool m_bodySeen;
     bool m_inStyle;
+#if PLATFORM(ANDROID)
+    unsigned m_criticalImageCount;
+#endif
 };
 
 }
@@ -160,6 +160,12 @@ public:
         m_data.append(characters);
     }
 
+    void appendToCharacter(const UChar* characters, size_t length)
+    {
+        ASSERT(m_type == Character);
+        m_data.append(characters, length);
+    }
+
     void appendToComment(UChar character)
     {
         ASSERT(character);
@@ -222,6 +228,13 @@ public:
         m_currentAttribute->m_value.append(character);
     }
 
+    void appendToAttributeValue(const UChar* characters, size_t length)
+    {
+        ASSERT(m_type == StartTag || m_type == EndTag);
+        ASSERT(m_currentAttribute->m_valueRange.m_start);
+        m_currentAttribute->m_value.append(characters, length);
+    }
+
     void appendToAttributeValue(size_t i, const String& value)
     {
         ASSERT(!value.isEmpty());
@@ -378,12 +391,41 @@ private:
     Attribute* m_currentAttribute;
 };
 
+// Tag and attribute names repeat constantly within a document. This remembers
+// the last name seen in each of a few slots, so most names become AtomicStrings
+// with a short compare instead of hashing and probing the AtomicString table.
+class HTMLNameCache {
+    WTF_MAKE_NONCOPYABLE(HTMLNameCache);
+public:
+    HTMLNameCache() { }
+
+    template<size_t inlineCapacity>
+    AtomicString name(const WTF::Vector<UChar, inlineCapacity>& characters)
+    {
+        const UChar* data = characters.data();
+        unsigned length = characters.size();
+        if (!length || length > maximumCachedNameLength)
+            return AtomicString(data, length);
+
+        AtomicString& entry = m_entries[(data[0] + (data[length - 1] << 2) + length) % capacity];
+        if (entry.length() != length || memcmp(entry.characters(), data, length * sizeof(UChar)))
+            entry = AtomicString(data, length);
+        return entry;
+    }
+
+private:
+    static const unsigned maximumCachedNameLength = 16;
+    static const unsigned capacity = 64;
+
+    AtomicString m_entries[capacity];
+};
+
 // FIXME: This class should eventually be named HTMLToken once we move the
 // exiting HTMLToken to be internal to the HTMLTokenizer.
 class AtomicHTMLToken {
     WTF_MAKE_NONCOPYABLE(AtomicHTMLToken);
 public:
-    AtomicHTMLToken(HTMLToken& token)
+    AtomicHTMLToken(HTMLToken& token, HTMLNameCache& nameCache)
         : m_type(token.type())
     {
         switch (m_type) {
@@ -399,8 +441,8 @@ public:
         case HTMLToken::StartTag:
         case HTMLToken::EndTag: {
             m_selfClosing = token.selfClosing();
-            m_name = AtomicString(token.name().data(), token.name().size());
-            initializeAttributes(token.attributes());
+            m_name = nameCache.name(token.name());
+            initializeAttributes(token.attributes(), nameCache);
             break;
         }
         case HTMLToken::Comment:
@@ -495,7 +537,7 @@ public:
 private:
     HTMLToken::Type m_type;
 
-    void initializeAttributes(const HTMLToken::AttributeList& attributes);
+    void initializeAttributes(const HTMLToken::AttributeList& attributes, HTMLNameCache&);
     
     bool usesName() const
     {
@@ -532,7 +574,7 @@ private:
     RefPtr<NamedNodeMap> m_attributes;
 };
 
-inline void AtomicHTMLToken::initializeAttributes(const HTMLToken::AttributeList& attributes)
+inline void AtomicHTMLToken::initializeAttributes(const HTMLToken::AttributeList& attributes, HTMLNameCache& nameCache)
 {
     size_t size = attributes.size();
     if (!size)
@@ -550,8 +592,10 @@ inline void AtomicHTMLToken::initializeAttributes(const HTMLToken::AttributeList
         ASSERT(attribute.m_valueRange.m_start);
         ASSERT(attribute.m_valueRange.m_end);
 
-        String name(attribute.m_name.data(), attribute.m_name.size());
-        String value(attribute.m_value.data(), attribute.m_value.size());
+        // Atomize straight from the token's buffers. Going through a String would
+        // allocate a copy even when the table already holds the string.
+        AtomicString name = nameCache.name(attribute.m_name);
+        AtomicString value(attribute.m_value.data(), attribute.m_value.size());
         m_attributes->insertAttribute(Attribute::createMapped(name, value), false);
     }
 }
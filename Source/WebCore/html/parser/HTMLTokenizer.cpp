@@ -101,6 +101,29 @@ inline bool isEndTagBufferingState(HTMLTokenizer::State state)
     }
 }
 
+// Text content and attribute values mostly come in long runs with nothing the
+// state machine needs to look at. Returns how many characters after the current
+// one, |cc|, can be appended in bulk instead of stepping the state machine once
+// per character. The run stays inside the current substring, and the state machine
+// still advances onto the character after it itself. Newlines, carriage returns
+// and nulls end a run so the input stream preprocessor sees them.
+template<UChar terminator>
+inline unsigned plainCharacterRunLength(SegmentedString& source, UChar cc)
+{
+    unsigned available = source.lengthOfCurrentSubstring();
+    if (available < 2 || cc == '\n' || *source != cc)
+        return 0;
+    const UChar* characters = source.operator->();
+    unsigned length = 0;
+    while (length + 1 < available) {
+        UChar next = characters[length + 1];
+        if (next == terminator || next == '&' || next == '\n' || next == '\r' || !next)
+            break;
+        ++length;
+    }
+    return length;
+}
+
 }
 
 HTMLTokenizer::HTMLTokenizer(bool usePreHTML5ParserQuirks)
@@ -317,6 +340,10 @@ bool HTMLTokenizer::nextToken(SegmentedString& source, HTMLToken& token)
             return emitEndOfFile(source);
         else {
             bufferCharacter(cc);
+            if (unsigned length = plainCharacterRunLength<'<'>(source, cc)) {
+                m_token->appendToCharacter(source.operator->() + 1, length);
+                source.advancePastNonNewlines(length);
+            }
             ADVANCE_TO(DataState);
         }
     }
@@ -1004,6 +1031,10 @@ bool HTMLTokenizer::nextToken(SegmentedString& source, HTMLToken& token)
             RECONSUME_IN(DataState);
         } else {
             m_token->appendToAttributeValue(cc);
+            if (unsigned length = plainCharacterRunLength<'"'>(source, cc)) {
+                m_token->appendToAttributeValue(source.operator->() + 1, length);
+                source.advancePastNonNewlines(length);
+            }
             ADVANCE_TO(AttributeValueDoubleQuotedState);
         }
     }
@@ -32,6 +32,7 @@
 #include "HTMLConstructionSite.h"
 #include "HTMLElementStack.h"
 #include "HTMLFormattingElementList.h"
+#include "HTMLToken.h"
 #include "HTMLTokenizer.h"
 #include <wtf/text/TextPosition.h>
 #include <wtf/Noncopyable.h>
@@ -258,6 +259,8 @@ private:
     bool m_usePreHTML5ParserQuirks;
 
     bool m_hasPendingForeignInsertionModeSteps;
+
+    HTMLNameCache m_nameCache;
 };
 
 }
@@ -45,6 +45,14 @@ namespace WebCore {
 static const unsigned maxRequestsInFlightForNonHTTPProtocols = 20;
 // Match the parallel connection count used by the networking layer.
 static unsigned maxRequestsInFlightPerHost;
+#if PLATFORM(ANDROID)
+// Images and prefetches may only use this many of a host's connections until
+// the document has been parsed and its stylesheets have loaded.
+static const unsigned maxLowPriorityRequestsInFlightDuringFirstPaint = 2;
+// Requests to a host that speaks SPDY share one session and are ordered there
+// by their priority, so more of them can be handed to the network at once.
+static const unsigned maxRequestsInFlightPerMultiplexedHost = 16;
+#endif
 #else
 static const unsigned maxRequestsInFlightForNonHTTPProtocols = 10000;
 static const unsigned maxRequestsInFlightPerHost = 10000;
@@ -152,6 +160,18 @@ void ResourceLoadScheduler::crossOriginRedirectReceived(ResourceLoader* resource
     oldHost->remove(resourceLoader);
 }
 
+#if PLATFORM(ANDROID)
+void ResourceLoadScheduler::hostIsMultiplexed(const KURL& url)
+{
+    HostInformation* host = hostForURL(url);
+    if (!host || host->isMultiplexed())
+        return;
+    host->setMultiplexed();
+    // Hand the newly available slots to whatever is waiting for this host.
+    scheduleServePendingRequests();
+}
+#endif
+
 void ResourceLoadScheduler::servePendingRequests(ResourceLoadPriority minimumPriority)
 {
     LOG(ResourceLoading, "ResourceLoadScheduler::servePendingRequests. m_isSuspendingPendingRequests=%d", m_isSuspendingPendingRequests); 
@@ -192,9 +212,15 @@ void ResourceLoadScheduler::servePendingRequests(HostInformation* host, Resource
             // For non-named hosts - everything but http(s) - we should only enforce the limit if the document isn't done parsing 
             // and we don't know all stylesheets yet.
             Document* document = resourceLoader->frameLoader() ? resourceLoader->frameLoader()->frame()->document() : 0;
-            bool shouldLimitRequests = !host->name().isNull() || (document && (document->parsing() || !document->haveStylesheetsLoaded()));
+            bool isFirstPaintPending = document && (document->parsing() || !document->haveStylesheetsLoaded());
+            bool shouldLimitRequests = !host->name().isNull() || isFirstPaintPending;
+#if PLATFORM(ANDROID)
+            if (shouldLimitRequests && host->limitRequests(ResourceLoadPriority(priority), isFirstPaintPending))
+                return;
+#else
             if (shouldLimitRequests && host->limitRequests(ResourceLoadPriority(priority)))
                 return;
+#endif
 
             requestsPending.removeFirst();
             host->addLoadInProgress(resourceLoader.get());
@@ -283,11 +309,34 @@ bool ResourceLoadScheduler::HostInformation::hasRequests() const
     return false;
 }
 
+#if PLATFORM(ANDROID)
+bool ResourceLoadScheduler::HostInformation::limitRequests(ResourceLoadPriority priority, bool isFirstPaintPending) const
+#else
 bool ResourceLoadScheduler::HostInformation::limitRequests(ResourceLoadPriority priority) const 
+#endif
 {
     if (priority == ResourceLoadPriorityVeryLow && !m_requestsLoading.isEmpty())
         return true;
+#if PLATFORM(ANDROID)
+    // Leave the rest of the connections to the stylesheets and scripts the
+    // first layout is waiting on.
+    if (isFirstPaintPending && priority <= ResourceLoadPriorityLow
+        && m_requestsLoading.size() >= maxLowPriorityRequestsInFlightDuringFirstPaint)
+        return true;
+#endif
     return m_requestsLoading.size() >= (resourceLoadScheduler()->isSerialLoadingEnabled() ? 1 : m_maxRequestsInFlight);
 }
 
+#if PLATFORM(ANDROID)
+bool ResourceLoadScheduler::HostInformation::isMultiplexed() const
+{
+    return m_maxRequestsInFlight >= static_cast<int>(maxRequestsInFlightPerMultiplexedHost);
+}
+
+void ResourceLoadScheduler::HostInformation::setMultiplexed()
+{
+    m_maxRequestsInFlight = maxRequestsInFlightPerMultiplexedHost;
+}
+#endif
+
 } // namespace WebCore
@@ -63,6 +63,11 @@ public:
     bool isSerialLoadingEnabled() const { return m_isSerialLoadingEnabled; }
     void setSerialLoadingEnabled(bool b) { m_isSerialLoadingEnabled = b; }
 
+#if PLATFORM(ANDROID)
+    // The host of this URL multiplexes its requests over one connection.
+    void hostIsMultiplexed(const KURL&);
+#endif
+
 private:
     ResourceLoadScheduler();
     ~ResourceLoadScheduler();
@@ -82,7 +87,13 @@ private:
         void addLoadInProgress(ResourceLoader*);
         void remove(ResourceLoader*);
         bool hasRequests() const;
+#if PLATFORM(ANDROID)
+        bool limitRequests(ResourceLoadPriority, bool isFirstPaintPending) const;
+        bool isMultiplexed() const;
+        void setMultiplexed();
+#else
         bool limitRequests(ResourceLoadPriority) const;
+#endif
 
         typedef Deque<RefPtr<ResourceLoader> > RequestQueue;
         RequestQueue& requestsPending(ResourceLoadPriority priority) { return m_requestsPending[priority]; }
@@ -92,7 +103,11 @@ private:
         typedef HashSet<RefPtr<ResourceLoader> > RequestMap;
         RequestMap m_requestsLoading;
         const String m_name;
+#if PLATFORM(ANDROID)
+        int m_maxRequestsInFlight;
+#else
         const int m_maxRequestsInFlight;
+#endif
     };
 
     enum CreateHostPolicy {
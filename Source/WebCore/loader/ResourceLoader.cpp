@@ -268,6 +268,14 @@ void ResourceLoader::didReceiveResponse(const ResourceResponse& r)
 
     if (FormData* data = m_request.httpBody())
         data->removeGeneratedFilesIfNeeded();
+
+#if PLATFORM(ANDROID)
+    if (m_response.wasFetchedViaSPDY()) {
+        Settings* settings = m_frame->settings();
+        if (settings && settings->multiplexedLoadsEnabled())
+            resourceLoadScheduler()->hostIsMultiplexed(m_response.url());
+    }
+#endif
         
     if (m_sendResourceLoadCallbacks)
         frameLoader()->notifier()->didReceiveResponse(this, m_response);
@@ -49,6 +49,10 @@ namespace WebCore {
 
 static const char flatFileSubdirectory[] = "ApplicationCache";
 
+// Resources at least this large are kept in flat files, which loadCache()
+// maps instead of copying out of the database.
+static const unsigned minimumFlatFileResourceSize = 64 * 1024;
+
 template <class T>
 class StorageIDJournal {
 public:  
@@ -308,6 +312,8 @@ ApplicationCacheGroup* ApplicationCacheStorage::fallbackCacheGroupForURL(const K
         // a matching fallback namespace.
         unsigned newestCacheID = static_cast<unsigned>(statement.getColumnInt64(2));
         RefPtr<ApplicationCache> cache = loadCache(newestCacheID);
+        if (!cache)
+            continue;
 
         KURL fallbackURL;
         if (cache->isURLInOnlineWhitelist(url))
@@ -563,7 +569,7 @@ bool ApplicationCacheStorage::executeSQLCommand(const String& sql)
 // Update the schemaVersion when the schema of any the Application Cache
 // SQLite tables changes. This allows the database to be rebuilt when
 // a new, incompatible change has been introduced to the database schema.
-static const int schemaVersion = 7;
+static const int schemaVersion = 8;
     
 void ApplicationCacheStorage::verifySchemaVersion()
 {
@@ -621,7 +627,7 @@ void ApplicationCacheStorage::openDatabase(bool createIfDoesNotExist)
     executeSQLCommand("CREATE TABLE IF NOT EXISTS CacheEntries (cache INTEGER NOT NULL ON CONFLICT FAIL, type INTEGER, resource INTEGER NOT NULL)");
     executeSQLCommand("CREATE TABLE IF NOT EXISTS CacheResources (id INTEGER PRIMARY KEY AUTOINCREMENT, url TEXT NOT NULL ON CONFLICT FAIL, "
                       "statusCode INTEGER NOT NULL, responseURL TEXT NOT NULL, mimeType TEXT, textEncodingName TEXT, headers TEXT, data INTEGER NOT NULL ON CONFLICT FAIL)");
-    executeSQLCommand("CREATE TABLE IF NOT EXISTS CacheResourceData (id INTEGER PRIMARY KEY AUTOINCREMENT, data BLOB, path TEXT)");
+    executeSQLCommand("CREATE TABLE IF NOT EXISTS CacheResourceData (id INTEGER PRIMARY KEY AUTOINCREMENT, data BLOB, path TEXT, size INTEGER)");
     executeSQLCommand("CREATE TABLE IF NOT EXISTS DeletedCacheResources (id INTEGER PRIMARY KEY AUTOINCREMENT, path TEXT)");
     executeSQLCommand("CREATE TABLE IF NOT EXISTS Origins (origin TEXT UNIQUE ON CONFLICT IGNORE, quota INTEGER NOT NULL ON CONFLICT FAIL)");
 
@@ -785,15 +791,19 @@ bool ApplicationCacheStorage::store(ApplicationCacheResource* resource, unsigned
         return false;
 
     // First, insert the data
-    SQLiteStatement dataStatement(m_database, "INSERT INTO CacheResourceData (data, path) VALUES (?, ?)");
+    SQLiteStatement dataStatement(m_database, "INSERT INTO CacheResourceData (data, path, size) VALUES (?, ?, ?)");
     if (dataStatement.prepare() != SQLResultOk)
         return false;
     
 
     String fullPath;
-    if (!resource->path().isEmpty())
+    if (!resource->path().isEmpty()) {
+        long long fileSize;
+        if (!getFileSize(resource->path(), fileSize))
+            return false;
         dataStatement.bindText(2, pathGetFileName(resource->path()));
-    else if (shouldStoreResourceAsFlatFile(resource)) {
+        dataStatement.bindInt64(3, fileSize);
+    } else if (shouldStoreResourceAsFlatFile(resource)) {
         // First, check to see if creating the flat file would violate the maximum total quota. We don't need
         // to check the per-origin quota here, as it was already checked in storeNewestCache().
         if (m_database.totalSize() + flatFileAreaSize() + resource->data()->size() > m_maximumSize) {
@@ -810,6 +820,7 @@ bool ApplicationCacheStorage::store(ApplicationCacheResource* resource, unsigned
         fullPath = pathByAppendingComponent(flatFileDirectory, path);
         resource->setPath(fullPath);
         dataStatement.bindText(2, path);
+        dataStatement.bindInt64(3, resource->data()->size());
     } else {
         if (resource->data()->size())
             dataStatement.bindBlob(1, resource->data()->data(), resource->data()->size());
@@ -1055,7 +1066,7 @@ static inline void parseHeaders(const String& headers, ResourceResponse& respons
 PassRefPtr<ApplicationCache> ApplicationCacheStorage::loadCache(unsigned storageID)
 {
     SQLiteStatement cacheStatement(m_database, 
-                                   "SELECT url, type, mimeType, textEncodingName, headers, CacheResourceData.data, CacheResourceData.path FROM CacheEntries INNER JOIN CacheResources ON CacheEntries.resource=CacheResources.id "
+                                   "SELECT url, type, mimeType, textEncodingName, headers, CacheResourceData.data, CacheResourceData.path, CacheResourceData.size FROM CacheEntries INNER JOIN CacheResources ON CacheEntries.resource=CacheResources.id "
                                    "INNER JOIN CacheResourceData ON CacheResourceData.id=CacheResources.data WHERE CacheEntries.cache=?");
     if (cacheStatement.prepare() != SQLResultOk) {
         LOG_ERROR("Could not prepare cache statement, error \"%s\"", m_database.lastErrorMsg());
@@ -1074,19 +1085,24 @@ PassRefPtr<ApplicationCache> ApplicationCacheStorage::loadCache(unsigned storage
         
         unsigned type = static_cast<unsigned>(cacheStatement.getColumnInt64(1));
 
-        Vector<char> blob;
-        cacheStatement.getColumnBlobAsVector(5, blob);
-        
-        RefPtr<SharedBuffer> data = SharedBuffer::adoptVector(blob);
-        
+        RefPtr<SharedBuffer> data;
         String path = cacheStatement.getColumnText(6);
-        long long size = 0;
-        if (path.isEmpty())
-            size = data->size();
-        else {
+        if (path.isEmpty()) {
+            Vector<char> blob;
+            cacheStatement.getColumnBlobAsVector(5, blob);
+            data = SharedBuffer::adoptVector(blob);
+        } else {
             path = pathByAppendingComponent(flatFileDirectory, path);
-            getFileSize(path, size);
+            data = SharedBuffer::createWithMappedFile(path);
+            // A missing or truncated flat file means the cache can no longer
+            // be served; let the group fetch it again rather than hand out
+            // partial resources.
+            if (!data || static_cast<long long>(data->size()) != cacheStatement.getColumnInt64(7)) {
+                LOG_ERROR("Application cache resource file %s is missing or has the wrong size", path.utf8().data());
+                return 0;
+            }
         }
+        long long size = data->size();
         
         String mimeType = cacheStatement.getColumnText(2);
         String textEncodingName = cacheStatement.getColumnText(3);
@@ -1225,7 +1241,8 @@ void ApplicationCacheStorage::deleteTables()
 bool ApplicationCacheStorage::shouldStoreResourceAsFlatFile(ApplicationCacheResource* resource)
 {
     return resource->response().mimeType().startsWith("audio/", false) 
-        || resource->response().mimeType().startsWith("video/", false);
+        || resource->response().mimeType().startsWith("video/", false)
+        || resource->data()->size() >= minimumFlatFileResourceSize;
 }
     
 bool ApplicationCacheStorage::writeDataToUniqueFileInDirectory(SharedBuffer* data, const String& directory, String& path)
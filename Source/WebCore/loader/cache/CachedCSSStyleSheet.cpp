@@ -40,6 +40,8 @@ namespace WebCore {
 CachedCSSStyleSheet::CachedCSSStyleSheet(const ResourceRequest& resourceRequest, const String& charset)
     : CachedResource(resourceRequest, CSSStyleSheet)
     , m_decoder(TextResourceDecoder::create("text/css", charset))
+    , m_decodedDataDeletionTimer(this, &CachedCSSStyleSheet::decodedDataDeletionTimerFired)
+    , m_incrementallyDecodedSize(0)
 {
     // Prefer text/css but accept any type (dell.com serves a stylesheet
     // as text/html; see <http://bugs.webkit.org/show_bug.cgi?id=11451>).
@@ -50,15 +52,25 @@ CachedCSSStyleSheet::~CachedCSSStyleSheet()
 {
 }
 
+void CachedCSSStyleSheet::load(CachedResourceLoader* cachedResourceLoader)
+{
+    CachedResource::load(cachedResourceLoader, true, DoSecurityCheck, true);
+}
+
 void CachedCSSStyleSheet::didAddClient(CachedResourceClient *c)
 {
+    if (m_decodedDataDeletionTimer.isActive())
+        m_decodedDataDeletionTimer.stop();
+
     if (!isLoading())
         c->setCSSStyleSheet(m_resourceRequest.url(), m_response.url(), m_decoder->encoding().name(), this);
 }
 
 void CachedCSSStyleSheet::allClientsRemoved()
 {
-    if (!MemoryCache::shouldMakeResourcePurgeableOnEviction() && isSafeToMakePurgeable())
+    if (double interval = memoryCache()->deadDecodedDataDeletionInterval())
+        m_decodedDataDeletionTimer.startOneShot(interval);
+    else if (!MemoryCache::shouldMakeResourcePurgeableOnEviction() && isSafeToMakePurgeable())
         makePurgeable(true);
 }
 
@@ -82,28 +94,48 @@ const String CachedCSSStyleSheet::sheetText(bool enforceMIMEType, bool* hasValid
     if (!m_decodedSheetText.isNull())
         return m_decodedSheetText;
     
-    // Don't cache the decoded text, regenerating is cheap and it can use quite a bit of memory
+    // The decoded text was dropped to save memory, regenerate it without keeping it around.
     String sheetText = m_decoder->decode(m_data->data(), m_data->size());
     sheetText += m_decoder->flush();
     return sheetText;
 }
 
+void CachedCSSStyleSheet::decodeReceivedData(SharedBuffer* data)
+{
+    // The buffer only ever grows while loading; anything else means we are looking at a new body.
+    if (data->size() < m_incrementallyDecodedSize) {
+        m_incrementallyDecodedText.clear();
+        m_incrementallyDecodedSize = 0;
+    }
+
+    const char* segment;
+    while (unsigned length = data->getSomeData(segment, m_incrementallyDecodedSize)) {
+        m_incrementallyDecodedText.append(m_decoder->decode(segment, length));
+        m_incrementallyDecodedSize += length;
+    }
+}
+
 void CachedCSSStyleSheet::data(PassRefPtr<SharedBuffer> data, bool allDataReceived)
 {
-    if (!allDataReceived)
+    if (!allDataReceived) {
+        if (data)
+            decodeReceivedData(data.get());
         return;
+    }
 
     m_data = data;
     setEncodedSize(m_data.get() ? m_data->size() : 0);
     // Decode the data to find out the encoding and keep the sheet text around during checkNotify()
     if (m_data) {
-        m_decodedSheetText = m_decoder->decode(m_data->data(), m_data->size());
-        m_decodedSheetText += m_decoder->flush();
+        decodeReceivedData(m_data.get());
+        m_incrementallyDecodedText.append(m_decoder->flush());
+        m_decodedSheetText = m_incrementallyDecodedText.toString();
     }
+    m_incrementallyDecodedText.clear();
+    m_incrementallyDecodedSize = 0;
+    setDecodedSize(m_decodedSheetText.length() * sizeof(UChar));
     setLoading(false);
     checkNotify();
-    // Clear the decoded text as it is unlikely to be needed immediately again and is cheap to regenerate.
-    m_decodedSheetText = String();
 }
 
 void CachedCSSStyleSheet::checkNotify()
@@ -118,12 +150,27 @@ void CachedCSSStyleSheet::checkNotify()
 
 void CachedCSSStyleSheet::error(CachedResource::Status status)
 {
+    m_incrementallyDecodedText.clear();
+    m_incrementallyDecodedSize = 0;
     setStatus(status);
     ASSERT(errorOccurred());
     setLoading(false);
     checkNotify();
 }
 
+void CachedCSSStyleSheet::destroyDecodedData()
+{
+    m_decodedSheetText = String();
+    setDecodedSize(0);
+    if (!MemoryCache::shouldMakeResourcePurgeableOnEviction() && isSafeToMakePurgeable())
+        makePurgeable(true);
+}
+
+void CachedCSSStyleSheet::decodedDataDeletionTimerFired(Timer<CachedCSSStyleSheet>*)
+{
+    destroyDecodedData();
+}
+
 bool CachedCSSStyleSheet::canUseSheet(bool enforceMIMEType, bool* hasValidMIMEType) const
 {
     if (errorOccurred())
@@ -28,7 +28,9 @@
 
 #include "CachedResource.h"
 #include "TextEncoding.h"
+#include "Timer.h"
 #include <wtf/Vector.h>
+#include <wtf/text/StringBuilder.h>
 
 namespace WebCore {
 
@@ -42,6 +44,7 @@ namespace WebCore {
 
         const String sheetText(bool enforceMIMEType = true, bool* hasValidMIMEType = 0) const;
 
+        virtual void load(CachedResourceLoader*);
         virtual void didAddClient(CachedResourceClient*);
         
         virtual void allClientsRemoved();
@@ -50,16 +53,27 @@ namespace WebCore {
         virtual String encoding() const;
         virtual void data(PassRefPtr<SharedBuffer> data, bool allDataReceived);
         virtual void error(CachedResource::Status);
+        virtual void destroyDecodedData();
 
         void checkNotify();
     
     private:
         bool canUseSheet(bool enforceMIMEType, bool* hasValidMIMEType) const;
+        void decodeReceivedData(SharedBuffer*);
+        void decodedDataDeletionTimerFired(Timer<CachedCSSStyleSheet>*);
         virtual PurgePriority purgePriority() const { return PurgeLast; }
 
     protected:
         RefPtr<TextResourceDecoder> m_decoder;
+        // Kept as decoded data so that documents attaching to the sheet later, e.g. after a
+        // navigation, skip decoding. The memory cache drops it under pressure.
         String m_decodedSheetText;
+        Timer<CachedCSSStyleSheet> m_decodedDataDeletionTimer;
+
+        // Text decoded so far while the sheet is still downloading, so that the decoding
+        // does not all happen at once when the last chunk arrives.
+        StringBuilder m_incrementallyDecodedText;
+        unsigned m_incrementallyDecodedSize;
     };
 
 }
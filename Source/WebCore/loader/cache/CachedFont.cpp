@@ -43,6 +43,11 @@
 
 #ifdef STORE_FONT_CUSTOM_PLATFORM_DATA
 #include "FontCustomPlatformData.h"
+#if PLATFORM(ANDROID)
+#include "CachedResourceHandle.h"
+#include "FontDecoder.h"
+#include "WOFFFileFormat.h"
+#endif
 #endif
 
 #if ENABLE(SVG_FONTS)
@@ -55,10 +60,34 @@
 
 namespace WebCore {
 
+#if PLATFORM(ANDROID) && defined(STORE_FONT_CUSTOM_PLATFORM_DATA)
+// Holds a handle on the font so the memory cache can't delete it while its
+// file is being decoded.
+class CachedFontDecoderClient : public FontDecoder::Client {
+public:
+    CachedFontDecoderClient(CachedFont* font)
+        : m_font(font)
+    {
+    }
+
+    virtual void fontDecoded(FontCustomPlatformData* fontData)
+    {
+        m_font->fontDecoded(fontData);
+    }
+
+private:
+    CachedResourceHandle<CachedFont> m_font;
+};
+#endif
+
 CachedFont::CachedFont(const ResourceRequest& resourceRequest)
     : CachedResource(resourceRequest, FontResource)
     , m_fontData(0)
     , m_loadInitiated(false)
+#if PLATFORM(ANDROID)
+    , m_decodingFontData(false)
+    , m_fontDataIsWOFF(false)
+#endif
 {
 }
 
@@ -88,10 +117,41 @@ void CachedFont::data(PassRefPtr<SharedBuffer> data, bool allDataReceived)
 
     m_data = data;     
     setEncodedSize(m_data.get() ? m_data->size() : 0);
+#if PLATFORM(ANDROID) && defined(STORE_FONT_CUSTOM_PLATFORM_DATA)
+    // Keep the font loading, and text set in it on its fallback, until the
+    // decoding thread has the typeface ready; the decoder gets its own copy
+    // of the file as SharedBuffer isn't thread safe.
+    if (m_data && !m_fontData && !m_decodingFontData) {
+        m_decodingFontData = true;
+        FontDecoder::decode(SharedBuffer::create(m_data->data(), m_data->size()),
+                            adoptPtr(new CachedFontDecoderClient(this)));
+        return;
+    }
+#endif
     setLoading(false);
     checkNotify();
 }
 
+#if PLATFORM(ANDROID)
+void CachedFont::fontDecoded(FontCustomPlatformData* fontData)
+{
+#ifdef STORE_FONT_CUSTOM_PLATFORM_DATA
+    m_decodingFontData = false;
+    // A file Skia can't read may still be an SVG font, so a failure is left
+    // for ensureCustomFontData() to report as before.
+    if (fontData && !m_fontData) {
+        m_fontData = fontData;
+#if !ENABLE(OPENTYPE_SANITIZER)
+        m_fontDataIsWOFF = m_data && isWOFF(m_data.get());
+#endif
+    } else
+        delete fontData;
+    setLoading(false);
+    checkNotify();
+#endif
+}
+#endif
+
 void CachedFont::beginLoadIfNeeded(CachedResourceLoader* dl)
 {
     if (!m_loadInitiated) {
@@ -103,6 +163,15 @@ void CachedFont::beginLoadIfNeeded(CachedResourceLoader* dl)
 bool CachedFont::ensureCustomFontData(bool woffEnabled)
 {
 #ifdef STORE_FONT_CUSTOM_PLATFORM_DATA
+#if PLATFORM(ANDROID)
+    // The decoding thread always unpacks WOFF files.
+    if (m_fontData && m_fontDataIsWOFF && !woffEnabled) {
+        delete m_fontData;
+        m_fontData = 0;
+        m_fontDataIsWOFF = false;
+        setStatus(DecodeError);
+    }
+#endif
     if (!m_fontData && !errorOccurred() && !isLoading() && m_data) {
         m_fontData = createFontCustomPlatformData(m_data.get(), woffEnabled);
         if (!m_fontData)
@@ -182,6 +251,9 @@ void CachedFont::allClientsRemoved()
         delete m_fontData;
         m_fontData = 0;
     }
+#if PLATFORM(ANDROID)
+    m_fontDataIsWOFF = false;
+#endif
 #endif
 }
 
@@ -67,6 +67,12 @@ public:
     bool ensureCustomFontData(bool woffEnabled);
     FontPlatformData platformDataFromCustomData(float size, bool bold, bool italic, FontOrientation = Horizontal, TextOrientation = TextOrientationVerticalRight, FontWidthVariant = RegularWidth, FontRenderingMode = NormalRenderingMode);
 
+#if PLATFORM(ANDROID)
+    // Called by the font decoding thread's client once the downloaded file
+    // has been turned into a typeface, or failed to be.
+    void fontDecoded(FontCustomPlatformData*);
+#endif
+
 #if ENABLE(SVG_FONTS)
     bool ensureSVGFontData();
     SVGFontElement* getSVGFontById(const String&) const;
@@ -75,6 +81,10 @@ public:
 private:
     FontCustomPlatformData* m_fontData;
     bool m_loadInitiated;
+#if PLATFORM(ANDROID)
+    bool m_decodingFontData;
+    bool m_fontDataIsWOFF;
+#endif
 
 #if ENABLE(SVG_FONTS)
     RefPtr<SVGDocument> m_externalSVGDocument;
@@ -58,6 +58,9 @@ CachedImage::CachedImage(const ResourceRequest& resourceRequest)
     , m_decodedDataDeletionTimer(this, &CachedImage::decodedDataDeletionTimerFired)
     , m_shouldPaintBrokenImage(true)
     , m_autoLoadWasPreventedBySettings(false)
+#if PLATFORM(ANDROID)
+    , m_decodeAhead(false)
+#endif
 {
     setStatus(Unknown);
 }
@@ -68,6 +71,9 @@ CachedImage::CachedImage(Image* image)
     , m_decodedDataDeletionTimer(this, &CachedImage::decodedDataDeletionTimerFired)
     , m_shouldPaintBrokenImage(true)
     , m_autoLoadWasPreventedBySettings(false)
+#if PLATFORM(ANDROID)
+    , m_decodeAhead(false)
+#endif
 {
     setStatus(Cached);
     setLoading(false);
@@ -310,11 +316,28 @@ void CachedImage::data(PassRefPtr<SharedBuffer> data, bool allDataReceived)
     }
     
     if (allDataReceived) {
+#if PLATFORM(ANDROID)
+        if (m_decodeAhead && m_image)
+            m_image->decodeAhead(m_decodeAheadSize);
+#endif
         setLoading(false);
         checkNotify();
     }
 }
 
+#if PLATFORM(ANDROID)
+void CachedImage::setDecodeAhead(const IntSize& sizeHint)
+{
+    if (m_decodeAhead)
+        return;
+    m_decodeAhead = true;
+    m_decodeAheadSize = sizeHint;
+    // Already in the memory cache, no data left to wait for.
+    if (isLoaded() && !errorOccurred() && m_image)
+        m_image->decodeAhead(m_decodeAheadSize);
+}
+#endif
+
 void CachedImage::error(CachedResource::Status status)
 {
     checkShouldPaintBrokenImage();
@@ -88,6 +88,13 @@ public:
 
     void setAutoLoadWasPreventedBySettings(bool prevented) { m_autoLoadWasPreventedBySettings = prevented; }
 
+#if PLATFORM(ANDROID)
+    // Starts decoding the image as soon as all of its data is in, instead of
+    // when it is first painted. sizeHint is the size the markup says it will
+    // be drawn at, if any.
+    void setDecodeAhead(const IntSize& sizeHint);
+#endif
+
 private:
     void createImage();
     size_t maximumDecodedImageSize();
@@ -101,6 +108,10 @@ private:
     Timer<CachedImage> m_decodedDataDeletionTimer;
     bool m_shouldPaintBrokenImage;
     bool m_autoLoadWasPreventedBySettings;
+#if PLATFORM(ANDROID)
+    bool m_decodeAhead;
+    IntSize m_decodeAheadSize;
+#endif
 };
 
 }
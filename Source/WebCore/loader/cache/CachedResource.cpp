@@ -378,7 +378,7 @@ void CachedResource::setDecodedSize(unsigned size)
             memoryCache()->removeFromLiveDecodedResourcesList(this);
 
         // Update the cache's size totals.
-        memoryCache()->adjustSize(hasClients(), delta);
+        memoryCache()->adjustSize(this, delta);
     }
 }
 
@@ -405,7 +405,7 @@ void CachedResource::setEncodedSize(unsigned size)
         memoryCache()->insertInLRUList(this);
         
         // Update the cache's size totals.
-        memoryCache()->adjustSize(hasClients(), delta);
+        memoryCache()->adjustSize(this, delta);
     }
 }
 
@@ -72,6 +72,17 @@ static void SaveSubURL(CachedResourceLoader* cachedResourceLoader, CachedResourc
 #endif //  USE(CHROME_NETWORK_STACK)
 }
 
+#if PLATFORM(ANDROID) && ENABLE(LINK_PREFETCH)
+// Prefetch and prerender loads a document may have in flight at once, beyond
+// which further hints are ignored.
+static const size_t maxSpeculativeLoads = 2;
+
+static bool isSpeculativeType(CachedResource::Type type)
+{
+    return type == CachedResource::LinkPrefetch || type == CachedResource::LinkPrerender;
+}
+#endif
+
 static CachedResource* createResource(CachedResource::Type type, ResourceRequest& request, const String& charset)
 {
     switch (type) {
@@ -231,8 +242,36 @@ CachedResource* CachedResourceLoader::requestLinkResource(CachedResource::Type t
 {
     ASSERT(frame());
     ASSERT(type == CachedResource::LinkPrefetch || type == CachedResource::LinkPrerender || type == CachedResource::LinkSubresource);
+#if PLATFORM(ANDROID)
+    if (isSpeculativeType(type)) {
+        Vector<RefPtr<CachedResourceRequest> > inFlight;
+        speculativeRequests(inFlight);
+        if (inFlight.size() >= maxSpeculativeLoads)
+            return 0;
+    }
+#endif
     return requestResource(type, request, String(), priority);
 }
+
+#if PLATFORM(ANDROID)
+void CachedResourceLoader::speculativeRequests(Vector<RefPtr<CachedResourceRequest> >& requests) const
+{
+    RequestSet::const_iterator end = m_requests.end();
+    for (RequestSet::const_iterator it = m_requests.begin(); it != end; ++it) {
+        if (isSpeculativeType((*it)->cachedResource()->type()))
+            requests.append(*it);
+    }
+}
+
+void CachedResourceLoader::cancelSpeculativeLoads()
+{
+    // Cancelling removes the request from m_requests, so take them out first.
+    Vector<RefPtr<CachedResourceRequest> > requests;
+    speculativeRequests(requests);
+    for (size_t i = 0; i < requests.size(); ++i)
+        requests[i]->cancel();
+}
+#endif
 #endif
 
 bool CachedResourceLoader::canRequest(CachedResource::Type type, const KURL& url)
@@ -727,6 +766,18 @@ void CachedResourceLoader::preload(CachedResource::Type type, ResourceRequest& r
     requestPreload(type, request, charset);
 }
 
+#if PLATFORM(ANDROID)
+void CachedResourceLoader::preloadCriticalImage(ResourceRequest& request, const IntSize& sizeHint)
+{
+    // Unlike other image preloads these don't wait for something to be
+    // drawn, the first paint is waiting on them.
+    requestPreload(CachedResource::ImageResource, request, String(), ResourceLoadPriorityMedium);
+    CachedResource* resource = cachedResource(request.url());
+    if (resource && resource->type() == CachedResource::ImageResource)
+        static_cast<CachedImage*>(resource)->setDecodeAhead(sizeHint);
+}
+#endif
+
 void CachedResourceLoader::checkForPendingPreloads() 
 {
     if (m_pendingPreloads.isEmpty() || !m_document->body() || !m_document->body()->renderer())
@@ -740,13 +791,13 @@ void CachedResourceLoader::checkForPendingPreloads()
     m_pendingPreloads.clear();
 }
 
-void CachedResourceLoader::requestPreload(CachedResource::Type type, ResourceRequest& request, const String& charset)
+void CachedResourceLoader::requestPreload(CachedResource::Type type, ResourceRequest& request, const String& charset, ResourceLoadPriority priority)
 {
     String encoding;
     if (type == CachedResource::Script || type == CachedResource::CSSStyleSheet)
         encoding = charset.isEmpty() ? m_document->charset() : charset;
 
-    CachedResource* resource = requestResource(type, request, encoding, ResourceLoadPriorityUnresolved, true);
+    CachedResource* resource = requestResource(type, request, encoding, priority, true);
     if (!resource || (m_preloads && m_preloads->contains(resource)))
         return;
     resource->increasePreloadCount();
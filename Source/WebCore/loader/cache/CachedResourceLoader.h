@@ -48,6 +48,7 @@ class CachedXSLStyleSheet;
 class Document;
 class Frame;
 class ImageLoader;
+class IntSize;
 class KURL;
 
 // The CachedResourceLoader manages the loading of scripts/images/stylesheets for a single document.
@@ -70,6 +71,12 @@ public:
 #endif
 #if ENABLE(LINK_PREFETCH)
     CachedResource* requestLinkResource(CachedResource::Type, ResourceRequest&, ResourceLoadPriority = ResourceLoadPriorityUnresolved);
+#if PLATFORM(ANDROID)
+    // Prefetches and prerenders only pay off if the user follows the link, so
+    // few are allowed at a time and they are the first loads given up when
+    // memory runs short.
+    void cancelSpeculativeLoads();
+#endif
 #endif
 
     // Logs an access denied message to the console for the specified URL.
@@ -111,6 +118,11 @@ public:
     void clearPreloads();
     void clearPendingPreloads();
     void preload(CachedResource::Type, ResourceRequest&, const String& charset, bool referencedFromBody);
+#if PLATFORM(ANDROID)
+    // For the images the first paint is likely to show: fetched right away
+    // at a higher priority, and decoded as soon as they arrive.
+    void preloadCriticalImage(ResourceRequest&, const IntSize& sizeHint);
+#endif
     void checkForPendingPreloads();
     void printPreloadStats();
     
@@ -118,7 +130,7 @@ private:
     CachedResource* requestResource(CachedResource::Type, ResourceRequest&, const String& charset, ResourceLoadPriority = ResourceLoadPriorityUnresolved, bool isPreload = false);
     CachedResource* revalidateResource(CachedResource*, ResourceLoadPriority priority);
     CachedResource* loadResource(CachedResource::Type, ResourceRequest&, const String& charset, ResourceLoadPriority);
-    void requestPreload(CachedResource::Type, ResourceRequest& url, const String& charset);
+    void requestPreload(CachedResource::Type, ResourceRequest& url, const String& charset, ResourceLoadPriority = ResourceLoadPriorityUnresolved);
 
     enum RevalidationPolicy { Use, Revalidate, Reload, Load };
     RevalidationPolicy determineRevalidationPolicy(CachedResource::Type, bool forPreload, CachedResource* existingResource) const;
@@ -129,6 +141,10 @@ private:
     void loadDoneActionTimerFired(Timer<CachedResourceLoader>*);
 
     void performPostLoadActions();
+
+#if PLATFORM(ANDROID) && ENABLE(LINK_PREFETCH)
+    void speculativeRequests(Vector<RefPtr<CachedResourceRequest> >&) const;
+#endif
     
     HashSet<String> m_validatedURLs;
     mutable DocumentResourceMap m_documentResources;
@@ -60,7 +60,13 @@ static ResourceRequest::TargetType cachedResourceTypeToTargetType(CachedResource
     case CachedResource::LinkPrefetch:
         return ResourceRequest::TargetIsPrefetch;
     case CachedResource::LinkPrerender:
+#if PLATFORM(ANDROID)
+        // There is no hidden page to prerender into, the document is fetched
+        // ahead of the navigation like any other prefetch.
+        return ResourceRequest::TargetIsPrefetch;
+#else
         return ResourceRequest::TargetIsSubresource;
+#endif
     case CachedResource::LinkSubresource:
         return ResourceRequest::TargetIsSubresource;
 #endif
@@ -42,6 +42,11 @@ namespace WebCore {
         void didFail(bool cancelled = false);
 
         CachedResourceLoader* cachedResourceLoader() const { return m_cachedResourceLoader; }
+#if PLATFORM(ANDROID)
+        CachedResource* cachedResource() const { return m_resource; }
+        // Stops the network load; the resource's clients see it fail.
+        void cancel() { if (m_loader) m_loader->cancel(); }
+#endif
 
     private:
         CachedResourceRequest(CachedResourceLoader*, CachedResource*, bool incremental);
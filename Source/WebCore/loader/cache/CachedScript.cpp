@@ -44,6 +44,7 @@ CachedScript::CachedScript(const ResourceRequest& resourceRequest, const String&
     : CachedResource(resourceRequest, Script)
     , m_decoder(TextResourceDecoder::create("application/javascript", charset))
     , m_decodedDataDeletionTimer(this, &CachedScript::decodedDataDeletionTimerFired)
+    , m_incrementallyDecodedSize(0)
 {
     // It's javascript we want.
     // But some websites think their scripts are <some wrong mimetype here>
@@ -55,6 +56,11 @@ CachedScript::~CachedScript()
 {
 }
 
+void CachedScript::load(CachedResourceLoader* cachedResourceLoader)
+{
+    CachedResource::load(cachedResourceLoader, true, DoSecurityCheck, true);
+}
+
 void CachedScript::didAddClient(CachedResourceClient* c)
 {
     if (m_decodedDataDeletionTimer.isActive())
@@ -93,19 +99,47 @@ const String& CachedScript::script()
     return m_script;
 }
 
+void CachedScript::decodeReceivedData(SharedBuffer* data)
+{
+    // The buffer only ever grows while loading; anything else means we are looking at a new body.
+    if (data->size() < m_incrementallyDecodedSize) {
+        m_incrementallyDecodedScript.clear();
+        m_incrementallyDecodedSize = 0;
+    }
+
+    const char* segment;
+    while (unsigned length = data->getSomeData(segment, m_incrementallyDecodedSize)) {
+        m_incrementallyDecodedScript.append(m_decoder->decode(segment, length));
+        m_incrementallyDecodedSize += length;
+    }
+}
+
 void CachedScript::data(PassRefPtr<SharedBuffer> data, bool allDataReceived)
 {
-    if (!allDataReceived)
+    if (!allDataReceived) {
+        if (data)
+            decodeReceivedData(data.get());
         return;
+    }
 
     m_data = data;
     setEncodedSize(m_data.get() ? m_data->size() : 0);
+    if (m_data) {
+        decodeReceivedData(m_data.get());
+        m_incrementallyDecodedScript.append(m_decoder->flush());
+        m_script = m_incrementallyDecodedScript.toString();
+        setDecodedSize(m_script.length() * sizeof(UChar));
+    }
+    m_incrementallyDecodedScript.clear();
+    m_incrementallyDecodedSize = 0;
     setLoading(false);
     checkNotify();
 }
 
 void CachedScript::error(CachedResource::Status status)
 {
+    m_incrementallyDecodedScript.clear();
+    m_incrementallyDecodedSize = 0;
     setStatus(status);
     ASSERT(errorOccurred());
     setLoading(false);
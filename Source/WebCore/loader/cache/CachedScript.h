@@ -28,6 +28,7 @@
 
 #include "CachedResource.h"
 #include "Timer.h"
+#include <wtf/text/StringBuilder.h>
 
 #if USE(JSC)
 namespace JSC {
@@ -47,6 +48,7 @@ namespace WebCore {
 
         const String& script();
 
+        virtual void load(CachedResourceLoader*);
         virtual void didAddClient(CachedResourceClient*);
         virtual void allClientsRemoved();
 
@@ -63,11 +65,17 @@ namespace WebCore {
 #endif
     private:
         void decodedDataDeletionTimerFired(Timer<CachedScript>*);
+        void decodeReceivedData(SharedBuffer*);
         virtual PurgePriority purgePriority() const { return PurgeLast; }
 
         String m_script;
         RefPtr<TextResourceDecoder> m_decoder;
         Timer<CachedScript> m_decodedDataDeletionTimer;
+
+        // Source decoded so far while the script is still downloading, so that it is
+        // ready to run as soon as the last chunk arrives.
+        StringBuilder m_incrementallyDecodedScript;
+        unsigned m_incrementallyDecodedSize;
 #if USE(JSC)        
         mutable OwnPtr<JSC::SourceProviderCache> m_sourceProviderCache;
 #endif
@@ -56,6 +56,17 @@ static const double cMinDelayBeforeLiveDecodedPrune = 1; // Seconds.
 static const float cTargetPrunePercentage = .95f; // Percentage of capacity toward which we prune, to avoid immediately pruning again.
 static const double cDefaultDecodedDataDeletionInterval = 0;
 
+#if PLATFORM(ANDROID)
+// Share of the dead capacity that pruning leaves to each type of resource
+// before evicting it, indexed by CachedResource::Type.
+static const float cDeadReservePercentage[] = {
+    0,    // ImageResource
+    .15f, // CSSStyleSheet
+    .15f, // Script
+    .05f  // FontResource
+};
+#endif
+
 MemoryCache* memoryCache()
 {
     static MemoryCache* staticCache = new MemoryCache;
@@ -73,6 +84,11 @@ MemoryCache::MemoryCache()
     , m_liveSize(0)
     , m_deadSize(0)
 {
+#if PLATFORM(ANDROID)
+    COMPILE_ASSERT(sizeof(cDeadReservePercentage) / sizeof(cDeadReservePercentage[0]) == cTrackedTypeCount, reserve_for_each_tracked_type);
+    for (int i = 0; i < cTrackedTypeCount; i++)
+        m_deadSizeForType[i] = 0;
+#endif
 }
 
 KURL MemoryCache::removeFragmentIdentifierIfNeeded(const KURL& originalURL)
@@ -121,7 +137,7 @@ void MemoryCache::revalidationSucceeded(CachedResource* revalidatingResource, co
     if (resource->decodedSize() && resource->hasClients())
         insertInLiveDecodedResourcesList(resource);
     if (delta)
-        adjustSize(resource->hasClients(), delta);
+        adjustSize(resource, delta);
     
     revalidatingResource->switchClientsToRevalidatedResource();
     // this deletes the revalidating resource
@@ -147,7 +163,7 @@ CachedResource* MemoryCache::resourceForURL(const KURL& resourceURL)
     }
     // Add the size back since we had subtracted it when we marked the memory as purgeable.
     if (wasPurgeable)
-        adjustSize(resource->hasClients(), resource->size());
+        adjustSize(resource, resource->size());
     return resource;
 }
 
@@ -222,7 +238,9 @@ void MemoryCache::pruneDeadResources()
     unsigned targetSize = static_cast<unsigned>(capacity * cTargetPrunePercentage); // Cut by a percentage to avoid immediately pruning again.
     int size = m_allResources.size();
     
-    if (!m_inPruneDeadResources) {
+    // Only resources made purgeable on eviction can have been purged, don't
+    // walk every LRU list looking for them otherwise.
+    if (!m_inPruneDeadResources && shouldMakeResourcePurgeableOnEviction()) {
         // See if we have any purged resources we can evict.
         for (int i = 0; i < size; i++) {
             CachedResource* current = m_allResources[i].m_tail;
@@ -240,9 +258,20 @@ void MemoryCache::pruneDeadResources()
             return;
     }
     
-    bool canShrinkLRULists = true;
     m_inPruneDeadResources = true;
-    for (int i = size - 1; i >= 0; i--) {
+#if PLATFORM(ANDROID)
+    // Leave each type its reserved share of the dead capacity first, and
+    // only evict from the reserves if that wasn't enough.
+    if (pruneDeadResourcesToSize(targetSize, true))
+        return;
+#endif
+    pruneDeadResourcesToSize(targetSize, false);
+}
+
+bool MemoryCache::pruneDeadResourcesToSize(unsigned targetSize, bool keepReserves)
+{
+    bool canShrinkLRULists = true;
+    for (int i = m_allResources.size() - 1; i >= 0; i--) {
         // Remove from the tail, since this is the least frequently accessed of the objects.
         CachedResource* current = m_allResources[i].m_tail;
         
@@ -257,7 +286,7 @@ void MemoryCache::pruneDeadResources()
                 
                 if (targetSize && m_deadSize <= targetSize) {
                     m_inPruneDeadResources = false;
-                    return;
+                    return true;
                 }
             }
             current = prev;
@@ -267,18 +296,22 @@ void MemoryCache::pruneDeadResources()
         current = m_allResources[i].m_tail;
         while (current) {
             CachedResource* prev = current->m_prevInAllResourcesList;
-            if (!current->hasClients() && !current->isPreloaded() && !current->isCacheValidator()) {
+            if (!current->hasClients() && !current->isPreloaded() && !current->isCacheValidator()
+#if PLATFORM(ANDROID)
+                && !(keepReserves && isInDeadReserve(current))
+#endif
+                ) {
                 if (!makeResourcePurgeable(current))
                     evict(current);
 
                 // If evict() caused pruneDeadResources() to be re-entered, bail out. This can happen when removing an
                 // SVG CachedImage that has subresources.
                 if (!m_inPruneDeadResources)
-                    return;
+                    return true;
 
                 if (targetSize && m_deadSize <= targetSize) {
                     m_inPruneDeadResources = false;
-                    return;
+                    return true;
                 }
             }
             current = prev;
@@ -291,7 +324,10 @@ void MemoryCache::pruneDeadResources()
         else if (canShrinkLRULists)
             m_allResources.resize(i);
     }
+    if (keepReserves)
+        return false;
     m_inPruneDeadResources = false;
+    return true;
 }
 
 void MemoryCache::setCapacities(unsigned minDeadBytes, unsigned maxDeadBytes, unsigned totalBytes)
@@ -321,7 +357,7 @@ bool MemoryCache::makeResourcePurgeable(CachedResource* resource)
     if (!resource->makePurgeable(true))
         return false;
 
-    adjustSize(resource->hasClients(), -static_cast<int>(resource->size()));
+    adjustSize(resource, -static_cast<int>(resource->size()));
 
     return true;
 }
@@ -344,7 +380,7 @@ void MemoryCache::evict(CachedResource* resource)
         // resource purgeable in makeResourcePurgeable(). So adjust the size if we are evicting a
         // resource that was not marked as purgeable.
         if (!MemoryCache::shouldMakeResourcePurgeableOnEviction() || !resource->isPurgeable())
-            adjustSize(resource->hasClients(), -static_cast<int>(resource->size()));
+            adjustSize(resource, -static_cast<int>(resource->size()));
     } else
         ASSERT(m_resources.get(resource->url()) != resource);
 
@@ -471,7 +507,7 @@ void MemoryCache::resourceAccessed(CachedResource* resource)
     
     // If this is the first time the resource has been accessed, adjust the size of the cache to account for its initial size.
     if (!resource->accessCount())
-        adjustSize(resource->hasClients(), resource->size());
+        adjustSize(resource, resource->size());
     
     // Add to our access count.
     resource->increaseAccessCount();
@@ -576,12 +612,18 @@ void MemoryCache::addToLiveResourcesSize(CachedResource* resource)
 {
     m_liveSize += resource->size();
     m_deadSize -= resource->size();
+#if PLATFORM(ANDROID)
+    adjustDeadSizeForType(resource, -static_cast<int>(resource->size()));
+#endif
 }
 
 void MemoryCache::removeFromLiveResourcesSize(CachedResource* resource)
 {
     m_liveSize -= resource->size();
     m_deadSize += resource->size();
+#if PLATFORM(ANDROID)
+    adjustDeadSizeForType(resource, resource->size());
+#endif
 }
 
 void MemoryCache::adjustSize(bool live, int delta)
@@ -595,6 +637,62 @@ void MemoryCache::adjustSize(bool live, int delta)
     }
 }
 
+void MemoryCache::adjustSize(CachedResource* resource, int delta)
+{
+    adjustSize(resource->hasClients(), delta);
+#if PLATFORM(ANDROID)
+    if (!resource->hasClients())
+        adjustDeadSizeForType(resource, delta);
+#endif
+}
+
+#if PLATFORM(ANDROID)
+void MemoryCache::adjustDeadSizeForType(CachedResource* resource, int delta)
+{
+    int type = resource->type();
+    if (type >= cTrackedTypeCount)
+        return;
+    ASSERT(delta >= 0 || ((int)m_deadSizeForType[type] + delta >= 0));
+    m_deadSizeForType[type] += delta;
+}
+
+unsigned MemoryCache::deadSizeForType(CachedResource::Type type) const
+{
+    return type < cTrackedTypeCount ? m_deadSizeForType[type] : 0;
+}
+
+unsigned MemoryCache::pruneToMinimum(bool includeLive)
+{
+    unsigned sizeBefore = m_liveSize + m_deadSize;
+    unsigned capacity = m_capacity;
+    unsigned minDeadCapacity = m_minDeadCapacity;
+    unsigned maxDeadCapacity = m_maxDeadCapacity;
+
+    // With no capacity left, both passes prune all they can.
+    m_capacity = 0;
+    m_minDeadCapacity = 0;
+    m_maxDeadCapacity = 0;
+    pruneDeadResources();
+    if (includeLive)
+        pruneLiveResources();
+
+    m_capacity = capacity;
+    m_minDeadCapacity = minDeadCapacity;
+    m_maxDeadCapacity = maxDeadCapacity;
+
+    unsigned sizeAfter = m_liveSize + m_deadSize;
+    return sizeBefore > sizeAfter ? sizeBefore - sizeAfter : 0;
+}
+
+bool MemoryCache::isInDeadReserve(CachedResource* resource) const
+{
+    int type = resource->type();
+    if (type >= cTrackedTypeCount)
+        return false;
+    return m_deadSizeForType[type] <= deadCapacity() * cDeadReservePercentage[type];
+}
+#endif
+
 void MemoryCache::TypeStatistic::addResource(CachedResource* o)
 {
     bool purged = o->wasPurged();
@@ -152,6 +152,7 @@ public:
 
     // Called to adjust the cache totals when a resource changes size.
     void adjustSize(bool live, int delta);
+    void adjustSize(CachedResource*, int delta);
 
     // Track decoded resources that are in the cache and referenced by a Web page.
     void insertInLiveDecodedResourcesList(CachedResource*);
@@ -176,6 +177,17 @@ public:
     unsigned getDeadSize() { return m_deadSize; }
 #endif
 
+#if PLATFORM(ANDROID)
+    // Bytes held by dead resources of the given type; only images, style
+    // sheets, scripts and fonts are tracked.
+    unsigned deadSizeForType(CachedResource::Type) const;
+
+    // Evicts every dead resource, and destroys the decoded data of the live
+    // ones if includeLive is set, keeping the configured capacities.
+    // Returns the bytes freed.
+    unsigned pruneToMinimum(bool includeLive);
+#endif
+
 
 private:
     MemoryCache();
@@ -191,6 +203,7 @@ private:
     unsigned deadCapacity() const;
     
     void pruneDeadResources(); // Flush decoded and encoded data from resources not referenced by Web pages.
+    bool pruneDeadResourcesToSize(unsigned targetSize, bool keepReserves); // Returns true once pruning is done.
     void pruneLiveResources(); // Flush decoded data from resources still referenced by Web pages.
 
     bool makeResourcePurgeable(CachedResource*);
@@ -208,6 +221,16 @@ private:
     unsigned m_liveSize; // The number of bytes currently consumed by "live" resources in the cache.
     unsigned m_deadSize; // The number of bytes currently consumed by "dead" resources in the cache.
 
+#if PLATFORM(ANDROID)
+    // Dead bytes per resource type, so that pruning can keep a share of the
+    // dead capacity for the style sheets, scripts and fonts a page needs
+    // instead of letting a few large images push all of them out.
+    static const int cTrackedTypeCount = CachedResource::FontResource + 1;
+    void adjustDeadSizeForType(CachedResource*, int delta);
+    bool isInDeadReserve(CachedResource*) const;
+    unsigned m_deadSizeForType[cTrackedTypeCount];
+#endif
+
     // Size-adjusted and popularity-aware LRU list collection for cache objects.  This collection can hold
     // more resources than the cached resource map, since it can also hold "stale" multiple versions of objects that are
     // waiting to die when the clients referencing them go away.
@@ -149,8 +149,9 @@ void IconDatabase::close()
 {
 #ifdef ANDROID
     // Since we close and reopen the database within the same process, reset
-    // this flag
+    // these flags
     m_initialPruningComplete = false;
+    m_urlImportRequested = false;
 #endif
     ASSERT_NOT_SYNC_THREAD();
     
@@ -214,6 +215,9 @@ void IconDatabase::removeAllIcons()
     }
     
     m_removeIconsRequested = true;
+#ifdef ANDROID
+    requestURLImport();
+#endif
     wakeSyncThread();
 }
 
@@ -669,6 +673,9 @@ IconLoadDecision IconDatabase::synchronousLoadDecisionForIconURL(const String& i
     LOG(IconDatabase, "Don't know if we should load %s or not - adding %p to the set of document loaders waiting on a decision", iconURL.ascii().data(), notificationDocumentLoader);
     if (notificationDocumentLoader)
         m_loadersPendingDecision.add(notificationDocumentLoader);    
+#ifdef ANDROID
+    requestURLImport();
+#endif
 
     return IconLoadUnknown;
 }
@@ -771,6 +778,9 @@ IconDatabase::IconDatabase()
     , m_removeIconsRequested(false)
     , m_iconURLImportComplete(false)
     , m_disabledSuddenTerminationForSyncThread(false)
+#ifdef ANDROID
+    , m_urlImportRequested(false)
+#endif
     , m_initialPruningComplete(false)
     , m_client(defaultClient())
     , m_imported(false)
@@ -824,6 +834,17 @@ void IconDatabase::wakeSyncThread()
     m_syncCondition.signal();
 }
 
+#ifdef ANDROID
+void IconDatabase::requestURLImport()
+{
+    MutexLocker locker(m_syncLock);
+    if (m_urlImportRequested)
+        return;
+    m_urlImportRequested = true;
+    m_syncCondition.signal();
+}
+#endif
+
 void IconDatabase::scheduleOrDeferSyncTimer()
 {
     ASSERT_NOT_SYNC_THREAD();
@@ -832,6 +853,12 @@ void IconDatabase::scheduleOrDeferSyncTimer()
         // The following is balanced by the call to enableSuddenTermination in the
         // syncTimerFired function.
         disableSuddenTermination();
+#ifdef ANDROID
+    } else {
+        // Let a steady stream of icon changes be written out once per
+        // interval, rather than deferring the write until the stream stops.
+        return;
+#endif
     }
 
     m_syncTimer.startOneShot(updateTimerDelay);
@@ -840,6 +867,10 @@ void IconDatabase::scheduleOrDeferSyncTimer()
 void IconDatabase::syncTimerFired(Timer<IconDatabase>*)
 {
     ASSERT_NOT_SYNC_THREAD();
+#ifdef ANDROID
+    // There is something to write, which can't happen before the import.
+    requestURLImport();
+#endif
     wakeSyncThread();
 
     // The following is balanced by the call to disableSuddenTermination in the
@@ -897,6 +928,9 @@ PageURLRecord* IconDatabase::getOrCreatePageURLRecord(const String& pageURL)
     
     MutexLocker locker(m_pendingReadingLock);
     if (!m_iconURLImportComplete) {
+#ifdef ANDROID
+        requestURLImport();
+#endif
         // If the initial import of all URLs hasn't completed and we have no page record, we assume we *might* know about this later and create a record for it
         if (!pageRecord) {
             LOG(IconDatabase, "Creating new PageURLRecord for pageURL %s", urlForLogging(pageURL).ascii().data());
@@ -1035,6 +1069,18 @@ void* IconDatabase::iconDatabaseSyncThread()
     // Uncomment the following line to simulate a long lasting URL import (*HUGE* icon databases, or network home directories)
     // while (currentTime() - timeStamp < 10);
 
+#ifdef ANDROID
+    // Reading in every URL mapping is most of the start up I/O, so put it off
+    // until the first icon lookup or write.
+    {
+        MutexLocker locker(m_syncLock);
+        while (!m_urlImportRequested && !m_threadTerminationRequested)
+            m_syncCondition.wait(m_syncLock);
+    }
+    if (shouldStopThreadActivity())
+        return syncThreadMainLoop();
+#endif
+
     // Read in URL mappings from the database          
     LOG(IconDatabase, "(THREAD) Starting iconURL import");
     performURLImport();
@@ -121,6 +121,9 @@ private:
     void notifyPendingLoadDecisions();
 
     void wakeSyncThread();
+#ifdef ANDROID
+    void requestURLImport();
+#endif
     void scheduleOrDeferSyncTimer();
     void syncTimerFired(Timer<IconDatabase>*);
     
@@ -155,6 +158,11 @@ private:
     bool m_removeIconsRequested;
     bool m_iconURLImportComplete;
     bool m_disabledSuddenTerminationForSyncThread;
+#ifdef ANDROID
+    // Set, while holding m_syncLock, the first time anything needs the URL
+    // mappings. The sync thread doesn't read them in until then.
+    bool m_urlImportRequested;
+#endif
 
     Mutex m_urlAndIconLock;
     // Holding m_urlAndIconLock is required when accessing any of the following data structures or the objects they contain
@@ -3127,10 +3127,26 @@ bool EventHandler::handleTouchEvent(const PlatformTouchEvent& event)
         default:
             break;
         }
+        // Increment the platform touch id by 1 to avoid storing a key of 0 in the hashmap.
+        unsigned touchPointTargetKey = point.id() + 1;
+
+        // A moving touch keeps the target it started on, and its hit test is
+        // read-only, so skip hit testing once the target is known.
+        Node* originatingNode = 0;
+        if (pointState == PlatformTouchPoint::TouchMoved || pointState == PlatformTouchPoint::TouchStationary) {
+            if (EventTarget* originatingTarget = m_originatingTouchPointTargets.get(touchPointTargetKey).get()) {
+                originatingNode = originatingTarget->toNode();
+                if (originatingNode && !originatingNode->inDocument())
+                    originatingNode = 0;
+            }
+        }
+
 #if PLATFORM(ANDROID)
         Node* node = 0;
         if (m_capturingTouchEventsNode)
             node = m_capturingTouchEventsNode.get();
+        else if (originatingNode)
+            node = originatingNode;
         else {
             HitTestResult result = hitTestResultAtPoint(pagePoint, /*allowShadowContent*/ false, false, DontHitTestScrollbars, hitType);
             node = result.innerNode();
@@ -3141,13 +3157,16 @@ bool EventHandler::handleTouchEvent(const PlatformTouchEvent& event)
                 node = node->parentNode();
         }
 #else
-        HitTestResult result = hitTestResultAtPoint(pagePoint, /*allowShadowContent*/ false, false, DontHitTestScrollbars, hitType);
-        Node* node = result.innerNode();
-        ASSERT(node);
+        Node* node = originatingNode;
+        if (!node) {
+            HitTestResult result = hitTestResultAtPoint(pagePoint, /*allowShadowContent*/ false, false, DontHitTestScrollbars, hitType);
+            node = result.innerNode();
+            ASSERT(node);
 
-        // Touch events should not go to text nodes
-        if (node->isTextNode())
-            node = node->parentNode();
+            // Touch events should not go to text nodes
+            if (node->isTextNode())
+                node = node->parentNode();
+        }
 #endif
 
 
@@ -3165,8 +3184,6 @@ bool EventHandler::handleTouchEvent(const PlatformTouchEvent& event)
         int adjustedPageX = lroundf(pagePoint.x() / m_frame->pageZoomFactor());
         int adjustedPageY = lroundf(pagePoint.y() / m_frame->pageZoomFactor());
 
-        // Increment the platform touch id by 1 to avoid storing a key of 0 in the hashmap.
-        unsigned touchPointTargetKey = point.id() + 1;
         RefPtr<EventTarget> touchTarget;
 #if PLATFORM(ANDROID)
         if (m_capturingTouchEventsNode)
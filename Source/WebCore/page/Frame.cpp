@@ -150,6 +150,31 @@ static inline float parentTextZoomFactor(Frame* frame)
     return parent->textZoomFactor();
 }
 
+static void initializeNames()
+{
+    AtomicString::init();
+    HTMLNames::init();
+    QualifiedName::init();
+    MediaFeatureNames::init();
+    SVGNames::init();
+    XLinkNames::init();
+    MathMLNames::init();
+    XMLNSNames::init();
+    XMLNames::init();
+
+#if ENABLE(WML)
+    WMLNames::init();
+#endif
+}
+
+void Frame::initializeSharedNames()
+{
+    initializeNames();
+
+    // Lets parsers on other threads produce names that compare equal to these.
+    AtomicString::shareExistingAtoms();
+}
+
 inline Frame::Frame(Page* page, HTMLFrameOwnerElement* ownerElement, FrameLoaderClient* frameLoaderClient)
     : m_page(page)
     , m_treeNode(this, parentFromOwnerElement(ownerElement))
@@ -177,19 +202,7 @@ inline Frame::Frame(Page* page, HTMLFrameOwnerElement* ownerElement, FrameLoader
 #endif
 {
     ASSERT(page);
-    AtomicString::init();
-    HTMLNames::init();
-    QualifiedName::init();
-    MediaFeatureNames::init();
-    SVGNames::init();
-    XLinkNames::init();
-    MathMLNames::init();
-    XMLNSNames::init();
-    XMLNames::init();
-
-#if ENABLE(WML)
-    WMLNames::init();
-#endif
+    initializeNames();
 
     if (!ownerElement) {
 #if ENABLE(TILED_BACKING_STORE)
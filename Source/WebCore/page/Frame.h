@@ -83,6 +83,10 @@ namespace WebCore {
     public:
         static PassRefPtr<Frame> create(Page*, HTMLFrameOwnerElement*, FrameLoaderClient*);
 
+        // Initializes the tag, attribute and other names and shares them with
+        // every thread. Must be called before any other thread starts.
+        static void initializeSharedNames();
+
         void init();
         void setView(PassRefPtr<FrameView>);
         void createView(const IntSize&, const Color&, bool, const IntSize&, bool,
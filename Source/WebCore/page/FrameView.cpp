@@ -44,6 +44,7 @@
 #include "GraphicsContext.h"
 #include "HTMLDocument.h"
 #include "HTMLFrameElement.h"
+#include "HTMLFrameElementBase.h"
 #include "HTMLFrameSetElement.h"
 #include "HTMLNames.h"
 #include "HTMLPlugInImageElement.h"
@@ -67,6 +68,10 @@
 #include "TimeCounter.h"
 #endif
 
+#if PLATFORM(ANDROID)
+#include "TraceEventAndroid.h"
+#endif
+
 #if USE(ACCELERATED_COMPOSITING)
 #include "RenderLayerCompositor.h"
 #endif
@@ -219,6 +224,7 @@ void FrameView::reset()
     m_borderY = 30;
     m_layoutTimer.stop();
     m_layoutRoot = 0;
+    m_additionalLayoutRoots.clear();
     m_delayedLayout = false;
     m_doFullRepaint = true;
     m_layoutSchedulingEnabled = true;
@@ -794,6 +800,10 @@ void FrameView::layout(bool allowSubtree)
     if (m_inLayout)
         return;
 
+#if PLATFORM(ANDROID)
+    ANDROID_TRACE_EVENT("webcore", "FrameView::layout");
+#endif
+
     bool inSubframeLayoutWithFrameFlattening = parent() && m_frame->settings() && m_frame->settings()->frameFlatteningEnabled();
 
     if (inSubframeLayoutWithFrameFlattening) {
@@ -829,10 +839,8 @@ void FrameView::layout(bool allowSubtree)
 
     InspectorInstrumentationCookie cookie = InspectorInstrumentation::willLayout(m_frame.get());
 
-    if (!allowSubtree && m_layoutRoot) {
-        m_layoutRoot->markContainingBlocksForLayout(false);
-        m_layoutRoot = 0;
-    }
+    if (!allowSubtree && m_layoutRoot)
+        clearLayoutRoots();
 
     ASSERT(m_frame->view() == this);
 
@@ -1000,6 +1008,10 @@ void FrameView::layout(bool allowSubtree)
                                 subtree ? 0 : &cachedOffset);
     endDeferredRepaints();
 
+    if (subtree)
+        layoutAdditionalRoots();
+    m_additionalLayoutRoots.clear();
+
 #if USE(ACCELERATED_COMPOSITING)
     updateCompositingLayers();
 #endif
@@ -1514,6 +1526,11 @@ void FrameView::scrollPositionChanged()
 {
     frame()->eventHandler()->sendScrollEvent();
 
+    // Scrolling can happen while layout clamps the scroll position; the
+    // post-layout tasks pick up deferred frames in that case.
+    if (!m_nestedLayoutCount)
+        loadDeferredFramesNearViewport();
+
 #if USE(ACCELERATED_COMPOSITING)
     if (RenderView* root = m_frame->contentRenderer()) {
         if (root->usesCompositing())
@@ -1522,6 +1539,31 @@ void FrameView::scrollPositionChanged()
 #endif
 }
 
+void FrameView::loadDeferredFramesNearViewport()
+{
+    Document* document = m_frame->document();
+    if (!document || !document->hasDeferredFrameElements())
+        return;
+
+    IntRect nearViewport = visibleContentRect();
+    nearViewport.inflateX(nearViewport.width());
+    nearViewport.inflateY(nearViewport.height());
+
+    // Loading a frame can run script that adds or removes deferred frames, so
+    // collect the ones to load before starting any of them.
+    Vector<RefPtr<HTMLFrameElementBase> > framesToLoad;
+    const HashSet<HTMLFrameElementBase*>& deferred = document->deferredFrameElements();
+    HashSet<HTMLFrameElementBase*>::const_iterator end = deferred.end();
+    for (HashSet<HTMLFrameElementBase*>::const_iterator it = deferred.begin(); it != end; ++it) {
+        RenderObject* renderer = (*it)->renderer();
+        if (renderer && renderer->absoluteBoundingBoxRect().intersects(nearViewport))
+            framesToLoad.append(*it);
+    }
+
+    for (size_t i = 0; i < framesToLoad.size(); ++i)
+        framesToLoad[i]->loadDeferredFrame();
+}
+
 void FrameView::repaintFixedElementsAfterScrolling()
 {
     // For fixed position elements, update widget positions and compositing layers after scrolling,
@@ -1741,10 +1783,8 @@ void FrameView::scheduleRelayout()
     // too many false assertions.  See <rdar://problem/7218118>.
     ASSERT(m_frame->view() == this);
 
-    if (m_layoutRoot) {
-        m_layoutRoot->markContainingBlocksForLayout(false);
-        m_layoutRoot = 0;
-    }
+    if (m_layoutRoot)
+        clearLayoutRoots();
     if (!m_layoutSchedulingEnabled)
         return;
     if (!needsLayout())
@@ -1810,11 +1850,15 @@ void FrameView::scheduleRelayoutOfSubtree(RenderObject* relayoutRoot)
                 m_layoutRoot->markContainingBlocksForLayout(false, relayoutRoot);
                 m_layoutRoot = relayoutRoot;
                 ASSERT(!m_layoutRoot->container() || !m_layoutRoot->container()->needsLayout());
+                addAdditionalLayoutRoot(relayoutRoot);
+            } else if (m_layoutRoot && addAdditionalLayoutRoot(relayoutRoot)) {
+                // relayoutRoot is a separate relayout boundary; lay it out
+                // alongside the current root instead of the whole document.
+                ASSERT(!relayoutRoot->container() || !relayoutRoot->container()->needsLayout());
             } else {
                 // Just do a full relayout
                 if (m_layoutRoot)
-                    m_layoutRoot->markContainingBlocksForLayout(false);
-                m_layoutRoot = 0;
+                    clearLayoutRoots();
                 relayoutRoot->markContainingBlocksForLayout(false);
             }
         }
@@ -1827,6 +1871,98 @@ void FrameView::scheduleRelayoutOfSubtree(RenderObject* relayoutRoot)
     }
 }
 
+// Dashboards with many fixed-size widgets schedule several unrelated subtree
+// layouts between two layout timer fires. Keep a few of them as independent
+// roots rather than falling back to a full document layout.
+static const size_t maxAdditionalLayoutRoots = 16;
+
+bool FrameView::addAdditionalLayoutRoot(RenderObject* relayoutRoot)
+{
+    ASSERT(m_layoutRoot);
+
+    size_t i = 0;
+    while (i < m_additionalLayoutRoots.size()) {
+        RenderObject* root = m_additionalLayoutRoots[i];
+        if (root == relayoutRoot)
+            return true;
+        if (isObjectAncestorContainerOf(root, relayoutRoot)) {
+            relayoutRoot->markContainingBlocksForLayout(false, root);
+            return true;
+        }
+        if (isObjectAncestorContainerOf(relayoutRoot, root)) {
+            // relayoutRoot now covers this root as well.
+            root->markContainingBlocksForLayout(false, relayoutRoot);
+            m_additionalLayoutRoots.remove(i);
+            continue;
+        }
+        ++i;
+    }
+
+    // Called from the re-root case only to absorb the roots inside the new
+    // m_layoutRoot.
+    if (relayoutRoot == m_layoutRoot)
+        return true;
+
+    if (m_additionalLayoutRoots.size() >= maxAdditionalLayoutRoots)
+        return false;
+
+    m_additionalLayoutRoots.append(relayoutRoot);
+    return true;
+}
+
+void FrameView::clearLayoutRoots()
+{
+    m_layoutRoot->markContainingBlocksForLayout(false);
+    m_layoutRoot = 0;
+
+    for (size_t i = 0; i < m_additionalLayoutRoots.size(); ++i)
+        m_additionalLayoutRoots[i]->markContainingBlocksForLayout(false);
+    m_additionalLayoutRoots.clear();
+}
+
+void FrameView::layoutAdditionalRoots()
+{
+    // Roots scheduled while the first one was being laid out are dropped,
+    // just like m_layoutRoot is.
+    Vector<RenderObject*> roots;
+    roots.swap(m_additionalLayoutRoots);
+
+    for (size_t i = 0; i < roots.size(); ++i) {
+        RenderObject* root = roots[i];
+        if (!root->needsLayout())
+            continue;
+
+        // m_layoutRoot is what RenderBox::computeLogicalWidth() checks to leave
+        // the root's width alone, so point it at the root being laid out.
+        m_layoutRoot = root;
+        m_layoutSchedulingEnabled = false;
+
+        RenderView* view = root->view();
+        bool disableLayoutState = view->shouldDisableLayoutStateForSubtree(root);
+        view->pushLayoutState(root);
+        if (disableLayoutState)
+            view->disableLayoutState();
+
+        m_inLayout = true;
+        beginDeferredRepaints();
+        root->layout();
+        endDeferredRepaints();
+        m_inLayout = false;
+
+        view->popLayoutState(root);
+        if (disableLayoutState)
+            view->enableLayoutState();
+        m_layoutRoot = 0;
+        m_layoutSchedulingEnabled = true;
+
+        beginDeferredRepaints();
+        root->enclosingLayer()->updateLayerPositions(RenderLayer::CheckForRepaint
+                                                     | RenderLayer::IsCompositingUpdateRoot
+                                                     | RenderLayer::UpdateCompositingLayers);
+        endDeferredRepaints();
+    }
+}
+
 bool FrameView::layoutPending() const
 {
     return m_layoutTimer.isActive();
@@ -2069,6 +2205,8 @@ void FrameView::performPostLayoutTasks()
 
     scrollToAnchor();
 
+    loadDeferredFramesNearViewport();
+
     m_actionScheduler->resume();
 
     if (!root->printing()) {
@@ -165,6 +165,11 @@ public:
     void scrollPositionChangedViaPlatformWidget();
     virtual void repaintFixedElementsAfterScrolling();
 
+    // Starts the loads of deferred iframes that are now within a viewport of
+    // the visible content rect. Ports that scroll without going through
+    // scrollPositionChanged() call this once the new offset has settled.
+    void loadDeferredFramesNearViewport();
+
     String mediaType() const;
     void setMediaType(const String&);
     void adjustMediaTypeForPrinting(bool printing);
@@ -306,6 +311,10 @@ private:
 
     void performPostLayoutTasks();
 
+    bool addAdditionalLayoutRoot(RenderObject*);
+    void clearLayoutRoots();
+    void layoutAdditionalRoots();
+
     virtual void repaintContentRectangle(const IntRect&, bool immediate);
     virtual void contentsResized();
     virtual void visibleContentsResized();
@@ -376,6 +385,9 @@ private:
     Timer<FrameView> m_layoutTimer;
     bool m_delayedLayout;
     RenderObject* m_layoutRoot;
+    // Relayout boundaries outside m_layoutRoot that are waiting for the same
+    // subtree layout; see scheduleRelayoutOfSubtree().
+    Vector<RenderObject*> m_additionalLayoutRoots;
     
     bool m_layoutSchedulingEnabled;
     bool m_inLayout;
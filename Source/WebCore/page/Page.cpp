@@ -20,10 +20,12 @@
 #include "config.h"
 #include "Page.h"
 
+#include "AnimationController.h"
 #include "BackForwardController.h"
 #include "BackForwardList.h"
 #include "Base64.h"
 #include "CSSStyleSelector.h"
+#include "CachedResourceLoader.h"
 #include "Chrome.h"
 #include "ChromeClient.h"
 #include "ContextMenuClient.h"
@@ -99,6 +101,10 @@ namespace WebCore {
 
 static HashSet<Page*>* allPages;
 
+// Repeating timers on a page that is not being drawn only need to keep the
+// script alive, not to animate anything. Interval in seconds.
+static const double hiddenPageMinimumTimerInterval = 1.0;
+
 #ifndef NDEBUG
 static WTF::RefCountedLeakCounter pageCounter("Page");
 #endif
@@ -177,6 +183,7 @@ Page::Page(const PageClients& pageClients)
     , m_canStartMedia(true)
     , m_viewMode(ViewModeWindowed)
     , m_minimumTimerInterval(Settings::defaultMinDOMTimerInterval())
+    , m_isVisible(true)
     , m_isEditable(false)
 {
     if (!allPages) {
@@ -454,6 +461,22 @@ void Page::refreshPlugins(bool reload)
         framesNeedingReload[i]->loader()->reload();
 }
 
+#if PLATFORM(ANDROID) && ENABLE(LINK_PREFETCH)
+void Page::cancelSpeculativeLoadsForAllPages()
+{
+    if (!allPages)
+        return;
+
+    HashSet<Page*>::iterator end = allPages->end();
+    for (HashSet<Page*>::iterator it = allPages->begin(); it != end; ++it) {
+        for (Frame* frame = (*it)->mainFrame(); frame; frame = frame->tree()->traverseNext()) {
+            if (Document* document = frame->document())
+                document->cachedResourceLoader()->cancelSpeculativeLoads();
+        }
+    }
+}
+#endif
+
 PluginData* Page::pluginData() const
 {
     if (!mainFrame()->loader()->subframeLoader()->allowPlugins(NotAboutToInstantiatePlugin))
@@ -747,6 +770,24 @@ void Page::visitedStateChanged(PageGroup* group, LinkHash visitedLinkHash)
     }
 }
 
+void Page::visitedStateChanged(PageGroup* group, const HashSet<LinkHash, LinkHashHash>& visitedHashes)
+{
+    ASSERT(group);
+    if (!allPages || visitedHashes.isEmpty())
+        return;
+
+    HashSet<Page*>::iterator pagesEnd = allPages->end();
+    for (HashSet<Page*>::iterator it = allPages->begin(); it != pagesEnd; ++it) {
+        Page* page = *it;
+        if (page->m_group != group)
+            continue;
+        for (Frame* frame = page->m_mainFrame.get(); frame; frame = frame->tree()->traverseNext()) {
+            if (CSSStyleSelector* styleSelector = frame->document()->styleSelector())
+                styleSelector->visitedStateChanged(visitedHashes);
+        }
+    }
+}
+
 void Page::setDebuggerForAllPages(JSC::Debugger* debugger)
 {
     ASSERT(allPages);
@@ -846,7 +887,7 @@ bool Page::javaScriptURLsAreAllowed() const
 
 void Page::setMinimumTimerInterval(double minimumTimerInterval)
 {
-    double oldTimerInterval = m_minimumTimerInterval;
+    double oldTimerInterval = this->minimumTimerInterval();
     m_minimumTimerInterval = minimumTimerInterval;
     for (Frame* frame = mainFrame(); frame; frame = frame->tree()->traverseNextWithWrap(false)) {
         if (frame->document())
@@ -856,9 +897,32 @@ void Page::setMinimumTimerInterval(double minimumTimerInterval)
 
 double Page::minimumTimerInterval() const
 {
+    if (!m_isVisible)
+        return std::max(m_minimumTimerInterval, hiddenPageMinimumTimerInterval);
     return m_minimumTimerInterval;
 }
 
+void Page::setIsVisible(bool isVisible)
+{
+    if (m_isVisible == isVisible)
+        return;
+
+    double oldTimerInterval = minimumTimerInterval();
+    m_isVisible = isVisible;
+    for (Frame* frame = mainFrame(); frame; frame = frame->tree()->traverseNextWithWrap(false)) {
+        if (frame->document())
+            frame->document()->adjustMinimumTimerInterval(oldTimerInterval);
+    }
+
+    if (!mainFrame())
+        return;
+    // AnimationController walks the child frames itself.
+    if (isVisible)
+        mainFrame()->animation()->resumeAnimations();
+    else
+        mainFrame()->animation()->suspendAnimations();
+}
+
 #if ENABLE(INPUT_SPEECH)
 SpeechInput* Page::speechInput()
 {
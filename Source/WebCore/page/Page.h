@@ -91,6 +91,7 @@ namespace WebCore {
 #endif
 
     typedef uint64_t LinkHash;
+    struct LinkHashHash;
 
     enum FindDirection { FindDirectionForward, FindDirectionBackward };
 
@@ -136,6 +137,11 @@ namespace WebCore {
         void setCanStartMedia(bool);
         bool canStartMedia() const { return m_canStartMedia; }
 
+        // A hidden page keeps its DOM alive but is not drawn, so repeating
+        // timers are clamped harder and CSS animations are suspended.
+        void setIsVisible(bool);
+        bool isVisible() const { return m_isVisible; }
+
         EditorClient* editorClient() const { return m_editorClient; }
 
         void setMainFrame(PassRefPtr<Frame>);
@@ -257,9 +263,13 @@ namespace WebCore {
         JSC::Debugger* debugger() const { return m_debugger; }
 
         static void removeAllVisitedLinks();
+#if PLATFORM(ANDROID) && ENABLE(LINK_PREFETCH)
+        static void cancelSpeculativeLoadsForAllPages();
+#endif
 
         static void allVisitedStateChanged(PageGroup*);
         static void visitedStateChanged(PageGroup*, LinkHash visitedHash);
+        static void visitedStateChanged(PageGroup*, const HashSet<LinkHash, LinkHashHash>& visitedHashes);
 
         SharedGraphicsContext3D* sharedGraphicsContext3D();
 
@@ -403,6 +413,7 @@ namespace WebCore {
         ViewportArguments m_viewportArguments;
 
         double m_minimumTimerInterval;
+        bool m_isVisible;
 
         OwnPtr<ScrollableAreaSet> m_scrollableAreaSet;
 
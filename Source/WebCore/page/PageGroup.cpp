@@ -292,7 +292,24 @@ inline void PageGroup::addVisitedLink(LinkHash hash)
         return;
 #endif
     Page::visitedStateChanged(this, hash);
-    pageCache()->markPagesForVistedLinkStyleRecalc();
+    pageCache()->markPagesForVistedLinkStyleRecalc(hash);
+}
+
+void PageGroup::addVisitedLinkHashes(const Vector<LinkHash>& hashes)
+{
+    if (!shouldTrackVisitedLinks)
+        return;
+
+    HashSet<LinkHash, LinkHashHash> addedHashes;
+    for (size_t i = 0; i < hashes.size(); ++i) {
+#if !PLATFORM(CHROMIUM)
+        if (!m_visitedLinkHashes.add(hashes[i]).second)
+            continue;
+#endif
+        if (addedHashes.add(hashes[i]).second)
+            pageCache()->markPagesForVistedLinkStyleRecalc(hashes[i]);
+    }
+    Page::visitedStateChanged(this, addedHashes);
 }
 
 void PageGroup::addVisitedLink(const KURL& url)
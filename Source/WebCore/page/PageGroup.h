@@ -75,6 +75,9 @@ namespace WebCore {
         void addVisitedLink(const KURL&);
         void addVisitedLink(const UChar*, size_t);
         void addVisitedLinkHash(LinkHash);
+        // Adds many links at once, restyling each affected document once
+        // rather than once per link.
+        void addVisitedLinkHashes(const Vector<LinkHash>&);
         void removeVisitedLinks();
 
         static void setShouldTrackVisitedLinks(bool);
@@ -95,6 +95,9 @@ Settings::Settings(Page* page)
 #endif
     , m_pluginAllowedRunTime(numeric_limits<unsigned>::max())
     , m_editingBehaviorType(editingBehaviorTypeForPlatform())
+#if PLATFORM(ANDROID)
+    , m_webFontLoadTimeout(3)
+#endif
 #ifdef ANDROID_LAYOUT
     , m_layoutAlgorithm(kLayoutFitColumnToScreen)
 #endif
@@ -177,6 +180,7 @@ Settings::Settings(Page* page)
     , m_useQuickLookResourceCachingQuirks(false)
     , m_forceCompositingMode(false)
     , m_shouldInjectUserScriptsInInitialEmptyDocument(false)
+    , m_deferOffscreenFrameLoads(false)
 #ifdef ANDROID_LAYOUT
     , m_useWideViewport(false)
 #endif
@@ -186,6 +190,9 @@ Settings::Settings(Page* page)
 #ifdef ANDROID_BLOCK_NETWORK_IMAGE
     , m_blockNetworkImage(false)
 #endif
+#if PLATFORM(ANDROID)
+    , m_multiplexedLoadsEnabled(false)
+#endif
 #if ENABLE(WEB_AUTOFILL)
     , m_autoFillEnabled(false)
 #endif
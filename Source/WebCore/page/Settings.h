@@ -468,9 +468,26 @@ namespace WebCore {
         bool blockNetworkImage() const { return m_blockNetworkImage; }
 #endif
 
+#if PLATFORM(ANDROID)
+        // Lets subresources of hosts that answered over SPDY use more than
+        // the usual per-host connection count, since they share one session.
+        void setMultiplexedLoadsEnabled(bool flag) { m_multiplexedLoadsEnabled = flag; }
+        bool multiplexedLoadsEnabled() const { return m_multiplexedLoadsEnabled; }
+
+        // How long, in seconds, text set in a downloading web font stays
+        // invisible before it is painted with the fallback font instead.
+        void setWebFontLoadTimeout(double timeout) { m_webFontLoadTimeout = timeout; }
+        double webFontLoadTimeout() const { return m_webFontLoadTimeout; }
+#endif
+
         void setWOFFEnabled(bool);
         bool woffEnabled() const { return m_woffEnabled; }
 
+        // Postpones loading cross-origin iframes of the main frame until they
+        // are laid out within a viewport of the visible area.
+        void setDeferOffscreenFrameLoads(bool flag) { m_deferOffscreenFrameLoads = flag; }
+        bool deferOffscreenFrameLoads() const { return m_deferOffscreenFrameLoads; }
+
     private:
         Page* m_page;
 
@@ -497,6 +514,9 @@ namespace WebCore {
 #endif
         unsigned m_pluginAllowedRunTime;
         unsigned m_editingBehaviorType;
+#if PLATFORM(ANDROID)
+        double m_webFontLoadTimeout;
+#endif
 #ifdef ANDROID_META_SUPPORT
         // range is from 200 to 10,000. 0 is a special value means device-width.
         // default is -1, which means undefined.
@@ -592,6 +612,7 @@ namespace WebCore {
         bool m_forceCompositingMode : 1;
         bool m_shouldInjectUserScriptsInInitialEmptyDocument : 1;
         bool m_woffEnabled : 1;
+        bool m_deferOffscreenFrameLoads : 1;
 #ifdef ANDROID_META_SUPPORT
         // default is yes
         bool m_viewport_user_scalable : 1;
@@ -615,6 +636,9 @@ namespace WebCore {
 #ifdef ANDROID_BLOCK_NETWORK_IMAGE
         bool m_blockNetworkImage : 1;
 #endif
+#if PLATFORM(ANDROID)
+        bool m_multiplexedLoadsEnabled : 1;
+#endif
 #if ENABLE(WEB_AUTOFILL)
         bool m_autoFillEnabled: 1;
 #endif
@@ -255,12 +255,14 @@ void FinishArenaPool(ArenaPool *pool)
     FreeArenaList(pool, &pool->first, true);
 }
 
-#ifdef ANDROID_INSTRUMENT
-size_t ReportPoolSize(const ArenaPool* pool)
+#if PLATFORM(ANDROID)
+size_t ReportPoolSize(const ArenaPool* pool, bool includeFreeList)
 {
     size_t total = 0;
     for (const Arena *a = &pool->first; a; a = a->next)
         total += (a->limit - a->base);
+    if (!includeFreeList)
+        return total;
     for (const Arena *fa = arena_freelist; fa; fa = fa->next )
         total += (fa->limit - fa->base);
     return total;
@@ -134,8 +134,10 @@ void* ArenaAllocate(ArenaPool *pool, unsigned int nb);
          fastFree(a); \
          (a) = 0;
 
-#ifdef ANDROID_INSTRUMENT
-size_t ReportPoolSize(const ArenaPool* pool);
+#if PLATFORM(ANDROID)
+// The shared free list is not owned by any pool, leave it out to add up the
+// size of several pools.
+size_t ReportPoolSize(const ArenaPool* pool, bool includeFreeList = true);
 #endif
 
 }
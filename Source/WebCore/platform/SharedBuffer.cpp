@@ -27,9 +27,18 @@
 #include "config.h"
 #include "SharedBuffer.h"
 
+#include "FileSystem.h"
 #include "PurgeableBuffer.h"
 #include <wtf/PassOwnPtr.h>
 
+#if OS(UNIX)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <wtf/text/CString.h>
+#endif
+
 using namespace std;
 
 namespace WebCore {
@@ -57,6 +66,82 @@ static inline void freeSegment(char* p)
     fastFree(p);
 }
 
+#if OS(UNIX)
+
+class SharedBuffer::MappedFile {
+    WTF_MAKE_NONCOPYABLE(MappedFile); WTF_MAKE_FAST_ALLOCATED;
+public:
+    static PassOwnPtr<MappedFile> create(int fd, unsigned size)
+    {
+        void* data = mmap(0, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED)
+            return PassOwnPtr<MappedFile>();
+        return adoptPtr(new MappedFile(data, size));
+    }
+
+    ~MappedFile() { munmap(m_data, m_size); }
+
+    const char* data() const { return static_cast<const char*>(m_data); }
+    unsigned size() const { return m_size; }
+
+private:
+    MappedFile(void* data, unsigned size)
+        : m_data(data)
+        , m_size(size)
+    {
+    }
+
+    void* m_data;
+    unsigned m_size;
+};
+
+PassRefPtr<SharedBuffer> SharedBuffer::createWithMappedFile(const String& filePath)
+{
+    if (filePath.isEmpty())
+        return 0;
+
+    CString filename = fileSystemRepresentation(filePath);
+    int fd = open(filename.data(), O_RDONLY);
+    if (fd == -1)
+        return 0;
+
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) || fileStat.st_size != static_cast<unsigned>(fileStat.st_size)) {
+        close(fd);
+        return 0;
+    }
+
+    // mmap() refuses empty mappings.
+    if (!fileStat.st_size) {
+        close(fd);
+        return create();
+    }
+
+    OwnPtr<MappedFile> mappedFile = MappedFile::create(fd, fileStat.st_size);
+    close(fd);
+    if (!mappedFile)
+        return createWithContentsOfFile(filePath);
+
+    RefPtr<SharedBuffer> buffer = create();
+    buffer->m_mappedFile = mappedFile.release();
+    return buffer.release();
+}
+
+#else
+
+class SharedBuffer::MappedFile {
+public:
+    const char* data() const { return 0; }
+    unsigned size() const { return 0; }
+};
+
+PassRefPtr<SharedBuffer> SharedBuffer::createWithMappedFile(const String& filePath)
+{
+    return createWithContentsOfFile(filePath);
+}
+
+#endif
+
 SharedBuffer::SharedBuffer()
     : m_size(0)
 {
@@ -102,6 +187,9 @@ unsigned SharedBuffer::size() const
     
     if (m_purgeableBuffer)
         return m_purgeableBuffer->size();
+
+    if (m_mappedFile)
+        return m_mappedFile->size();
     
     return m_size;
 }
@@ -113,6 +201,9 @@ const char* SharedBuffer::data() const
     
     if (m_purgeableBuffer)
         return m_purgeableBuffer->data();
+
+    if (m_mappedFile)
+        return m_mappedFile->data();
     
     return buffer().data();
 }
@@ -122,6 +213,7 @@ void SharedBuffer::append(const char* data, unsigned length)
     ASSERT(!m_purgeableBuffer);
 
     maybeTransferPlatformData();
+    maybeTransferMappedFile();
     
     unsigned positionInSegment = offsetInSegment(m_size - m_buffer.size());
     m_size += length;
@@ -167,6 +259,7 @@ void SharedBuffer::clear()
 
     m_buffer.clear();
     m_purgeableBuffer.clear();
+    m_mappedFile.clear();
 #if HAVE(CFNETWORK_DATA_ARRAY_CALLBACK)
     m_dataArray.clear();
 #endif
@@ -175,7 +268,7 @@ void SharedBuffer::clear()
 PassRefPtr<SharedBuffer> SharedBuffer::copy() const
 {
     RefPtr<SharedBuffer> clone(adoptRef(new SharedBuffer));
-    if (m_purgeableBuffer || hasPlatformData()) {
+    if (m_purgeableBuffer || m_mappedFile || hasPlatformData()) {
         clone->append(data(), size());
         return clone;
     }
@@ -188,6 +281,17 @@ PassRefPtr<SharedBuffer> SharedBuffer::copy() const
     return clone;
 }
 
+void SharedBuffer::maybeTransferMappedFile()
+{
+    if (!m_mappedFile)
+        return;
+
+    // Appending needs writable storage, so the mapped contents become the
+    // start of an ordinary buffer.
+    OwnPtr<MappedFile> mappedFile = m_mappedFile.release();
+    append(mappedFile->data(), mappedFile->size());
+}
+
 PassOwnPtr<PurgeableBuffer> SharedBuffer::releasePurgeableBuffer()
 { 
     ASSERT(hasOneRef()); 
@@ -218,7 +322,7 @@ const Vector<char>& SharedBuffer::buffer() const
 
 unsigned SharedBuffer::getSomeData(const char*& someData, unsigned position) const
 {
-    if (hasPlatformData() || m_purgeableBuffer) {
+    if (hasPlatformData() || m_purgeableBuffer || m_mappedFile) {
         someData = data() + position;
         return size() - position;
     }
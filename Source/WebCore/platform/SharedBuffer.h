@@ -57,6 +57,12 @@ public:
 
     static PassRefPtr<SharedBuffer> createWithContentsOfFile(const String& filePath);
 
+    // Maps the file read-only instead of reading it, so its pages are only
+    // faulted in as they are used. The file must not be modified while the
+    // buffer is alive. Falls back to createWithContentsOfFile() on platforms
+    // that cannot map files.
+    static PassRefPtr<SharedBuffer> createWithMappedFile(const String& filePath);
+
     static PassRefPtr<SharedBuffer> adoptVector(Vector<char>& vector);
     
     // The buffer must be in non-purgeable state before adopted to a SharedBuffer. 
@@ -137,11 +143,15 @@ private:
     void clearPlatformData();
     void maybeTransferPlatformData();
     bool hasPlatformData() const;
+
+    class MappedFile;
+    void maybeTransferMappedFile();
     
     unsigned m_size;
     mutable Vector<char> m_buffer;
     mutable Vector<char*> m_segments;
     OwnPtr<PurgeableBuffer> m_purgeableBuffer;
+    OwnPtr<MappedFile> m_mappedFile;
 #if HAVE(CFNETWORK_DATA_ARRAY_CALLBACK)
     mutable Vector<RetainPtr<CFDataRef> > m_dataArray;
     void copyDataArrayAndClear(char *destination, unsigned bytesToCopy) const;
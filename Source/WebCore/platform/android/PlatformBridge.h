@@ -111,6 +111,11 @@ public:
     static NPObject* pluginScriptableObject(Widget*);
     // Popups
     static bool popupsAllowed(NPP);
+    // DNS
+    static void prefetchDNS(const String& hostname);
+    // Stores data alongside the disk cache entry for url, if the entry is
+    // still the response received at responseTime.
+    static void cacheMetadata(const KURL&, double responseTime, const Vector<char>&);
 
     // These ids need to be in sync with the constants in BrowserFrame.java
     enum rawResId {
@@ -149,6 +154,8 @@ public:
     static int memoryUsageMB();
     static int actualMemoryUsageMB();
     static bool canSatisfyMemoryAllocation(long bytes);
+    // Seconds since the user last interacted with any page
+    static double userIdleTime();
 
     static int screenWidthInDocCoord(const FrameView*);
     static int screenHeightInDocCoord(const FrameView*);
@@ -26,13 +26,15 @@
 #include "config.h"
 #include "SystemTime.h"
 
+#include "PlatformBridge.h"
+
 namespace WebCore {
 
 float userIdleTime()
 {
-    // return an arbitrarily high userIdleTime so that releasing pages from the
-    // page cache isn't postponed.
-    return 1000.0F;
+    // Releasing the pages evicted from the page cache is postponed while the
+    // user interacts with a page, the idle work releases them afterwards.
+    return PlatformBridge::userIdleTime();
 }
 
 }  // namespace WebCore
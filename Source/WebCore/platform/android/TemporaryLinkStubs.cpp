@@ -412,13 +412,7 @@ char* dirname(const char*)
     return 0;
 }
 
-    // new as of SVN change 38068, Nov 5, 2008
 namespace WebCore {
-void prefetchDNS(const String&)
-{
-    notImplemented();
-}
-
 PassRefPtr<Icon> Icon::createIconForFiles(const Vector<String>&)
 {
     notImplemented();
@@ -0,0 +1,186 @@
+/*
+ * Copyright 2012, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "TraceEventAndroid.h"
+
+#include <algorithm>
+#include <pthread.h>
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+#include <wtf/Threading.h>
+#include <wtf/Vector.h>
+#include <wtf/text/StringBuilder.h>
+#include <wtf/text/WTFString.h>
+
+namespace WebCore {
+
+namespace {
+
+struct TraceEventRecord {
+    const char* category;
+    const char* name;
+    long long timestampUs;
+    char phase;
+};
+
+// Only the owning thread writes. The slot is filled before m_count is
+// published, so a reader never looks at a slot that is being written,
+// unless the writer has wrapped all the way around to it.
+class TraceEventBuffer {
+public:
+    static const unsigned capacity = 16384;
+
+    TraceEventBuffer()
+        : m_count(0)
+        , m_threadId(gettid())
+    {
+    }
+
+    void append(const char* category, const char* name, long long timestampUs, char phase)
+    {
+        unsigned count = m_count;
+        TraceEventRecord& record = m_events[count & (capacity - 1)];
+        record.category = category;
+        record.name = name;
+        record.timestampUs = timestampUs;
+        record.phase = phase;
+        __sync_synchronize();
+        m_count = count + 1;
+    }
+
+    void write(FILE* file, bool* first) const
+    {
+        unsigned count = m_count;
+        unsigned begin = count > capacity ? count - capacity : 0;
+        for (unsigned i = begin; i < count; ++i) {
+            const TraceEventRecord& record = m_events[i & (capacity - 1)];
+            fprintf(file, "%s{\"cat\":\"%s\",\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%lld,\"pid\":%d,\"tid\":%d}",
+                    *first ? "" : ",\n", record.category, record.name, record.phase, record.timestampUs, getpid(), m_threadId);
+            *first = false;
+        }
+    }
+
+    // Appends the events from *cursor on and moves it past them.
+    void append(StringBuilder* builder, unsigned* cursor) const
+    {
+        unsigned count = m_count;
+        unsigned begin = count > capacity ? std::max(*cursor, count - capacity) : *cursor;
+        for (unsigned i = begin; i < count; ++i) {
+            const TraceEventRecord& record = m_events[i & (capacity - 1)];
+            builder->append(String::format("{\"cat\":\"%s\",\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%lld,\"pid\":%d,\"tid\":%d}\n",
+                    record.category, record.name, record.phase, record.timestampUs, getpid(), m_threadId));
+        }
+        *cursor = count;
+    }
+
+private:
+    TraceEventRecord m_events[capacity];
+    volatile unsigned m_count;
+    pid_t m_threadId;
+};
+
+pthread_key_t bufferKey;
+pthread_once_t bufferKeyOnce = PTHREAD_ONCE_INIT;
+// Buffers outlive their threads so that the events of short lived threads
+// still make it into the timeline.
+Mutex* buffersMutex;
+Vector<TraceEventBuffer*>* buffers;
+
+void initializeBuffers()
+{
+    pthread_key_create(&bufferKey, 0);
+    buffersMutex = new Mutex;
+    buffers = new Vector<TraceEventBuffer*>;
+}
+
+TraceEventBuffer* currentThreadBuffer()
+{
+    pthread_once(&bufferKeyOnce, initializeBuffers);
+    TraceEventBuffer* buffer = static_cast<TraceEventBuffer*>(pthread_getspecific(bufferKey));
+    if (buffer)
+        return buffer;
+
+    buffer = new TraceEventBuffer;
+    pthread_setspecific(bufferKey, buffer);
+    MutexLocker locker(*buffersMutex);
+    buffers->append(buffer);
+    return buffer;
+}
+
+long long nowUs()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<long long>(now.tv_sec) * 1000000 + now.tv_nsec / 1000;
+}
+
+} // namespace
+
+volatile bool TraceEventAndroid::s_enabled = false;
+
+void TraceEventAndroid::setEnabled(bool enabled)
+{
+    s_enabled = enabled;
+}
+
+void TraceEventAndroid::append(const char* category, const char* name, char phase)
+{
+    currentThreadBuffer()->append(category, name, nowUs(), phase);
+}
+
+bool TraceEventAndroid::writeTimeline(const char* path)
+{
+    FILE* file = fopen(path, "w");
+    if (!file)
+        return false;
+
+    pthread_once(&bufferKeyOnce, initializeBuffers);
+    bool first = true;
+    fputs("{\"traceEvents\":[\n", file);
+    {
+        MutexLocker locker(*buffersMutex);
+        for (size_t i = 0; i < buffers->size(); ++i)
+            buffers->at(i)->write(file, &first);
+    }
+    fputs("\n]}\n", file);
+    return !fclose(file);
+}
+
+String TraceEventAndroid::takeNewEvents(Vector<unsigned>* cursor)
+{
+    pthread_once(&bufferKeyOnce, initializeBuffers);
+    StringBuilder builder;
+    MutexLocker locker(*buffersMutex);
+    // Buffers are never removed, so a cursor entry keeps matching its buffer.
+    while (cursor->size() < buffers->size())
+        cursor->append(0);
+    for (size_t i = 0; i < buffers->size(); ++i)
+        buffers->at(i)->append(&builder, &cursor->at(i));
+    return builder.toString();
+}
+
+} // namespace WebCore
@@ -0,0 +1,112 @@
+/*
+ * Copyright 2012, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TraceEventAndroid_h
+#define TraceEventAndroid_h
+
+// Scoped trace events covering the phases of a page's life: parsing, style,
+// layout, script, GC, picture recording, tile painting and the compositor.
+// While tracing is off an event costs one load and branch. While it is on,
+// events go to a fixed size ring buffer owned by the recording thread, so
+// recording never takes a lock, and the buffers can be written out as a
+// Chrome trace file for about:tracing.
+//
+// Names and categories must be string literals, only the pointers are kept.
+
+#include <wtf/Forward.h>
+#include <wtf/Vector.h>
+
+#define ANDROID_TRACE_EVENT_MAKE_UNIQUE_IDENTIFIER3(a, b) a##b
+#define ANDROID_TRACE_EVENT_MAKE_UNIQUE_IDENTIFIER2(a, b) ANDROID_TRACE_EVENT_MAKE_UNIQUE_IDENTIFIER3(a, b)
+#define ANDROID_TRACE_EVENT_MAKE_UNIQUE_IDENTIFIER(prefix) ANDROID_TRACE_EVENT_MAKE_UNIQUE_IDENTIFIER2(prefix, __LINE__)
+
+// Traces the enclosing scope.
+#define ANDROID_TRACE_EVENT(category, name) \
+    WebCore::TraceEventScope ANDROID_TRACE_EVENT_MAKE_UNIQUE_IDENTIFIER(__androidTraceEventScope)(category, name)
+
+namespace WebCore {
+
+class TraceEventAndroid {
+public:
+    static bool isEnabled() { return s_enabled; }
+    static void setEnabled(bool);
+
+    // For phases that do not map to a scope, such as the GC prologue and
+    // epilogue callbacks. Must be paired on the same thread.
+    static void begin(const char* category, const char* name)
+    {
+        if (s_enabled)
+            append(category, name, 'B');
+    }
+    static void end(const char* category, const char* name)
+    {
+        if (s_enabled)
+            append(category, name, 'E');
+    }
+
+    // Writes the buffered events of all threads as JSON in the Chrome trace
+    // event format. Events recorded while writing may be torn, so turn
+    // tracing off first.
+    static bool writeTimeline(const char* path);
+
+    // For a live consumer such as the wds STRM command: the events recorded
+    // since the previous call with the same cursor, one JSON object per line.
+    // Events overwritten before they could be read are skipped.
+    static String takeNewEvents(Vector<unsigned>* cursor);
+
+private:
+    friend class TraceEventScope;
+    static void append(const char* category, const char* name, char phase);
+
+    static volatile bool s_enabled;
+};
+
+class TraceEventScope {
+public:
+    TraceEventScope(const char* category, const char* name)
+        : m_category(category)
+        , m_name(name)
+        , m_began(TraceEventAndroid::isEnabled())
+    {
+        if (m_began)
+            TraceEventAndroid::begin(category, name);
+    }
+
+    ~TraceEventScope()
+    {
+        // Close what was opened even if tracing was turned off meanwhile.
+        if (m_began)
+            TraceEventAndroid::append(m_category, m_name, 'E');
+    }
+
+private:
+    const char* m_category;
+    const char* m_name;
+    bool m_began;
+};
+
+} // namespace WebCore
+
+#endif // TraceEventAndroid_h
@@ -234,8 +234,6 @@ void AudioBus::processWithGainFromMonoStereo(const AudioBus &sourceBus, double*
     // We don't want to suddenly change the gain from mixing one time slice to the next,
     // so we "de-zipper" by slowly changing the gain each sample-frame until we've achieved the target gain.
 
-    // FIXME: optimize this method (SSE, etc.)
-    // FIXME: Need fast path here when gain has converged on targetGain. In this case, de-zippering is no longer needed.
     // FIXME: Need fast path when this==sourceBus && lastMixGain==targetGain==1.0 && sumToBus==false (this is a NOP)
 
     // Take master bus gain into account as well as the targetGain.
@@ -258,6 +256,27 @@ void AudioBus::processWithGainFromMonoStereo(const AudioBus &sourceBus, double*
     const double DezipperRate = 0.005;
     int framesToProcess = length();
 
+    // Once the gain is within epsilon of the target there is nothing left to de-zipper,
+    // so snap to the target and use the vectorized constant-gain routines.
+    const double GainEpsilon = 0.001;
+    if (fabs(totalDesiredGain - gain) < GainEpsilon) {
+        float constantGain = static_cast<float>(totalDesiredGain);
+        const float* sourceForRight = sourceR ? sourceR : sourceL;
+
+        if (sumToBus) {
+            vsma(sourceL, 1, &constantGain, destinationL, 1, framesToProcess);
+            if (destinationR)
+                vsma(sourceForRight, 1, &constantGain, destinationR, 1, framesToProcess);
+        } else {
+            vsmul(sourceL, 1, &constantGain, destinationL, 1, framesToProcess);
+            if (destinationR)
+                vsmul(sourceForRight, 1, &constantGain, destinationR, 1, framesToProcess);
+        }
+
+        *lastMixGain = totalDesiredGain;
+        return;
+    }
+
     if (sumToBus) {
         // Sum to our bus
         if (sourceR && destinationR) {
@@ -84,12 +84,16 @@ void Biquad::process(const float* sourceP, float* destP, size_t framesToProcess)
     double b1 = m_b1;
     double b2 = m_b2;
 
+    // Keep the gain in a register too; reading m_g through |this| on every frame
+    // can't be hoisted since destP might alias it.
+    double g = m_g;
+
     while (n--) {
         // FIXME: this can be optimized by pipelining the multiply adds...
         float x = *sourceP++;
         float y = a0*x + a1*x1 + a2*x2 - b1*y1 - b2*y2;
 
-        y *= m_g;
+        y *= g;
 
         *destP++ = y;
 
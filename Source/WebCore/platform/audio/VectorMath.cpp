@@ -32,6 +32,10 @@
 #include <Accelerate/Accelerate.h>
 #endif
 
+#if CPU(ARM_NEON) && COMPILER(GCC)
+#include <arm_neon.h>
+#endif
+
 namespace WebCore {
 
 namespace VectorMath {
@@ -59,13 +63,65 @@ void vadd(const float* source1P, int sourceStride1, const float* source2P, int s
 #endif
 }
 
+void vmul(const float* source1P, int sourceStride1, const float* source2P, int sourceStride2, float* destP, int destStride, size_t framesToProcess)
+{
+#if defined(__ppc__) || defined(__i386__)
+    ::vmul(source1P, sourceStride1, source2P, sourceStride2, destP, destStride, framesToProcess);
+#else
+    vDSP_vmul(source1P, sourceStride1, source2P, sourceStride2, destP, destStride, framesToProcess);
+#endif
+}
+
+void vsma(const float* sourceP, int sourceStride, const float* scale, float* destP, int destStride, size_t framesToProcess)
+{
+#if defined(__ppc__) || defined(__i386__)
+    ::vsma(sourceP, sourceStride, scale, destP, destStride, destP, destStride, framesToProcess);
+#else
+    vDSP_vsma(sourceP, sourceStride, scale, destP, destStride, destP, destStride, framesToProcess);
+#endif
+}
+
+void zvmul(const float* real1P, const float* imag1P, const float* real2P, const float* imag2P, float* realDestP, float* imagDestP, size_t framesToProcess)
+{
+    DSPSplitComplex sc1;
+    DSPSplitComplex sc2;
+    DSPSplitComplex dest;
+    sc1.realp = const_cast<float*>(real1P);
+    sc1.imagp = const_cast<float*>(imag1P);
+    sc2.realp = const_cast<float*>(real2P);
+    sc2.imagp = const_cast<float*>(imag2P);
+    dest.realp = realDestP;
+    dest.imagp = imagDestP;
+#if defined(__ppc__) || defined(__i386__)
+    ::zvmul(&sc1, 1, &sc2, 1, &dest, 1, framesToProcess, 1);
+#else
+    vDSP_zvmul(&sc1, 1, &sc2, 1, &dest, 1, framesToProcess, 1);
+#endif
+}
+
 #else
 
 void vsmul(const float* sourceP, int sourceStride, const float* scale, float* destP, int destStride, size_t framesToProcess)
 {
-    // FIXME: optimize for SSE
     int n = framesToProcess;
     float k = *scale;
+
+#if CPU(ARM_NEON) && COMPILER(GCC)
+    if (sourceStride == 1 && destStride == 1) {
+        int tailFrames = n % 4;
+        const float* endP = destP + n - tailFrames;
+
+        while (destP < endP) {
+            float32x4_t source = vld1q_f32(sourceP);
+            vst1q_f32(destP, vmulq_n_f32(source, k));
+
+            sourceP += 4;
+            destP += 4;
+        }
+        n = tailFrames;
+    }
+#endif
+
     while (n--) {
         *destP = k * *sourceP;
         sourceP += sourceStride;
@@ -75,8 +131,26 @@ void vsmul(const float* sourceP, int sourceStride, const float* scale, float* de
 
 void vadd(const float* source1P, int sourceStride1, const float* source2P, int sourceStride2, float* destP, int destStride, size_t framesToProcess)
 {
-    // FIXME: optimize for SSE
     int n = framesToProcess;
+
+#if CPU(ARM_NEON) && COMPILER(GCC)
+    if (sourceStride1 == 1 && sourceStride2 == 1 && destStride == 1) {
+        int tailFrames = n % 4;
+        const float* endP = destP + n - tailFrames;
+
+        while (destP < endP) {
+            float32x4_t source1 = vld1q_f32(source1P);
+            float32x4_t source2 = vld1q_f32(source2P);
+            vst1q_f32(destP, vaddq_f32(source1, source2));
+
+            source1P += 4;
+            source2P += 4;
+            destP += 4;
+        }
+        n = tailFrames;
+    }
+#endif
+
     while (n--) {
         *destP = *source1P + *source2P;
         source1P += sourceStride1;
@@ -85,6 +159,97 @@ void vadd(const float* source1P, int sourceStride1, const float* source2P, int s
     }
 }
 
+void vmul(const float* source1P, int sourceStride1, const float* source2P, int sourceStride2, float* destP, int destStride, size_t framesToProcess)
+{
+    int n = framesToProcess;
+
+#if CPU(ARM_NEON) && COMPILER(GCC)
+    if (sourceStride1 == 1 && sourceStride2 == 1 && destStride == 1) {
+        int tailFrames = n % 4;
+        const float* endP = destP + n - tailFrames;
+
+        while (destP < endP) {
+            float32x4_t source1 = vld1q_f32(source1P);
+            float32x4_t source2 = vld1q_f32(source2P);
+            vst1q_f32(destP, vmulq_f32(source1, source2));
+
+            source1P += 4;
+            source2P += 4;
+            destP += 4;
+        }
+        n = tailFrames;
+    }
+#endif
+
+    while (n--) {
+        *destP = *source1P * *source2P;
+        source1P += sourceStride1;
+        source2P += sourceStride2;
+        destP += destStride;
+    }
+}
+
+void vsma(const float* sourceP, int sourceStride, const float* scale, float* destP, int destStride, size_t framesToProcess)
+{
+    int n = framesToProcess;
+    float k = *scale;
+
+#if CPU(ARM_NEON) && COMPILER(GCC)
+    if (sourceStride == 1 && destStride == 1) {
+        int tailFrames = n % 4;
+        const float* endP = destP + n - tailFrames;
+
+        while (destP < endP) {
+            float32x4_t source = vld1q_f32(sourceP);
+            float32x4_t dest = vld1q_f32(destP);
+            vst1q_f32(destP, vmlaq_n_f32(dest, source, k));
+
+            sourceP += 4;
+            destP += 4;
+        }
+        n = tailFrames;
+    }
+#endif
+
+    while (n--) {
+        *destP += k * *sourceP;
+        sourceP += sourceStride;
+        destP += destStride;
+    }
+}
+
+void zvmul(const float* real1P, const float* imag1P, const float* real2P, const float* imag2P, float* realDestP, float* imagDestP, size_t framesToProcess)
+{
+    unsigned i = 0;
+
+#if CPU(ARM_NEON) && COMPILER(GCC)
+    unsigned endSize = framesToProcess - framesToProcess % 4;
+
+    while (i < endSize) {
+        float32x4_t real1 = vld1q_f32(real1P + i);
+        float32x4_t real2 = vld1q_f32(real2P + i);
+        float32x4_t imag1 = vld1q_f32(imag1P + i);
+        float32x4_t imag2 = vld1q_f32(imag2P + i);
+
+        float32x4_t realResult = vmlsq_f32(vmulq_f32(real1, real2), imag1, imag2);
+        float32x4_t imagResult = vmlaq_f32(vmulq_f32(real1, imag2), imag1, real2);
+
+        vst1q_f32(realDestP + i, realResult);
+        vst1q_f32(imagDestP + i, imagResult);
+
+        i += 4;
+    }
+#endif
+
+    for (; i < framesToProcess; ++i) {
+        // Read and compute the result before storing, since the destination may alias either source.
+        float realResult = real1P[i] * real2P[i] - imag1P[i] * imag2P[i];
+        float imagResult = real1P[i] * imag2P[i] + imag1P[i] * real2P[i];
+        realDestP[i] = realResult;
+        imagDestP[i] = imagResult;
+    }
+}
+
 #endif // OS(DARWIN)
 
 } // namespace VectorMath
@@ -31,9 +31,21 @@ namespace WebCore {
 
 namespace VectorMath {
 
+// Multiplies each element in source by scale and stores in destination.
 void vsmul(const float* sourceP, int sourceStride, const float* scale, float* destP, int destStride, size_t framesToProcess);
+
+// Element-wise addition of source1 and source2.
 void vadd(const float* source1P, int sourceStride1, const float* source2P, int sourceStride2, float* destP, int destStride, size_t framesToProcess);
 
+// Element-wise multiplication of source1 and source2.
+void vmul(const float* source1P, int sourceStride1, const float* source2P, int sourceStride2, float* destP, int destStride, size_t framesToProcess);
+
+// Multiplies each element in source by scale and adds it to destination (dest += scale * source).
+void vsma(const float* sourceP, int sourceStride, const float* scale, float* destP, int destStride, size_t framesToProcess);
+
+// Complex multiplication of two split-complex vectors. The destination may be either source.
+void zvmul(const float* real1P, const float* imag1P, const float* real2P, const float* imag2P, float* realDestP, float* imagDestP, size_t framesToProcess);
+
 } // namespace VectorMath
 
 } // namespace WebCore
@@ -32,6 +32,7 @@
 #if !OS(DARWIN) && USE(WEBAUDIO_FFTW)
 
 #include "FFTFrame.h"
+#include "VectorMath.h"
 
 #include <wtf/MathExtras.h>
 
@@ -134,21 +135,20 @@ void FFTFrame::multiply(const FFTFrame& frame)
     // factor will need to change too.
     float scale = 0.5f;
 
-    // Multiply the packed DC/nyquist component
-    realP1[0] *= scale * realP2[0];
-    imagP1[0] *= scale * imagP2[0];
-
-    // Complex multiplication. If this loop turns out to be hot then
-    // we should use SSE or other intrinsics to accelerate it.
     unsigned halfSize = fftSize() / 2;
 
-    for (unsigned i = 1; i < halfSize; ++i) {
-        float realResult = realP1[i] * realP2[i] - imagP1[i] * imagP2[i];
-        float imagResult = realP1[i] * imagP2[i] + imagP1[i] * realP2[i];
+    // The packed DC/nyquist components are real, so they must not go through the
+    // complex multiply; save them and fix them up afterwards.
+    float real0 = realP1[0];
+    float imag0 = imagP1[0];
 
-        realP1[i] = scale * realResult;
-        imagP1[i] = scale * imagResult;
-    }
+    VectorMath::zvmul(realP1, imagP1, realP2, imagP2, realP1, imagP1, halfSize);
+
+    realP1[0] = real0 * realP2[0];
+    imagP1[0] = imag0 * imagP2[0];
+
+    VectorMath::vsmul(realP1, 1, &scale, realP1, 1, halfSize);
+    VectorMath::vsmul(imagP1, 1, &scale, imagP1, 1, halfSize);
 }
 
 void FFTFrame::doFFT(float* data)
@@ -158,17 +158,13 @@ void FFTFrame::doFFT(float* data)
     // Scale the frequency domain data to match vecLib's scale factor
     // on the Mac. FIXME: if we change the definition of FFTFrame to
     // eliminate this scale factor then this code will need to change.
-    // Also, if this loop turns out to be hot then we should use SSE
-    // or other intrinsics to accelerate it.
     float scaleFactor = 2;
     unsigned length = unpackedFFTWDataSize(fftSize());
     float* realData = this->realData();
     float* imagData = this->imagData();
 
-    for (unsigned i = 0; i < length; ++i) {
-        realData[i] = realData[i] * scaleFactor;
-        imagData[i] = imagData[i] * scaleFactor;
-    }
+    VectorMath::vsmul(realData, 1, &scaleFactor, realData, 1, length);
+    VectorMath::vsmul(imagData, 1, &scaleFactor, imagData, 1, length);
 
     // Move the Nyquist component to the location expected by the
     // FFTFrame API.
@@ -190,13 +186,9 @@ void FFTFrame::doInverseFFT(float* data)
 
     // Restore the original scaling of the time domain data.
     // FIXME: if we change the definition of FFTFrame to eliminate the
-    // scale factor then this code will need to change. Also, if this
-    // loop turns out to be hot then we should use SSE or other
-    // intrinsics to accelerate it.
+    // scale factor then this code will need to change.
     float scaleFactor = 1.0 / (2.0 * fftSize());
-    unsigned n = fftSize();
-    for (unsigned i = 0; i < n; ++i)
-        data[i] *= scaleFactor;
+    VectorMath::vsmul(data, 1, &scaleFactor, data, 1, fftSize());
 
     // Move the Nyquist component back to the location expected by the
     // FFTFrame API.
@@ -154,6 +154,15 @@ public:
 
 #if PLATFORM(ANDROID)
     virtual void setURL(const String& str);
+    virtual void decodeAhead(const IntSize& sizeHint);
+
+    // Used by the compositor to play animated images back without the
+    // animation timer: returns the number of frames once all of them are
+    // complete, 0 otherwise.
+    size_t completeFrameCount();
+    NativeImagePtr nativeImageForFrame(size_t index) { return frameAtIndex(index); }
+    float durationForFrame(size_t index) { return frameDurationAtIndex(index); }
+    int completeRepetitionCount() { return repetitionCount(true); }
 #endif
 
 #if PLATFORM(GTK)
@@ -124,10 +124,21 @@ void Font::update(PassRefPtr<FontSelector> fontSelector) const
     m_fontList->invalidate(fontSelector);
 }
 
+bool Font::hidesTextWhileLoadingCustomFonts() const
+{
+    if (!loadingCustomFonts())
+        return false;
+#if PLATFORM(ANDROID)
+    if (FontSelector* selector = fontSelector())
+        return !selector->drawsTextWhileLoadingFonts();
+#endif
+    return true;
+}
+
 void Font::drawText(GraphicsContext* context, const TextRun& run, const FloatPoint& point, int from, int to) const
 {
     // Don't draw anything while we are using custom fonts that are in the process of loading.
-    if (loadingCustomFonts())
+    if (hidesTextWhileLoadingCustomFonts())
         return;
     
     to = (to == -1 ? run.length() : to);
@@ -147,7 +158,7 @@ void Font::drawText(GraphicsContext* context, const TextRun& run, const FloatPoi
 
 void Font::drawEmphasisMarks(GraphicsContext* context, const TextRun& run, const AtomicString& mark, const FloatPoint& point, int from, int to) const
 {
-    if (loadingCustomFonts())
+    if (hidesTextWhileLoadingCustomFonts())
         return;
 
     if (to < 0)
@@ -177,7 +188,22 @@ float Font::width(const TextRun& run, HashSet<const SimpleFontData*>* fallbackFo
         // If the complex text implementation cannot return fallback fonts, avoid
         // returning them for simple text as well.
         static bool returnFallbackFonts = canReturnFallbackFontsForComplexText();
-        return floatWidthForSimpleText(run, 0, returnFallbackFonts ? fallbackFonts : 0, codePathToUse == SimpleWithGlyphOverflow || (glyphOverflow && glyphOverflow->computeBounds) ? glyphOverflow : 0);
+        GlyphOverflow* overflowToCompute = codePathToUse == SimpleWithGlyphOverflow || (glyphOverflow && glyphOverflow->computeBounds) ? glyphOverflow : 0;
+#if PLATFORM(ANDROID)
+        // Word and letter spacing live on the Font, not on the shared fallback
+        // list, so runs that use them can't share its cached widths.
+        bool useWidthCache = !overflowToCompute && !(returnFallbackFonts && fallbackFonts)
+            && ((!wordSpacing() && !letterSpacing()) || run.spacingDisabled()) && !loadingCustomFonts();
+        if (useWidthCache) {
+            float width;
+            if (m_fontList->widthCache().lookup(run, width))
+                return width;
+            width = floatWidthForSimpleText(run, 0);
+            m_fontList->widthCache().add(run, width);
+            return width;
+        }
+#endif
+        return floatWidthForSimpleText(run, 0, returnFallbackFonts ? fallbackFonts : 0, overflowToCompute);
     }
 
     return floatWidthForComplexText(run, fallbackFonts, glyphOverflow);
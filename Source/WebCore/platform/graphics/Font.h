@@ -194,6 +194,9 @@ private:
     FloatRect selectionRectForComplexText(const TextRun&, const FloatPoint&, int h, int from, int to) const;
 
     friend struct WidthIterator;
+#if PLATFORM(ANDROID)
+    friend class ComplexTextPreshaper;
+#endif
 
 public:
     // Useful for debugging the different font rendering code paths.
@@ -233,6 +236,8 @@ private:
         return m_fontList && m_fontList->loadingCustomFonts();
     }
 
+    bool hidesTextWhileLoadingCustomFonts() const;
+
     FontDescription m_fontDescription;
     mutable RefPtr<FontFallbackList> m_fontList;
     short m_letterSpacing;
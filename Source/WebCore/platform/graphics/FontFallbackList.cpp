@@ -58,6 +58,9 @@ void FontFallbackList::invalidate(PassRefPtr<FontSelector> fontSelector)
     m_loadingCustomFonts = false;
     m_fontSelector = fontSelector;
     m_generation = fontCache()->generation();
+#if PLATFORM(ANDROID)
+    m_widthCache.clear();
+#endif
 }
 
 void FontFallbackList::releaseFontData()
@@ -23,6 +23,9 @@
 
 #include "FontSelector.h"
 #include "SimpleFontData.h"
+#if PLATFORM(ANDROID)
+#include "WidthCache.h"
+#endif
 #include <wtf/Forward.h>
 
 namespace WebCore {
@@ -52,6 +55,10 @@ public:
     FontSelector* fontSelector() const { return m_fontSelector.get(); }
     unsigned generation() const { return m_generation; }
 
+#if PLATFORM(ANDROID)
+    WidthCache& widthCache() const { return m_widthCache; }
+#endif
+
 private:
     FontFallbackList();
 
@@ -79,6 +86,9 @@ private:
     mutable Pitch m_pitch;
     mutable bool m_loadingCustomFonts;
     unsigned m_generation;
+#if PLATFORM(ANDROID)
+    mutable WidthCache m_widthCache;
+#endif
 
     friend class Font;
 };
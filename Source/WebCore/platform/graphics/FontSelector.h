@@ -42,6 +42,12 @@ public:
 
     virtual void fontCacheInvalidated() { }
 
+#if PLATFORM(ANDROID)
+    // Whether text set in custom fonts that are still loading should be
+    // drawn with its fallback font instead of being left invisible.
+    virtual bool drawsTextWhileLoadingFonts() const { return false; }
+#endif
+
     virtual void registerForInvalidationCallbacks(FontSelectorClient*) = 0;
     virtual void unregisterForInvalidationCallbacks(FontSelectorClient*) = 0;
 };
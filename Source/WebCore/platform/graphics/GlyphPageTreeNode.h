@@ -31,6 +31,7 @@
 
 #include <string.h>
 #include <wtf/HashMap.h>
+#include <wtf/OwnArrayPtr.h>
 #include <wtf/PassRefPtr.h>
 #include <wtf/RefCounted.h>
 #include <wtf/unicode/Unicode.h>
@@ -68,6 +69,9 @@ struct GlyphData {
 // missing in the primary font. It is owned by exactly one GlyphPageTreeNode,
 // although multiple nodes may reference it as their "page" if they are supposed
 // to be overriding the parent's node, but provide no additional information.
+//
+// Most pages map every character to the same font data, so a page only keeps
+// a font data pointer per character once it is given a second font data.
 class GlyphPage : public RefCounted<GlyphPage> {
 public:
     static PassRefPtr<GlyphPage> create(GlyphPageTreeNode* owner)
@@ -80,14 +84,13 @@ public:
     unsigned indexForCharacter(UChar32 c) const { return c % size; }
     GlyphData glyphDataForCharacter(UChar32 c) const
     {
-        unsigned index = indexForCharacter(c);
-        return GlyphData(m_glyphs[index], m_glyphFontData[index]);
+        return glyphDataForIndex(indexForCharacter(c));
     }
 
     GlyphData glyphDataForIndex(unsigned index) const
     {
         ASSERT(index < size);
-        return GlyphData(m_glyphs[index], m_glyphFontData[index]);
+        return GlyphData(m_glyphs[index], fontDataForIndex(index));
     }
 
     Glyph glyphAt(unsigned index) const
@@ -98,7 +101,7 @@ public:
 
     const SimpleFontData* fontDataForCharacter(UChar32 c) const
     {
-        return m_glyphFontData[indexForCharacter(c)];
+        return fontDataForIndex(indexForCharacter(c));
     }
 
     void setGlyphDataForCharacter(UChar32 c, Glyph g, const SimpleFontData* f)
@@ -109,7 +112,21 @@ public:
     {
         ASSERT(index < size);
         m_glyphs[index] = g;
-        m_glyphFontData[index] = f;
+        if (m_perGlyphFontData) {
+            m_perGlyphFontData[index] = f;
+            return;
+        }
+        if (!m_hasFontData) {
+            // Entries that were never set are undefined, so the first font
+            // data can stand for the whole page.
+            m_fontDataForAllGlyphs = f;
+            m_hasFontData = true;
+        } else if (f != m_fontDataForAllGlyphs) {
+            m_perGlyphFontData = adoptArrayPtr(new const SimpleFontData*[size]);
+            for (unsigned i = 0; i < size; ++i)
+                m_perGlyphFontData[i] = m_fontDataForAllGlyphs;
+            m_perGlyphFontData[index] = f;
+        }
     }
     void setGlyphDataForIndex(unsigned index, const GlyphData& glyphData)
     {
@@ -119,13 +136,22 @@ public:
     void copyFrom(const GlyphPage& other)
     {
         memcpy(m_glyphs, other.m_glyphs, sizeof(m_glyphs));
-        memcpy(m_glyphFontData, other.m_glyphFontData, sizeof(m_glyphFontData));
+        m_fontDataForAllGlyphs = other.m_fontDataForAllGlyphs;
+        m_hasFontData = other.m_hasFontData;
+        if (other.m_perGlyphFontData) {
+            if (!m_perGlyphFontData)
+                m_perGlyphFontData = adoptArrayPtr(new const SimpleFontData*[size]);
+            memcpy(m_perGlyphFontData.get(), other.m_perGlyphFontData.get(), size * sizeof(m_perGlyphFontData[0]));
+        } else
+            m_perGlyphFontData.clear();
     }
 
     void clear()
     {
         memset(m_glyphs, 0, sizeof(m_glyphs));
-        memset(m_glyphFontData, 0, sizeof(m_glyphFontData));
+        m_fontDataForAllGlyphs = 0;
+        m_hasFontData = true;
+        m_perGlyphFontData.clear();
     }
     
     GlyphPageTreeNode* owner() const { return m_owner; }
@@ -135,13 +161,22 @@ public:
 
 private:
     GlyphPage(GlyphPageTreeNode* owner)
-        : m_owner(owner)
+        : m_fontDataForAllGlyphs(0)
+        , m_hasFontData(false)
+        , m_owner(owner)
+    {
+    }
+
+    const SimpleFontData* fontDataForIndex(unsigned index) const
     {
+        return m_perGlyphFontData ? m_perGlyphFontData[index] : m_fontDataForAllGlyphs;
     }
 
     // Separate arrays, rather than array of GlyphData, to save space.
     Glyph m_glyphs[size];
-    const SimpleFontData* m_glyphFontData[size];
+    const SimpleFontData* m_fontDataForAllGlyphs;
+    OwnArrayPtr<const SimpleFontData*> m_perGlyphFontData;
+    bool m_hasFontData;
 
     GlyphPageTreeNode* m_owner;
 };
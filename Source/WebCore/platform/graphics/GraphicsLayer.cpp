@@ -453,6 +453,11 @@ void GraphicsLayer::dumpProperties(TextStream& ts, int indent, LayerTreeAsTextBe
         ts << "(drawsContent " << m_drawsContent << ")\n";
     }
 
+    if (m_contentsOpaque) {
+        writeIndent(ts, indent + 1);
+        ts << "(contentsOpaque " << m_contentsOpaque << ")\n";
+    }
+
     if (!m_backfaceVisibility) {
         writeIndent(ts, indent + 1);
         ts << "(backfaceVisibility " << (m_backfaceVisibility ? "visible" : "hidden") << ")\n";
@@ -148,6 +148,9 @@ public:
 
 #if PLATFORM(ANDROID)
     virtual void setURL(const String& str) {}
+    // Decodes the image in the background before it is first drawn, at the
+    // resolution sizeHint needs if it isn't empty.
+    virtual void decodeAhead(const IntSize& sizeHint) {}
 #endif
 
 #if PLATFORM(GTK)
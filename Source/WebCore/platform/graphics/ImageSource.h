@@ -89,9 +89,12 @@ typedef QPixmap* NativeImagePtr;
 #ifdef ANDROID_ANIMATED_GIF
 class GIFImageDecoder;
 #endif
+class ImageDecoder;
 struct NativeImageSourcePtr {
     SkString m_url;
     PrivateAndroidImageSourceRec* m_image;
+    // Renders JPEG and PNG images while their data is still arriving.
+    ImageDecoder* m_partialDecoder;
 #ifdef ANDROID_ANIMATED_GIF
     GIFImageDecoder* m_gifDecoder;
 #endif
@@ -210,6 +213,14 @@ public:
 #if PLATFORM(ANDROID)
     void clearURL();
     void setURL(const String& url);
+    // Called each time the image is drawn, with the size it covers on the
+    // canvas. Lets the decoder pick the coarsest sample size that still
+    // looks right there.
+    void willDrawAtSize(const IntSize&, SharedBuffer* data);
+
+    // Queues the image for a background decode before anything draws it,
+    // first picking the sample size for sizeHint if it isn't empty.
+    void decodeAhead(const IntSize& sizeHint, SharedBuffer* data);
 #endif
 
 private:
@@ -114,6 +114,11 @@ namespace WebCore {
         bool strokeContains(StrokeStyleApplier*, const FloatPoint&) const;
         FloatRect boundingRect() const;
         FloatRect strokeBoundingRect(StrokeStyleApplier* = 0) const;
+#if USE(SKIA)
+        // Returns the area covered by stroking this path as a fillable path, so callers
+        // can reuse it instead of re-running the stroker for every bounds or hit test query.
+        Path strokeOutline(StrokeStyleApplier*) const;
+#endif
         
         float length() const;
         FloatPoint pointAtLength(float length, bool& ok) const;
@@ -0,0 +1,136 @@
+/*
+ * Copyright 2012, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef WidthCache_h
+#define WidthCache_h
+
+#if PLATFORM(ANDROID)
+
+#include "TextRun.h"
+#include <wtf/HashMap.h>
+#include <wtf/HashTraits.h>
+#include <wtf/StringHasher.h>
+
+namespace WebCore {
+
+// Caches the measured width of short simple-path text runs (typically single
+// words) for one FontFallbackList. Relayout after a zoom or a viewport change
+// measures the same words at the same font over and over; this turns most of
+// those measurements into a hash lookup instead of a glyph walk.
+class WidthCache {
+public:
+    WidthCache() { }
+
+    bool lookup(const TextRun& run, float& width) const
+    {
+        if (!isCacheable(run))
+            return false;
+        Map::const_iterator it = m_map.find(SmallStringKey(run.characters(), run.length()));
+        if (it == m_map.end())
+            return false;
+        width = it->second;
+        return true;
+    }
+
+    void add(const TextRun& run, float width)
+    {
+        if (!isCacheable(run))
+            return;
+        // Pages rarely use more distinct words per font than this; when one
+        // does, start over rather than paying for an eviction policy.
+        if (m_map.size() >= cMaxEntries)
+            m_map.clear();
+        m_map.set(SmallStringKey(run.characters(), run.length()), width);
+    }
+
+    void clear() { m_map.clear(); }
+
+private:
+    static const unsigned cMaxEntries = 2000;
+
+    class SmallStringKey {
+    public:
+        static const unsigned cCapacity = 16;
+
+        SmallStringKey() : m_length(0), m_hash(0) { }
+        SmallStringKey(WTF::HashTableDeletedValueType) : m_length(cDeletedLength), m_hash(0) { }
+        SmallStringKey(const UChar* characters, unsigned length)
+            : m_length(length)
+            , m_hash(WTF::StringHasher::computeHash<UChar>(characters, length))
+        {
+            ASSERT(length && length <= cCapacity);
+            memcpy(m_characters, characters, length * sizeof(UChar));
+        }
+
+        unsigned hash() const { return m_hash; }
+        bool isHashTableDeletedValue() const { return m_length == cDeletedLength; }
+
+        bool operator==(const SmallStringKey& other) const
+        {
+            if (m_length != other.m_length || m_hash != other.m_hash)
+                return false;
+            if (!m_length || m_length == cDeletedLength)
+                return true;
+            return !memcmp(m_characters, other.m_characters, m_length * sizeof(UChar));
+        }
+
+    private:
+        static const unsigned cDeletedLength = 0xFFFFFFFF;
+
+        unsigned m_length;
+        unsigned m_hash;
+        UChar m_characters[cCapacity];
+    };
+
+    struct SmallStringKeyHash {
+        static unsigned hash(const SmallStringKey& key) { return key.hash(); }
+        static bool equal(const SmallStringKey& a, const SmallStringKey& b) { return a == b; }
+        static const bool safeToCompareToEmptyOrDeleted = true;
+    };
+
+    typedef HashMap<SmallStringKey, float, SmallStringKeyHash, WTF::SimpleClassHashTraits<SmallStringKey> > Map;
+
+    // The width only depends on the characters as long as the run carries no
+    // state the WidthIterator would fold in: tabs depend on the x position,
+    // expansion and stretching on the line, and RTL mirrors some glyphs.
+    static bool isCacheable(const TextRun& run)
+    {
+        if (!run.length() || static_cast<unsigned>(run.length()) > SmallStringKey::cCapacity)
+            return false;
+#if ENABLE(SVG)
+        if (run.horizontalGlyphStretch() != 1)
+            return false;
+#endif
+        return !run.allowTabs() && !run.expansion() && run.ltr() && !run.directionalOverride();
+    }
+
+    Map m_map;
+};
+
+} // namespace WebCore
+
+#endif // PLATFORM(ANDROID)
+
+#endif // WidthCache_h
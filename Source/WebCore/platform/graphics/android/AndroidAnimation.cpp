@@ -73,12 +73,33 @@ AndroidAnimation::AndroidAnimation(AnimatedPropertyID type,
     , m_operations(operations)
     , m_uniqueId(++gUniqueId)
     , m_hasFinished(false)
+    , m_pausedElapsedTime(-1)
+    , m_isSuspended(false)
 {
     ASSERT(m_timingFunction);
 
     gDebugAndroidAnimationInstances++;
 }
 
+AndroidAnimation::AndroidAnimation(AndroidAnimation* anim)
+    : m_beginTime(anim->m_beginTime)
+    , m_duration(anim->m_duration)
+    , m_fillsBackwards(anim->m_fillsBackwards)
+    , m_fillsForwards(anim->m_fillsForwards)
+    , m_iterationCount(anim->m_iterationCount)
+    , m_direction(anim->m_direction)
+    , m_timingFunction(anim->m_timingFunction)
+    , m_name(anim->m_name)
+    , m_type(anim->m_type)
+    , m_operations(anim->m_operations)
+    , m_uniqueId(anim->m_uniqueId)
+    , m_hasFinished(anim->m_hasFinished)
+    , m_pausedElapsedTime(anim->m_pausedElapsedTime)
+    , m_isSuspended(anim->m_isSuspended)
+{
+    gDebugAndroidAnimationInstances++;
+}
+
 AndroidAnimation::~AndroidAnimation()
 {
     gDebugAndroidAnimationInstances--;
@@ -90,8 +111,26 @@ void AndroidAnimation::suggestBeginTime(double time)
         m_beginTime = time;
 }
 
+void AndroidAnimation::pause(double elapsedTime, bool isSuspension)
+{
+    m_pausedElapsedTime = elapsedTime < 0 ? 0 : elapsedTime;
+    m_isSuspended = isSuspension;
+}
+
+void AndroidAnimation::resume(double time)
+{
+    if (!isPaused())
+        return;
+    m_beginTime = time - m_pausedElapsedTime;
+    m_pausedElapsedTime = -1;
+    m_isSuspended = false;
+}
+
 double AndroidAnimation::elapsedTime(double time)
 {
+    if (isPaused())
+        return m_pausedElapsedTime;
+
     double elapsedTime = (m_beginTime < 0.000001) ? 0 : time - m_beginTime;
 
     if (m_duration <= 0)
@@ -115,7 +154,13 @@ bool AndroidAnimation::checkIterationsAndProgress(double time, float* finalProgr
 
     // If not infinite, return false if we are done
     if (m_iterationCount > 0 && progress > dur) {
-        *finalProgress = 1.0;
+        // an alternating animation with an even iteration count ends
+        // where it started
+        if (m_direction == Animation::AnimationDirectionAlternate
+            && !(m_iterationCount & 1))
+            *finalProgress = 0;
+        else
+            *finalProgress = 1.0;
         if (!m_hasFinished) {
             // first time past duration, continue with progress 1.0 so the
             // element's final position lines up with it's last keyframe
@@ -202,7 +247,8 @@ bool AndroidAnimation::evaluate(LayerAndroid* layer, double time)
 
     applyForProgress(layer, progress);
 
-    return true;
+    // keep the paused values on the layer, but don't ask for more frames
+    return !isPaused();
 }
 
 PassRefPtr<AndroidOpacityAnimation> AndroidOpacityAnimation::create(
@@ -221,6 +267,16 @@ AndroidOpacityAnimation::AndroidOpacityAnimation(const Animation* animation,
 {
 }
 
+AndroidOpacityAnimation::AndroidOpacityAnimation(AndroidOpacityAnimation* anim)
+    : AndroidAnimation(anim)
+{
+}
+
+PassRefPtr<AndroidAnimation> AndroidOpacityAnimation::copy()
+{
+    return adoptRef(new AndroidOpacityAnimation(this));
+}
+
 void AndroidAnimation::pickValues(double progress, int* start, int* end)
 {
     float distance = -1;
@@ -284,6 +340,16 @@ AndroidTransformAnimation::AndroidTransformAnimation(const Animation* animation,
 {
 }
 
+AndroidTransformAnimation::AndroidTransformAnimation(AndroidTransformAnimation* anim)
+    : AndroidAnimation(anim)
+{
+}
+
+PassRefPtr<AndroidAnimation> AndroidTransformAnimation::copy()
+{
+    return adoptRef(new AndroidTransformAnimation(this));
+}
+
 void AndroidTransformAnimation::applyForProgress(LayerAndroid* layer, float progress)
 {
     // First, we need to get the from and to values
@@ -39,8 +39,10 @@ public:
                      const Animation* animation,
                      KeyframeValueList* operations,
                      double beginTime);
+    AndroidAnimation(AndroidAnimation* anim);
 
     virtual ~AndroidAnimation();
+    virtual PassRefPtr<AndroidAnimation> copy() = 0;
     void suggestBeginTime(double time);
     double elapsedTime(double time);
     void pickValues(double progress, int* start, int* end);
@@ -57,6 +59,13 @@ public:
     bool fillsForwards() { return m_fillsForwards; }
     int uniqueId() { return m_uniqueId; }
 
+    // a paused animation keeps applying the values at elapsedTime without
+    // asking for more frames; suspended ones are resumed by resume()
+    void pause(double elapsedTime, bool isSuspension);
+    void resume(double time);
+    bool isPaused() { return m_pausedElapsedTime >= 0; }
+    bool isSuspended() { return m_isSuspended; }
+
 protected:
     double m_beginTime;
     double m_duration;
@@ -70,6 +79,8 @@ protected:
     KeyframeValueList* m_operations;
     int m_uniqueId;
     bool m_hasFinished;
+    double m_pausedElapsedTime;
+    bool m_isSuspended;
 };
 
 class AndroidOpacityAnimation : public AndroidAnimation {
@@ -80,6 +91,8 @@ public:
     AndroidOpacityAnimation(const Animation* animation,
                             KeyframeValueList* operations,
                             double beginTime);
+    AndroidOpacityAnimation(AndroidOpacityAnimation* anim);
+    virtual PassRefPtr<AndroidAnimation> copy();
 
     virtual void applyForProgress(LayerAndroid* layer, float progress);
 };
@@ -93,6 +106,8 @@ public:
     AndroidTransformAnimation(const Animation* animation,
                               KeyframeValueList* operations,
                               double beginTime);
+    AndroidTransformAnimation(AndroidTransformAnimation* anim);
+    virtual PassRefPtr<AndroidAnimation> copy();
 
     virtual void applyForProgress(LayerAndroid* layer, float progress);
 };
@@ -109,6 +109,8 @@ void BaseLayerAndroid::setContent(const PictureSet& src)
 bool BaseLayerAndroid::drawCanvas(SkCanvas* canvas)
 {
 #if USE(ACCELERATED_COMPOSITING)
+    // SkPicture playback is not thread-safe, so the paint workers take
+    // turns drawing the content
     android::Mutex::Autolock lock(m_drawLock);
 #endif
     if (!m_content.isEmpty())
@@ -160,6 +162,43 @@ void BaseLayerAndroid::prefetchBasePicture(SkRect& viewport, float currentScale,
         prefetchTiledPage->prepareForDrawGL(PREFETCH_OPACITY, bounds);
 }
 
+// Prepares the low resolution page over the whole content if it is small
+// enough, or else over LOW_RES_PAGE_MAX_TILES tiles around the viewport
+void BaseLayerAndroid::prepareLowResPage(SkRect& viewport, float currentScale, bool draw)
+{
+    TiledPage* lowResPage = m_state->lowResPage();
+    float lowResScale = lowResPage->scale();
+    if (currentScale <= lowResScale)
+        return;
+
+    float invTileWidth = lowResScale / TilesManager::instance()->tileWidth();
+    float invTileHeight = lowResScale / TilesManager::instance()->tileHeight();
+    int contentTilesX = std::max(1, static_cast<int>(ceilf(content()->width() * invTileWidth)));
+    int contentTilesY = std::max(1, static_cast<int>(ceilf(content()->height() * invTileHeight)));
+
+    int tilesX = std::min(contentTilesX, LOW_RES_PAGE_MAX_TILES);
+    int tilesY = std::min(contentTilesY, std::max(1, LOW_RES_PAGE_MAX_TILES / tilesX));
+
+    // center the covered area on the viewport, within the content
+    int centerX = static_cast<int>(floorf(viewport.centerX() * invTileWidth));
+    int centerY = static_cast<int>(floorf(viewport.centerY() * invTileHeight));
+    int left = std::max(0, std::min(centerX - tilesX / 2, contentTilesX - tilesX));
+    int top = std::max(0, std::min(centerY - tilesY / 2, contentTilesY - tilesY));
+
+    SkIRect bounds;
+    bounds.set(left, top, left + tilesX, top + tilesY);
+
+    XLOG("low res rect %d %d %d %d, scale %f", bounds.fLeft, bounds.fTop,
+         bounds.fRight, bounds.fBottom, lowResScale);
+
+    lowResPage->updateTileDirtiness(bounds);
+    lowResPage->prepare(m_state->goingDown(), m_state->goingLeft(), bounds,
+                        TiledPage::VisibleBounds);
+    lowResPage->swapBuffersIfReady(bounds, lowResScale);
+    if (draw)
+        lowResPage->prepareForDrawGL(1, bounds);
+}
+
 bool BaseLayerAndroid::isReady()
 {
     ZoomManager* zoomManager = m_state->zoomManager();
@@ -310,15 +349,25 @@ bool BaseLayerAndroid::prepareBasePictureInGL(SkRect& viewport, float scale,
         prefetchBasePicture(viewport, scale, nextTiledPage, drawPrefetchPage);
     }
 
+    // keep the low resolution page ready, and show it under the gaps left by
+    // zooming or missing tiles
+    bool drawLowResPage = zooming || doZoomPageSwap || tiledPage->hasMissingContent(preZoomBounds);
+    prepareLowResPage(viewport, scale, drawLowResPage);
+
     tiledPage->prepareForDrawGL(transparency, preZoomBounds);
 
     return needsRedraw;
 }
 
-void BaseLayerAndroid::drawBasePictureInGL()
+void BaseLayerAndroid::drawBasePictureInGL(const SkRegion& occludedArea)
 {
-    m_state->backPage()->drawGL();
-    m_state->frontPage()->drawGL();
+    // the pages only draw tiles, submit them in as few calls as possible
+    ShaderProgram* shader = TilesManager::instance()->shader();
+    shader->beginBatch();
+    m_state->lowResPage()->drawGL(occludedArea);
+    m_state->backPage()->drawGL(occludedArea);
+    m_state->frontPage()->drawGL(occludedArea);
+    shader->endBatch();
 }
 
 #endif // USE(ACCELERATED_COMPOSITING)
@@ -366,15 +415,26 @@ bool BaseLayerAndroid::drawGL(IntRect& viewRect, SkRect& visibleRect,
 
     // TODO: consider moving drawBackground outside of prepare (into tree manager)
     m_state->drawBackground(m_color);
-    drawBasePictureInGL();
 
     bool needsRedraw = false;
+    SkRegion occludedArea;
 
 #if USE(ACCELERATED_COMPOSITING)
 
+    // position the layers first, to know which base tiles they hide
     LayerAndroid* compositedRoot = static_cast<LayerAndroid*>(getChild(0));
     if (compositedRoot) {
         updateLayerPositions(visibleRect);
+        compositedRoot->addOpaqueArea(occludedArea);
+    }
+
+#endif // USE(ACCELERATED_COMPOSITING)
+
+    drawBasePictureInGL(occludedArea);
+
+#if USE(ACCELERATED_COMPOSITING)
+
+    if (compositedRoot) {
         // For now, we render layers only if the rendering mode
         // is kAllTextures or kClippedTextures
         if (compositedRoot->drawGL()) {
@@ -85,8 +85,9 @@ private:
 #if USE(ACCELERATED_COMPOSITING)
     void prefetchBasePicture(SkRect& viewport, float currentScale,
                              TiledPage* prefetchTiledPage, bool draw);
+    void prepareLowResPage(SkRect& viewport, float currentScale, bool draw);
     bool prepareBasePictureInGL(SkRect& viewport, float scale, double currentTime);
-    void drawBasePictureInGL();
+    void drawBasePictureInGL(const SkRegion& occludedArea);
 
     android::Mutex m_drawLock;
     Color m_color;
@@ -31,6 +31,7 @@
 
 #include "GaneshRenderer.h"
 #include "GLUtils.h"
+#include "PaintStripOperation.h"
 #include "RasterRenderer.h"
 #include "SkBitmap.h"
 #include "SkBitmapRef.h"
@@ -39,12 +40,14 @@
 #include "SkPicture.h"
 #include "TilesManager.h"
 
+#include <string.h>
+#include <utils/threads.h>
+#include <wtf/CurrentTime.h>
 #include <wtf/text/CString.h>
 
 #ifdef DEBUG
 
 #include <cutils/log.h>
-#include <wtf/CurrentTime.h>
 
 #undef XLOG
 #define XLOG(...) android_printLog(ANDROID_LOG_DEBUG, "BaseRenderer", __VA_ARGS__)
@@ -56,10 +59,29 @@
 
 #endif // DEBUG
 
+// Tiles are split into strips only when painted at least at this scale...
+#define MIN_STRIPS_SCALE 2
+// ...and if every strip gets at least this many rows
+#define MIN_STRIP_HEIGHT 64
+
+// A Ganesh paint is considered slow if it takes this many times longer than
+// an average raster paint, measured over at least MIN_RASTER_SAMPLES tiles
+#define GANESH_SLOW_FACTOR 2
+#define MIN_RASTER_SAMPLES 20
+
 namespace WebCore {
 
 BaseRenderer::RendererType BaseRenderer::g_currentType = BaseRenderer::Raster;
 
+struct RendererStats {
+    int tiles;
+    double paintTime;
+};
+
+static android::Mutex s_statsLock;
+static RendererStats s_stats[2];
+static int s_fallbacks = 0;
+
 BaseRenderer* BaseRenderer::createRenderer()
 {
     if (g_currentType == Raster)
@@ -116,6 +138,8 @@ int BaseRenderer::renderTiledContent(const TileRenderInfo& renderInfo)
 {
     const bool visualIndicator = TilesManager::instance()->getShowVisualIndicator();
     const SkSize& tileSize = renderInfo.tileSize;
+    const double startTime = WTF::currentTime();
+    m_lastPaintTime = 0;
 
     SkCanvas canvas;
     setupCanvas(renderInfo, &canvas);
@@ -128,11 +152,22 @@ int BaseRenderer::renderTiledContent(const TileRenderInfo& renderInfo)
     if (visualIndicator)
         canvas.save();
 
-    setupPartialInval(renderInfo, &canvas);
-    canvas.translate(-renderInfo.x * tileSize.width(), -renderInfo.y * tileSize.height());
-    canvas.scale(renderInfo.scale, renderInfo.scale);
     unsigned int pictureCount = 0;
-    renderInfo.tilePainter->paint(renderInfo.baseTile, &canvas, &pictureCount);
+    int strips = stripsCount(renderInfo);
+    if (!visualIndicator && strips > 1) {
+        // the raster of a zoomed in tile is long, let the idle workers
+        // take a share of it
+        RefPtr<TileStrips> tileStrips = TileStrips::create(renderInfo,
+            canvas.getDevice()->accessBitmap(true), strips);
+        for (int i = 1; i < tileStrips->count(); i++)
+            TilesManager::instance()->scheduleOperation(new PaintStripOperation(tileStrips.get(), i));
+        pictureCount = tileStrips->paintAndWait();
+    } else {
+        setupPartialInval(renderInfo, &canvas);
+        canvas.translate(-renderInfo.x * tileSize.width(), -renderInfo.y * tileSize.height());
+        canvas.scale(renderInfo.scale, renderInfo.scale);
+        renderInfo.tilePainter->paint(renderInfo.baseTile, &canvas, &pictureCount);
+    }
 
     if (visualIndicator) {
         canvas.restore();
@@ -159,9 +194,64 @@ int BaseRenderer::renderTiledContent(const TileRenderInfo& renderInfo)
     }
     renderInfo.textureInfo->m_pictureCount = pictureCount;
     renderingComplete(renderInfo, &canvas);
+
+    m_lastPaintTime = WTF::currentTime() - startTime;
+    recordPaint(m_type, m_lastPaintTime);
     return pictureCount;
 }
 
+void BaseRenderer::recordPaint(RendererType type, double seconds)
+{
+    android::Mutex::Autolock lock(s_statsLock);
+    s_stats[type].tiles++;
+    s_stats[type].paintTime += seconds;
+}
+
+void BaseRenderer::tileFellBack()
+{
+    android::Mutex::Autolock lock(s_statsLock);
+    s_fallbacks++;
+}
+
+bool BaseRenderer::slowerThanRaster(double seconds)
+{
+    android::Mutex::Autolock lock(s_statsLock);
+    const RendererStats& raster = s_stats[Raster];
+    if (raster.tiles < MIN_RASTER_SAMPLES)
+        return false;
+    return seconds > GANESH_SLOW_FACTOR * raster.paintTime / raster.tiles;
+}
+
+String BaseRenderer::dumpStats()
+{
+    android::Mutex::Autolock lock(s_statsLock);
+    const RendererStats& raster = s_stats[Raster];
+    const RendererStats& ganesh = s_stats[Ganesh];
+    return String::format("raster %d tiles %.2fms/tile ganesh %d tiles %.2fms/tile"
+                          " fallbacks %d",
+                          raster.tiles, raster.tiles ? raster.paintTime * 1000 / raster.tiles : 0,
+                          ganesh.tiles, ganesh.tiles ? ganesh.paintTime * 1000 / ganesh.tiles : 0,
+                          s_fallbacks);
+}
+
+void BaseRenderer::clearStats()
+{
+    android::Mutex::Autolock lock(s_statsLock);
+    memset(s_stats, 0, sizeof(s_stats));
+    s_fallbacks = 0;
+}
+
+int BaseRenderer::stripsCount(const TileRenderInfo& renderInfo)
+{
+    // the strips paint the bitmap the raster renderer set up, Ganesh draws
+    // with a single GL context
+    if (m_type != Raster || !renderInfo.urgent || renderInfo.scale < MIN_STRIPS_SCALE)
+        return 1;
+
+    int strips = std::min(TilesManager::instance()->paintThreadCount(), MAX_TILE_STRIPS);
+    return std::max(1, std::min(strips, renderInfo.invalRect->height() / MIN_STRIP_HEIGHT));
+}
+
 } // namespace WebCore
 
 #endif // USE(ACCELERATED_COMPOSITING)
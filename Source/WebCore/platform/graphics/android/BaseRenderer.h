@@ -30,6 +30,7 @@
 
 #include "PerformanceMonitor.h"
 #include "SkRect.h"
+#include <wtf/text/WTFString.h>
 
 class SkCanvas;
 class SkDevice;
@@ -39,6 +40,7 @@ namespace WebCore {
 class TextureInfo;
 class TilePainter;
 class BaseTile;
+class BaseTileTexture;
 
 struct TileRenderInfo {
     // coordinates of the tile
@@ -63,8 +65,19 @@ struct TileRenderInfo {
     // info about the texture that we are to render into
     TextureInfo* textureInfo;
 
+    // the texture that we are to render into
+    BaseTileTexture* tileTexture;
+
+    // if set, tileTexture is the (displayed) front texture of the tile, and
+    // only invalRect is to be updated in it
+    bool partialUpdate;
+
     // specifies whether or not to measure the rendering performance
     bool measurePerf;
+
+    // the tile is visible without any content, so it's worth splitting its
+    // paint across the workers
+    bool urgent;
 };
 
 /**
@@ -73,7 +86,7 @@ struct TileRenderInfo {
 class BaseRenderer {
 public:
     enum RendererType { Raster, Ganesh };
-    BaseRenderer(RendererType type) : m_type(type) {}
+    BaseRenderer(RendererType type) : m_type(type), m_lastPaintTime(0) {}
     virtual ~BaseRenderer() {}
 
     int renderTiledContent(const TileRenderInfo& renderInfo);
@@ -85,6 +98,17 @@ public:
     static RendererType getCurrentRendererType() { return g_currentType; }
     static void setCurrentRendererType(RendererType type) { g_currentType = type; }
 
+    // duration of the last renderTiledContent(), in seconds
+    double lastPaintTime() { return m_lastPaintTime; }
+
+    // Paint times are accumulated per renderer type, so that both can be
+    // compared on the same content (see the "renderer_stats" WebView property)
+    static void tileFellBack();
+    // true if painting took much longer than the raster renderer usually does
+    static bool slowerThanRaster(double seconds);
+    static String dumpStats();
+    static void clearStats();
+
 protected:
 
     virtual void setupCanvas(const TileRenderInfo& renderInfo, SkCanvas* canvas) = 0;
@@ -94,13 +118,19 @@ protected:
     void drawTileInfo(SkCanvas* canvas, const TileRenderInfo& renderInfo,
             int pictureCount);
 
+    // number of strips to split the paint of the tile into
+    int stripsCount(const TileRenderInfo& renderInfo);
+
     virtual const String* getPerformanceTags(int& tagCount) = 0;
 
     // Performance tracking
     PerformanceMonitor m_perfMon;
 
 private:
+    static void recordPaint(RendererType type, double seconds);
+
     RendererType m_type;
+    double m_lastPaintTime;
     static RendererType g_currentType;
 };
 
@@ -29,9 +29,11 @@
 #if USE(ACCELERATED_COMPOSITING)
 
 #include "GLUtils.h"
+#include "GaneshRenderer.h"
 #include "RasterRenderer.h"
 #include "TextureInfo.h"
 #include "TilesManager.h"
+#include "TraceEventAndroid.h"
 
 #include <cutils/atomic.h>
 
@@ -54,6 +56,10 @@
 
 #endif // DEBUG
 
+// Above this fraction of the tile area, a dirty tile is fully repainted into
+// a new back texture rather than partially updated in its front texture
+#define MAX_PARTIAL_UPDATE_RATIO 0.5
+
 namespace WebCore {
 
 BaseTile::BaseTile(bool isLayerTile)
@@ -69,6 +75,10 @@ BaseTile::BaseTile(bool isLayerTile)
     , m_repaintPending(false)
     , m_lastDirtyPicture(0)
     , m_isTexturePainted(false)
+    , m_partialUpdate(false)
+    , m_fallbackRenderer(0)
+    , m_ganeshTextRenderer(0)
+    , m_preferRaster(false)
     , m_isLayerTile(isLayerTile)
     , m_drawCount(0)
     , m_state(Unpainted)
@@ -101,6 +111,8 @@ BaseTile::~BaseTile()
         m_frontTexture->release(this);
 
     delete m_renderer;
+    delete m_fallbackRenderer;
+    delete m_ganeshTextRenderer;
     delete[] m_dirtyArea;
     delete[] m_fullRepaint;
 
@@ -122,6 +134,8 @@ void BaseTile::setContents(TilePainter* painter, int x, int y, float scale)
     }
 
     android::AutoMutex lock(m_atomicSync);
+    if (m_painter != painter)
+        m_preferRaster = false;
     m_painter = painter;
     m_x = x;
     m_y = y;
@@ -131,9 +145,13 @@ void BaseTile::setContents(TilePainter* painter, int x, int y, float scale)
 
 void BaseTile::reserveTexture()
 {
+    if (reservePartialUpdate())
+        return;
+
     BaseTileTexture* texture = TilesManager::instance()->getAvailableTexture(this);
 
     android::AutoMutex lock(m_atomicSync);
+    m_partialUpdate = false;
     if (texture && m_backTexture != texture) {
         XLOG("tile %p reserving texture %p, back was %p (front %p)",
              this, texture, m_backTexture, m_frontTexture);
@@ -148,6 +166,62 @@ void BaseTile::reserveTexture()
     }
 }
 
+// Checks whether the dirty area can be painted in place into the front
+// texture. It needs to hold the current content of the tile, and only a
+// small part of it must be dirty.
+bool BaseTile::reservePartialUpdate()
+{
+    // Ganesh renders the whole tile into the surface texture
+    if (BaseRenderer::getCurrentRendererType() != BaseRenderer::Raster
+        || !TilesManager::instance()->transferQueue()->supportsPartialUpdate())
+        return false;
+
+    android::AutoMutex lock(m_atomicSync);
+    if (m_partialUpdate)
+        return true;
+
+    if (!m_dirty || m_state != Unpainted || m_backTexture || !m_frontTexture
+        || !m_isTexturePainted || m_fullRepaint[m_currentDirtyAreaIndex])
+        return false;
+
+    if (m_frontTexture->owner() != this || !m_frontTexture->readyFor(this)
+        || m_frontTexture->isCompressed())
+        return false;
+
+    int tileWidth = TilesManager::instance()->tileWidth();
+    int tileHeight = TilesManager::instance()->tileHeight();
+    if (m_isLayerTile) {
+        tileWidth = TilesManager::instance()->layerTileWidth();
+        tileHeight = TilesManager::instance()->layerTileHeight();
+    }
+
+    float dirtyArea = 0;
+    SkRegion::Iterator cliperator(m_dirtyArea[m_currentDirtyAreaIndex]);
+    while (!cliperator.done()) {
+        SkRect realTileRect;
+        SkRect dirtyRect;
+        dirtyRect.set(cliperator.rect());
+        if (intersectWithRect(m_x, m_y, tileWidth, tileHeight,
+                              m_scale, dirtyRect, realTileRect))
+            dirtyArea += realTileRect.width() * realTileRect.height();
+        cliperator.next();
+    }
+
+    if (!dirtyArea || dirtyArea > tileWidth * tileHeight * MAX_PARTIAL_UPDATE_RATIO)
+        return false;
+
+    XLOG("tile %p (%d, %d) partially updating %.0f pixels of front texture %p",
+         this, m_x, m_y, dirtyArea, m_frontTexture);
+    m_partialUpdate = true;
+    return true;
+}
+
+bool BaseTile::hasPaintTexture()
+{
+    android::AutoMutex lock(m_atomicSync);
+    return m_backTexture || m_partialUpdate;
+}
+
 bool BaseTile::removeTexture(BaseTileTexture* texture)
 {
     XLOG("%p removeTexture %p, back %p front %p... page %p",
@@ -342,21 +416,27 @@ bool BaseTile::isTileVisible(const IntRect& viewTileBounds)
 }
 
 // This is called from the texture generation thread
-void BaseTile::paintBitmap()
+void BaseTile::paintBitmap(bool ganeshText)
 {
+    ANDROID_TRACE_EVENT("compositor", "BaseTile::paintBitmap");
     // We acquire the values below atomically. This ensures that we are reading
     // values correctly across cores. Further, once we have these values they
     // can be updated by other threads without consequence.
     m_atomicSync.lock();
     bool dirty = m_dirty;
-    BaseTileTexture* texture = m_backTexture;
+    bool partialUpdate = m_partialUpdate;
+    BaseTileTexture* texture = partialUpdate ? m_frontTexture : m_backTexture;
     SkRegion dirtyArea = m_dirtyArea[m_currentDirtyAreaIndex];
     float scale = m_scale;
     const int x = m_x;
     const int y = m_y;
     TilePainter* painter = m_painter;
+    bool urgent = !m_frontTexture
+        && m_drawCount + 1 >= TilesManager::instance()->getDrawGLCount();
+    bool preferRaster = m_preferRaster;
 
     if (!dirty || !texture) {
+        m_partialUpdate = false;
         m_atomicSync.unlock();
         return;
     }
@@ -391,6 +471,26 @@ void BaseTile::paintBitmap()
     renderInfo.tilePainter = painter;
     renderInfo.baseTile = this;
     renderInfo.textureInfo = textureInfo;
+    renderInfo.tileTexture = texture;
+    renderInfo.partialUpdate = partialUpdate;
+    renderInfo.urgent = urgent;
+
+    BaseRenderer* renderer = m_renderer;
+    if (renderer->getType() == BaseRenderer::Ganesh
+        && (preferRaster || !GaneshRenderer::canRender(renderInfo))) {
+        if (!m_fallbackRenderer)
+            m_fallbackRenderer = new RasterRenderer();
+        renderer = m_fallbackRenderer;
+        BaseRenderer::tileFellBack();
+    } else if (ganeshText && renderer->getType() == BaseRenderer::Raster
+               && !preferRaster && !partialUpdate
+               && GaneshRenderer::canRender(renderInfo)) {
+        // a partial update is small enough to be rastered, and Ganesh can
+        // only render whole tiles
+        if (!m_ganeshTextRenderer)
+            m_ganeshTextRenderer = new GaneshRenderer();
+        renderer = m_ganeshTextRenderer;
+    }
 
     const float tileWidth = renderInfo.tileSize.width();
     const float tileHeight = renderInfo.tileSize.height();
@@ -405,7 +505,10 @@ void BaseTile::paintBitmap()
         fullRepaint = true;
     }
 
-    bool surfaceTextureMode = textureInfo->getSharedTextureMode() == SurfaceTextureMode;
+    // Without partial update, the whole tile has to be repainted as the new
+    // texture doesn't hold any of the previous content
+    bool surfaceTextureMode = textureInfo->getSharedTextureMode() == SurfaceTextureMode
+        && !partialUpdate;
 
     if (surfaceTextureMode)
         fullRepaint = true;
@@ -447,7 +550,7 @@ void BaseTile::paintBitmap()
             renderInfo.invalRect = &finalRealRect;
             renderInfo.measurePerf = false;
 
-            pictureCount = m_renderer->renderTiledContent(renderInfo);
+            pictureCount = renderer->renderTiledContent(renderInfo);
         }
 
         cliperator.next();
@@ -461,16 +564,44 @@ void BaseTile::paintBitmap()
         renderInfo.invalRect = &rect;
         renderInfo.measurePerf = TilesManager::instance()->getShowVisualIndicator();
 
-        pictureCount = m_renderer->renderTiledContent(renderInfo);
+        pictureCount = renderer->renderTiledContent(renderInfo);
     }
 
+    TilesManager::instance()->frameTimings()->tilePainted();
+
+    // content Ganesh is slow with (e.g. lots of text or paths) is better
+    // painted on the CPU, until the tile gets different content
+    bool slowGanesh = renderer->getType() == BaseRenderer::Ganesh
+        && BaseRenderer::slowerThanRaster(renderer->lastPaintTime());
+
     m_atomicSync.lock();
+    if (slowGanesh) {
+        XLOG("tile %p painted slowly by Ganesh, falling back to raster", this);
+        m_preferRaster = true;
+    }
 
 #if DEPRECATED_SURFACE_TEXTURE_MODE
     texture->setTile(textureInfo, x, y, scale, painter, pictureCount);
 #endif
     texture->producerReleaseAndSwap();
-    if (texture == m_backTexture) {
+    if (partialUpdate) {
+        m_partialUpdate = false;
+        // The front texture is updated in place, so there's no back texture
+        // to validate or swap. If the tile got dirty again or a transfer
+        // failed while painting, the state went back to Unpainted.
+        if (texture == m_frontTexture && m_state == PaintingStarted && m_scale == scale) {
+            if (fullRepaint)
+                m_dirtyArea[m_currentDirtyAreaIndex].setEmpty();
+            else
+                m_dirtyArea[m_currentDirtyAreaIndex].op(dirtyArea, SkRegion::kDifference_Op);
+            m_dirty = !m_dirtyArea[m_currentDirtyAreaIndex].isEmpty();
+            m_state = m_dirty ? Unpainted : UpToDate;
+        } else {
+            m_dirty = true;
+            m_state = Unpainted;
+        }
+        XLOG("partially painted tile %p (%d, %d), texture %p, dirty=%d", this, x, y, texture, m_dirty);
+    } else if (texture == m_backTexture) {
         m_isTexturePainted = true;
 
         // set the fullrepaint flags
@@ -536,6 +667,9 @@ void BaseTile::discardBackTexture() {
         m_backTexture->release(this);
         m_backTexture = 0;
     }
+    // a discarded partial update leaves the front texture incomplete
+    for (int i = 0; i < m_maxBufferNumber; i++)
+        m_fullRepaint[i] = true;
     m_state = Unpainted;
     m_dirty = true;
 }
@@ -577,6 +711,12 @@ void BaseTile::backTextureTransferFail() {
     android::AutoMutex lock(m_atomicSync);
     m_state = Unpainted;
     m_dirty = true;
+    // the dirty area of a partial update is cleared when the paint ends, so
+    // make sure that the next paint covers the whole tile
+    if (m_partialUpdate) {
+        for (int i = 0; i < m_maxBufferNumber; i++)
+            m_fullRepaint[i] = true;
+    }
     // whether validatePaint is called before or after, it won't do anything
 }
 
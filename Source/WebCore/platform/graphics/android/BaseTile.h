@@ -98,13 +98,18 @@ public:
     void setPage(TiledPage* page) { m_page = page; }
 
     void reserveTexture();
+    // true if paintBitmap() has a texture to paint into: either the back
+    // texture, or the front texture when partially updating it
+    bool hasPaintTexture();
 
     bool isTileReady();
 
     void draw(float transparency, SkRect& rect, float scale);
 
-    // the only thread-safe function called by the background thread
-    void paintBitmap();
+    // the only thread-safe function called by the background thread.
+    // ganeshText is set for layer tiles with text that should be painted by
+    // Ganesh, on the worker owning its GL context, while rastering.
+    void paintBitmap(bool ganeshText = false);
 
     bool intersectWithRect(int x, int y, int tileWidth, int tileHeight,
                            float scale, const SkRect& dirtyRect,
@@ -142,6 +147,7 @@ public:
 
 private:
     void validatePaint();
+    bool reservePartialUpdate();
 
     GLWebViewState* m_glWebViewState;
 
@@ -180,12 +186,23 @@ private:
     // flag used to know if we have a texture that was painted at least once
     bool m_isTexturePainted;
 
+    // set when only small parts of the tile are dirty: they are then painted
+    // and uploaded in place into the front texture, instead of repainting
+    // the whole tile into a new back texture
+    bool m_partialUpdate;
+
     // This mutex serves two purposes. (1) It ensures that certain operations
     // happen atomically and (2) it makes sure those operations are synchronized
     // across all threads and cores.
     android::Mutex m_atomicSync;
 
     BaseRenderer* m_renderer;
+    // paints the tiles Ganesh can't, or is too slow for
+    BaseRenderer* m_fallbackRenderer;
+    // paints layer text with Ganesh while the current renderer is raster
+    BaseRenderer* m_ganeshTextRenderer;
+    // Ganesh was much slower than raster for the current content
+    bool m_preferRaster;
 
     bool m_isLayerTile;
 
@@ -50,12 +50,18 @@
 
 #endif // DEBUG
 
+#define BYTES_PER_PIXEL 4 // 8888 config
+
 namespace WebCore {
 
-BaseTileTexture::BaseTileTexture(uint32_t w, uint32_t h)
+BaseTileTexture::BaseTileTexture(uint32_t w, uint32_t h, bool isLayerTexture)
     : DoubleBufferedTexture(eglGetCurrentContext(),
                             TilesManager::instance()->getSharedTextureMode())
     , m_owner(0)
+    , m_isLayerTexture(isLayerTexture)
+    , m_compressedSize(0)
+    , m_directImage(EGL_NO_IMAGE_KHR)
+    , m_directImageBuffer(0)
     , m_busy(false)
 {
     m_size.set(w, h);
@@ -75,21 +81,73 @@ BaseTileTexture::~BaseTileTexture()
         SharedTexture* textures[3] = { m_textureA, m_textureB, 0 };
         destroyTextures(textures);
     }
+    if (m_directImage != EGL_NO_IMAGE_KHR)
+        eglDestroyImageKHR(eglGetCurrentDisplay(), m_directImage);
 #ifdef DEBUG_COUNT
     ClassTracker::instance()->decrement("BaseTileTexture");
 #endif
 }
 
-void BaseTileTexture::requireGLTexture()
+int BaseTileTexture::byteSize()
 {
-    if (!m_ownTextureId)
-        m_ownTextureId = GLUtils::createBaseTileGLTexture(m_size.width(), m_size.height());
+    return m_size.width() * m_size.height() * BYTES_PER_PIXEL;
 }
 
-void BaseTileTexture::discardGLTexture()
+TextureBudget::Category BaseTileTexture::budgetCategory()
+{
+    return m_isLayerTexture ? TextureBudget::LayerTileTextures : TextureBudget::BaseTileTextures;
+}
+
+bool BaseTileTexture::requireGLTexture()
 {
+    TextureBudget* budget = TilesManager::instance()->textureBudget();
+    TexturePool* pool = TilesManager::instance()->texturePool();
+    if (m_ownTextureId && m_compressedSize) {
+        // compressed storage can't be copied into, start from a new texture
+        pool->deleteLater(&m_ownTextureId);
+        budget->freed(budgetCategory(), m_compressedSize);
+        m_compressedSize = 0;
+    }
+
     if (m_ownTextureId)
-        GLUtils::deleteTexture(&m_ownTextureId);
+        return true;
+
+    m_ownTextureId = pool->acquire(m_size.width(), m_size.height());
+    if (!m_ownTextureId) {
+        XLOGC("ERROR: could not allocate GL texture for %p", this);
+        budget->allocationFailed();
+        return false;
+    }
+    budget->allocated(budgetCategory(), byteSize());
+    return true;
+}
+
+void BaseTileTexture::discardGLTexture()
+{
+    TextureBudget* budget = TilesManager::instance()->textureBudget();
+    TexturePool* pool = TilesManager::instance()->texturePool();
+    if (m_ownTextureId) {
+        budget->freed(budgetCategory(), glByteSize());
+        // only the plain RGBA storage can be handed to another tile
+        if (m_compressedSize || m_directImage != EGL_NO_IMAGE_KHR)
+            pool->deleteLater(&m_ownTextureId);
+        else
+            pool->recycle(&m_ownTextureId, m_size.width(), m_size.height());
+        m_compressedSize = 0;
+    }
+
+    if (m_directImage != EGL_NO_IMAGE_KHR) {
+        eglDestroyImageKHR(eglGetCurrentDisplay(), m_directImage);
+        m_directImage = EGL_NO_IMAGE_KHR;
+        m_directImageBuffer = 0;
+    }
+    {
+        // a producer painting into the buffer keeps its own reference
+        android::Mutex::Autolock lock(m_directBufferLock);
+        if (m_directBuffer.get())
+            budget->freed(budgetCategory(), byteSize());
+        m_directBuffer.clear();
+    }
 
     if (m_owner) {
         // clear both Tile->Texture and Texture->Tile links
@@ -98,6 +156,77 @@ void BaseTileTexture::discardGLTexture()
     }
 }
 
+bool BaseTileTexture::setCompressedContent(const uint8_t* data, int size)
+{
+    if (!m_ownTextureId && !requireGLTexture())
+        return false;
+
+    TextureBudget* budget = TilesManager::instance()->textureBudget();
+    int previousSize = glByteSize();
+    if (!GLUtils::updateTextureWithETC1(m_ownTextureId, m_size.width(), m_size.height(),
+                                        data, size)) {
+        // the previous storage is in an undefined state
+        XLOGC("ERROR: could not upload compressed content for %p", this);
+        TilesManager::instance()->texturePool()->deleteLater(&m_ownTextureId);
+        budget->freed(budgetCategory(), previousSize);
+        m_compressedSize = 0;
+        budget->allocationFailed();
+        return false;
+    }
+
+    m_compressedSize = size;
+    budget->freed(budgetCategory(), previousSize);
+    budget->allocated(budgetCategory(), m_compressedSize);
+    return true;
+}
+
+sp<android::GraphicBuffer> BaseTileTexture::acquireDirectBuffer()
+{
+    android::Mutex::Autolock lock(m_directBufferLock);
+    if (!m_directBuffer.get()) {
+        m_directBuffer = new android::GraphicBuffer(m_size.width(), m_size.height(),
+                                                    android::PIXEL_FORMAT_RGBA_8888,
+                                                    android::GraphicBuffer::USAGE_HW_TEXTURE
+                                                    | android::GraphicBuffer::USAGE_SW_WRITE_OFTEN);
+        if (m_directBuffer->initCheck() != android::NO_ERROR) {
+            XLOGC("ERROR: could not allocate direct buffer for texture %p", this);
+            m_directBuffer.clear();
+        } else
+            TilesManager::instance()->textureBudget()->allocated(budgetCategory(), byteSize());
+    }
+    return m_directBuffer;
+}
+
+bool BaseTileTexture::bindDirectBuffer()
+{
+    sp<android::GraphicBuffer> buffer;
+    {
+        android::Mutex::Autolock lock(m_directBufferLock);
+        buffer = m_directBuffer;
+    }
+    if (!buffer.get() || !m_ownTextureId)
+        return false;
+
+    EGLDisplay display = eglGetCurrentDisplay();
+    if (m_directImageBuffer != buffer.get()) {
+        if (m_directImage != EGL_NO_IMAGE_KHR)
+            eglDestroyImageKHR(display, m_directImage);
+        EGLClientBuffer clientBuffer = (EGLClientBuffer)buffer->getNativeBuffer();
+        m_directImage = eglCreateImageKHR(display, EGL_NO_CONTEXT,
+                                          EGL_NATIVE_BUFFER_ANDROID, clientBuffer, 0);
+        GLUtils::checkEglError("eglCreateImageKHR", m_directImage != EGL_NO_IMAGE_KHR);
+        m_directImageBuffer = m_directImage != EGL_NO_IMAGE_KHR ? buffer.get() : 0;
+    }
+    if (m_directImage == EGL_NO_IMAGE_KHR)
+        return false;
+
+    // Re-specifying the target each time makes the driver pick up the new
+    // content written by the CPU
+    glBindTexture(GL_TEXTURE_2D, m_ownTextureId);
+    glEGLImageTargetTexture2DOES(GL_TEXTURE_2D, (GLeglImageOES)m_directImage);
+    return !GLUtils::checkGlError("glEGLImageTargetTexture2DOES");
+}
+
 void BaseTileTexture::destroyTextures(SharedTexture** textures)
 {
     int x = 0;
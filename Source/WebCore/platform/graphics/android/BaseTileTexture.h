@@ -28,6 +28,7 @@
 
 #include "DoubleBufferedTexture.h"
 #include "GLWebViewState.h"
+#include "TextureBudget.h"
 #include "TextureOwner.h"
 #include "TilePainter.h"
 #include <SkBitmap.h>
@@ -66,7 +67,7 @@ class BaseTileTexture : public DoubleBufferedTexture {
 public:
     // This object is to be constructed on the consumer's thread and must have
     // a width and height greater than 0.
-    BaseTileTexture(uint32_t w, uint32_t h);
+    BaseTileTexture(uint32_t w, uint32_t h, bool isLayerTexture = false);
     virtual ~BaseTileTexture();
 
     // these functions override their parent
@@ -104,17 +105,35 @@ public:
 
     // OpenGL ID of backing texture, 0 when not allocated
     GLuint m_ownTextureId;
-    // these are used for dynamically (de)allocating backing graphics memory
-    void requireGLTexture();
+    // these are used for dynamically (de)allocating backing graphics memory,
+    // accounted for in TilesManager's TextureBudget. requireGLTexture()
+    // returns false if the allocation failed.
+    bool requireGLTexture();
     void discardGLTexture();
+    int byteSize();
+
+    // Replaces the storage of m_ownTextureId with ETC1 compressed content,
+    // which can't be partially updated: requireGLTexture() turns it back
+    // into an uncompressed texture. Only used by the consumer thread.
+    bool setCompressedContent(const uint8_t* data, int size);
+    bool isCompressed() { return m_compressedSize; }
 
     void setOwnTextureTileInfoFromQueue(const TextureTileInfo* info);
 
+    // In DirectUpload mode, the producer paints straight into this graphic
+    // buffer (allocated on first use), and the consumer then binds it as the
+    // storage of m_ownTextureId.
+    sp<android::GraphicBuffer> acquireDirectBuffer();
+    bool bindDirectBuffer();
+
 protected:
     HashMap<SharedTexture*, TextureTileInfo*> m_texturesInfo;
 
 private:
     void destroyTextures(SharedTexture** textures);
+    TextureBudget::Category budgetCategory();
+    // size of the storage of m_ownTextureId
+    int glByteSize() { return m_compressedSize ? m_compressedSize : byteSize(); }
     TextureTileInfo m_ownTextureTileInfo;
 
     SkSize m_size;
@@ -122,6 +141,16 @@ private:
 
     // BaseTile owning the texture, only modified by UI thread
     TextureOwner* m_owner;
+    bool m_isLayerTexture;
+    // size of the compressed content, 0 when not compressed
+    int m_compressedSize;
+
+    // Direct buffer and the EGLImage wrapping it, the latter only used by the
+    // UI thread
+    sp<android::GraphicBuffer> m_directBuffer;
+    android::Mutex m_directBufferLock;
+    EGLImageKHR m_directImage;
+    android::GraphicBuffer* m_directImageBuffer;
 
     // This values signals that the texture is currently in use by the consumer.
     // This allows us to prevent the owner of the texture from changing while the
@@ -34,6 +34,8 @@
 #define MIN_ASHMEM_ALLOC_SIZE   (32*1024)
 
 
+static WebCore::ImageDecodeBackend* gDecodeBackend = 0;
+
 static bool should_use_ashmem(const SkBitmap& bm) {
     return bm.getSize() >= MIN_ASHMEM_ALLOC_SIZE;
 }
@@ -56,8 +58,13 @@ BitmapAllocatorAndroid::~BitmapAllocatorAndroid()
 
 bool BitmapAllocatorAndroid::allocPixelRef(SkBitmap* bitmap, SkColorTable*)
 {
-    SkPixelRef* ref;
-    if (should_use_ashmem(*bitmap)) {
+    SkPixelRef* ref = 0;
+    if (gDecodeBackend)
+        ref = gDecodeBackend->createPixelRef(fStream, *bitmap, fSampleSize);
+    // Skia decodes whatever the backend turned down
+    if (ref) {
+//        SkDebugf("backend [%d %d]\n", bitmap->width(), bitmap->height());
+    } else if (should_use_ashmem(*bitmap)) {
 //        SkDebugf("ashmem [%d %d]\n", bitmap->width(), bitmap->height());
         ref = new SkImageRef_ashmem(fStream, bitmap->config(), fSampleSize);
     } else {
@@ -68,4 +75,20 @@ bool BitmapAllocatorAndroid::allocPixelRef(SkBitmap* bitmap, SkColorTable*)
     return true;
 }
 
+void BitmapAllocatorAndroid::setCacheBudget(size_t bytes)
+{
+    SkImageRef_GlobalPool::SetRAMBudget(bytes);
+}
+
+void BitmapAllocatorAndroid::setDecodeBackend(ImageDecodeBackend* backend)
+{
+    gDecodeBackend = backend;
+}
+
+void BitmapAllocatorAndroid::purgeCache()
+{
+    // purges unlocked images until the pool is down to this size
+    SkImageRef_GlobalPool::SetRAMUsed(0);
+}
+
 }
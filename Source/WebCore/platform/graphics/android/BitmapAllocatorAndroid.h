@@ -28,11 +28,29 @@
 
 #include "SkBitmap.h"
 
+class SkStream;
+
 namespace WebCore {
 
     class SharedBuffer;
     class SharedBufferStream;
 
+    /** A platform decoder (e.g. a hardware JPEG block) that can take over
+        some images from Skia. It is asked once per image, when the image's
+        data is complete, and must be callable from any thread.
+     */
+    class ImageDecodeBackend {
+    public:
+        virtual ~ImageDecodeBackend() {}
+
+        /** Returns a pixel ref that decodes the stream into pixels matching
+            the bitmap's config and (already subsampled) size when it is
+            locked, or NULL to leave this image to Skia. The pixel ref
+            must be re-decodable, like the Skia ones it replaces.
+         */
+        virtual SkPixelRef* createPixelRef(SkStream*, const SkBitmap&, int sampleSize) = 0;
+    };
+
     /** Returns a custom allocator that takes advantage of ashmem and global
         pools to best manage the pixel memory for a decoded image. This should
         be used for images that are logically immutable, and can be re-decoded
@@ -46,6 +64,20 @@ namespace WebCore {
         // overrides
         virtual bool allocPixelRef(SkBitmap*, SkColorTable*);
 
+        /** Decoded images too small for ashmem live in a global heap pool,
+            shared by every WebView in the process, until this many bytes
+            push them out. Larger ones are in ashmem the kernel unpins at
+            will. Either way they are decoded again when next drawn.
+         */
+        static void setCacheBudget(size_t bytes);
+        /** Drops the pixels of every decoded image not being drawn now. */
+        static void purgeCache();
+
+        /** Installs the backend tried before Skia for every new image. Not
+            owned; set it before pages load and leave it installed.
+         */
+        static void setDecodeBackend(ImageDecodeBackend*);
+
     private:
         SharedBufferStream* fStream;
         int                 fSampleSize;
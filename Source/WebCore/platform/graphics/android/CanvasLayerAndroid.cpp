@@ -40,7 +40,6 @@ IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 namespace WebCore {
 
-std::map<int, uint32_t> CanvasLayerAndroid::s_bitmap_map2;
 std::map<uint32_t, GLuint> CanvasLayerAndroid::s_texture_map2;
 std::map<uint32_t, int> CanvasLayerAndroid::s_width_map;
 std::map<uint32_t, int> CanvasLayerAndroid::s_height_map;
@@ -58,12 +57,15 @@ int CanvasLayerAndroid::s_maxTextureThreshold = 1;     //Aggressive collection o
 CanvasLayerAndroid::CanvasLayerAndroid()
     : LayerAndroid((RenderLayer*)0)
     , m_canvas_id(-1)
+    , m_batchesValid(false)
 {
 }
 
 CanvasLayerAndroid::CanvasLayerAndroid(const CanvasLayerAndroid& layer)
     : LayerAndroid(layer)
     , m_canvas_id(layer.m_canvas_id)
+    , m_batches(layer.m_batches)
+    , m_batchesValid(layer.m_batchesValid)
 {
     SkPicture copy_picture = layer.getPicture();
     m_currentPicture.swap(copy_picture);
@@ -220,6 +222,7 @@ void CanvasLayerAndroid::setPicture(SkPicture& picture)
 {
     MutexLocker locker(m_mutex);
     m_currentPicture.swap(picture);
+    m_batchesValid = false;
     if(m_currentBitmap.width() != m_currentPicture.width() || m_currentBitmap.height() != m_currentPicture.height())
     {
         if(!(m_currentBitmap.isNull() || m_currentBitmap.empty()))
@@ -250,273 +253,216 @@ SkBitmap CanvasLayerAndroid::ScaleBitmap(SkBitmap src, float sx, float sy)
     return dst;
 }
 
-bool CanvasLayerAndroid::drawGL()
+bool CanvasLayerAndroid::batchesAreUploaded() const
+{
+    for(size_t ii=0; ii<m_batches.size(); ++ii)
+    {
+        if(s_texture_map2.find(m_batches[ii].generationID) == s_texture_map2.end())
+            return false;
+    }
+    return true;
+}
+
+bool CanvasLayerAndroid::buildBatches(std::vector<uint32_t>& generationIDs)
 {
     SkAltCanvas canvas(m_currentBitmap);
-    if(m_currentBitmap.isNull() || m_currentBitmap.empty())
-        return drawChildrenGL();
+    m_currentPicture.drawAltCanvas(&canvas);
+    int numBitmaps = canvas.getNumBitmaps();
+    int numPrimitives = canvas.getNumPrimitives();
+    int bitmap_height, bitmap_width;
 
-    std::vector<uint32_t> generationIDs;
-    std::vector<uint32_t> generationIDsUsed;
+    m_batches.clear();
+    m_batchesValid = false;
 
-    //Need to lock since we track oom canvases here
-    MutexLocker locker(s_mutex);
+    //Bitmaps sharing a generation id share a texture and a batch
+    std::map<uint32_t, int> batch_index;
+    std::vector<int> bitmap_batch;
 
-    //if(m_canvas_id >= 0 && m_canvas != NULL)
+    for(int jj=0; jj<numBitmaps; ++jj)
     {
-        m_currentPicture.drawAltCanvas(&canvas);
-        int numBitmaps = canvas.getNumBitmaps();
-        int numPrimitives = canvas.getNumPrimitives();
-        int bitmap_height, bitmap_width;
+        SkBitmap* bmp = canvas.getBitmap(jj);
+        bitmap_height = bmp->height();
+        bitmap_width = bmp->width();
 
-        //Clear content before new run
-        s_bitmap_map2.clear();
+        uint32_t generationID = bmp->getGenerationID();
 
-        //Time to transfer setup from the TilesManager to the custom shader
-        //CanvasLayerShader shader;
-        if(!s_shader_initialized)
-        {
-            glGetIntegerv(GL_MAX_TEXTURE_SIZE, &s_maxTextureSize);
-            s_shader.initialize();
-            s_shader_initialized = true;
-        }
+        std::map<uint32_t, int>::iterator tmp_it = s_texture_usage.find(generationID);
+        if(tmp_it == s_texture_usage.end())
+            s_texture_usage.insert(std::make_pair(generationID, 0));
 
-        for(int jj=0; jj<numBitmaps; ++jj)
+        GLuint texture;
+        std::map<uint32_t, GLuint>::iterator it = s_texture_map2.find(generationID);
+        if(it != s_texture_map2.end())
         {
-            SkBitmap* bmp = canvas.getBitmap(jj);
-            bitmap_height = bmp->height();
-            bitmap_width = bmp->width();
-
-            uint32_t generationID = bmp->getGenerationID();
-
-            generationIDsUsed.push_back(generationID);
-
-            std::map<uint32_t, int>::iterator tmp_it = s_texture_usage.find(generationID);
-            if(tmp_it == s_texture_usage.end())
-                s_texture_usage.insert(std::make_pair(generationID, 0));
-
-            GLuint texture;
-            std::map<uint32_t, GLuint>::iterator it = s_texture_map2.find(generationID);
-            if(it != s_texture_map2.end())
+            //Find the bitmap and add the canvas to the generationID
+            std::map<uint32_t, std::vector<int> >::iterator ref_it = s_texture_refs.find(generationID);
+            if(ref_it != s_texture_refs.end())
             {
-                texture = it->second;
-
-                //Find the bitmap and add the canvas to the generationID
-                std::map<uint32_t, std::vector<int> >::iterator ref_it = s_texture_refs.find(generationID);
-                if(ref_it != s_texture_refs.end())
+                std::vector<int>& canvas_list = ref_it->second;
+                if(std::find(canvas_list.begin(), canvas_list.end(), m_canvas_id) == canvas_list.end())
                 {
-                    std::vector<int>& canvas_list = ref_it->second;
-                    if(std::find(canvas_list.begin(), canvas_list.end(), m_canvas_id) == canvas_list.end())
-                    {
-                        canvas_list.push_back(m_canvas_id);
-                    }
+                    canvas_list.push_back(m_canvas_id);
                 }
-            }else
+            }
+        }else
+        {
+            float scale = 1.0f;
+            if(bitmap_height > s_maxTextureSize)
             {
-                float scale = 1.0f;
-                if(bitmap_height > s_maxTextureSize)
+                float tmp_scale = (float)s_maxTextureSize/(float)bitmap_height;
+                if(tmp_scale < scale)
                 {
-                    float tmp_scale = (float)s_maxTextureSize/(float)bitmap_height;
-                    if(tmp_scale < scale)
-                    {
-                        scale = tmp_scale;
-                    }
-                }
-
-                if(bitmap_width > s_maxTextureSize)
-                {
-                    float tmp_scale = (float)s_maxTextureSize/(float)bitmap_width;
-                    if(tmp_scale < scale)
-                        scale = tmp_scale;
+                    scale = tmp_scale;
                 }
+            }
 
-                SkBitmap dst = ScaleBitmap(*bmp, scale, scale);
+            if(bitmap_width > s_maxTextureSize)
+            {
+                float tmp_scale = (float)s_maxTextureSize/(float)bitmap_width;
+                if(tmp_scale < scale)
+                    scale = tmp_scale;
+            }
 
-                glGenTextures(1, &texture);
-                bool val = GLUtils::createTextureWithBitmapFailSafe(texture, dst);
-                //Do not draw if encounter GL error
-                if(!val)
-                {
-                    s_canvas_oom.push_back(m_canvas_id);
-                    return drawChildrenGL();
-                }
+            SkBitmap dst = ScaleBitmap(*bmp, scale, scale);
 
-                //Store for future runs
-                s_texture_map2.insert(std::make_pair(generationID, texture));
-                s_width_map.insert(std::make_pair(generationID, bitmap_width));
-                s_height_map.insert(std::make_pair(generationID, bitmap_height));
+            glGenTextures(1, &texture);
+            bool val = GLUtils::createTextureWithBitmapFailSafe(texture, dst);
+            //Do not draw if encounter GL error
+            if(!val)
+            {
+                glDeleteTextures(1, &texture);
+                return false;
+            }
 
-                //Store for asset management
-                generationIDs.push_back(generationID);
-                std::vector<int> canvas_list;
-                canvas_list.push_back(m_canvas_id);
-                s_texture_refs.insert(std::make_pair(generationID, canvas_list));
+            //Store for future runs
+            s_texture_map2.insert(std::make_pair(generationID, texture));
+            s_width_map.insert(std::make_pair(generationID, bitmap_width));
+            s_height_map.insert(std::make_pair(generationID, bitmap_height));
 
-            }
+            //Store for asset management
+            generationIDs.push_back(generationID);
+            std::vector<int> canvas_list;
+            canvas_list.push_back(m_canvas_id);
+            s_texture_refs.insert(std::make_pair(generationID, canvas_list));
 
-            s_bitmap_map2.insert(std::make_pair(jj, generationID));
         }
 
-        glUseProgram(s_shader.getProgram());
-        glUniform1i(s_shader.getSampler(), 0);
-        s_shader.setViewport(TilesManager::instance()->shader()->getViewport());
-        s_shader.setTitleBarHeight(TilesManager::instance()->shader()->getTitleBarHeight());
-        s_shader.setViewRect(TilesManager::instance()->shader()->getViewRect());
-        s_shader.setWebViewRect(TilesManager::instance()->shader()->getWebViewRect());
-        s_shader.setClipRect(TilesManager::instance()->shader()->getClipRect());
-        s_shader.setScreenClip(TilesManager::instance()->shader()->getScreenClip());
-        s_shader.setDocumentViewport(TilesManager::instance()->shader()->getDocumentViewport());
-        s_shader.setAlphaLayer(TilesManager::instance()->shader()->getAlphaLayer());
-        s_shader.setScale(TilesManager::instance()->shader()->getScale());
-        s_shader.setRepositionMatrix(TilesManager::instance()->shader()->getRepositionMatrix());
-        s_shader.setWebViewMatrix(TilesManager::instance()->shader()->getWebViewMatrix());
-
-        std::map<int, std::vector<SkRect> > primitives_map;
-        std::map<int, std::vector<FloatRect> > primTexCoord_map;
-        std::map<int, std::vector<int> > primScaleX_map;
-        std::map<int, std::vector<int> > primScaleY_map;
-
-        int texture_id;
-        for(int ii=0; ii<numPrimitives; ++ii)
+        std::map<uint32_t, int>::iterator batch_it = batch_index.find(generationID);
+        if(batch_it == batch_index.end())
         {
-            SkRect& rect = canvas.getPrimitive(ii);
-            SkIRect& tex_rect = canvas.getPrimitiveTexCoord(ii);
-            int& _scaleX = canvas.getScaleX(ii);
-            int& _scaleY = canvas.getScaleY(ii);
+            batch_index.insert(std::make_pair(generationID, (int)m_batches.size()));
+            bitmap_batch.push_back(m_batches.size());
+            m_batches.push_back(TextureBatch());
+            m_batches.back().generationID = generationID;
+        }
+        else
+            bitmap_batch.push_back(batch_it->second);
+    }
 
-            int& bm = canvas.getPrimitiveBmMap(ii);
+    for(int ii=0; ii<numPrimitives; ++ii)
+    {
+        SkRect& rect = canvas.getPrimitive(ii);
+        SkIRect& tex_rect = canvas.getPrimitiveTexCoord(ii);
+        int& _scaleX = canvas.getScaleX(ii);
+        int& _scaleY = canvas.getScaleY(ii);
 
-            std::map<int, uint32_t>::iterator it_bm = s_bitmap_map2.find(bm);
-            if(it_bm != s_bitmap_map2.end())
-            {
-                uint32_t generationID = it_bm->second;  //Get the generation id from the map
+        int& bm = canvas.getPrimitiveBmMap(ii);
+        if(bm < 0 || bm >= numBitmaps)
+            continue;
 
-                std::map<uint32_t, GLuint>::iterator it_tm = s_texture_map2.find(generationID);
-                std::map<uint32_t, int>::iterator it_wm = s_width_map.find(generationID);
-                std::map<uint32_t, int>::iterator it_hm = s_height_map.find(generationID);
+        TextureBatch& batch = m_batches[bitmap_batch[bm]];
 
-                if(it_tm != s_texture_map2.end())
-                {
-                    texture_id = it_tm->second;
+        std::map<uint32_t, int>::iterator it_wm = s_width_map.find(batch.generationID);
+        std::map<uint32_t, int>::iterator it_hm = s_height_map.find(batch.generationID);
+        if(it_wm == s_width_map.end() || it_hm == s_height_map.end())
+            continue;
 
-                    std::map<int, std::vector<SkRect> >::iterator pr_it = primitives_map.find(texture_id);
-                    std::map<int, std::vector<FloatRect> >::iterator pr_tx_it = primTexCoord_map.find(texture_id);
-                    std::map<int, std::vector<int> >::iterator prScX_it = primScaleX_map.find(texture_id);
-                    std::map<int, std::vector<int> >::iterator prScY_it = primScaleY_map.find(texture_id);
+        SkRect temp;
+        temp.set(rect.fLeft, rect.fTop, rect.fRight, rect.fBottom);
+        batch.primitives.push_back(temp);
 
-                    if(pr_it != primitives_map.end() &&
-                        pr_tx_it != primTexCoord_map.end() &&
-                        prScX_it != primScaleX_map.end() &&
-                        prScY_it != primScaleY_map.end() )
-                    {
-                        std::vector<SkRect>& primitives = pr_it->second;
-                        std::vector<FloatRect>& primTexCoord = pr_tx_it->second;
-                        std::vector<int>& primScaleX = prScX_it->second;
-                        std::vector<int>& primScaleY = prScY_it->second;
-
-                        SkRect temp;
-                        temp.set(rect.fLeft, rect.fTop, rect.fRight, rect.fBottom);
-                        primitives.push_back(temp);
-
-                        int width = tex_rect.fRight - tex_rect.fLeft;
-                        int height = tex_rect.fBottom - tex_rect.fTop;
-
-                        //TODO::Defensive programming needed here
-                        //DO not assume this will succeed
-                        int bitmap_width_m = it_wm->second;
-                        int bitmap_height_m = it_hm->second;
-
-                        float scaling_width = (float) width/ (float) bitmap_width_m;
-                        float scaling_height = (float) height/ (float) bitmap_height_m;
-
-                        FloatRect textemp((float)tex_rect.fLeft/(float)bitmap_width_m,
-                                    (float)tex_rect.fTop/(float)bitmap_height_m,
-                                    scaling_width,
-                                    scaling_height);
-                        primTexCoord.push_back(textemp);
-
-                        primScaleX.push_back(_scaleX);
-                        primScaleY.push_back(_scaleY);
-                    }
-                    else
-                    {
-                        std::vector<SkRect> primitives;
-                        std::vector<FloatRect> primTexCoord;
-                        std::vector<int> primScaleX;
-                        std::vector<int> primScaleY;
-
-                        SkRect temp;
-                        temp.set(rect.fLeft, rect.fTop, rect.fRight, rect.fBottom);
-                        primitives.push_back(temp);
-
-                        int width = tex_rect.fRight - tex_rect.fLeft;
-                        int height = tex_rect.fBottom - tex_rect.fTop;
-
-                        //TODO::Defensive programming needed here
-                        //DO not assume this will succeed
-                        int bitmap_width_m = it_wm->second;
-                        int bitmap_height_m = it_hm->second;
-
-                        float scaling_width = (float) width/ (float) bitmap_width_m;
-                        float scaling_height = (float) height/ (float) bitmap_height_m;
-
-                        FloatRect textemp((float)tex_rect.fLeft/(float)bitmap_width_m,
-                                    (float)tex_rect.fTop/(float)bitmap_height_m,
-                                    scaling_width,
-                                    scaling_height);
-                        primTexCoord.push_back(textemp);
-
-                        primScaleX.push_back(_scaleX);
-                        primScaleY.push_back(_scaleY);
-
-                        //Add it to map
-                        primitives_map.insert(std::make_pair(texture_id, primitives));
-                        primTexCoord_map.insert(std::make_pair(texture_id, primTexCoord));
-                        primScaleX_map.insert(std::make_pair(texture_id, primScaleX));
-                        primScaleY_map.insert(std::make_pair(texture_id, primScaleY));
-                    }
-                }
-            }
-        }
+        int width = tex_rect.fRight - tex_rect.fLeft;
+        int height = tex_rect.fBottom - tex_rect.fTop;
 
-        for(int jj=0; jj<numBitmaps; ++jj)
-        {
-            SkBitmap* bmp = canvas.getBitmap(jj);
-            uint32_t generationID = bmp->getGenerationID();
+        int bitmap_width_m = it_wm->second;
+        int bitmap_height_m = it_hm->second;
 
-            GLuint texture;
-            std::map<uint32_t, GLuint>::iterator it = s_texture_map2.find(generationID);
-            if(it != s_texture_map2.end())
-            {
-                texture = it->second;
+        float scaling_width = (float) width/ (float) bitmap_width_m;
+        float scaling_height = (float) height/ (float) bitmap_height_m;
 
-                std::map<int, std::vector<SkRect> >::iterator pr_it = primitives_map.find(texture);
-                std::map<int, std::vector<FloatRect> >::iterator pr_tx_it = primTexCoord_map.find(texture);
-                std::map<int, std::vector<int> >::iterator prScX_it = primScaleX_map.find(texture);
-                std::map<int, std::vector<int> >::iterator prScY_it = primScaleY_map.find(texture);
+        FloatRect textemp((float)tex_rect.fLeft/(float)bitmap_width_m,
+                    (float)tex_rect.fTop/(float)bitmap_height_m,
+                    scaling_width,
+                    scaling_height);
+        batch.texCoords.push_back(textemp);
 
-                if(pr_it != primitives_map.end() &&
-                    pr_tx_it != primTexCoord_map.end() &&
-                    prScX_it != primScaleX_map.end() &&
-                    prScY_it != primScaleY_map.end() )
-                {
-                    std::vector<SkRect>& primitives = pr_it->second;
-                    std::vector<FloatRect>& primTexCoord = pr_tx_it->second;
-                    std::vector<int>& primScaleX = prScX_it->second;
-                    std::vector<int>& primScaleY = prScY_it->second;
+        batch.scaleX.push_back(_scaleX);
+        batch.scaleY.push_back(_scaleY);
+    }
 
-                    if(primitives.size() > 0)
-                    {
-                        bool drawVal = s_shader.drawPrimitives(primitives, primTexCoord, primScaleX, primScaleY, texture, m_drawTransform, 1.0f);
+    m_batchesValid = true;
+    return true;
+}
 
-                        if(!drawVal)
-                        {
-                            s_canvas_oom.push_back(m_canvas_id);
-                            return drawChildrenGL();
-                        }
-                    }
-                }
-            }
+bool CanvasLayerAndroid::drawGL()
+{
+    if(m_currentBitmap.isNull() || m_currentBitmap.empty())
+        return drawChildrenGL();
+
+    std::vector<uint32_t> generationIDs;
+
+    //Need to lock since we track oom canvases here
+    MutexLocker locker(s_mutex);
+
+    //Time to transfer setup from the TilesManager to the custom shader
+    if(!s_shader_initialized)
+    {
+        glGetIntegerv(GL_MAX_TEXTURE_SIZE, &s_maxTextureSize);
+        s_shader.initialize();
+        s_shader_initialized = true;
+    }
+
+    //The UI thread redraws far more often than the page hands us a new
+    //picture, so only replay the picture when it changed or one of its
+    //textures was evicted; otherwise flush last frame's batches again
+    if(!m_batchesValid || !batchesAreUploaded())
+    {
+        if(!buildBatches(generationIDs))
+        {
+            s_canvas_oom.push_back(m_canvas_id);
+            return drawChildrenGL();
+        }
+    }
+
+    glUseProgram(s_shader.getProgram());
+    glUniform1i(s_shader.getSampler(), 0);
+    s_shader.setViewport(TilesManager::instance()->shader()->getViewport());
+    s_shader.setTitleBarHeight(TilesManager::instance()->shader()->getTitleBarHeight());
+    s_shader.setViewRect(TilesManager::instance()->shader()->getViewRect());
+    s_shader.setWebViewRect(TilesManager::instance()->shader()->getWebViewRect());
+    s_shader.setClipRect(TilesManager::instance()->shader()->getClipRect());
+    s_shader.setScreenClip(TilesManager::instance()->shader()->getScreenClip());
+    s_shader.setDocumentViewport(TilesManager::instance()->shader()->getDocumentViewport());
+    s_shader.setAlphaLayer(TilesManager::instance()->shader()->getAlphaLayer());
+    s_shader.setScale(TilesManager::instance()->shader()->getScale());
+    s_shader.setRepositionMatrix(TilesManager::instance()->shader()->getRepositionMatrix());
+    s_shader.setWebViewMatrix(TilesManager::instance()->shader()->getWebViewMatrix());
+
+    for(size_t ii=0; ii<m_batches.size(); ++ii)
+    {
+        TextureBatch& batch = m_batches[ii];
+        if(batch.primitives.empty())
+            continue;
+
+        std::map<uint32_t, GLuint>::iterator it = s_texture_map2.find(batch.generationID);
+        if(it == s_texture_map2.end())
+            continue;
+
+        bool drawVal = s_shader.drawPrimitives(batch.primitives, batch.texCoords, batch.scaleX, batch.scaleY, it->second, m_drawTransform, 1.0f);
+        if(!drawVal)
+        {
+            s_canvas_oom.push_back(m_canvas_id);
+            return drawChildrenGL();
         }
     }
 
@@ -553,12 +499,13 @@ bool CanvasLayerAndroid::drawGL()
     }
 
     //Keep track of usage and track bitmaps that need to be deleted
-    for(std::map<uint32_t, int>::iterator usage_it = s_texture_usage.begin();
-            usage_it != s_texture_usage.end();
-            ++usage_it)
+    for(size_t ii=0; ii<m_batches.size(); ++ii)
     {
-        uint32_t generationID = usage_it->first;
-        int& value = usage_it->second;
+        uint32_t generationID = m_batches[ii].generationID;
+
+        std::map<uint32_t, int>::iterator usage_it = s_texture_usage.find(generationID);
+        if(usage_it == s_texture_usage.end())
+            continue;
 
         //Check if this tex belongs to this canvas
         std::map<uint32_t, std::vector<int> >::iterator canvas_it = s_texture_refs.find(generationID);
@@ -568,8 +515,7 @@ bool CanvasLayerAndroid::drawGL()
             if(std::find(canvas_list.begin(), canvas_list.end(), m_canvas_id) == canvas_list.end())
                 continue;
 
-            if(std::find(generationIDsUsed.begin(), generationIDsUsed.end(), generationID) != generationIDsUsed.end())
-                --value;
+            --usage_it->second;
         }
     }
 
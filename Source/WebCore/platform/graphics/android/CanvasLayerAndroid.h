@@ -73,11 +73,25 @@ protected:
     SkBitmap ScaleBitmap(SkBitmap src, float sx, float sy);
 
 private:
+    //The picture's bitmap draws, grouped by the texture they sample
+    struct TextureBatch {
+        uint32_t generationID;
+        std::vector<SkRect> primitives;
+        std::vector<FloatRect> texCoords;
+        std::vector<int> scaleX;
+        std::vector<int> scaleY;
+    };
+
+    bool buildBatches(std::vector<uint32_t>& generationIDs);
+    bool batchesAreUploaded() const;
+
     SkPicture m_currentPicture;
     SkBitmap m_currentBitmap;
     IntRect m_r;
     int m_width, m_height;
     int m_canvas_id;
+    std::vector<TextureBatch> m_batches;
+    bool m_batchesValid;
     WTF::Mutex m_mutex;
 
     static WTF::Mutex s_mutex;
@@ -85,7 +99,6 @@ private:
     static bool s_shader_initialized;
     static CanvasLayerShader s_shader;
 
-    static std::map<int, uint32_t> s_bitmap_map2;
     static std::map<uint32_t, GLuint> s_texture_map2;
     static std::map<uint32_t, int> s_width_map;
     static std::map<uint32_t, int> s_height_map;
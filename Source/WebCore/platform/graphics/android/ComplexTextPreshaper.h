@@ -0,0 +1,63 @@
+/*
+ * Copyright 2012, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef ComplexTextPreshaper_h
+#define ComplexTextPreshaper_h
+
+#include <wtf/Noncopyable.h>
+#include <wtf/OwnPtr.h>
+#include <wtf/unicode/Unicode.h>
+
+namespace WebCore {
+
+class Font;
+struct PreshapeBatch;
+
+// Shapes the complex script words of a block on worker threads before its
+// lines are laid out. Line breaking then finds them in the shaped text cache
+// of FontAndroid.cpp rather than running HarfBuzz for each word in turn on
+// the WebCore thread. Only the shaping itself happens on the workers; the
+// Font is walked for script runs and fallback fonts on the WebCore thread.
+class ComplexTextPreshaper {
+    WTF_MAKE_NONCOPYABLE(ComplexTextPreshaper);
+public:
+    ComplexTextPreshaper();
+    ~ComplexTextPreshaper();
+
+    // Queues the words of |characters| the way line breaking measures them:
+    // the first word, then each space together with the word that follows.
+    void addWords(const Font&, const UChar* characters, unsigned length);
+
+    // Shapes the queued words, with the calling thread helping the workers,
+    // and adds them to the shaped text cache.
+    void shape();
+
+private:
+    OwnPtr<PreshapeBatch> m_batch;
+};
+
+} // namespace WebCore
+
+#endif // ComplexTextPreshaper_h
@@ -26,6 +26,7 @@
 
 #include "config.h"
 
+#include "ComplexTextPreshaper.h"
 #include "EmojiFont.h"
 #include "Font.h"
 #include "FontData.h"
@@ -48,10 +49,14 @@
 #include "HarfbuzzSkia.h"
 #include <unicode/normlzr.h>
 #include <unicode/uchar.h>
+#include <utils/threads.h>
+#include <wtf/HashSet.h>
+#include <wtf/ListHashSet.h>
 #include <wtf/OwnArrayPtr.h>
 #include <wtf/OwnPtr.h>
 #include <wtf/PassOwnArrayPtr.h>
 #include <wtf/PassOwnPtr.h>
+#include <wtf/ThreadPool.h>
 #include <wtf/unicode/Unicode.h>
 #endif
 
@@ -334,6 +339,25 @@ int Font::offsetForPositionForComplexText(const TextRun& run, float x,
     return count;
 }
 
+struct PreshapeBatch {
+};
+
+ComplexTextPreshaper::ComplexTextPreshaper()
+{
+}
+
+ComplexTextPreshaper::~ComplexTextPreshaper()
+{
+}
+
+void ComplexTextPreshaper::addWords(const Font&, const UChar*, unsigned)
+{
+}
+
+void ComplexTextPreshaper::shape()
+{
+}
+
 #else
 
 // TODO Should we remove the multilayer support?
@@ -363,6 +387,28 @@ static int truncateFixedPointToInteger(HB_Fixed value)
     return value >> 6;
 }
 
+// HB_ShapeItem() keeps scratch buffers in the HB_Face, so a face can only
+// shape one item at a time. The preshaping workers and the WebCore thread
+// share the faces through the FontPlatformData, and take one of these locks
+// around the shaping.
+static const unsigned cHarfbuzzFaceLockCount = 8;
+
+static android::Mutex& harfbuzzFaceLock(HB_Face face)
+{
+    static android::Mutex locks[cHarfbuzzFaceLockCount];
+    return locks[(reinterpret_cast<uintptr_t>(face) >> 4) % cHarfbuzzFaceLockCount];
+}
+
+// A script run as TextRunWalker found it, with the face and font to shape it
+// with. Finding script runs needs the Font, which only the WebCore thread may
+// use; with the segments recorded, a TextRunWalker can shape the run anywhere.
+struct ScriptRunSegment {
+    HB_ScriptItem item;
+    unsigned numCodePoints;
+    HB_Face face;
+    const FontPlatformData* fontPlatformData;
+};
+
 // TextRunWalker walks a TextRun and presents each script run in sequence. A
 // TextRun is a sequence of code-points with the same embedding level (i.e. they
 // are all left-to-right or right-to-left). A script run is a subsequence where
@@ -393,6 +439,16 @@ public:
     bool nextScriptRun();
     float widthOfFullRun();
 
+    // appendScriptRunSegments records the script runs of the TextRun without
+    // shaping them. A walker given those segments with setScriptRunSegments
+    // shapes them in turn and doesn't use its Font.
+    void appendScriptRunSegments(Vector<ScriptRunSegment>&);
+    void setScriptRunSegments(const Vector<ScriptRunSegment>* segments)
+    {
+        m_segments = segments;
+        reset();
+    }
+
     // setWordSpacingAdjustment sets a delta (in pixels) which is applied at
     // each word break in the TextRun.
     void setWordSpacingAdjustment(int wordSpacingAdjustment)
@@ -464,7 +520,9 @@ private:
 
     static const char* paths[NUM_SCRIPTS];
 
+    bool segmentScriptRun();
     void setupFontForScriptRun();
+    static SkTypeface* typefaceForScript(CustomScript);
     const FontPlatformData* setupComplexFont(CustomScript script,
                 const FontPlatformData& platformData);
     HB_FontRec* allocHarfbuzzFont();
@@ -505,6 +563,8 @@ private:
                       // each word break we accumulate error. This is the
                       // number of pixels that we are behind so far.
     unsigned m_letterSpacing; // pixels to be added after each glyph.
+    const Vector<ScriptRunSegment>* m_segments; // Script runs found beforehand.
+    size_t m_indexOfNextSegment; // Indexes |m_segments|.
 };
 
 
@@ -530,6 +590,8 @@ TextRunWalker::TextRunWalker(const TextRun& run, unsigned startingX, const Font*
     , m_padPerWordBreak(0)
     , m_padError(0)
     , m_letterSpacing(0)
+    , m_segments(0)
+    , m_indexOfNextSegment(0)
 {
     // Do not use |run| inside this constructor. Use |m_run| instead.
 
@@ -600,6 +662,7 @@ void TextRunWalker::reset()
         m_indexOfNextScriptRun = m_run.length() - 1;
     else
         m_indexOfNextScriptRun = 0;
+    m_indexOfNextSegment = 0;
     m_offsetX = m_startingX;
 }
 
@@ -612,6 +675,39 @@ void TextRunWalker::setBackwardsIteration(bool isBackwards)
 // Advance to the next script run, returning false when the end of the
 // TextRun has been reached.
 bool TextRunWalker::nextScriptRun()
+{
+    if (m_segments) {
+        if (m_indexOfNextSegment == m_segments->size())
+            return false;
+        const ScriptRunSegment& segment = m_segments->at(m_indexOfNextSegment++);
+        m_item.item = segment.item;
+        m_numCodePoints = segment.numCodePoints;
+        m_item.face = segment.face;
+        m_item.font->userData = const_cast<FontPlatformData*>(segment.fontPlatformData);
+    } else if (!segmentScriptRun())
+        return false;
+
+    shapeGlyphs();
+    setGlyphXPositions(rtl());
+
+    return true;
+}
+
+void TextRunWalker::appendScriptRunSegments(Vector<ScriptRunSegment>& segments)
+{
+    while (segmentScriptRun()) {
+        ScriptRunSegment segment;
+        segment.item = m_item.item;
+        segment.numCodePoints = m_numCodePoints;
+        segment.face = m_item.face;
+        segment.fontPlatformData = fontPlatformDataForScriptRun();
+        segments.append(segment);
+    }
+    reset();
+}
+
+// Find the next script run and set up its font, without shaping it.
+bool TextRunWalker::segmentScriptRun()
 {
     if (m_iterateBackwards) {
         // In right-to-left mode we need to render the shaped glyph backwards and
@@ -649,9 +745,6 @@ bool TextRunWalker::nextScriptRun()
     }
 
     setupFontForScriptRun();
-    shapeGlyphs();
-    setGlyphXPositions(rtl());
-
     return true;
 }
 
@@ -671,27 +764,47 @@ void TextRunWalker::setWordAndLetterSpacing(int wordSpacingAdjustment,
     setLetterSpacingAdjustment(letterSpacingAdjustment);
 }
 
+SkTypeface* TextRunWalker::typefaceForScript(CustomScript script)
+{
+    // Each file is loaded once and shared by all the sizes and styles it is
+    // used at. A file that fails to load isn't tried again.
+    static SkTypeface* typefaces[NUM_SCRIPTS];
+    static bool loaded[NUM_SCRIPTS];
+
+    if (!loaded[script]) {
+        typefaces[script] = SkTypeface::CreateFromFile(paths[script]);
+        loaded[script] = true;
+    }
+    return typefaces[script];
+}
+
 const FontPlatformData* TextRunWalker::setupComplexFont(
         CustomScript script,
         const FontPlatformData& platformData)
 {
     static FallbackHash fallbackPlatformData;
 
-    FallbackFontKey key(script, platformData.size());
-    FontPlatformData* newPlatformData = 0;
-
-    if (!fallbackPlatformData.contains(key)) {
-        SkTypeface* typeface = SkTypeface::CreateFromFile(paths[script]);
-        newPlatformData = new FontPlatformData(platformData, typeface);
-        SkSafeUnref(typeface);
-        fallbackPlatformData.set(key, newPlatformData);
-    }
-
-    if (!newPlatformData)
-        newPlatformData = fallbackPlatformData.get(key);
-
-    // If we couldn't allocate a new FontPlatformData, revert to the one passed
-    return newPlatformData ? newPlatformData : &platformData;
+    SkTypeface* typeface = typefaceForScript(script);
+    // If we couldn't load the font for the script, use the one passed
+    if (!typeface)
+        return &platformData;
+
+    // The fallback keeps the size, synthetic styles and orientation of the
+    // font it stands in for, so they are all part of the key.
+    int variant = script
+        | platformData.isFakeBold() << 8
+        | platformData.isFakeItalic() << 9
+        | platformData.orientation() << 10
+        | platformData.textOrientation() << 12;
+    FallbackFontKey key(variant, platformData.size());
+
+    FallbackHash::iterator it = fallbackPlatformData.find(key);
+    if (it != fallbackPlatformData.end())
+        return it->second;
+
+    FontPlatformData* newPlatformData = new FontPlatformData(platformData, typeface);
+    fallbackPlatformData.set(key, newPlatformData);
+    return newPlatformData;
 }
 
 void TextRunWalker::setupFontForScriptRun()
@@ -801,6 +914,7 @@ void TextRunWalker::shapeGlyphs()
     // So, we need to reset the num_glyphs to the capacity of the array.
     m_item.num_glyphs = m_glyphsArrayCapacity;
     resetGlyphArrays();
+    android::Mutex::Autolock lock(harfbuzzFaceLock(m_item.face));
     while (!HB_ShapeItem(&m_item)) {
         // We overflowed our arrays. Resize and retry.
         // HB_ShapeItem fills in m_item.num_glyphs with the needed size.
@@ -942,6 +1056,235 @@ const TextRun& TextRunWalker::getNormalizedTextRun(const TextRun& originalRun,
     return *normalizedRun;
 }
 
+// Layout measures each word of complex text several times and painting then
+// shapes it once more, so remember the glyphs HarfBuzz produced for the most
+// recent runs. Runs are keyed by their text, direction and the Font (which
+// covers the fallback list and the word and letter spacing); holding the Font
+// also keeps the FontPlatformData of the script runs alive.
+static const unsigned cMaxShapedTexts = 256;
+static const int cMaxShapedTextLength = 256;
+
+struct ShapedScriptRun {
+    const FontPlatformData* fontPlatformData;
+    Vector<uint16_t> glyphs;
+    Vector<SkScalar> xPositions; // from the start of the text
+};
+
+struct ShapedText {
+    ShapedText(const Font& font, const TextRun& run)
+        : font(font)
+        , text(run.characters(), run.length())
+        , rtl(run.rtl())
+        , width(0)
+    {
+    }
+
+    Font font;
+    String text;
+    bool rtl;
+    Vector<ShapedScriptRun> runs;
+    float width;
+};
+
+struct ShapedTextHash {
+    static unsigned hash(const ShapedText* shaped)
+    {
+        return StringHash::hash(shaped->text)
+            ^ shaped->font.primaryFont()->platformData().hash()
+            ^ shaped->rtl;
+    }
+
+    static bool equal(const ShapedText* a, const ShapedText* b)
+    {
+        return a == b || (a->rtl == b->rtl && a->text == b->text && a->font == b->font);
+    }
+
+    static const bool safeToCompareToEmptyOrDeleted = false;
+};
+
+typedef ListHashSet<ShapedText*, cMaxShapedTexts, ShapedTextHash> ShapedTextCache;
+
+static ShapedTextCache& shapedTextCache()
+{
+    DEFINE_STATIC_LOCAL(ShapedTextCache, cache, ());
+    return cache;
+}
+
+static void shapeScriptRuns(TextRunWalker& walker, ShapedText* shaped)
+{
+    while (walker.nextScriptRun()) {
+        shaped->runs.append(ShapedScriptRun());
+        ShapedScriptRun& scriptRun = shaped->runs.last();
+        scriptRun.fontPlatformData = walker.fontPlatformDataForScriptRun();
+        scriptRun.glyphs.append(walker.glyphs(), walker.length());
+        scriptRun.xPositions.append(walker.xPositions(), walker.length());
+        shaped->width += walker.width();
+    }
+}
+
+// Takes ownership of |shaped|, evicting the least recently used text if the
+// cache is full.
+static void addShapedText(ShapedText* shaped)
+{
+    ShapedTextCache& cache = shapedTextCache();
+    if (cache.contains(shaped)) {
+        delete shaped;
+        return;
+    }
+    if (cache.size() >= cMaxShapedTexts) {
+        ShapedText* oldest = cache.first();
+        cache.remove(cache.begin());
+        delete oldest;
+    }
+    cache.add(shaped);
+}
+
+// Returns the shaped runs of a TextRun that isn't justified, in the order
+// TextRunWalker iterates them by default. The result belongs to the cache
+// and is only valid until the next call.
+static const ShapedText* shapeText(const Font* font, const TextRun& run)
+{
+    ShapedTextCache& cache = shapedTextCache();
+    OwnPtr<ShapedText> shaped = adoptPtr(new ShapedText(*font, run));
+    ShapedTextCache::iterator it = cache.find(shaped.get());
+    if (it != cache.end()) {
+        // most recently used texts are at the end
+        ShapedText* cached = *it;
+        cache.remove(it);
+        cache.add(cached);
+        return cached;
+    }
+
+    TextRunWalker walker(run, 0, font);
+    walker.setWordAndLetterSpacing(font->wordSpacing(), font->letterSpacing());
+    shapeScriptRuns(walker, shaped.get());
+
+    ShapedText* result = shaped.leakPtr();
+    addShapedText(result);
+    return result;
+}
+
+// Justified runs are padded for the line they are on, and long runs are
+// rarely shaped twice. Fonts still loading compare unequal to everything, so
+// callers don't cache anything for them either.
+static bool canCacheShapedText(const TextRun& run)
+{
+    return !run.expansion() && run.length() <= cMaxShapedTextLength;
+}
+
+// Few words aren't worth handing over to the workers; they get shaped as
+// they are laid out. A batch stays well below the cache size so that it
+// doesn't evict its own first words.
+static const size_t cMinPreshapeJobs = 8;
+static const size_t cMaxPreshapeJobs = cMaxShapedTexts / 2;
+// The WebCore thread and up to three pool threads shape at once.
+static const unsigned cMaxPreshapeConcurrency = 4;
+
+struct PreshapeJob {
+    OwnPtr<ShapedText> shaped; // only |runs| and |width| are written by the workers
+    Vector<ScriptRunSegment> segments;
+    int wordSpacing;
+    int letterSpacing;
+};
+
+struct PreshapeBatch {
+    Vector<PreshapeJob*> jobs;
+    HashSet<ShapedText*, ShapedTextHash> texts;
+};
+
+static void runPreshapeJob(void* context)
+{
+    PreshapeJob* job = static_cast<PreshapeJob*>(context);
+    ShapedText* shaped = job->shaped.get();
+    ASSERT(!shaped->rtl);
+    TextRun run(shaped->text.characters(), shaped->text.length());
+    TextRunWalker walker(run, 0, 0);
+    walker.setWordAndLetterSpacing(job->wordSpacing, job->letterSpacing);
+    walker.setScriptRunSegments(&job->segments);
+    shapeScriptRuns(walker, shaped);
+}
+
+static bool canPreshape()
+{
+    static bool haveOtherCores = ThreadPool::numberOfProcessorCores() > 1;
+    return haveOtherCores;
+}
+
+static TaskKind& preshapeTasks()
+{
+    DEFINE_STATIC_LOCAL(TaskKind, kind, ("ComplexTextPreshaper", TaskPriorityUserBlocking, cMaxPreshapeConcurrency));
+    return kind;
+}
+
+// Returns once all the jobs are shaped. The calling thread shapes jobs too
+// rather than waiting idle.
+static void preshape(const Vector<PreshapeJob*>& jobs)
+{
+    ThreadPool& pool = ThreadPool::shared();
+    TaskGroup group;
+    for (size_t i = 0; i < jobs.size(); i++)
+        pool.dispatch(preshapeTasks(), runPreshapeJob, jobs[i], &group);
+    pool.wait(group);
+}
+
+ComplexTextPreshaper::ComplexTextPreshaper()
+    : m_batch(adoptPtr(new PreshapeBatch))
+{
+}
+
+ComplexTextPreshaper::~ComplexTextPreshaper()
+{
+    m_batch->texts.clear();
+    deleteAllValues(m_batch->jobs);
+}
+
+void ComplexTextPreshaper::addWords(const Font& font, const UChar* characters, unsigned length)
+{
+    if (font.loadingCustomFonts() || !canPreshape())
+        return;
+    // most text needs no shaping at all
+    if (font.codePath(TextRun(characters, length)) != Font::Complex)
+        return;
+
+    ShapedTextCache& cache = shapedTextCache();
+    unsigned start = 0;
+    while (start < length && m_batch->jobs.size() < cMaxPreshapeJobs) {
+        unsigned end = start + 1;
+        while (end < length && characters[end] != ' ')
+            end++;
+        TextRun run(characters + start, end - start);
+        start = end;
+        if (font.codePath(run) != Font::Complex || !canCacheShapedText(run))
+            continue;
+
+        OwnPtr<ShapedText> shaped = adoptPtr(new ShapedText(font, run));
+        if (cache.contains(shaped.get()) || m_batch->texts.contains(shaped.get()))
+            continue;
+
+        PreshapeJob* job = new PreshapeJob;
+        TextRunWalker walker(run, 0, &font);
+        walker.appendScriptRunSegments(job->segments);
+        job->wordSpacing = font.wordSpacing();
+        job->letterSpacing = font.letterSpacing();
+        m_batch->texts.add(shaped.get());
+        job->shaped = shaped.release();
+        m_batch->jobs.append(job);
+    }
+}
+
+void ComplexTextPreshaper::shape()
+{
+    Vector<PreshapeJob*>& jobs = m_batch->jobs;
+    m_batch->texts.clear();
+    if (jobs.size() >= cMinPreshapeJobs) {
+        preshape(jobs);
+        for (size_t i = 0; i < jobs.size(); i++)
+            addShapedText(jobs[i]->shaped.leakPtr());
+    }
+    deleteAllValues(jobs);
+    jobs.clear();
+}
+
 FloatRect Font::selectionRectForComplexText(const TextRun& run,
     const FloatPoint& point, int height, int from, int to) const
 {
@@ -1028,6 +1371,34 @@ void Font::drawComplexText(GraphicsContext* gc, TextRun const& run,
 
     SkCanvas* canvas = gc->platformContext()->mCanvas;
     bool haveMultipleLayers = isCanvasMultiLayered(canvas);
+
+    if (canCacheShapedText(run) && !loadingCustomFonts()) {
+        const ShapedText* shaped = shapeText(this, run);
+        // TextRunWalker positions glyphs from the truncated starting x
+        SkScalar x = SkIntToScalar(static_cast<int>(point.x()));
+        for (size_t i = 0; i < shaped->runs.size(); i++) {
+            const ShapedScriptRun& scriptRun = shaped->runs[i];
+            size_t count = scriptRun.glyphs.size();
+            SkAutoSTMalloc<64, SkScalar> storage(count);
+            SkScalar* xPositions = storage.get();
+            for (size_t j = 0; j < count; j++)
+                xPositions[j] = scriptRun.xPositions[j] + x;
+            if (fill) {
+                scriptRun.fontPlatformData->setupPaint(&fillPaint);
+                adjustTextRenderMode(&fillPaint, haveMultipleLayers);
+                canvas->drawPosTextH(scriptRun.glyphs.data(), count << 1,
+                                     xPositions, point.y(), fillPaint);
+            }
+            if (stroke) {
+                scriptRun.fontPlatformData->setupPaint(&strokePaint);
+                adjustTextRenderMode(&strokePaint, haveMultipleLayers);
+                canvas->drawPosTextH(scriptRun.glyphs.data(), count << 1,
+                                     xPositions, point.y(), strokePaint);
+            }
+        }
+        return;
+    }
+
     TextRunWalker walker(run, point.x(), this);
     walker.setWordAndLetterSpacing(wordSpacing(), letterSpacing());
     walker.setPadding(run.expansion());
@@ -1051,6 +1422,9 @@ void Font::drawComplexText(GraphicsContext* gc, TextRun const& run,
 float Font::floatWidthForComplexText(const TextRun& run,
             HashSet<const SimpleFontData*>*, GlyphOverflow*) const
 {
+    if (canCacheShapedText(run) && !loadingCustomFonts())
+        return shapeText(this, run)->width;
+
     TextRunWalker walker(run, 0, this);
     walker.setWordAndLetterSpacing(wordSpacing(), letterSpacing());
     return walker.widthOfFullRun();
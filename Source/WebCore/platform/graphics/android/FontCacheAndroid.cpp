@@ -34,7 +34,9 @@
 #include "SkPaint.h"
 #include "SkTypeface.h"
 #include "SkUtils.h"
+#include <wtf/HashMap.h>
 #include <wtf/text/CString.h>
+#include <wtf/text/StringHash.h>
 
 namespace WebCore {
 
@@ -137,24 +139,22 @@ SimpleFontData* FontCache::getLastResortFallbackFont(const FontDescription& desc
     return getCachedFontData(fontPlatformData);
 }
 
-FontPlatformData* FontCache::createFontPlatformData(const FontDescription& fontDescription, const AtomicString& family)
-{
-    char* storage = 0;
-    const char* name = 0;
-    FontPlatformData* result = 0;
+// CSS font stacks name many families the device doesn't have, and WebCore
+// asks for each of them again at every size a page uses. Remember what every
+// family and style resolved to, including the families we turned down.
+static const unsigned cMaxResolvedFamilies = 256;
 
-    if (family.length()) {
-        storage = AtomicStringToUTF8String(family);
-        name = storage;
-    } else
-        name = getFallbackFontName(fontDescription);
+typedef std::pair<String, int> FamilyStyleKey;
+typedef HashMap<FamilyStyleKey, SkTypeface*> ResolvedFamilyMap;
 
-    int style = SkTypeface::kNormal;
-    if (fontDescription.weight() >= FontWeightBold)
-        style |= SkTypeface::kBold;
-    if (fontDescription.italic())
-        style |= SkTypeface::kItalic;
+static ResolvedFamilyMap& resolvedFamilies()
+{
+    DEFINE_STATIC_LOCAL(ResolvedFamilyMap, families, ());
+    return families;
+}
 
+static SkTypeface* resolveFamily(const char* name, const AtomicString& family, int style)
+{
     // CreateFromName always returns a typeface, falling back to a default font
     // if the one requested is not found. Calling Equal() with a null pointer
     // serves to compare the returned font against the default, with the caveat
@@ -167,24 +167,58 @@ FontPlatformData* FontCache::createFontPlatformData(const FontDescription& fontD
 
     SkTypeface* tf = SkTypeface::CreateFromName(name, SkTypeface::kNormal);
 
-    if (!SkTypeface::Equal(tf, 0) || isFallbackFamily(family.string())) {
-        // We had to use normal styling to see if this was a default font. If
-        // we need bold or italic, replace with the corrected typeface.
-        if (style != SkTypeface::kNormal) {
-            tf->unref();
-            tf = SkTypeface::CreateFromName(name, (SkTypeface::Style)style);
-        }
+    if (SkTypeface::Equal(tf, 0) && !isFallbackFamily(family.string())) {
+        tf->unref();
+        return 0;
+    }
 
-        result = new FontPlatformData(tf, fontDescription.computedSize(),
-                            (style & SkTypeface::kBold) && !tf->isBold(),
-                            (style & SkTypeface::kItalic) && !tf->isItalic(),
-                            fontDescription.orientation(),
-                            fontDescription.textOrientation());
+    // We had to use normal styling to see if this was a default font. If
+    // we need bold or italic, replace with the corrected typeface.
+    if (style != SkTypeface::kNormal) {
+        tf->unref();
+        tf = SkTypeface::CreateFromName(name, (SkTypeface::Style)style);
     }
+    return tf;
+}
+
+FontPlatformData* FontCache::createFontPlatformData(const FontDescription& fontDescription, const AtomicString& family)
+{
+    int style = SkTypeface::kNormal;
+    if (fontDescription.weight() >= FontWeightBold)
+        style |= SkTypeface::kBold;
+    if (fontDescription.italic())
+        style |= SkTypeface::kItalic;
+
+    const char* genericName = family.length() ? 0 : getFallbackFontName(fontDescription);
+    FamilyStyleKey key(genericName ? String(genericName) : family.string().lower(), style);
+    ResolvedFamilyMap& families = resolvedFamilies();
+    ResolvedFamilyMap::iterator it = families.find(key);
+    SkTypeface* tf;
+    if (it != families.end())
+        tf = it->second;
+    else {
+        char* storage = genericName ? 0 : AtomicStringToUTF8String(family);
+        tf = resolveFamily(genericName ? genericName : storage, family, style);
+        sk_free(storage);
+
+        if (families.size() >= cMaxResolvedFamilies) {
+            ResolvedFamilyMap::iterator end = families.end();
+            for (ResolvedFamilyMap::iterator resolved = families.begin(); resolved != end; ++resolved)
+                SkSafeUnref(resolved->second);
+            families.clear();
+        }
+        // the map keeps the reference CreateFromName gave us
+        families.set(key, tf);
+    }
+
+    if (!tf)
+        return 0;
 
-    tf->unref();
-    sk_free(storage);
-    return result;
+    return new FontPlatformData(tf, fontDescription.computedSize(),
+                                (style & SkTypeface::kBold) && !tf->isBold(),
+                                (style & SkTypeface::kItalic) && !tf->isItalic(),
+                                fontDescription.orientation(),
+                                fontDescription.textOrientation());
 }
 
     // new as of SVN change 36269, Sept 8, 2008
@@ -32,6 +32,10 @@
 #include "WOFFFileFormat.h"
 #include "FontPlatformData.h"
 
+#if ENABLE(OPENTYPE_SANITIZER)
+#include "OpenTypeSanitizer.h"
+#endif
+
 namespace WebCore {
 
 FontCustomPlatformData::FontCustomPlatformData(SkTypeface* face)
@@ -62,6 +66,14 @@ FontPlatformData FontCustomPlatformData::fontPlatformData(int size, bool bold, b
 FontCustomPlatformData* createFontCustomPlatformData(SharedBuffer* buffer, bool woffEnabled)
 {
     RefPtr<SharedBuffer> sfntBuffer;
+#if ENABLE(OPENTYPE_SANITIZER)
+    // The sanitizer also unpacks WOFF files into plain sfnt data.
+    OpenTypeSanitizer sanitizer(buffer);
+    sfntBuffer = sanitizer.sanitize();
+    if (!sfntBuffer)
+        return 0; // validation failed.
+    buffer = sfntBuffer.get();
+#else
     if (woffEnabled && isWOFF(buffer)) {
         Vector<char> sfnt;
         if (!convertWOFFToSfnt(buffer, sfnt))
@@ -70,6 +82,7 @@ FontCustomPlatformData* createFontCustomPlatformData(SharedBuffer* buffer, bool
         sfntBuffer = SharedBuffer::adoptVector(sfnt);
         buffer = sfntBuffer.get();
     }
+#endif
 
     // pass true until we know how we can share the data, and not have to
     // make a copy of it.
@@ -0,0 +1,100 @@
+/*
+ * Copyright 2012, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "FontDecoder.h"
+
+#include "FontCustomPlatformData.h"
+#include "SharedBuffer.h"
+
+#include <wtf/CurrentTime.h>
+#include <wtf/MainThread.h>
+#include <wtf/OwnPtr.h>
+#include <wtf/RefPtr.h>
+#include <wtf/StdLibExtras.h>
+#include <wtf/ThreadPool.h>
+
+#ifdef DEBUG
+
+#include <cutils/log.h>
+
+#undef XLOG
+#define XLOG(...) android_printLog(ANDROID_LOG_DEBUG, "FontDecoder", __VA_ARGS__)
+
+#else
+
+#undef XLOG
+#define XLOG(...)
+
+#endif // DEBUG
+
+namespace WebCore {
+
+struct FontDecoder::Job {
+    RefPtr<SharedBuffer> buffer;
+    OwnPtr<Client> client;
+    FontCustomPlatformData* result;
+};
+
+// Fonts are decoded one at a time, as the dedicated thread used to.
+static TaskKind& fontDecodingTasks()
+{
+    DEFINE_STATIC_LOCAL(TaskKind, kind, ("FontDecoder", TaskPriorityBackground, 1));
+    return kind;
+}
+
+void FontDecoder::decode(PassRefPtr<SharedBuffer> buffer, PassOwnPtr<Client> client)
+{
+    ASSERT(isMainThread());
+    Job* job = new Job;
+    job->buffer = buffer;
+    job->client = client;
+    job->result = 0;
+    ThreadPool::shared().dispatch(fontDecodingTasks(), decodeFont, job);
+}
+
+void FontDecoder::decodeFont(void* context)
+{
+    Job* job = static_cast<Job*>(context);
+#ifdef DEBUG
+    double startTime = currentTime();
+#endif
+    // WOFF is always unpacked here; the client checks the setting when it
+    // uses the font, as the settings live on the main thread.
+    job->result = createFontCustomPlatformData(job->buffer.get(), true);
+    XLOG("decoded %d byte font in %.1f ms", job->buffer->size(), (currentTime() - startTime) * 1000);
+
+    // The buffer and the client are only ever touched on the main thread
+    // from here on, which is also where they are released.
+    callOnMainThread(deliverDecodedFont, job);
+}
+
+void FontDecoder::deliverDecodedFont(void* context)
+{
+    OwnPtr<Job> job = adoptPtr(static_cast<Job*>(context));
+    job->client->fontDecoded(job->result);
+}
+
+} // namespace WebCore
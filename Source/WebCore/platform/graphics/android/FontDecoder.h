@@ -0,0 +1,64 @@
+/*
+ * Copyright 2012, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef FontDecoder_h
+#define FontDecoder_h
+
+#include <wtf/PassOwnPtr.h>
+#include <wtf/PassRefPtr.h>
+
+namespace WebCore {
+
+class SharedBuffer;
+struct FontCustomPlatformData;
+
+// Turns downloaded web font files into typefaces on the shared thread pool,
+// so converting a WOFF file and having FreeType parse the tables of a large
+// font doesn't hold up the main thread while the page is being laid out.
+class FontDecoder {
+public:
+    class Client {
+    public:
+        virtual ~Client() { }
+        // Called on the main thread with the decoded font, or 0 if Skia
+        // couldn't read the file. The client owns the result, and is
+        // deleted once it returns.
+        virtual void fontDecoded(FontCustomPlatformData*) = 0;
+    };
+
+    // The buffer is read on a pool thread, so nothing else may hold a
+    // reference to it.
+    static void decode(PassRefPtr<SharedBuffer>, PassOwnPtr<Client>);
+
+private:
+    struct Job;
+
+    static void decodeFont(void* job);
+    static void deliverDecodedFont(void* job);
+};
+
+} // namespace WebCore
+
+#endif // FontDecoder_h
@@ -69,6 +69,7 @@ public:
 
     FontOrientation orientation() const { return mOrientation; }
     void setOrientation(FontOrientation orientation) { mOrientation = orientation; }
+    TextOrientation textOrientation() const { return mTextOrientation; }
     FontPlatformData& operator=(const FontPlatformData&);
     bool operator==(const FontPlatformData& a) const;
 
@@ -81,6 +82,8 @@ public:
     uint32_t uniqueID() const;
 
     float size() const { return mTextSize; }
+    bool isFakeBold() const { return mFakeBold; }
+    bool isFakeItalic() const { return mFakeItalic; }
     unsigned hash() const;
     bool isFixedPitch() const;
 
@@ -0,0 +1,144 @@
+/*
+ * Copyright 2012, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "FrameTimings.h"
+
+#if USE(ACCELERATED_COMPOSITING)
+
+#include <string.h>
+#include <wtf/CurrentTime.h>
+#include <wtf/text/StringBuilder.h>
+
+namespace WebCore {
+
+FrameTimings::FrameTimings()
+    : m_nextFrame(0)
+    , m_numFrames(0)
+{
+    memset(&m_current, 0, sizeof(m_current));
+}
+
+void FrameTimings::frameStarted()
+{
+    android::Mutex::Autolock lock(m_lock);
+    m_current.startTime = currentTime();
+}
+
+void FrameTimings::frameEnded(bool treeSwapped)
+{
+    android::Mutex::Autolock lock(m_lock);
+    m_current.drawTime = (currentTime() - m_current.startTime) * 1000;
+    m_current.treeSwapped = treeSwapped;
+
+    m_frames[m_nextFrame] = m_current;
+    m_nextFrame = (m_nextFrame + 1) % FRAME_TIMINGS_SIZE;
+    if (m_numFrames < FRAME_TIMINGS_SIZE)
+        m_numFrames++;
+
+    memset(&m_current, 0, sizeof(m_current));
+}
+
+void FrameTimings::tilesDrawn(int drawn, int missing)
+{
+    android::Mutex::Autolock lock(m_lock);
+    m_current.tilesDrawn += drawn;
+    m_current.tilesMissing += missing;
+}
+
+void FrameTimings::bytesUploaded(int bytes)
+{
+    android::Mutex::Autolock lock(m_lock);
+    m_current.uploadedBytes += bytes;
+}
+
+void FrameTimings::videoFrameDrawn()
+{
+    android::Mutex::Autolock lock(m_lock);
+    m_current.videoFrames++;
+}
+
+void FrameTimings::tilePainted()
+{
+    android::Mutex::Autolock lock(m_lock);
+    m_current.tilesPainted++;
+}
+
+void FrameTimings::transferQueueWaited(double seconds)
+{
+    android::Mutex::Autolock lock(m_lock);
+    m_current.transferWait += seconds * 1000;
+}
+
+void FrameTimings::clear()
+{
+    android::Mutex::Autolock lock(m_lock);
+    m_nextFrame = 0;
+    m_numFrames = 0;
+}
+
+int FrameTimings::numFrames()
+{
+    android::Mutex::Autolock lock(m_lock);
+    return m_numFrames;
+}
+
+bool FrameTimings::frame(int index, FrameTimingRecord* record)
+{
+    android::Mutex::Autolock lock(m_lock);
+    if (index < 0 || index >= m_numFrames)
+        return false;
+
+    *record = m_frames[frameIndex(index)];
+    return true;
+}
+
+String FrameTimings::dump()
+{
+    android::Mutex::Autolock lock(m_lock);
+    StringBuilder builder;
+    for (int i = 0; i < m_numFrames; i++) {
+        const FrameTimingRecord& record = m_frames[frameIndex(i)];
+        builder.append(String::format("%.3f draw %.2fms tiles %d missing %d painted %d"
+                                      " wait %.2fms upload %dKb video %d swap %d\n",
+                                      record.startTime, record.drawTime,
+                                      record.tilesDrawn, record.tilesMissing,
+                                      record.tilesPainted, record.transferWait,
+                                      record.uploadedBytes / 1024, record.videoFrames,
+                                      record.treeSwapped));
+    }
+    return builder.toString();
+}
+
+// must be called with m_lock held
+int FrameTimings::frameIndex(int index)
+{
+    int oldest = (m_nextFrame - m_numFrames + FRAME_TIMINGS_SIZE) % FRAME_TIMINGS_SIZE;
+    return (oldest + index) % FRAME_TIMINGS_SIZE;
+}
+
+} // namespace WebCore
+
+#endif // USE(ACCELERATED_COMPOSITING)
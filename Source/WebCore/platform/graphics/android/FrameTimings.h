@@ -0,0 +1,91 @@
+/*
+ * Copyright 2012, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef FrameTimings_h
+#define FrameTimings_h
+
+#if USE(ACCELERATED_COMPOSITING)
+
+#include <utils/threads.h>
+#include <wtf/text/WTFString.h>
+
+// Number of frames kept, older ones are overwritten
+#define FRAME_TIMINGS_SIZE 120
+
+namespace WebCore {
+
+struct FrameTimingRecord {
+    double startTime;     // seconds, when drawGL started
+    float drawTime;       // ms spent in GLWebViewState::drawGL
+    int tilesDrawn;       // base tiles drawn
+    int tilesMissing;     // visible base tiles without up to date content
+    int tilesPainted;     // tiles the generators painted since the last frame
+    float transferWait;   // ms the generators waited on the transfer queue
+    int uploadedBytes;    // texture bytes uploaded from the transfer queue
+    int videoFrames;      // new video frames composited
+    bool treeSwapped;     // a new layer tree became the drawing tree
+};
+
+// Always on, per frame record of the compositor's work, kept in a ring
+// buffer so it can be collected from release builds (see the
+// "frame_timings" WebView property and the wds DFTM command).
+// The UI thread opens and closes the frames; the texture generators only
+// add to the counters of the frame in progress.
+class FrameTimings {
+public:
+    FrameTimings();
+
+    // UI thread
+    void frameStarted();
+    void frameEnded(bool treeSwapped);
+    void tilesDrawn(int drawn, int missing);
+    void bytesUploaded(int bytes);
+    void videoFrameDrawn();
+
+    // texture generator threads
+    void tilePainted();
+    void transferQueueWaited(double seconds);
+
+    void clear();
+    int numFrames();
+    // index 0 is the oldest frame kept
+    bool frame(int index, FrameTimingRecord* record);
+    // one line per frame, oldest first
+    String dump();
+
+private:
+    int frameIndex(int index);
+
+    android::Mutex m_lock;
+    FrameTimingRecord m_frames[FRAME_TIMINGS_SIZE];
+    FrameTimingRecord m_current;
+    int m_nextFrame;
+    int m_numFrames;
+};
+
+} // namespace WebCore
+
+#endif // USE(ACCELERATED_COMPOSITING)
+#endif // FrameTimings_h
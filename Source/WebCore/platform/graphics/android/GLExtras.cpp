@@ -202,6 +202,9 @@ void GLExtras::drawFindOnPage(SkRect& viewport)
 void GLExtras::drawGL(IntRect& webViewRect, SkRect& viewport, int titleBarHeight)
 {
     if (m_drawExtra) {
+        // the rings are made of many quads sharing the same texture
+        ShaderProgram* shader = TilesManager::instance()->shader();
+        shader->beginBatch();
         if (m_drawExtra == m_ring)
             drawCursorRings();
         else if (m_drawExtra == m_findOnPage)
@@ -209,5 +212,6 @@ void GLExtras::drawGL(IntRect& webViewRect, SkRect& viewport, int titleBarHeight
         else
             XLOGC("m_drawExtra %p is unknown! (cursor: %p, find: %p",
                   m_drawExtra, m_ring, m_findOnPage);
+        shader->endBatch();
     }
 }
@@ -31,9 +31,11 @@
 #include "ShaderProgram.h"
 #include "TilesManager.h"
 
+#include <ETC1/etc1.h>
 #include <cutils/log.h>
 #include <gui/SurfaceTexture.h>
 #include <wtf/CurrentTime.h>
+#include <wtf/Vector.h>
 #include <wtf/text/CString.h>
 
 
@@ -52,6 +54,12 @@
 
 #endif // DEBUG
 
+// A bitmap where more than this ratio of the horizontally adjacent pixels
+// differ by more than ETC1_EDGE_LUMINANCE_DELTA is mostly text or line art,
+// which the ETC1 block artifacts would make blurry.
+#define ETC1_MAX_EDGE_RATIO 0.04
+#define ETC1_EDGE_LUMINANCE_DELTA 96
+
 struct ANativeWindowBuffer;
 
 namespace WebCore {
@@ -187,6 +195,12 @@ bool GLUtils::isEGLFenceSyncSupported()
     return eglExtensions && strstr(eglExtensions, "EGL_KHR_fence_sync");
 }
 
+bool GLUtils::isETC1Supported()
+{
+    const char* glExtensions = reinterpret_cast<const char*>(glGetString(GL_EXTENSIONS));
+    return glExtensions && strstr(glExtensions, "GL_OES_compressed_ETC1_RGB8_texture");
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////
 // Textures utilities
 /////////////////////////////////////////////////////////////////////////////////////////
@@ -369,7 +383,12 @@ GLuint GLUtils::createBaseTileGLTexture(int width, int height)
     glBindTexture(GL_TEXTURE_2D, texture);
     GLUtils::checkGlError("glBindTexture");
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
-    GLUtils::checkGlError("glTexImage2D");
+    // don't crash when out of memory, the caller evicts textures instead
+    if (GLUtils::checkGlError("glTexImage2D", false)) {
+        delete[] pixels;
+        glDeleteTextures(1, &texture);
+        return 0;
+    }
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
     return texture;
@@ -586,6 +605,66 @@ void GLUtils::updateTextureWithBitmap(GLuint texture, int x, int y, const SkBitm
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
 }
 
+bool GLUtils::canEncodeWithETC1(const SkBitmap& bitmap)
+{
+    // ETC1 encodes blocks of 4x4 pixels
+    if (bitmap.config() != SkBitmap::kARGB_8888_Config || !bitmap.width()
+        || bitmap.width() % 4 || bitmap.height() % 4)
+        return false;
+
+    SkAutoLockPixels lock(bitmap);
+    int edges = 0;
+    int maxEdges = bitmap.width() * bitmap.height() * ETC1_MAX_EDGE_RATIO;
+    for (int y = 0; y < bitmap.height(); y++) {
+        const SkPMColor* row = bitmap.getAddr32(0, y);
+        int previousLuminance = 0;
+        for (int x = 0; x < bitmap.width(); x++) {
+            SkPMColor color = row[x];
+            // ETC1 has no alpha channel
+            if (SkGetPackedA32(color) != 0xFF)
+                return false;
+            int luminance = (SkGetPackedR32(color) * 77 + SkGetPackedG32(color) * 150
+                             + SkGetPackedB32(color) * 29) >> 8;
+            if (x && abs(luminance - previousLuminance) > ETC1_EDGE_LUMINANCE_DELTA
+                && ++edges > maxEdges)
+                return false;
+            previousLuminance = luminance;
+        }
+    }
+    return true;
+}
+
+bool GLUtils::encodeWithETC1(const SkBitmap& bitmap, uint8_t* data)
+{
+    int width = bitmap.width();
+    int height = bitmap.height();
+    WTF::Vector<uint8_t> rgb(width * height * 3);
+    uint8_t* dst = rgb.data();
+
+    bitmap.lockPixels();
+    for (int y = 0; y < height; y++) {
+        const SkPMColor* row = bitmap.getAddr32(0, y);
+        for (int x = 0; x < width; x++) {
+            *dst++ = SkGetPackedR32(row[x]);
+            *dst++ = SkGetPackedG32(row[x]);
+            *dst++ = SkGetPackedB32(row[x]);
+        }
+    }
+    bitmap.unlockPixels();
+
+    return !etc1_encode_image(rgb.data(), width, height, 3, width * 3, data);
+}
+
+bool GLUtils::updateTextureWithETC1(GLuint texture, int width, int height,
+                                    const uint8_t* data, int size)
+{
+    glBindTexture(GL_TEXTURE_2D, texture);
+    GLUtils::checkGlError("glBindTexture");
+    // the compressed data replaces the whole texture storage
+    glCompressedTexImage2D(GL_TEXTURE_2D, 0, GL_ETC1_RGB8_OES, width, height, 0, size, data);
+    return !GLUtils::checkGlError("glCompressedTexImage2D", false);
+}
+
 void GLUtils::createEGLImageFromTexture(GLuint texture, EGLImageKHR* image)
 {
     EGLClientBuffer buffer = reinterpret_cast<EGLClientBuffer>(texture);
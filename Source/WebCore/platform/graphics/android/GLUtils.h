@@ -64,6 +64,7 @@ public:
     // GL & EGL extension checks
     static bool isEGLImageSupported();
     static bool isEGLFenceSyncSupported();
+    static bool isETC1Supported();
 
     // Texture utilities
     static EGLContext createBackgroundContext(EGLContext sharedContext);
@@ -78,6 +79,13 @@ public:
     static void createEGLImageFromTexture(GLuint texture, EGLImageKHR* image);
     static void createTextureFromEGLImage(GLuint texture, EGLImageKHR image, GLint filter = GL_LINEAR);
 
+    // ETC1 compression: only opaque bitmaps without much text are suitable,
+    // see canEncodeWithETC1(). The data needs etc1_get_encoded_data_size() bytes.
+    static bool canEncodeWithETC1(const SkBitmap& bitmap);
+    static bool encodeWithETC1(const SkBitmap& bitmap, uint8_t* data);
+    static bool updateTextureWithETC1(GLuint texture, int width, int height,
+                                      const uint8_t* data, int size);
+
     static void paintTextureWithBitmap(const TileRenderInfo* renderInfo, const SkBitmap& bitmap);
 #if DEPRECATED_SURFACE_TEXTURE_MODE
     static void createSurfaceTextureWithBitmap(const TileRenderInfo* , const SkBitmap& bitmap, GLint filter  = GL_LINEAR);
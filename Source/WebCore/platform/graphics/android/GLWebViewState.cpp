@@ -37,6 +37,7 @@
 #include "SkPath.h"
 #include "TilesManager.h"
 #include "TilesTracker.h"
+#include "TraceEventAndroid.h"
 #include "CanvasLayerAndroid.h"
 #include "TreeManager.h"
 #include <wtf/CurrentTime.h>
@@ -63,9 +64,15 @@
 
 #define FIRST_TILED_PAGE_ID 1
 #define SECOND_TILED_PAGE_ID 2
+#define LOW_RES_TILED_PAGE_ID 3
 
 #define FRAMERATE_CAP 0.01666 // We cap at 60 fps
 
+// The scroll velocity is reset if the viewport didn't move for that long
+// (in seconds), and smoothed over the viewport updates with that weight
+#define SCROLL_VELOCITY_TIMEOUT 0.1
+#define SCROLL_VELOCITY_SMOOTHING 0.5
+
 // log warnings if scale goes outside this range
 #define MIN_SCALE_WARNING 0.1
 #define MAX_SCALE_WARNING 10
@@ -83,6 +90,7 @@ GLWebViewState::GLWebViewState()
     , m_isScrolling(false)
     , m_goingDown(true)
     , m_goingLeft(false)
+    , m_lastViewportTime(0)
     , m_expandedTileBoundsX(0)
     , m_expandedTileBoundsY(0)
     , m_highEndGfx(false)
@@ -96,12 +104,16 @@ GLWebViewState::GLWebViewState()
     , m_layersRenderingMode(kAllTextures)
 {
     m_viewport.setEmpty();
+    m_scrollVelocity.set(0, 0);
     m_futureViewportTileBounds.setEmpty();
     m_viewportTileBounds.setEmpty();
     m_preZoomBounds.setEmpty();
 
     m_tiledPageA = new TiledPage(FIRST_TILED_PAGE_ID, this);
     m_tiledPageB = new TiledPage(SECOND_TILED_PAGE_ID, this);
+    m_lowResPage = new TiledPage(LOW_RES_TILED_PAGE_ID, this);
+    m_lowResPage->setIsLowResPage(true);
+    m_lowResPage->setScale(LOW_RES_PAGE_SCALE);
 
 #ifdef DEBUG_COUNT
     ClassTracker::instance()->increment("GLWebViewState");
@@ -126,6 +138,7 @@ GLWebViewState::~GLWebViewState()
     // will remove any pending operations, and wait if one is underway).
     delete m_tiledPageA;
     delete m_tiledPageB;
+    delete m_lowResPage;
 #ifdef DEBUG_COUNT
     ClassTracker::instance()->decrement("GLWebViewState");
 #endif
@@ -140,6 +153,7 @@ void GLWebViewState::setBaseLayer(BaseLayerAndroid* layer, const SkRegion& inval
         m_zoomManager.swapPages(); // reset zoom state
         m_tiledPageA->discardTextures();
         m_tiledPageB->discardTextures();
+        m_lowResPage->discardTextures();
         m_layersRenderingMode = kAllTextures;
     }
     if (layer) {
@@ -193,6 +207,7 @@ void GLWebViewState::inval(const IntRect& rect)
         // find which tiles fall within the invalRect and mark them as dirty
         m_tiledPageA->invalidateRect(rect, m_currentPictureCounter);
         m_tiledPageB->invalidateRect(rect, m_currentPictureCounter);
+        m_lowResPage->invalidateRect(rect, m_currentPictureCounter);
         if (m_frameworkInval.isEmpty())
             m_frameworkInval = rect;
         else
@@ -245,6 +260,14 @@ int GLWebViewState::baseContentHeight()
     return m_treeManager.baseContentHeight();
 }
 
+SkPoint GLWebViewState::scrollVelocity()
+{
+    SkPoint velocity = m_scrollVelocity;
+    if (WTF::currentTime() - m_lastViewportTime > SCROLL_VELOCITY_TIMEOUT)
+        velocity.set(0, 0);
+    return velocity;
+}
+
 void GLWebViewState::setViewport(SkRect& viewport, float scale)
 {
     if ((m_viewport == viewport) &&
@@ -253,6 +276,22 @@ void GLWebViewState::setViewport(SkRect& viewport, float scale)
 
     m_goingDown = m_viewport.fTop - viewport.fTop <= 0;
     m_goingLeft = m_viewport.fLeft - viewport.fLeft >= 0;
+
+    // only track scrolling, not zooming
+    double now = WTF::currentTime();
+    double delta = now - m_lastViewportTime;
+    if (delta > 0 && delta < SCROLL_VELOCITY_TIMEOUT
+        && m_viewport.width() == viewport.width()
+        && m_viewport.height() == viewport.height()) {
+        float velocityX = (viewport.fLeft - m_viewport.fLeft) / delta;
+        float velocityY = (viewport.fTop - m_viewport.fTop) / delta;
+        m_scrollVelocity.set(
+            m_scrollVelocity.fX * (1 - SCROLL_VELOCITY_SMOOTHING) + velocityX * SCROLL_VELOCITY_SMOOTHING,
+            m_scrollVelocity.fY * (1 - SCROLL_VELOCITY_SMOOTHING) + velocityY * SCROLL_VELOCITY_SMOOTHING);
+    } else
+        m_scrollVelocity.set(0, 0);
+    m_lastViewportTime = now;
+
     m_viewport = viewport;
 
     XLOG("New VIEWPORT %.2f - %.2f %.2f - %.2f (w: %2.f h: %.2f scale: %.2f currentScale: %.2f futureScale: %.2f)",
@@ -273,12 +312,17 @@ void GLWebViewState::setViewport(SkRect& viewport, float scale)
     int viewMaxTileX = static_cast<int>(ceilf((viewport.width()-1) * invTileContentWidth)) + 1;
     int viewMaxTileY = static_cast<int>(ceilf((viewport.height()-1) * invTileContentHeight)) + 1;
 
-    int maxTextureCount = (viewMaxTileX + m_expandedTileBoundsX * 2) *
-        (viewMaxTileY + m_expandedTileBoundsY * 2) * (m_highEndGfx ? 4 : 2);
+    int maxTilesX = viewMaxTileX + m_expandedTileBoundsX * 2;
+    int maxTilesY = viewMaxTileY + m_expandedTileBoundsY * 2;
+    // leave room for the rows (or columns) prepared ahead of a fling
+    int maxTextureCount = (maxTilesX * maxTilesY
+        + std::max(maxTilesX, maxTilesY) * FLING_PREFETCH_MAX_TILES) * (m_highEndGfx ? 4 : 2)
+        + LOW_RES_PAGE_MAX_TILES;
 
     TilesManager::instance()->setMaxTextureCount(maxTextureCount);
     m_tiledPageA->updateBaseTileSize();
     m_tiledPageB->updateBaseTileSize();
+    m_lowResPage->updateBaseTileSize();
 }
 
 #ifdef MEASURES_PERF
@@ -438,6 +482,7 @@ bool GLWebViewState::setLayersRenderingMode(TexturesResult& nbTexturesNeeded)
         && invalBase) {
         m_tiledPageA->discardTextures();
         m_tiledPageB->discardTextures();
+        m_lowResPage->discardTextures();
         fullInval();
         return true;
     }
@@ -456,6 +501,7 @@ bool GLWebViewState::drawGL(IntRect& rect, SkRect& viewport, IntRect* invalRect,
                             IntRect& clip, float scale,
                             bool* treesSwappedPtr, bool* newTreeHasAnimPtr)
 {
+    ANDROID_TRACE_EVENT("compositor", "GLWebViewState::drawGL");
     if(m_start)
     {
         m_start_time = currentTime();
@@ -477,6 +523,8 @@ bool GLWebViewState::drawGL(IntRect& rect, SkRect& viewport, IntRect* invalRect,
         }
     }
 
+    TilesManager::instance()->frameTimings()->frameStarted();
+
     m_scale = scale;
     TilesManager::instance()->getProfiler()->nextFrame(viewport.fLeft,
                                                        viewport.fTop,
@@ -494,8 +542,9 @@ bool GLWebViewState::drawGL(IntRect& rect, SkRect& viewport, IntRect* invalRect,
     bool useMinimalMemory = TilesManager::instance()->useMinimalMemory();
     bool useHorzPrefetch = useMinimalMemory ? 0 : viewWidth < baseContentWidth();
     bool useVertPrefetch = useMinimalMemory ? 0 : viewHeight < baseContentHeight();
-    m_expandedTileBoundsX = (useHorzPrefetch) ? TILE_PREFETCH_DISTANCE : 0;
-    m_expandedTileBoundsY = (useVertPrefetch) ? TILE_PREFETCH_DISTANCE : 0;
+    int prefetchDistance = TilesManager::instance()->prefetchDistance();
+    m_expandedTileBoundsX = (useHorzPrefetch) ? prefetchDistance : 0;
+    m_expandedTileBoundsY = (useVertPrefetch) ? prefetchDistance : 0;
 
     XLOG("drawGL, rect(%d, %d, %d, %d), viewport(%.2f, %.2f, %.2f, %.2f)",
          rect.x(), rect.y(), rect.width(), rect.height(),
@@ -514,6 +563,10 @@ bool GLWebViewState::drawGL(IntRect& rect, SkRect& viewport, IntRect* invalRect,
     // the BaseTiles' texture.
     TilesManager::instance()->transferQueue()->updateDirtyBaseTiles();
 
+    // Free the textures we can't afford anymore before preparing the tiles:
+    // the pools are shared by all the WebViews
+    TilesManager::instance()->enforceTextureBudget();
+
     // Upload any pending ImageTexture
     // Return true if we still have some images to upload.
     // TODO: upload as many textures as possible within a certain time limit
@@ -617,6 +670,12 @@ bool GLWebViewState::drawGL(IntRect& rect, SkRect& viewport, IntRect* invalRect,
 
     CanvasLayerAndroid::cleanupAssets();
 
+    // delete the textures freed during this frame once nothing is animating
+    TilesManager::instance()->texturePool()->frameEnded(!ret);
+
+    TilesManager::instance()->frameTimings()->frameEnded(treesSwappedPtr && *treesSwappedPtr);
+    TilesManager::instance()->getProfiler()->frameEnded();
+
     return ret;
 }
 
@@ -54,6 +54,16 @@
 // ratio of content to view required for prefetching to enable
 #define TILE_PREFETCH_RATIO 1.2
 
+// While flinging, also prepare the tiles the viewport will reach within
+// FLING_PREFETCH_LOOKAHEAD seconds, up to FLING_PREFETCH_MAX_TILES tiles ahead
+#define FLING_PREFETCH_LOOKAHEAD 0.5
+#define FLING_PREFETCH_MAX_TILES 3
+
+// Scale of the low resolution page drawn under the base layer, and the
+// number of tiles it may use
+#define LOW_RES_PAGE_SCALE 0.25
+#define LOW_RES_PAGE_MAX_TILES 16
+
 namespace WebCore {
 
 class BaseLayerAndroid;
@@ -186,6 +196,7 @@ public:
     TiledPage* frontPage();
     TiledPage* backPage();
     void swapPages();
+    TiledPage* lowResPage() { return m_lowResPage; }
 
     // dimensions of the current base layer
     int baseContentWidth();
@@ -227,6 +238,9 @@ public:
 
     bool goingDown() { return m_goingDown; }
     bool goingLeft() { return m_goingLeft; }
+    // smoothed scrolling velocity, in content pixels per second. Zero when
+    // the viewport hasn't moved recently.
+    SkPoint scrollVelocity();
     void setDirection(bool goingDown, bool goingLeft) {
         m_goingDown = goingDown;
         m_goingLeft = goingLeft;
@@ -266,6 +280,8 @@ private:
     bool m_usePageA;
     TiledPage* m_tiledPageA;
     TiledPage* m_tiledPageB;
+    // not swapped with the others, always at LOW_RES_PAGE_SCALE
+    TiledPage* m_lowResPage;
     IntRect m_lastInval;
     IntRect m_frameworkInval;
     IntRect m_frameworkLayersInval;
@@ -289,6 +305,8 @@ private:
     bool m_isScrolling;
     bool m_goingDown;
     bool m_goingLeft;
+    SkPoint m_scrollVelocity;
+    double m_lastViewportTime;
 
     int m_expandedTileBoundsX;
     int m_expandedTileBoundsY;
@@ -77,6 +77,12 @@ GaneshRenderer::~GaneshRenderer()
 #endif
 }
 
+bool GaneshRenderer::canRender(const TileRenderInfo& renderInfo)
+{
+    return renderInfo.tileSize.width() == TilesManager::tileWidth()
+        && renderInfo.tileSize.height() == TilesManager::tileHeight();
+}
+
 void GaneshRenderer::setupCanvas(const TileRenderInfo& renderInfo, SkCanvas* canvas)
 {
     if (renderInfo.measurePerf)
@@ -100,8 +106,7 @@ void GaneshRenderer::setupCanvas(const TileRenderInfo& renderInfo, SkCanvas* can
 #endif
 
     SkDevice* device = NULL;
-    if (renderInfo.tileSize.width() == TilesManager::tileWidth()
-            && renderInfo.tileSize.height() == TilesManager::tileHeight()) {
+    if (canRender(renderInfo)) {
         device = ganesh->getDeviceForBaseTile(renderInfo);
     } else {
         // TODO support arbitrary sizes for layers
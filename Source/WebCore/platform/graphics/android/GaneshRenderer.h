@@ -44,6 +44,10 @@ public:
     GaneshRenderer();
     ~GaneshRenderer();
 
+    // Ganesh only has render targets for base tiles, the other tiles are
+    // painted with the raster renderer
+    static bool canRender(const TileRenderInfo& renderInfo);
+
 protected:
 
     virtual void setupCanvas(const TileRenderInfo& renderInfo, SkCanvas* canvas);
@@ -26,6 +26,8 @@
 
 #include "config.h"
 
+#include "GlyphMapAndroid.h"
+
 #include "EmojiFont.h"
 #include "Font.h"
 #include "GlyphPageTreeNode.h"
@@ -34,9 +36,15 @@
 #include "SkFontHost.h"
 #include "SkPaint.h"
 #include "SkTemplates.h"
+#include "SkTypeface.h"
 #include "SkUtils.h"
 #include "VerticalTextMap.h"
 
+#include <wtf/OwnPtr.h>
+#include <wtf/PassOwnPtr.h>
+#include <wtf/StringHasher.h>
+#include <wtf/Vector.h>
+
 
 using namespace android;
 
@@ -44,6 +52,59 @@ namespace WebCore {
 
 #define NO_BREAK_SPACE_UNICHAR 0xA0
 
+// Pages are filled for each font data, so a page of a typeface used at
+// several sizes or weights used to go through Skia's character map once for
+// each of them. The glyph ids only depend on the typeface, so keep those of
+// the pages filled last.
+static const size_t cMaxRecentGlyphPages = 16;
+
+struct RecentGlyphPage {
+    uint32_t typefaceID;
+    unsigned hash;
+    Vector<UChar> text;
+    Vector<uint16_t> glyphs;
+};
+
+// most recently filled last
+static Vector<OwnPtr<RecentGlyphPage> >& recentGlyphPages()
+{
+    DEFINE_STATIC_LOCAL(Vector<OwnPtr<RecentGlyphPage> >, pages, ());
+    return pages;
+}
+
+static bool findRecentGlyphPage(uint32_t typefaceID, const UChar* text, unsigned textLength, uint16_t* glyphs, unsigned glyphCount)
+{
+    Vector<OwnPtr<RecentGlyphPage> >& pages = recentGlyphPages();
+    unsigned hash = StringHasher::computeHash<UChar>(text, textLength);
+    for (size_t i = pages.size(); i > 0; --i) {
+        RecentGlyphPage* page = pages[i - 1].get();
+        if (page->typefaceID != typefaceID || page->hash != hash || page->text.size() != textLength
+            || page->glyphs.size() != glyphCount || memcmp(page->text.data(), text, textLength * sizeof(UChar)))
+            continue;
+        memcpy(glyphs, page->glyphs.data(), glyphCount * sizeof(uint16_t));
+        return true;
+    }
+    return false;
+}
+
+static void addRecentGlyphPage(uint32_t typefaceID, const UChar* text, unsigned textLength, const uint16_t* glyphs, unsigned glyphCount)
+{
+    Vector<OwnPtr<RecentGlyphPage> >& pages = recentGlyphPages();
+    if (pages.size() >= cMaxRecentGlyphPages)
+        pages.remove(0);
+    OwnPtr<RecentGlyphPage> page = adoptPtr(new RecentGlyphPage);
+    page->typefaceID = typefaceID;
+    page->hash = StringHasher::computeHash<UChar>(text, textLength);
+    page->text.append(text, textLength);
+    page->glyphs.append(glyphs, glyphCount);
+    pages.append(page.release());
+}
+
+void purgeRecentGlyphPages()
+{
+    recentGlyphPages().clear();
+}
+
 static HB_Error substituteWithVerticalGlyphs(const FontPlatformData& platformData, uint16_t* glyphs, unsigned bufferLength)
 {
     HB_FaceRec_* hbFace = platformData.harfbuzzFace();
@@ -110,10 +171,17 @@ bool GlyphPage::fill(unsigned offset, unsigned length, UChar* buffer, unsigned b
         textBuffer = vTextBuffer;
     }
 
-    unsigned count = paint.textToGlyphs(textBuffer, bufferLength << 1, glyphs);
-    if (count != length) {
-        SkDebugf("%s count != length\n", __FUNCTION__);
-        return false;
+    // vertical forms and substitutions are rare enough to always convert
+    bool reusable = textBuffer == buffer && !fontData->hasVerticalGlyphs();
+    uint32_t typefaceID = SkTypeface::UniqueID(fontData->platformData().typeface());
+    if (!reusable || !findRecentGlyphPage(typefaceID, textBuffer, bufferLength, glyphs, length)) {
+        unsigned count = paint.textToGlyphs(textBuffer, bufferLength << 1, glyphs);
+        if (count != length) {
+            SkDebugf("%s count != length\n", __FUNCTION__);
+            return false;
+        }
+        if (reusable)
+            addRecentGlyphPage(typefaceID, textBuffer, bufferLength, glyphs, length);
     }
 
     if (fontData->hasVerticalGlyphs()) {
@@ -22,6 +22,7 @@
 
 #include "AndroidAnimation.h"
 #include "Animation.h"
+#include "BitmapImage.h"
 #include "FloatRect.h"
 #include "GraphicsContext.h"
 #include "Image.h"
@@ -121,6 +122,7 @@ GraphicsLayerAndroid::GraphicsLayerAndroid(GraphicsLayerClient* client) :
     m_needsNotifyClient(false),
     m_haveContents(false),
     m_newImage(false),
+    m_animatedImage(false),
     m_image(0),
 #if ENABLE(WEBGL)
     m_is3DCanvas(false),
@@ -433,6 +435,7 @@ void GraphicsLayerAndroid::setContentsOpaque(bool opaque)
         return;
     LOG("(%x) setContentsOpaque (%d)", this, opaque);
     GraphicsLayer::setContentsOpaque(opaque);
+    m_contentLayer->setContentsOpaque(opaque);
     m_haveContents = true;
     askForSync();
 }
@@ -840,19 +843,25 @@ void GraphicsLayerAndroid::removeAnimationsForKeyframes(const String& keyframesN
     askForSync();
 }
 
-void GraphicsLayerAndroid::pauseAnimation(const String& keyframesName)
+void GraphicsLayerAndroid::pauseAnimation(const String& keyframesName, double timeOffset)
 {
-    TLOG("NRO pauseAnimation(%s)", keyframesName.latin1().data());
+    TLOG("pauseAnimation(%s) at %.2f", keyframesName.latin1().data(), timeOffset);
+    m_contentLayer->pauseAnimation(keyframesName, timeOffset);
+    askForSync();
 }
 
 void GraphicsLayerAndroid::suspendAnimations(double time)
 {
-    TLOG("NRO suspendAnimations(%.2f)", time);
+    TLOG("suspendAnimations(%.2f)", time);
+    m_contentLayer->suspendAnimations(time);
+    askForSync();
 }
 
 void GraphicsLayerAndroid::resumeAnimations()
 {
-    TLOG("NRO resumeAnimations()");
+    TLOG("resumeAnimations()");
+    m_contentLayer->resumeAnimations();
+    askForSync();
 }
 
 void GraphicsLayerAndroid::setContentsToImage(Image* image)
@@ -864,22 +873,65 @@ void GraphicsLayerAndroid::setContentsToImage(Image* image)
             m_image->deref();
         m_image = image;
 
-        SkBitmapRef* bitmap = image->nativeImageForCurrentFrame();
-        m_contentLayer->setContentsImage(bitmap);
+        m_animatedImage = image->isBitmapImage()
+            && setContentsToAnimatedImage(static_cast<BitmapImage*>(image));
+        if (!m_animatedImage) {
+            SkBitmapRef* bitmap = image->nativeImageForCurrentFrame();
+            m_contentLayer->setContentsImage(bitmap);
+        }
 
         m_haveContents = true;
         m_newImage = true;
+    } else if (image && !m_animatedImage && image->isBitmapImage()) {
+        // the remaining frames of an animated image may have arrived since
+        if (setContentsToAnimatedImage(static_cast<BitmapImage*>(image))) {
+            m_animatedImage = true;
+            m_newImage = true;
+        }
     }
     if (!image && m_image) {
         m_contentLayer->setContentsImage(0);
         m_image->deref();
         m_image = 0;
+        m_animatedImage = false;
     }
 
     setNeedsDisplay();
     askForSync();
 }
 
+// The compositor keeps every frame of an animated image as its own
+// texture, so only hand it the ones that stay small
+#define MAX_COMPOSITED_IMAGE_FRAMES 16
+#define MAX_COMPOSITED_IMAGE_BYTES (4 * 1024 * 1024)
+
+bool GraphicsLayerAndroid::setContentsToAnimatedImage(BitmapImage* image)
+{
+    size_t frameCount = image->completeFrameCount();
+    if (frameCount < 2 || frameCount > MAX_COMPOSITED_IMAGE_FRAMES)
+        return false;
+
+    IntSize size = image->size();
+    size_t frameBytes = size.width() * size.height() * 4;
+    if (!frameBytes || frameBytes * frameCount > MAX_COMPOSITED_IMAGE_BYTES)
+        return false;
+
+    Vector<SkBitmapRef*> frames;
+    Vector<float> durations;
+    for (size_t i = 0; i < frameCount; i++) {
+        SkBitmapRef* frame = image->nativeImageForFrame(i);
+        if (!frame)
+            return false;
+        frames.append(frame);
+        durations.append(image->durationForFrame(i));
+    }
+
+    TLOG("(%x) setContentsToAnimatedImage, %d frames", this, frameCount);
+    m_contentLayer->setContentsAnimatedImage(frames, durations,
+                                             image->completeRepetitionCount());
+    return true;
+}
+
 void GraphicsLayerAndroid::setContentsToMedia(PlatformLayer* mediaLayer)
 {
     // Only fullscreen video on Android, so media doesn't get it's own layer.
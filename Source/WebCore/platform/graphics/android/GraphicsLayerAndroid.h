@@ -36,6 +36,7 @@ class SkRegion;
 
 namespace WebCore {
 
+class BitmapImage;
 class ScrollableLayerAndroid;
 
 class GraphicsLayerAndroid : public GraphicsLayer {
@@ -103,7 +104,7 @@ public:
 
     virtual void removeAnimationsForProperty(AnimatedPropertyID);
     virtual void removeAnimationsForKeyframes(const String& keyframesName);
-    virtual void pauseAnimation(const String& keyframesName);
+    virtual void pauseAnimation(const String& keyframesName, double timeOffset);
 
     virtual void suspendAnimations(double time);
     virtual void resumeAnimations();
@@ -144,6 +145,9 @@ private:
     void updateFixedPosition();
     void updateScrollingLayers();
 
+    // hands all the frames of an animated image to the compositor
+    bool setContentsToAnimatedImage(BitmapImage*);
+
     // with SkPicture, we always repaint the entire layer's content.
     bool repaint();
     void needsNotifyClient();
@@ -157,6 +161,7 @@ private:
 
     bool m_haveContents;
     bool m_newImage;
+    bool m_animatedImage;
     Image* m_image;
 
 #if ENABLE(WEBGL)
@@ -196,6 +196,18 @@ void BitmapImage::draw(GraphicsContext* ctxt, const FloatRect& dstRect,
         return;
     }
 
+    SkCanvas*   canvas = ctxt->platformContext()->mCanvas;
+    SkRect  dstR(dstRect);
+
+    // size the whole image would cover, given the part of it we draw
+    if (!srcRect.isEmpty()) {
+        SkRect drawnR;
+        canvas->getTotalMatrix().mapRect(&drawnR, dstR);
+        m_source.willDrawAtSize(IntSize(SkScalarCeil(drawnR.width() * m_size.width() / srcRect.width()),
+                                        SkScalarCeil(drawnR.height() * m_size.height() / srcRect.height())),
+                                data());
+    }
+
     // in case we get called with an incomplete bitmap
     const SkBitmap& bitmap = image->bitmap();
     if (bitmap.getPixels() == NULL && bitmap.pixelRef() == NULL) {
@@ -208,7 +220,6 @@ void BitmapImage::draw(GraphicsContext* ctxt, const FloatRect& dstRect,
     }
 
     SkIRect srcR;
-    SkRect  dstR(dstRect);
     float invScaleX = (float)bitmap.width() / image->origWidth();
     float invScaleY = (float)bitmap.height() / image->origHeight();
 
@@ -222,7 +233,6 @@ void BitmapImage::draw(GraphicsContext* ctxt, const FloatRect& dstRect,
         return;
     }
 
-    SkCanvas*   canvas = ctxt->platformContext()->mCanvas;
     SkPaint     paint;
 
     ctxt->setupBitmapPaint(&paint);   // need global alpha among other things
@@ -246,6 +256,23 @@ void BitmapImage::setURL(const String& str)
     m_source.setURL(str);
 }
 
+void BitmapImage::decodeAhead(const IntSize& sizeHint)
+{
+    m_source.decodeAhead(sizeHint, data());
+}
+
+size_t BitmapImage::completeFrameCount()
+{
+    if (!m_allDataReceived)
+        return 0;
+    size_t count = frameCount();
+    for (size_t i = 0; i < count; ++i) {
+        if (!frameIsCompleteAtIndex(i))
+            return 0;
+    }
+    return count;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 void Image::drawPattern(GraphicsContext* ctxt, const FloatRect& srcRect,
@@ -50,6 +50,10 @@
 #include "image-encoders/skia/PNGImageEncoder.h"
 #include <wtf/text/StringConcatenate.h>
 
+#if CPU(ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 using namespace std;
 
 namespace WebCore {
@@ -200,6 +204,75 @@ void ImageBuffer::drawPattern(GraphicsContext* context, const FloatRect& srcRect
     imageCopy->drawPattern(context, srcRect, patternTransform, phase, styleColorSpace, op, destRect);
 }
 
+// With this packing a canvas pixel is laid out in memory as R, G, B, A bytes,
+// the same order ImageData uses, so only the alpha arithmetic differs.
+#if CPU(ARM_NEON) && SK_R32_SHIFT == 0 && SK_G32_SHIFT == 8 && SK_B32_SHIFT == 16 && SK_A32_SHIFT == 24
+#define NEON_IMAGE_DATA_CONVERSION 1
+#endif
+
+static inline void unpremultiplyPixels(const SkPMColor* source, unsigned char* destination, int count)
+{
+    static const SkUnPreMultiply::Scale* scale = SkUnPreMultiply::GetScaleTable();
+    for (int x = 0; x < count; ++x) {
+        SkPMColor pixel = source[x];
+        unsigned alpha = SkGetPackedA32(pixel);
+        unsigned char* output = destination + x * 4;
+        if (alpha == 0xFF) {
+            output[0] = SkGetPackedR32(pixel);
+            output[1] = SkGetPackedG32(pixel);
+            output[2] = SkGetPackedB32(pixel);
+        } else {
+            output[0] = SkUnPreMultiply::ApplyScale(scale[alpha], SkGetPackedR32(pixel));
+            output[1] = SkUnPreMultiply::ApplyScale(scale[alpha], SkGetPackedG32(pixel));
+            output[2] = SkUnPreMultiply::ApplyScale(scale[alpha], SkGetPackedB32(pixel));
+        }
+        output[3] = alpha;
+    }
+}
+
+static void unpremultiplyRow(const SkPMColor* source, unsigned char* destination, int width)
+{
+    int x = 0;
+#if NEON_IMAGE_DATA_CONVERSION
+    // Canvases are mostly opaque; eight opaque pixels in a row are already
+    // valid ImageData and are copied as they are.
+    for (; x + 8 <= width; x += 8) {
+        uint32x4_t low = vld1q_u32(source + x);
+        uint32x4_t high = vld1q_u32(source + x + 4);
+        uint32x4_t minimum = vminq_u32(low, high);
+        uint32x2_t minimumPair = vpmin_u32(vget_low_u32(minimum), vget_high_u32(minimum));
+        minimumPair = vpmin_u32(minimumPair, minimumPair);
+        if (vget_lane_u32(minimumPair, 0) >= 0xFF000000) {
+            vst1q_u8(destination + x * 4, vreinterpretq_u8_u32(low));
+            vst1q_u8(destination + x * 4 + 16, vreinterpretq_u8_u32(high));
+        } else
+            unpremultiplyPixels(source + x, destination + x * 4, 8);
+    }
+#endif
+    unpremultiplyPixels(source + x, destination + x * 4, width - x);
+}
+
+static void premultiplyRow(const unsigned char* source, SkPMColor* destination, int width)
+{
+    int x = 0;
+#if NEON_IMAGE_DATA_CONVERSION
+    for (; x + 8 <= width; x += 8) {
+        uint8x8x4_t pixels = vld4_u8(source + x * 4);
+        uint8x8_t alpha = pixels.val[3];
+        // SkMulDiv255Round() on eight channels at once.
+        for (int channel = 0; channel < 3; ++channel) {
+            uint16x8_t product = vmlal_u8(vdupq_n_u16(128), pixels.val[channel], alpha);
+            pixels.val[channel] = vaddhn_u16(product, vshrq_n_u16(product, 8));
+        }
+        vst4_u8(reinterpret_cast<uint8_t*>(destination + x), pixels);
+    }
+#endif
+    for (; x < width; ++x) {
+        const unsigned char* pixel = source + x * 4;
+        destination[x] = SkPreMultiplyARGB(pixel[3], pixel[0], pixel[1], pixel[2]);
+    }
+}
+
 PassRefPtr<ByteArray> ImageBuffer::getUnmultipliedImageData(const IntRect& rect) const
 {
     ASSERT(context() && context()->platformContext());
@@ -253,15 +326,7 @@ PassRefPtr<ByteArray> ImageBuffer::getUnmultipliedImageData(const IntRect& rect)
     const SkPMColor* srcRows = src.getAddr32(originx, originy);
     unsigned char* destRows = data + desty * destBytesPerRow + destx * 4;
     for (int y = 0; y < numRows; ++y) {
-        for (int x = 0; x < numColumns; x++) {
-            // ugh, it appears they want unpremultiplied pixels
-            SkColor c = SkUnPreMultiply::PMColorToColor(srcRows[x]);
-            int basex = x * 4;
-            destRows[basex + 0] = SkColorGetR(c);
-            destRows[basex + 1] = SkColorGetG(c);
-            destRows[basex + 2] = SkColorGetB(c);
-            destRows[basex + 3] = SkColorGetA(c);
-        }
+        unpremultiplyRow(srcRows, destRows, numColumns);
         srcRows += srcPixelsPerRow;
         destRows += destBytesPerRow;
     }
@@ -319,13 +384,7 @@ void ImageBuffer::putUnmultipliedImageData(ByteArray* source, const IntSize& sou
     unsigned char* srcRows = source->data() + originy * srcBytesPerRow + originx * 4;
     SkPMColor* dstRows = dst.getAddr32(destx, desty);
     for (int y = 0; y < numRows; ++y) {
-        for (int x = 0; x < numColumns; x++) {
-            int basex = x * 4;
-            dstRows[x] = SkPackARGB32(srcRows[basex + 3],
-                                      srcRows[basex + 0],
-                                      srcRows[basex + 1],
-                                      srcRows[basex + 2]);
-        }
+        premultiplyRow(srcRows, dstRows, numColumns);
         dstRows += dstPixelsPerRow;
         srcRows += srcBytesPerRow;
     }
@@ -0,0 +1,91 @@
+/*
+ * Copyright 2012, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "ImagePredecoder.h"
+
+#include "SkPixelRef.h"
+
+#include <wtf/Atomics.h>
+#include <wtf/CurrentTime.h>
+#include <wtf/StdLibExtras.h>
+#include <wtf/ThreadPool.h>
+
+#ifdef DEBUG
+
+#include <cutils/log.h>
+
+#undef XLOG
+#define XLOG(...) android_printLog(ANDROID_LOG_DEBUG, "ImagePredecoder", __VA_ARGS__)
+
+#else
+
+#undef XLOG
+#define XLOG(...)
+
+#endif // DEBUG
+
+// Past this many images waiting, the page is loading faster than we
+// decode and the extra ones are decoded when drawn, as before.
+#define MAX_QUEUED_DECODES 16
+
+namespace WebCore {
+
+// Predecodes queued on the pool but not started yet. The limit is a soft
+// one, so checking it without a lock is fine.
+static int volatile queuedDecodeCount;
+
+static TaskKind& predecodingTasks()
+{
+    DEFINE_STATIC_LOCAL(TaskKind, kind, ("ImagePredecoder", TaskPriorityBackground, 1));
+    return kind;
+}
+
+void ImagePredecoder::predecode(SkPixelRef* ref)
+{
+    if (queuedDecodeCount >= MAX_QUEUED_DECODES)
+        return;
+    atomicIncrement(&queuedDecodeCount);
+    ref->ref();
+    ThreadPool::shared().dispatch(predecodingTasks(), decode, ref);
+}
+
+void ImagePredecoder::decode(void* context)
+{
+    SkPixelRef* ref = static_cast<SkPixelRef*>(context);
+    atomicDecrement(&queuedDecodeCount);
+
+#ifdef DEBUG
+    double startTime = currentTime();
+#endif
+    // The decoded pixels stay in the image cache (or the unpinned ashmem
+    // region) after they are unlocked, until memory pressure purges them.
+    ref->lockPixels();
+    ref->unlockPixels();
+    XLOG("decoded %s in %.1f ms", ref->getURI() ? ref->getURI() : "", (currentTime() - startTime) * 1000);
+    ref->unref();
+}
+
+} // namespace WebCore
@@ -25,9 +25,12 @@
 
 #include "config.h"
 #include "BitmapAllocatorAndroid.h"
+#include "ImagePredecoder.h"
 #include "ImageSource.h"
 #include "IntSize.h"
+#include "JPEGImageDecoder.h"
 #include "NotImplemented.h"
+#include "PNGImageDecoder.h"
 #include "SharedBuffer.h"
 #include "PlatformString.h"
 
@@ -48,6 +51,15 @@
 
 SkPixelRef* SkCreateRLEPixelRef(const SkBitmap& src);
 
+// decoding smaller images when they are first drawn doesn't stall anything
+#define MIN_PREDECODE_SIZE          (256*1024)
+
+// Pictures are recorded in document coordinates but tiles are rasterized
+// at the zoom scale times the screen density. Keep this much more
+// resolution than the recorded size, so a double tap zoom on a hdpi screen
+// still looks sharp without a re-decode.
+#define DRAW_SIZE_HEADROOM          3
+
 //#define TRACE_SUBSAMPLE_BITMAPS
 //#define TRACE_RLE_BITMAPS
 
@@ -120,12 +132,18 @@ class PrivateAndroidImageSourceRec : public SkBitmapRef {
 public:
     PrivateAndroidImageSourceRec(const SkBitmap& bm, int origWidth,
                                  int origHeight, int sampleSize)
-            : SkBitmapRef(bm), fSampleSize(sampleSize), fAllDataReceived(false) {
+            : SkBitmapRef(bm), fSampleSize(sampleSize), fMinSampleSize(sampleSize),
+              fAllDataReceived(false), fDrawnWidth(0), fDrawnHeight(0) {
         this->setOrigSize(origWidth, origHeight);
     }
 
     int  fSampleSize;
+    // the memory budget won't let us decode with less subsampling than this
+    int  fMinSampleSize;
     bool fAllDataReceived;
+    // largest size (with zoom headroom) the image has been drawn at so far
+    int  fDrawnWidth;
+    int  fDrawnHeight;
 };
 
 namespace WebCore {
@@ -135,6 +153,7 @@ ImageSource::ImageSource(AlphaOption alphaOption, GammaAndColorProfileOption gam
     , m_gammaAndColorProfileOption(gammaAndColorProfileOption)
 {
     m_decoder.m_image = NULL;
+    m_decoder.m_partialDecoder = 0;
 #ifdef ANDROID_ANIMATED_GIF
     m_decoder.m_gifDecoder = 0;
 #endif
@@ -142,6 +161,7 @@ ImageSource::ImageSource(AlphaOption alphaOption, GammaAndColorProfileOption gam
 
 ImageSource::~ImageSource() {
     delete m_decoder.m_image;
+    delete m_decoder.m_partialDecoder;
 #ifdef ANDROID_ANIMATED_GIF
     delete m_decoder.m_gifDecoder;
 #endif
@@ -223,6 +243,17 @@ static bool should_use_animated_gif(int width, int height) {
 }
 #endif
 
+static ImageDecoder* createPartialDecoder(const char* contents, size_t length,
+        ImageSource::AlphaOption alphaOption,
+        ImageSource::GammaAndColorProfileOption gammaAndColorProfileOption)
+{
+    if (length >= 3 && !memcmp(contents, "\xFF\xD8\xFF", 3))
+        return new JPEGImageDecoder(alphaOption, gammaAndColorProfileOption);
+    if (length >= 4 && !memcmp(contents, "\x89PNG", 4))
+        return new PNGImageDecoder(alphaOption, gammaAndColorProfileOption);
+    return 0;
+}
+
 void ImageSource::setData(SharedBuffer* data, bool allDataReceived)
 {
 #ifdef ANDROID_ANIMATED_GIF
@@ -301,8 +332,21 @@ void ImageSource::setData(SharedBuffer* data, bool allDataReceived)
     }
 
     PrivateAndroidImageSourceRec* decoder = m_decoder.m_image;
+    if (!allDataReceived && decoder) {
+        // Decoding a partial image means holding its full size pixels in
+        // the heap, so only do it for images we won't subsample.
+        if (!m_decoder.m_partialDecoder && decoder->fSampleSize == 1)
+            m_decoder.m_partialDecoder = createPartialDecoder(data->data(), data->size(),
+                    m_alphaOption, m_gammaAndColorProfileOption);
+        if (m_decoder.m_partialDecoder)
+            m_decoder.m_partialDecoder->setData(data, false);
+    }
+
     if (allDataReceived && decoder && !decoder->fAllDataReceived) {
         decoder->fAllDataReceived = true;
+        // From here on the purgeable, lazily decoded pixel ref takes over.
+        delete m_decoder.m_partialDecoder;
+        m_decoder.m_partialDecoder = 0;
 
         SkBitmap* bm = &decoder->bitmap();
         SkPixelRef* ref = convertToRLE(bm, data->data(), data->size());
@@ -324,6 +368,89 @@ void ImageSource::setData(SharedBuffer* data, bool allDataReceived)
     }
 }
 
+static int computeDrawSampleSize(const PrivateAndroidImageSourceRec& decoder) {
+    int sampleSize = 1;
+    // the next power of two must still leave at least the drawn size
+    while (decoder.origWidth() / (sampleSize << 1) >= decoder.fDrawnWidth
+           && decoder.origHeight() / (sampleSize << 1) >= decoder.fDrawnHeight)
+        sampleSize <<= 1;
+    return std::max(sampleSize, decoder.fMinSampleSize);
+}
+
+void ImageSource::willDrawAtSize(const IntSize& size, SharedBuffer* data)
+{
+    PrivateAndroidImageSourceRec* decoder = m_decoder.m_image;
+    if (!decoder || !decoder->fAllDataReceived || !data)
+        return;
+    SkBitmap* bm = &decoder->bitmap();
+    // RLE images are already decoded, in memory that we can't shrink
+    if (bm->config() == SkBitmap::kRLE_Index8_Config)
+        return;
+
+    int drawnWidth = size.width() * DRAW_SIZE_HEADROOM;
+    int drawnHeight = size.height() * DRAW_SIZE_HEADROOM;
+    bool predecode = !decoder->fDrawnWidth && !decoder->fDrawnHeight;
+    if (!predecode && drawnWidth <= decoder->fDrawnWidth && drawnHeight <= decoder->fDrawnHeight)
+        return;
+    decoder->fDrawnWidth = std::max(decoder->fDrawnWidth, drawnWidth);
+    decoder->fDrawnHeight = std::max(decoder->fDrawnHeight, drawnHeight);
+
+    // The first draw only ever coarsens the sample size picked in setData;
+    // later, larger draws bring back resolution. Either way the pixels are
+    // decoded lazily, so switching before they are first locked is free.
+    int sampleSize = computeDrawSampleSize(*decoder);
+    if (sampleSize != decoder->fSampleSize) {
+        SkBitmap tmp;
+        SkMemoryStream stream(data->data(), data->size(), false);
+        SkImageDecoder* codec = SkImageDecoder::Factory(&stream);
+        if (!codec)
+            return;
+        SkAutoTDelete<SkImageDecoder> ad(codec);
+        codec->setPrefConfigTable(gPrefConfigTable);
+        codec->setSampleSize(sampleSize);
+        if (!codec->decode(&stream, &tmp, SkImageDecoder::kDecodeBounds_Mode))
+            return;
+
+        // Pictures that recorded the old bitmap keep its pixel ref alive
+        // until they are re-recorded.
+        BitmapAllocatorAndroid alloc(data, sampleSize);
+        if (!alloc.allocPixelRef(&tmp, NULL))
+            return;
+        SkPixelRef* ref = tmp.pixelRef();
+        ref->setImmutable();
+        ref->setURI(m_decoder.m_url);
+        *bm = tmp;
+        decoder->fSampleSize = sampleSize;
+        predecode = true;
+    }
+
+    // Big images start decoding in the background now that we know what to
+    // decode, so they are ready by the time the tiles showing them are
+    // painted.
+    if (predecode && bm->getSize() >= MIN_PREDECODE_SIZE)
+        ImagePredecoder::predecode(bm->pixelRef());
+}
+
+void ImageSource::decodeAhead(const IntSize& sizeHint, SharedBuffer* data)
+{
+    PrivateAndroidImageSourceRec* decoder = m_decoder.m_image;
+    if (!decoder || !decoder->fAllDataReceived)
+        return;
+    SkBitmap* bm = &decoder->bitmap();
+    if (bm->config() == SkBitmap::kRLE_Index8_Config)
+        return;
+
+    // With a size from the markup this is the decode the first draw would
+    // have asked for, and already queues it if the image is big.
+    if (!sizeHint.isEmpty()) {
+        willDrawAtSize(sizeHint, data);
+        if (bm->getSize() >= MIN_PREDECODE_SIZE)
+            return;
+    }
+    // The page is waiting on these images, decode them whatever their size.
+    ImagePredecoder::predecode(bm->pixelRef());
+}
+
 bool ImageSource::isSizeAvailable()
 {
     return
@@ -387,6 +514,17 @@ SkBitmapRef* ImageSource::createFrameAtIndex(size_t index)
     SkASSERT(index == 0);
 #endif
     SkASSERT(m_decoder.m_image != NULL);
+    if (m_decoder.m_partialDecoder) {
+        // Decodes whatever arrived since the last call. The bitmap keeps
+        // changing, so it is handed out as a copy instead of the shared
+        // (immutable) one.
+        ImageFrame* buffer = m_decoder.m_partialDecoder->frameBufferAtIndex(0);
+        if (buffer && buffer->status() != ImageFrame::FrameEmpty) {
+            SkBitmapRef* ref = new SkBitmapRef(buffer->bitmap());
+            ref->setOrigSize(m_decoder.m_image->origWidth(), m_decoder.m_image->origHeight());
+            return ref;
+        }
+    }
     m_decoder.m_image->ref();
     return m_decoder.m_image;
 }
@@ -458,6 +596,11 @@ bool ImageSource::frameIsCompleteAtIndex(size_t index)
 
 void ImageSource::clear(bool destroyAll, size_t clearBeforeFrame, SharedBuffer* data, bool allDataReceived)
 {
+    // the next chunk of data starts a new partial decode if it is still needed
+    if (destroyAll) {
+        delete m_decoder.m_partialDecoder;
+        m_decoder.m_partialDecoder = 0;
+    }
 #ifdef ANDROID_ANIMATED_GIF
     if (!destroyAll) {
         if (m_decoder.m_gifDecoder)
@@ -112,6 +112,7 @@ ImageTexture::~ImageTexture()
 #ifdef DEBUG_COUNT
     ClassTracker::instance()->decrement("ImageTexture");
 #endif
+    TilesManager::instance()->textureAtlas()->remove(m_atlasLocation);
     delete m_image;
     delete m_texture;
     SkSafeUnref(m_picture);
@@ -159,7 +160,7 @@ int ImageTexture::nbTextures()
 {
     if (!hasContentToShow())
         return 0;
-    if (!m_texture)
+    if (!m_texture || TilesManager::instance()->textureAtlas()->contains(m_atlasLocation))
         return 0;
 
     // TODO: take in account the visible clip (need to maintain
@@ -182,11 +183,31 @@ bool ImageTexture::hasContentToShow()
     return true;
 }
 
+bool ImageTexture::prepareAtlas()
+{
+    if (!TextureAtlas::fits(m_image->width(), m_image->height()))
+        return false;
+
+    TextureAtlas* atlas = TilesManager::instance()->textureAtlas();
+    if (atlas->contains(m_atlasLocation))
+        return true;
+    if (!atlas->add(*m_image, &m_atlasLocation))
+        return false;
+
+    // the tiles painted while the atlas was full aren't needed anymore
+    delete m_texture;
+    m_texture = 0;
+    return true;
+}
+
 bool ImageTexture::prepareGL(GLWebViewState* state)
 {
     if (!hasContentToShow())
         return false;
 
+    if (prepareAtlas())
+        return false;
+
     if (!m_texture && m_picture) {
         m_texture = new TiledTexture(this);
         SkRegion region;
@@ -240,7 +261,14 @@ void ImageTexture::drawGL(LayerAndroid* layer)
     // TiledTexture::draw() will call us back to know the
     // transform and opacity, so we need to set m_layer
     m_layer = layer;
-    if (m_texture)
+    GLuint textureId = 0;
+    SkRect texCoordRect;
+    if (TilesManager::instance()->textureAtlas()->get(m_atlasLocation, &textureId, &texCoordRect)) {
+        SkRect rect = SkRect::MakeWH(m_image->width(), m_image->height());
+        TilesManager::instance()->shader()->drawLayerQuad(*transform(), rect, textureId,
+                                                          opacity(), true, GL_TEXTURE_2D,
+                                                          &texCoordRect);
+    } else if (m_texture)
         m_texture->draw();
     m_layer = 0;
 }
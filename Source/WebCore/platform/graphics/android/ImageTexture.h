@@ -32,6 +32,7 @@
 #include "SkPicture.h"
 #include "SkRefCnt.h"
 #include "LayerAndroid.h"
+#include "TextureAtlas.h"
 
 namespace WebCore {
 
@@ -65,6 +66,8 @@ class TiledTexture;
 // ImageTexture recopy the original SkBitmap so that they can safely be used
 // on a different thread; it uses TiledTexture to allocate and paint the image,
 // so that we can share the same textures and limits as the rest of the layers.
+// Small images are instead uploaded into the TilesManager's TextureAtlas, and
+// drawn from there, unless it is full.
 //
 /////////////////////////////////////////////////////////////////////////////////
 class ImageTexture : public SurfacePainter {
@@ -93,6 +96,8 @@ public:
     virtual SurfaceType type() { return SurfacePainter::ImageSurface; }
 
 private:
+    // returns true if the image is drawn from the atlas
+    bool prepareAtlas();
 
     SkBitmapRef* m_imageRef;
     SkBitmap* m_image;
@@ -101,6 +106,7 @@ private:
     SkPicture* m_picture;
     TransformationMatrix m_layerMatrix;
     unsigned m_crc;
+    TextureAtlas::Location m_atlasLocation;
 };
 
 } // namespace WebCore
@@ -7,6 +7,7 @@
 #include "ClassTracker.h"
 #include "DrawExtra.h"
 #include "GLUtils.h"
+#include "ImageSource.h"
 #include "ImagesManager.h"
 #include "MediaLayer.h"
 #include "PaintedSurface.h"
@@ -150,6 +151,8 @@ LayerAndroid::LayerAndroid(RenderLayer* owner) : Layer(),
     m_uniqueId(++gUniqueId),
     m_texture(0),
     m_imageCRC(0),
+    m_imageRepetitionCount(0),
+    m_imageAnimationStart(0),
     m_pictureUsed(0),
     m_scale(1),
     m_lastComputeTextureSize(0),
@@ -158,6 +161,7 @@ LayerAndroid::LayerAndroid(RenderLayer* owner) : Layer(),
     m_hasText(true)
 {
     m_backgroundColor = 0;
+    m_contentsOpaque = false;
 
     m_preserves3D = false;
     m_iframeOffset.set(0,0);
@@ -181,12 +185,19 @@ LayerAndroid::LayerAndroid(const LayerAndroid& layer) : Layer(layer),
     m_imageCRC = layer.m_imageCRC;
     if (m_imageCRC)
         ImagesManager::instance()->retainImage(m_imageCRC);
+    m_imageFrameCRCs = layer.m_imageFrameCRCs;
+    for (unsigned i = 0; i < m_imageFrameCRCs.size(); i++)
+        ImagesManager::instance()->retainImage(m_imageFrameCRCs[i]);
+    m_imageFrameEnds = layer.m_imageFrameEnds;
+    m_imageRepetitionCount = layer.m_imageRepetitionCount;
+    m_imageAnimationStart = layer.m_imageAnimationStart;
 
     m_renderLayerPos = layer.m_renderLayerPos;
     m_transform = layer.m_transform;
     m_backfaceVisibility = layer.m_backfaceVisibility;
     m_visible = layer.m_visible;
     m_backgroundColor = layer.m_backgroundColor;
+    m_contentsOpaque = layer.m_contentsOpaque;
 
     m_fixedLeft = layer.m_fixedLeft;
     m_fixedTop = layer.m_fixedTop;
@@ -251,6 +262,8 @@ LayerAndroid::LayerAndroid(SkPicture* picture) : Layer(),
     m_uniqueId(++gUniqueId),
     m_texture(0),
     m_imageCRC(0),
+    m_imageRepetitionCount(0),
+    m_imageAnimationStart(0),
     m_scale(1),
     m_lastComputeTextureSize(0),
     m_owningLayer(0),
@@ -258,6 +271,7 @@ LayerAndroid::LayerAndroid(SkPicture* picture) : Layer(),
     m_hasText(true)
 {
     m_backgroundColor = 0;
+    m_contentsOpaque = false;
     SkSafeRef(m_recordingPicture);
     m_iframeOffset.set(0,0);
     m_dirtyRegion.setEmpty();
@@ -271,6 +285,7 @@ LayerAndroid::~LayerAndroid()
 {
     if (m_imageCRC)
         ImagesManager::instance()->releaseImage(m_imageCRC);
+    releaseImageFrames();
 
     SkSafeUnref(m_recordingPicture);
     m_animations.clear();
@@ -382,6 +397,46 @@ void LayerAndroid::removeAnimationsForKeyframes(const String& name)
         m_animations.remove(toDelete[i]);
 }
 
+// The animations are shared with the copies of this layer already handed to
+// the UI thread, so state changes are made on new copies of the animations:
+// they then only reach the compositor with the next layer tree.
+void LayerAndroid::pauseAnimation(const String& name, double timeOffset)
+{
+    KeyframesMap::iterator end = m_animations.end();
+    for (KeyframesMap::iterator it = m_animations.begin(); it != end; ++it) {
+        if ((it->second)->name() != name)
+            continue;
+        RefPtr<AndroidAnimation> anim = (it->second)->copy();
+        anim->pause(timeOffset, false);
+        it->second = anim.release();
+    }
+}
+
+void LayerAndroid::suspendAnimations(double time)
+{
+    KeyframesMap::iterator end = m_animations.end();
+    for (KeyframesMap::iterator it = m_animations.begin(); it != end; ++it) {
+        if ((it->second)->isPaused())
+            continue;
+        RefPtr<AndroidAnimation> anim = (it->second)->copy();
+        anim->pause(anim->elapsedTime(time), true);
+        it->second = anim.release();
+    }
+}
+
+void LayerAndroid::resumeAnimations()
+{
+    double time = WTF::currentTime();
+    KeyframesMap::iterator end = m_animations.end();
+    for (KeyframesMap::iterator it = m_animations.begin(); it != end; ++it) {
+        if (!(it->second)->isSuspended())
+            continue;
+        RefPtr<AndroidAnimation> anim = (it->second)->copy();
+        anim->resume(time);
+        it->second = anim.release();
+    }
+}
+
 // We only use the bounding rect of the layer as mask...
 // FIXME: use a real mask?
 void LayerAndroid::setMaskLayer(LayerAndroid* layer)
@@ -773,6 +828,61 @@ void LayerAndroid::setContentsImage(SkBitmapRef* img)
     ImageTexture* image = ImagesManager::instance()->setImage(img);
     ImagesManager::instance()->releaseImage(m_imageCRC);
     m_imageCRC = image ? image->imageCRC() : 0;
+    releaseImageFrames();
+}
+
+void LayerAndroid::setContentsAnimatedImage(const Vector<SkBitmapRef*>& frames,
+                                            const Vector<float>& durations,
+                                            int repetitionCount)
+{
+    setContentsImage(frames.isEmpty() ? 0 : frames[0]);
+    if (frames.size() < 2 || !m_imageCRC)
+        return;
+
+    double end = 0;
+    for (unsigned i = 0; i < frames.size(); i++) {
+        ImageTexture* image = ImagesManager::instance()->setImage(frames[i]);
+        if (!image) {
+            releaseImageFrames();
+            return;
+        }
+        end += durations[i];
+        m_imageFrameCRCs.append(image->imageCRC());
+        m_imageFrameEnds.append(end);
+    }
+    m_imageRepetitionCount = repetitionCount;
+    m_imageAnimationStart = WTF::currentTime();
+}
+
+void LayerAndroid::releaseImageFrames()
+{
+    for (unsigned i = 0; i < m_imageFrameCRCs.size(); i++)
+        ImagesManager::instance()->releaseImage(m_imageFrameCRCs[i]);
+    m_imageFrameCRCs.clear();
+    m_imageFrameEnds.clear();
+}
+
+unsigned LayerAndroid::currentImageCRC(bool& isAnimating)
+{
+    isAnimating = false;
+    if (m_imageFrameCRCs.size() < 2 || m_imageRepetitionCount == cAnimationNone)
+        return m_imageCRC;
+
+    double loopDuration = m_imageFrameEnds.last();
+    double elapsed = WTF::currentTime() - m_imageAnimationStart;
+    if (loopDuration <= 0)
+        return m_imageCRC;
+    if (m_imageRepetitionCount != cAnimationLoopInfinite
+        && elapsed >= loopDuration * (m_imageRepetitionCount + 1))
+        return m_imageFrameCRCs.last();
+
+    isAnimating = true;
+    double position = fmod(elapsed, loopDuration);
+    for (unsigned i = 0; i < m_imageFrameEnds.size(); i++) {
+        if (position < m_imageFrameEnds[i])
+            return m_imageFrameCRCs[i];
+    }
+    return m_imageFrameCRCs.last();
 }
 
 bool LayerAndroid::needsTexture()
@@ -893,29 +1003,48 @@ void LayerAndroid::setIsPainting(Layer* drawingTree)
 {
     XLOG("setting layer %p as painting, needs texture %d, drawing tree %p",
          this, needsTexture(), drawingTree);
+    LayerIdMap drawingLayers;
+    if (drawingTree)
+        static_cast<LayerAndroid*>(drawingTree)->collectLayersById(drawingLayers);
+    setIsPainting(drawingLayers);
+}
+
+void LayerAndroid::setIsPainting(const LayerIdMap& drawingLayers)
+{
     int count = this->countChildren();
     for (int i = 0; i < count; i++)
-        this->getChild(i)->setIsPainting(drawingTree);
-
-
-    LayerAndroid* drawingLayer = 0;
-    if (drawingTree)
-        drawingLayer = static_cast<LayerAndroid*>(drawingTree)->findById(uniqueId());
+        this->getChild(i)->setIsPainting(drawingLayers);
 
-    obtainTextureForPainting(drawingLayer);
+    obtainTextureForPainting(drawingLayers.get(uniqueId()));
 }
 
 void LayerAndroid::mergeInvalsInto(Layer* replacementTree)
+{
+    LayerIdMap replacementLayers;
+    static_cast<LayerAndroid*>(replacementTree)->collectLayersById(replacementLayers);
+    mergeInvalsInto(replacementLayers);
+}
+
+void LayerAndroid::mergeInvalsInto(const LayerIdMap& replacementLayers)
 {
     int count = this->countChildren();
     for (int i = 0; i < count; i++)
-        this->getChild(i)->mergeInvalsInto(replacementTree);
+        this->getChild(i)->mergeInvalsInto(replacementLayers);
 
-    LayerAndroid* replacementLayer = static_cast<LayerAndroid*>(replacementTree)->findById(uniqueId());
+    LayerAndroid* replacementLayer = replacementLayers.get(uniqueId());
     if (replacementLayer)
         replacementLayer->markAsDirty(m_dirtyRegion);
 }
 
+void LayerAndroid::collectLayersById(LayerIdMap& layers)
+{
+    // add() keeps an existing entry, so the first layer in pre-order wins
+    layers.add(m_uniqueId, this);
+    int count = countChildren();
+    for (int i = 0; i < count; i++)
+        getChild(i)->collectLayersById(layers);
+}
+
 bool LayerAndroid::isReady()
 {
     int count = countChildren();
@@ -929,6 +1058,42 @@ bool LayerAndroid::isReady()
     return true;
 }
 
+void LayerAndroid::addOpaqueArea(SkRegion& area)
+{
+    if (!m_visible)
+        return;
+
+    int count = countChildren();
+    for (int i = 0; i < count; i++)
+        getChild(i)->addOpaqueArea(area);
+
+    // only an axis aligned, fully opaque layer with all of its visible
+    // content uploaded hides what is beneath it
+    if (!hasOpaqueContent()
+        || m_state->layersRenderingMode() >= GLWebViewState::kScrollableAndFixedLayers)
+        return;
+
+    if (!m_drawTransform.isAffine() || m_drawTransform.b() || m_drawTransform.c())
+        return;
+
+    FloatRect bounds(0, 0, getSize().width(), getSize().height());
+    bounds = m_drawTransform.mapRect(bounds);
+    bounds.intersect(m_clippingRect);
+
+    // round inwards, partially covered pixels still show what's beneath
+    SkIRect opaque;
+    opaque.set(ceilf(bounds.x()), ceilf(bounds.y()),
+               floorf(bounds.maxX()), floorf(bounds.maxY()));
+    if (!opaque.isEmpty())
+        area.op(opaque, SkRegion::kUnion_Op);
+}
+
+bool LayerAndroid::hasOpaqueContent()
+{
+    return m_contentsOpaque && m_drawOpacity >= 1 && !m_imageCRC
+        && m_texture && m_texture->isReady();
+}
+
 bool LayerAndroid::updateWithTree(LayerAndroid* newTree)
 {
 // Disable fast update for now
@@ -1122,10 +1287,13 @@ bool LayerAndroid::drawGL()
         if (m_texture)
             askScreenUpdate |= m_texture->draw();
         if (m_imageCRC) {
-            ImageTexture* imageTexture = ImagesManager::instance()->retainImage(m_imageCRC);
+            bool isAnimating = false;
+            unsigned imageCRC = currentImageCRC(isAnimating);
+            ImageTexture* imageTexture = ImagesManager::instance()->retainImage(imageCRC);
             if (imageTexture)
                 imageTexture->drawGL(this);
-            ImagesManager::instance()->releaseImage(m_imageCRC);
+            ImagesManager::instance()->releaseImage(imageCRC);
+            askScreenUpdate |= isAnimating;
         }
     }
 
@@ -1225,14 +1393,16 @@ void LayerAndroid::onDraw(SkCanvas* canvas, SkScalar opacity)
         canvas->setDrawFilter(new OpacityDrawFilter(canvasOpacity));
 
     if (m_imageCRC) {
-        ImageTexture* imageTexture = ImagesManager::instance()->retainImage(m_imageCRC);
+        bool isAnimating = false;
+        unsigned imageCRC = currentImageCRC(isAnimating);
+        ImageTexture* imageTexture = ImagesManager::instance()->retainImage(imageCRC);
         m_dirtyRegion.setEmpty();
         if (imageTexture) {
             SkRect dest;
             dest.set(0, 0, getSize().width(), getSize().height());
             imageTexture->drawCanvas(canvas, dest);
         }
-        ImagesManager::instance()->releaseImage(m_imageCRC);
+        ImagesManager::instance()->releaseImage(imageCRC);
     }
     contentDraw(canvas);
 }
@@ -33,6 +33,7 @@
 #include "TransformationMatrix.h"
 
 #include <wtf/HashMap.h>
+#include <wtf/Vector.h>
 
 #ifndef BZERO_DEFINED
 #define BZERO_DEFINED
@@ -58,7 +59,7 @@ class ImageTexture;
 namespace android {
 class DrawExtra;
 void serializeLayer(WebCore::LayerAndroid* layer, SkWStream* stream);
-WebCore::LayerAndroid* deserializeLayer(SkStream* stream);
+WebCore::LayerAndroid* deserializeLayer(SkStream* stream, int version);
 void cleanupImageRefs(WebCore::LayerAndroid* layer);
 }
 
@@ -204,6 +205,7 @@ public:
     }
 
     void setBackgroundColor(SkColor color);
+    void setContentsOpaque(bool opaque) { m_contentsOpaque = opaque; }
     void setMaskLayer(LayerAndroid*);
     void setMasksToBounds(bool masksToBounds)
     {
@@ -216,10 +218,14 @@ public:
     void addAnimation(PassRefPtr<AndroidAnimation> anim);
     void removeAnimationsForProperty(AnimatedPropertyID property);
     void removeAnimationsForKeyframes(const String& name);
+    void pauseAnimation(const String& name, double timeOffset);
+    void suspendAnimations(double time);
+    void resumeAnimations();
     bool evaluateAnimations();
     bool evaluateAnimations(double time);
     void initAnimations();
     bool hasAnimations() const;
+    bool hasRunningAnimations() const { return m_hasRunningAnimations; }
     void addDirtyArea();
 
     SkPicture* picture() const { return m_recordingPicture; }
@@ -270,6 +276,15 @@ public:
     */
     void setContentsImage(SkBitmapRef* img);
 
+    /** Same as setContentsImage(), for an animated image whose frames are
+        all decoded: each frame gets its own ImageTexture and the compositor
+        picks the one to draw from the time elapsed since the call, so the
+        animation runs without WebKit repainting the layer.
+    */
+    void setContentsAnimatedImage(const Vector<SkBitmapRef*>& frames,
+                                  const Vector<float>& durations,
+                                  int repetitionCount);
+
     void bounds(SkRect*) const;
 
     virtual LayerAndroid* copy() const { return new LayerAndroid(*this); }
@@ -292,7 +307,7 @@ public:
 
     // ViewStateSerializer friends
     friend void android::serializeLayer(LayerAndroid* layer, SkWStream* stream);
-    friend LayerAndroid* android::deserializeLayer(SkStream* stream);
+    friend LayerAndroid* android::deserializeLayer(SkStream* stream, int version);
     friend void android::cleanupImageRefs(LayerAndroid* layer);
 
     PaintedSurface* texture() { return m_texture; }
@@ -318,6 +333,17 @@ public:
     void mergeInvalsInto(Layer* replacementTree);
     bool isReady();
 
+    // adds the document area known to be covered by opaque, ready layer
+    // content this frame, so the base tiles beneath can be skipped
+    void addOpaqueArea(SkRegion& area);
+    // true if drawGL() covers the layer bounds with opaque, ready content
+    virtual bool hasOpaqueContent();
+
+    // maps each uniqueId of a tree to its first layer in pre-order, as
+    // findById would, so matching two trees costs one traversal of each
+    typedef HashMap<int, LayerAndroid*> LayerIdMap;
+    void collectLayersById(LayerIdMap& layers);
+
 protected:
     virtual void onDraw(SkCanvas*, SkScalar opacity);
 
@@ -325,6 +351,8 @@ protected:
 
 private:
     class FindState;
+    void setIsPainting(const LayerIdMap& drawingLayers);
+    void mergeInvalsInto(const LayerIdMap& replacementLayers);
 #if DUMP_NAV_CACHE
     friend class CachedLayer::Debug; // debugging access only
 #endif
@@ -361,6 +389,8 @@ private:
     bool m_visible;
 
     SkColor m_backgroundColor;
+    // WebCore guarantees every pixel of the layer's bounds is painted opaque
+    bool m_contentsOpaque;
 
     bool m_preserves3D;
     float m_anchorPointZ;
@@ -395,6 +425,15 @@ private:
     PaintedSurface* m_texture;
     unsigned m_imageCRC;
 
+    // Frames of an animated image (the first one is also m_imageCRC), with
+    // the time at which each of them ends within one loop
+    unsigned currentImageCRC(bool& isAnimating);
+    void releaseImageFrames();
+    Vector<unsigned> m_imageFrameCRCs;
+    Vector<double> m_imageFrameEnds;
+    int m_imageRepetitionCount;
+    double m_imageAnimationStart;
+
     unsigned int m_pictureUsed;
 
     // used to signal the framework we need a repaint
@@ -162,6 +162,7 @@ void MediaTexture::draw(const TransformationMatrix& contentMatrix,
             continue;
 
         video->surfaceTexture->updateTexImage();
+        updateAccountedBytes(video);
 
         float surfaceMatrix[16];
         video->surfaceTexture->getTransformMatrix(surfaceMatrix);
@@ -183,6 +184,7 @@ void MediaTexture::draw(const TransformationMatrix& contentMatrix,
         return;
 
     m_contentTexture->surfaceTexture->updateTexImage();
+    updateAccountedBytes(m_contentTexture);
 
     sp<GraphicBuffer> buf = m_contentTexture->surfaceTexture->getCurrentBuffer();
 
@@ -302,6 +304,7 @@ MediaTexture::TextureWrapper* MediaTexture::createTexture()
     wrapper->surfaceTexture = new android::SurfaceTexture(wrapper->textureId);
     wrapper->nativeWindow = new android::SurfaceTextureClient(wrapper->surfaceTexture);
     wrapper->dimensions.setEmpty();
+    wrapper->accountedBytes = 0;
 
     // setup callback
     wrapper->mediaListener = new MediaListener(m_weakWebViewRef,
@@ -312,8 +315,29 @@ MediaTexture::TextureWrapper* MediaTexture::createTexture()
     return wrapper;
 }
 
+// Only the buffer currently attached to the texture is known here, the other
+// buffers of the surface texture are assumed to be of the same size.
+void MediaTexture::updateAccountedBytes(TextureWrapper* texture)
+{
+    sp<GraphicBuffer> buf = texture->surfaceTexture->getCurrentBuffer();
+    int bytes = 0;
+    if (buf.get())
+        bytes = buf->getStride() * buf->getHeight() * bytesPerPixel(buf->getPixelFormat());
+    if (bytes == texture->accountedBytes)
+        return;
+
+    TextureBudget* budget = TilesManager::instance()->textureBudget();
+    budget->freed(TextureBudget::MediaTextures, texture->accountedBytes);
+    budget->allocated(TextureBudget::MediaTextures, bytes);
+    texture->accountedBytes = bytes;
+}
+
 void MediaTexture::deleteTexture(TextureWrapper* texture, bool force)
 {
+    if (texture->accountedBytes)
+        TilesManager::instance()->textureBudget()->freed(TextureBudget::MediaTextures,
+                                                         texture->accountedBytes);
+
     if (texture->surfaceTexture.get())
         texture->surfaceTexture->setFrameAvailableListener(0);
 
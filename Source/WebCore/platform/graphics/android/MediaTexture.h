@@ -66,9 +66,11 @@ private:
         sp<ANativeWindow> nativeWindow;
         sp<MediaListener> mediaListener;
         SkRect dimensions; // only used by the video layer
+        int accountedBytes; // size of the current buffer, in TextureBudget
     };
 
     TextureWrapper* createTexture();
+    void updateAccountedBytes(TextureWrapper* texture);
     void deleteTexture(TextureWrapper* item, bool force = false);
 
     TextureWrapper* m_contentTexture;
@@ -0,0 +1,201 @@
+/*
+ * Copyright 2012, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "OperationQueue.h"
+
+#if USE(ACCELERATED_COMPOSITING)
+
+#include <wtf/CurrentTime.h>
+
+namespace WebCore {
+
+void OperationQueueStats::add(const OperationQueueStats& stats)
+{
+    depth += stats.depth;
+    maxDepth = std::max(maxDepth, stats.maxDepth);
+    processed += stats.processed;
+    totalLatency += stats.totalLatency;
+    maxLatency = std::max(maxLatency, stats.maxLatency);
+    reprioritizations += stats.reprioritizations;
+}
+
+OperationQueue::OperationQueue()
+    : m_sequence(0)
+{
+}
+
+OperationQueue::~OperationQueue()
+{
+    for (unsigned int i = 0; i < m_heap.size(); i++)
+        delete m_heap[i];
+}
+
+bool OperationQueue::lessThan(const QueuedOperation* a, const QueuedOperation* b) const
+{
+    // negative priorities are all equally urgent
+    int priorityA = std::max(a->m_queuedPriority, -1);
+    int priorityB = std::max(b->m_queuedPriority, -1);
+    if (priorityA != priorityB)
+        return priorityA < priorityB;
+    // sequence numbers may wrap around, compare their difference
+    return static_cast<int>(a->m_queuedSequence - b->m_queuedSequence) < 0;
+}
+
+void OperationQueue::setAt(int index, QueuedOperation* operation)
+{
+    m_heap[index] = operation;
+    operation->m_queueIndex = index;
+}
+
+void OperationQueue::siftUp(int index)
+{
+    QueuedOperation* operation = m_heap[index];
+    while (index > 0) {
+        int parent = (index - 1) / 2;
+        if (!lessThan(operation, m_heap[parent]))
+            break;
+        setAt(index, m_heap[parent]);
+        index = parent;
+    }
+    setAt(index, operation);
+}
+
+void OperationQueue::siftDown(int index)
+{
+    const int count = m_heap.size();
+    QueuedOperation* operation = m_heap[index];
+    while (true) {
+        int child = 2 * index + 1;
+        if (child >= count)
+            break;
+        if (child + 1 < count && lessThan(m_heap[child + 1], m_heap[child]))
+            child++;
+        if (!lessThan(m_heap[child], operation))
+            break;
+        setAt(index, m_heap[child]);
+        index = child;
+    }
+    setAt(index, operation);
+}
+
+QueuedOperation* OperationQueue::removeAt(int index)
+{
+    QueuedOperation* operation = m_heap[index];
+    QueuedOperation* last = m_heap.last();
+    m_heap.removeLast();
+    if (last != operation) {
+        setAt(index, last);
+        siftDown(index);
+        siftUp(last->m_queueIndex);
+    }
+    operation->m_queueIndex = -1;
+    return operation;
+}
+
+void OperationQueue::append(QueuedOperation* operation)
+{
+    operation->m_queuedPriority = operation->priority();
+    operation->m_queuedSequence = m_sequence++;
+    operation->m_queuedTime = WTF::currentTime();
+    m_heap.append(operation);
+    siftUp(m_heap.size() - 1);
+
+    m_stats.maxDepth = std::max(m_stats.maxDepth, static_cast<int>(m_heap.size()));
+}
+
+QueuedOperation* OperationQueue::popNext(bool paintOnly)
+{
+    if (m_heap.isEmpty())
+        return 0;
+
+    // Re-sample the priority of the top operation as it may have changed
+    // since it was queued; if it dropped, let the next one go first.
+    int priority = m_heap[0]->priority();
+    if (priority != m_heap[0]->m_queuedPriority) {
+        m_heap[0]->m_queuedPriority = priority;
+        siftDown(0);
+    }
+
+    if (paintOnly && !m_heap[0]->isPaint())
+        return 0;
+
+    QueuedOperation* operation = removeAt(0);
+
+    double latency = WTF::currentTime() - operation->m_queuedTime;
+    m_stats.processed++;
+    m_stats.totalLatency += latency;
+    m_stats.maxLatency = std::max(m_stats.maxLatency, latency);
+    return operation;
+}
+
+void OperationQueue::removeOperationsForFilter(OperationFilter* filter)
+{
+    // Compact the matching operations out, then restore the heap property
+    // in a single pass instead of sifting for every removal.
+    unsigned int kept = 0;
+    for (unsigned int i = 0; i < m_heap.size(); i++) {
+        QueuedOperation* operation = m_heap[i];
+        if (filter->check(operation))
+            delete operation;
+        else
+            setAt(kept++, operation);
+    }
+    if (kept == m_heap.size())
+        return;
+
+    m_heap.shrink(kept);
+    for (int i = kept / 2 - 1; i >= 0; i--)
+        siftDown(i);
+}
+
+void OperationQueue::reprioritize(QueuedOperation* operation)
+{
+    int index = operation->m_queueIndex;
+    if (index < 0 || index >= static_cast<int>(m_heap.size()) || m_heap[index] != operation)
+        return;
+    operation->m_queuedPriority = operation->priority();
+    siftDown(index);
+    siftUp(operation->m_queueIndex);
+}
+
+void OperationQueue::reprioritize()
+{
+    for (unsigned int i = 0; i < m_heap.size(); i++)
+        m_heap[i]->m_queuedPriority = m_heap[i]->priority();
+    for (int i = m_heap.size() / 2 - 1; i >= 0; i--)
+        siftDown(i);
+    m_stats.reprioritizations++;
+}
+
+const OperationQueueStats& OperationQueue::stats()
+{
+    m_stats.depth = m_heap.size();
+    return m_stats;
+}
+
+} // namespace WebCore
+
+#endif // USE(ACCELERATED_COMPOSITING)
@@ -0,0 +1,105 @@
+/*
+ * Copyright 2012, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef OperationQueue_h
+#define OperationQueue_h
+
+#if USE(ACCELERATED_COMPOSITING)
+
+#include "QueuedOperation.h"
+#include <wtf/Vector.h>
+
+namespace WebCore {
+
+struct OperationQueueStats {
+    OperationQueueStats()
+        : depth(0)
+        , maxDepth(0)
+        , processed(0)
+        , totalLatency(0)
+        , maxLatency(0)
+        , reprioritizations(0) {}
+
+    void add(const OperationQueueStats& stats);
+
+    // operations currently queued, and the most ever queued at once
+    int depth;
+    int maxDepth;
+    // operations popped from the queue, and the time (in seconds) they
+    // spent waiting in it
+    int processed;
+    double totalLatency;
+    double maxLatency;
+    // number of times the whole queue was reordered
+    int reprioritizations;
+};
+
+// Binary min-heap of QueuedOperations ordered by priority() (lower values are
+// processed first), then by insertion order. The priority of an operation is
+// sampled when it is inserted and whenever reprioritize() is called, so that
+// popping does not have to rescan the whole queue.
+// The heap is indexed (each operation knows its position), which makes
+// removing or reprioritizing a single operation O(log n).
+// Not thread-safe, the owner is expected to lock around it.
+class OperationQueue {
+public:
+    OperationQueue();
+    ~OperationQueue();
+
+    unsigned int size() const { return m_heap.size(); }
+    bool isEmpty() const { return m_heap.isEmpty(); }
+
+    void append(QueuedOperation* operation);
+
+    // Returns the most urgent operation, or 0 if the queue is empty. If
+    // paintOnly is set, only returns a PaintTile or PaintStrip operation (or 0).
+    QueuedOperation* popNext(bool paintOnly = false);
+
+    // Removes and deletes all the operations matching the filter
+    void removeOperationsForFilter(OperationFilter* filter);
+
+    // Re-samples the priority of a single operation
+    void reprioritize(QueuedOperation* operation);
+    // Re-samples every priority and rebuilds the heap in O(n)
+    void reprioritize();
+
+    const OperationQueueStats& stats();
+
+private:
+    bool lessThan(const QueuedOperation* a, const QueuedOperation* b) const;
+    void setAt(int index, QueuedOperation* operation);
+    void siftUp(int index);
+    void siftDown(int index);
+    QueuedOperation* removeAt(int index);
+
+    Vector<QueuedOperation*> m_heap;
+    unsigned int m_sequence;
+    OperationQueueStats m_stats;
+};
+
+} // namespace WebCore
+
+#endif // USE(ACCELERATED_COMPOSITING)
+#endif // OperationQueue_h
@@ -0,0 +1,104 @@
+/*
+ * Copyright 2012, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "PaintStripOperation.h"
+
+#if USE(ACCELERATED_COMPOSITING)
+
+#include "SkCanvas.h"
+#include "TilePainter.h"
+
+#include <cutils/atomic.h>
+
+namespace WebCore {
+
+TileStrips::TileStrips(const TileRenderInfo& renderInfo, const SkBitmap& bitmap, int count)
+    : m_renderInfo(renderInfo)
+    , m_invalRect(*renderInfo.invalRect)
+    , m_bitmap(bitmap)
+    , m_count(std::min(count, MAX_TILE_STRIPS))
+    , m_pictureCount(0)
+    , m_painted(0)
+{
+    // the inval rect given by the caller only lives for the duration of the
+    // paint, the queued strips may run after that
+    m_renderInfo.invalRect = &m_invalRect;
+    for (int i = 0; i < MAX_TILE_STRIPS; i++)
+        m_claimed[i] = 0;
+}
+
+bool TileStrips::claim(int index)
+{
+    return !android_atomic_cmpxchg(0, 1, &m_claimed[index]);
+}
+
+int TileStrips::paintAndWait()
+{
+    for (int i = 0; i < m_count; i++)
+        paintStrip(i);
+
+    android::Mutex::Autolock lock(m_paintedLock);
+    while (m_painted < m_count)
+        m_paintedCond.wait(m_paintedLock);
+    return m_pictureCount;
+}
+
+void TileStrips::paintStrip(int index)
+{
+    if (!claim(index))
+        return;
+
+    // the bitmap holds the inval rect at its origin, see setupCanvas()
+    const int height = m_invalRect.height();
+    const int top = height * index / m_count;
+    const int bottom = height * (index + 1) / m_count;
+
+    SkBitmap strip;
+    strip.setConfig(m_bitmap.config(), m_invalRect.width(), bottom - top,
+                    m_bitmap.rowBytes());
+    strip.setPixels(m_bitmap.getAddr(0, top));
+    strip.setIsOpaque(m_bitmap.isOpaque());
+
+    SkCanvas canvas(strip);
+    const SkSize& tileSize = m_renderInfo.tileSize;
+    canvas.translate(-m_invalRect.fLeft, -m_invalRect.fTop - top);
+    canvas.translate(-m_renderInfo.x * tileSize.width(), -m_renderInfo.y * tileSize.height());
+    canvas.scale(m_renderInfo.scale, m_renderInfo.scale);
+
+    unsigned int pictureCount = 0;
+    m_renderInfo.tilePainter->paint(m_renderInfo.baseTile, &canvas, &pictureCount);
+
+    android::Mutex::Autolock lock(m_paintedLock);
+    if (!index)
+        m_pictureCount = pictureCount;
+    m_painted++;
+    if (m_painted == m_count)
+        m_paintedCond.signal();
+}
+
+} // namespace WebCore
+
+#endif // USE(ACCELERATED_COMPOSITING)
@@ -0,0 +1,105 @@
+/*
+ * Copyright 2012, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef PaintStripOperation_h
+#define PaintStripOperation_h
+
+#if USE(ACCELERATED_COMPOSITING)
+
+#include "BaseRenderer.h"
+#include "QueuedOperation.h"
+#include "SkBitmap.h"
+#include <utils/threads.h>
+#include <wtf/PassRefPtr.h>
+#include <wtf/RefPtr.h>
+#include <wtf/ThreadSafeRefCounted.h>
+
+// Most strips a single tile is split into
+#define MAX_TILE_STRIPS 4
+
+namespace WebCore {
+
+// The content of one tile, split into horizontal strips of its bitmap that
+// several paint workers can rasterize at the same time. The worker painting
+// the tile queues a PaintStripOperation for every strip but the first, then
+// paints all the strips that no other worker started and waits for the
+// others: the tile never waits for a strip that's still sitting in a queue.
+class TileStrips : public ThreadSafeRefCounted<TileStrips> {
+public:
+    static PassRefPtr<TileStrips> create(const TileRenderInfo& renderInfo,
+                                         const SkBitmap& bitmap, int count)
+    {
+        return adoptRef(new TileStrips(renderInfo, bitmap, count));
+    }
+
+    int count() { return m_count; }
+
+    // runs on the worker painting the tile, returns the picture count
+    int paintAndWait();
+    // runs on any worker, does nothing if the strip was already claimed
+    void paintStrip(int index);
+
+private:
+    TileStrips(const TileRenderInfo& renderInfo, const SkBitmap& bitmap, int count);
+    bool claim(int index);
+
+    TileRenderInfo m_renderInfo;
+    SkIRect m_invalRect;
+    SkBitmap m_bitmap;
+    int m_count;
+    int m_pictureCount;
+
+    volatile int32_t m_claimed[MAX_TILE_STRIPS];
+    int m_painted;
+    android::Mutex m_paintedLock;
+    android::Condition m_paintedCond;
+};
+
+class PaintStripOperation : public QueuedOperation {
+public:
+    PaintStripOperation(TileStrips* strips, int index)
+        : QueuedOperation(QueuedOperation::PaintStrip, 0)
+        , m_strips(strips)
+        , m_index(index) {}
+    virtual bool operator==(const QueuedOperation* operation)
+    {
+        if (operation->type() != type())
+            return false;
+        const PaintStripOperation* op = static_cast<const PaintStripOperation*>(operation);
+        return op->m_strips == m_strips && op->m_index == m_index;
+    }
+    virtual void run() { m_strips->paintStrip(m_index); }
+    // a paint worker is blocked until the strip is painted
+    virtual int priority() { return 0; }
+
+private:
+    RefPtr<TileStrips> m_strips;
+    int m_index;
+};
+
+} // namespace WebCore
+
+#endif // USE(ACCELERATED_COMPOSITING)
+#endif // PaintStripOperation_h
@@ -29,6 +29,10 @@
 #include "ImagesManager.h"
 #include "LayerAndroid.h"
 #include "PaintedSurface.h"
+#include "TilesManager.h"
+
+// frame rate used to convert the time until a tile is drawn into a draw count
+#define FLING_FRAMERATE 60
 
 namespace WebCore {
 
@@ -36,10 +40,18 @@ PaintTileOperation::PaintTileOperation(BaseTile* tile, SurfacePainter* surface)
     : QueuedOperation(QueuedOperation::PaintTile, tile->page())
     , m_tile(tile)
     , m_surface(surface)
+    , m_ganeshText(false)
 {
     if (m_tile)
         m_tile->setRepaintPending(true);
     SkSafeRef(m_surface);
+
+    if (m_tile && m_tile->isLayerTile() && m_surface && m_surface->hasText()
+        && TilesManager::instance()->useGaneshForLayerText()
+        && BaseRenderer::getCurrentRendererType() == BaseRenderer::Raster) {
+        m_ganeshText = true;
+        setNeedsGLContext();
+    }
 }
 
 PaintTileOperation::~PaintTileOperation()
@@ -68,7 +80,7 @@ bool PaintTileOperation::operator==(const QueuedOperation* operation)
 void PaintTileOperation::run()
 {
     if (m_tile) {
-        m_tile->paintBitmap();
+        m_tile->paintBitmap(m_ganeshText);
         m_tile->setRepaintPending(false);
         m_tile = 0;
     }
@@ -90,9 +102,31 @@ int PaintTileOperation::priority()
             priority = 400000;
     }
 
+    // the low resolution page is only worth painting first if it is about to
+    // be shown under a zoomed or incomplete page
+    if (page && page->isLowResPage()) {
+        GLWebViewState* state = page->glWebViewState();
+        bool zooming = state->zoomManager()->scaleRequestState() != ZoomManager::kNoScaleRequest;
+        if (state->isScrolling() || zooming)
+            priority = 0;
+        else
+            priority = 400000;
+    }
+
     // prioritize higher draw count
     unsigned long long currentDraw = TilesManager::instance()->getDrawGLCount();
     unsigned long long drawDelta = currentDraw - m_tile->drawCount();
+
+    // tiles ahead of a fling are prioritized by when they will be drawn,
+    // counted in frames as for the draw count
+    if (page && !m_tile->isLayerTile() && drawDelta > 1) {
+        float timeToVisible = page->flingTimeToVisible(m_tile->x(), m_tile->y());
+        if (timeToVisible >= 0) {
+            unsigned long long framesToVisible = timeToVisible * FLING_FRAMERATE;
+            drawDelta = std::min(drawDelta, framesToVisible + 1);
+        }
+    }
+
     priority += 100000 * (int)std::min(drawDelta, (unsigned long long)1000);
 
     // prioritize unpainted tiles, within the same drawCount
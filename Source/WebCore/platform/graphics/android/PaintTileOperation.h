@@ -46,10 +46,13 @@ public:
     virtual int priority();
     TilePainter* painter() { return m_tile->painter(); }
     float scale() { return m_tile->scale(); }
+    BaseTile* tile() { return m_tile; }
 
 private:
     BaseTile* m_tile;
     SurfacePainter* m_surface;
+    // the tile is a layer tile with text, to be painted by Ganesh
+    bool m_ganeshText;
 };
 
 class ScaleFilter : public OperationFilter {
@@ -72,6 +75,28 @@ private:
 };
 
 
+// Matches the paints of the base tiles of a page outside of the given tile
+// bounds
+class TileBoundsFilter : public OperationFilter {
+public:
+    TileBoundsFilter(TiledPage* page, const SkIRect& bounds)
+        : m_page(page)
+        , m_bounds(bounds) {}
+    virtual bool check(QueuedOperation* operation)
+    {
+        if (operation->type() == QueuedOperation::PaintTile) {
+            BaseTile* tile = static_cast<PaintTileOperation*>(operation)->tile();
+            if (tile && tile->page() == m_page && !tile->isLayerTile()
+                && !m_bounds.contains(tile->x(), tile->y()))
+                return true;
+        }
+        return false;
+    }
+private:
+    TiledPage* m_page;
+    SkIRect m_bounds;
+};
+
 class TilePainterFilter : public OperationFilter {
 public:
     TilePainterFilter(TilePainter* painter) : m_painter(painter) {}
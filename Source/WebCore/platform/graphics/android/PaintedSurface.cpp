@@ -55,6 +55,14 @@
 // Layers with an area larger than 2048*2048 should never be unclipped
 #define MAX_UNCLIPPED_AREA 4194304
 
+// Bounds of the layer transform scale folded into the raster scale
+#define MIN_LAYER_SCALE 0.25
+#define MAX_LAYER_SCALE 2
+
+// The tiles are kept as long as the layer transform scale stays within
+// this factor of the scale they were rasterized at
+#define LAYER_SCALE_DRIFT 1.25
+
 namespace WebCore {
 
 PaintedSurface::PaintedSurface()
@@ -62,6 +70,7 @@ PaintedSurface::PaintedSurface()
     , m_paintingLayer(0)
     , m_tiledTexture(0)
     , m_scale(0)
+    , m_layerScale(0)
     , m_pictureUsed(0)
 {
     TilesManager::instance()->addPaintedSurface(this);
@@ -101,7 +110,7 @@ void PaintedSurface::prepare(GLWebViewState* state)
 
     IntRect visibleArea = computeVisibleArea(paintingLayer);
 
-    m_scale = state->scale();
+    m_scale = state->scale() * computeLayerScale(paintingLayer);
 
     // If we do not have text, we may as well limit ourselves to
     // a scale factor of one... this saves up textures.
@@ -214,6 +223,40 @@ IntRect PaintedSurface::computeVisibleArea(LayerAndroid* layer) {
     return area;
 }
 
+float PaintedSurface::computeLayerScale(LayerAndroid* layer)
+{
+    const TransformationMatrix* transform = layer->drawTransform();
+    float scaleX = sqrtf(transform->m11() * transform->m11()
+                         + transform->m12() * transform->m12());
+    float scaleY = sqrtf(transform->m21() * transform->m21()
+                         + transform->m22() * transform->m22());
+    float layerScale = std::max(scaleX, scaleY);
+    layerScale = std::min(std::max(layerScale, (float) MIN_LAYER_SCALE),
+                          (float) MAX_LAYER_SCALE);
+
+    // Transform changes are applied when compositing, so the tiles we have
+    // remain valid: only rasterize again once the scale drifted far enough
+    // from the one they were painted at, and never while the layer is
+    // animating, to not repaint on every frame of a scale animation.
+    if (!m_layerScale) {
+        m_layerScale = layerScale;
+    } else if (!layer->hasRunningAnimations()
+               && (layerScale > m_layerScale * LAYER_SCALE_DRIFT
+                   || layerScale * LAYER_SCALE_DRIFT < m_layerScale)) {
+        XLOG("PS %p layer scale drifted from %.2f to %.2f, rasterizing again",
+             this, m_layerScale, layerScale);
+        m_layerScale = layerScale;
+    }
+
+    return m_layerScale;
+}
+
+bool PaintedSurface::hasText()
+{
+    LayerAndroid* layer = m_paintingLayer ? m_paintingLayer : m_drawingLayer;
+    return layer && layer->hasText();
+}
+
 bool PaintedSurface::owns(BaseTileTexture* texture)
 {
     if (m_tiledTexture)
@@ -68,10 +68,12 @@ public:
 
     void computeTexturesAmount(TexturesResult*);
     IntRect computeVisibleArea(LayerAndroid*);
+    float computeLayerScale(LayerAndroid*);
 
     // TilePainter methods for TiledTexture
     virtual const TransformationMatrix* transform();
     virtual float opacity();
+    virtual bool hasText();
 
     // used by TiledTexture
     float scale() { return m_scale; }
@@ -83,6 +85,8 @@ private:
     DualTiledTexture* m_tiledTexture;
 
     float m_scale;
+    // scale of the layer's own transform the tiles were rasterized at
+    float m_layerScale;
 
     unsigned int m_pictureUsed;
 
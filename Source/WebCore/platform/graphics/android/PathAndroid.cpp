@@ -303,6 +303,23 @@ FloatRect Path::strokeBoundingRect(StrokeStyleApplier* applier) const
     return r;
 }
 
+Path Path::strokeOutline(StrokeStyleApplier* applier) const
+{
+    GraphicsContext* scratch = scratchContext();
+    scratch->save();
+
+    if (applier)
+        applier->strokeStyle(scratch);
+
+    SkPaint paint;
+    scratch->setupStrokePaint(&paint);
+    Path outline;
+    paint.getFillPath(*platformPath(), outline.platformPath());
+
+    scratch->restore();
+    return outline;
+}
+
 #if ENABLE(SVG)
 bool Path::strokeContains(StrokeStyleApplier* applier, const FloatPoint& point) const
 {
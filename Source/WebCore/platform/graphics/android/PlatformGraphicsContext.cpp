@@ -38,6 +38,7 @@ PlatformGraphicsContext::PlatformGraphicsContext(SkCanvas* canvas)
         : mCanvas(canvas), m_deleteCanvas(false)
         , m_canvasState(DEFAULT)
         , m_picture(0)
+        , m_presentedPicture(0)
 {
 }
 
@@ -46,6 +47,7 @@ PlatformGraphicsContext::PlatformGraphicsContext()
 //    , m_buttons(0)
     , m_canvasState(DEFAULT)
     , m_picture(0)
+    , m_presentedPicture(0)
 {
 }
 
@@ -53,12 +55,15 @@ PlatformGraphicsContext::PlatformGraphicsContext(int width, int height)
     : m_deleteCanvas(false)
     , m_canvasState(RECORDING)
     , m_picture(new SkPicture)
+    , m_presentedPicture(0)
 {
     mCanvas = m_picture->beginRecording(width, height, 0);
 }
 
 PlatformGraphicsContext::~PlatformGraphicsContext()
 {
+    delete m_presentedPicture;
+
     if (m_picture) {
         delete m_picture; // The SkPicture will free mCanvas in its destructor.
         m_picture = 0;
@@ -79,7 +84,11 @@ void PlatformGraphicsContext::clearRecording()
     int width = m_picture->width();
     int height = m_picture->height();
 
-    delete m_picture;
+    // The cleared commands are already on screen, so keep them around in case
+    // the pixels have to be read back before the next frame is presented.
+    m_picture->endRecording();
+    delete m_presentedPicture;
+    m_presentedPicture = m_picture;
     m_picture = new SkPicture;
 
     mCanvas = m_picture->beginRecording(width, height, 0);
@@ -99,11 +108,15 @@ void PlatformGraphicsContext::convertToNonRecording()
     SkCanvas* canvas = new SkCanvas;
     canvas->setBitmapDevice(bitmap);
 
+    if (m_presentedPicture)
+        m_presentedPicture->draw(canvas);
     m_picture->draw(canvas);
 
     mCanvas = canvas;
     m_deleteCanvas = true;
 
+    delete m_presentedPicture;
+    m_presentedPicture = 0;
     delete m_picture;
     m_picture = 0;
 
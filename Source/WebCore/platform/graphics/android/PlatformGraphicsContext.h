@@ -83,6 +83,8 @@ private:
     enum CanvasState m_canvasState;
 
     SkPicture* m_picture;
+    // The recording most recently handed to the screen by clearRecording().
+    SkPicture* m_presentedPicture;
 
 };
 
@@ -32,19 +32,44 @@ class TiledPage;
 
 class QueuedOperation {
 public:
-    enum OperationType { Undefined, PaintTile, PaintLayer, DeleteTexture };
+    enum OperationType { Undefined, PaintTile, PaintLayer, DeleteTexture, PaintStrip };
     QueuedOperation(OperationType type, TiledPage* page)
         : m_type(type)
-        , m_page(page) {}
+        , m_page(page)
+        , m_needsGLContext(false)
+        , m_queueIndex(-1)
+        , m_queuedPriority(0)
+        , m_queuedSequence(0)
+        , m_queuedTime(0) {}
     virtual ~QueuedOperation() {}
     virtual void run() = 0;
     virtual bool operator==(const QueuedOperation* operation) = 0;
     virtual int priority() { return -1; }
     OperationType type() const { return m_type; }
+    // paints on the CPU, so can run on any of the workers
+    bool isPaint() const
+    {
+        return (m_type == PaintTile || m_type == PaintStrip) && !m_needsGLContext;
+    }
     TiledPage* page() const { return m_page; }
+protected:
+    // set by paints that draw with Ganesh, whose GL context lives on the
+    // first worker
+    void setNeedsGLContext() { m_needsGLContext = true; }
 private:
+    friend class OperationQueue;
+
     OperationType m_type;
     TiledPage* m_page;
+    bool m_needsGLContext;
+
+    // Bookkeeping of the OperationQueue holding this operation: position in
+    // the heap, priority snapshot used for ordering, insertion order (to
+    // break priority ties) and insertion time (for latency stats)
+    int m_queueIndex;
+    int m_queuedPriority;
+    unsigned int m_queuedSequence;
+    double m_queuedTime;
 };
 
 class OperationFilter {
@@ -65,20 +65,15 @@ static const String TAGS[] = {
     TAG_UPDATE_TEXTURE,
 };
 
-SkBitmap* RasterRenderer::g_bitmap = 0;
+WTF::ThreadSpecific<SkBitmap>* RasterRenderer::g_bitmap = 0;
 
 RasterRenderer::RasterRenderer() : BaseRenderer(BaseRenderer::Raster)
 {
 #ifdef DEBUG_COUNT
     ClassTracker::instance()->increment("RasterRenderer");
 #endif
-    if (!g_bitmap) {
-        g_bitmap = new SkBitmap();
-        g_bitmap->setConfig(SkBitmap::kARGB_8888_Config,
-                           TilesManager::instance()->tileWidth(),
-                           TilesManager::instance()->tileHeight());
-        g_bitmap->allocPixels();
-    }
+    if (!g_bitmap)
+        g_bitmap = new WTF::ThreadSpecific<SkBitmap>();
 }
 
 RasterRenderer::~RasterRenderer()
@@ -93,15 +88,43 @@ void RasterRenderer::setupCanvas(const TileRenderInfo& renderInfo, SkCanvas* can
     if (renderInfo.measurePerf)
         m_perfMon.start(TAG_CREATE_BITMAP);
 
+    SkBitmap* bitmap = *g_bitmap;
+    if (bitmap->isNull()) {
+        bitmap->setConfig(SkBitmap::kARGB_8888_Config,
+                          TilesManager::instance()->tileWidth(),
+                          TilesManager::instance()->tileHeight());
+        bitmap->allocPixels();
+    }
+
+    TransferQueue* tileQueue = TilesManager::instance()->transferQueue();
+    // a partial update only uploads the inval rect into the front texture,
+    // which can't be painted into directly as it may be drawn meanwhile
+    if (tileQueue->textureUploadType() == DirectUpload && renderInfo.tileTexture
+        && !renderInfo.partialUpdate) {
+        m_directBuffer = renderInfo.tileTexture->acquireDirectBuffer();
+        void* pixels = 0;
+        if (m_directBuffer.get()
+            && m_directBuffer->lock(android::GraphicBuffer::USAGE_SW_WRITE_OFTEN, &pixels) == android::NO_ERROR) {
+            m_directBitmap.setConfig(SkBitmap::kARGB_8888_Config,
+                                     m_directBuffer->getWidth(), m_directBuffer->getHeight(),
+                                     m_directBuffer->getStride() * 4);
+            m_directBitmap.setPixels(pixels);
+            bitmap = &m_directBitmap;
+        } else {
+            XLOG("Could not lock direct buffer, painting through the transfer queue");
+            m_directBuffer.clear();
+        }
+    }
+
     if (renderInfo.baseTile->isLayerTile()) {
-        g_bitmap->setIsOpaque(false);
-        g_bitmap->eraseARGB(0, 0, 0, 0);
+        bitmap->setIsOpaque(false);
+        bitmap->eraseARGB(0, 0, 0, 0);
     } else {
-        g_bitmap->setIsOpaque(true);
-        g_bitmap->eraseARGB(255, 255, 255, 255);
+        bitmap->setIsOpaque(true);
+        bitmap->eraseARGB(255, 255, 255, 255);
     }
 
-    SkDevice* device = new SkDevice(*g_bitmap);
+    SkDevice* device = new SkDevice(*bitmap);
 
     if (renderInfo.measurePerf) {
         m_perfMon.stop(TAG_CREATE_BITMAP);
@@ -123,9 +146,16 @@ void RasterRenderer::renderingComplete(const TileRenderInfo& renderInfo, SkCanva
         m_perfMon.start(TAG_UPDATE_TEXTURE);
     }
 
-    const SkBitmap& bitmap = canvas->getDevice()->accessBitmap(false);
-
-    GLUtils::paintTextureWithBitmap(&renderInfo, bitmap);
+    if (m_directBuffer.get()) {
+        // the content is already where the GPU will read it from
+        m_directBuffer->unlock();
+        m_directBuffer.clear();
+        m_directBitmap.setPixels(0);
+        TilesManager::instance()->transferQueue()->updateQueueWithDirectBuffer(&renderInfo);
+    } else {
+        const SkBitmap& bitmap = canvas->getDevice()->accessBitmap(false);
+        GLUtils::paintTextureWithBitmap(&renderInfo, bitmap);
+    }
 
     if (renderInfo.measurePerf)
         m_perfMon.stop(TAG_UPDATE_TEXTURE);
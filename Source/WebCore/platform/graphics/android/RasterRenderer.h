@@ -31,6 +31,8 @@
 #include "BaseRenderer.h"
 #include "SkBitmap.h"
 #include "SkRect.h"
+#include <ui/GraphicBuffer.h>
+#include <wtf/ThreadSpecific.h>
 
 class SkCanvas;
 class SkDevice;
@@ -52,7 +54,13 @@ protected:
     virtual const String* getPerformanceTags(int& tagCount);
 
 private:
-    static SkBitmap* g_bitmap;
+    // In DirectUpload mode, the buffer of the tile texture we are painting
+    // into, and the bitmap wrapping its pixels
+    sp<android::GraphicBuffer> m_directBuffer;
+    SkBitmap m_directBitmap;
+
+    // Each paint worker thread renders into its own bitmap
+    static WTF::ThreadSpecific<SkBitmap>* g_bitmap;
 
 };
 
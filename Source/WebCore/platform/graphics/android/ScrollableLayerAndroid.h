@@ -68,7 +68,7 @@ public:
     bool scrollRectIntoView(const SkIRect&);
 
     friend void android::serializeLayer(LayerAndroid* layer, SkWStream* stream);
-    friend LayerAndroid* android::deserializeLayer(SkStream* stream);
+    friend LayerAndroid* android::deserializeLayer(SkStream* stream, int version);
 
 private:
     // The position of the visible area of the layer, relative to the parent
@@ -41,15 +41,31 @@
 #undef XLOG
 #define XLOG(...) android_printLog(ANDROID_LOG_DEBUG, "ShaderProgram", __VA_ARGS__)
 
+// Maximum number of quads submitted at once by a batch
+#define BATCH_MAX_QUADS 256
+// position in clip space (x, y, z, w), then texture coordinates (u, v)
+#define BATCH_VERTEX_FLOATS 6
+
 namespace WebCore {
 
 static const char gVertexShader[] =
     "attribute vec4 vPosition;\n"
     "uniform mat4 projectionMatrix;\n"
+    "uniform vec4 texCoordRect;\n"
     "varying vec2 v_texCoord;\n"
     "void main() {\n"
     "  gl_Position = projectionMatrix * vPosition;\n"
-    "  v_texCoord = vec2(vPosition);\n"
+    "  v_texCoord = texCoordRect.xy + vec2(vPosition) * texCoordRect.zw;\n"
+    "}\n";
+
+// The batched quads are transformed on the CPU
+static const char gBatchVertexShader[] =
+    "attribute vec4 vPosition;\n"
+    "attribute vec2 vTexCoord;\n"
+    "varying vec2 v_texCoord;\n"
+    "void main() {\n"
+    "  gl_Position = vPosition;\n"
+    "  v_texCoord = vTexCoord;\n"
     "}\n";
 
 static const char gFragmentShader[] =
@@ -206,6 +222,12 @@ GLuint ShaderProgram::createProgram(const char* pVertexSource, const char* pFrag
 
 ShaderProgram::ShaderProgram()
     : m_blendingEnabled(false)
+    , m_batching(false)
+    , m_batchQuadCount(0)
+    , m_batchOpacity(1)
+    , m_batchBlending(false)
+    , m_batchProgram(-1)
+    , m_batchProgramInverted(-1)
     , m_contrast(1)
     , m_alphaLayer(false)
     , m_currentScale(1.0f)
@@ -222,6 +244,8 @@ void ShaderProgram::init()
         createProgram(gVertexShader, gSurfaceTextureOESFragmentShader);
     m_surfTexOESProgramInverted =
         createProgram(gVertexShader, gSurfaceTextureOESFragmentShaderInverted);
+    m_batchProgram = createProgram(gBatchVertexShader, gFragmentShader);
+    m_batchProgramInverted = createProgram(gBatchVertexShader, gFragmentShaderInverted);
 
     if (m_program == -1
         || m_programInverted == -1
@@ -234,12 +258,14 @@ void ShaderProgram::init()
     m_hAlpha = glGetUniformLocation(m_program, "alpha");
     m_hTexSampler = glGetUniformLocation(m_program, "s_texture");
     m_hPosition = glGetAttribLocation(m_program, "vPosition");
+    m_hTexCoordRect = glGetUniformLocation(m_program, "texCoordRect");
 
     m_hProjectionMatrixInverted = glGetUniformLocation(m_programInverted, "projectionMatrix");
     m_hAlphaInverted = glGetUniformLocation(m_programInverted, "alpha");
     m_hContrastInverted = glGetUniformLocation(m_surfTexOESProgramInverted, "contrast");
     m_hTexSamplerInverted = glGetUniformLocation(m_programInverted, "s_texture");
     m_hPositionInverted = glGetAttribLocation(m_programInverted, "vPosition");
+    m_hTexCoordRectInverted = glGetUniformLocation(m_programInverted, "texCoordRect");
 
     m_hVideoProjectionMatrix =
         glGetUniformLocation(m_videoProgram, "projectionMatrix");
@@ -252,6 +278,7 @@ void ShaderProgram::init()
     m_hSTOESAlpha = glGetUniformLocation(m_surfTexOESProgram, "alpha");
     m_hSTOESTexSampler = glGetUniformLocation(m_surfTexOESProgram, "s_texture");
     m_hSTOESPosition = glGetAttribLocation(m_surfTexOESProgram, "vPosition");
+    m_hSTOESTexCoordRect = glGetUniformLocation(m_surfTexOESProgram, "texCoordRect");
 
     m_hSTOESProjectionMatrixInverted =
         glGetUniformLocation(m_surfTexOESProgramInverted, "projectionMatrix");
@@ -259,6 +286,8 @@ void ShaderProgram::init()
     m_hSTOESContrastInverted = glGetUniformLocation(m_surfTexOESProgramInverted, "contrast");
     m_hSTOESTexSamplerInverted = glGetUniformLocation(m_surfTexOESProgramInverted, "s_texture");
     m_hSTOESPositionInverted = glGetAttribLocation(m_surfTexOESProgramInverted, "vPosition");
+    m_hSTOESTexCoordRectInverted =
+        glGetUniformLocation(m_surfTexOESProgramInverted, "texCoordRect");
 
 
     const GLfloat coord[] = {
@@ -272,11 +301,46 @@ void ShaderProgram::init()
     glBindBuffer(GL_ARRAY_BUFFER, m_textureBuffer[0]);
     glBufferData(GL_ARRAY_BUFFER, 2 * 4 * sizeof(GLfloat), coord, GL_STATIC_DRAW);
 
+    // batching is only done if its programs are available
+    if (m_batchProgram != -1 && m_batchProgramInverted != -1) {
+        m_hBatchAlpha = glGetUniformLocation(m_batchProgram, "alpha");
+        m_hBatchTexSampler = glGetUniformLocation(m_batchProgram, "s_texture");
+        m_hBatchPosition = glGetAttribLocation(m_batchProgram, "vPosition");
+        m_hBatchTexCoord = glGetAttribLocation(m_batchProgram, "vTexCoord");
+
+        m_hBatchAlphaInverted = glGetUniformLocation(m_batchProgramInverted, "alpha");
+        m_hBatchContrastInverted = glGetUniformLocation(m_batchProgramInverted, "contrast");
+        m_hBatchTexSamplerInverted = glGetUniformLocation(m_batchProgramInverted, "s_texture");
+        m_hBatchPositionInverted = glGetAttribLocation(m_batchProgramInverted, "vPosition");
+        m_hBatchTexCoordInverted = glGetAttribLocation(m_batchProgramInverted, "vTexCoord");
+
+        // two triangles per quad, with the vertices in the order of coord
+        GLushort indices[BATCH_MAX_QUADS * 6];
+        for (int i = 0; i < BATCH_MAX_QUADS; i++) {
+            GLushort first = i * 4;
+            indices[i * 6] = first;
+            indices[i * 6 + 1] = first + 1;
+            indices[i * 6 + 2] = first + 2;
+            indices[i * 6 + 3] = first + 2;
+            indices[i * 6 + 4] = first + 1;
+            indices[i * 6 + 5] = first + 3;
+        }
+        glGenBuffers(2, m_batchBuffers);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_batchBuffers[1]);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+        m_batchVertices.reserveCapacity(BATCH_MAX_QUADS * 4 * BATCH_VERTEX_FLOATS);
+    } else {
+        m_batchProgram = -1;
+        m_batchProgramInverted = -1;
+    }
+
     GLUtils::checkGlError("init");
 }
 
 void ShaderProgram::resetBlending()
 {
+    submitBatch();
     glDisable(GL_BLEND);
     glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
     glBlendEquation(GL_FUNC_ADD);
@@ -296,6 +360,29 @@ void ShaderProgram::setBlendingState(bool enableBlending)
     m_blendingEnabled = enableBlending;
 }
 
+// All the programs sharing gVertexShader sample the texture in texCoordRect,
+// the whole texture unless specified
+void ShaderProgram::setTexCoordRect(GLint program, const SkRect* texCoordRect)
+{
+    GLint handle = -1;
+    if (program == m_program)
+        handle = m_hTexCoordRect;
+    else if (program == m_programInverted)
+        handle = m_hTexCoordRectInverted;
+    else if (program == m_surfTexOESProgram)
+        handle = m_hSTOESTexCoordRect;
+    else if (program == m_surfTexOESProgramInverted)
+        handle = m_hSTOESTexCoordRectInverted;
+    if (handle == -1)
+        return;
+
+    if (texCoordRect)
+        glUniform4f(handle, texCoordRect->fLeft, texCoordRect->fTop,
+                    texCoordRect->width(), texCoordRect->height());
+    else
+        glUniform4f(handle, 0, 0, 1, 1);
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////
 // Drawing
 /////////////////////////////////////////////////////////////////////////////////////////
@@ -310,7 +397,7 @@ void ShaderProgram::setViewport(SkRect& viewport, float scale)
     m_currentScale = scale;
 }
 
-void ShaderProgram::setProjectionMatrix(SkRect& geometry, GLint projectionMatrixHandle)
+TransformationMatrix ShaderProgram::quadMatrix(SkRect& geometry)
 {
     TransformationMatrix translate;
     translate.translate3d(geometry.fLeft, geometry.fTop, 0.0);
@@ -323,6 +410,12 @@ void ShaderProgram::setProjectionMatrix(SkRect& geometry, GLint projectionMatrix
                 * translate * scale;
     else
         total = m_projectionMatrix * translate * scale;
+    return total;
+}
+
+void ShaderProgram::setProjectionMatrix(SkRect& geometry, GLint projectionMatrixHandle)
+{
+    TransformationMatrix total = quadMatrix(geometry);
 
     GLfloat projectionMatrix[16];
     GLUtils::toGLMatrix(projectionMatrix, total);
@@ -342,6 +435,7 @@ void ShaderProgram::drawQuadInternal(SkRect& geometry,
                                      GLint contrast)
 {
     glUseProgram(program);
+    setTexCoordRect(program, 0);
 
     if (!geometry.isEmpty())
          setProjectionMatrix(geometry, projectionMatrixHandle);
@@ -377,6 +471,13 @@ void ShaderProgram::drawQuadInternal(SkRect& geometry,
 void ShaderProgram::drawQuad(SkRect& geometry, int textureId, float opacity,
                              GLenum textureTarget, GLint texFilter)
 {
+    // an empty geometry is used for full viewport blits, not worth batching
+    if (m_batching && textureTarget == GL_TEXTURE_2D && !geometry.isEmpty()) {
+        batchQuad(quadMatrix(geometry), 0, textureId, texFilter, opacity, opacity < 1.0);
+        return;
+    }
+    submitBatch();
+
     if (textureTarget == GL_TEXTURE_2D) {
         if (!TilesManager::instance()->invertedScreen()) {
             drawQuadInternal(geometry, textureId, opacity, m_program,
@@ -495,6 +596,9 @@ void ShaderProgram::clip(const FloatRect& clip)
     if (clip == m_clipRect)
         return;
 
+    // the batched quads were meant for the previous clip
+    submitBatch();
+
     // we should only call glScissor in this function, so that we can easily
     // track the current clipping rect.
 
@@ -547,10 +651,12 @@ void ShaderProgram::drawLayerQuadInternal(const GLfloat* projectionMatrix,
                                           GLenum textureTarget, GLint program,
                                           GLint matrix, GLint texSample,
                                           GLint position, GLint alpha,
+                                          const SkRect* texCoordRect,
                                           GLint contrast)
 {
     glUseProgram(program);
     glUniformMatrix4fv(matrix, 1, GL_FALSE, projectionMatrix);
+    setTexCoordRect(program, texCoordRect);
 
     glActiveTexture(GL_TEXTURE0);
     glUniform1i(texSample, 0);
@@ -573,7 +679,8 @@ void ShaderProgram::drawLayerQuadInternal(const GLfloat* projectionMatrix,
 void ShaderProgram::drawLayerQuad(const TransformationMatrix& drawMatrix,
                                   const SkRect& geometry, int textureId,
                                   float opacity, bool forceBlending,
-                                  GLenum textureTarget)
+                                  GLenum textureTarget,
+                                  const SkRect* texCoordRect)
 {
 
     TransformationMatrix modifiedDrawMatrix = drawMatrix;
@@ -588,6 +695,13 @@ void ShaderProgram::drawLayerQuad(const TransformationMatrix& drawMatrix,
     else
         renderMatrix = m_projectionMatrix * modifiedDrawMatrix;
 
+    if (m_batching && textureTarget == GL_TEXTURE_2D) {
+        batchQuad(renderMatrix, texCoordRect, textureId, GL_LINEAR, opacity,
+                  forceBlending || opacity < 1.0);
+        return;
+    }
+    submitBatch();
+
     GLfloat projectionMatrix[16];
     GLUtils::toGLMatrix(projectionMatrix, renderMatrix);
     if (textureTarget == GL_TEXTURE_2D) {
@@ -595,27 +709,27 @@ void ShaderProgram::drawLayerQuad(const TransformationMatrix& drawMatrix,
             drawLayerQuadInternal(projectionMatrix, textureId, opacity,
                                   GL_TEXTURE_2D, m_program,
                                   m_hProjectionMatrix, m_hTexSampler,
-                                  m_hPosition, m_hAlpha);
+                                  m_hPosition, m_hAlpha, texCoordRect);
         } else {
             drawLayerQuadInternal(projectionMatrix, textureId, opacity,
                                   GL_TEXTURE_2D, m_programInverted,
                                   m_hProjectionMatrixInverted, m_hTexSamplerInverted,
                                   m_hPositionInverted, m_hAlphaInverted,
-                                  m_hContrastInverted);
+                                  texCoordRect, m_hContrastInverted);
         }
     } else if (textureTarget == GL_TEXTURE_EXTERNAL_OES
                && !TilesManager::instance()->invertedScreen()) {
         drawLayerQuadInternal(projectionMatrix, textureId, opacity,
                               GL_TEXTURE_EXTERNAL_OES, m_surfTexOESProgram,
                               m_hSTOESProjectionMatrix, m_hSTOESTexSampler,
-                              m_hSTOESPosition, m_hSTOESAlpha);
+                              m_hSTOESPosition, m_hSTOESAlpha, texCoordRect);
     } else if (textureTarget == GL_TEXTURE_EXTERNAL_OES
                && TilesManager::instance()->invertedScreen()) {
         drawLayerQuadInternal(projectionMatrix, textureId, opacity,
                               GL_TEXTURE_EXTERNAL_OES, m_surfTexOESProgramInverted,
                               m_hSTOESProjectionMatrixInverted, m_hSTOESTexSamplerInverted,
                               m_hSTOESPositionInverted, m_hSTOESAlphaInverted,
-                              m_hSTOESContrastInverted);
+                              texCoordRect, m_hSTOESContrastInverted);
     }
 
     setBlendingState(forceBlending || opacity < 1.0);
@@ -628,6 +742,8 @@ void ShaderProgram::drawVideoLayerQuad(const TransformationMatrix& drawMatrix,
                                        float* textureMatrix, SkRect& geometry,
                                        int textureId)
 {
+    submitBatch();
+
     // switch to our custom yuv video rendering program
     glUseProgram(m_videoProgram);
 
@@ -653,6 +769,104 @@ void ShaderProgram::drawVideoLayerQuad(const TransformationMatrix& drawMatrix,
     glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 }
 
+void ShaderProgram::beginBatch()
+{
+    m_batching = m_batchProgram != -1;
+}
+
+void ShaderProgram::endBatch()
+{
+    submitBatch();
+    m_batching = false;
+}
+
+void ShaderProgram::batchQuad(const TransformationMatrix& renderMatrix,
+                              const SkRect* texCoordRect, int textureId,
+                              GLint texFilter, float opacity, bool blending)
+{
+    if (m_batchQuadCount == BATCH_MAX_QUADS
+        || (m_batchQuadCount && (opacity != m_batchOpacity || blending != m_batchBlending)))
+        submitBatch();
+    m_batchOpacity = opacity;
+    m_batchBlending = blending;
+
+    // same corners as m_textureBuffer, transformed like the vertex shader does
+    static const GLfloat corners[4][2] = { { 0, 0 }, { 1, 0 }, { 0, 1 }, { 1, 1 } };
+    const TransformationMatrix& m = renderMatrix;
+    for (int i = 0; i < 4; i++) {
+        GLfloat x = corners[i][0];
+        GLfloat y = corners[i][1];
+        m_batchVertices.append(m.m11() * x + m.m21() * y + m.m41());
+        m_batchVertices.append(m.m12() * x + m.m22() * y + m.m42());
+        m_batchVertices.append(m.m13() * x + m.m23() * y + m.m43());
+        m_batchVertices.append(m.m14() * x + m.m24() * y + m.m44());
+        if (texCoordRect) {
+            m_batchVertices.append(texCoordRect->fLeft + x * texCoordRect->width());
+            m_batchVertices.append(texCoordRect->fTop + y * texCoordRect->height());
+        } else {
+            m_batchVertices.append(x);
+            m_batchVertices.append(y);
+        }
+    }
+
+    if (m_batchTextures.isEmpty() || m_batchTextures.last().textureId != textureId
+        || m_batchTextures.last().texFilter != texFilter)
+        m_batchTextures.append(BatchedTexture(textureId, texFilter));
+    m_batchTextures.last().quadCount++;
+    m_batchQuadCount++;
+}
+
+void ShaderProgram::submitBatch()
+{
+    if (!m_batchQuadCount)
+        return;
+
+    bool inverted = TilesManager::instance()->invertedScreen();
+    GLint position = inverted ? m_hBatchPositionInverted : m_hBatchPosition;
+    GLint texCoord = inverted ? m_hBatchTexCoordInverted : m_hBatchTexCoord;
+
+    glUseProgram(inverted ? m_batchProgramInverted : m_batchProgram);
+    glActiveTexture(GL_TEXTURE0);
+    glUniform1i(inverted ? m_hBatchTexSamplerInverted : m_hBatchTexSampler, 0);
+    glUniform1f(inverted ? m_hBatchAlphaInverted : m_hBatchAlpha, m_batchOpacity);
+    if (inverted)
+        glUniform1f(m_hBatchContrastInverted, m_contrast);
+
+    GLsizei stride = BATCH_VERTEX_FLOATS * sizeof(GLfloat);
+    glBindBuffer(GL_ARRAY_BUFFER, m_batchBuffers[0]);
+    glBufferData(GL_ARRAY_BUFFER, m_batchVertices.size() * sizeof(GLfloat),
+                 m_batchVertices.data(), GL_STREAM_DRAW);
+    glEnableVertexAttribArray(position);
+    glVertexAttribPointer(position, 4, GL_FLOAT, GL_FALSE, stride, 0);
+    glEnableVertexAttribArray(texCoord);
+    glVertexAttribPointer(texCoord, 2, GL_FLOAT, GL_FALSE, stride,
+                          reinterpret_cast<GLvoid*>(4 * sizeof(GLfloat)));
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_batchBuffers[1]);
+    setBlendingState(m_batchBlending);
+
+    int firstQuad = 0;
+    for (unsigned int i = 0; i < m_batchTextures.size(); i++) {
+        const BatchedTexture& run = m_batchTextures[i];
+        glBindTexture(GL_TEXTURE_2D, run.textureId);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, run.texFilter);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, run.texFilter);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glDrawElements(GL_TRIANGLES, run.quadCount * 6, GL_UNSIGNED_SHORT,
+                       reinterpret_cast<GLvoid*>(firstQuad * 6 * sizeof(GLushort)));
+        firstQuad += run.quadCount;
+    }
+
+    // the other programs don't source the texture coordinates from an array
+    glDisableVertexAttribArray(texCoord);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    m_batchVertices.shrink(0);
+    m_batchTextures.shrink(0);
+    m_batchQuadCount = 0;
+    GLUtils::checkGlError("submitBatch");
+}
+
 void ShaderProgram::setWebViewMatrix(const float* matrix, bool alphaLayer)
 {
     GLUtils::convertToTransformationMatrix(matrix, m_webViewMatrix);
@@ -24,6 +24,7 @@
 #include "SkRect.h"
 #include "TransformationMatrix.h"
 #include <GLES2/gl2.h>
+#include <wtf/Vector.h>
 
 #define MAX_CONTRAST 5
 
@@ -53,12 +54,24 @@ public:
     void drawQuad(SkRect& geometry, int textureId, float opacity,
                   GLenum textureTarget = GL_TEXTURE_2D,
                   GLint texFilter = GL_LINEAR);
+    // If texCoordRect is set, only that part of the texture (in normalized
+    // coordinates) is drawn, e.g. an image in a TextureAtlas page.
     void drawLayerQuad(const TransformationMatrix& drawMatrix,
                        const SkRect& geometry, int textureId, float opacity,
                        bool forceBlending = false,
-                       GLenum textureTarget = GL_TEXTURE_2D);
+                       GLenum textureTarget = GL_TEXTURE_2D,
+                       const SkRect* texCoordRect = 0);
     void drawVideoLayerQuad(const TransformationMatrix& drawMatrix,
                      float* textureMatrix, SkRect& geometry, int textureId);
+
+    // Between beginBatch() and endBatch(), drawQuad() and drawLayerQuad()
+    // only collect the GL_TEXTURE_2D quads, transformed on the CPU. The
+    // consecutive quads sharing the same opacity and blending are then
+    // submitted with a single vertex buffer upload, and a draw call per run
+    // of quads using the same texture. No GL state may be changed outside
+    // of ShaderProgram in between.
+    void beginBatch();
+    void endBatch();
     void setViewRect(const IntRect& viewRect);
     FloatRect rectInScreenCoord(const TransformationMatrix& drawMatrix,
                                 const IntSize& size);
@@ -118,8 +131,15 @@ private:
     GLuint loadShader(GLenum shaderType, const char* pSource);
     GLuint createProgram(const char* vertexSource, const char* fragmentSource);
     void setProjectionMatrix(SkRect& geometry, GLint projectionMatrixHandle);
+    TransformationMatrix quadMatrix(SkRect& geometry);
+
+    // adds a quad to the current batch, submitting it first if needed
+    void batchQuad(const TransformationMatrix& renderMatrix, const SkRect* texCoordRect,
+                   int textureId, GLint texFilter, float opacity, bool blending);
+    void submitBatch();
 
     void setBlendingState(bool enableBlending);
+    void setTexCoordRect(GLint program, const SkRect* texCoordRect);
 
     void drawQuadInternal(SkRect& geometry, GLint textureId, float opacity,
                           GLint program, GLint projectionMatrixHandle,
@@ -130,7 +150,8 @@ private:
     void drawLayerQuadInternal(const GLfloat* projectionMatrix, int textureId,
                                float opacity, GLenum textureTarget, GLint program,
                                GLint matrix, GLint texSample,
-                               GLint position, GLint alpha, GLint contrast = -1);
+                               GLint position, GLint alpha,
+                               const SkRect* texCoordRect, GLint contrast = -1);
 
     bool m_blendingEnabled;
 
@@ -143,6 +164,36 @@ private:
     TransformationMatrix m_projectionMatrix;
     GLuint m_textureBuffer[1];
 
+    // a run of consecutive batched quads drawn from the same texture
+    struct BatchedTexture {
+        BatchedTexture(int textureId, GLint texFilter)
+            : textureId(textureId), texFilter(texFilter), quadCount(0) {}
+        int textureId;
+        GLint texFilter;
+        int quadCount;
+    };
+
+    bool m_batching;
+    int m_batchQuadCount;
+    float m_batchOpacity;
+    bool m_batchBlending;
+    WTF::Vector<GLfloat> m_batchVertices;
+    WTF::Vector<BatchedTexture> m_batchTextures;
+    // vertex buffer, and static index buffer
+    GLuint m_batchBuffers[2];
+
+    int m_batchProgram;
+    int m_batchProgramInverted;
+    GLint m_hBatchAlpha;
+    GLint m_hBatchTexSampler;
+    GLint m_hBatchPosition;
+    GLint m_hBatchTexCoord;
+    GLint m_hBatchAlphaInverted;
+    GLint m_hBatchContrastInverted;
+    GLint m_hBatchTexSamplerInverted;
+    GLint m_hBatchPositionInverted;
+    GLint m_hBatchTexCoordInverted;
+
     TransformationMatrix m_documentToScreenMatrix;
     TransformationMatrix m_documentToInvScreenMatrix;
     SkRect m_viewport;
@@ -165,6 +216,10 @@ private:
     GLint m_hVideoProjectionMatrix;
     GLint m_hVideoTextureMatrix;
     GLint m_hVideoTexSampler;
+    GLint m_hTexCoordRect;
+    GLint m_hTexCoordRectInverted;
+    GLint m_hSTOESTexCoordRect;
+    GLint m_hSTOESTexCoordRectInverted;
 
     GLint m_hSTOESProjectionMatrix;
     GLint m_hSTOESAlpha;
@@ -0,0 +1,308 @@
+/*
+ * Copyright 2012, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "TextureAtlas.h"
+
+#if USE(ACCELERATED_COMPOSITING)
+
+#include "GLUtils.h"
+#include "TilesManager.h"
+
+#include <algorithm>
+#include <cutils/log.h>
+#include <wtf/text/CString.h>
+
+#undef XLOGC
+#define XLOGC(...) android_printLog(ANDROID_LOG_DEBUG, "TextureAtlas", __VA_ARGS__)
+
+#ifdef DEBUG
+
+#undef XLOG
+#define XLOG(...) android_printLog(ANDROID_LOG_DEBUG, "TextureAtlas", __VA_ARGS__)
+
+#else
+
+#undef XLOG
+#define XLOG(...)
+
+#endif // DEBUG
+
+#define ATLAS_PAGE_SIZE 512
+#define ATLAS_MAX_PAGES 4
+// Bigger images waste little enough of their layer tiles
+#define ATLAS_MAX_IMAGE_SIZE 128
+#define ATLAS_PADDING 1
+#define BYTES_PER_PIXEL 4 // 8888 config
+
+namespace WebCore {
+
+TextureAtlas::Page::Page()
+    : textureId(0)
+    , generation(0)
+    , imageCount(0)
+{
+    reset();
+}
+
+void TextureAtlas::Page::reset()
+{
+    skyline.clear();
+    skyline.append(SkylineSegment(0, 0, ATLAS_PAGE_SIZE));
+    imageCount = 0;
+    generation++;
+}
+
+int TextureAtlas::Page::fitAt(unsigned int index, int width, int height)
+{
+    int x = skyline[index].x;
+    if (x + width > ATLAS_PAGE_SIZE)
+        return -1;
+
+    // the rectangle lies on the highest segment it spans
+    int y = 0;
+    int widthLeft = width;
+    while (widthLeft > 0 && index < skyline.size()) {
+        y = std::max(y, skyline[index].y);
+        if (y + height > ATLAS_PAGE_SIZE)
+            return -1;
+        widthLeft -= skyline[index].width;
+        index++;
+    }
+    return y;
+}
+
+bool TextureAtlas::Page::allocate(int width, int height, SkIPoint* position)
+{
+    // bottom-left heuristic: lowest position, then the tightest segment
+    int bestIndex = -1;
+    int bestY = ATLAS_PAGE_SIZE;
+    int bestWidth = ATLAS_PAGE_SIZE + 1;
+    for (unsigned int i = 0; i < skyline.size(); i++) {
+        int y = fitAt(i, width, height);
+        if (y < 0)
+            continue;
+        if (y < bestY || (y == bestY && skyline[i].width < bestWidth)) {
+            bestIndex = i;
+            bestY = y;
+            bestWidth = skyline[i].width;
+        }
+    }
+    if (bestIndex < 0)
+        return false;
+
+    position->set(skyline[bestIndex].x, bestY);
+    skyline.insert(bestIndex, SkylineSegment(position->fX, bestY + height, width));
+
+    // the new segment covers the beginning of the following ones
+    unsigned int i = bestIndex + 1;
+    while (i < skyline.size()) {
+        int end = skyline[i - 1].x + skyline[i - 1].width;
+        if (skyline[i].x >= end)
+            break;
+        int shrink = end - skyline[i].x;
+        skyline[i].x += shrink;
+        skyline[i].width -= shrink;
+        if (skyline[i].width > 0)
+            break;
+        skyline.remove(i);
+    }
+
+    // merge the neighbours at the same height
+    i = 0;
+    while (i + 1 < skyline.size()) {
+        if (skyline[i].y == skyline[i + 1].y) {
+            skyline[i].width += skyline[i + 1].width;
+            skyline.remove(i + 1);
+        } else
+            i++;
+    }
+    return true;
+}
+
+// Copies the bitmap with a border replicating its edges
+static void copyWithPadding(const SkBitmap& bitmap, SkBitmap* padded)
+{
+    int width = bitmap.width();
+    int height = bitmap.height();
+    padded->setConfig(SkBitmap::kARGB_8888_Config,
+                      width + 2 * ATLAS_PADDING, height + 2 * ATLAS_PADDING);
+    padded->allocPixels();
+
+    SkAutoLockPixels bitmapLock(bitmap);
+    SkAutoLockPixels paddedLock(*padded);
+    for (int y = 0; y < padded->height(); y++) {
+        int srcY = std::min(std::max(y - ATLAS_PADDING, 0), height - 1);
+        const uint32_t* src = bitmap.getAddr32(0, srcY);
+        uint32_t* dst = padded->getAddr32(0, y);
+        for (int x = 0; x < ATLAS_PADDING; x++) {
+            dst[x] = src[0];
+            dst[ATLAS_PADDING + width + x] = src[width - 1];
+        }
+        memcpy(dst + ATLAS_PADDING, src, width * BYTES_PER_PIXEL);
+    }
+}
+
+TextureAtlas::TextureAtlas()
+{
+}
+
+TextureAtlas::~TextureAtlas()
+{
+    for (unsigned int i = 0; i < m_pages.size(); i++)
+        delete m_pages[i];
+}
+
+bool TextureAtlas::fits(int width, int height)
+{
+    return width > 0 && height > 0
+        && width <= ATLAS_MAX_IMAGE_SIZE && height <= ATLAS_MAX_IMAGE_SIZE;
+}
+
+bool TextureAtlas::allocatePageTexture(Page* page)
+{
+    int bytes = ATLAS_PAGE_SIZE * ATLAS_PAGE_SIZE * BYTES_PER_PIXEL;
+    TextureBudget* budget = TilesManager::instance()->textureBudget();
+    if (!budget->canAllocate(bytes))
+        return false;
+
+    page->textureId = GLUtils::createBaseTileGLTexture(ATLAS_PAGE_SIZE, ATLAS_PAGE_SIZE);
+    if (!page->textureId) {
+        XLOGC("ERROR: could not allocate atlas page");
+        budget->allocationFailed();
+        return false;
+    }
+    budget->allocated(TextureBudget::AtlasTextures, bytes);
+    return true;
+}
+
+bool TextureAtlas::add(const SkBitmap& bitmap, Location* location)
+{
+    if (!fits(bitmap.width(), bitmap.height())
+        || bitmap.config() != SkBitmap::kARGB_8888_Config)
+        return false;
+
+    int width = bitmap.width() + 2 * ATLAS_PADDING;
+    int height = bitmap.height() + 2 * ATLAS_PADDING;
+
+    android::Mutex::Autolock lock(m_pagesLock);
+
+    // first try the pages in use, then a page without texture, then a new one
+    int index = -1;
+    SkIPoint position;
+    for (unsigned int i = 0; i < m_pages.size() && index < 0; i++) {
+        if (m_pages[i]->textureId && m_pages[i]->allocate(width, height, &position))
+            index = i;
+    }
+    for (unsigned int i = 0; i < m_pages.size() && index < 0; i++) {
+        if (!m_pages[i]->textureId)
+            index = i;
+    }
+    if (index < 0 && m_pages.size() < ATLAS_MAX_PAGES) {
+        m_pages.append(new Page());
+        index = m_pages.size() - 1;
+    }
+    if (index < 0)
+        return false;
+
+    Page* page = m_pages[index];
+    if (!page->textureId) {
+        if (!allocatePageTexture(page))
+            return false;
+        page->allocate(width, height, &position);
+    }
+
+    SkBitmap padded;
+    copyWithPadding(bitmap, &padded);
+    GLUtils::updateTextureWithBitmap(page->textureId, position.fX, position.fY, padded);
+
+    page->imageCount++;
+    location->page = index;
+    location->generation = page->generation;
+    location->rect.setXYWH(position.fX + ATLAS_PADDING, position.fY + ATLAS_PADDING,
+                           bitmap.width(), bitmap.height());
+    XLOG("added %d x %d image at %d, %d in page %d (%d images)", bitmap.width(),
+         bitmap.height(), location->rect.fLeft, location->rect.fTop, index, page->imageCount);
+    return true;
+}
+
+// needs to be called with m_pagesLock held
+bool TextureAtlas::isValid(const Location& location)
+{
+    if (location.page < 0 || location.page >= static_cast<int>(m_pages.size()))
+        return false;
+    Page* page = m_pages[location.page];
+    return page->textureId && page->generation == location.generation;
+}
+
+bool TextureAtlas::contains(const Location& location)
+{
+    android::Mutex::Autolock lock(m_pagesLock);
+    return isValid(location);
+}
+
+bool TextureAtlas::get(const Location& location, GLuint* textureId, SkRect* texCoordRect)
+{
+    android::Mutex::Autolock lock(m_pagesLock);
+    if (!isValid(location))
+        return false;
+
+    *textureId = m_pages[location.page]->textureId;
+    float scale = 1.0f / ATLAS_PAGE_SIZE;
+    texCoordRect->set(location.rect.fLeft * scale, location.rect.fTop * scale,
+                      location.rect.fRight * scale, location.rect.fBottom * scale);
+    return true;
+}
+
+void TextureAtlas::remove(const Location& location)
+{
+    android::Mutex::Autolock lock(m_pagesLock);
+    if (!isValid(location))
+        return;
+
+    Page* page = m_pages[location.page];
+    page->imageCount--;
+    if (!page->imageCount)
+        page->reset();
+}
+
+void TextureAtlas::discardPages()
+{
+    android::Mutex::Autolock lock(m_pagesLock);
+    TextureBudget* budget = TilesManager::instance()->textureBudget();
+    for (unsigned int i = 0; i < m_pages.size(); i++) {
+        Page* page = m_pages[i];
+        if (!page->textureId)
+            continue;
+        GLUtils::deleteTexture(&page->textureId);
+        budget->freed(TextureBudget::AtlasTextures,
+                      ATLAS_PAGE_SIZE * ATLAS_PAGE_SIZE * BYTES_PER_PIXEL);
+        page->reset();
+    }
+}
+
+} // namespace WebCore
+
+#endif // USE(ACCELERATED_COMPOSITING)
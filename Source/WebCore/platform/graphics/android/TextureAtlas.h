@@ -0,0 +1,110 @@
+/*
+ * Copyright 2012, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TextureAtlas_h
+#define TextureAtlas_h
+
+#if USE(ACCELERATED_COMPOSITING)
+
+#include "SkBitmap.h"
+#include "SkRect.h"
+#include <GLES2/gl2.h>
+#include <utils/threads.h>
+#include <wtf/Vector.h>
+
+namespace WebCore {
+
+// Packs small images that never change (the ImageTextures) into a few shared
+// GL textures, instead of using a whole layer tile texture for each of them.
+// Each page is ATLAS_PAGE_SIZE pixels square, and filled with a skyline
+// allocator. Images are padded by replicating their edges so that bilinear
+// filtering doesn't bleed the neighbouring images in.
+// A page is recycled once all of its images are removed; its GL texture is
+// only freed by discardPages().
+class TextureAtlas {
+public:
+    // Where an image lives in the atlas. It becomes stale if the page is
+    // recycled or discarded, in which case the image has to be added again.
+    class Location {
+    public:
+        Location() : page(-1), generation(0) {}
+        int page;
+        unsigned generation;
+        // in the page, without the padding
+        SkIRect rect;
+    };
+
+    TextureAtlas();
+    ~TextureAtlas();
+
+    // true if an image of that size should be put in the atlas
+    static bool fits(int width, int height);
+
+    // Called on the UI thread. Returns false if there is no room, or if the
+    // budget doesn't allow another page.
+    bool add(const SkBitmap& bitmap, Location* location);
+    bool contains(const Location& location);
+    // returns the texture and the normalized coordinates of the image in it
+    bool get(const Location& location, GLuint* textureId, SkRect* texCoordRect);
+    // frees all the pages, invalidating all the locations
+    void discardPages();
+
+    // can be called from any thread
+    void remove(const Location& location);
+
+private:
+    // top edge of the filled area, from x to x + width
+    struct SkylineSegment {
+        SkylineSegment(int x, int y, int width) : x(x), y(y), width(width) {}
+        int x;
+        int y;
+        int width;
+    };
+
+    struct Page {
+        Page();
+        void reset();
+        // returns -1 if the rectangle doesn't fit at that segment
+        int fitAt(unsigned int index, int width, int height);
+        bool allocate(int width, int height, SkIPoint* position);
+
+        GLuint textureId;
+        unsigned generation;
+        int imageCount;
+        WTF::Vector<SkylineSegment> skyline;
+    };
+
+    bool isValid(const Location& location);
+    bool allocatePageTexture(Page* page);
+
+    // all of the below are protected by m_pagesLock
+    WTF::Vector<Page*> m_pages;
+    android::Mutex m_pagesLock;
+};
+
+} // namespace WebCore
+
+#endif // USE(ACCELERATED_COMPOSITING)
+#endif // TextureAtlas_h
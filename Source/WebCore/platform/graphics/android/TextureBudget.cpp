@@ -0,0 +1,178 @@
+/*
+ * Copyright 2012, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "TextureBudget.h"
+
+#if USE(ACCELERATED_COMPOSITING)
+
+#include "TilesManager.h"
+#include <cutils/atomic.h>
+#include <wtf/CurrentTime.h>
+
+#include <cutils/log.h>
+#include <wtf/text/CString.h>
+
+#undef XLOGC
+#define XLOGC(...) android_printLog(ANDROID_LOG_DEBUG, "TextureBudget", __VA_ARGS__)
+
+#ifdef DEBUG
+
+#undef XLOG
+#define XLOG(...) android_printLog(ANDROID_LOG_DEBUG, "TextureBudget", __VA_ARGS__)
+
+#else
+
+#undef XLOG
+#define XLOG(...)
+
+#endif // DEBUG
+
+#define BYTES_PER_PIXEL 4 // 8888 config
+
+// Seconds after which a trim request or an allocation failure stops
+// restricting the budget
+#define PRESSURE_TIMEOUT 30
+
+// After an allocation failure, leave that much room below the memory in use
+// when it failed
+#define FAILURE_MARGIN_TEXTURES 4
+
+namespace WebCore {
+
+// By default, allow as much as a full pool of tile textures
+static int defaultLimit()
+{
+    return TilesManager::getMaxTextureAllocation() * BYTES_PER_PIXEL
+        * TilesManager::tileWidth() * TilesManager::tileHeight();
+}
+
+TextureBudget::TextureBudget()
+    : m_limit(defaultLimit())
+    , m_pressure(NoPressure)
+    , m_pressureTime(0)
+    , m_failureCap(0)
+    , m_failureTime(0)
+{
+    for (int i = 0; i < CategoryCount; i++)
+        m_usedBytes[i] = 0;
+}
+
+void TextureBudget::allocated(Category category, int bytes)
+{
+    android_atomic_add(bytes, &m_usedBytes[category]);
+}
+
+void TextureBudget::freed(Category category, int bytes)
+{
+    android_atomic_add(-bytes, &m_usedBytes[category]);
+}
+
+int TextureBudget::usedBytes()
+{
+    int used = 0;
+    for (int i = 0; i < CategoryCount; i++)
+        used += m_usedBytes[i];
+    return used;
+}
+
+int TextureBudget::usedBytes(Category category)
+{
+    return m_usedBytes[category];
+}
+
+void TextureBudget::setLimit(int bytes)
+{
+    m_limit = bytes > 0 ? bytes : defaultLimit();
+    XLOGC("Texture budget set to %d Mb", m_limit / 1024 / 1024);
+}
+
+void TextureBudget::updatePressure()
+{
+    double now = WTF::currentTime();
+    if (m_pressure != NoPressure && now - m_pressureTime > PRESSURE_TIMEOUT) {
+        XLOG("memory pressure %d expired", m_pressure);
+        m_pressure = NoPressure;
+    }
+    if (m_failureCap && now - m_failureTime > PRESSURE_TIMEOUT) {
+        XLOG("allocation failure cap of %d bytes expired", m_failureCap);
+        m_failureCap = 0;
+    }
+}
+
+int TextureBudget::budget()
+{
+    updatePressure();
+
+    int budget = m_limit;
+    switch (m_pressure) {
+    case HiddenPressure:
+        budget /= 2;
+        break;
+    case BackgroundPressure:
+        budget /= 4;
+        break;
+    case CriticalPressure:
+        budget = 0;
+        break;
+    default:
+        break;
+    }
+
+    if (m_failureCap)
+        budget = std::min(budget, m_failureCap);
+    return budget;
+}
+
+int TextureBudget::overBudgetBytes()
+{
+    return std::max(0, usedBytes() - budget());
+}
+
+void TextureBudget::setPressure(Pressure pressure)
+{
+    updatePressure();
+    // a lower level doesn't mean the pressure went away, keep the highest
+    if (pressure >= m_pressure) {
+        m_pressure = pressure;
+        m_pressureTime = WTF::currentTime();
+    }
+    XLOGC("memory pressure %d, budget now %d Mb (%d Mb used)",
+          m_pressure, budget() / 1024 / 1024, usedBytes() / 1024 / 1024);
+}
+
+void TextureBudget::allocationFailed()
+{
+    int margin = FAILURE_MARGIN_TEXTURES * BYTES_PER_PIXEL
+        * TilesManager::tileWidth() * TilesManager::tileHeight();
+    m_failureCap = std::max(margin, usedBytes() - margin);
+    m_failureTime = WTF::currentTime();
+    XLOGC("GL allocation failed with %d Mb used, capping the budget to %d Mb",
+          usedBytes() / 1024 / 1024, m_failureCap / 1024 / 1024);
+}
+
+} // namespace WebCore
+
+#endif // USE(ACCELERATED_COMPOSITING)
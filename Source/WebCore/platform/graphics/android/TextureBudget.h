@@ -0,0 +1,100 @@
+/*
+ * Copyright 2012, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TextureBudget_h
+#define TextureBudget_h
+
+#if USE(ACCELERATED_COMPOSITING)
+
+#include <utils/threads.h>
+
+namespace WebCore {
+
+// Accounts for the graphics memory used by the compositor, and decides how
+// much of it may be used. Both are in bytes.
+// The tile textures (used by the base layer, and by the layers through
+// PaintedSurface and ImageTexture) are recycled by TilesManager, which
+// evicts the least recently drawn ones once the budget is exceeded.
+// The budget shrinks under memory pressure (onTrimMemory) or after a failed
+// GL allocation, and grows back after PRESSURE_TIMEOUT seconds.
+// The byte counters can be updated from any thread.
+class TextureBudget {
+public:
+    enum Category {
+        BaseTileTextures = 0,
+        LayerTileTextures = 1,
+        MediaTextures = 2,
+        AtlasTextures = 3,
+        CategoryCount = 4
+    };
+
+    enum Pressure {
+        NoPressure = 0,
+        // the WebView is hidden, keep what is needed to redraw it quickly
+        HiddenPressure = 1,
+        // the process is in the background, keep very little
+        BackgroundPressure = 2,
+        // the process may be killed, free everything possible
+        CriticalPressure = 3
+    };
+
+    TextureBudget();
+
+    void allocated(Category category, int bytes);
+    void freed(Category category, int bytes);
+
+    int usedBytes();
+    int usedBytes(Category category);
+
+    // 0 resets the limit to its default
+    void setLimit(int bytes);
+    int limit() { return m_limit; }
+
+    // current budget, taking in account pressure and allocation failures
+    int budget();
+    bool canAllocate(int bytes) { return usedBytes() + bytes <= budget(); }
+    int overBudgetBytes();
+
+    void setPressure(Pressure pressure);
+    // a GL allocation failed: caps the budget to what is currently used
+    void allocationFailed();
+
+private:
+    void updatePressure();
+
+    volatile int32_t m_usedBytes[CategoryCount];
+    int m_limit;
+
+    // only accessed by the UI thread
+    Pressure m_pressure;
+    double m_pressureTime;
+    int m_failureCap;
+    double m_failureTime;
+};
+
+} // namespace WebCore
+
+#endif // USE(ACCELERATED_COMPOSITING)
+#endif // TextureBudget_h
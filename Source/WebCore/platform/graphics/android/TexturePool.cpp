@@ -0,0 +1,137 @@
+/*
+ * Copyright 2012, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "TexturePool.h"
+
+#if USE(ACCELERATED_COMPOSITING)
+
+#include "GLUtils.h"
+
+#include <cutils/log.h>
+#include <wtf/text/CString.h>
+
+#ifdef DEBUG
+
+#undef XLOG
+#define XLOG(...) android_printLog(ANDROID_LOG_DEBUG, "TexturePool", __VA_ARGS__)
+
+#else
+
+#undef XLOG
+#define XLOG(...)
+
+#endif // DEBUG
+
+// Number of textures kept for reuse, the others are deleted
+#define MAX_POOLED_TEXTURES 8
+
+// Deletions left pending while frames keep being drawn
+#define MAX_PENDING_DELETES 16
+
+namespace WebCore {
+
+TexturePool::TexturePool()
+    : m_hits(0)
+    , m_misses(0)
+{
+}
+
+GLuint TexturePool::acquire(int width, int height)
+{
+    for (unsigned int i = 0; i < m_pool.size(); i++) {
+        if (m_pool[i].width == width && m_pool[i].height == height) {
+            GLuint texture = m_pool[i].texture;
+            m_pool.remove(i);
+            m_hits++;
+            return texture;
+        }
+    }
+
+    m_misses++;
+    return GLUtils::createBaseTileGLTexture(width, height);
+}
+
+void TexturePool::recycle(GLuint* texture, int width, int height)
+{
+    if (!*texture)
+        return;
+
+    if (m_pool.size() >= MAX_POOLED_TEXTURES) {
+        deleteLater(texture);
+        return;
+    }
+
+    PooledTexture pooled = { *texture, width, height };
+    m_pool.append(pooled);
+    *texture = 0;
+}
+
+void TexturePool::deleteLater(GLuint* texture)
+{
+    if (!*texture)
+        return;
+
+    m_pendingDeletes.append(*texture);
+    *texture = 0;
+}
+
+void TexturePool::frameEnded(bool idle)
+{
+    // while animating or painting, only bound the number of pending textures
+    deletePending(idle ? 0 : MAX_PENDING_DELETES);
+}
+
+void TexturePool::clear()
+{
+    for (unsigned int i = 0; i < m_pool.size(); i++)
+        m_pendingDeletes.append(m_pool[i].texture);
+    m_pool.clear();
+    deletePending(0);
+}
+
+String TexturePool::dump()
+{
+    int requests = m_hits + m_misses;
+    return String::format("pooled %d pending %d hits %d misses %d hit rate %d%%",
+                          m_pool.size(), m_pendingDeletes.size(), m_hits, m_misses,
+                          requests ? m_hits * 100 / requests : 0);
+}
+
+void TexturePool::deletePending(unsigned int keep)
+{
+    if (m_pendingDeletes.size() <= keep)
+        return;
+
+    int count = m_pendingDeletes.size() - keep;
+    XLOG("deleting %d textures, keeping %d pending", count, keep);
+    glDeleteTextures(count, m_pendingDeletes.data());
+    GLUtils::checkGlError("glDeleteTextures");
+    m_pendingDeletes.remove(0, count);
+}
+
+} // namespace WebCore
+
+#endif // USE(ACCELERATED_COMPOSITING)
@@ -0,0 +1,85 @@
+/*
+ * Copyright 2012, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TexturePool_h
+#define TexturePool_h
+
+#if USE(ACCELERATED_COMPOSITING)
+
+#include <GLES2/gl2.h>
+#include <wtf/Vector.h>
+#include <wtf/text/WTFString.h>
+
+namespace WebCore {
+
+// Keeps the GL textures of the discarded tiles so that new tiles of the same
+// size can reuse them instead of going through glGenTextures/glTexImage2D,
+// and defers the deletion of the textures that can't be reused to the frames
+// where there is nothing left to draw.
+// Only RGBA textures allocated with GLUtils::createBaseTileGLTexture can be
+// recycled: compressed textures and the ones bound to an EGLImage have their
+// own storage, and are simply deleted later.
+// The pooled textures are not accounted in the TextureBudget; the pool is
+// small and emptied under memory pressure.
+// UI thread only.
+class TexturePool {
+public:
+    TexturePool();
+
+    // returns a texture from the pool, or a newly allocated one (0 on failure)
+    GLuint acquire(int width, int height);
+    // gives back a texture that can be recycled, sets it to 0
+    void recycle(GLuint* texture, int width, int height);
+    // gives back a texture that can't be recycled, sets it to 0
+    void deleteLater(GLuint* texture);
+
+    // called at the end of each frame, idle is true if nothing was left to draw
+    void frameEnded(bool idle);
+    // deletes all the pooled and pending textures right away
+    void clear();
+
+    int hits() { return m_hits; }
+    int misses() { return m_misses; }
+    String dump();
+
+private:
+    void deletePending(unsigned int keep);
+
+    struct PooledTexture {
+        GLuint texture;
+        int width;
+        int height;
+    };
+
+    Vector<PooledTexture> m_pool;
+    Vector<GLuint> m_pendingDeletes;
+    int m_hits;
+    int m_misses;
+};
+
+} // namespace WebCore
+
+#endif // USE(ACCELERATED_COMPOSITING)
+#endif // TexturePool_h
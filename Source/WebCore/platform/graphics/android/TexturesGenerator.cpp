@@ -60,19 +60,10 @@ void TexturesGenerator::scheduleOperation(QueuedOperation* operation)
     mRequestedOperationsCond.signal();
 }
 
-void TexturesGenerator::removeOperationsForPage(TiledPage* page)
+int TexturesGenerator::pendingOperationsCount()
 {
-    removeOperationsForFilter(new PageFilter(page));
-}
-
-void TexturesGenerator::removePaintOperationsForPage(TiledPage* page, bool waitForRunning)
-{
-    removeOperationsForFilter(new PagePaintFilter(page), waitForRunning);
-}
-
-void TexturesGenerator::removeOperationsForFilter(OperationFilter* filter)
-{
-    removeOperationsForFilter(filter, true);
+    android::Mutex::Autolock lock(mRequestedOperationsLock);
+    return mRequestedOperations.size();
 }
 
 void TexturesGenerator::removeOperationsForFilter(OperationFilter* filter, bool waitForRunning)
@@ -81,15 +72,7 @@ void TexturesGenerator::removeOperationsForFilter(OperationFilter* filter, bool
         return;
 
     android::Mutex::Autolock lock(mRequestedOperationsLock);
-    for (unsigned int i = 0; i < mRequestedOperations.size();) {
-        QueuedOperation* operation = mRequestedOperations[i];
-        if (filter->check(operation)) {
-            mRequestedOperations.remove(i);
-            delete operation;
-        } else {
-            i++;
-        }
-    }
+    mRequestedOperations.removeOperationsForFilter(filter);
 
     if (waitForRunning && m_currentOperation) {
         QueuedOperation* operation = m_currentOperation;
@@ -107,19 +90,35 @@ void TexturesGenerator::removeOperationsForFilter(OperationFilter* filter, bool
             m_tilesManager->transferQueue()->interruptTransferQueue(true);
         }
 
-        delete filter;
-
         // At this point, it means that we are currently executing an operation that
         // we want to be removed -- we should wait until it is done, so that
         // when we return our caller can be sure that there is no more operations
         // in the queue matching the given filter.
         while (m_waitForCompletion)
             mRequestedOperationsCond.wait(mRequestedOperationsLock);
-    } else {
-        delete filter;
     }
 }
 
+QueuedOperation* TexturesGenerator::stealOperation()
+{
+    // Never block here: the thief holds its own queue lock while stealing,
+    // and two workers stealing from each other would otherwise deadlock.
+    if (mRequestedOperationsLock.tryLock() != NO_ERROR)
+        return 0;
+
+    QueuedOperation* operation = 0;
+    if (mRequestedOperations.size())
+        operation = popNext(true);
+    mRequestedOperationsLock.unlock();
+    return operation;
+}
+
+OperationQueueStats TexturesGenerator::queueStats()
+{
+    android::Mutex::Autolock lock(mRequestedOperationsLock);
+    return mRequestedOperations.stats();
+}
+
 status_t TexturesGenerator::readyToRun()
 {
     XLOG("Thread ready to run");
@@ -127,36 +126,20 @@ status_t TexturesGenerator::readyToRun()
 }
 
 // Must be called from within a lock!
-QueuedOperation* TexturesGenerator::popNext()
+// If paintOnly is set, only a PaintTile or PaintStrip operation is returned,
+// as other operations (e.g. DeleteTexture) are bound to the EGL context of
+// the worker they were scheduled on.
+QueuedOperation* TexturesGenerator::popNext(bool paintOnly)
 {
-    // Priority can change between when it was added and now
-    // Hence why the entire queue is rescanned
-    QueuedOperation* current = mRequestedOperations.last();
-    int currentPriority = current->priority();
-    if (currentPriority < 0) {
-        mRequestedOperations.removeLast();
-        return current;
-    }
-    int currentIndex = mRequestedOperations.size() - 1;
-    // Scan from the back to make removing faster (less items to copy)
-    for (int i = mRequestedOperations.size() - 2; i >= 0; i--) {
-        QueuedOperation *next = mRequestedOperations[i];
-        int nextPriority = next->priority();
-        if (nextPriority < 0) {
-            // Found a very high priority item, go ahead and just handle it now
-            mRequestedOperations.remove(i);
-            return next;
-        }
-        // pick items preferrably by priority, or if equal, by order of
-        // insertion (as we add items at the back of the queue)
-        if (nextPriority <= currentPriority) {
-            current = next;
-            currentPriority = nextPriority;
-            currentIndex = i;
-        }
+    // Priorities change as the viewport moves. Rather than rescanning the
+    // entire queue for every operation, reorder it once each time the
+    // TilesManager signals that the priorities are stale.
+    int32_t generation = m_tilesManager->prioritiesGeneration();
+    if (generation != m_prioritiesGeneration) {
+        mRequestedOperations.reprioritize();
+        m_prioritiesGeneration = generation;
     }
-    mRequestedOperations.remove(currentIndex);
-    return current;
+    return mRequestedOperations.popNext(paintOnly);
 }
 
 bool TexturesGenerator::threadLoop()
@@ -175,7 +158,9 @@ bool TexturesGenerator::threadLoop()
         mRequestedOperationsLock.lock();
         XLOG("threadLoop, %d operations in the queue", mRequestedOperations.size());
         if (mRequestedOperations.size())
-            m_currentOperation = popNext();
+            m_currentOperation = popNext(false);
+        else
+            m_currentOperation = m_tilesManager->stealOperation(this);
         mRequestedOperationsLock.unlock();
 
         if (m_currentOperation) {
@@ -187,7 +172,8 @@ bool TexturesGenerator::threadLoop()
         mRequestedOperationsLock.lock();
         if (m_currentOperation)
             m_currentOperation = 0;
-        if (!mRequestedOperations.size())
+        // keep going as long as we either have or can steal work
+        if (!oldOperation && !mRequestedOperations.size())
             stop = true;
         if (m_waitForCompletion) {
             m_waitForCompletion = false;
@@ -28,6 +28,7 @@
 
 #if USE(ACCELERATED_COMPOSITING)
 
+#include "OperationQueue.h"
 #include "QueuedOperation.h"
 #include "TiledPage.h"
 #include "TilePainter.h"
@@ -41,31 +42,46 @@ class BaseLayerAndroid;
 class LayerAndroid;
 class TilesManager;
 
+// A TexturesGenerator is one paint worker of the pool owned by the
+// TilesManager. Each worker drains its own queue of operations; when that
+// queue runs dry, it steals the most urgent PaintTile operation from the
+// busiest other worker before going back to sleep.
 class TexturesGenerator : public Thread {
 public:
     TexturesGenerator(TilesManager* instance) : Thread(false)
         , m_waitForCompletion(false)
         , m_currentOperation(0)
-        , m_tilesManager(instance) { }
+        , m_tilesManager(instance)
+        , m_prioritiesGeneration(0) { }
     virtual ~TexturesGenerator() { }
     virtual status_t readyToRun();
 
-    void removeOperationsForPage(TiledPage* page);
-    void removePaintOperationsForPage(TiledPage* page, bool waitForRunning);
-    void removeOperationsForFilter(OperationFilter* filter);
+    // The caller keeps the ownership of the filter
     void removeOperationsForFilter(OperationFilter* filter, bool waitForRunning);
 
     void scheduleOperation(QueuedOperation* operation);
 
+    // Number of operations waiting in this worker's queue
+    int pendingOperationsCount();
+
+    // Called by another (idle) worker. Removes and returns the most urgent
+    // PaintTile or PaintStrip operation of this worker's queue, or 0 if the
+    // queue is empty or currently locked.
+    QueuedOperation* stealOperation();
+
+    OperationQueueStats queueStats();
+
 private:
-    QueuedOperation* popNext();
+    QueuedOperation* popNext(bool paintOnly);
     virtual bool threadLoop();
-    Vector<QueuedOperation*> mRequestedOperations;
+    OperationQueue mRequestedOperations;
     android::Mutex mRequestedOperationsLock;
     android::Condition mRequestedOperationsCond;
     bool m_waitForCompletion;
     QueuedOperation* m_currentOperation;
     TilesManager* m_tilesManager;
+    // last TilesManager priorities generation the queue was ordered for
+    int32_t m_prioritiesGeneration;
 };
 
 } // namespace WebCore
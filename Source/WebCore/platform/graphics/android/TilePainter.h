@@ -49,6 +49,7 @@ public:
    virtual float opacity() { return 1.0; }
    enum SurfaceType { PaintedSurface, ImageSurface };
    virtual SurfaceType type() { return PaintedSurface; }
+   virtual bool hasText() { return false; }
 };
 
 }
@@ -67,9 +67,14 @@ TiledPage::TiledPage(int id, GLWebViewState* state)
     , m_glWebViewState(state)
     , m_latestPictureInval(0)
     , m_prepare(false)
+    , m_scrollingDown(false)
     , m_isPrefetchPage(false)
+    , m_isLowResPage(false)
+    , m_preparedGoingDown(false)
     , m_willDraw(false)
 {
+    m_preparedTileBounds.setEmpty();
+    m_flingTileBounds.setEmpty();
     m_baseTiles = new BaseTile[TilesManager::getMaxTextureAllocation() + 1];
 #ifdef DEBUG_COUNT
     ClassTracker::instance()->increment("TiledPage");
@@ -191,7 +196,7 @@ void TiledPage::prepareRow(bool goingLeft, int tilesInRow, int firstTileX, int y
             // see if the texture is dirty and in need of repainting
             if (currentTile->isDirty() || !currentTile->frontTexture())
                 currentTile->reserveTexture();
-            if (currentTile->backTexture()
+            if (currentTile->hasPaintTexture()
                     && currentTile->isDirty()
                     && !currentTile->isRepaintPending()) {
                 PaintTileOperation *operation = new PaintTileOperation(currentTile);
@@ -201,6 +206,56 @@ void TiledPage::prepareRow(bool goingLeft, int tilesInRow, int firstTileX, int y
     }
 }
 
+void TiledPage::flingTilesAhead(int* aheadX, int* aheadY)
+{
+    SkPoint velocity = m_glWebViewState->scrollVelocity();
+    float tilesPerSecondX = velocity.fX * m_scale / TilesManager::tileWidth();
+    float tilesPerSecondY = velocity.fY * m_scale / TilesManager::tileHeight();
+    *aheadX = std::min(FLING_PREFETCH_MAX_TILES,
+                       static_cast<int>(roundf(fabsf(tilesPerSecondX) * FLING_PREFETCH_LOOKAHEAD)));
+    *aheadY = std::min(FLING_PREFETCH_MAX_TILES,
+                       static_cast<int>(roundf(fabsf(tilesPerSecondY) * FLING_PREFETCH_LOOKAHEAD)));
+    if (tilesPerSecondX < 0)
+        *aheadX = -*aheadX;
+    if (tilesPerSecondY < 0)
+        *aheadY = -*aheadY;
+}
+
+float TiledPage::flingTimeToVisible(int x, int y)
+{
+    if (!m_glWebViewState || m_preparedTileBounds.isEmpty())
+        return -1;
+
+    SkPoint velocity = m_glWebViewState->scrollVelocity();
+    float tilesPerSecondX = velocity.fX * m_scale / TilesManager::tileWidth();
+    float tilesPerSecondY = velocity.fY * m_scale / TilesManager::tileHeight();
+
+    // time for the visible bounds to reach the tile along each axis
+    float timeX = 0;
+    if (x < m_preparedTileBounds.fLeft) {
+        if (tilesPerSecondX >= 0)
+            return -1;
+        timeX = (m_preparedTileBounds.fLeft - x) / -tilesPerSecondX;
+    } else if (x >= m_preparedTileBounds.fRight) {
+        if (tilesPerSecondX <= 0)
+            return -1;
+        timeX = (x - m_preparedTileBounds.fRight + 1) / tilesPerSecondX;
+    }
+
+    float timeY = 0;
+    if (y < m_preparedTileBounds.fTop) {
+        if (tilesPerSecondY >= 0)
+            return -1;
+        timeY = (m_preparedTileBounds.fTop - y) / -tilesPerSecondY;
+    } else if (y >= m_preparedTileBounds.fBottom) {
+        if (tilesPerSecondY <= 0)
+            return -1;
+        timeY = (y - m_preparedTileBounds.fBottom + 1) / tilesPerSecondY;
+    }
+
+    return std::max(timeX, timeY);
+}
+
 bool TiledPage::updateTileDirtiness(const SkIRect& tileBounds)
 {
     if (!m_glWebViewState || tileBounds.isEmpty()) {
@@ -237,6 +292,14 @@ void TiledPage::prepare(bool goingDown, bool goingLeft, const SkIRect& tileBound
     TilesManager::instance()->gatherTextures();
     m_scrollingDown = goingDown;
 
+    // the priority of the queued paints depends on the viewport position and
+    // scrolling direction
+    if (tileBounds != m_preparedTileBounds || goingDown != m_preparedGoingDown) {
+        TilesManager::instance()->reprioritizeOperations();
+        m_preparedTileBounds = tileBounds;
+        m_preparedGoingDown = goingDown;
+    }
+
     int firstTileX = tileBounds.fLeft;
     int firstTileY = tileBounds.fTop;
     int nbTilesWidth = tileBounds.width();
@@ -247,6 +310,8 @@ void TiledPage::prepare(bool goingDown, bool goingLeft, const SkIRect& tileBound
     int nTilesToPrepare = nbTilesWidth * nbTilesHeight;
     int nMaxTilesPerPage = m_baseTileSize / 2;
 
+    int aheadX = 0;
+    int aheadY = 0;
     if (bounds == ExpandedBounds) {
         // prepare tiles outside of the visible bounds
         int expandX = m_glWebViewState->expandedTileBoundsX();
@@ -257,6 +322,18 @@ void TiledPage::prepare(bool goingDown, bool goingLeft, const SkIRect& tileBound
 
         firstTileY -= expandY;
         nbTilesHeight += expandY * 2;
+
+        // and along the fling trajectory, the lower resolution prefetch page
+        // covers the rest of the page
+        if (!m_isPrefetchPage && !m_isLowResPage) {
+            flingTilesAhead(&aheadX, &aheadY);
+            if (aheadX < 0)
+                firstTileX += aheadX;
+            nbTilesWidth += abs(aheadX);
+            if (aheadY < 0)
+                firstTileY += aheadY;
+            nbTilesHeight += abs(aheadY);
+        }
     }
 
     // crop the tile bounds in each dimension to the larger of the base layer or viewport
@@ -287,6 +364,21 @@ void TiledPage::prepare(bool goingDown, bool goingLeft, const SkIRect& tileBound
               " nbTilesHeight %d nbTilesWidth %d", nbTilesHeight, nbTilesWidth);
         return;
     }
+    // when the fling slows down or changes direction, drop the queued paints
+    // of the tiles it won't reach anymore
+    SkIRect preparedArea = SkIRect::MakeXYWH(firstTileX, firstTileY, nbTilesWidth, nbTilesHeight);
+    if (!m_flingTileBounds.isEmpty() && !preparedArea.contains(m_flingTileBounds)) {
+        XLOG("fling area %d %d %d %d shrunk, cancelling paints outside of %d %d %d %d",
+             m_flingTileBounds.fLeft, m_flingTileBounds.fTop,
+             m_flingTileBounds.fRight, m_flingTileBounds.fBottom,
+             preparedArea.fLeft, preparedArea.fTop, preparedArea.fRight, preparedArea.fBottom);
+        TilesManager::instance()->removeOperationsForFilter(new TileBoundsFilter(this, preparedArea));
+    }
+    if (aheadX || aheadY)
+        m_flingTileBounds = preparedArea;
+    else
+        m_flingTileBounds.setEmpty();
+
     for (int i = 0; i < nbTilesHeight; i++)
         prepareRow(goingLeft, nbTilesWidth, firstTileX, firstTileY + i, tileBounds);
 
@@ -360,7 +452,7 @@ void TiledPage::prepareForDrawGL(float transparency, const SkIRect& tileBounds)
     m_tileBounds = tileBounds;
 }
 
-void TiledPage::drawGL()
+void TiledPage::drawGL(const SkRegion& occludedArea)
 {
     if (!m_glWebViewState || m_transparency == 0 || !m_willDraw)
         return;
@@ -368,21 +460,38 @@ void TiledPage::drawGL()
     const float tileWidth = TilesManager::tileWidth() * m_invScale;
     const float tileHeight = TilesManager::tileHeight() * m_invScale;
 
+    int readyTiles = 0;
+    int drawnTiles = 0;
     for (int j = 0; j < m_baseTileSize; j++) {
         BaseTile& tile = m_baseTiles[j];
         bool tileInView = m_tileBounds.contains(tile.x(), tile.y());
         if (tileInView) {
+            bool isReady = tile.isTileReady();
+            if (isReady)
+                readyTiles++;
+
             SkRect rect;
             rect.fLeft = tile.x() * tileWidth;
             rect.fTop = tile.y() * tileHeight;
             rect.fRight = rect.fLeft + tileWidth;
             rect.fBottom = rect.fTop + tileHeight;
 
-            tile.draw(m_transparency, rect, m_scale);
+            SkIRect area;
+            rect.roundOut(&area);
+            if (!occludedArea.contains(area)) {
+                tile.draw(m_transparency, rect, m_scale);
+                if (isReady)
+                    drawnTiles++;
+            }
         }
 
         TilesManager::instance()->getProfiler()->nextTile(tile, m_invScale, tileInView);
     }
+
+    // the low res page only fills in for the missing tiles of the others
+    int missingTiles = m_tileBounds.width() * m_tileBounds.height() - readyTiles;
+    TilesManager::instance()->frameTimings()->tilesDrawn(drawnTiles,
+                                                         isLowResPage() ? 0 : missingTiles);
     m_willDraw = false; // don't redraw until re-prepared
 }
 
@@ -394,7 +503,7 @@ bool TiledPage::paint(BaseTile* tile, SkCanvas* canvas, unsigned int* pictureUse
     if (!m_glWebViewState)
         return false;
 
-    if (isPrefetchPage())
+    if (isPrefetchPage() || isLowResPage())
         canvas->setDrawFilter(&prefetchFilter);
 
     *pictureUsed = m_glWebViewState->paintBaseLayerContent(canvas);
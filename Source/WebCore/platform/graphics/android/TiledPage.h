@@ -78,8 +78,9 @@ public:
     bool swapBuffersIfReady(const SkIRect& tileBounds, float scale);
     // save the transparency and bounds to be drawn in drawGL()
     void prepareForDrawGL(float transparency, const SkIRect& tileBounds);
-    // draw the page on the screen
-    void drawGL();
+    // draw the page on the screen, skipping the tiles entirely within
+    // occludedArea (in document coordinates)
+    void drawGL(const SkRegion& occludedArea);
 
     // TilePainter implementation
     // used by individual tiles to generate the bitmap for their tile
@@ -99,8 +100,20 @@ public:
     bool scrollingDown() { return m_scrollingDown; }
     bool isPrefetchPage() { return m_isPrefetchPage; }
     void setIsPrefetchPage(bool isPrefetch) { m_isPrefetchPage = isPrefetch; }
+    // the low resolution page is drawn under the other pages, to fill the
+    // gaps while they are zoomed or missing tiles
+    bool isLowResPage() { return m_isLowResPage; }
+    void setIsLowResPage(bool isLowRes) { m_isLowResPage = isLowRes; }
+    const SkIRect& preparedTileBounds() { return m_preparedTileBounds; }
+
+    // seconds before the current fling brings the tile into the prepared
+    // bounds, 0 if already in them, or -1 if the fling doesn't go there
+    float flingTimeToVisible(int x, int y);
 
 private:
+    // number of rows and columns to prepare ahead of the visible bounds,
+    // signed along the fling direction
+    void flingTilesAhead(int* aheadX, int* aheadY);
     void prepareRow(bool goingLeft, int tilesInRow, int firstTileX, int y, const SkIRect& tileBounds);
 
     BaseTile* getBaseTile(int x, int y) const;
@@ -128,6 +141,16 @@ private:
     bool m_prepare;
     bool m_scrollingDown;
     bool m_isPrefetchPage;
+    bool m_isLowResPage;
+
+    // bounds and direction of the last prepare(), so that the paint queues
+    // are only reordered when the viewport actually moved
+    SkIRect m_preparedTileBounds;
+    bool m_preparedGoingDown;
+
+    // area prepared during the last prepare() extended along a fling, empty
+    // when not flinging
+    SkIRect m_flingTileBounds;
 
     // info saved in prepare, used in drawGL()
     bool m_willDraw;
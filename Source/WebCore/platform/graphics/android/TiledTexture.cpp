@@ -206,7 +206,7 @@ void TiledTexture::prepareTile(bool repaint, int x, int y)
         tile->reserveTexture();
 
     bool hasPicture = m_paintingPicture != 0; // safely read on UI thread, since only UI thread writes
-    if (tile->backTexture() && tile->isDirty() && !tile->isRepaintPending() && hasPicture) {
+    if (tile->hasPaintTexture() && tile->isDirty() && !tile->isRepaintPending() && hasPicture) {
         PaintTileOperation *operation = new PaintTileOperation(tile, m_surface);
         TilesManager::instance()->scheduleOperation(operation);
     }
@@ -262,6 +262,8 @@ bool TiledTexture::draw()
     const float tileHeight = TilesManager::layerTileHeight() * m_invScale;
 
     bool askRedraw = false;
+    ShaderProgram* shader = TilesManager::instance()->shader();
+    shader->beginBatch();
     for (unsigned int i = 0; i < m_tiles.size(); i++) {
         BaseTile* tile = m_tiles[i];
 
@@ -281,6 +283,7 @@ bool TiledTexture::draw()
 #endif
         }
     }
+    shader->endBatch();
 
     // need to redraw if some visible tile wasn't ready
     return askRedraw;
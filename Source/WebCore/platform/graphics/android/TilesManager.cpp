@@ -33,10 +33,12 @@
 #include "SkCanvas.h"
 #include "SkDevice.h"
 #include "SkPaint.h"
+#include <algorithm>
 #include <android/native_window.h>
 #include <cutils/atomic.h>
 #include <gui/SurfaceTexture.h>
 #include <gui/SurfaceTextureClient.h>
+#include <unistd.h>
 
 
 #include <cutils/log.h>
@@ -79,6 +81,10 @@
 
 #define LAYER_TEXTURES_DESTROY_TIMEOUT 60 // If we do not need layers for 60 seconds, free the textures
 
+// Upper bound on the number of paint workers. One core is left to the UI and
+// WebCore threads, the others paint tiles.
+#define MAX_PAINT_THREADS 4
+
 namespace WebCore {
 
 GLint TilesManager::getMaxTextureSize()
@@ -103,17 +109,126 @@ TilesManager::TilesManager()
     , m_invertedScreen(false)
     , m_invertedScreenSwitch(false)
     , m_useMinimalMemory(true)
+    , m_useGaneshForLayerText(false)
+    , m_prefetchDistance(TILE_PREFETCH_DISTANCE)
     , m_drawGLCount(1)
     , m_lastTimeLayersUsed(0)
     , m_hasLayerTextures(false)
+    , m_paintThreadCount(1)
+    , m_prioritiesGeneration(0)
 {
     XLOG("TilesManager ctor");
     m_textures.reserveCapacity(MAX_TEXTURE_ALLOCATION);
     m_availableTextures.reserveCapacity(MAX_TEXTURE_ALLOCATION);
     m_tilesTextures.reserveCapacity(MAX_TEXTURE_ALLOCATION);
     m_availableTilesTextures.reserveCapacity(MAX_TEXTURE_ALLOCATION);
-    m_pixmapsGenerationThread = new TexturesGenerator(this);
-    m_pixmapsGenerationThread->run("TexturesGenerator", android::PRIORITY_BACKGROUND);
+
+    int cores = sysconf(_SC_NPROCESSORS_CONF);
+    int workers = std::max(1, std::min(cores - 1, MAX_PAINT_THREADS));
+    for (int i = 0; i < workers; i++) {
+        sp<TexturesGenerator> generator = new TexturesGenerator(this);
+        generator->run("TexturesGenerator", android::PRIORITY_BACKGROUND);
+        m_textureGenerators.append(generator);
+    }
+    m_paintThreadCount = workers;
+    XLOGC("TilesManager started %d paint workers (%d cores)", workers, cores);
+}
+
+void TilesManager::removeOperationsForFilter(OperationFilter* filter, bool waitForRunning)
+{
+    if (!filter)
+        return;
+
+    {
+        android::Mutex::Autolock lock(m_generatorsLock);
+        for (unsigned int i = 0; i < m_textureGenerators.size(); i++)
+            m_textureGenerators[i]->removeOperationsForFilter(filter, waitForRunning);
+    }
+
+    delete filter;
+}
+
+void TilesManager::scheduleOperation(QueuedOperation* operation)
+{
+    // Operations other than tile and strip paints have to run on the first
+    // worker, as they may depend on its EGL context. The same goes for every
+    // operation when painting with Ganesh, which owns a single GL context.
+    int count = m_paintThreadCount;
+    if (!operation->isPaint()
+        || BaseRenderer::getCurrentRendererType() != BaseRenderer::Raster)
+        count = 1;
+
+    // Give the operation to the least loaded worker; work stealing takes care
+    // of balancing if the queues drain unevenly.
+    TexturesGenerator* target = m_textureGenerators[0].get();
+    int targetCount = target->pendingOperationsCount();
+    for (int i = 1; i < count && targetCount; i++) {
+        int pending = m_textureGenerators[i]->pendingOperationsCount();
+        if (pending < targetCount) {
+            target = m_textureGenerators[i].get();
+            targetCount = pending;
+        }
+    }
+    target->scheduleOperation(operation);
+}
+
+QueuedOperation* TilesManager::stealOperation(TexturesGenerator* thief)
+{
+    if (BaseRenderer::getCurrentRendererType() != BaseRenderer::Raster)
+        return 0;
+
+    // Don't steal while operations are being removed, the removal would miss
+    // the operation in flight.
+    if (m_generatorsLock.tryLock() != NO_ERROR)
+        return 0;
+
+    const int count = m_textureGenerators.size();
+    int thiefIndex = 0;
+    for (int i = 0; i < count; i++) {
+        if (m_textureGenerators[i].get() == thief) {
+            thiefIndex = i;
+            break;
+        }
+    }
+
+    // Workers beyond m_paintThreadCount only finish their remaining work, but
+    // anyone may steal from them.
+    QueuedOperation* operation = 0;
+    if (thiefIndex < m_paintThreadCount) {
+        for (int i = 1; i < count && !operation; i++)
+            operation = m_textureGenerators[(thiefIndex + i) % count]->stealOperation();
+    }
+
+    m_generatorsLock.unlock();
+
+    if (operation)
+        XLOG("worker %d stole operation %p", thiefIndex, operation);
+    return operation;
+}
+
+void TilesManager::reprioritizeOperations()
+{
+    android_atomic_inc(&m_prioritiesGeneration);
+}
+
+OperationQueueStats TilesManager::gatherOperationQueueStats()
+{
+    OperationQueueStats stats;
+    for (unsigned int i = 0; i < m_textureGenerators.size(); i++)
+        stats.add(m_textureGenerators[i]->queueStats());
+    return stats;
+}
+
+void TilesManager::setPaintThreadCount(int count)
+{
+    m_paintThreadCount = std::max(1, std::min(count, maxPaintThreadCount()));
+    XLOGC("Now painting with %d workers", m_paintThreadCount);
+}
+
+void TilesManager::setPrefetchDistance(int distance)
+{
+    m_prefetchDistance = std::max(0, std::min(distance, TILE_PREFETCH_DISTANCE));
+    XLOGC("Now prefetching %d tiles ahead", m_prefetchDistance);
 }
 
 void TilesManager::allocateTiles()
@@ -139,7 +254,7 @@ void TilesManager::allocateTiles()
     int nbLayersTexturesAllocated = 0;
     for (int i = 0; i < nbLayersTexturesToAllocate; i++) {
         BaseTileTexture* texture = new BaseTileTexture(
-            layerTileWidth(), layerTileHeight());
+            layerTileWidth(), layerTileHeight(), true);
         // the atomic load ensures that the texture has been fully initialized
         // before we pass a pointer for other threads to operate on
         BaseTileTexture* loadedTexture =
@@ -171,6 +286,10 @@ void TilesManager::deallocateTextures(bool allTextures)
     }
     deallocateTexturesVector(sparedDrawCount, m_textures);
     deallocateTexturesVector(sparedDrawCount, m_tilesTextures);
+    // the freed textures must not stay around in the pool
+    m_texturePool.clear();
+    if (allTextures)
+        m_textureAtlas.discardPages();
 }
 
 void TilesManager::deallocateTexturesVector(unsigned long long sparedDrawCount,
@@ -189,6 +308,81 @@ void TilesManager::deallocateTexturesVector(unsigned long long sparedDrawCount,
          dealloc, max, maxLayer);
 }
 
+struct TilesManager::EvictionCandidate {
+    BaseTileTexture* texture;
+    unsigned long long drawCount;
+    int distance;
+
+    // least recently drawn first, then farthest from its page's viewport
+    bool operator<(const EvictionCandidate& other) const
+    {
+        if (drawCount != other.drawCount)
+            return drawCount < other.drawCount;
+        return distance > other.distance;
+    }
+};
+
+void TilesManager::gatherEvictionCandidates(WTF::Vector<BaseTileTexture*>& textures,
+                                            WTF::Vector<EvictionCandidate>& candidates)
+{
+    // textures drawn in the last frame are kept, to avoid flickering
+    unsigned long long lastDrawCount = getDrawGLCount() - 1;
+    for (unsigned int i = 0; i < textures.size(); i++) {
+        BaseTileTexture* texture = textures[i];
+        if (!texture->m_ownTextureId || texture->busy())
+            continue;
+
+        EvictionCandidate candidate;
+        candidate.texture = texture;
+        candidate.drawCount = 0;
+        candidate.distance = 0;
+
+        BaseTile* owner = static_cast<BaseTile*>(texture->owner());
+        if (owner) {
+            candidate.drawCount = owner->drawCount();
+            if (candidate.drawCount >= lastDrawCount)
+                continue;
+            if (owner->page()) {
+                const SkIRect& bounds = owner->page()->preparedTileBounds();
+                if (!bounds.isEmpty()) {
+                    int dx = std::max(0, std::max(bounds.fLeft - owner->x(),
+                                                  owner->x() - bounds.fRight));
+                    int dy = std::max(0, std::max(bounds.fTop - owner->y(),
+                                                  owner->y() - bounds.fBottom));
+                    candidate.distance = dx + dy;
+                }
+            }
+        }
+        candidates.append(candidate);
+    }
+}
+
+void TilesManager::enforceTextureBudget()
+{
+    int excess = m_textureBudget.overBudgetBytes();
+    if (!excess)
+        return;
+
+    android::Mutex::Autolock lock(m_texturesLock);
+
+    WTF::Vector<EvictionCandidate> candidates;
+    gatherEvictionCandidates(m_textures, candidates);
+    gatherEvictionCandidates(m_tilesTextures, candidates);
+    std::sort(candidates.begin(), candidates.end());
+
+    int evicted = 0;
+    for (unsigned int i = 0; i < candidates.size() && excess > 0; i++) {
+        int used = m_textureBudget.usedBytes();
+        candidates[i].texture->discardGLTexture();
+        excess -= used - m_textureBudget.usedBytes();
+        evicted++;
+    }
+
+    XLOG("Evicted %d of %d candidate textures, %d Mb used, budget %d Mb",
+         evicted, candidates.size(), m_textureBudget.usedBytes() / 1024 / 1024,
+         m_textureBudget.budget() / 1024 / 1024);
+}
+
 void TilesManager::gatherTexturesNumbers(int* nbTextures, int* nbAllocatedTextures,
                                         int* nbLayerTextures, int* nbAllocatedLayerTextures)
 {
@@ -279,6 +473,11 @@ BaseTileTexture* TilesManager::getAvailableTexture(BaseTile* owner)
     //  5. Otherwise, use the least recently prepared tile, but ignoring tiles
     //         drawn in the last frame to avoid flickering
 
+    // Past the budget, unused textures without GL memory are only taken if
+    // no allocated texture can be recycled
+    bool canAllocate = m_textureBudget.canAllocate(tileWidth() * tileHeight() * BYTES_PER_PIXEL);
+    BaseTileTexture* unallocatedTexture = 0;
+
     BaseTileTexture* farthestTexture = 0;
     unsigned long long oldestDrawCount = getDrawGLCount() - 1;
     const unsigned int max = availableTexturePool->size();
@@ -292,6 +491,11 @@ BaseTileTexture* TilesManager::getAvailableTexture(BaseTile* owner)
         }
 
         if (!currentOwner) {
+            if (!canAllocate && !texture->m_ownTextureId) {
+                if (!unallocatedTexture)
+                    unallocatedTexture = texture;
+                continue;
+            }
             // unused texture! take it!
             farthestTexture = texture;
             break;
@@ -318,6 +522,9 @@ BaseTileTexture* TilesManager::getAvailableTexture(BaseTile* owner)
         }
     }
 
+    if (!farthestTexture)
+        farthestTexture = unallocatedTexture;
+
     if (farthestTexture) {
         BaseTile* previousOwner = static_cast<BaseTile*>(farthestTexture->owner());
         if (farthestTexture->acquire(owner)) {
@@ -30,10 +30,14 @@
 
 #include "BaseTile.h"
 #include "BaseTileTexture.h"
+#include "FrameTimings.h"
 #include "ImageTexture.h"
 #include "LayerAndroid.h"
 #include "ShaderProgram.h"
 #include "SkBitmapRef.h"
+#include "TextureAtlas.h"
+#include "TextureBudget.h"
+#include "TexturePool.h"
 #include "TexturesGenerator.h"
 #include "TiledPage.h"
 #include "TilesProfiler.h"
@@ -59,25 +63,36 @@ public:
         return gInstance != 0;
     }
 
-    void removeOperationsForFilter(OperationFilter* filter, bool waitForRunning = false)
-    {
-        m_pixmapsGenerationThread->removeOperationsForFilter(filter, waitForRunning);
-    }
+    void removeOperationsForFilter(OperationFilter* filter, bool waitForRunning = false);
 
     void removeOperationsForPage(TiledPage* page)
     {
-        m_pixmapsGenerationThread->removeOperationsForPage(page);
+        removeOperationsForFilter(new PageFilter(page), true);
     }
 
     void removePaintOperationsForPage(TiledPage* page, bool waitForCompletion)
     {
-        m_pixmapsGenerationThread->removePaintOperationsForPage(page, waitForCompletion);
+        removeOperationsForFilter(new PagePaintFilter(page), waitForCompletion);
     }
 
-    void scheduleOperation(QueuedOperation* operation)
-    {
-        m_pixmapsGenerationThread->scheduleOperation(operation);
-    }
+    void scheduleOperation(QueuedOperation* operation);
+
+    // Called by an idle paint worker, with its own queue locked
+    QueuedOperation* stealOperation(TexturesGenerator* thief);
+
+    // Number of paint workers receiving new operations, at most
+    // maxPaintThreadCount()
+    void setPaintThreadCount(int count);
+    int paintThreadCount() { return m_paintThreadCount; }
+    int maxPaintThreadCount() { return m_textureGenerators.size(); }
+
+    // Tells the paint workers to reorder their queues, as the priorities of
+    // the queued operations changed (e.g. the viewport moved)
+    void reprioritizeOperations();
+    int32_t prioritiesGeneration() { return m_prioritiesGeneration; }
+
+    // Queue depth and latency, summed over all the paint workers
+    OperationQueueStats gatherOperationQueueStats();
 
     void swapLayersTextures(LayerAndroid* newTree, LayerAndroid* oldTree);
     void addPaintedSurface(PaintedSurface* surface);
@@ -85,6 +100,13 @@ public:
     ShaderProgram* shader() { return &m_shader; }
     TransferQueue* transferQueue() { return &m_queue; }
     VideoLayerManager* videoLayerManager() { return &m_videoLayerManager; }
+    TextureBudget* textureBudget() { return &m_textureBudget; }
+    TextureAtlas* textureAtlas() { return &m_textureAtlas; }
+    TexturePool* texturePool() { return &m_texturePool; }
+
+    // Frees the GL memory of the least recently drawn tile textures (across
+    // all the GLWebViewStates) until the budget is met. UI thread only.
+    void enforceTextureBudget();
 
     void gatherLayerTextures();
     void gatherTextures();
@@ -134,6 +156,11 @@ public:
         return &m_profiler;
     }
 
+    FrameTimings* frameTimings()
+    {
+        return &m_frameTimings;
+    }
+
     TilesTracker* getTilesTracker()
     {
         return &m_tilesTracker;
@@ -176,6 +203,24 @@ public:
         return m_useMinimalMemory;
     }
 
+    // Tiles prepared ahead of the scroll, at most TILE_PREFETCH_DISTANCE as
+    // the texture allocation is sized for it
+    void setPrefetchDistance(int distance);
+    int prefetchDistance() { return m_prefetchDistance; }
+
+    // When rastering, layer tiles holding text are still painted by Ganesh,
+    // whose glyphs are drawn from the glyph atlas texture of its GrContext
+    // instead of being rasterized and uploaded along with the tile.
+    void setUseGaneshForLayerText(bool useGanesh)
+    {
+        m_useGaneshForLayerText = useGanesh;
+    }
+
+    bool useGaneshForLayerText()
+    {
+        return m_useGaneshForLayerText;
+    }
+
     void incDrawGLCount()
     {
         m_drawGLCount++;
@@ -197,6 +242,10 @@ private:
     void deallocateTexturesVector(unsigned long long sparedDrawCount,
                                   WTF::Vector<BaseTileTexture*>& textures);
 
+    struct EvictionCandidate;
+    void gatherEvictionCandidates(WTF::Vector<BaseTileTexture*>& textures,
+                                  WTF::Vector<EvictionCandidate>& candidates);
+
     Vector<BaseTileTexture*> m_textures;
     Vector<BaseTileTexture*> m_availableTextures;
 
@@ -216,8 +265,17 @@ private:
     bool m_invertedScreenSwitch;
 
     bool m_useMinimalMemory;
-
-    sp<TexturesGenerator> m_pixmapsGenerationThread;
+    bool m_useGaneshForLayerText;
+    int m_prefetchDistance;
+
+    // The pool of paint workers. Its size is fixed at construction so that
+    // the workers can walk it without locking when stealing operations.
+    Vector<sp<TexturesGenerator> > m_textureGenerators;
+    int m_paintThreadCount;
+    volatile int32_t m_prioritiesGeneration;
+    // Held while removing operations, so that no operation can be stolen
+    // from a worker not yet filtered to one already filtered
+    android::Mutex m_generatorsLock;
 
     android::Mutex m_texturesLock;
 
@@ -227,8 +285,12 @@ private:
     TransferQueue m_queue;
 
     VideoLayerManager m_videoLayerManager;
+    TextureBudget m_textureBudget;
+    TextureAtlas m_textureAtlas;
+    TexturePool m_texturePool;
 
     TilesProfiler m_profiler;
+    FrameTimings m_frameTimings;
     TilesTracker m_tilesTracker;
     unsigned long long m_drawGLCount;
     double m_lastTimeLayersUsed;
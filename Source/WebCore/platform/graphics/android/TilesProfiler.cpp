@@ -29,7 +29,9 @@
 #if USE(ACCELERATED_COMPOSITING)
 
 #include "TilesManager.h"
+#include <algorithm>
 #include <wtf/CurrentTime.h>
+#include <wtf/text/StringBuilder.h>
 
 #ifdef DEBUG
 
@@ -48,12 +50,20 @@
 
 // Hard limit on amount of frames (and thus memory) profiling can take
 #define MAX_PROF_FRAMES 400
+// The summary is much smaller per frame, and covers longer sessions
+#define MAX_SUMMARY_FRAMES 10000
 #define INVAL_CODE -2
 
 namespace WebCore {
 TilesProfiler::TilesProfiler()
     : m_enabled(false)
+    , m_goodTiles(0)
+    , m_badTiles(0)
+    , m_time(0)
+    , m_frameStart(0)
+    , m_missingArea(0)
 {
+    m_viewport.setEmpty();
 }
 
 void TilesProfiler::start()
@@ -63,6 +73,14 @@ void TilesProfiler::start()
     m_badTiles = 0;
     m_records.clear();
     m_time = currentTimeMS();
+    m_frameStart = 0;
+    m_missingArea = 0;
+    m_frameIntervals.clear();
+    m_drawTimes.clear();
+    m_checkerboard.clear();
+    m_tileLatencies.clear();
+    m_textureBytes.clear();
+    m_missingSince.clear();
     XLOG("initializing tileprofiling");
 }
 
@@ -81,13 +99,26 @@ void TilesProfiler::clear()
 
 void TilesProfiler::nextFrame(int left, int top, int right, int bottom, float scale)
 {
-    if (!m_enabled || (m_records.size() > MAX_PROF_FRAMES))
+    if (!m_enabled)
         return;
 
     double currentTime = currentTimeMS();
     double timeDelta = currentTime - m_time;
     m_time = currentTime;
 
+    if (m_frameIntervals.size() < MAX_SUMMARY_FRAMES) {
+        // The first interval is the wait for the first frame, not a frame.
+        if (m_frameStart)
+            m_frameIntervals.append(timeDelta);
+        m_frameStart = currentTime;
+        m_viewport.set(left, top, right, bottom);
+        m_checkerboard.append(0);
+        m_textureBytes.append(TilesManager::instance()->textureBudget()->usedBytes());
+    }
+
+    if (m_records.size() > MAX_PROF_FRAMES)
+        return;
+
 #ifdef DEBUG
     if (m_records.size() != 0) {
         XLOG("completed tile profiling frame, observed %d tiles. %f ms since last",
@@ -105,7 +136,7 @@ void TilesProfiler::nextFrame(int left, int top, int right, int bottom, float sc
 
 void TilesProfiler::nextTile(BaseTile& tile, float scale, bool inView)
 {
-    if (!m_enabled || (m_records.size() > MAX_PROF_FRAMES) || (m_records.size() == 0))
+    if (!m_enabled || !m_frameStart)
         return;
 
     bool isReady = tile.isTileReady();
@@ -119,13 +150,95 @@ void TilesProfiler::nextTile(BaseTile& tile, float scale, bool inView)
             m_goodTiles++;
         else
             m_badTiles++;
+        recordTileSummary(&tile, isReady, SkRect::MakeLTRB(left * scale, top * scale, right * scale, bottom * scale));
     }
+
+    if ((m_records.size() > MAX_PROF_FRAMES) || (m_records.size() == 0))
+        return;
     m_records.last().append(TileProfileRecord(
                                 left, top, right, bottom,
                                 scale, isReady, (int)tile.drawCount()));
     XLOG("adding tile %d %d %d %d, scale %f", left, top, right, bottom, scale);
 }
 
+void TilesProfiler::recordTileSummary(BaseTile* tile, bool isReady, const SkRect& contentRect)
+{
+    if (m_checkerboard.isEmpty() || m_checkerboard.size() > MAX_SUMMARY_FRAMES)
+        return;
+
+    if (isReady) {
+        HashMap<BaseTile*, double>::iterator it = m_missingSince.find(tile);
+        if (it != m_missingSince.end()) {
+            m_tileLatencies.append(m_frameStart - it->second);
+            m_missingSince.remove(it);
+        }
+        return;
+    }
+
+    m_missingSince.add(tile, m_frameStart);
+    SkRect visible = contentRect;
+    if (!visible.intersect(m_viewport))
+        return;
+    float area = visible.width() * visible.height();
+    float viewportArea = m_viewport.width() * m_viewport.height();
+    m_missingArea += area;
+    // The low res page's tiles overlap the others', keep the fraction sane.
+    if (viewportArea > 0)
+        m_checkerboard.last() = std::min(1.0f, m_checkerboard.last() + area / viewportArea);
+}
+
+void TilesProfiler::frameEnded()
+{
+    if (!m_enabled || !m_frameStart || m_drawTimes.size() >= m_checkerboard.size())
+        return;
+    m_drawTimes.append(currentTimeMS() - m_frameStart);
+}
+
+static void appendDistribution(StringBuilder& builder, const char* name, Vector<float> values, float scale)
+{
+    std::sort(values.begin(), values.end());
+    float mean = 0;
+    for (size_t i = 0; i < values.size(); ++i)
+        mean += values[i];
+    if (values.size())
+        mean /= values.size();
+
+    builder.append(String::format("\"%s\":{\"count\":%d", name, static_cast<int>(values.size())));
+    if (values.size()) {
+        static const int percentiles[] = { 50, 90, 95, 99 };
+        for (size_t i = 0; i < sizeof(percentiles) / sizeof(percentiles[0]); ++i) {
+            size_t index = std::min(values.size() - 1, values.size() * percentiles[i] / 100);
+            builder.append(String::format(",\"p%d\":%.2f", percentiles[i], values[index] * scale));
+        }
+        builder.append(String::format(",\"mean\":%.2f,\"max\":%.2f", mean * scale, values.last() * scale));
+    }
+    builder.append("}");
+}
+
+String TilesProfiler::report()
+{
+    Vector<float> textureBytes;
+    for (size_t i = 0; i < m_textureBytes.size(); ++i)
+        textureBytes.append(m_textureBytes[i]);
+
+    StringBuilder builder;
+    builder.append(String::format("{\"frames\":%d,\"readyTileRatio\":%.3f,\"missingTileArea\":%.0f,",
+                                  static_cast<int>(m_checkerboard.size()),
+                                  m_goodTiles + m_badTiles ? (1.0 * m_goodTiles) / (m_goodTiles + m_badTiles) : 1.0,
+                                  m_missingArea));
+    appendDistribution(builder, "frameIntervalMs", m_frameIntervals, 1);
+    builder.append(",");
+    appendDistribution(builder, "drawGLMs", m_drawTimes, 1);
+    builder.append(",");
+    appendDistribution(builder, "checkerboardPercent", m_checkerboard, 100);
+    builder.append(",");
+    appendDistribution(builder, "tileLatencyMs", m_tileLatencies, 1);
+    builder.append(",");
+    appendDistribution(builder, "textureKb", textureBytes, 1.0f / 1024);
+    builder.append(String::format(",\"tilesStillMissing\":%d}", static_cast<int>(m_missingSince.size())));
+    return builder.toString();
+}
+
 void TilesProfiler::nextInval(const IntRect& rect, float scale)
 {
     if (!m_enabled || (m_records.size() > MAX_PROF_FRAMES) || (m_records.size() == 0))
@@ -30,7 +30,10 @@
 
 #include "BaseTile.h"
 #include "IntRect.h"
+#include "SkRect.h"
 #include "Vector.h"
+#include <wtf/HashMap.h>
+#include <wtf/text/WTFString.h>
 
 namespace WebCore {
 
@@ -50,6 +53,12 @@ struct TileProfileRecord {
     float scale;
 };
 
+// Besides the per tile records read back through the WebView tile profiling
+// methods, keeps a summary of the smoothness of the session: frame intervals,
+// drawGL times, how much of the viewport was left without content, how long
+// visible tiles took to get it, and texture memory. The caller drives the
+// scrolling and zooming between start() and stop(), report() formats the
+// summary as JSON. UI thread only.
 class TilesProfiler {
 public:
     TilesProfiler();
@@ -60,6 +69,8 @@ public:
     void nextFrame(int left, int top, int right, int bottom, float scale);
     void nextTile(BaseTile& tile, float scale, bool inView);
     void nextInval(const IntRect& rect, float scale);
+    void frameEnded();
+    String report();
     int numFrames() {
         return m_records.size();
     };
@@ -73,11 +84,25 @@ public:
     }
 
 private:
+    void recordTileSummary(BaseTile*, bool isReady, const SkRect& contentRect);
+
     bool m_enabled;
     unsigned int m_goodTiles;
     unsigned int m_badTiles;
     Vector<Vector<TileProfileRecord> > m_records;
     double m_time;
+
+    // Summary of the session, in ms, fraction of the viewport, and bytes.
+    SkRect m_viewport;
+    double m_frameStart;
+    double m_missingArea;
+    Vector<float> m_frameIntervals;
+    Vector<float> m_drawTimes;
+    Vector<float> m_checkerboard;
+    Vector<float> m_tileLatencies;
+    Vector<int> m_textureBytes;
+    // When each visible tile still waiting for content was first drawn.
+    HashMap<BaseTile*, double> m_missingSince;
 };
 
 } // namespace WebCore
@@ -30,11 +30,14 @@
 
 #include "BaseTile.h"
 #include "PaintedSurface.h"
+#include "TraceEventAndroid.h"
+#include <ETC1/etc1.h>
 #include <android/native_window.h>
 #include <gui/SurfaceTexture.h>
 #include <gui/SurfaceTextureClient.h>
 
 #include <cutils/log.h>
+#include <wtf/CurrentTime.h>
 #include <wtf/text/CString.h>
 #define XLOGC(...) android_printLog(ANDROID_LOG_DEBUG, "TransferQueue", __VA_ARGS__)
 
@@ -67,6 +70,8 @@ TransferQueue::TransferQueue()
     , m_interruptedByRemovingOp(false)
     , m_currentDisplay(EGL_NO_DISPLAY)
     , m_currentUploadType(DEFAULT_UPLOAD_TYPE)
+    , m_tileCompression(false)
+    , m_compressionSupported(false)
 {
     memset(&m_GLStateBeforeBlit, 0, sizeof(m_GLStateBeforeBlit));
 
@@ -105,6 +110,9 @@ void TransferQueue::initSharedSurfaceTextures(int width, int height)
         result = native_window_set_usage(m_ANW.get(),
                 GRALLOC_USAGE_SW_READ_OFTEN | GRALLOC_USAGE_SW_WRITE_OFTEN);
         GLUtils::checkSurfaceTextureError("native_window_set_usage", result);
+
+        android::Mutex::Autolock lock(m_transferQueueItemLocks);
+        m_compressionSupported = GLUtils::isETC1Supported();
     }
 
     if (!m_fboID)
@@ -122,7 +130,8 @@ bool TransferQueue::checkObsolete(int index)
         return true;
     }
 
-    BaseTileTexture* baseTileTexture = baseTilePtr->backTexture();
+    BaseTileTexture* baseTileTexture = m_transferQueue[index].partialUpdate ?
+        baseTilePtr->frontTexture() : baseTilePtr->backTexture();
     if (!baseTileTexture) {
         XLOG("Invalid baseTileTexture , such that the tile is obsolete");
         return true;
@@ -138,12 +147,21 @@ bool TransferQueue::checkObsolete(int index)
         return true;
     }
 
+    // a partial update only applies on top of the content it was painted
+    // against, it must go into the same texture
+    if (m_transferQueue[index].partialUpdate
+        && (baseTileTexture != m_transferQueue[index].savedBaseTileTexturePtr
+            || baseTileTexture->owner() != baseTilePtr)) {
+        XLOG("Front texture changed, such that the partial update is obsolete");
+        return true;
+    }
+
     return false;
 }
 
 void TransferQueue::blitTileFromQueue(GLuint fboID, BaseTileTexture* destTex,
                                       GLuint srcTexId, GLenum srcTexTarget,
-                                      int index)
+                                      int index, const SkIRect* invalRect)
 {
 #if GPU_UPLOAD_WITHOUT_DRAW
     glBindFramebuffer(GL_FRAMEBUFFER, fboID);
@@ -153,9 +171,15 @@ void TransferQueue::blitTileFromQueue(GLuint fboID, BaseTileTexture* destTex,
                            srcTexId,
                            0);
     glBindTexture(GL_TEXTURE_2D, destTex->m_ownTextureId);
-    glCopyTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 0, 0,
-                        destTex->getSize().width(),
-                        destTex->getSize().height());
+    if (invalRect) {
+        // the partial content is at the origin of the surface texture buffer
+        glCopyTexSubImage2D(GL_TEXTURE_2D, 0, invalRect->fLeft, invalRect->fTop,
+                            0, 0, invalRect->width(), invalRect->height());
+    } else {
+        glCopyTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 0, 0,
+                            destTex->getSize().width(),
+                            destTex->getSize().height());
+    }
 #else
     // Then set up the FBO and copy the SurfTex content in.
     glBindFramebuffer(GL_FRAMEBUFFER, fboID);
@@ -218,7 +242,9 @@ bool TransferQueue::readyForUpdate()
     if (!m_emptyItemCount) {
         if (m_interruptedByRemovingOp)
             return false;
+        double waitStart = currentTime();
         m_transferQueueItemCond.wait(m_transferQueueItemLocks);
+        TilesManager::instance()->frameTimings()->transferQueueWaited(currentTime() - waitStart);
         if (m_interruptedByRemovingOp)
             return false;
     }
@@ -278,6 +304,7 @@ void TransferQueue::discardQueue()
 // Call on UI thread to copy from the shared Surface Texture to the BaseTile's texture.
 void TransferQueue::updateDirtyBaseTiles()
 {
+    ANDROID_TRACE_EVENT("compositor", "TransferQueue::updateDirtyBaseTiles");
     android::Mutex::Autolock lock(m_transferQueueItemLocks);
 
     cleanupTransportQueue();
@@ -289,14 +316,17 @@ void TransferQueue::updateDirtyBaseTiles()
     const int nextItemIndex = getNextTransferQueueIndex();
     int index = nextItemIndex;
     bool usedFboForUpload = false;
+    int uploadedBytes = 0;
     for (int k = 0; k < ST_BUFFER_NUMBER ; k++) {
         if (m_transferQueue[index].status == pendingBlit) {
             bool obsoleteBaseTile = checkObsolete(index);
             // Save the needed info, update the Surf Tex, clean up the item in
             // the queue. Then either move on to next item or copy the content.
             BaseTileTexture* destTexture = 0;
+            BaseTile* baseTile = m_transferQueue[index].savedBaseTilePtr;
+            bool partialUpdate = m_transferQueue[index].partialUpdate;
             if (!obsoleteBaseTile)
-                destTexture = m_transferQueue[index].savedBaseTilePtr->backTexture();
+                destTexture = partialUpdate ? baseTile->frontTexture() : baseTile->backTexture();
             if (m_transferQueue[index].uploadType == GpuUpload) {
                 status_t result = m_sharedSurfaceTexture->updateTexImage();
                 if (result != OK)
@@ -304,20 +334,53 @@ void TransferQueue::updateDirtyBaseTiles()
             }
             m_transferQueue[index].savedBaseTilePtr = 0;
             m_transferQueue[index].status = emptyItem;
+            // content painted directly lives in the buffer of the texture
+            // it was painted into, it can't be moved to another texture
+            if (!obsoleteBaseTile && m_transferQueue[index].uploadType == DirectUpload
+                && destTexture != m_transferQueue[index].savedBaseTileTexturePtr)
+                obsoleteBaseTile = true;
             if (obsoleteBaseTile) {
                 XLOG("Warning: the texture is obsolete for this baseTile");
                 index = (index + 1) % ST_BUFFER_NUMBER;
                 continue;
             }
 
-            // guarantee that we have a texture to blit into
-            destTexture->requireGLTexture();
+            if (m_transferQueue[index].uploadType == CompressedUpload) {
+                // the compressed content becomes the whole texture storage
+                const WTF::Vector<uint8_t>& data = m_transferQueue[index].compressedData;
+                if (!destTexture->setCompressedContent(data.data(), data.size())) {
+                    baseTile->backTextureTransferFail();
+                    index = (index + 1) % ST_BUFFER_NUMBER;
+                    continue;
+                }
+                uploadedBytes += data.size();
+            } else if (!destTexture->requireGLTexture()) {
+                // guarantee that we have a texture to blit into
+                // out of memory, the tile will be painted again once the
+                // budget evicted other textures
+                baseTile->backTextureTransferFail();
+                index = (index + 1) % ST_BUFFER_NUMBER;
+                continue;
+            }
 
             if (m_transferQueue[index].uploadType == CpuUpload) {
                 // Here we just need to upload the bitmap content to the GL Texture
-                GLUtils::updateTextureWithBitmap(destTexture->m_ownTextureId, 0, 0,
+                const SkIRect& rect = m_transferQueue[index].invalRect;
+                GLUtils::updateTextureWithBitmap(destTexture->m_ownTextureId,
+                                                 partialUpdate ? rect.fLeft : 0,
+                                                 partialUpdate ? rect.fTop : 0,
                                                  *m_transferQueue[index].bitmap);
-            } else {
+                uploadedBytes += m_transferQueue[index].bitmap->getSize();
+            } else if (m_transferQueue[index].uploadType == DirectUpload) {
+                // The content is already in the texture's buffer, just
+                // (re)attach it as the texture storage
+                if (!destTexture->bindDirectBuffer()) {
+                    XLOGC("unexpected error: failed binding direct buffer of %p", destTexture);
+                    baseTile->backTextureTransferFail();
+                    index = (index + 1) % ST_BUFFER_NUMBER;
+                    continue;
+                }
+            } else if (m_transferQueue[index].uploadType == GpuUpload) {
                 if (!usedFboForUpload) {
                     saveGLState();
                     usedFboForUpload = true;
@@ -325,7 +388,11 @@ void TransferQueue::updateDirtyBaseTiles()
                 blitTileFromQueue(m_fboID, destTexture,
                                   m_sharedSurfaceTextureId,
                                   m_sharedSurfaceTexture->getCurrentTextureTarget(),
-                                  index);
+                                  index,
+                                  partialUpdate ? &m_transferQueue[index].invalRect : 0);
+                const SkIRect& rect = m_transferQueue[index].invalRect;
+                uploadedBytes += partialUpdate ? rect.width() * rect.height() * 4
+                    : TilesManager::tileWidth() * TilesManager::tileHeight() * 4;
             }
 
             // After the base tile copied into the GL texture, we need to
@@ -353,6 +420,9 @@ void TransferQueue::updateDirtyBaseTiles()
         GLUtils::checkGlError("updateDirtyBaseTiles");
     }
 
+    // direct uploads don't copy anything, the tile was painted in place
+    TilesManager::instance()->frameTimings()->bytesUploaded(uploadedBytes);
+
     m_emptyItemCount = ST_BUFFER_NUMBER;
     m_transferQueueItemCond.signal();
 }
@@ -360,7 +430,14 @@ void TransferQueue::updateDirtyBaseTiles()
 void TransferQueue::updateQueueWithBitmap(const TileRenderInfo* renderInfo,
                                           int x, int y, const SkBitmap& bitmap)
 {
-    if (!tryUpdateQueueWithBitmap(renderInfo, x, y, bitmap)) {
+    ANDROID_TRACE_EVENT("compositor", "TransferQueue::updateQueueWithBitmap");
+    bool inserted;
+    if (canCompress(renderInfo, x, y, bitmap))
+        inserted = tryUpdateQueueWithCompressedBitmap(renderInfo, bitmap);
+    else
+        inserted = tryUpdateQueueWithBitmap(renderInfo, x, y, bitmap);
+
+    if (!inserted) {
         // failed placing bitmap in queue, discard tile's texture so it will be
         // re-enqueued (and repainted)
         BaseTile* tile = renderInfo->baseTile;
@@ -369,13 +446,89 @@ void TransferQueue::updateQueueWithBitmap(const TileRenderInfo* renderInfo,
     }
 }
 
+void TransferQueue::updateQueueWithDirectBuffer(const TileRenderInfo* renderInfo)
+{
+    android::Mutex::Autolock producerLock(m_producerLock);
+
+    m_transferQueueItemLocks.lock();
+    bool ready = readyForUpdate();
+    if (ready)
+        addItemInTransferQueue(renderInfo, DirectUpload, 0);
+    m_transferQueueItemLocks.unlock();
+
+    if (!ready) {
+        XLOG("Quit direct buffer update: not ready! for tile x y %d %d",
+             renderInfo->x, renderInfo->y);
+        BaseTile* tile = renderInfo->baseTile;
+        if (tile)
+            tile->backTextureTransferFail();
+    }
+}
+
+bool TransferQueue::canCompress(const TileRenderInfo* renderInfo, int x, int y,
+                                const SkBitmap& bitmap)
+{
+    {
+        android::Mutex::Autolock lock(m_transferQueueItemLocks);
+        if (!m_tileCompression || !m_compressionSupported)
+            return false;
+    }
+
+    // the compressed content replaces the whole texture storage
+    if (renderInfo->partialUpdate || x || y || !renderInfo->tileTexture
+        || !renderInfo->tileTexture->getSize().equals(bitmap.width(), bitmap.height()))
+        return false;
+
+    // tiles with transparency or text would look wrong
+    return GLUtils::canEncodeWithETC1(bitmap);
+}
+
+bool TransferQueue::tryUpdateQueueWithCompressedBitmap(const TileRenderInfo* renderInfo,
+                                                       const SkBitmap& bitmap)
+{
+    // Encode before waiting for the other paint workers, this is the
+    // expensive part
+    WTF::Vector<uint8_t> data(etc1_get_encoded_data_size(bitmap.width(), bitmap.height()));
+    if (!GLUtils::encodeWithETC1(bitmap, data.data())) {
+        XLOG("ETC1 encoding failed for tile x y %d %d", renderInfo->x, renderInfo->y);
+        return tryUpdateQueueWithBitmap(renderInfo, 0, 0, bitmap);
+    }
+
+    android::Mutex::Autolock producerLock(m_producerLock);
+
+    m_transferQueueItemLocks.lock();
+    bool ready = readyForUpdate();
+    if (ready) {
+        addItemInTransferQueue(renderInfo, CompressedUpload, 0);
+        m_transferQueue[m_transferQueueIndex].compressedData.swap(data);
+    }
+    m_transferQueueItemLocks.unlock();
+
+    if (!ready) {
+        XLOG("Quit compressed bitmap update: not ready! for tile x y %d %d",
+             renderInfo->x, renderInfo->y);
+        return false;
+    }
+    return true;
+}
+
 bool TransferQueue::tryUpdateQueueWithBitmap(const TileRenderInfo* renderInfo,
                                           int x, int y, const SkBitmap& bitmap)
 {
+    android::Mutex::Autolock producerLock(m_producerLock);
+
     m_transferQueueItemLocks.lock();
     bool ready = readyForUpdate();
     TextureUploadType currentUploadType = m_currentUploadType;
     m_transferQueueItemLocks.unlock();
+    // the tile wasn't painted directly (e.g. the mode was switched while
+    // painting), go through the surface texture
+    if (currentUploadType == DirectUpload)
+        currentUploadType = GpuUpload;
+    // the surface texture is connected to Ganesh's EGL surface, the tiles
+    // painted by the raster fallback can't lock it
+    if (currentUploadType == GpuUpload && m_eglSurface != EGL_NO_SURFACE)
+        currentUploadType = CpuUpload;
     if (!ready) {
         XLOG("Quit bitmap update: not ready! for tile x y %d %d",
              renderInfo->x, renderInfo->y);
@@ -397,7 +550,23 @@ bool TransferQueue::tryUpdateQueueWithBitmap(const TileRenderInfo* renderInfo,
         int bpp = 4; // Now we only deal with RGBA8888 format.
         int width = TilesManager::instance()->tileWidth();
         int height = TilesManager::instance()->tileHeight();
-        if (!x && !y && bitmap.width() == width && bitmap.height() == height) {
+        if (renderInfo->partialUpdate) {
+            // The renderer painted the inval rect at the origin of the
+            // bitmap, copy it at the origin of the buffer, it will be moved
+            // in place when blitting into the tile texture.
+            int copyWidth = std::min(renderInfo->invalRect->width(),
+                                     std::min(bitmap.width(), buffer.width));
+            int copyHeight = std::min(renderInfo->invalRect->height(),
+                                      std::min(bitmap.height(), buffer.height));
+            bitmap.lockPixels();
+            uint8_t* bitmapOrigin = static_cast<uint8_t*>(bitmap.getPixels());
+            for (row = 0; row < copyHeight; row++) {
+                uint8_t* dst = &(img[buffer.stride * row * bpp]);
+                uint8_t* src = &(bitmapOrigin[bitmap.rowBytes() * row]);
+                memcpy(dst, src, bpp * copyWidth);
+            }
+            bitmap.unlockPixels();
+        } else if (!x && !y && bitmap.width() == width && bitmap.height() == height) {
             bitmap.lockPixels();
             uint8_t* bitmapOrigin = static_cast<uint8_t*>(bitmap.getPixels());
             if (buffer.stride != bitmap.width())
@@ -443,11 +612,27 @@ void TransferQueue::addItemInTransferQueue(const TileRenderInfo* renderInfo,
         XLOG("ERROR update a tile which is dirty already @ index %d", index);
     }
 
-    m_transferQueue[index].savedBaseTileTexturePtr = renderInfo->baseTile->backTexture();
+    bool partialUpdate = renderInfo->partialUpdate;
+    m_transferQueue[index].savedBaseTileTexturePtr = partialUpdate ?
+        renderInfo->tileTexture : renderInfo->baseTile->backTexture();
     m_transferQueue[index].savedBaseTilePtr = renderInfo->baseTile;
     m_transferQueue[index].status = pendingBlit;
     m_transferQueue[index].uploadType = type;
-    if (type == CpuUpload && bitmap) {
+    if (type != CompressedUpload)
+        m_transferQueue[index].compressedData.clear();
+    m_transferQueue[index].partialUpdate = partialUpdate;
+    if (partialUpdate)
+        m_transferQueue[index].invalRect = *renderInfo->invalRect;
+    if (type == CpuUpload && bitmap && partialUpdate) {
+        // only keep the inval rect, painted at the origin of the bitmap
+        SkBitmap subset;
+        SkIRect rect = SkIRect::MakeWH(renderInfo->invalRect->width(),
+                                       renderInfo->invalRect->height());
+        if (!m_transferQueue[index].bitmap)
+            m_transferQueue[index].bitmap = new SkBitmap();
+        if (bitmap->extractSubset(&subset, rect))
+            subset.copyTo(m_transferQueue[index].bitmap, bitmap->config());
+    } else if (type == CpuUpload && bitmap) {
         // Lazily create the bitmap
         if (!m_transferQueue[index].bitmap) {
             m_transferQueue[index].bitmap = new SkBitmap();
@@ -484,7 +669,38 @@ void TransferQueue::setTextureUploadType(TextureUploadType type)
 #else
     m_currentUploadType = type;
 #endif
-    XLOGC("Now we set the upload to %s", m_currentUploadType == GpuUpload ? "GpuUpload" : "CpuUpload");
+    XLOGC("Now we set the upload to %s", m_currentUploadType == GpuUpload ? "GpuUpload"
+          : (m_currentUploadType == DirectUpload ? "DirectUpload" : "CpuUpload"));
+}
+
+TextureUploadType TransferQueue::textureUploadType()
+{
+    android::Mutex::Autolock lock(m_transferQueueItemLocks);
+    return m_currentUploadType;
+}
+
+void TransferQueue::setTileCompression(bool enabled)
+{
+    android::Mutex::Autolock lock(m_transferQueueItemLocks);
+    m_tileCompression = enabled;
+    XLOGC("Tile compression %s", enabled ? "enabled" : "disabled");
+}
+
+bool TransferQueue::tileCompression()
+{
+    android::Mutex::Autolock lock(m_transferQueueItemLocks);
+    return m_tileCompression;
+}
+
+bool TransferQueue::supportsPartialUpdate()
+{
+#if GPU_UPLOAD_WITHOUT_DRAW
+    // The content painted directly goes into the whole texture storage, and
+    // drawing the surface texture into the FBO can only cover the whole tile.
+    return textureUploadType() != DirectUpload;
+#else
+    return false;
+#endif
 }
 
 // Note: this need to be called within th lock.
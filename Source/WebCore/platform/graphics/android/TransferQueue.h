@@ -32,6 +32,7 @@
 #include "BaseTileTexture.h"
 #include "ShaderProgram.h"
 #include "TiledPage.h"
+#include <wtf/Vector.h>
 
 namespace WebCore {
 
@@ -60,7 +61,14 @@ enum TransferItemStatus {
 
 enum TextureUploadType {
     CpuUpload = 0,
-    GpuUpload = 1
+    GpuUpload = 1,
+    // The tile is painted straight into a graphic buffer owned by its
+    // BaseTileTexture, which is then bound as the texture storage: no copy
+    // into the shared surface texture, and no blit into the tile texture.
+    DirectUpload = 2,
+    // Only used for the queue items: the tile was encoded into ETC1 by the
+    // producer, and compressedData replaces the storage of the tile texture.
+    CompressedUpload = 3
 };
 
 #ifdef FORCE_CPU_UPLOAD
@@ -75,6 +83,7 @@ public:
     , savedBaseTilePtr(0)
     , savedBaseTileTexturePtr(0)
     , uploadType(DEFAULT_UPLOAD_TYPE)
+    , partialUpdate(false)
     , bitmap(0)
     , m_syncKHR(EGL_NO_SYNC_KHR)
     {
@@ -91,9 +100,15 @@ public:
     BaseTileTexture* savedBaseTileTexturePtr;
     TextureTileInfo tileInfo;
     TextureUploadType uploadType;
+    // If set, only invalRect of the front texture of the tile is updated
+    // with the content, instead of the whole back texture.
+    bool partialUpdate;
+    SkIRect invalRect;
     // This is only useful in Cpu upload code path, so it will be dynamically
     // lazily allocated.
     SkBitmap* bitmap;
+    // Only used for CompressedUpload items
+    WTF::Vector<uint8_t> compressedData;
 
     // Sync object for GPU fence, this is the only the info passed from UI
     // thread to Tex Gen thread. The reason of having this is due to the
@@ -112,6 +127,16 @@ public:
 
     // This will be called by the browser through nativeSetProperty
     void setTextureUploadType(TextureUploadType type);
+    TextureUploadType textureUploadType();
+
+    // true if tiles can be painted partially, in place in their front texture
+    bool supportsPartialUpdate();
+
+    // When enabled, the tiles suitable for it are uploaded as ETC1 textures,
+    // trading some tile quality and paint time for texture memory.
+    // This will be called by the browser through nativeSetProperty
+    void setTileCompression(bool enabled);
+    bool tileCompression();
 
     void updateDirtyBaseTiles();
 
@@ -121,6 +146,10 @@ public:
     void updateQueueWithBitmap(const TileRenderInfo* renderInfo, int x, int y,
                                const SkBitmap& bitmap);
 
+    // insert a tile painted in its texture's direct buffer into the queue,
+    // mark the tile dirty if failing
+    void updateQueueWithDirectBuffer(const TileRenderInfo* renderInfo);
+
     void discardQueue();
 
     void addItemInTransferQueue(const TileRenderInfo* info,
@@ -148,6 +177,11 @@ private:
     // return true if successfully inserted into queue
     bool tryUpdateQueueWithBitmap(const TileRenderInfo* renderInfo, int x, int y,
                                   const SkBitmap& bitmap);
+    bool tryUpdateQueueWithCompressedBitmap(const TileRenderInfo* renderInfo,
+                                            const SkBitmap& bitmap);
+    // true if the bitmap can be uploaded as a compressed texture
+    bool canCompress(const TileRenderInfo* renderInfo, int x, int y,
+                     const SkBitmap& bitmap);
     bool getHasGLContext();
     void setHasGLContext(bool hasContext);
 
@@ -167,7 +201,7 @@ private:
 
     void blitTileFromQueue(GLuint fboID, BaseTileTexture* destTex,
                            GLuint srcTexId, GLenum srcTexTarget,
-                           int index);
+                           int index, const SkIRect* invalRect = 0);
 
     // Note that the m_transferQueueIndex only changed in the TexGen thread
     // where we are going to move on to update the next item in the queue.
@@ -199,11 +233,21 @@ private:
     android::Mutex m_transferQueueItemLocks;
     android::Condition m_transferQueueItemCond;
 
+    // Serializes the paint workers while they write into the shared surface
+    // texture: items have to be added to the queue in the same order as the
+    // buffers are posted.
+    android::Mutex m_producerLock;
+
     EGLDisplay m_currentDisplay;
 
     // This should be GpuUpload for production, but for debug purpose or working
     // around driver/HW issue, we can set it to CpuUpload.
     TextureUploadType m_currentUploadType;
+
+    // Set through setTileCompression(), only effective if the GL driver
+    // supports ETC1 textures
+    bool m_tileCompression;
+    bool m_compressionSupported;
 };
 
 } // namespace WebCore
@@ -74,31 +74,38 @@ void TreeManager::swap()
     // swap can't be called unless painting just finished
     ASSERT(m_paintingTree);
 
-    android::Mutex::Autolock lock(m_paintSwapLock);
+    Layer* discardedTree = 0;
+    {
+        android::Mutex::Autolock lock(m_paintSwapLock);
 
-    XLOG("SWAPPING, D %p, P %p, Q %p", m_drawingTree, m_paintingTree, m_queuedTree);
+        XLOG("SWAPPING, D %p, P %p, Q %p", m_drawingTree, m_paintingTree, m_queuedTree);
 
-    // if we have a drawing tree, discard it since the painting tree is done
-    if (m_drawingTree) {
-        XLOG("destroying drawing tree %p", m_drawingTree);
-        m_drawingTree->setIsDrawing(false);
-        SkSafeUnref(m_drawingTree);
-    }
+        // if we have a drawing tree, discard it since the painting tree is done
+        if (m_drawingTree) {
+            XLOG("destroying drawing tree %p", m_drawingTree);
+            m_drawingTree->setIsDrawing(false);
+            discardedTree = m_drawingTree;
+        }
 
-    // painting tree becomes the drawing tree
-    XLOG("drawing tree %p", m_paintingTree);
-    m_paintingTree->setIsDrawing(true);
-    if (m_paintingTree->countChildren())
-        static_cast<LayerAndroid*>(m_paintingTree->getChild(0))->initAnimations();
+        // painting tree becomes the drawing tree
+        XLOG("drawing tree %p", m_paintingTree);
+        m_paintingTree->setIsDrawing(true);
+        if (m_paintingTree->countChildren())
+            static_cast<LayerAndroid*>(m_paintingTree->getChild(0))->initAnimations();
 
-    if (m_queuedTree) {
-        // start painting with the queued tree
-        XLOG("now painting tree %p", m_queuedTree);
-        m_queuedTree->setIsPainting(m_paintingTree);
+        if (m_queuedTree) {
+            // start painting with the queued tree
+            XLOG("now painting tree %p", m_queuedTree);
+            m_queuedTree->setIsPainting(m_paintingTree);
+        }
+        m_drawingTree = m_paintingTree;
+        m_paintingTree = m_queuedTree;
+        m_queuedTree = 0;
     }
-    m_drawingTree = m_paintingTree;
-    m_paintingTree = m_queuedTree;
-    m_queuedTree = 0;
+
+    // the texture generators ref the tree they paint, so the old drawing tree
+    // can be destroyed without holding up their access to the new trees
+    SkSafeUnref(discardedTree);
 
     TilesManager::instance()->paintedSurfacesCleanup();
 
@@ -145,37 +152,42 @@ void TreeManager::updateWithTree(Layer* newTree, bool brandNew)
 
     SkSafeRef(newTree);
 
-    android::Mutex::Autolock lock(m_paintSwapLock);
+    Layer* discardedTree = 0;
+    {
+        android::Mutex::Autolock lock(m_paintSwapLock);
+
+        if (!newTree || brandNew) {
+            clearTrees();
+            if (brandNew) {
+                m_paintingTree = newTree;
+                m_paintingTree->setIsPainting(m_drawingTree);
+            }
+            return;
+        }
 
-    if (!newTree || brandNew) {
-        clearTrees();
-        if (brandNew) {
+        if (m_queuedTree || m_paintingTree) {
+            // currently painting, so defer this new tree
+            if (m_queuedTree) {
+                // have a queued tree, copy over invals so the regions are
+                // eventually repainted
+                m_queuedTree->mergeInvalsInto(newTree);
+
+                XLOG("DISCARDING tree - %p, has children %d, has animations %d",
+                     newTree, newTree && newTree->countChildren(),
+                     newTree && newTree->countChildren()
+                         ? static_cast<LayerAndroid*>(newTree->getChild(0))->hasAnimations() : 0);
+            }
+            discardedTree = m_queuedTree;
+            m_queuedTree = newTree;
+        } else {
+            // don't have painting tree, paint this one!
             m_paintingTree = newTree;
             m_paintingTree->setIsPainting(m_drawingTree);
         }
-        return;
-    }
-
-    if (m_queuedTree || m_paintingTree) {
-        // currently painting, so defer this new tree
-        if (m_queuedTree) {
-            // have a queued tree, copy over invals so the regions are
-            // eventually repainted
-            m_queuedTree->mergeInvalsInto(newTree);
-
-            XLOG("DISCARDING tree - %p, has children %d, has animations %d",
-                 newTree, newTree && newTree->countChildren(),
-                 newTree && newTree->countChildren()
-                     ? static_cast<LayerAndroid*>(newTree->getChild(0))->hasAnimations() : 0);
-        }
-        SkSafeUnref(m_queuedTree);
-        m_queuedTree = newTree;
-        return;
     }
 
-    // don't have painting tree, paint this one!
-    m_paintingTree = newTree;
-    m_paintingTree->setIsPainting(m_drawingTree);
+    // a queued tree is never painted, so it is released outside of the lock
+    SkSafeUnref(discardedTree);
 }
 
 void TreeManager::updateScrollableLayerInTree(Layer* tree, int layerId, int x, int y)
@@ -70,6 +70,7 @@ VideoLayerAndroid::VideoLayerAndroid(const VideoLayerAndroid& layer)
     : LayerAndroid(layer)
 {
     init();
+    m_frameTimestamp = layer.m_frameTimestamp;
 }
 
 void VideoLayerAndroid::init()
@@ -77,6 +78,7 @@ void VideoLayerAndroid::init()
     // m_surfaceTexture is only useful on UI thread, no need to copy.
     // And it will be set at setBaseLayer timeframe
     m_playerState = INITIALIZED;
+    m_frameTimestamp = 0;
 }
 
 // We can use this function to set the Layer to point to surface texture.
@@ -178,6 +180,12 @@ static bool calculateInnerRectBounds(const SkRect& boundsRect, SkRect& innerRect
     return false;
 }
 
+bool VideoLayerAndroid::hasOpaqueContent()
+{
+    return (m_playerState == PLAYING || m_playerState == BUFFERING)
+        && m_surfaceTexture.get();
+}
+
 bool VideoLayerAndroid::drawGL()
 {
     // Lazily allocated the textures.
@@ -207,6 +215,11 @@ bool VideoLayerAndroid::drawGL()
         // Show the real video.
         m_surfaceTexture->updateTexImage();
         m_surfaceTexture->getTransformMatrix(surfaceMatrix);
+        int64_t timestamp = m_surfaceTexture->getTimestamp();
+        if (timestamp != m_frameTimestamp) {
+            m_frameTimestamp = timestamp;
+            TilesManager::instance()->frameTimings()->videoFrameDrawn();
+        }
         GLuint textureId =
             TilesManager::instance()->videoLayerManager()->getTextureId(uniqueId());
         TilesManager::instance()->shader()->drawVideoLayerQuad(m_drawTransform,
@@ -57,6 +57,8 @@ public:
 
     // The following 3 functions are called in UI thread only.
     virtual bool drawGL();
+    // the video frames are drawn opaque over the whole layer
+    virtual bool hasOpaqueContent();
     void setSurfaceTexture(sp<SurfaceTexture> texture, int textureName, PlayerState playerState);
     GLuint createBackgroundTexture();
     GLuint createSpinnerOuterTexture();
@@ -73,6 +75,9 @@ private:
 
     PlayerState m_playerState;
 
+    // timestamp of the last frame composited, to count the new ones
+    int64_t m_frameTimestamp;
+
     // Texture for showing the static image will be created at native side.
     static bool m_createdTexture;
     static GLuint m_backgroundTextureId;
@@ -246,6 +246,23 @@ FloatRect Path::strokeBoundingRect(StrokeStyleApplier* applier) const
     return r;
 }
 
+Path Path::strokeOutline(StrokeStyleApplier* applier) const
+{
+    GraphicsContext* scratch = scratchContext();
+    scratch->save();
+
+    if (applier)
+        applier->strokeStyle(scratch);
+
+    SkPaint paint;
+    scratch->platformContext()->setupPaintForStroking(&paint, 0, 0);
+    Path outline;
+    paint.getFillPath(*platformPath(), outline.platformPath());
+
+    scratch->restore();
+    return outline;
+}
+
 bool Path::strokeContains(StrokeStyleApplier* applier, const FloatPoint& point) const
 {
     ASSERT(applier);
@@ -27,6 +27,10 @@
 #include <algorithm>
 #include <cmath>
 
+#if CPU(ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 #include "BMPImageDecoder.h"
 #include "GIFImageDecoder.h"
 #include "ICOImageDecoder.h"
@@ -243,6 +247,66 @@ int ImageFrame::height() const
 
 #endif
 
+// Skia on Android packs pixels as R, G, B, A bytes in memory, which is
+// exactly what the NEON interleaved stores below write.
+#if CPU(ARM_NEON) && USE(SKIA) && SK_R32_SHIFT == 0 && SK_G32_SHIFT == 8 && SK_B32_SHIFT == 16 && SK_A32_SHIFT == 24
+#define NEON_ROW_CONVERSION 1
+#endif
+
+void ImageFrame::setRGBRow(int y, const unsigned char* rgb, int width)
+{
+    PixelData* dest = getAddr(0, y);
+    int x = 0;
+#if NEON_ROW_CONVERSION
+    uint8x8x4_t pixels;
+    pixels.val[3] = vdup_n_u8(0xFF);
+    for (; x + 8 <= width; x += 8) {
+        uint8x8x3_t source = vld3_u8(rgb + x * 3);
+        pixels.val[0] = source.val[0];
+        pixels.val[1] = source.val[1];
+        pixels.val[2] = source.val[2];
+        vst4_u8(reinterpret_cast<uint8_t*>(dest + x), pixels);
+    }
+#endif
+    for (; x < width; ++x) {
+        const unsigned char* pixel = rgb + x * 3;
+        setRGBA(dest + x, pixel[0], pixel[1], pixel[2], 0xFF);
+    }
+}
+
+bool ImageFrame::setRGBARow(int y, const unsigned char* rgba, int width)
+{
+    PixelData* dest = getAddr(0, y);
+    unsigned minAlpha = 0xFF;
+    int x = 0;
+#if NEON_ROW_CONVERSION
+    uint8x8_t minAlphas = vdup_n_u8(0xFF);
+    for (; x + 8 <= width; x += 8) {
+        uint8x8x4_t pixels = vld4_u8(rgba + x * 4);
+        uint8x8_t alpha = pixels.val[3];
+        minAlphas = vmin_u8(minAlphas, alpha);
+        if (m_premultiplyAlpha) {
+            // Same rounding as premultiplyChannel(), eight pixels at a time.
+            for (int channel = 0; channel < 3; ++channel) {
+                uint16x8_t product = vmlal_u8(vdupq_n_u16(128), pixels.val[channel], alpha);
+                pixels.val[channel] = vaddhn_u16(product, vshrq_n_u16(product, 8));
+            }
+        }
+        vst4_u8(reinterpret_cast<uint8_t*>(dest + x), pixels);
+    }
+    minAlphas = vpmin_u8(minAlphas, minAlphas);
+    minAlphas = vpmin_u8(minAlphas, minAlphas);
+    minAlphas = vpmin_u8(minAlphas, minAlphas);
+    minAlpha = vget_lane_u8(minAlphas, 0);
+#endif
+    for (; x < width; ++x) {
+        const unsigned char* pixel = rgba + x * 4;
+        setRGBA(dest + x, pixel[0], pixel[1], pixel[2], pixel[3]);
+        minAlpha = std::min<unsigned>(minAlpha, pixel[3]);
+    }
+    return minAlpha < 0xFF;
+}
+
 namespace {
 
 enum MatchType {
@@ -142,11 +142,24 @@ namespace WebCore {
             setRGBA(getAddr(x, y), r, g, b, a);
         }
 
+        // Write the first |width| pixels of row |y| from packed 8-bit RGB
+        // triplets (always opaque) or RGBA quads. The RGBA version returns
+        // whether any pixel was not fully opaque.
+        void setRGBRow(int y, const unsigned char* rgb, int width);
+        bool setRGBARow(int y, const unsigned char* rgba, int width);
+
 #if PLATFORM(QT)
         void setPixmap(const QPixmap& pixmap);
 #endif
 
     private:
+        // Rounds c * a / 255 exactly, without a division.
+        static inline unsigned premultiplyChannel(unsigned c, unsigned a)
+        {
+            unsigned product = c * a + 128;
+            return (product + (product >> 8)) >> 8;
+        }
+
 #if USE(CG)
         typedef RetainPtr<CFMutableDataRef> NativeBackingStore;
 #else
@@ -175,10 +188,9 @@ namespace WebCore {
                 *dest = 0;
             else {
                 if (m_premultiplyAlpha && a < 255) {
-                    float alphaPercent = a / 255.0f;
-                    r = static_cast<unsigned>(r * alphaPercent);
-                    g = static_cast<unsigned>(g * alphaPercent);
-                    b = static_cast<unsigned>(b * alphaPercent);
+                    r = premultiplyChannel(r, a);
+                    g = premultiplyChannel(g, a);
+                    b = premultiplyChannel(b, a);
                 }
 #if USE(SKIA)
                 // we are sure to call the NoCheck version, since we may
@@ -486,6 +486,10 @@ bool JPEGImageDecoder::outputScanlines()
         if (destY < 0)
             continue;
         int width = m_scaled ? m_scaledColumns.size() : info->output_width;
+        if (!m_scaled && info->out_color_space == JCS_RGB) {
+            buffer.setRGBRow(destY, *samples, width);
+            continue;
+        }
         for (int x = 0; x < width; ++x) {
             JSAMPLE* jsample = *samples + (m_scaled ? m_scaledColumns[x] : x) * ((info->out_color_space == JCS_RGB) ? 3 : 4);
             if (info->out_color_space == JCS_RGB)
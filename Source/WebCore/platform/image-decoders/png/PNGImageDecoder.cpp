@@ -402,12 +402,17 @@ void PNGImageDecoder::rowAvailable(unsigned char* rowBuffer, unsigned rowIndex,
     if (destY < 0 || destY >= scaledSize().height())
         return;
     bool nonTrivialAlpha = false;
-    for (int x = 0; x < width; ++x) {
-        png_bytep pixel = row + (m_scaled ? m_scaledColumns[x] : x) * colorChannels;
-        unsigned alpha = hasAlpha ? pixel[3] : 255;
-        buffer.setRGBA(x, destY, pixel[0], pixel[1], pixel[2], alpha);
-        nonTrivialAlpha |= alpha < 255;
-    }
+    if (m_scaled) {
+        for (int x = 0; x < width; ++x) {
+            png_bytep pixel = row + m_scaledColumns[x] * colorChannels;
+            unsigned alpha = hasAlpha ? pixel[3] : 255;
+            buffer.setRGBA(x, destY, pixel[0], pixel[1], pixel[2], alpha);
+            nonTrivialAlpha |= alpha < 255;
+        }
+    } else if (hasAlpha)
+        nonTrivialAlpha = buffer.setRGBARow(destY, row, width);
+    else
+        buffer.setRGBRow(destY, row, width);
     if (nonTrivialAlpha && !buffer.hasAlpha())
         buffer.setHasAlpha(nonTrivialAlpha);
 }
@@ -31,9 +31,12 @@
 #include "LevelDBComparator.h"
 #include "LevelDBIterator.h"
 #include "LevelDBSlice.h"
+#include "LevelDBWriteBatch.h"
 #include <leveldb/comparator.h>
 #include <leveldb/db.h>
+#include <leveldb/iterator.h>
 #include <leveldb/slice.h>
+#include <leveldb/write_batch.h>
 #include <string>
 #include <wtf/PassOwnPtr.h>
 #include <wtf/text/CString.h>
@@ -136,6 +139,14 @@ bool LevelDBDatabase::remove(const LevelDBSlice& key)
     return m_db->Delete(writeOptions, makeSlice(key)).ok();
 }
 
+bool LevelDBDatabase::write(LevelDBWriteBatch& writeBatch)
+{
+    leveldb::WriteOptions writeOptions;
+    writeOptions.sync = false;
+
+    return m_db->Write(writeOptions, writeBatch.m_writeBatch.get()).ok();
+}
+
 bool LevelDBDatabase::get(const LevelDBSlice& key, Vector<char>& value)
 {
     std::string result;
@@ -146,12 +157,33 @@ bool LevelDBDatabase::get(const LevelDBSlice& key, Vector<char>& value)
     return true;
 }
 
+namespace {
+class IteratorImpl : public LevelDBIterator {
+public:
+    IteratorImpl(leveldb::Iterator* iterator)
+        : m_iterator(iterator)
+    {
+    }
+
+    virtual bool isValid() const { return m_iterator->Valid(); }
+    virtual void seekToLast() { m_iterator->SeekToLast(); }
+    virtual void seek(const LevelDBSlice& target) { m_iterator->Seek(makeSlice(target)); }
+    virtual void next() { m_iterator->Next(); }
+    virtual void prev() { m_iterator->Prev(); }
+    virtual LevelDBSlice key() const { return makeLevelDBSlice(m_iterator->key()); }
+    virtual LevelDBSlice value() const { return makeLevelDBSlice(m_iterator->value()); }
+
+private:
+    OwnPtr<leveldb::Iterator> m_iterator;
+};
+}
+
 LevelDBIterator* LevelDBDatabase::newIterator()
 {
     leveldb::Iterator* i = m_db->NewIterator(leveldb::ReadOptions());
     if (!i) // FIXME: Double check if we actually need to check this.
         return 0;
-    return new LevelDBIterator(i);
+    return new IteratorImpl(i);
 }
 
 } // namespace WebCore
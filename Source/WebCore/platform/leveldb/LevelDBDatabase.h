@@ -42,6 +42,7 @@ namespace WebCore {
 class LevelDBComparator;
 class LevelDBIterator;
 class LevelDBSlice;
+class LevelDBWriteBatch;
 
 class LevelDBDatabase {
 public:
@@ -50,6 +51,8 @@ public:
 
     bool put(const LevelDBSlice& key, const Vector<char>& value);
     bool remove(const LevelDBSlice& key);
+    // Applies every write in the batch at once.
+    bool write(LevelDBWriteBatch&);
     bool get(const LevelDBSlice& key, Vector<char>& value);
     LevelDBIterator* newIterator();
 
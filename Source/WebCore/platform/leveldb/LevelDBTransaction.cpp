@@ -0,0 +1,419 @@
+/*
+ * Copyright 2012, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "LevelDBTransaction.h"
+
+#if ENABLE(LEVELDB)
+
+#include "LevelDBDatabase.h"
+#include "LevelDBWriteBatch.h"
+#include <wtf/PassOwnPtr.h>
+
+namespace WebCore {
+
+PassRefPtr<LevelDBTransaction> LevelDBTransaction::create(LevelDBDatabase* database, const LevelDBComparator* comparator)
+{
+    return adoptRef(new LevelDBTransaction(database, comparator));
+}
+
+LevelDBTransaction::LevelDBTransaction(LevelDBDatabase* database, const LevelDBComparator* comparator)
+    : m_database(database)
+    , m_comparator(comparator)
+    , m_finished(false)
+{
+    m_tree.abstractor().m_comparator = comparator;
+}
+
+LevelDBTransaction::~LevelDBTransaction()
+{
+    ASSERT(m_iterators.isEmpty());
+    clearTree();
+}
+
+void LevelDBTransaction::clearTree()
+{
+    Vector<AVLTreeNode*> nodes;
+    TreeType::Iterator iterator;
+    iterator.start_iter_least(m_tree);
+    for (; *iterator; ++iterator)
+        nodes.append(*iterator);
+    m_tree.purge();
+
+    HashSet<TransactionIterator*>::iterator end = m_iterators.end();
+    for (HashSet<TransactionIterator*>::iterator it = m_iterators.begin(); it != end; ++it)
+        (*it)->treeCleared();
+
+    deleteAllValues(nodes);
+}
+
+void LevelDBTransaction::set(const LevelDBSlice& key, const Vector<char>& value, bool deleted)
+{
+    ASSERT(!m_finished);
+    AVLTreeNode* node = m_tree.search(key);
+    bool isNewNode = !node;
+    if (isNewNode) {
+        node = new AVLTreeNode;
+        node->key.append(key.begin(), key.end() - key.begin());
+        m_tree.insert(node);
+    }
+    node->value = value;
+    node->deleted = deleted;
+
+    // Updating a node in place leaves the tree's shape alone, but an insert
+    // may rebalance it under the iterators' saved paths.
+    if (!isNewNode)
+        return;
+    HashSet<TransactionIterator*>::iterator end = m_iterators.end();
+    for (HashSet<TransactionIterator*>::iterator it = m_iterators.begin(); it != end; ++it)
+        (*it)->treeChanged();
+}
+
+bool LevelDBTransaction::put(const LevelDBSlice& key, const Vector<char>& value)
+{
+    set(key, value, false);
+    return true;
+}
+
+bool LevelDBTransaction::remove(const LevelDBSlice& key)
+{
+    // The key may only exist in the database, so the tree keeps a marker that hides it.
+    set(key, Vector<char>(), true);
+    return true;
+}
+
+bool LevelDBTransaction::get(const LevelDBSlice& key, Vector<char>& value)
+{
+    ASSERT(!m_finished);
+    if (AVLTreeNode* node = m_tree.search(key)) {
+        if (node->deleted)
+            return false;
+        value = node->value;
+        return true;
+    }
+    return m_database->get(key, value);
+}
+
+LevelDBIterator* LevelDBTransaction::newIterator()
+{
+    ASSERT(!m_finished);
+    return new TransactionIterator(this);
+}
+
+bool LevelDBTransaction::commit()
+{
+    ASSERT(!m_finished);
+    if (m_tree.is_empty()) {
+        m_finished = true;
+        return true;
+    }
+
+    OwnPtr<LevelDBWriteBatch> writeBatch = LevelDBWriteBatch::create();
+    TreeType::Iterator iterator;
+    iterator.start_iter_least(m_tree);
+    for (; *iterator; ++iterator) {
+        AVLTreeNode* node = *iterator;
+        if (node->deleted)
+            writeBatch->remove(node->key);
+        else
+            writeBatch->put(node->key, node->value);
+    }
+
+    if (!m_database->write(*writeBatch))
+        return false;
+
+    clearTree();
+    m_finished = true;
+    return true;
+}
+
+void LevelDBTransaction::rollback()
+{
+    ASSERT(!m_finished);
+    m_finished = true;
+    clearTree();
+}
+
+void LevelDBTransaction::registerIterator(TransactionIterator* iterator)
+{
+    ASSERT(!m_iterators.contains(iterator));
+    m_iterators.add(iterator);
+}
+
+void LevelDBTransaction::unregisterIterator(TransactionIterator* iterator)
+{
+    ASSERT(m_iterators.contains(iterator));
+    m_iterators.remove(iterator);
+}
+
+LevelDBTransaction::TreeIterator::TreeIterator(LevelDBTransaction* transaction)
+    : m_tree(&transaction->m_tree)
+    , m_node(0)
+{
+}
+
+bool LevelDBTransaction::TreeIterator::isValid() const
+{
+    return m_node;
+}
+
+void LevelDBTransaction::TreeIterator::seekToLast()
+{
+    m_iterator.start_iter_greatest(*m_tree);
+    updateNode();
+}
+
+void LevelDBTransaction::TreeIterator::seek(const LevelDBSlice& target)
+{
+    m_iterator.start_iter(*m_tree, target, TreeType::GREATER_EQUAL);
+    updateNode();
+}
+
+void LevelDBTransaction::TreeIterator::next()
+{
+    ASSERT(isValid());
+    ++m_iterator;
+    updateNode();
+}
+
+void LevelDBTransaction::TreeIterator::prev()
+{
+    ASSERT(isValid());
+    --m_iterator;
+    updateNode();
+}
+
+LevelDBSlice LevelDBTransaction::TreeIterator::key() const
+{
+    ASSERT(isValid());
+    return LevelDBSlice(m_node->key);
+}
+
+LevelDBSlice LevelDBTransaction::TreeIterator::value() const
+{
+    ASSERT(isValid());
+    ASSERT(!isDeleted());
+    return LevelDBSlice(m_node->value);
+}
+
+bool LevelDBTransaction::TreeIterator::isDeleted() const
+{
+    ASSERT(isValid());
+    return m_node->deleted;
+}
+
+void LevelDBTransaction::TreeIterator::reset()
+{
+    ASSERT(isValid());
+    // Nodes are never freed while the transaction is open, so the current one
+    // still has its key.
+    m_iterator.start_iter(*m_tree, LevelDBSlice(m_node->key), TreeType::EQUAL);
+    ASSERT(*m_iterator == m_node);
+}
+
+void LevelDBTransaction::TreeIterator::invalidate()
+{
+    ASSERT(m_tree->is_empty());
+    m_iterator.start_iter_least(*m_tree);
+    m_node = 0;
+}
+
+LevelDBTransaction::TransactionIterator::TransactionIterator(PassRefPtr<LevelDBTransaction> transaction)
+    : m_transaction(transaction)
+    , m_comparator(m_transaction->m_comparator)
+    , m_treeIterator(adoptPtr(new TreeIterator(m_transaction.get())))
+    , m_databaseIterator(adoptPtr(m_transaction->m_database->newIterator()))
+    , m_current(0)
+    , m_direction(Forward)
+    , m_treeChanged(false)
+{
+    m_transaction->registerIterator(this);
+}
+
+LevelDBTransaction::TransactionIterator::~TransactionIterator()
+{
+    m_transaction->unregisterIterator(this);
+}
+
+void LevelDBTransaction::TransactionIterator::seekToLast()
+{
+    m_treeIterator->seekToLast();
+    m_databaseIterator->seekToLast();
+    m_direction = Reverse;
+    m_treeChanged = false;
+
+    handleConflictsAndDeletes();
+    setCurrentIteratorToLargestKey();
+}
+
+void LevelDBTransaction::TransactionIterator::seek(const LevelDBSlice& target)
+{
+    m_treeIterator->seek(target);
+    m_databaseIterator->seek(target);
+    m_direction = Forward;
+    m_treeChanged = false;
+
+    handleConflictsAndDeletes();
+    setCurrentIteratorToSmallestKey();
+}
+
+void LevelDBTransaction::TransactionIterator::next()
+{
+    ASSERT(isValid());
+    if (m_treeChanged)
+        refreshTreeIterator();
+
+    if (m_direction != Forward) {
+        // Turning around: put the other iterator just past the current key.
+        LevelDBIterator* other = m_current == m_databaseIterator.get() ? static_cast<LevelDBIterator*>(m_treeIterator.get()) : m_databaseIterator.get();
+        other->seek(key());
+        if (other->isValid() && !m_comparator->compare(other->key(), key()))
+            other->next();
+        m_direction = Forward;
+    }
+
+    m_current->next();
+    handleConflictsAndDeletes();
+    setCurrentIteratorToSmallestKey();
+}
+
+void LevelDBTransaction::TransactionIterator::prev()
+{
+    ASSERT(isValid());
+    if (m_treeChanged)
+        refreshTreeIterator();
+
+    if (m_direction != Reverse) {
+        // Turning around: put the other iterator just before the current key.
+        LevelDBIterator* other = m_current == m_databaseIterator.get() ? static_cast<LevelDBIterator*>(m_treeIterator.get()) : m_databaseIterator.get();
+        other->seek(key());
+        if (other->isValid())
+            other->prev();
+        else
+            other->seekToLast();
+        m_direction = Reverse;
+    }
+
+    m_current->prev();
+    handleConflictsAndDeletes();
+    setCurrentIteratorToLargestKey();
+}
+
+LevelDBSlice LevelDBTransaction::TransactionIterator::key() const
+{
+    ASSERT(isValid());
+    return m_current->key();
+}
+
+LevelDBSlice LevelDBTransaction::TransactionIterator::value() const
+{
+    ASSERT(isValid());
+    return m_current->value();
+}
+
+void LevelDBTransaction::TransactionIterator::treeCleared()
+{
+    m_treeIterator->invalidate();
+    m_treeChanged = false;
+    if (m_current == m_treeIterator.get())
+        m_current = m_databaseIterator->isValid() ? m_databaseIterator.get() : 0;
+}
+
+void LevelDBTransaction::TransactionIterator::handleConflictsAndDeletes()
+{
+    bool loop = true;
+    while (loop) {
+        loop = false;
+
+        // The transaction's own write of a key wins over the database's.
+        if (m_treeIterator->isValid() && m_databaseIterator->isValid() && !m_comparator->compare(m_treeIterator->key(), m_databaseIterator->key())) {
+            if (m_direction == Forward)
+                m_databaseIterator->next();
+            else
+                m_databaseIterator->prev();
+        }
+
+        // A delete marker is only stepped over once the database iterator has
+        // moved past its key; until then it still has to hide that key.
+        if (m_treeIterator->isValid() && m_treeIterator->isDeleted()) {
+            if (m_direction == Forward && (!m_databaseIterator->isValid() || m_comparator->compare(m_treeIterator->key(), m_databaseIterator->key()) < 0)) {
+                m_treeIterator->next();
+                loop = true;
+            } else if (m_direction == Reverse && (!m_databaseIterator->isValid() || m_comparator->compare(m_treeIterator->key(), m_databaseIterator->key()) > 0)) {
+                m_treeIterator->prev();
+                loop = true;
+            }
+        }
+    }
+}
+
+void LevelDBTransaction::TransactionIterator::setCurrentIteratorToSmallestKey()
+{
+    m_current = 0;
+    if (m_treeIterator->isValid())
+        m_current = m_treeIterator.get();
+    if (m_databaseIterator->isValid() && (!m_current || m_comparator->compare(m_databaseIterator->key(), m_current->key()) < 0))
+        m_current = m_databaseIterator.get();
+}
+
+void LevelDBTransaction::TransactionIterator::setCurrentIteratorToLargestKey()
+{
+    m_current = 0;
+    if (m_treeIterator->isValid())
+        m_current = m_treeIterator.get();
+    if (m_databaseIterator->isValid() && (!m_current || m_comparator->compare(m_databaseIterator->key(), m_current->key()) > 0))
+        m_current = m_databaseIterator.get();
+}
+
+void LevelDBTransaction::TransactionIterator::refreshTreeIterator()
+{
+    ASSERT(m_treeChanged);
+    m_treeChanged = false;
+
+    if (m_treeIterator->isValid() && m_current == m_treeIterator.get()) {
+        m_treeIterator->reset();
+        return;
+    }
+
+    // The database iterator is current. A node inserted since the last move
+    // may lie between it and the tree iterator, so seek the tree iterator to
+    // the first node beyond the current key in the direction of travel.
+    if (!m_databaseIterator->isValid())
+        return;
+    m_treeIterator->seek(m_databaseIterator->key());
+    if (m_direction == Forward) {
+        if (m_treeIterator->isValid() && !m_comparator->compare(m_treeIterator->key(), m_databaseIterator->key()))
+            m_treeIterator->next();
+    } else {
+        if (m_treeIterator->isValid())
+            m_treeIterator->prev();
+        else
+            m_treeIterator->seekToLast();
+    }
+}
+
+} // namespace WebCore
+
+#endif // ENABLE(LEVELDB)
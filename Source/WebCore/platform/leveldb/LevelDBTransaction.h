@@ -0,0 +1,176 @@
+/*
+ * Copyright 2012, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef LevelDBTransaction_h
+#define LevelDBTransaction_h
+
+#if ENABLE(LEVELDB)
+
+#include "LevelDBComparator.h"
+#include "LevelDBIterator.h"
+#include "LevelDBSlice.h"
+#include <wtf/AVLTree.h>
+#include <wtf/HashSet.h>
+#include <wtf/OwnPtr.h>
+#include <wtf/PassRefPtr.h>
+#include <wtf/RefCounted.h>
+#include <wtf/Vector.h>
+
+namespace WebCore {
+
+class LevelDBDatabase;
+
+// Holds the writes of one transaction in memory, ordered by the database's
+// comparator, and hands them to the database in a single write batch on
+// commit(). Reads and iterators see the database as the transaction has
+// changed it so far.
+class LevelDBTransaction : public RefCounted<LevelDBTransaction> {
+public:
+    static PassRefPtr<LevelDBTransaction> create(LevelDBDatabase*, const LevelDBComparator*);
+    ~LevelDBTransaction();
+
+    bool put(const LevelDBSlice& key, const Vector<char>& value);
+    bool remove(const LevelDBSlice& key);
+    bool get(const LevelDBSlice& key, Vector<char>& value);
+    LevelDBIterator* newIterator();
+
+    bool commit();
+    void rollback();
+
+private:
+    LevelDBTransaction(LevelDBDatabase*, const LevelDBComparator*);
+
+    struct AVLTreeNode {
+        WTF_MAKE_FAST_ALLOCATED;
+    public:
+        Vector<char> key;
+        Vector<char> value;
+        bool deleted;
+
+        AVLTreeNode* less;
+        AVLTreeNode* greater;
+        int balanceFactor;
+    };
+
+    struct AVLTreeAbstractor {
+        typedef AVLTreeNode* handle;
+        typedef size_t size;
+        typedef LevelDBSlice key;
+
+        handle get_less(handle h) { return h->less; }
+        void set_less(handle h, handle less) { h->less = less; }
+        handle get_greater(handle h) { return h->greater; }
+        void set_greater(handle h, handle greater) { h->greater = greater; }
+
+        int get_balance_factor(handle h) { return h->balanceFactor; }
+        void set_balance_factor(handle h, int balanceFactor) { h->balanceFactor = balanceFactor; }
+
+        int compare_key_key(const key& a, const key& b) { return m_comparator->compare(a, b); }
+        int compare_key_node(const key& k, handle h) { return compare_key_key(k, h->key); }
+        int compare_node_node(handle a, handle b) { return compare_key_key(a->key, b->key); }
+
+        static handle null() { return 0; }
+
+        const LevelDBComparator* m_comparator;
+    };
+
+    typedef WTF::AVLTree<AVLTreeAbstractor, 64> TreeType;
+
+    class TreeIterator : public LevelDBIterator {
+    public:
+        explicit TreeIterator(LevelDBTransaction*);
+
+        virtual bool isValid() const;
+        virtual void seekToLast();
+        virtual void seek(const LevelDBSlice& target);
+        virtual void next();
+        virtual void prev();
+        virtual LevelDBSlice key() const;
+        virtual LevelDBSlice value() const;
+
+        bool isDeleted() const;
+        // Finds the current node again after the tree has been rebalanced.
+        void reset();
+        void invalidate();
+
+    private:
+        void updateNode() { m_node = *m_iterator; }
+
+        TreeType* m_tree;
+        TreeType::Iterator m_iterator;
+        // The tree iterator reads the root out of the tree, which a rotation
+        // may have replaced, so the node it stopped on is remembered here.
+        AVLTreeNode* m_node;
+    };
+
+    class TransactionIterator : public LevelDBIterator {
+    public:
+        explicit TransactionIterator(PassRefPtr<LevelDBTransaction>);
+        virtual ~TransactionIterator();
+
+        virtual bool isValid() const { return m_current; }
+        virtual void seekToLast();
+        virtual void seek(const LevelDBSlice& target);
+        virtual void next();
+        virtual void prev();
+        virtual LevelDBSlice key() const;
+        virtual LevelDBSlice value() const;
+
+        void treeChanged() { m_treeChanged = true; }
+        void treeCleared();
+
+    private:
+        void handleConflictsAndDeletes();
+        void setCurrentIteratorToSmallestKey();
+        void setCurrentIteratorToLargestKey();
+        void refreshTreeIterator();
+
+        RefPtr<LevelDBTransaction> m_transaction;
+        const LevelDBComparator* m_comparator;
+        OwnPtr<TreeIterator> m_treeIterator;
+        OwnPtr<LevelDBIterator> m_databaseIterator;
+        LevelDBIterator* m_current;
+
+        enum Direction { Forward, Reverse };
+        Direction m_direction;
+        bool m_treeChanged;
+    };
+
+    void set(const LevelDBSlice& key, const Vector<char>& value, bool deleted);
+    void clearTree();
+    void registerIterator(TransactionIterator*);
+    void unregisterIterator(TransactionIterator*);
+
+    LevelDBDatabase* m_database;
+    const LevelDBComparator* m_comparator;
+    TreeType m_tree;
+    bool m_finished;
+    HashSet<TransactionIterator*> m_iterators;
+};
+
+} // namespace WebCore
+
+#endif // ENABLE(LEVELDB)
+#endif // LevelDBTransaction_h
@@ -27,11 +27,13 @@
 #include "ResourceHandle.h"
 
 #include "CachedResourceLoader.h"
+#include "DNS.h"
 #include "DocumentLoader.h"
 #include "Frame.h"
 #include "FrameLoader.h"
 #include "MainResourceLoader.h"
 #include "NotImplemented.h"
+#include "PlatformBridge.h"
 #include "ResourceHandleClient.h"
 #include "ResourceHandleInternal.h"
 #include "ResourceLoaderAndroid.h"
@@ -40,6 +42,17 @@
 
 namespace WebCore {
 
+void prefetchDNS(const String& hostname)
+{
+    PlatformBridge::prefetchDNS(hostname);
+}
+
+void ResourceHandle::cacheMetadata(const ResourceResponse& response, const Vector<char>& data)
+{
+    if (response.responseTime())
+        PlatformBridge::cacheMetadata(response.url(), response.responseTime(), data);
+}
+
 ResourceHandleInternal::~ResourceHandleInternal()
 {
 }
@@ -34,10 +34,18 @@ namespace WebCore {
 
 class ResourceResponse : public ResourceResponseBase {
 public:
-    ResourceResponse() : ResourceResponseBase() { }
+    ResourceResponse() : ResourceResponseBase(), m_responseTime(0), m_wasFetchedViaSPDY(false) { }
 
     ResourceResponse(const KURL& url, const String& mimeType, long long expectedLength, const String& textEncodingName, const String& filename)
-        : ResourceResponseBase(url, mimeType, expectedLength, textEncodingName, filename) { }
+        : ResourceResponseBase(url, mimeType, expectedLength, textEncodingName, filename), m_responseTime(0), m_wasFetchedViaSPDY(false) { }
+
+    // Time the response was received from the network, 0 if it didn't come
+    // from the HTTP stack. Used to key ResourceHandle::cacheMetadata().
+    double responseTime() const { return m_responseTime; }
+    void setResponseTime(double responseTime) { m_responseTime = responseTime; }
+
+    bool wasFetchedViaSPDY() const { return m_wasFetchedViaSPDY; }
+    void setWasFetchedViaSPDY(bool value) { m_wasFetchedViaSPDY = value; }
 
 private:
     friend class ResourceResponseBase;
@@ -49,6 +57,9 @@ private:
 
     PassOwnPtr<CrossThreadResourceResponseData> doPlatformCopyData(PassOwnPtr<CrossThreadResourceResponseData> data) const { return data; }
     void doPlatformAdopt(PassOwnPtr<CrossThreadResourceResponseData>) { }
+
+    double m_responseTime;
+    bool m_wasFetchedViaSPDY;
 };
 
 struct CrossThreadResourceResponseData : public CrossThreadResourceResponseDataBase {
@@ -33,6 +33,7 @@
 #include "SQLiteFileSystem.h"
 #include "SQLiteStatement.h"
 #include <sqlite3.h>
+#include <wtf/OwnPtr.h>
 #include <wtf/Threading.h>
 #include <wtf/text/CString.h>
 #include <wtf/text/StringConcatenate.h>
@@ -47,6 +48,8 @@ const int SQLResultSchema = SQLITE_SCHEMA;
 const int SQLResultFull = SQLITE_FULL;
 const int SQLResultInterrupt = SQLITE_INTERRUPT;
 
+static const size_t maximumCachedStatements = 16;
+
 SQLiteDatabase::SQLiteDatabase()
     : m_db(0)
     , m_pageSize(-1)
@@ -97,6 +100,8 @@ void SQLiteDatabase::close()
         sqlite3* db = m_db;
         {
             MutexLocker locker(m_databaseClosingMutex);
+            // sqlite3_close() refuses to close a database with unfinalized statements.
+            clearStatementCache();
             m_db = 0;
         }
         sqlite3_close(db);
@@ -229,6 +234,58 @@ void SQLiteDatabase::setSynchronous(SynchronousPragma sync)
     executeCommand(makeString("PRAGMA synchronous = ", String::number(sync)));
 }
 
+bool SQLiteDatabase::enableWriteAheadLogging()
+{
+#if SQLITE_VERSION_NUMBER >= 3007000
+    SQLiteStatement statement(*this, "PRAGMA journal_mode = WAL;");
+    if (statement.prepareAndStep() != SQLITE_ROW)
+        return false;
+    return equalIgnoringCase(statement.getColumnText(0), "wal");
+#else
+    return false;
+#endif
+}
+
+PassOwnPtr<SQLiteStatement> SQLiteDatabase::takeCachedStatement(const String& query, int variant, unsigned& userData)
+{
+    MutexLocker locker(m_databaseClosingMutex);
+    for (size_t i = m_statementCache.size(); i--; ) {
+        CachedStatement entry = m_statementCache[i];
+        if (entry.variant != variant || entry.statement->query() != query)
+            continue;
+        m_statementCache.remove(i);
+        userData = entry.userData;
+        return adoptPtr(entry.statement);
+    }
+    return PassOwnPtr<SQLiteStatement>();
+}
+
+void SQLiteDatabase::cacheStatement(PassOwnPtr<SQLiteStatement> passedStatement, int variant, unsigned userData)
+{
+    OwnPtr<SQLiteStatement> statement = passedStatement;
+    ASSERT(statement->database() == this);
+    MutexLocker locker(m_databaseClosingMutex);
+    if (!m_db)
+        return;
+
+    statement->reset();
+    statement->clearBindings();
+
+    if (m_statementCache.size() == maximumCachedStatements) {
+        delete m_statementCache[0].statement;
+        m_statementCache.remove(0);
+    }
+    CachedStatement entry = { statement.leakPtr(), variant, userData };
+    m_statementCache.append(entry);
+}
+
+void SQLiteDatabase::clearStatementCache()
+{
+    for (size_t i = 0; i < m_statementCache.size(); ++i)
+        delete m_statementCache[i].statement;
+    m_statementCache.clear();
+}
+
 void SQLiteDatabase::setBusyTimeout(int ms)
 {
     if (m_db)
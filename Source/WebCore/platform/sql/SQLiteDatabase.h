@@ -28,7 +28,9 @@
 #define SQLiteDatabase_h
 
 #include "PlatformString.h"
+#include <wtf/PassOwnPtr.h>
 #include <wtf/Threading.h>
+#include <wtf/Vector.h>
 
 #if COMPILER(MSVC)
 #pragma warning(disable: 4800)
@@ -98,6 +100,21 @@ public:
     // OFF - Calls return immediately after the data has been passed to disk
     enum SynchronousPragma { SyncOff = 0, SyncNormal = 1, SyncFull = 2 };
     void setSynchronous(SynchronousPragma);
+
+    // Switches the journal to a write-ahead log, which commits with one append
+    // instead of rewriting a rollback journal and lets readers run alongside a
+    // writer. Returns false if this SQLite predates WAL or the switch failed.
+    bool enableWriteAheadLogging();
+
+    // Prepared statements kept for callers that run the same queries over and
+    // over. A statement is owned by the caller between takeCachedStatement()
+    // and cacheStatement(); |variant| keeps apart preparations of one query
+    // that are not interchangeable, and |userData| is handed back on a hit.
+    // The least recently cached statement is finalized when the cache is full.
+    // The cache is guarded by m_databaseClosingMutex, since close() may run on
+    // the main thread while the database thread uses it.
+    PassOwnPtr<SQLiteStatement> takeCachedStatement(const String& query, int variant, unsigned& userData);
+    void cacheStatement(PassOwnPtr<SQLiteStatement>, int variant, unsigned userData);
     
     int lastError();
     const char* lastErrorMsg();
@@ -136,6 +153,9 @@ private:
     static int authorizerFunction(void*, int, const char*, const char*, const char*, const char*);
 
     void enableAuthorizer(bool enable);
+
+    // Must be called with m_databaseClosingMutex held.
+    void clearStatementCache();
     
     int pageSize();
     
@@ -153,6 +173,13 @@ private:
 
     Mutex m_databaseClosingMutex;
     bool m_interrupted;
+
+    struct CachedStatement {
+        SQLiteStatement* statement;
+        int variant;
+        unsigned userData;
+    };
+    Vector<CachedStatement> m_statementCache;
 }; // class SQLiteDatabase
 
 } // namespace WebCore
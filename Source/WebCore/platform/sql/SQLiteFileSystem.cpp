@@ -115,13 +115,23 @@ bool SQLiteFileSystem::deleteEmptyDatabaseDirectory(const String& path)
 
 bool SQLiteFileSystem::deleteDatabaseFile(const String& fileName)
 {
+    // A database that journaled to a write-ahead log leaves the log and its index behind.
+    deleteFile(fileName + "-wal");
+    deleteFile(fileName + "-shm");
     return deleteFile(fileName);
 }
 
 long long SQLiteFileSystem::getDatabaseFileSize(const String& fileName)
 {        
     long long size;
-    return getFileSize(fileName, size) ? size : 0;
+    if (!getFileSize(fileName, size))
+        return 0;
+
+    // Pages committed to a write-ahead log count against the quota until they are checkpointed.
+    long long logSize;
+    if (getFileSize(fileName + "-wal", logSize))
+        size += logSize;
+    return size;
 }
 
 } // namespace WebCore
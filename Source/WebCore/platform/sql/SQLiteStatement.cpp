@@ -135,6 +135,14 @@ int SQLiteStatement::reset()
     return sqlite3_reset(m_statement);
 }
 
+int SQLiteStatement::clearBindings()
+{
+    ASSERT(m_isPrepared);
+    if (!m_statement)
+        return SQLITE_OK;
+    return sqlite3_clear_bindings(m_statement);
+}
+
 bool SQLiteStatement::executeCommand()
 {
     if (!m_statement && prepare() != SQLITE_OK)
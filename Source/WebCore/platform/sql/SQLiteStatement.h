@@ -54,6 +54,7 @@ public:
     int step();
     int finalize();
     int reset();
+    int clearBindings();
     
     int prepareAndStep() { if (int error = prepare()) return error; return step(); }
     
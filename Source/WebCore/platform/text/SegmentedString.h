@@ -205,6 +205,20 @@ public:
     // have space for at least |count| characters.
     void advance(unsigned count, UChar* consumedCharacters);
 
+    // The number of characters, starting with the current one, that can be read
+    // directly through operator->() without crossing into another substring.
+    unsigned lengthOfCurrentSubstring() const { return m_pushedChar1 ? 0 : m_currentString.m_length; }
+
+    // Skips |count| characters of the current substring, none of which may be a
+    // newline. At least one character of the substring must remain current.
+    void advancePastNonNewlines(unsigned count)
+    {
+        ASSERT(!m_pushedChar1);
+        ASSERT(count < static_cast<unsigned>(m_currentString.m_length));
+        m_currentString.m_length -= count;
+        m_currentChar = m_currentString.m_current += count;
+    }
+
     bool escaped() const { return m_pushedChar1; }
 
     int numberOfCharactersConsumed() const
@@ -26,6 +26,7 @@
 #include "TextBreakIteratorInternalICU.h"
 #include <unicode/ubrk.h>
 #include <wtf/Assertions.h>
+#include <string.h>
 
 using namespace std;
 
@@ -70,20 +71,53 @@ TextBreakIterator* wordBreakIterator(const UChar* string, int length)
         staticWordBreakIterator, UBRK_WORD, string, length);
 }
 
-static bool createdLineBreakIterator = false;
-static TextBreakIterator* staticLineBreakIterator;
+// Line break iterators are acquired once per LazyLineBreakIterator, and several
+// of them can be alive at once while laying out nested inline content. Keep a
+// small pool of released iterators, tagged with the locale they were opened for,
+// so that reacquiring one only costs a ubrk_setText() instead of a ubrk_open().
+static const size_t lineBreakIteratorPoolCapacity = 4;
 
-TextBreakIterator* acquireLineBreakIterator(const UChar* string, int length)
+struct PooledLineBreakIterator {
+    const char* locale;
+    TextBreakIterator* iterator;
+};
+
+static PooledLineBreakIterator lineBreakIteratorPool[lineBreakIteratorPoolCapacity];
+static size_t lineBreakIteratorPoolSize = 0;
+
+static TextBreakIterator* takeLineBreakIteratorFromPool(const char* locale)
 {
-    TextBreakIterator* lineBreakIterator = 0;
-    if (!createdLineBreakIterator || staticLineBreakIterator) {
-        setUpIterator(createdLineBreakIterator, staticLineBreakIterator, UBRK_LINE, string, length);
-        swap(staticLineBreakIterator, lineBreakIterator);
+    for (size_t i = lineBreakIteratorPoolSize; i > 0; --i) {
+        PooledLineBreakIterator& entry = lineBreakIteratorPool[i - 1];
+        if (entry.locale != locale && strcmp(entry.locale, locale))
+            continue;
+        TextBreakIterator* iterator = entry.iterator;
+        entry = lineBreakIteratorPool[--lineBreakIteratorPoolSize];
+        return iterator;
     }
+    return 0;
+}
+
+TextBreakIterator* acquireLineBreakIterator(const UChar* string, int length)
+{
+    if (!string)
+        return 0;
 
+    const char* locale = currentTextBreakLocaleID();
+    TextBreakIterator* lineBreakIterator = takeLineBreakIteratorFromPool(locale);
     if (!lineBreakIterator) {
-        bool createdNewLineBreakIterator = false;
-        setUpIterator(createdNewLineBreakIterator, lineBreakIterator, UBRK_LINE, string, length);
+        UErrorCode openStatus = U_ZERO_ERROR;
+        lineBreakIterator = reinterpret_cast<TextBreakIterator*>(ubrk_open(UBRK_LINE, locale, 0, 0, &openStatus));
+        ASSERT_WITH_MESSAGE(U_SUCCESS(openStatus), "ICU could not open a break iterator: %s (%d)", u_errorName(openStatus), openStatus);
+        if (!lineBreakIterator)
+            return 0;
+    }
+
+    UErrorCode setTextStatus = U_ZERO_ERROR;
+    ubrk_setText(reinterpret_cast<UBreakIterator*>(lineBreakIterator), string, length, &setTextStatus);
+    if (U_FAILURE(setTextStatus)) {
+        releaseLineBreakIterator(lineBreakIterator);
+        return 0;
     }
 
     return lineBreakIterator;
@@ -91,13 +125,16 @@ TextBreakIterator* acquireLineBreakIterator(const UChar* string, int length)
 
 void releaseLineBreakIterator(TextBreakIterator* iterator)
 {
-    ASSERT(createdLineBreakIterator);
     ASSERT(iterator);
 
-    if (!staticLineBreakIterator)
-        staticLineBreakIterator = iterator;
-    else
+    if (lineBreakIteratorPoolSize == lineBreakIteratorPoolCapacity) {
         ubrk_close(reinterpret_cast<UBreakIterator*>(iterator));
+        return;
+    }
+
+    PooledLineBreakIterator& entry = lineBreakIteratorPool[lineBreakIteratorPoolSize++];
+    entry.locale = currentTextBreakLocaleID();
+    entry.iterator = iterator;
 }
 
 TextBreakIterator* sentenceBreakIterator(const UChar* string, int length)
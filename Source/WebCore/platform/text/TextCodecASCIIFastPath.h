@@ -29,6 +29,12 @@
 
 #include <stdint.h>
 
+#if CPU(ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 namespace WebCore {
 
 // Assuming that a pointer is the size of a "machine word", then
@@ -91,6 +97,36 @@ template<typename T> inline T* alignToMachineWord(T* pointer)
     return reinterpret_cast<T*>(reinterpret_cast<uintptr_t>(pointer) & ~machineWordAlignmentMask);
 }
 
+#if CPU(ARM_NEON) || defined(__SSE2__)
+#define ASCII_VECTOR_FAST_PATH 1
+
+// Number of bytes copyASCIIVector() checks and widens at once.
+const ptrdiff_t asciiVectorSize = 16;
+
+// Widens asciiVectorSize bytes into UChars if they are all ASCII, and
+// returns false without writing anything otherwise. Neither pointer needs
+// to be aligned.
+inline bool copyASCIIVector(UChar* destination, const uint8_t* source)
+{
+#if CPU(ARM_NEON)
+    uint8x16_t bytes = vld1q_u8(source);
+    uint8x8_t folded = vorr_u8(vget_low_u8(bytes), vget_high_u8(bytes));
+    if (vget_lane_u64(vreinterpret_u64_u8(folded), 0) & 0x8080808080808080ULL)
+        return false;
+    vst1q_u16(reinterpret_cast<uint16_t*>(destination), vmovl_u8(vget_low_u8(bytes)));
+    vst1q_u16(reinterpret_cast<uint16_t*>(destination + 8), vmovl_u8(vget_high_u8(bytes)));
+#else
+    __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source));
+    if (_mm_movemask_epi8(bytes))
+        return false;
+    __m128i zero = _mm_setzero_si128();
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(destination), _mm_unpacklo_epi8(bytes, zero));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + 8), _mm_unpackhi_epi8(bytes, zero));
+#endif
+    return true;
+}
+#endif
+
 } // namespace WebCore
 
 #endif // TextCodecASCIIFastPath_h
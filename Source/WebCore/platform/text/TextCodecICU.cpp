@@ -41,6 +41,8 @@ using std::min;
 namespace WebCore {
 
 const size_t ConversionBufferSize = 16384;
+// Room for the bytes a converter may carry over between decode() calls.
+const size_t ConversionSlack = 16;
 
 ICUConverterWrapper::~ICUConverterWrapper()
 {
@@ -306,22 +308,28 @@ String TextCodecICU::decode(const char* bytes, size_t length, bool flush, bool s
     
     ErrorCallbackSetter callbackSetter(m_converterICU, stopOnError);
 
-    Vector<UChar> result;
-
-    UChar buffer[ConversionBufferSize];
-    UChar* bufferLimit = buffer + ConversionBufferSize;
+    // Decode straight into the result. The encodings we use ICU for produce
+    // at most one UTF-16 code unit per input byte, plus whatever the
+    // converter held back from the previous chunk, so this is normally a
+    // single ucnv_toUnicode call with no intermediate copy.
+    Vector<UChar> result(length + ConversionSlack);
+    size_t resultLength = 0;
     const char* source = reinterpret_cast<const char*>(bytes);
     const char* sourceLimit = source + length;
     int32_t* offsets = NULL;
     UErrorCode err = U_ZERO_ERROR;
 
     do {
-        int ucharsDecoded = decodeToBuffer(buffer, bufferLimit, source, sourceLimit, offsets, flush, err);
-        result.append(buffer, ucharsDecoded);
+        resultLength += decodeToBuffer(result.data() + resultLength, result.data() + result.size(), source, sourceLimit, offsets, flush, err);
+        if (err == U_BUFFER_OVERFLOW_ERROR)
+            result.grow(result.size() + ConversionBufferSize);
     } while (err == U_BUFFER_OVERFLOW_ERROR);
+    result.shrink(resultLength);
 
     if (U_FAILURE(err)) {
         // flush the converter so it can be reused, and not be bothered by this error.
+        UChar buffer[ConversionBufferSize];
+        UChar* bufferLimit = buffer + ConversionBufferSize;
         do {
             decodeToBuffer(buffer, bufferLimit, source, sourceLimit, offsets, true, err);
         } while (source < sourceLimit);
@@ -242,6 +242,18 @@ String TextCodecUTF8::decode(const char* bytes, size_t length, bool flush, bool
         while (source < end) {
             if (isASCII(*source)) {
                 // Fast path for ASCII. Most UTF-8 text will be ASCII.
+#if ASCII_VECTOR_FAST_PATH
+                if (end - source >= asciiVectorSize) {
+                    while (end - source >= asciiVectorSize && copyASCIIVector(destination, source)) {
+                        source += asciiVectorSize;
+                        destination += asciiVectorSize;
+                    }
+                    if (source == end)
+                        break;
+                    if (!isASCII(*source))
+                        continue;
+                }
+#endif
                 if (isAlignedToMachineWord(source)) {
                     while (source < alignedEnd) {
                         MachineWord chunk = *reinterpret_cast_ptr<const MachineWord*>(source);
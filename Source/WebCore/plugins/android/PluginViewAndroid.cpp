@@ -698,6 +698,13 @@ void PluginView::paint(GraphicsContext* context, const IntRect& rect)
          */
         updatePluginWidget();
         m_window->setSurfaceClip(context->platformContext()->mCanvas->getTotalClip().getBounds());
+    } else if (m_window->getLayer()) {
+        /* composited plugins are displayed by their layer, so nothing is
+           recorded here. Bitmap plugins are asked to redraw asynchronously and
+           their pixels are posted straight to the layer.
+         */
+        if (!m_window->isOpenGLDrawingModel())
+            m_window->inval(rect, true);
     } else {
         m_window->inval(rect, false);
         context->save();
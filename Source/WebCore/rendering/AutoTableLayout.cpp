@@ -35,6 +35,8 @@ AutoTableLayout::AutoTableLayout(RenderTable* table)
     : TableLayout(table)
     , m_hasPercent(false)
     , m_effectiveLogicalWidthDirty(true)
+    , m_needsFullRecalc(true)
+    , m_hasDirtyColumns(false)
 {
 }
 
@@ -142,11 +144,15 @@ void AutoTableLayout::fullRecalc()
 {
     m_hasPercent = false;
     m_effectiveLogicalWidthDirty = true;
+    m_needsFullRecalc = false;
+    m_hasDirtyColumns = false;
 
     int nEffCols = m_table->numEffCols();
     m_layoutStruct.resize(nEffCols);
     m_layoutStruct.fill(Layout());
     m_spanCells.fill(0);
+    m_columnNeedsRecalc.resize(nEffCols);
+    m_columnNeedsRecalc.fill(false);
 
     RenderObject* child = m_table->firstChild();
     Length groupLogicalWidth;
@@ -185,6 +191,55 @@ void AutoTableLayout::fullRecalc()
         recalcColumn(i);
 }
 
+void AutoTableLayout::cellPreferredLogicalWidthsDirtied(RenderTableCell* cell)
+{
+    if (m_needsFullRecalc)
+        return;
+
+    // Cells that are not placed in the grid yet come with a section recalc,
+    // which asks for a full recalc anyway.
+    if (m_table->needsSectionRecalc())
+        return;
+
+    size_t effCol = m_table->colToEffCol(cell->col());
+    if (cell->colSpan() != 1 || effCol >= m_columnNeedsRecalc.size()) {
+        m_needsFullRecalc = true;
+        return;
+    }
+
+    m_columnNeedsRecalc[effCol] = true;
+    m_hasDirtyColumns = true;
+}
+
+bool AutoTableLayout::canRecalcDirtyColumnsOnly() const
+{
+    // A column's result only depends on its own cells unless <col> elements,
+    // spanning cells, percentages or collapsed borders tie columns together.
+    return !m_needsFullRecalc
+        && m_layoutStruct.size() == static_cast<size_t>(m_table->numEffCols())
+        && !m_table->hasColElements()
+        && !m_table->collapseBorders()
+        && !m_hasPercent
+        && (m_spanCells.isEmpty() || !m_spanCells[0]);
+}
+
+void AutoTableLayout::recalcDirtyColumns()
+{
+    if (!m_hasDirtyColumns)
+        return;
+
+    m_effectiveLogicalWidthDirty = true;
+    m_hasDirtyColumns = false;
+
+    for (size_t i = 0; i < m_columnNeedsRecalc.size(); ++i) {
+        if (!m_columnNeedsRecalc[i])
+            continue;
+        m_columnNeedsRecalc[i] = false;
+        m_layoutStruct[i] = Layout();
+        recalcColumn(i);
+    }
+}
+
 // FIXME: This needs to be adapted for vertical writing modes.
 static bool shouldScaleColumns(RenderTable* table)
 {
@@ -221,7 +276,11 @@ static bool shouldScaleColumns(RenderTable* table)
 
 void AutoTableLayout::computePreferredLogicalWidths(int& minWidth, int& maxWidth)
 {
-    fullRecalc();
+    // Editing a few cells of a large table should not walk every row again.
+    if (canRecalcDirtyColumnsOnly())
+        recalcDirtyColumns();
+    else
+        fullRecalc();
 
     int spanMaxLogicalWidth = calcEffectiveLogicalWidth();
     minWidth = 0;
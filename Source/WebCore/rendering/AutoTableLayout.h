@@ -38,8 +38,13 @@ public:
     virtual void computePreferredLogicalWidths(int& minWidth, int& maxWidth);
     virtual void layout();
 
+    virtual void setNeedsFullRecalc() { m_needsFullRecalc = true; }
+    virtual void cellPreferredLogicalWidthsDirtied(RenderTableCell*);
+
 private:
     void fullRecalc();
+    bool canRecalcDirtyColumnsOnly() const;
+    void recalcDirtyColumns();
     void recalcColumn(int effCol);
 
     int calcEffectiveLogicalWidth();
@@ -69,8 +74,11 @@ private:
 
     Vector<Layout, 4> m_layoutStruct;
     Vector<RenderTableCell*, 4> m_spanCells;
+    Vector<bool, 4> m_columnNeedsRecalc;
     bool m_hasPercent : 1;
     mutable bool m_effectiveLogicalWidthDirty : 1;
+    bool m_needsFullRecalc : 1;
+    bool m_hasDirtyColumns : 1;
 };
 
 } // namespace WebCore
@@ -136,10 +136,10 @@ void RenderArena::free(size_t size, void* ptr)
 #endif
 }
 
-#ifdef ANDROID_INSTRUMENT
-size_t RenderArena::reportPoolSize() const
+#if PLATFORM(ANDROID)
+size_t RenderArena::reportPoolSize(bool includeFreeList) const
 {
-    return ReportPoolSize(&m_pool);
+    return ReportPoolSize(&m_pool, includeFreeList);
 }
 #endif
 
@@ -53,8 +53,8 @@ public:
     void* allocate(size_t);
     void free(size_t, void*);
 
-#ifdef ANDROID_INSTRUMENT
-    size_t reportPoolSize() const;
+#if PLATFORM(ANDROID)
+    size_t reportPoolSize(bool includeFreeList = true) const;
 #endif
 
 private:
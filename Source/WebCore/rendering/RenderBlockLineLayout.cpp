@@ -59,6 +59,10 @@
 #include "HTMLNames.h"
 #endif // ANDROID_LAYOUT
 
+#if PLATFORM(ANDROID)
+#include "ComplexTextPreshaper.h"
+#endif
+
 using namespace std;
 using namespace WTF;
 using namespace Unicode;
@@ -792,6 +796,11 @@ void RenderBlock::layoutInlineChildren(bool relayoutChildren, int& repaintLogica
         RenderObject* o = bidiFirst(this, 0, false);
         Vector<FloatWithRect> floats;
         bool hasInlineChild = false;
+#if PLATFORM(ANDROID)
+        // Shape the complex script words of the dirty text on all cores
+        // before the line breaking below measures them one at a time.
+        ComplexTextPreshaper preshaper;
+#endif
         while (o) {
             if (!hasInlineChild && o->isInline())
                 hasInlineChild = true;
@@ -835,8 +844,15 @@ void RenderBlock::layoutInlineChildren(bool relayoutChildren, int& repaintLogica
             } else if (o->isText() || (o->isRenderInline() && !endOfInline)) {
                 if (!o->isText())
                     toRenderInline(o)->updateAlwaysCreateLineBoxes();
-                if (fullLayout || o->selfNeedsLayout())
+                if (fullLayout || o->selfNeedsLayout()) {
                     dirtyLineBoxesForRenderer(o, fullLayout);
+#if PLATFORM(ANDROID)
+                    if (o->isText()) {
+                        RenderText* text = toRenderText(o);
+                        preshaper.addWords(text->style()->font(), text->characters(), text->textLength());
+                    }
+#endif
+                }
                 o->setNeedsLayout(false);
 #ifdef ANDROID_LAYOUT
                 if (doTextWrap && !hasTextToWrap && o->isText()) {
@@ -861,6 +877,9 @@ void RenderBlock::layoutInlineChildren(bool relayoutChildren, int& repaintLogica
             }
             o = bidiNext(this, o, 0, false, &endOfInline);
         }
+#if PLATFORM(ANDROID)
+        preshaper.shape();
+#endif
 
 #ifdef ANDROID_LAYOUT
         // try to make sure that inline text will not span wider than the
@@ -1635,6 +1654,14 @@ static bool shouldSkipWhitespaceAfterStartObject(RenderBlock* block, RenderObjec
     return false;
 }
 
+// Same as isBreakable(), using a RenderText's cached break opportunities.
+static inline bool isBreakable(const Vector<int>& breakablePositions, int pos, int& nextBreakable)
+{
+    if (pos > nextBreakable)
+        nextBreakable = *lower_bound(breakablePositions.begin(), breakablePositions.end(), pos);
+    return pos == nextBreakable;
+}
+
 static inline float textWidth(RenderText* text, unsigned from, unsigned len, const Font& font, float xPos, bool isFixedPitch, bool collapseWhiteSpace)
 {
     if (isFixedPitch || (!from && len == text->textLength()) || text->style()->hasTextCombine())
@@ -2038,6 +2065,7 @@ InlineIterator RenderBlock::findNextLineBreak(InlineBidiResolver& resolver, bool
             bool midWordBreak = false;
             bool breakAll = o->style()->wordBreak() == BreakAllWordBreak && autoWrap;
             float hyphenWidth = 0;
+            const Vector<int>* breakablePositions = autoWrap && currWS != PRE ? t->breakablePositions(breakNBSP) : 0;
 
             if (t->isWordBreak()) {
                 width.commit();
@@ -2075,7 +2103,9 @@ InlineIterator RenderBlock::findNextLineBreak(InlineBidiResolver& resolver, bool
                     lineBreakIteratorInfo.second.reset(str, strlen);
                 }
 
-                bool betweenWords = c == '\n' || (currWS != PRE && !atStart && isBreakable(lineBreakIteratorInfo.second, pos, nextBreakable, breakNBSP) && (style->hyphens() != HyphensNone || (pos && str[pos - 1] != softHyphen)));
+                bool betweenWords = c == '\n' || (currWS != PRE && !atStart
+                    && (breakablePositions ? isBreakable(*breakablePositions, pos, nextBreakable) : isBreakable(lineBreakIteratorInfo.second, pos, nextBreakable, breakNBSP))
+                    && (style->hyphens() != HyphensNone || (pos && str[pos - 1] != softHyphen)));
 
                 if (betweenWords || midWordBreak) {
                     bool stoppedIgnoringSpaces = false;
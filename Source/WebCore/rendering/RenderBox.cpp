@@ -1524,10 +1524,23 @@ void RenderBox::setVisibleWidth(int newWidth) {
     if (settings->layoutAlgorithm() != Settings::kLayoutFitColumnToScreen
         || m_visibleWidth == newWidth)
         return;
-    m_isVisibleWidthChangedBeforeLayout = true;
+    if (!m_visibleWidth || isAffectedByTextWrapWidthChange(m_visibleWidth, newWidth))
+        m_isVisibleWidthChangedBeforeLayout = true;
     m_visibleWidth = newWidth;
 }
 
+bool RenderBox::isAffectedByTextWrapWidthChange(int oldWidth, int newWidth) const
+{
+    // Table columns are sized from the text wrap width.
+    if (isTable() || isTableCell())
+        return true;
+    // Line layout only narrows boxes wider than the text wrap width, down to
+    // the width less the margin padding. A box narrower than that at both
+    // widths keeps its lines.
+    int threshold = min(oldWidth - 2 * ANDROID_FCTS_MARGIN_PADDING, newWidth);
+    return width() >= threshold + paddingLeft() + paddingRight();
+}
+
 bool RenderBox::checkAndSetRelayoutChildren(bool* relayoutChildren) {
     if (m_isVisibleWidthChangedBeforeLayout) {
         m_isVisibleWidthChangedBeforeLayout = false;
@@ -402,6 +402,9 @@ public:
 
 #ifdef ANDROID_LAYOUT
     int getVisibleWidth() const { return m_visibleWidth; }
+    // Whether line layout may wrap this box differently after the text wrap
+    // width changes from oldWidth to newWidth.
+    bool isAffectedByTextWrapWidthChange(int oldWidth, int newWidth) const;
 #endif
 
 protected:
@@ -140,6 +140,7 @@ RenderLayer::RenderLayer(RenderBoxModelObject* renderer)
     , m_last(0)
     , m_relX(0)
     , m_relY(0)
+    , m_subtreeBoundsOutlineSize(0)
     , m_x(0)
     , m_y(0)
     , m_width(0)
@@ -182,6 +183,8 @@ RenderLayer::RenderLayer(RenderBoxModelObject* renderer)
 #endif
 #endif
     , m_containsDirtyOverlayScrollbars(false)
+    , m_subtreeBoundsDirty(true)
+    , m_subtreeBoundsCullable(false)
 #if ENABLE(ANDROID_OVERFLOW_SCROLL)
     , m_hasOverflowScroll(false)
 #endif
@@ -191,6 +194,9 @@ RenderLayer::RenderLayer(RenderBoxModelObject* renderer)
     , m_reflection(0)
     , m_scrollCorner(0)
     , m_resizer(0)
+#if USE(ACCELERATED_COMPOSITING)
+    , m_squashingOwner(0)
+#endif
 {
     ScrollableArea::setConstrainsScrollingToContentEdge(false);
 
@@ -232,6 +238,7 @@ RenderLayer::~RenderLayer()
     delete m_marquee;
 
 #if USE(ACCELERATED_COMPOSITING)
+    setSquashingOwner(0);
     clearBacking();
 #endif
     
@@ -673,6 +680,9 @@ bool RenderLayer::update3DTransformedDescendantStatus()
 
 void RenderLayer::updateLayerPosition()
 {
+    // Layout moved or resized us, or changed our overflow.
+    setSubtreeBoundsDirty();
+
     IntPoint localPoint;
     IntSize inlineBoundingBoxOffset; // We don't put this into the RenderLayer x/y for inlines, so we need to subtract it out when done.
     if (renderer()->isRenderInline()) {
@@ -1035,6 +1045,9 @@ void RenderLayer::addChild(RenderLayer* child, RenderLayer* beforeChild)
 
     child->setParent(this);
 
+    // The child's own subtree bounds are relative to itself and stay valid.
+    setSubtreeBoundsDirty();
+
     if (child->isNormalFlowOnly())
         dirtyNormalFlowList();
 
@@ -1084,6 +1097,8 @@ RenderLayer* RenderLayer::removeChild(RenderLayer* oldChild)
     oldChild->setPreviousSibling(0);
     oldChild->setNextSibling(0);
     oldChild->setParent(0);
+
+    setSubtreeBoundsDirty();
     
     oldChild->updateVisibilityStatus();
     if (oldChild->m_hasVisibleContent || oldChild->m_hasVisibleDescendant)
@@ -2562,6 +2577,10 @@ void RenderLayer::paintLayer(RenderLayer* rootLayer, GraphicsContext* p,
             // If this RenderLayer should paint into its backing, that will be done via RenderLayerBacking::paintIntoLayer().
             return;
         }
+    } else if (m_squashingOwner && !(paintFlags & PaintLayerPaintingSquashedLayer)) {
+        // Squashed layers are painted by their owner's RenderLayerBacking::paintIntoLayer().
+        if (!p->updatingControlTints() && !(paintBehavior & PaintBehaviorFlattenCompositingLayers))
+            return;
     }
 #endif
 
@@ -2756,11 +2775,18 @@ void RenderLayer::paintList(Vector<RenderLayer*>* list, RenderLayer* rootLayer,
     if (!list)
         return;
     
+    // Overlap tests want to see every layer, whether it paints or not.
+    bool canCullLayers = !overlapTestRequests || overlapTestRequests->isEmpty();
+
     for (size_t i = 0; i < list->size(); ++i) {
         RenderLayer* childLayer = list->at(i);
-        if (!childLayer->isPaginated())
+        if (!childLayer->isPaginated()) {
+            // Skip the whole subtree, clip rect computation included, when
+            // none of it can touch the damaged area.
+            if (canCullLayers && !childLayer->subtreeIntersectsDamageRect(paintDirtyRect, rootLayer))
+                continue;
             childLayer->paintLayer(rootLayer, p, paintDirtyRect, paintBehavior, paintingRoot, overlapTestRequests, paintFlags);
-        else
+        } else
             paintPaginatedChildLayer(childLayer, rootLayer, p, paintDirtyRect, paintBehavior, paintingRoot, overlapTestRequests, paintFlags);
     }
 }
@@ -3616,6 +3642,65 @@ bool RenderLayer::intersectsDamageRect(const IntRect& layerBounds, const IntRect
     return boundingBox(rootLayer).intersects(damageRect);
 }
 
+void RenderLayer::setSubtreeBoundsDirty()
+{
+    for (RenderLayer* layer = this; layer && !layer->m_subtreeBoundsDirty; layer = layer->parent())
+        layer->m_subtreeBoundsDirty = true;
+}
+
+bool RenderLayer::updateSubtreeBounds()
+{
+    if (!m_subtreeBoundsDirty)
+        return m_subtreeBoundsCullable;
+
+    // Transformed, reflected, fixed and column content does not paint where
+    // convertToLayerCoords() says it does.
+    RenderBoxModelObject* renderer = this->renderer();
+    m_subtreeBoundsCullable = !renderer->isRenderView() && !renderer->isRoot()
+        && !transform() && !m_reflection && !isPaginated() && !renderer->hasColumns()
+        && renderer->style()->position() != FixedPosition;
+    m_subtreeBoundsDirty = false;
+
+    m_subtreeBoundsOutlineSize = renderer->view()->maximalOutlineSize();
+    m_subtreeBounds = boundingBox(this);
+
+    // Update every child, even once we know we can't cull, so that a clean
+    // layer never has dirty descendants.
+    for (RenderLayer* child = firstChild(); child; child = child->nextSibling()) {
+        if (!child->updateSubtreeBounds()) {
+            m_subtreeBoundsCullable = false;
+            continue;
+        }
+        IntRect childBounds = child->m_subtreeBounds;
+        int x = 0;
+        int y = 0;
+        child->convertToLayerCoords(this, x, y);
+        childBounds.move(x, y);
+        m_subtreeBounds.unite(childBounds);
+        m_subtreeBoundsOutlineSize = min(m_subtreeBoundsOutlineSize, child->m_subtreeBoundsOutlineSize);
+    }
+
+    return m_subtreeBoundsCullable;
+}
+
+bool RenderLayer::subtreeIntersectsDamageRect(const IntRect& damageRect, const RenderLayer* rootLayer)
+{
+    if (!updateSubtreeBounds())
+        return true;
+
+    IntRect bounds = m_subtreeBounds;
+    // The outline fudge factor only grows; make up for the difference.
+    int outlineSize = renderer()->view()->maximalOutlineSize();
+    if (outlineSize > m_subtreeBoundsOutlineSize)
+        bounds.inflate(outlineSize - m_subtreeBoundsOutlineSize);
+
+    int x = 0;
+    int y = 0;
+    convertToLayerCoords(rootLayer, x, y);
+    bounds.move(x, y);
+    return bounds.intersects(damageRect);
+}
+
 IntRect RenderLayer::localBoundingBox() const
 {
     // There are three special cases we need to consider.
@@ -3716,6 +3801,35 @@ void RenderLayer::clearBacking()
     m_backing.clear();
 }
 
+void RenderLayer::setSquashingOwner(RenderLayer* owner)
+{
+    if (m_squashingOwner && m_squashingOwner != owner && m_squashingOwner->backing())
+        m_squashingOwner->backing()->removeSquashedLayer(this);
+
+    m_squashingOwner = owner;
+    if (owner) {
+        ASSERT(owner->backing());
+        owner->backing()->addSquashedLayer(this);
+    }
+}
+
+void RenderLayer::setSquashingOwnerNeedsRepaintInRect(const RenderLayer* compositingAncestor, const IntRect& r)
+{
+    for (const RenderLayer* curr = this; curr && curr != compositingAncestor; curr = curr->parent()) {
+        RenderLayer* owner = curr->squashingOwner();
+        if (!owner)
+            continue;
+
+        int ownerX = 0;
+        int ownerY = 0;
+        owner->convertToLayerCoords(compositingAncestor, ownerX, ownerY);
+        IntRect ownerRect(r);
+        ownerRect.move(-ownerX, -ownerY);
+        owner->setBackingNeedsRepaintInRect(ownerRect);
+        return;
+    }
+}
+
 bool RenderLayer::hasCompositedMask() const
 {
     return m_backing && m_backing->hasMaskLayer();
@@ -4065,6 +4179,9 @@ bool RenderLayer::isSelfPaintingLayer() const
 
 void RenderLayer::styleChanged(StyleDifference diff, const RenderStyle* oldStyle)
 {
+    // Transforms, positioning and masks decide whether our bounds can be cached.
+    setSubtreeBoundsDirty();
+
     bool isNormalFlowOnly = shouldBeNormalFlowOnly();
     if (isNormalFlowOnly != m_isNormalFlowOnly) {
         m_isNormalFlowOnly = isNormalFlowOnly;
@@ -425,6 +425,11 @@ public:
 
     bool intersectsDamageRect(const IntRect& layerBounds, const IntRect& damageRect, const RenderLayer* rootLayer) const;
 
+    // Whether anything this layer or its descendant layers paint can fall in
+    // the damage rect. Conservatively true when the bounds can't be cached.
+    bool subtreeIntersectsDamageRect(const IntRect& damageRect, const RenderLayer* rootLayer);
+    void setSubtreeBoundsDirty();
+
     // Bounding box relative to some ancestor layer.
     IntRect boundingBox(const RenderLayer* rootLayer) const;
     // Bounding box in the coordinates of this layer.
@@ -522,7 +527,8 @@ private:
         PaintLayerAppliedTransform = 1 << 1,
         PaintLayerTemporaryClipRects = 1 << 2,
         PaintLayerPaintingReflection = 1 << 3,
-        PaintLayerPaintingOverlayScrollbars = 1 << 4
+        PaintLayerPaintingOverlayScrollbars = 1 << 4,
+        PaintLayerPaintingSquashedLayer = 1 << 5
     };
     
     typedef unsigned PaintLayerFlags;
@@ -530,6 +536,8 @@ private:
     void paintLayer(RenderLayer* rootLayer, GraphicsContext*, const IntRect& paintDirtyRect,
                     PaintBehavior, RenderObject* paintingRoot, OverlapTestRequestMap* = 0,
                     PaintLayerFlags = 0);
+    bool updateSubtreeBounds();
+
     void paintList(Vector<RenderLayer*>*, RenderLayer* rootLayer, GraphicsContext* p,
                    const IntRect& paintDirtyRect, PaintBehavior,
                    RenderObject* paintingRoot, OverlapTestRequestMap*,
@@ -641,6 +649,13 @@ private:
     
     bool mustOverlapCompositedLayers() const { return m_mustOverlapCompositedLayers; }
     void setMustOverlapCompositedLayers(bool b) { m_mustOverlapCompositedLayers = b; }
+
+    // A squashed layer has no backing of its own; it is painted into the
+    // backing of an earlier sibling that was composited for the same reason.
+    RenderLayer* squashingOwner() const { return m_squashingOwner; }
+    void setSquashingOwner(RenderLayer*);
+    // r is in the coordinate space of compositingAncestor's render object.
+    void setSquashingOwnerNeedsRepaintInRect(const RenderLayer* compositingAncestor, const IntRect& r);
 #if ENABLE(COMPOSITED_FIXED_ELEMENTS)
     bool shouldComposite() { return m_shouldComposite; }
     void setShouldComposite(bool b) { m_shouldComposite = b; }
@@ -673,6 +688,11 @@ protected:
     IntRect m_repaintRect; // Cached repaint rects. Used by layout.
     IntRect m_outlineBox;
 
+    // Union of the bounding boxes of this layer and its descendant layers, in
+    // our coordinates. Dirtying a layer dirties all its ancestors.
+    IntRect m_subtreeBounds;
+    int m_subtreeBoundsOutlineSize; // maximalOutlineSize() m_subtreeBounds was inflated by
+
     // Our current relative position offset.
     int m_relX;
     int m_relY;
@@ -753,6 +773,9 @@ protected:
 #endif
 
     bool m_containsDirtyOverlayScrollbars : 1;
+
+    bool m_subtreeBoundsDirty : 1;
+    bool m_subtreeBoundsCullable : 1;
 #if ENABLE(ANDROID_OVERFLOW_SCROLL)
     bool m_hasOverflowScroll : 1;
 #endif
@@ -779,6 +802,7 @@ private:
 
 #if USE(ACCELERATED_COMPOSITING)
     OwnPtr<RenderLayerBacking> m_backing;
+    RenderLayer* m_squashingOwner;
 #endif
 
     Page* m_page;
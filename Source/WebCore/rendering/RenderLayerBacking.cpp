@@ -74,6 +74,23 @@ static bool hasBoxDecorationsOrBackground(const RenderObject*);
 static bool hasBoxDecorationsOrBackgroundImage(const RenderStyle*);
 static IntRect clipBox(RenderBox* renderer);
 
+#if PLATFORM(ANDROID)
+// True if the renderer paints an opaque background color over exactly the
+// given layer bounds, so that nothing beneath the layer can show through.
+static bool backgroundCoversBounds(RenderObject* renderer, const IntRect& bounds)
+{
+    if (!renderer->isBox() || (renderer->node() && renderer->node()->isDocumentNode()))
+        return false;
+
+    RenderStyle* style = renderer->style();
+    if (style->visibility() != VISIBLE || style->hasBorderRadius() || style->backgroundClip() != BorderFillBox
+        || style->visitedDependentColor(CSSPropertyBackgroundColor).alpha() != 255)
+        return false;
+
+    return bounds == toRenderBox(renderer)->borderBoxRect();
+}
+#endif
+
 static inline bool isAcceleratedCanvas(RenderObject* renderer)
 {
 #if ENABLE(WEBGL) || ENABLE(ACCELERATED_2D_CANVAS)
@@ -97,6 +114,9 @@ RenderLayerBacking::RenderLayerBacking(RenderLayer* layer)
 
 RenderLayerBacking::~RenderLayerBacking()
 {
+    for (size_t i = 0; i < m_squashedLayers.size(); ++i)
+        m_squashedLayers[i]->m_squashingOwner = 0;
+
     updateClippingLayers(false, false);
     updateOverflowControlsLayers(false, false, false);
     updateForegroundLayer(false);
@@ -188,6 +208,13 @@ void RenderLayerBacking::updateCompositedBounds()
 {
     IntRect layerBounds = compositor()->calculateCompositedBounds(m_owningLayer, m_owningLayer);
 
+    for (size_t i = 0; i < m_squashedLayers.size(); ++i) {
+        RenderLayer* squashedLayer = m_squashedLayers[i];
+        IntRect squashedBounds = compositor()->calculateCompositedBounds(squashedLayer, squashedLayer);
+        squashedBounds.move(squashedLayerOffset(squashedLayer));
+        layerBounds.unite(squashedBounds);
+    }
+
     // Clip to the size of the document or enclosing overflow-scroll layer.
     // If this or an ancestor is transformed, we can't currently compute the correct rect to intersect with.
     // We'd need RenderObject::convertContainerToLocalQuad(), which doesn't yet exist.  If this
@@ -291,6 +318,11 @@ bool RenderLayerBacking::updateGraphicsLayerConfiguration()
     if (isDirectlyCompositedImage())
         updateImageContents();
 
+    if (m_squashedLayers != m_paintedSquashedLayers) {
+        m_paintedSquashedLayers = m_squashedLayers;
+        m_graphicsLayer->setNeedsDisplay();
+    }
+
     if ((renderer->isEmbeddedObject() && toRenderEmbeddedObject(renderer)->allowsAcceleratedCompositing())
         || (renderer->isApplet() && toRenderApplet(renderer)->allowsAcceleratedCompositing())) {
         PluginViewBase* pluginViewBase = static_cast<PluginViewBase*>(toRenderWidget(renderer)->widget());
@@ -505,6 +537,11 @@ void RenderLayerBacking::updateGraphicsLayerGeometry()
 
     m_graphicsLayer->setContentsRect(contentsBox());
     updateDrawsContent();
+#if PLATFORM(ANDROID)
+    // lets the compositor skip drawing what is hidden behind this layer
+    m_graphicsLayer->setContentsOpaque(m_graphicsLayer->drawsContent() && !m_foregroundLayer
+                                       && !m_maskLayer && backgroundCoversBounds(renderer(), compositedBounds()));
+#endif
     updateAfterWidgetResize();
 }
 
@@ -907,6 +944,9 @@ bool RenderLayerBacking::hasNonCompositingDescendants() const
 
 bool RenderLayerBacking::containsPaintedContent() const
 {
+    if (hasSquashedLayers())
+        return true;
+
     if (isSimpleContainerCompositingLayer() || paintingGoesToWindow() || m_artificiallyInflatedBounds || m_owningLayer->isReflection())
         return false;
 
@@ -1208,6 +1248,10 @@ void RenderLayerBacking::paintIntoLayer(RenderLayer* rootLayer, GraphicsContext*
         // Now walk the sorted list of children with positive z-indices.
         m_owningLayer->paintList(m_owningLayer->posZOrderList(), rootLayer, context, paintDirtyRect, paintBehavior, paintingRoot, 0, 0);
     }
+
+    // Squashed layers follow the owning layer in paint order, so they go on top of everything it painted.
+    if (paintingPhase & GraphicsLayerPaintForeground)
+        paintSquashedLayers(context, paintDirtyRect, paintBehavior);
     
     if (shouldPaint && (paintingPhase & GraphicsLayerPaintMask)) {
         if (renderer()->hasMask() && !selectionOnly && !damageRect.isEmpty()) {
@@ -1225,6 +1269,54 @@ void RenderLayerBacking::paintIntoLayer(RenderLayer* rootLayer, GraphicsContext*
     ASSERT(!m_owningLayer->m_usedTransparency);
 }
 
+void RenderLayerBacking::addSquashedLayer(RenderLayer* layer)
+{
+    ASSERT(!m_squashedLayers.contains(layer));
+    m_squashedLayers.append(layer);
+}
+
+void RenderLayerBacking::removeSquashedLayer(RenderLayer* layer)
+{
+    size_t index = m_squashedLayers.find(layer);
+    if (index == notFound)
+        return;
+    m_squashedLayers.remove(index);
+    setContentsNeedDisplay();
+}
+
+// Squashed layers are siblings of the owning layer (see RenderLayerCompositor::canSquashLayer()),
+// so their offset can be measured from the shared parent.
+IntSize RenderLayerBacking::squashedLayerOffset(const RenderLayer* layer) const
+{
+    ASSERT(layer->parent() == m_owningLayer->parent());
+    int ownerX = 0;
+    int ownerY = 0;
+    m_owningLayer->convertToLayerCoords(m_owningLayer->parent(), ownerX, ownerY);
+    int x = 0;
+    int y = 0;
+    layer->convertToLayerCoords(m_owningLayer->parent(), x, y);
+    return IntSize(x - ownerX, y - ownerY);
+}
+
+void RenderLayerBacking::paintSquashedLayers(GraphicsContext* context, const IntRect& paintDirtyRect, PaintBehavior paintBehavior)
+{
+    for (size_t i = 0; i < m_squashedLayers.size(); ++i) {
+        RenderLayer* squashedLayer = m_squashedLayers[i];
+        IntSize offset = squashedLayerOffset(squashedLayer);
+
+        IntRect dirtyRect(paintDirtyRect);
+        dirtyRect.move(-offset);
+
+        // Each squashed layer paints as its own root, like a composited layer would. Its clip rects
+        // are temporary because hit testing caches them relative to a different root.
+        context->save();
+        context->translate(offset.width(), offset.height());
+        squashedLayer->paintLayer(squashedLayer, context, dirtyRect, paintBehavior, squashedLayer->renderer(), 0,
+            RenderLayer::PaintLayerPaintingSquashedLayer | RenderLayer::PaintLayerTemporaryClipRects);
+        context->restore();
+    }
+}
+
 static void paintScrollbar(Scrollbar* scrollbar, GraphicsContext& context, const IntRect& clip)
 {
     if (!scrollbar)
@@ -122,6 +122,14 @@ public:
     IntRect compositedBounds() const;
     void setCompositedBounds(const IntRect&);
     void updateCompositedBounds();
+
+    // Layers painted into this backing after the owning layer, in paint order.
+    // See RenderLayerCompositor::computeCompositingRequirements().
+    const Vector<RenderLayer*>& squashedLayers() const { return m_squashedLayers; }
+    bool hasSquashedLayers() const { return !m_squashedLayers.isEmpty(); }
+    void addSquashedLayer(RenderLayer*);
+    void removeSquashedLayer(RenderLayer*);
+    void clearSquashedLayers() { m_squashedLayers.clear(); }
     
     void updateAfterWidgetResize();
 
@@ -189,6 +197,10 @@ private:
     const Color rendererBackgroundColor() const;
 
     bool hasNonCompositingDescendants() const;
+
+    // Offset of a squashed layer from the owning layer, in the owning layer's coordinates.
+    IntSize squashedLayerOffset(const RenderLayer*) const;
+    void paintSquashedLayers(GraphicsContext*, const IntRect& paintDirtyRect, PaintBehavior);
     
     void paintIntoLayer(RenderLayer* rootLayer, GraphicsContext*, const IntRect& paintDirtyRect,
                     PaintBehavior paintBehavior, GraphicsLayerPaintingPhase, RenderObject* paintingRoot);
@@ -215,6 +227,9 @@ private:
 
     IntRect m_compositedBounds;
 
+    Vector<RenderLayer*> m_squashedLayers;
+    Vector<RenderLayer*> m_paintedSquashedLayers; // Compared by address only; the layers may be gone.
+
     bool m_artificiallyInflatedBounds;      // bounds had to be made non-zero to make transform-origin work
 };
 
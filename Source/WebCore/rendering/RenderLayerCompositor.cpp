@@ -77,6 +77,8 @@ struct CompositingState {
     CompositingState(RenderLayer* compAncestor)
         : m_compositingAncestor(compAncestor)
         , m_subtreeIsCompositing(false)
+        , m_squashingOwner(0)
+        , m_squashingOwnerCount(0)
 #if ENABLE(COMPOSITED_FIXED_ELEMENTS)
         , m_fixedSibling(false)
         , m_hasFixedElement(false)
@@ -92,6 +94,10 @@ struct CompositingState {
     
     RenderLayer* m_compositingAncestor;
     bool m_subtreeIsCompositing;
+    // The last layer in this list that can take squashed siblings, and the value of
+    // m_compositedLayerCount right after it was composited.
+    RenderLayer* m_squashingOwner;
+    unsigned m_squashingOwnerCount;
 #if ENABLE(COMPOSITED_FIXED_ELEMENTS)
     bool m_fixedSibling;
     bool m_hasFixedElement;
@@ -118,6 +124,8 @@ RenderLayerCompositor::RenderLayerCompositor(RenderView* renderView)
     , m_compositingLayersNeedRebuild(false)
     , m_flushingLayers(false)
     , m_forceCompositingMode(false)
+    , m_hasSquashedLayers(false)
+    , m_compositedLayerCount(0)
     , m_rootLayerAttachment(RootLayerUnattached)
 #if PROFILE_LAYER_REBUILD
     , m_rootLayerUpdateCount(0)
@@ -303,6 +311,8 @@ void RenderLayerCompositor::updateCompositingLayers(CompositingUpdateType update
 #if ENABLE(ANDROID_OVERFLOW_SCROLL)
         compState.m_hasScrollableElement = false;
 #endif
+        m_hasSquashedLayers = false;
+        m_compositedLayerCount = 0;
         if (m_compositingConsultsOverlap) {
             OverlapMap overlapTestRequestMap;
             computeCompositingRequirements(updateRoot, &overlapTestRequestMap, compState, layersChanged);
@@ -546,6 +556,13 @@ void RenderLayerCompositor::layerWasAdded(RenderLayer* /*parent*/, RenderLayer*
 
 void RenderLayerCompositor::layerWillBeRemoved(RenderLayer* parent, RenderLayer* child)
 {
+    if (child->squashingOwner() && !parent->renderer()->documentBeingDestroyed()) {
+        // Dropping the layer repaints the owner's backing without it.
+        child->setSquashingOwner(0);
+        setCompositingLayersNeedRebuild();
+        return;
+    }
+
     if (!child->isComposited() || parent->renderer()->documentBeingDestroyed())
         return;
 
@@ -681,6 +698,10 @@ void RenderLayerCompositor::computeCompositingRequirements(RenderLayer* layer, O
     
     // Clear the flag
     layer->setHasCompositingDescendant(false);
+
+    // Squashed siblings re-register below, in paint order.
+    if (RenderLayerBacking* backing = layer->backing())
+        backing->clearSquashedLayers();
     
     bool mustOverlapCompositedLayers = compositingState.m_subtreeIsCompositing;
 
@@ -715,6 +736,22 @@ void RenderLayerCompositor::computeCompositingRequirements(RenderLayer* layer, O
 
     bool willBeComposited = needsToBeComposited(layer);
 
+    // A layer composited only because it overlaps earlier composited content is
+    // painted into the backing of the preceding sibling promoted for the same
+    // reason, as long as nothing else was composited in between. It is entered in
+    // the overlap map after its descendants, which paint into the same backing and
+    // so never need promoting for overlapping it.
+    bool compositedForOverlap = willBeComposited && overlapMap && layer->mustOverlapCompositedLayers() && !requiresCompositingLayer(layer);
+    RenderLayer* squashingOwner = 0;
+    if (compositedForOverlap && compositingState.m_squashingOwner && compositingState.m_squashingOwnerCount == m_compositedLayerCount
+        && compositingState.m_squashingOwner->parent() == layer->parent()
+        && compositingState.m_squashingOwner->renderer()->isPositioned() == layer->renderer()->isPositioned()
+        && canSquashLayer(layer, compositingState)) {
+        squashingOwner = compositingState.m_squashingOwner;
+        layer->setMustOverlapCompositedLayers(false);
+        willBeComposited = false;
+    }
+
 #if ENABLE(ANDROID_OVERFLOW_SCROLL)
     // tell the parent it has scrollable descendants.
     if (layer->hasOverflowScroll())
@@ -729,7 +766,7 @@ void RenderLayerCompositor::computeCompositingRequirements(RenderLayer* layer, O
         compositingState.m_subtreeIsCompositing = true;
         // This layer now acts as the ancestor for kids.
         childState.m_compositingAncestor = layer;
-        if (overlapMap)
+        if (overlapMap && !compositedForOverlap)
             addToOverlapMap(*overlapMap, layer, absBounds, haveComputedBounds);
     }
 
@@ -745,6 +782,7 @@ void RenderLayerCompositor::computeCompositingRequirements(RenderLayer* layer, O
         ASSERT(!layer->m_zOrderListsDirty);
         if (Vector<RenderLayer*>* negZOrderList = layer->negZOrderList()) {
             size_t listSize = negZOrderList->size();
+            childState.m_squashingOwner = 0;
 #if ENABLE(COMPOSITED_FIXED_ELEMENTS)
             childState.m_fixedSibling = compositingState.m_fixedSibling;
             if (checkForFixedLayers(negZOrderList, false))
@@ -782,6 +820,7 @@ void RenderLayerCompositor::computeCompositingRequirements(RenderLayer* layer, O
     ASSERT(!layer->m_normalFlowListDirty);
     if (Vector<RenderLayer*>* normalFlowList = layer->normalFlowList()) {
         size_t listSize = normalFlowList->size();
+        childState.m_squashingOwner = 0;
 #if ENABLE(COMPOSITED_FIXED_ELEMENTS)
         childState.m_fixedSibling = compositingState.m_fixedSibling;
         if (checkForFixedLayers(normalFlowList, true))
@@ -796,6 +835,7 @@ void RenderLayerCompositor::computeCompositingRequirements(RenderLayer* layer, O
     if (layer->isStackingContext()) {
         if (Vector<RenderLayer*>* posZOrderList = layer->posZOrderList()) {
             size_t listSize = posZOrderList->size();
+            childState.m_squashingOwner = 0;
 #if ENABLE(COMPOSITED_FIXED_ELEMENTS)
             childState.m_fixedSibling = compositingState.m_fixedSibling;
             if (checkForFixedLayers(posZOrderList, true))
@@ -808,6 +848,32 @@ void RenderLayerCompositor::computeCompositingRequirements(RenderLayer* layer, O
         }
     }
     
+    if (squashingOwner && (willBeComposited || childState.m_subtreeIsCompositing)) {
+        // Something in the subtree needs its own backing after all, which has to
+        // stack above this layer, so this layer cannot live in its sibling's backing.
+        squashingOwner = 0;
+        if (!willBeComposited) {
+            layer->setMustOverlapCompositedLayers(true);
+            compositingState.m_subtreeIsCompositing = true;
+            willBeComposited = true;
+        }
+    }
+
+    if (overlapMap && (compositedForOverlap || squashingOwner))
+        addToOverlapMap(*overlapMap, layer, absBounds, haveComputedBounds);
+
+    RenderLayer* previousSquashingOwner = layer->squashingOwner();
+    layer->setSquashingOwner(squashingOwner);
+    if (squashingOwner)
+        m_hasSquashedLayers = true;
+    if (previousSquashingOwner != squashingOwner) {
+        layersChanged = true;
+        if (!layer->isComposited())
+            repaintOnCompositingChange(layer);
+        // Clip rects cached while painting into the old backing have a different root.
+        layer->clearClipRectsIncludingDescendants();
+    }
+
     // If we just entered compositing mode, the root will have become composited (as long as accelerated compositing is enabled).
     if (layer->isRootLayer()) {
         if (inCompositingMode() && m_hasAcceleratedCompositing)
@@ -878,6 +944,36 @@ void RenderLayerCompositor::computeCompositingRequirements(RenderLayer* layer, O
 
     if (layer->reflectionLayer() && updateLayerCompositingState(layer->reflectionLayer(), CompositingChangeRepaintNow))
         layersChanged = true;
+
+    if (willBeComposited) {
+        ++m_compositedLayerCount;
+        // The owner's opacity would apply to everything squashed into its backing.
+        bool canOwnSquashedLayers = compositedForOverlap && layer->isComposited() && !childState.m_subtreeIsCompositing
+            && !layer->isTransparent() && canSquashLayer(layer, compositingState);
+        compositingState.m_squashingOwner = canOwnSquashedLayers ? layer : 0;
+        compositingState.m_squashingOwnerCount = m_compositedLayerCount;
+    }
+}
+
+bool RenderLayerCompositor::canSquashLayer(const RenderLayer* layer, const CompositingState& compositingState) const
+{
+    RenderBoxModelObject* renderer = layer->renderer();
+    if (layer->isRootLayer() || layer->isReflection() || layer->hasTransform() || renderer->isReplaced()
+        || renderer->hasMask() || renderer->hasReflection() || renderer->style()->position() == FixedPosition)
+        return false;
+
+#if ENABLE(COMPOSITED_FIXED_ELEMENTS)
+    if (compositingState.m_fixedSibling)
+        return false;
+#endif
+
+    // The shared backing is positioned and clipped for the owner, so nothing between
+    // the siblings and their compositing ancestor may transform or clip them.
+    for (RenderLayer* curr = layer->parent(); curr && curr != compositingState.m_compositingAncestor; curr = curr->parent()) {
+        if (curr->hasTransform() || curr->renderer()->hasOverflowClip() || curr->renderer()->hasClip())
+            return false;
+    }
+    return true;
 }
 
 void RenderLayerCompositor::setCompositingParent(RenderLayer* childLayer, RenderLayer* parentLayer)
@@ -121,6 +121,9 @@ public:
 
     // Repaint the appropriate layers when the given RenderLayer starts or stops being composited.
     void repaintOnCompositingChange(RenderLayer*);
+
+    // Whether the last update painted some layer into a sibling's backing instead of its own.
+    bool hasSquashedLayers() const { return m_hasSquashedLayers; }
     
     // Notify us that a layer has been added or removed
     void layerWasAdded(RenderLayer* parent, RenderLayer* child);
@@ -224,6 +227,8 @@ private:
 
     // Returns true if any layer's compositing changed
     void computeCompositingRequirements(RenderLayer*, OverlapMap*, struct CompositingState&, bool& layersChanged);
+    // Whether a layer composited only for overlap can share a sibling's backing, or own such a backing.
+    bool canSquashLayer(const RenderLayer*, const struct CompositingState&) const;
     
     // Recurses down the tree, parenting descendant compositing layers and collecting an array of child layers for the current compositing layer.
     void rebuildCompositingLayerTree(RenderLayer* layer, const struct CompositingState&, Vector<GraphicsLayer*>& childGraphicsLayersOfEnclosingLayer);
@@ -291,6 +296,10 @@ private:
     bool m_compositingLayersNeedRebuild;
     bool m_flushingLayers;
     bool m_forceCompositingMode;
+    bool m_hasSquashedLayers;
+
+    // Layers given their own backing so far in the current computeCompositingRequirements() pass.
+    unsigned m_compositedLayerCount;
 
     RootLayerAttachment m_rootLayerAttachment;
 
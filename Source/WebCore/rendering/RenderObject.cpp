@@ -578,6 +578,8 @@ void RenderObject::setPreferredLogicalWidthsDirty(bool b, bool markParents)
 {
     bool alreadyDirty = m_preferredLogicalWidthsDirty;
     m_preferredLogicalWidthsDirty = b;
+    if (b && !alreadyDirty && isTableCell())
+        toRenderTableCell(this)->preferredLogicalWidthsDirtied();
     if (b && !alreadyDirty && markParents && (isText() || (style()->position() != FixedPosition && style()->position() != AbsolutePosition)))
         invalidateContainerPreferredLogicalWidths();
 }
@@ -595,6 +597,8 @@ void RenderObject::invalidateContainerPreferredLogicalWidths()
             break;
 
         o->m_preferredLogicalWidthsDirty = true;
+        if (o->isTableCell())
+            toRenderTableCell(o)->preferredLogicalWidthsDirtied();
         if (o->style()->position() == FixedPosition || o->style()->position() == AbsolutePosition)
             // A positioned object has no effect on the min/max width of its containing block ever.
             // We can optimize this case and not go up any further.
@@ -1169,6 +1173,8 @@ void RenderObject::repaintUsingContainer(RenderBoxModelObject* repaintContainer,
     if (v->usesCompositing()) {
         ASSERT(repaintContainer->hasLayer() && repaintContainer->layer()->isComposited());
         repaintContainer->layer()->setBackingNeedsRepaintInRect(r);
+        if (v->compositor()->hasSquashedLayers())
+            enclosingLayer()->setSquashingOwnerNeedsRepaintInRect(repaintContainer->layer(), r);
     }
 #else
     if (repaintContainer->isRenderView())
@@ -94,7 +94,14 @@ void RenderTable::styleDidChange(StyleDifference diff, const RenderStyle* oldSty
             m_tableLayout.set(new FixedTableLayout(this));
         else
             m_tableLayout.set(new AutoTableLayout(this));
-    }
+    } else
+        m_tableLayout->setNeedsFullRecalc();
+}
+
+void RenderTable::cellPreferredLogicalWidthsDirtied(RenderTableCell* cell)
+{
+    if (m_tableLayout)
+        m_tableLayout->cellPreferredLogicalWidthsDirtied(cell);
 }
 
 static inline void resetSectionPointerIfNotBefore(RenderTableSection*& ptr, RenderObject* before)
@@ -837,6 +844,9 @@ void RenderTable::recalcSections() const
     m_columns.resize(maxCols);
     m_columnPos.resize(maxCols + 1);
 
+    if (m_tableLayout)
+        m_tableLayout->setNeedsFullRecalc();
+
     ASSERT(selfNeedsLayout());
 
     m_needsSectionRecalc = false;
@@ -175,6 +175,10 @@ public:
     RenderTableCol* colElement(int col, bool* startEdge = 0, bool* endEdge = 0) const;
     RenderTableCol* nextColElement(RenderTableCol* current) const;
 
+    bool hasColElements() const { return m_hasColElements; }
+
+    void cellPreferredLogicalWidthsDirtied(RenderTableCell*);
+
     bool needsSectionRecalc() const { return m_needsSectionRecalc; }
     void setNeedsSectionRecalc()
     {
@@ -149,6 +149,17 @@ void RenderTableCell::computePreferredLogicalWidths()
     }
 }
 
+void RenderTableCell::preferredLogicalWidthsDirtied()
+{
+    // Cells get dirtied while they are being built and torn down, before or
+    // after they hang off a row, section and table.
+    RenderObject* row = parent();
+    RenderObject* section = row ? row->parent() : 0;
+    RenderObject* table = section ? section->parent() : 0;
+    if (table && table->isTable() && !documentBeingDestroyed())
+        toRenderTable(table)->cellPreferredLogicalWidthsDirtied(this);
+}
+
 void RenderTableCell::computeLogicalWidth()
 {
 #ifdef ANDROID_LAYOUT
@@ -55,6 +55,9 @@ public:
 
     virtual void computePreferredLogicalWidths();
 
+    // Lets the table recompute only this cell's column.
+    void preferredLogicalWidthsDirtied();
+
     void updateLogicalWidth(int);
 
     virtual int borderLeft() const;
@@ -44,6 +44,7 @@
 #include "VisiblePosition.h"
 #include "break_lines.h"
 #include <wtf/AlwaysInline.h>
+#include <wtf/HashMap.h>
 #include <wtf/text/StringBuffer.h>
 #include <wtf/unicode/CharacterNames.h>
 
@@ -53,6 +54,17 @@ using namespace Unicode;
 
 namespace WebCore {
 
+struct BreakablePositions {
+    bool breakNBSP;
+    Vector<int> positions;
+};
+
+typedef HashMap<const RenderText*, BreakablePositions*> BreakablePositionsMap;
+static BreakablePositionsMap* gBreakablePositionsMap = 0;
+
+// Shorter text isn't worth a cache entry.
+static const unsigned minimumLengthForCachedBreakablePositions = 64;
+
 static void makeCapitalized(String* string, UChar previous)
 {
     if (string->isNull())
@@ -107,6 +119,7 @@ RenderText::RenderText(Node* node, PassRefPtr<StringImpl> str)
      , m_isAllASCII(m_text.containsOnlyASCII())
      , m_knownToHaveNoOverflowAndNoFallbackFonts(false)
      , m_needsTranscoding(false)
+     , m_hasCachedBreakablePositions(false)
 {
     ASSERT(m_text);
 
@@ -196,6 +209,8 @@ void RenderText::removeAndDestroyTextBoxes()
 
 void RenderText::destroy()
 {
+    if (m_hasCachedBreakablePositions)
+        delete gBreakablePositionsMap->take(this);
     removeAndDestroyTextBoxes();
     RenderObject::destroy();
 }
@@ -1154,6 +1169,41 @@ void RenderText::setTextInternal(PassRefPtr<StringImpl> text)
     ASSERT(!isBR() || (textLength() == 1 && m_text[0] == '\n'));
 
     m_isAllASCII = m_text.containsOnlyASCII();
+
+    if (m_hasCachedBreakablePositions) {
+        delete gBreakablePositionsMap->take(this);
+        m_hasCachedBreakablePositions = false;
+    }
+}
+
+const Vector<int>* RenderText::breakablePositions(bool breakNBSP)
+{
+    // ASCII text is looked up in a table without ICU.
+    if (m_isAllASCII || textLength() < minimumLengthForCachedBreakablePositions)
+        return 0;
+
+    if (!gBreakablePositionsMap)
+        gBreakablePositionsMap = new BreakablePositionsMap;
+    BreakablePositions*& entry = gBreakablePositionsMap->add(this, 0).first->second;
+    if (!entry) {
+        entry = new BreakablePositions;
+        m_hasCachedBreakablePositions = true;
+    } else if (entry->breakNBSP == breakNBSP)
+        return &entry->positions;
+
+    entry->breakNBSP = breakNBSP;
+    entry->positions.clear();
+    int length = textLength();
+    LazyLineBreakIterator breakIterator(characters(), length);
+    for (int pos = 0; pos < length; ) {
+        int nextBreakable = nextBreakablePosition(breakIterator, pos, breakNBSP);
+        entry->positions.append(nextBreakable);
+        pos = nextBreakable + 1;
+    }
+    if (entry->positions.isEmpty() || entry->positions.last() != length)
+        entry->positions.append(length);
+    entry->positions.shrinkToFit();
+    return &entry->positions;
 }
 
 void RenderText::setText(PassRefPtr<StringImpl> text, bool force)
@@ -130,6 +130,12 @@ public:
 
     void removeAndDestroyTextBoxes();
 
+    // Line break opportunities in ascending order, ending with textLength().
+    // They are kept across layouts for text that needs the ICU line breaker,
+    // so reflowing at a new width doesn't scan it again. Returns 0 for text
+    // that is cheap to scan.
+    const Vector<int>* breakablePositions(bool breakNBSP);
+
 protected:
     virtual void styleWillChange(StyleDifference, const RenderStyle*) { }
     virtual void styleDidChange(StyleDifference, const RenderStyle* oldStyle);
@@ -183,6 +189,7 @@ private:
     bool m_isAllASCII : 1;
     mutable bool m_knownToHaveNoOverflowAndNoFallbackFonts : 1;
     bool m_needsTranscoding : 1;
+    bool m_hasCachedBreakablePositions : 1;
 };
 
 inline RenderText* toRenderText(RenderObject* object)
@@ -27,6 +27,7 @@
 namespace WebCore {
 
 class RenderTable;
+class RenderTableCell;
 
 class TableLayout {
     WTF_MAKE_NONCOPYABLE(TableLayout); WTF_MAKE_FAST_ALLOCATED;
@@ -41,6 +42,11 @@ public:
     virtual void computePreferredLogicalWidths(int& minWidth, int& maxWidth) = 0;
     virtual void layout() = 0;
 
+    // Called when the table's structure changes and when a cell's preferred
+    // widths become dirty, so layouts can keep per-column results around.
+    virtual void setNeedsFullRecalc() { }
+    virtual void cellPreferredLogicalWidthsDirtied(RenderTableCell*) { }
+
 protected:
     RenderTable* m_table;
 };
@@ -27,6 +27,7 @@
 #include "break_lines.h"
 
 #include "TextBreakIterator.h"
+#include <wtf/ASCIICType.h>
 #include <wtf/StdLibExtras.h>
 #include <wtf/unicode/CharacterNames.h>
 
@@ -149,6 +150,14 @@ static inline bool needsLineBreakIterator(UChar ch)
     return ch > asciiLineBreakTableLastChar && ch != noBreakSpace;
 }
 
+// Letters from ASCII and the Latin-1 Supplement all have the Unicode line breaking
+// class AL, and UAX #14 never allows a break between two AL characters. Runs of
+// accented Latin text can therefore be walked without consulting ICU.
+static inline bool isLatin1Letter(UChar ch)
+{
+    return isASCIIAlpha(ch) || (ch >= 0xC0 && ch <= 0xFF && ch != 0xD7 && ch != 0xF7);
+}
+
 #if PLATFORM(MAC) && defined(BUILDING_ON_TIGER)
 static inline TextBreakLocatorRef lineBreakLocator()
 {
@@ -171,7 +180,7 @@ int nextBreakablePosition(LazyLineBreakIterator& lazyBreakIterator, int pos, boo
         if (isBreakableSpace(ch, treatNoBreakSpaceAsBreak) || shouldBreakAfter(lastCh, ch))
             return i;
 
-        if (needsLineBreakIterator(ch) || needsLineBreakIterator(lastCh)) {
+        if ((needsLineBreakIterator(ch) || needsLineBreakIterator(lastCh)) && !(isLatin1Letter(ch) && isLatin1Letter(lastCh))) {
             if (nextBreak < i && i) {
 #if !PLATFORM(MAC) || !defined(BUILDING_ON_TIGER)
                 TextBreakIterator* breakIterator = lazyBreakIterator.get();
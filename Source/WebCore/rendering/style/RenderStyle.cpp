@@ -169,6 +169,27 @@ void RenderStyle::inheritFrom(const RenderStyle* inheritParent)
 #endif
 }
 
+void RenderStyle::copyNonInheritedFrom(const RenderStyle* other)
+{
+    m_box = other->m_box;
+    visual = other->visual;
+    m_background = other->m_background;
+    surround = other->surround;
+    rareNonInheritedData = other->rareNonInheritedData;
+
+    NonInheritedFlags matchingFlags = noninherited_flags;
+    noninherited_flags = other->noninherited_flags;
+    noninherited_flags._styleType = matchingFlags._styleType;
+    noninherited_flags._affectedByHover = matchingFlags._affectedByHover;
+    noninherited_flags._affectedByActive = matchingFlags._affectedByActive;
+    noninherited_flags._affectedByDrag = matchingFlags._affectedByDrag;
+    noninherited_flags._pseudoBits = matchingFlags._pseudoBits;
+    noninherited_flags._isLink = matchingFlags._isLink;
+#if ENABLE(SVG)
+    m_svgStyle = other->m_svgStyle;
+#endif
+}
+
 RenderStyle::~RenderStyle()
 {
 }
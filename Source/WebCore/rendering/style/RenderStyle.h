@@ -320,6 +320,8 @@ public:
     ~RenderStyle();
 
     void inheritFrom(const RenderStyle* inheritParent);
+    // Copies the non-inherited property values of |other|, leaving the bits that selector matching sets alone.
+    void copyNonInheritedFrom(const RenderStyle* other);
 
     PseudoId styleType() const { return static_cast<PseudoId>(noninherited_flags._styleType); }
     void setStyleType(PseudoId styleType) { noninherited_flags._styleType = styleType; }
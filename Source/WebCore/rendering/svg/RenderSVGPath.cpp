@@ -71,6 +71,9 @@ RenderSVGPath::RenderSVGPath(SVGStyledTransformableElement* node)
     , m_needsBoundariesUpdate(false) // default is false, the cached rects are empty from the beginning
     , m_needsPathUpdate(true) // default is true, so we grab a Path object once from SVGStyledTransformableElement
     , m_needsTransformUpdate(true) // default is true, so we grab a AffineTransform object once from SVGStyledTransformableElement
+#if USE(SKIA)
+    , m_hasValidStrokeOutline(false)
+#endif
 {
 }
 
@@ -99,10 +102,33 @@ bool RenderSVGPath::strokeContains(const FloatPoint& point, bool requiresStroke)
     if (requiresStroke && !RenderSVGResource::strokePaintingResource(this, style(), fallbackColor))
         return false;
 
+#if USE(SKIA)
+    return strokeOutline().contains(point, RULE_NONZERO);
+#else
     BoundingRectStrokeStyleApplier strokeStyle(this, style());
     return m_path.strokeContains(&strokeStyle, point);
+#endif
 }
 
+#if USE(SKIA)
+void RenderSVGPath::styleDidChange(StyleDifference diff, const RenderStyle* oldStyle)
+{
+    // Dashing and joins may change with only a repaint, so drop the outline for any style change.
+    m_hasValidStrokeOutline = false;
+    RenderSVGModelObject::styleDidChange(diff, oldStyle);
+}
+
+const Path& RenderSVGPath::strokeOutline()
+{
+    if (!m_hasValidStrokeOutline) {
+        BoundingRectStrokeStyleApplier strokeStyle(this, style());
+        m_strokeOutline = m_path.strokeOutline(&strokeStyle);
+        m_hasValidStrokeOutline = true;
+    }
+    return m_strokeOutline;
+}
+#endif
+
 void RenderSVGPath::layout()
 {
     LayoutRepainter repainter(*this, checkForRepaintDuringLayout() && selfNeedsLayout());
@@ -115,6 +141,9 @@ void RenderSVGPath::layout()
         m_path.clear();
         element->toPathData(m_path);
         m_needsPathUpdate = false;
+#if USE(SKIA)
+        m_hasValidStrokeOutline = false;
+#endif
         updateCachedBoundariesInParents = true;
     }
 
@@ -305,6 +334,11 @@ FloatRect RenderSVGPath::calculateMarkerBoundsIfNeeded()
 
 void RenderSVGPath::updateCachedBoundaries()
 {
+#if USE(SKIA)
+    m_hasValidStrokeOutline = false;
+    m_strokeOutline.clear();
+#endif
+
     if (m_path.isEmpty()) {
         m_fillBoundingBox = FloatRect();
         m_strokeAndMarkerBoundingBox = FloatRect();
@@ -320,8 +354,12 @@ void RenderSVGPath::updateCachedBoundaries()
 
     const SVGRenderStyle* svgStyle = style()->svgStyle();
     if (svgStyle->hasStroke()) {
+#if USE(SKIA)
+        m_strokeAndMarkerBoundingBox.unite(strokeOutline().boundingRect());
+#else
         BoundingRectStrokeStyleApplier strokeStyle(this, style());
         m_strokeAndMarkerBoundingBox.unite(m_path.strokeBoundingRect(&strokeStyle));
+#endif
     }
 
     if (svgStyle->hasMarkers()) {
@@ -72,11 +72,24 @@ private:
     virtual AffineTransform localTransform() const { return m_localTransform; }
     void fillAndStrokePath(GraphicsContext*);
 
+#if USE(SKIA)
+    virtual void styleDidChange(StyleDifference, const RenderStyle* oldStyle);
+    const Path& strokeOutline();
+#endif
+
     bool m_needsBoundariesUpdate : 1;
     bool m_needsPathUpdate : 1;
     bool m_needsTransformUpdate : 1;
+#if USE(SKIA)
+    bool m_hasValidStrokeOutline : 1;
+#endif
 
     mutable Path m_path;
+#if USE(SKIA)
+    // m_path run through the stroker with the current style. Computed for the stroke bounds
+    // during layout and kept so that stroke hit testing doesn't have to stroke the path again.
+    Path m_strokeOutline;
+#endif
     FloatRect m_fillBoundingBox;
     FloatRect m_strokeAndMarkerBoundingBox;
     FloatRect m_repaintBoundingBox;
@@ -38,6 +38,7 @@
 #include "SecurityOrigin.h"
 #include <wtf/HashMap.h>
 #include <wtf/HashSet.h>
+#include <wtf/OwnPtr.h>
 #include <wtf/PassRefPtr.h>
 #include <wtf/RefPtr.h>
 #include <wtf/StdLibExtras.h>
@@ -164,6 +165,18 @@ void AbstractDatabase::setIsAvailable(bool available)
     isDatabaseAvailable = available;
 }
 
+static bool isWriteAheadLoggingEnabled = false;
+
+bool AbstractDatabase::usesWriteAheadLogging()
+{
+    return isWriteAheadLoggingEnabled;
+}
+
+void AbstractDatabase::setUsesWriteAheadLogging(bool enabled)
+{
+    isWriteAheadLoggingEnabled = enabled;
+}
+
 // static
 const String& AbstractDatabase::databaseInfoTableName()
 {
@@ -250,6 +263,11 @@ bool AbstractDatabase::performOpenAndVerify(bool shouldSetVersionInNewDatabase,
     if (!m_sqliteDatabase.turnOnIncrementalAutoVacuum())
         LOG_ERROR("Unable to turn on incremental auto-vacuum for database %s", m_filename.ascii().data());
 
+    // A write-ahead log stays consistent at NORMAL even across power loss, which
+    // can only roll back the last commits, so skip the sync on every commit.
+    if (isWriteAheadLoggingEnabled && m_sqliteDatabase.enableWriteAheadLogging())
+        m_sqliteDatabase.setSynchronous(SQLiteDatabase::SyncNormal);
+
     ASSERT(m_databaseAuthorizer);
     m_sqliteDatabase.setAuthorizer(m_databaseAuthorizer);
     m_sqliteDatabase.setBusyTimeout(maxSqliteBusyWaitTime);
@@ -468,6 +486,25 @@ void AbstractDatabase::resetAuthorizer()
         m_databaseAuthorizer->reset();
 }
 
+PassOwnPtr<SQLiteStatement> AbstractDatabase::prepareCachedStatement(const String& query, int permissions, unsigned& authorizerActions, int& result)
+{
+    ASSERT(m_databaseAuthorizer);
+    result = SQLResultOk;
+
+    OwnPtr<SQLiteStatement> statement = m_sqliteDatabase.takeCachedStatement(query, permissions, authorizerActions);
+    if (statement) {
+        m_databaseAuthorizer->addActions(authorizerActions);
+        return statement.release();
+    }
+
+    statement = adoptPtr(new SQLiteStatement(m_sqliteDatabase, query));
+    unsigned earlierActions = m_databaseAuthorizer->takeActions();
+    result = statement->prepare();
+    authorizerActions = m_databaseAuthorizer->takeActions();
+    m_databaseAuthorizer->addActions(earlierActions | authorizerActions);
+    return statement.release();
+}
+
 unsigned long long AbstractDatabase::maximumSize() const
 {
     return DatabaseTracker::tracker().getMaxSizeForDatabase(this);
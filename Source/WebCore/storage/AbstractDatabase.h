@@ -45,12 +45,17 @@ namespace WebCore {
 class DatabaseAuthorizer;
 class ScriptExecutionContext;
 class SecurityOrigin;
+class SQLiteStatement;
 
 class AbstractDatabase : public ThreadSafeRefCounted<AbstractDatabase> {
 public:
     static bool isAvailable();
     static void setIsAvailable(bool available);
 
+    // Off by default; databases opened afterwards journal to a write-ahead log.
+    static bool usesWriteAheadLogging();
+    static void setUsesWriteAheadLogging(bool);
+
     virtual ~AbstractDatabase();
 
     virtual String version() const;
@@ -87,6 +92,12 @@ public:
     bool hadDeletes();
     void resetAuthorizer();
 
+    // Prepares |query| for a statement running with |permissions|, or takes the
+    // statement an earlier run left in the SQLite database's statement cache.
+    // Hand it back with sqliteDatabase().cacheStatement(statement, permissions,
+    // authorizerActions) once it has run.
+    PassOwnPtr<SQLiteStatement> prepareCachedStatement(const String& query, int permissions, unsigned& authorizerActions, int& result);
+
     virtual void markAsDeletedAndClose() = 0;
     virtual void closeImmediately() = 0;
 
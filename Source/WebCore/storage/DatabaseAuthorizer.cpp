@@ -61,6 +61,27 @@ void DatabaseAuthorizer::resetDeletes()
     m_hadDeletes = false;
 }
 
+unsigned DatabaseAuthorizer::takeActions()
+{
+    unsigned actions = (m_lastActionWasInsert ? InsertAction : 0)
+        | (m_lastActionChangedDatabase ? ChangeAction : 0)
+        | (m_hadDeletes ? DeleteAction : 0);
+    m_lastActionWasInsert = false;
+    m_lastActionChangedDatabase = false;
+    m_hadDeletes = false;
+    return actions;
+}
+
+void DatabaseAuthorizer::addActions(unsigned actions)
+{
+    if (actions & InsertAction)
+        m_lastActionWasInsert = true;
+    if (actions & ChangeAction)
+        m_lastActionChangedDatabase = true;
+    if (actions & DeleteAction)
+        m_hadDeletes = true;
+}
+
 void DatabaseAuthorizer::addWhitelistedFunctions()
 {
     // SQLite functions used to help implement some operations
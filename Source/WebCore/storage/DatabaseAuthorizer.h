@@ -103,6 +103,17 @@ public:
     bool lastActionChangedDatabase() const { return m_lastActionChangedDatabase; }
     bool hadDeletes() const { return m_hadDeletes; }
 
+    // The three flags above as one mask. SQLite consults the authorizer only
+    // while preparing, so a statement that is reused without being prepared
+    // again has to add back the actions it recorded the first time.
+    enum Action {
+        InsertAction = 1 << 0,
+        ChangeAction = 1 << 1,
+        DeleteAction = 1 << 2
+    };
+    unsigned takeActions();
+    void addActions(unsigned actions);
+
 private:
     DatabaseAuthorizer(const String& databaseInfoTableName);
     void addWhitelistedFunctions();
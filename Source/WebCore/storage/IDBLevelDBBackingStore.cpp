@@ -37,6 +37,7 @@
 #include "LevelDBDatabase.h"
 #include "LevelDBIterator.h"
 #include "LevelDBSlice.h"
+#include "LevelDBTransaction.h"
 #include "SecurityOrigin.h"
 
 #ifndef INT64_MAX
@@ -464,34 +465,34 @@ static int compareEncodedIDBKeys(const Vector<char>& keyA, const Vector<char>& k
     return 0;
 }
 
-static bool getInt(LevelDBDatabase* db, const Vector<char>& key, int64_t& foundInt)
+static bool getInt(LevelDBTransaction* transaction, const Vector<char>& key, int64_t& foundInt)
 {
     Vector<char> result;
-    if (!db->get(key, result))
+    if (!transaction->get(key, result))
         return false;
 
     foundInt = decodeInt(result.begin(), result.end());
     return true;
 }
 
-static bool putInt(LevelDBDatabase* db, const Vector<char>& key, int64_t value)
+static bool putInt(LevelDBTransaction* transaction, const Vector<char>& key, int64_t value)
 {
-    return db->put(key, encodeInt(value));
+    return transaction->put(key, encodeInt(value));
 }
 
-static bool getString(LevelDBDatabase* db, const Vector<char>& key, String& foundString)
+static bool getString(LevelDBTransaction* transaction, const Vector<char>& key, String& foundString)
 {
     Vector<char> result;
-    if (!db->get(key, result))
+    if (!transaction->get(key, result))
         return false;
 
     foundString = decodeString(result.begin(), result.end());
     return true;
 }
 
-static bool putString(LevelDBDatabase* db, const Vector<char> key, const String& value)
+static bool putString(LevelDBTransaction* transaction, const Vector<char> key, const String& value)
 {
-    if (!db->put(key, encodeString(value)))
+    if (!transaction->put(key, encodeString(value)))
         return false;
     return true;
 }
@@ -1441,14 +1442,42 @@ public:
 };
 }
 
-static bool setUpMetadata(LevelDBDatabase* db)
+// Calls made while no IDB transaction is running, such as reading a database's
+// metadata when it is opened, get a LevelDB transaction of their own that
+// commits when the call returns.
+class IDBLevelDBBackingStore::TransactionScope {
+    WTF_MAKE_NONCOPYABLE(TransactionScope);
+public:
+    explicit TransactionScope(IDBLevelDBBackingStore* backingStore)
+        : m_transaction(backingStore->m_currentTransaction)
+        , m_isImplicit(!m_transaction)
+    {
+        if (m_isImplicit)
+            m_transaction = LevelDBTransaction::create(backingStore->m_db.get(), backingStore->m_comparator.get());
+    }
+
+    ~TransactionScope()
+    {
+        if (m_isImplicit && !m_transaction->commit())
+            LOG_ERROR("Failed to commit an IndexedDB backing store write");
+    }
+
+    LevelDBTransaction* get() const { return m_transaction.get(); }
+    LevelDBTransaction* operator->() const { return m_transaction.get(); }
+
+private:
+    RefPtr<LevelDBTransaction> m_transaction;
+    bool m_isImplicit;
+};
+
+static bool setUpMetadata(LevelDBTransaction* transaction)
 {
     const Vector<char> metaDataKey = SchemaVersionKey::encode();
 
     int64_t schemaVersion;
-    if (!getInt(db, metaDataKey, schemaVersion)) {
+    if (!getInt(transaction, metaDataKey, schemaVersion)) {
         schemaVersion = 0;
-        if (!putInt(db, metaDataKey, schemaVersion))
+        if (!putInt(transaction, metaDataKey, schemaVersion))
             return false;
     }
 
@@ -1498,7 +1527,8 @@ PassRefPtr<IDBBackingStore> IDBLevelDBBackingStore::open(SecurityOrigin* securit
     RefPtr<IDBLevelDBBackingStore> backingStore(adoptRef(new IDBLevelDBBackingStore(fileIdentifier, factory, db)));
     backingStore->m_comparator = comparator.release();
 
-    if (!setUpMetadata(backingStore->m_db.get()))
+    TransactionScope transaction(backingStore.get());
+    if (!setUpMetadata(transaction.get()))
         return 0;
 
     return backingStore.release();
@@ -1506,25 +1536,26 @@ PassRefPtr<IDBBackingStore> IDBLevelDBBackingStore::open(SecurityOrigin* securit
 
 bool IDBLevelDBBackingStore::extractIDBDatabaseMetaData(const String& name, String& foundVersion, int64_t& foundId)
 {
+    TransactionScope transaction(this);
     const Vector<char> key = DatabaseNameKey::encode(m_identifier, name);
 
-    bool ok = getInt(m_db.get(), key, foundId);
+    bool ok = getInt(transaction.get(), key, foundId);
     if (!ok)
         return false;
 
-    ok = getString(m_db.get(), DatabaseMetaDataKey::encode(foundId, DatabaseMetaDataKey::kUserVersion), foundVersion);
+    ok = getString(transaction.get(), DatabaseMetaDataKey::encode(foundId, DatabaseMetaDataKey::kUserVersion), foundVersion);
     if (!ok)
         return false;
 
     return true;
 }
 
-static int64_t getNewDatabaseId(LevelDBDatabase* db)
+static int64_t getNewDatabaseId(LevelDBTransaction* transaction)
 {
     const Vector<char> freeListStartKey = DatabaseFreeListKey::encode(0);
     const Vector<char> freeListStopKey = DatabaseFreeListKey::encode(INT64_MAX);
 
-    OwnPtr<LevelDBIterator> it(db->newIterator());
+    OwnPtr<LevelDBIterator> it(transaction->newIterator());
     for (it->seek(freeListStartKey); it->isValid() && compareKeys(it->key(), freeListStopKey) < 0; it->next()) {
         const char *p = it->key().begin();
         const char *limit = it->key().end();
@@ -1533,7 +1564,7 @@ static int64_t getNewDatabaseId(LevelDBDatabase* db)
         p = DatabaseFreeListKey::decode(p, limit, &freeListKey);
         ASSERT(p);
 
-        bool ok = db->remove(it->key());
+        bool ok = transaction->remove(it->key());
         ASSERT_UNUSED(ok, ok);
 
         return freeListKey.databaseId();
@@ -1541,13 +1572,13 @@ static int64_t getNewDatabaseId(LevelDBDatabase* db)
 
     // If we got here, there was no free-list.
     int64_t maxDatabaseId = -1;
-    if (!getInt(db, MaxDatabaseIdKey::encode(), maxDatabaseId))
+    if (!getInt(transaction, MaxDatabaseIdKey::encode(), maxDatabaseId))
         maxDatabaseId = 0;
 
     ASSERT(maxDatabaseId >= 0);
 
     int64_t databaseId = maxDatabaseId + 1;
-    bool ok = putInt(db, MaxDatabaseIdKey::encode(), databaseId);
+    bool ok = putInt(transaction, MaxDatabaseIdKey::encode(), databaseId);
     ASSERT_UNUSED(ok, ok);
 
     return databaseId;
@@ -1556,15 +1587,16 @@ static int64_t getNewDatabaseId(LevelDBDatabase* db)
 
 bool IDBLevelDBBackingStore::setIDBDatabaseMetaData(const String& name, const String& version, int64_t& rowId, bool invalidRowId)
 {
+    TransactionScope transaction(this);
     if (invalidRowId) {
-        rowId = getNewDatabaseId(m_db.get());
+        rowId = getNewDatabaseId(transaction.get());
 
         const Vector<char> key = DatabaseNameKey::encode(m_identifier, name);
-        if (!putInt(m_db.get(), key, rowId))
+        if (!putInt(transaction.get(), key, rowId))
             return false;
     }
 
-    if (!putString(m_db.get(), DatabaseMetaDataKey::encode(rowId, DatabaseMetaDataKey::kUserVersion), version))
+    if (!putString(transaction.get(), DatabaseMetaDataKey::encode(rowId, DatabaseMetaDataKey::kUserVersion), version))
         return false;
 
     return true;
@@ -1572,10 +1604,11 @@ bool IDBLevelDBBackingStore::setIDBDatabaseMetaData(const String& name, const St
 
 void IDBLevelDBBackingStore::getObjectStores(int64_t databaseId, Vector<int64_t>& foundIds, Vector<String>& foundNames, Vector<String>& foundKeyPaths, Vector<bool>& foundAutoIncrementFlags)
 {
+    TransactionScope transaction(this);
     const Vector<char> startKey = ObjectStoreMetaDataKey::encode(databaseId, 1, 0);
     const Vector<char> stopKey = ObjectStoreMetaDataKey::encode(databaseId, INT64_MAX, 0);
 
-    OwnPtr<LevelDBIterator> it(m_db->newIterator());
+    OwnPtr<LevelDBIterator> it(transaction->newIterator());
     for (it->seek(startKey); it->isValid() && compareKeys(it->key(), stopKey) < 0; it->next()) {
         const char *p = it->key().begin();
         const char *limit = it->key().end();
@@ -1627,12 +1660,12 @@ void IDBLevelDBBackingStore::getObjectStores(int64_t databaseId, Vector<int64_t>
     }
 }
 
-static int64_t getNewObjectStoreId(LevelDBDatabase* db, int64_t databaseId)
+static int64_t getNewObjectStoreId(LevelDBTransaction* transaction, int64_t databaseId)
 {
     const Vector<char> freeListStartKey = ObjectStoreFreeListKey::encode(databaseId, 0);
     const Vector<char> freeListStopKey = ObjectStoreFreeListKey::encode(databaseId, INT64_MAX);
 
-    OwnPtr<LevelDBIterator> it(db->newIterator());
+    OwnPtr<LevelDBIterator> it(transaction->newIterator());
     for (it->seek(freeListStartKey); it->isValid() && compareKeys(it->key(), freeListStopKey) < 0; it->next()) {
         const char* p = it->key().begin();
         const char* limit = it->key().end();
@@ -1641,7 +1674,7 @@ static int64_t getNewObjectStoreId(LevelDBDatabase* db, int64_t databaseId)
         p = ObjectStoreFreeListKey::decode(p, limit, &freeListKey);
         ASSERT(p);
 
-        bool ok = db->remove(it->key());
+        bool ok = transaction->remove(it->key());
         ASSERT_UNUSED(ok, ok);
 
         return freeListKey.objectStoreId();
@@ -1649,11 +1682,11 @@ static int64_t getNewObjectStoreId(LevelDBDatabase* db, int64_t databaseId)
 
     int64_t maxObjectStoreId;
     const Vector<char> maxObjectStoreIdKey = DatabaseMetaDataKey::encode(databaseId, DatabaseMetaDataKey::kMaxObjectStoreId);
-    if (!getInt(db, maxObjectStoreIdKey, maxObjectStoreId))
+    if (!getInt(transaction, maxObjectStoreIdKey, maxObjectStoreId))
         maxObjectStoreId = 0;
 
     int64_t objectStoreId = maxObjectStoreId + 1;
-    bool ok = putInt(db, maxObjectStoreIdKey, objectStoreId);
+    bool ok = putInt(transaction, maxObjectStoreIdKey, objectStoreId);
     ASSERT_UNUSED(ok, ok);
 
     return objectStoreId;
@@ -1661,7 +1694,8 @@ static int64_t getNewObjectStoreId(LevelDBDatabase* db, int64_t databaseId)
 
 bool IDBLevelDBBackingStore::createObjectStore(int64_t databaseId, const String& name, const String& keyPath, bool autoIncrement, int64_t& assignedObjectStoreId)
 {
-    int64_t objectStoreId = getNewObjectStoreId(m_db.get(), databaseId);
+    TransactionScope transaction(this);
+    int64_t objectStoreId = getNewObjectStoreId(transaction.get(), databaseId);
 
     const Vector<char> nameKey = ObjectStoreMetaDataKey::encode(databaseId, objectStoreId, 0);
     const Vector<char> keyPathKey = ObjectStoreMetaDataKey::encode(databaseId, objectStoreId, 1);
@@ -1671,43 +1705,43 @@ bool IDBLevelDBBackingStore::createObjectStore(int64_t databaseId, const String&
     const Vector<char> maxIndexIdKey = ObjectStoreMetaDataKey::encode(databaseId, objectStoreId, 5);
     const Vector<char> namesKey = ObjectStoreNamesKey::encode(databaseId, name);
 
-    bool ok = putString(m_db.get(), nameKey, name);
+    bool ok = putString(transaction.get(), nameKey, name);
     if (!ok) {
         LOG_ERROR("Internal Indexed DB error.");
         return false;
     }
 
-    ok = putString(m_db.get(), keyPathKey, keyPath);
+    ok = putString(transaction.get(), keyPathKey, keyPath);
     if (!ok) {
         LOG_ERROR("Internal Indexed DB error.");
         return false;
     }
 
-    ok = putInt(m_db.get(), autoIncrementKey, autoIncrement);
+    ok = putInt(transaction.get(), autoIncrementKey, autoIncrement);
     if (!ok) {
         LOG_ERROR("Internal Indexed DB error.");
         return false;
     }
 
-    ok = putInt(m_db.get(), evictableKey, false);
+    ok = putInt(transaction.get(), evictableKey, false);
     if (!ok) {
         LOG_ERROR("Internal Indexed DB error.");
         return false;
     }
 
-    ok = putInt(m_db.get(), lastVersionKey, 1);
+    ok = putInt(transaction.get(), lastVersionKey, 1);
     if (!ok) {
         LOG_ERROR("Internal Indexed DB error.");
         return false;
     }
 
-    ok = putInt(m_db.get(), maxIndexIdKey, kMinimumIndexId);
+    ok = putInt(transaction.get(), maxIndexIdKey, kMinimumIndexId);
     if (!ok) {
         LOG_ERROR("Internal Indexed DB error.");
         return false;
     }
 
-    ok = putInt(m_db.get(), namesKey, objectStoreId);
+    ok = putInt(transaction.get(), namesKey, objectStoreId);
     if (!ok) {
         LOG_ERROR("Internal Indexed DB error.");
         return false;
@@ -1718,12 +1752,12 @@ bool IDBLevelDBBackingStore::createObjectStore(int64_t databaseId, const String&
     return true;
 }
 
-static bool deleteRange(LevelDBDatabase* db, const Vector<char>& begin, const Vector<char>& end)
+static bool deleteRange(LevelDBTransaction* transaction, const Vector<char>& begin, const Vector<char>& end)
 {
     // FIXME: LevelDB may be able to provide a bulk operation that we can do first.
-    OwnPtr<LevelDBIterator> it(db->newIterator());
+    OwnPtr<LevelDBIterator> it(transaction->newIterator());
     for (it->seek(begin); it->isValid() && compareKeys(it->key(), end) < 0; it->next()) {
-        if (!db->remove(it->key()))
+        if (!transaction->remove(it->key()))
             return false;
     }
 
@@ -1732,18 +1766,19 @@ static bool deleteRange(LevelDBDatabase* db, const Vector<char>& begin, const Ve
 
 void IDBLevelDBBackingStore::deleteObjectStore(int64_t databaseId, int64_t objectStoreId)
 {
+    TransactionScope transaction(this);
     String objectStoreName;
-    getString(m_db.get(), ObjectStoreMetaDataKey::encode(databaseId, objectStoreId, 0), objectStoreName);
+    getString(transaction.get(), ObjectStoreMetaDataKey::encode(databaseId, objectStoreId, 0), objectStoreName);
 
-    if (!deleteRange(m_db.get(), ObjectStoreMetaDataKey::encode(databaseId, objectStoreId, 0), ObjectStoreMetaDataKey::encode(databaseId, objectStoreId, 6)))
+    if (!deleteRange(transaction.get(), ObjectStoreMetaDataKey::encode(databaseId, objectStoreId, 0), ObjectStoreMetaDataKey::encode(databaseId, objectStoreId, 6)))
         return; // FIXME: Report error.
 
-    putString(m_db.get(), ObjectStoreFreeListKey::encode(databaseId, objectStoreId), "");
-    m_db->remove(ObjectStoreNamesKey::encode(databaseId, objectStoreName));
+    putString(transaction.get(), ObjectStoreFreeListKey::encode(databaseId, objectStoreId), "");
+    transaction->remove(ObjectStoreNamesKey::encode(databaseId, objectStoreName));
 
-    if (!deleteRange(m_db.get(), IndexFreeListKey::encode(databaseId, objectStoreId, 0), IndexFreeListKey::encode(databaseId, objectStoreId, INT64_MAX)))
+    if (!deleteRange(transaction.get(), IndexFreeListKey::encode(databaseId, objectStoreId, 0), IndexFreeListKey::encode(databaseId, objectStoreId, INT64_MAX)))
         return; // FIXME: Report error.
-    if (!deleteRange(m_db.get(), IndexMetaDataKey::encode(databaseId, objectStoreId, 0, 0), IndexMetaDataKey::encode(databaseId, objectStoreId, INT64_MAX, 0)))
+    if (!deleteRange(transaction.get(), IndexMetaDataKey::encode(databaseId, objectStoreId, 0, 0), IndexMetaDataKey::encode(databaseId, objectStoreId, INT64_MAX, 0)))
         return; // FIXME: Report error.
 
     clearObjectStore(databaseId, objectStoreId);
@@ -1751,10 +1786,11 @@ void IDBLevelDBBackingStore::deleteObjectStore(int64_t databaseId, int64_t objec
 
 String IDBLevelDBBackingStore::getObjectStoreRecord(int64_t databaseId, int64_t objectStoreId, const IDBKey& key)
 {
+    TransactionScope transaction(this);
     const Vector<char> leveldbKey = ObjectStoreDataKey::encode(databaseId, objectStoreId, key);
     Vector<char> data;
 
-    if (!m_db->get(leveldbKey, data))
+    if (!transaction->get(leveldbKey, data))
         return String();
 
     int64_t version;
@@ -1787,18 +1823,18 @@ private:
 };
 }
 
-static int64_t getNewVersionNumber(LevelDBDatabase* db, int64_t databaseId, int64_t objectStoreId)
+static int64_t getNewVersionNumber(LevelDBTransaction* transaction, int64_t databaseId, int64_t objectStoreId)
 {
     const Vector<char> lastVersionKey = ObjectStoreMetaDataKey::encode(databaseId, objectStoreId, 4);
 
     int64_t lastVersion = -1;
-    if (!getInt(db, lastVersionKey, lastVersion))
+    if (!getInt(transaction, lastVersionKey, lastVersion))
         lastVersion = 0;
 
     ASSERT(lastVersion >= 0);
 
     int64_t version = lastVersion + 1;
-    bool ok = putInt(db, lastVersionKey, version);
+    bool ok = putInt(transaction, lastVersionKey, version);
     ASSERT_UNUSED(ok, ok);
 
     ASSERT(version > lastVersion); // FIXME: Think about how we want to handle the overflow scenario.
@@ -1808,18 +1844,19 @@ static int64_t getNewVersionNumber(LevelDBDatabase* db, int64_t databaseId, int6
 
 bool IDBLevelDBBackingStore::putObjectStoreRecord(int64_t databaseId, int64_t objectStoreId, const IDBKey& key, const String& value, ObjectStoreRecordIdentifier* recordIdentifier)
 {
-    int64_t version = getNewVersionNumber(m_db.get(), databaseId, objectStoreId);
+    TransactionScope transaction(this);
+    int64_t version = getNewVersionNumber(transaction.get(), databaseId, objectStoreId);
     const Vector<char> objectStoredataKey = ObjectStoreDataKey::encode(databaseId, objectStoreId, key);
 
     Vector<char> v;
     v.append(encodeVarInt(version));
     v.append(encodeString(value));
 
-    if (!m_db->put(objectStoredataKey, v))
+    if (!transaction->put(objectStoredataKey, v))
         return false;
 
     const Vector<char> existsEntryKey = ExistsEntryKey::encode(databaseId, objectStoreId, key);
-    if (!m_db->put(existsEntryKey, encodeInt(version)))
+    if (!transaction->put(existsEntryKey, encodeInt(version)))
         return false;
 
     LevelDBRecordIdentifier* levelDBRecordIdentifier = static_cast<LevelDBRecordIdentifier*>(recordIdentifier);
@@ -1830,10 +1867,11 @@ bool IDBLevelDBBackingStore::putObjectStoreRecord(int64_t databaseId, int64_t ob
 
 void IDBLevelDBBackingStore::clearObjectStore(int64_t databaseId, int64_t objectStoreId)
 {
+    TransactionScope transaction(this);
     const Vector<char> startKey = KeyPrefix(databaseId, objectStoreId, 0).encode();
     const Vector<char> stopKey = KeyPrefix(databaseId, objectStoreId + 1, 0).encode();
 
-    deleteRange(m_db.get(), startKey, stopKey);
+    deleteRange(transaction.get(), startKey, stopKey);
 }
 
 PassRefPtr<IDBBackingStore::ObjectStoreRecordIdentifier> IDBLevelDBBackingStore::createInvalidRecordIdentifier()
@@ -1843,17 +1881,19 @@ PassRefPtr<IDBBackingStore::ObjectStoreRecordIdentifier> IDBLevelDBBackingStore:
 
 void IDBLevelDBBackingStore::deleteObjectStoreRecord(int64_t databaseId, int64_t objectStoreId, const ObjectStoreRecordIdentifier* recordIdentifier)
 {
+    TransactionScope transaction(this);
     const LevelDBRecordIdentifier* levelDBRecordIdentifier = static_cast<const LevelDBRecordIdentifier*>(recordIdentifier);
     const Vector<char> key = ObjectStoreDataKey::encode(databaseId, objectStoreId, levelDBRecordIdentifier->primaryKey());
-    m_db->remove(key);
+    transaction->remove(key);
 }
 
 double IDBLevelDBBackingStore::nextAutoIncrementNumber(int64_t databaseId, int64_t objectStoreId)
 {
+    TransactionScope transaction(this);
     const Vector<char> startKey = ObjectStoreDataKey::encode(databaseId, objectStoreId, minIDBKey());
     const Vector<char> stopKey = ObjectStoreDataKey::encode(databaseId, objectStoreId, maxIDBKey());
 
-    OwnPtr<LevelDBIterator> it(m_db->newIterator());
+    OwnPtr<LevelDBIterator> it(transaction->newIterator());
 
     int maxNumericKey = 0;
 
@@ -1879,10 +1919,11 @@ double IDBLevelDBBackingStore::nextAutoIncrementNumber(int64_t databaseId, int64
 
 bool IDBLevelDBBackingStore::keyExistsInObjectStore(int64_t databaseId, int64_t objectStoreId, const IDBKey& key, ObjectStoreRecordIdentifier* foundRecordIdentifier)
 {
+    TransactionScope transaction(this);
     const Vector<char> leveldbKey = ObjectStoreDataKey::encode(databaseId, objectStoreId, key);
     Vector<char> data;
 
-    if (!m_db->get(leveldbKey, data))
+    if (!transaction->get(leveldbKey, data))
         return false;
 
     int64_t version;
@@ -1897,10 +1938,11 @@ bool IDBLevelDBBackingStore::keyExistsInObjectStore(int64_t databaseId, int64_t
 
 bool IDBLevelDBBackingStore::forEachObjectStoreRecord(int64_t databaseId, int64_t objectStoreId, ObjectStoreRecordCallback& callback)
 {
+    TransactionScope transaction(this);
     const Vector<char> startKey = ObjectStoreDataKey::encode(databaseId, objectStoreId, minIDBKey());
     const Vector<char> stopKey = ObjectStoreDataKey::encode(databaseId, objectStoreId, maxIDBKey());
 
-    OwnPtr<LevelDBIterator> it(m_db->newIterator());
+    OwnPtr<LevelDBIterator> it(transaction->newIterator());
     for (it->seek(startKey); it->isValid() && compareKeys(it->key(), stopKey) < 0; it->next()) {
         const char *p = it->key().begin();
         const char *limit = it->key().end();
@@ -1926,10 +1968,11 @@ bool IDBLevelDBBackingStore::forEachObjectStoreRecord(int64_t databaseId, int64_
 
 void IDBLevelDBBackingStore::getIndexes(int64_t databaseId, int64_t objectStoreId, Vector<int64_t>& foundIds, Vector<String>& foundNames, Vector<String>& foundKeyPaths, Vector<bool>& foundUniqueFlags)
 {
+    TransactionScope transaction(this);
     const Vector<char> startKey = IndexMetaDataKey::encode(databaseId, objectStoreId, 0, 0);
     const Vector<char> stopKey = IndexMetaDataKey::encode(databaseId, objectStoreId + 1, 0, 0);
 
-    OwnPtr<LevelDBIterator> it(m_db->newIterator());
+    OwnPtr<LevelDBIterator> it(transaction->newIterator());
     for (it->seek(startKey); it->isValid() && compareKeys(it->key(), stopKey) < 0; it->next()) {
         const char* p = it->key().begin();
         const char* limit = it->key().end();
@@ -1964,12 +2007,12 @@ void IDBLevelDBBackingStore::getIndexes(int64_t databaseId, int64_t objectStoreI
     }
 }
 
-static int64_t getNewIndexId(LevelDBDatabase* db, int64_t databaseId, int64_t objectStoreId)
+static int64_t getNewIndexId(LevelDBTransaction* transaction, int64_t databaseId, int64_t objectStoreId)
 {
     const Vector<char> startKey = IndexFreeListKey::encode(databaseId, objectStoreId, 0);
     const Vector<char> stopKey = IndexFreeListKey::encode(databaseId, objectStoreId, INT64_MAX);
 
-    OwnPtr<LevelDBIterator> it(db->newIterator());
+    OwnPtr<LevelDBIterator> it(transaction->newIterator());
     for (it->seek(startKey); it->isValid() && compareKeys(it->key(), stopKey) < 0; it->next()) {
         const char* p = it->key().begin();
         const char* limit = it->key().end();
@@ -1978,7 +2021,7 @@ static int64_t getNewIndexId(LevelDBDatabase* db, int64_t databaseId, int64_t ob
         p = IndexFreeListKey::decode(p, limit, &freeListKey);
         ASSERT(p);
 
-        bool ok = db->remove(it->key());
+        bool ok = transaction->remove(it->key());
         ASSERT_UNUSED(ok, ok);
 
         ASSERT(freeListKey.indexId() >= kMinimumIndexId);
@@ -1987,11 +2030,11 @@ static int64_t getNewIndexId(LevelDBDatabase* db, int64_t databaseId, int64_t ob
 
     int64_t maxIndexId;
     const Vector<char> maxIndexIdKey = ObjectStoreMetaDataKey::encode(databaseId, objectStoreId, 5);
-    if (!getInt(db, maxIndexIdKey, maxIndexId))
+    if (!getInt(transaction, maxIndexIdKey, maxIndexId))
         maxIndexId = kMinimumIndexId;
 
     int64_t indexId = maxIndexId + 1;
-    bool ok = putInt(db, maxIndexIdKey, indexId);
+    bool ok = putInt(transaction, maxIndexIdKey, indexId);
     if (!ok)
         return false;
 
@@ -2000,25 +2043,26 @@ static int64_t getNewIndexId(LevelDBDatabase* db, int64_t databaseId, int64_t ob
 
 bool IDBLevelDBBackingStore::createIndex(int64_t databaseId, int64_t objectStoreId, const String& name, const String& keyPath, bool isUnique, int64_t& indexId)
 {
-    indexId = getNewIndexId(m_db.get(), databaseId, objectStoreId);
+    TransactionScope transaction(this);
+    indexId = getNewIndexId(transaction.get(), databaseId, objectStoreId);
 
     const Vector<char> nameKey = IndexMetaDataKey::encode(databaseId, objectStoreId, indexId, 0);
     const Vector<char> uniqueKey = IndexMetaDataKey::encode(databaseId, objectStoreId, indexId, 1);
     const Vector<char> keyPathKey = IndexMetaDataKey::encode(databaseId, objectStoreId, indexId, 2);
 
-    bool ok = putString(m_db.get(), nameKey, name);
+    bool ok = putString(transaction.get(), nameKey, name);
     if (!ok) {
         LOG_ERROR("Internal Indexed DB error.");
         return false;
     }
 
-    ok = putInt(m_db.get(), uniqueKey, isUnique);
+    ok = putInt(transaction.get(), uniqueKey, isUnique);
     if (!ok) {
         LOG_ERROR("Internal Indexed DB error.");
         return false;
     }
 
-    ok = putString(m_db.get(), keyPathKey, keyPath);
+    ok = putString(transaction.get(), keyPathKey, keyPath);
     if (!ok) {
         LOG_ERROR("Internal Indexed DB error.");
         return false;
@@ -2035,22 +2079,23 @@ void IDBLevelDBBackingStore::deleteIndex(int64_t, int64_t, int64_t)
 
 bool IDBLevelDBBackingStore::putIndexDataForRecord(int64_t databaseId, int64_t objectStoreId, int64_t indexId, const IDBKey& key, const ObjectStoreRecordIdentifier* recordIdentifier)
 {
+    TransactionScope transaction(this);
     ASSERT(indexId >= kMinimumIndexId);
     const LevelDBRecordIdentifier* levelDBRecordIdentifier = static_cast<const LevelDBRecordIdentifier*>(recordIdentifier);
 
-    const int64_t globalSequenceNumber = getNewVersionNumber(m_db.get(), databaseId, objectStoreId);
+    const int64_t globalSequenceNumber = getNewVersionNumber(transaction.get(), databaseId, objectStoreId);
     const Vector<char> indexDataKey = IndexDataKey::encode(databaseId, objectStoreId, indexId, key, globalSequenceNumber);
 
     Vector<char> data;
     data.append(encodeVarInt(levelDBRecordIdentifier->version()));
     data.append(levelDBRecordIdentifier->primaryKey());
 
-    return m_db->put(indexDataKey, data);
+    return transaction->put(indexDataKey, data);
 }
 
-static bool findGreatestKeyLessThan(LevelDBDatabase* db, const Vector<char>& target, Vector<char>& foundKey)
+static bool findGreatestKeyLessThan(LevelDBTransaction* transaction, const Vector<char>& target, Vector<char>& foundKey)
 {
-    OwnPtr<LevelDBIterator> it(db->newIterator());
+    OwnPtr<LevelDBIterator> it(transaction->newIterator());
     it->seek(target);
 
     if (!it->isValid()) {
@@ -2085,12 +2130,12 @@ String IDBLevelDBBackingStore::getObjectViaIndex(int64_t databaseId, int64_t obj
     return getObjectStoreRecord(databaseId, objectStoreId, *primaryKey);
 }
 
-static bool versionExists(LevelDBDatabase* db, int64_t databaseId, int64_t objectStoreId, int64_t version, const Vector<char>& encodedPrimaryKey)
+static bool versionExists(LevelDBTransaction* transaction, int64_t databaseId, int64_t objectStoreId, int64_t version, const Vector<char>& encodedPrimaryKey)
 {
     const Vector<char> key = ExistsEntryKey::encode(databaseId, objectStoreId, encodedPrimaryKey);
     Vector<char> data;
 
-    if (!db->get(key, data))
+    if (!transaction->get(key, data))
         return false;
 
     return decodeInt(data.begin(), data.end()) == version;
@@ -2098,8 +2143,9 @@ static bool versionExists(LevelDBDatabase* db, int64_t databaseId, int64_t objec
 
 PassRefPtr<IDBKey> IDBLevelDBBackingStore::getPrimaryKeyViaIndex(int64_t databaseId, int64_t objectStoreId, int64_t indexId, const IDBKey& key)
 {
+    TransactionScope transaction(this);
     const Vector<char> leveldbKey = IndexDataKey::encode(databaseId, objectStoreId, indexId, key, 0);
-    OwnPtr<LevelDBIterator> it(m_db->newIterator());
+    OwnPtr<LevelDBIterator> it(transaction->newIterator());
     it->seek(leveldbKey);
 
     for (;;) {
@@ -2115,9 +2161,9 @@ PassRefPtr<IDBKey> IDBLevelDBBackingStore::getPrimaryKeyViaIndex(int64_t databas
         Vector<char> encodedPrimaryKey;
         encodedPrimaryKey.append(p, it->value().end() - p);
 
-        if (!versionExists(m_db.get(), databaseId, objectStoreId, version, encodedPrimaryKey)) {
+        if (!versionExists(transaction.get(), databaseId, objectStoreId, version, encodedPrimaryKey)) {
             // Delete stale index data entry and continue.
-            m_db->remove(it->key());
+            transaction->remove(it->key());
             it->next();
             continue;
         }
@@ -2130,8 +2176,9 @@ PassRefPtr<IDBKey> IDBLevelDBBackingStore::getPrimaryKeyViaIndex(int64_t databas
 
 bool IDBLevelDBBackingStore::keyExistsInIndex(int64_t databaseId, int64_t objectStoreId, int64_t indexId, const IDBKey& key)
 {
+    TransactionScope transaction(this);
     const Vector<char> levelDBKey = IndexDataKey::encode(databaseId, objectStoreId, indexId, key, 0);
-    OwnPtr<LevelDBIterator> it(m_db->newIterator());
+    OwnPtr<LevelDBIterator> it(transaction->newIterator());
 
     bool found = false;
 
@@ -2157,8 +2204,8 @@ public:
     bool firstSeek();
 
 protected:
-    CursorImplCommon(LevelDBDatabase* db, const Vector<char>& lowKey, bool lowOpen, const Vector<char>& highKey, bool highOpen, bool forward)
-        : m_db(db)
+    CursorImplCommon(LevelDBTransaction* transaction, const Vector<char>& lowKey, bool lowOpen, const Vector<char>& highKey, bool highOpen, bool forward)
+        : m_transaction(transaction)
         , m_lowKey(lowKey)
         , m_lowOpen(lowOpen)
         , m_highKey(highKey)
@@ -2168,7 +2215,7 @@ protected:
     }
     virtual ~CursorImplCommon() {}
 
-    LevelDBDatabase* m_db;
+    RefPtr<LevelDBTransaction> m_transaction;
     OwnPtr<LevelDBIterator> m_iterator;
     Vector<char> m_lowKey;
     bool m_lowOpen;
@@ -2180,7 +2227,7 @@ protected:
 
 bool CursorImplCommon::firstSeek()
 {
-    m_iterator = m_db->newIterator();
+    m_iterator = m_transaction->newIterator();
 
     if (m_forward)
         m_iterator->seek(m_lowKey);
@@ -2241,7 +2288,7 @@ bool CursorImplCommon::continueFunction(const IDBKey* key)
             return false;
 
         Vector<char> trash;
-        if (!m_db->get(m_iterator->key(), trash))
+        if (!m_transaction->get(m_iterator->key(), trash))
              continue;
 
         if (m_forward && m_highOpen && compareIndexKeys(m_iterator->key(), m_highKey) >= 0) // high key not included in range
@@ -2276,9 +2323,9 @@ bool CursorImplCommon::continueFunction(const IDBKey* key)
 
 class ObjectStoreCursorImpl : public CursorImplCommon {
 public:
-    static PassRefPtr<ObjectStoreCursorImpl> create(LevelDBDatabase* db, const Vector<char>& lowKey, bool lowOpen, const Vector<char>& highKey, bool highOpen, bool forward)
+    static PassRefPtr<ObjectStoreCursorImpl> create(LevelDBTransaction* transaction, const Vector<char>& lowKey, bool lowOpen, const Vector<char>& highKey, bool highOpen, bool forward)
     {
-        return adoptRef(new ObjectStoreCursorImpl(db, lowKey, lowOpen, highKey, highOpen, forward));
+        return adoptRef(new ObjectStoreCursorImpl(transaction, lowKey, lowOpen, highKey, highOpen, forward));
     }
 
     // CursorImplCommon
@@ -2288,8 +2335,8 @@ public:
     virtual bool loadCurrentRow();
 
 private:
-    ObjectStoreCursorImpl(LevelDBDatabase* db, const Vector<char>& lowKey, bool lowOpen, const Vector<char>& highKey, bool highOpen, bool forward)
-        : CursorImplCommon(db, lowKey, lowOpen, highKey, highOpen, forward)
+    ObjectStoreCursorImpl(LevelDBTransaction* transaction, const Vector<char>& lowKey, bool lowOpen, const Vector<char>& highKey, bool highOpen, bool forward)
+        : CursorImplCommon(transaction, lowKey, lowOpen, highKey, highOpen, forward)
     {
     }
 
@@ -2323,9 +2370,9 @@ bool ObjectStoreCursorImpl::loadCurrentRow()
 
 class IndexKeyCursorImpl : public CursorImplCommon {
 public:
-    static PassRefPtr<IndexKeyCursorImpl> create(LevelDBDatabase* db, const Vector<char>& lowKey, bool lowOpen, const Vector<char>& highKey, bool highOpen, bool forward)
+    static PassRefPtr<IndexKeyCursorImpl> create(LevelDBTransaction* transaction, const Vector<char>& lowKey, bool lowOpen, const Vector<char>& highKey, bool highOpen, bool forward)
     {
-        return adoptRef(new IndexKeyCursorImpl(db, lowKey, lowOpen, highKey, highOpen, forward));
+        return adoptRef(new IndexKeyCursorImpl(transaction, lowKey, lowOpen, highKey, highOpen, forward));
     }
 
     // CursorImplCommon
@@ -2336,8 +2383,8 @@ public:
     virtual bool loadCurrentRow();
 
 private:
-    IndexKeyCursorImpl(LevelDBDatabase* db, const Vector<char>& lowKey, bool lowOpen, const Vector<char>& highKey, bool highOpen, bool forward)
-        : CursorImplCommon(db, lowKey, lowOpen, highKey, highOpen, forward)
+    IndexKeyCursorImpl(LevelDBTransaction* transaction, const Vector<char>& lowKey, bool lowOpen, const Vector<char>& highKey, bool highOpen, bool forward)
+        : CursorImplCommon(transaction, lowKey, lowOpen, highKey, highOpen, forward)
     {
     }
 
@@ -2367,7 +2414,7 @@ bool IndexKeyCursorImpl::loadCurrentRow()
     Vector<char> primaryLevelDBKey = ObjectStoreDataKey::encode(indexDataKey.databaseId(), indexDataKey.objectStoreId(), *m_primaryKey);
 
     Vector<char> result;
-    if (!m_db->get(primaryLevelDBKey, result))
+    if (!m_transaction->get(primaryLevelDBKey, result))
         return false;
 
     int64_t objectStoreDataVersion;
@@ -2377,7 +2424,7 @@ bool IndexKeyCursorImpl::loadCurrentRow()
         return false;
 
     if (objectStoreDataVersion != indexDataVersion) { // FIXME: This is probably not very well covered by the layout tests.
-        m_db->remove(m_iterator->key());
+        m_transaction->remove(m_iterator->key());
         return false;
     }
 
@@ -2386,9 +2433,9 @@ bool IndexKeyCursorImpl::loadCurrentRow()
 
 class IndexCursorImpl : public CursorImplCommon {
 public:
-    static PassRefPtr<IndexCursorImpl> create(LevelDBDatabase* db, const Vector<char>& lowKey, bool lowOpen, const Vector<char>& highKey, bool highOpen, bool forward)
+    static PassRefPtr<IndexCursorImpl> create(LevelDBTransaction* transaction, const Vector<char>& lowKey, bool lowOpen, const Vector<char>& highKey, bool highOpen, bool forward)
     {
-        return adoptRef(new IndexCursorImpl(db, lowKey, lowOpen, highKey, highOpen, forward));
+        return adoptRef(new IndexCursorImpl(transaction, lowKey, lowOpen, highKey, highOpen, forward));
     }
 
     // CursorImplCommon
@@ -2399,8 +2446,8 @@ public:
     bool loadCurrentRow();
 
 private:
-    IndexCursorImpl(LevelDBDatabase* db, const Vector<char>& lowKey, bool lowOpen, const Vector<char>& highKey, bool highOpen, bool forward)
-        : CursorImplCommon(db, lowKey, lowOpen, highKey, highOpen, forward)
+    IndexCursorImpl(LevelDBTransaction* transaction, const Vector<char>& lowKey, bool lowOpen, const Vector<char>& highKey, bool highOpen, bool forward)
+        : CursorImplCommon(transaction, lowKey, lowOpen, highKey, highOpen, forward)
     {
     }
 
@@ -2435,7 +2482,7 @@ bool IndexCursorImpl::loadCurrentRow()
     m_primaryLevelDBKey = ObjectStoreDataKey::encode(indexDataKey.databaseId(), indexDataKey.objectStoreId(), *m_primaryKey);
 
     Vector<char> result;
-    if (!m_db->get(m_primaryLevelDBKey, result))
+    if (!m_transaction->get(m_primaryLevelDBKey, result))
         return false;
 
     int64_t objectStoreDataVersion;
@@ -2445,7 +2492,7 @@ bool IndexCursorImpl::loadCurrentRow()
         return false;
 
     if (objectStoreDataVersion != indexDataVersion) {
-        m_db->remove(m_iterator->key());
+        m_transaction->remove(m_iterator->key());
         return false;
     }
 
@@ -2455,9 +2502,9 @@ bool IndexCursorImpl::loadCurrentRow()
 
 }
 
-static bool findLastIndexKeyEqualTo(LevelDBDatabase* db, const Vector<char>& target, Vector<char>& foundKey)
+static bool findLastIndexKeyEqualTo(LevelDBTransaction* transaction, const Vector<char>& target, Vector<char>& foundKey)
 {
-    OwnPtr<LevelDBIterator> it(db->newIterator());
+    OwnPtr<LevelDBIterator> it(transaction->newIterator());
     it->seek(target);
 
     if (!it->isValid())
@@ -2474,6 +2521,7 @@ static bool findLastIndexKeyEqualTo(LevelDBDatabase* db, const Vector<char>& tar
 
 PassRefPtr<IDBBackingStore::Cursor> IDBLevelDBBackingStore::openObjectStoreCursor(int64_t databaseId, int64_t objectStoreId, const IDBKeyRange* range, IDBCursor::Direction direction)
 {
+    TransactionScope transaction(this);
     bool lowerBound = range && range->lower();
     bool upperBound = range && range->upper();
     bool forward = (direction == IDBCursor::NEXT_NO_DUPLICATE || direction == IDBCursor::NEXT);
@@ -2494,7 +2542,7 @@ PassRefPtr<IDBBackingStore::Cursor> IDBLevelDBBackingStore::openObjectStoreCurso
         upperOpen = true; // Not included.
 
         if (!forward) { // We need a key that exists.
-            if (!findGreatestKeyLessThan(m_db.get(), stopKey, stopKey))
+            if (!findGreatestKeyLessThan(transaction.get(), stopKey, stopKey))
                 return 0;
             upperOpen = false;
         }
@@ -2503,7 +2551,7 @@ PassRefPtr<IDBBackingStore::Cursor> IDBLevelDBBackingStore::openObjectStoreCurso
         upperOpen = range->upperOpen();
     }
 
-    RefPtr<ObjectStoreCursorImpl> cursor = ObjectStoreCursorImpl::create(m_db.get(), startKey, lowerOpen, stopKey, upperOpen, forward);
+    RefPtr<ObjectStoreCursorImpl> cursor = ObjectStoreCursorImpl::create(transaction.get(), startKey, lowerOpen, stopKey, upperOpen, forward);
     if (!cursor->firstSeek())
         return 0;
 
@@ -2512,6 +2560,7 @@ PassRefPtr<IDBBackingStore::Cursor> IDBLevelDBBackingStore::openObjectStoreCurso
 
 PassRefPtr<IDBBackingStore::Cursor> IDBLevelDBBackingStore::openIndexKeyCursor(int64_t databaseId, int64_t objectStoreId, int64_t indexId, const IDBKeyRange* range, IDBCursor::Direction direction)
 {
+    TransactionScope transaction(this);
     bool lowerBound = range && range->lower();
     bool upperBound = range && range->upper();
     bool forward = (direction == IDBCursor::NEXT_NO_DUPLICATE || direction == IDBCursor::NEXT);
@@ -2532,18 +2581,18 @@ PassRefPtr<IDBBackingStore::Cursor> IDBLevelDBBackingStore::openIndexKeyCursor(i
         upperOpen = false; // Included.
 
         if (!forward) { // We need a key that exists.
-            if (!findGreatestKeyLessThan(m_db.get(), stopKey, stopKey))
+            if (!findGreatestKeyLessThan(transaction.get(), stopKey, stopKey))
                 return 0;
             upperOpen = false;
         }
     } else {
         stopKey = IndexDataKey::encode(databaseId, objectStoreId, indexId, *range->upper(), 0);
-        if (!findLastIndexKeyEqualTo(m_db.get(), stopKey, stopKey)) // Seek to the *last* key in the set of non-unique keys.
+        if (!findLastIndexKeyEqualTo(transaction.get(), stopKey, stopKey)) // Seek to the *last* key in the set of non-unique keys.
             return 0;
         upperOpen = range->upperOpen();
     }
 
-    RefPtr<IndexKeyCursorImpl> cursor = IndexKeyCursorImpl::create(m_db.get(), startKey, lowerOpen, stopKey, upperOpen, forward);
+    RefPtr<IndexKeyCursorImpl> cursor = IndexKeyCursorImpl::create(transaction.get(), startKey, lowerOpen, stopKey, upperOpen, forward);
     if (!cursor->firstSeek())
         return 0;
 
@@ -2552,6 +2601,7 @@ PassRefPtr<IDBBackingStore::Cursor> IDBLevelDBBackingStore::openIndexKeyCursor(i
 
 PassRefPtr<IDBBackingStore::Cursor> IDBLevelDBBackingStore::openIndexCursor(int64_t databaseId, int64_t objectStoreId, int64_t indexId, const IDBKeyRange* range, IDBCursor::Direction direction)
 {
+    TransactionScope transaction(this);
     bool lowerBound = range && range->lower();
     bool upperBound = range && range->upper();
     bool forward = (direction == IDBCursor::NEXT_NO_DUPLICATE || direction == IDBCursor::NEXT);
@@ -2572,37 +2622,77 @@ PassRefPtr<IDBBackingStore::Cursor> IDBLevelDBBackingStore::openIndexCursor(int6
         upperOpen = false; // Included.
 
         if (!forward) { // We need a key that exists.
-            if (!findGreatestKeyLessThan(m_db.get(), stopKey, stopKey))
+            if (!findGreatestKeyLessThan(transaction.get(), stopKey, stopKey))
                 return 0;
             upperOpen = false;
         }
     } else {
         stopKey = IndexDataKey::encode(databaseId, objectStoreId, indexId, *range->upper(), 0);
-        if (!findLastIndexKeyEqualTo(m_db.get(), stopKey, stopKey)) // Seek to the *last* key in the set of non-unique keys.
+        if (!findLastIndexKeyEqualTo(transaction.get(), stopKey, stopKey)) // Seek to the *last* key in the set of non-unique keys.
             return 0;
         upperOpen = range->upperOpen();
     }
 
-    RefPtr<IndexCursorImpl> cursor = IndexCursorImpl::create(m_db.get(), startKey, lowerOpen, stopKey, upperOpen, forward);
+    RefPtr<IndexCursorImpl> cursor = IndexCursorImpl::create(transaction.get(), startKey, lowerOpen, stopKey, upperOpen, forward);
     if (!cursor->firstSeek())
         return 0;
 
     return cursor.release();
 }
 
-namespace {
-class DummyTransaction : public IDBBackingStore::Transaction {
+// Everything an IDB transaction writes stays in its LevelDBTransaction until
+// commit, which hands it to LevelDB as one write batch; rollback just drops it.
+class IDBLevelDBBackingStore::TransactionImpl : public IDBBackingStore::Transaction {
 public:
-    virtual void begin() {}
-    virtual void commit() {}
-    virtual void rollback() {}
+    static PassRefPtr<TransactionImpl> create(IDBLevelDBBackingStore* backingStore)
+    {
+        return adoptRef(new TransactionImpl(backingStore));
+    }
+
+    virtual void begin()
+    {
+        ASSERT(!m_backingStore->m_currentTransaction);
+        m_transaction = LevelDBTransaction::create(m_backingStore->m_db.get(), m_backingStore->m_comparator.get());
+        m_backingStore->m_currentTransaction = m_transaction;
+    }
+
+    virtual void commit()
+    {
+        ASSERT(m_transaction && m_backingStore->m_currentTransaction == m_transaction);
+        if (!m_transaction->commit())
+            LOG_ERROR("Failed to commit an IndexedDB transaction");
+        finish();
+    }
+
+    virtual void rollback()
+    {
+        // An IDB transaction can be aborted before it ever began.
+        if (!m_transaction)
+            return;
+        ASSERT(m_backingStore->m_currentTransaction == m_transaction);
+        m_transaction->rollback();
+        finish();
+    }
+
+private:
+    explicit TransactionImpl(IDBLevelDBBackingStore* backingStore)
+        : m_backingStore(backingStore)
+    {
+    }
+
+    void finish()
+    {
+        m_backingStore->m_currentTransaction = 0;
+        m_transaction = 0;
+    }
+
+    RefPtr<IDBLevelDBBackingStore> m_backingStore;
+    RefPtr<LevelDBTransaction> m_transaction;
 };
-}
 
 PassRefPtr<IDBBackingStore::Transaction> IDBLevelDBBackingStore::createTransaction()
 {
-    // FIXME: We need to implement a transaction abstraction that allows for roll-backs, and write tests for it.
-    return adoptRef(new DummyTransaction());
+    return TransactionImpl::create(this);
 }
 
 // FIXME: deleteDatabase should be part of IDBBackingStore.
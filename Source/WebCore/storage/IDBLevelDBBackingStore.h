@@ -31,11 +31,13 @@
 
 #include "IDBBackingStore.h"
 #include <wtf/OwnPtr.h>
+#include <wtf/RefPtr.h>
 
 namespace WebCore {
 
 class LevelDBComparator;
 class LevelDBDatabase;
+class LevelDBTransaction;
 
 class IDBLevelDBBackingStore : public IDBBackingStore {
 public:
@@ -76,10 +78,14 @@ public:
 private:
     IDBLevelDBBackingStore(String identifier, IDBFactoryBackendImpl*, LevelDBDatabase*);
 
+    class TransactionImpl;
+    class TransactionScope;
+
     String m_identifier;
     RefPtr<IDBFactoryBackendImpl> m_factory;
     OwnPtr<LevelDBDatabase> m_db;
     OwnPtr<LevelDBComparator> m_comparator;
+    RefPtr<LevelDBTransaction> m_currentTransaction;
 };
 
 } // namespace WebCore
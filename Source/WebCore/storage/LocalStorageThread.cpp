@@ -78,6 +78,13 @@ void LocalStorageThread::scheduleTask(PassOwnPtr<LocalStorageTask> task)
     m_queue.append(task);
 }
 
+void LocalStorageThread::scheduleImmediateTask(PassOwnPtr<LocalStorageTask> task)
+{
+    ASSERT(isMainThread());
+    ASSERT(!m_queue.killed() && m_threadID);
+    m_queue.prepend(task);
+}
+
 void LocalStorageThread::terminate()
 {
     ASSERT(isMainThread());
@@ -49,6 +49,8 @@ namespace WebCore {
         bool start();
         void terminate();
         void scheduleTask(PassOwnPtr<LocalStorageTask>);
+        // Runs the task before everything already queued.
+        void scheduleImmediateTask(PassOwnPtr<LocalStorageTask>);
 
         // Background thread part of the terminate procedure.
         void performTerminate();
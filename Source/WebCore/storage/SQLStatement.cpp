@@ -39,6 +39,7 @@
 #include "SQLStatementErrorCallback.h"
 #include "SQLTransaction.h"
 #include "SQLValue.h"
+#include <wtf/OwnPtr.h>
 #include <wtf/text/CString.h>
 
 namespace WebCore {
@@ -73,8 +74,9 @@ bool SQLStatement::execute(Database* db)
 
     SQLiteDatabase* database = &db->sqliteDatabase();
 
-    SQLiteStatement statement(*database, m_statement);
-    int result = statement.prepare();
+    unsigned authorizerActions;
+    int result;
+    OwnPtr<SQLiteStatement> statement = db->prepareCachedStatement(m_statement, m_permissions, authorizerActions, result);
 
     if (result != SQLResultOk) {
         LOG(StorageAPI, "Unable to verify correctness of statement %s - error %i (%s)", m_statement.ascii().data(), result, database->lastErrorMsg());
@@ -84,14 +86,14 @@ bool SQLStatement::execute(Database* db)
 
     // FIXME:  If the statement uses the ?### syntax supported by sqlite, the bind parameter count is very likely off from the number of question marks.
     // If this is the case, they might be trying to do something fishy or malicious
-    if (statement.bindParameterCount() != m_arguments.size()) {
+    if (statement->bindParameterCount() != m_arguments.size()) {
         LOG(StorageAPI, "Bind parameter count doesn't match number of question marks");
         m_error = SQLError::create(db->isInterrupted() ? SQLError::DATABASE_ERR : SQLError::SYNTAX_ERR, "number of '?'s in statement string does not match argument count");
         return false;
     }
 
     for (unsigned i = 0; i < m_arguments.size(); ++i) {
-        result = statement.bindValue(i + 1, m_arguments[i]);
+        result = statement->bindValue(i + 1, m_arguments[i]);
         if (result == SQLResultFull) {
             setFailureDueToQuota();
             return false;
@@ -107,19 +109,19 @@ bool SQLStatement::execute(Database* db)
     RefPtr<SQLResultSet> resultSet = SQLResultSet::create();
 
     // Step so we can fetch the column names.
-    result = statement.step();
+    result = statement->step();
     if (result == SQLResultRow) {
-        int columnCount = statement.columnCount();
+        int columnCount = statement->columnCount();
         SQLResultSetRowList* rows = resultSet->rows();
 
         for (int i = 0; i < columnCount; i++)
-            rows->addColumn(statement.getColumnName(i));
+            rows->addColumn(statement->getColumnName(i));
 
         do {
             for (int i = 0; i < columnCount; i++)
-                rows->addResult(statement.getColumnValue(i));
+                rows->addResult(statement->getColumnValue(i));
 
-            result = statement.step();
+            result = statement->step();
         } while (result == SQLResultRow);
 
         if (result != SQLResultDone) {
@@ -143,6 +145,7 @@ bool SQLStatement::execute(Database* db)
     // sqlite3_total_changes() here instead of sqlite3_changed, because that includes rows modified from within a trigger
     // For now, this seems sufficient
     resultSet->setRowsAffected(database->lastChanges());
+    database->cacheStatement(statement.release(), m_permissions, authorizerActions);
 
     m_resultSet = resultSet;
     return true;
@@ -38,6 +38,7 @@
 #include "SQLValue.h"
 #include "SQLiteDatabase.h"
 #include "SQLiteStatement.h"
+#include <wtf/OwnPtr.h>
 #include <wtf/PassRefPtr.h>
 #include <wtf/RefPtr.h>
 
@@ -57,20 +58,21 @@ PassRefPtr<SQLResultSet> SQLStatementSync::execute(DatabaseSync* db, ExceptionCo
 
     SQLiteDatabase* database = &db->sqliteDatabase();
 
-    SQLiteStatement statement(*database, m_statement);
-    int result = statement.prepare();
+    unsigned authorizerActions;
+    int result;
+    OwnPtr<SQLiteStatement> statement = db->prepareCachedStatement(m_statement, m_permissions, authorizerActions, result);
     if (result != SQLResultOk) {
         ec = (result == SQLResultInterrupt ? SQLException::DATABASE_ERR : SQLException::SYNTAX_ERR);
         return 0;
     }
 
-    if (statement.bindParameterCount() != m_arguments.size()) {
+    if (statement->bindParameterCount() != m_arguments.size()) {
         ec = (db->isInterrupted()? SQLException::DATABASE_ERR : SQLException::SYNTAX_ERR);
         return 0;
     }
 
     for (unsigned i = 0; i < m_arguments.size(); ++i) {
-        result = statement.bindValue(i + 1, m_arguments[i]);
+        result = statement->bindValue(i + 1, m_arguments[i]);
         if (result == SQLResultFull) {
             ec = SQLException::QUOTA_ERR;
             return 0;
@@ -85,19 +87,19 @@ PassRefPtr<SQLResultSet> SQLStatementSync::execute(DatabaseSync* db, ExceptionCo
     RefPtr<SQLResultSet> resultSet = SQLResultSet::create();
 
     // Step so we can fetch the column names.
-    result = statement.step();
+    result = statement->step();
     if (result == SQLResultRow) {
-        int columnCount = statement.columnCount();
+        int columnCount = statement->columnCount();
         SQLResultSetRowList* rows = resultSet->rows();
 
         for (int i = 0; i < columnCount; i++)
-            rows->addColumn(statement.getColumnName(i));
+            rows->addColumn(statement->getColumnName(i));
 
         do {
             for (int i = 0; i < columnCount; i++)
-                rows->addResult(statement.getColumnValue(i));
+                rows->addResult(statement->getColumnValue(i));
 
-            result = statement.step();
+            result = statement->step();
         } while (result == SQLResultRow);
 
         if (result != SQLResultDone) {
@@ -118,6 +120,7 @@ PassRefPtr<SQLResultSet> SQLStatementSync::execute(DatabaseSync* db, ExceptionCo
     }
 
     resultSet->setRowsAffected(database->lastChanges());
+    database->cacheStatement(statement.release(), m_permissions, authorizerActions);
     return resultSet.release();
 }
 
@@ -33,6 +33,7 @@
 #include "HTMLElement.h"
 #include "SQLiteFileSystem.h"
 #include "SQLiteStatement.h"
+#include "SQLiteTransaction.h"
 #include "SecurityOrigin.h"
 #include "StorageAreaImpl.h"
 #include "StorageSyncManager.h"
@@ -282,25 +283,16 @@ void StorageAreaSync::performImport()
         return;
     }
 
-    HashMap<String, String> itemMap;
-
+    // The key column is UNIQUE, so rows can go straight into the area. Nothing
+    // on the main thread reads it until markImported().
     int result = query.step();
     while (result == SQLResultRow) {
-        itemMap.set(query.getColumnText(0), query.getColumnText(1));
+        m_storageArea->importItem(query.getColumnText(0), query.getColumnText(1));
         result = query.step();
     }
 
-    if (result != SQLResultDone) {
+    if (result != SQLResultDone)
         LOG_ERROR("Error reading items from ItemTable for local storage");
-        markImported();
-        return;
-    }
-
-    HashMap<String, String>::iterator it = itemMap.begin();
-    HashMap<String, String>::iterator end = itemMap.end();
-
-    for (; it != end; ++it)
-        m_storageArea->importItem(it->first, it->second);
 
     markImported();
 }
@@ -355,6 +347,11 @@ void StorageAreaSync::sync(bool clearItems, const HashMap<String, String>& items
         return;
     }
     
+    // Commit the whole batch at once; outside a transaction every statement
+    // would be its own commit, with its own journal write and sync.
+    SQLiteTransaction transaction(m_database);
+    transaction.begin();
+
     // If the clear flag is set, then we clear all items out before we write any new ones in.
     if (clearItems) {
         SQLiteStatement clear(m_database, "DELETE FROM ItemTable");
@@ -402,6 +399,8 @@ void StorageAreaSync::sync(bool clearItems, const HashMap<String, String>& items
 
         query.reset();
     }
+
+    transaction.commit();
 }
 
 void StorageAreaSync::performSync()
@@ -87,8 +87,11 @@ bool StorageSyncManager::scheduleImport(PassRefPtr<StorageAreaSync> area)
 {
     ASSERT(isMainThread());
     ASSERT(m_thread);
+    // The main thread blocks on the import as soon as the page touches the area,
+    // so don't leave it waiting behind other areas' syncs. An area is imported
+    // before anything else is queued for it, so nothing it depends on is skipped.
     if (m_thread)
-        m_thread->scheduleTask(LocalStorageTask::createImport(area.get()));
+        m_thread->scheduleImmediateTask(LocalStorageTask::createImport(area.get()));
     return m_thread;
 }
 
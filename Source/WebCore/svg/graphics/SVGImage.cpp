@@ -47,6 +47,7 @@
 #include "SVGRenderSupport.h"
 #include "SVGSVGElement.h"
 #include "Settings.h"
+#include <wtf/MathExtras.h>
 
 // Moving this #include above FrameLoader.h causes the Windows build to fail due to warnings about
 // alignment in Timer<FrameLoader>. It seems that the definition of EmptyFrameLoaderClient is what
@@ -73,15 +74,23 @@ private:
 
     virtual void invalidateContentsAndWindow(const IntRect& r, bool)
     {
-        if (m_image && m_image->imageObserver())
+        if (!m_image)
+            return;
+        m_image->documentInvalidated();
+        if (m_image->imageObserver())
             m_image->imageObserver()->changedInRect(m_image, r);
     }
 
     SVGImage* m_image;
 };
 
+static const unsigned maxRasterCacheEntries = 4;
+static const int maxRasterPixels = 1024 * 1024;
+
 SVGImage::SVGImage(ImageObserver* observer)
     : Image(observer)
+    , m_rasterCacheSize(0)
+    , m_isDrawingFrame(false)
 {
 }
 
@@ -175,11 +184,48 @@ bool SVGImage::hasRelativeHeight() const
     return rootElement->height().unitType() == LengthTypePercentage;
 }
 
-void SVGImage::draw(GraphicsContext* context, const FloatRect& dstRect, const FloatRect& srcRect, ColorSpace, CompositeOperator compositeOp)
+void SVGImage::draw(GraphicsContext* context, const FloatRect& dstRect, const FloatRect& srcRect, ColorSpace styleColorSpace, CompositeOperator compositeOp)
 {
     if (!m_page)
         return;
 
+    // A pending layout means the document changed in a way that hasn't been invalidated yet.
+    if (m_page->mainFrame()->view()->needsLayout())
+        clearRasterCache();
+
+    IntSize imageSize = size();
+    if (!context->paintingDisabled() && !imageSize.isEmpty() && !srcRect.isEmpty()) {
+        AffineTransform ctm = context->getCTM();
+        float rasterScaleX = dstRect.width() / srcRect.width() * ctm.xScale();
+        float rasterScaleY = dstRect.height() / srcRect.height() * ctm.yScale();
+#if PLATFORM(ANDROID)
+        // Page content is recorded into pictures that are played back at the page zoom level,
+        // which isn't part of the CTM while recording. Oversample so zoomed-in pages don't show
+        // a blurry image.
+        rasterScaleX *= 2;
+        rasterScaleY *= 2;
+#endif
+        IntSize rasterSize(static_cast<int>(ceilf(imageSize.width() * rasterScaleX)), static_cast<int>(ceilf(imageSize.height() * rasterScaleY)));
+
+        if (Image* raster = cachedRaster(imageSize, rasterSize)) {
+            FloatRect rasterSrcRect(srcRect.x() * rasterSize.width() / imageSize.width(), srcRect.y() * rasterSize.height() / imageSize.height(),
+                srcRect.width() * rasterSize.width() / imageSize.width(), srcRect.height() * rasterSize.height() / imageSize.height());
+            context->drawImage(raster, styleColorSpace, dstRect, rasterSrcRect, compositeOp);
+
+            if (imageObserver())
+                imageObserver()->didDraw(this);
+            return;
+        }
+    }
+
+    drawFrame(context, dstRect, srcRect, compositeOp);
+
+    if (imageObserver())
+        imageObserver()->didDraw(this);
+}
+
+void SVGImage::drawFrame(GraphicsContext* context, const FloatRect& dstRect, const FloatRect& srcRect, CompositeOperator compositeOp)
+{
     FrameView* view = m_page->mainFrame()->view();
 
     context->save();
@@ -198,6 +244,8 @@ void SVGImage::draw(GraphicsContext* context, const FloatRect& dstRect, const Fl
     context->translate(destOffset.x(), destOffset.y());
     context->scale(scale);
 
+    m_isDrawingFrame = true;
+
     view->resize(size());
 
     if (view->needsLayout())
@@ -205,13 +253,77 @@ void SVGImage::draw(GraphicsContext* context, const FloatRect& dstRect, const Fl
 
     view->paint(context, IntRect(0, 0, view->width(), view->height()));
 
+    m_isDrawingFrame = false;
+
     if (compositeOp != CompositeSourceOver)
         context->endTransparencyLayer();
 
     context->restore();
+}
+
+Image* SVGImage::cachedRaster(const IntSize& imageSize, const IntSize& rasterSize)
+{
+    if (rasterSize.isEmpty() || rasterSize.width() > maxRasterPixels / rasterSize.height())
+        return 0;
+
+    for (size_t i = 0; i < m_rasterCache.size(); ++i) {
+        if (m_rasterCache[i].imageSize != imageSize || m_rasterCache[i].rasterSize != rasterSize)
+            continue;
+        if (i) {
+            RasterCacheEntry entry = m_rasterCache[i];
+            m_rasterCache.remove(i);
+            m_rasterCache.insert(0, entry);
+        }
+        return m_rasterCache[0].image.get();
+    }
 
+    OwnPtr<ImageBuffer> buffer = ImageBuffer::create(rasterSize);
+    if (!buffer)
+        return 0;
+    drawFrame(buffer->context(), FloatRect(FloatPoint(), rasterSize), FloatRect(FloatPoint(), imageSize), CompositeSourceOver);
+
+    int deltaBytes = 0;
+    if (m_rasterCache.size() >= maxRasterCacheEntries) {
+        const IntSize& evictedSize = m_rasterCache.last().rasterSize;
+        deltaBytes -= evictedSize.width() * evictedSize.height() * 4;
+        m_rasterCache.removeLast();
+    }
+
+    RasterCacheEntry entry;
+    entry.imageSize = imageSize;
+    entry.rasterSize = rasterSize;
+    entry.image = buffer->copyImage();
+    m_rasterCache.insert(0, entry);
+    deltaBytes += rasterSize.width() * rasterSize.height() * 4;
+
+    m_rasterCacheSize += deltaBytes;
     if (imageObserver())
-        imageObserver()->didDraw(this);
+        imageObserver()->decodedSizeChanged(this, deltaBytes);
+
+    return m_rasterCache[0].image.get();
+}
+
+void SVGImage::clearRasterCache()
+{
+    if (m_rasterCache.isEmpty())
+        return;
+
+    int deltaBytes = -static_cast<int>(m_rasterCacheSize);
+    m_rasterCache.clear();
+    m_rasterCacheSize = 0;
+    if (imageObserver())
+        imageObserver()->decodedSizeChanged(this, deltaBytes);
+}
+
+void SVGImage::documentInvalidated()
+{
+    if (!m_isDrawingFrame)
+        clearRasterCache();
+}
+
+void SVGImage::destroyDecodedData(bool)
+{
+    clearRasterCache();
 }
 
 NativeImagePtr SVGImage::nativeImageForCurrentFrame()
@@ -225,7 +337,7 @@ NativeImagePtr SVGImage::nativeImageForCurrentFrame()
         OwnPtr<ImageBuffer> buffer = ImageBuffer::create(size());
         if (!buffer) // failed to allocate image
             return 0;
-        draw(buffer->context(), rect(), rect(), ColorSpaceDeviceRGB, CompositeSourceOver);
+        drawFrame(buffer->context(), rect(), rect(), CompositeSourceOver);
         m_frameCache = buffer->copyImage();
     }
     return m_frameCache->nativeImageForCurrentFrame();
@@ -30,6 +30,8 @@
 #if ENABLE(SVG)
 
 #include "Image.h"
+#include "IntSize.h"
+#include <wtf/Vector.h>
 
 namespace WebCore {
 
@@ -57,10 +59,10 @@ private:
 
     virtual bool dataChanged(bool allDataReceived);
 
-    // FIXME: SVGImages are underreporting decoded sizes and will be unable
-    // to prune because these functions are not implemented yet.
-    virtual void destroyDecodedData(bool) { }
-    virtual unsigned decodedSize() const { return 0; }
+    // FIXME: Only the raster cache is reported here; the SVG document itself
+    // is not accounted for and can't be pruned.
+    virtual void destroyDecodedData(bool destroyAll = true);
+    virtual unsigned decodedSize() const { return m_rasterCacheSize; }
 
     virtual NativeImagePtr frameAtIndex(size_t) { return 0; }
 
@@ -69,9 +71,38 @@ private:
 
     virtual NativeImagePtr nativeImageForCurrentFrame();
 
+    friend class SVGImageChromeClient;
+
+    // Paints the SVG document directly, without going through the raster cache.
+    void drawFrame(GraphicsContext*, const FloatRect& dstRect, const FloatRect& srcRect, CompositeOperator);
+
+    // Returns a bitmap of the whole image at rasterSize, rendering and caching it if needed.
+    // Returns 0 if the raster would be too large to be worth caching.
+    Image* cachedRaster(const IntSize& imageSize, const IntSize& rasterSize);
+    void clearRasterCache();
+
+    // Called by the chrome client when the document repaints itself.
+    void documentInvalidated();
+
     OwnPtr<SVGImageChromeClient> m_chromeClient;
     OwnPtr<Page> m_page;
     RefPtr<Image> m_frameCache;
+
+    // Static SVG images are usually drawn many times at a handful of sizes (icons, backgrounds),
+    // so each size is rendered once and then drawn as a bitmap. Entries are keyed by the image
+    // size, which depends on the container size, and the device size of the raster. Most
+    // recently used first. Cleared whenever the document invalidates itself.
+    struct RasterCacheEntry {
+        IntSize imageSize;
+        IntSize rasterSize;
+        RefPtr<Image> image;
+    };
+    Vector<RasterCacheEntry> m_rasterCache;
+    unsigned m_rasterCacheSize;
+
+    // Set while drawFrame() lays out and paints the document; the invalidations that
+    // resizing the view causes don't mean the content changed.
+    bool m_isDrawingFrame;
 };
 }
 
@@ -88,6 +88,7 @@ AudioContext::AudioContext(Document* document)
     , m_connectionCount(0)
     , m_audioThread(0)
     , m_graphOwnerThread(UndefinedThreadIdentifier)
+    , m_hasPendingGraphChanges(false)
     , m_isOfflineContext(false)
 {
     constructCommon();
@@ -115,6 +116,7 @@ AudioContext::AudioContext(Document* document, unsigned numberOfChannels, size_t
     , m_connectionCount(0)
     , m_audioThread(0)
     , m_graphOwnerThread(UndefinedThreadIdentifier)
+    , m_hasPendingGraphChanges(false)
     , m_isOfflineContext(true)
 {
     constructCommon();
@@ -452,7 +454,13 @@ void AudioContext::addDeferredFinishDeref(AudioNode* node, AudioNode::RefType re
 void AudioContext::handlePreRenderTasks()
 {
     ASSERT(isAudioThread());
- 
+
+    // Most render quanta see no graph changes at all, so check the flag before touching the lock.
+    // This keeps the audio thread off m_contextGraphMutex in the steady state, and main thread
+    // callers of lock() from ever having to wait for an otherwise idle render quantum.
+    if (!m_hasPendingGraphChanges)
+        return;
+
     // At the beginning of every render quantum, try to update the internal rendering graph state (from main thread changes).
     // It's OK if the tryLock() fails, we'll just take slightly longer to pick up the changes.
     bool mustReleaseLock;
@@ -460,7 +468,9 @@ void AudioContext::handlePreRenderTasks()
         // Fixup the state of any dirty AudioNodeInputs and AudioNodeOutputs.
         handleDirtyAudioNodeInputs();
         handleDirtyAudioNodeOutputs();
-        
+
+        updatePendingGraphChanges();
+
         if (mustReleaseLock)
             unlock();
     }
@@ -469,7 +479,11 @@ void AudioContext::handlePreRenderTasks()
 void AudioContext::handlePostRenderTasks()
 {
     ASSERT(isAudioThread());
- 
+
+    // m_finishedNodes and m_deferredFinishDerefList are only touched on the audio thread, so they can be checked without the lock.
+    if (!m_hasPendingGraphChanges && m_finishedNodes.isEmpty() && m_deferredFinishDerefList.isEmpty())
+        return;
+
     // Must use a tryLock() here too.  Don't worry, the lock will very rarely be contended and this method is called frequently.
     // The worst that can happen is that there will be some nodes which will take slightly longer than usual to be deleted or removed
     // from the render graph (in which case they'll render silence).
@@ -487,12 +501,22 @@ void AudioContext::handlePostRenderTasks()
         // Fixup the state of any dirty AudioNodeInputs and AudioNodeOutputs.
         handleDirtyAudioNodeInputs();
         handleDirtyAudioNodeOutputs();
-        
+
+        updatePendingGraphChanges();
+
         if (mustReleaseLock)
             unlock();
     }
 }
 
+void AudioContext::updatePendingGraphChanges()
+{
+    ASSERT(isGraphOwner());
+
+    // deleteMarkedNodes() caps the work done per quantum, so there may still be nodes left to delete.
+    m_hasPendingGraphChanges = !m_nodesToDelete.isEmpty() || !m_dirtyAudioNodeInputs.isEmpty() || !m_dirtyAudioNodeOutputs.isEmpty();
+}
+
 void AudioContext::handleDeferredFinishDerefs()
 {
     ASSERT(isAudioThread() && isGraphOwner());
@@ -509,6 +533,7 @@ void AudioContext::markForDeletion(AudioNode* node)
 {
     ASSERT(isGraphOwner());
     m_nodesToDelete.append(node);
+    m_hasPendingGraphChanges = true;
 }
 
 void AudioContext::deleteMarkedNodes()
@@ -544,12 +569,14 @@ void AudioContext::markAudioNodeInputDirty(AudioNodeInput* input)
 {
     ASSERT(isGraphOwner());    
     m_dirtyAudioNodeInputs.add(input);
+    m_hasPendingGraphChanges = true;
 }
 
 void AudioContext::markAudioNodeOutputDirty(AudioNodeOutput* output)
 {
     ASSERT(isGraphOwner());    
     m_dirtyAudioNodeOutputs.add(output);
+    m_hasPendingGraphChanges = true;
 }
 
 void AudioContext::handleDirtyAudioNodeInputs()
@@ -252,6 +252,9 @@ private:
     void handleDirtyAudioNodeInputs();
     void handleDirtyAudioNodeOutputs();
 
+    // Recomputes m_hasPendingGraphChanges once the audio thread has processed what it could.
+    void updatePendingGraphChanges();
+
     OwnPtr<AudioBus> m_temporaryMonoBus;
     OwnPtr<AudioBus> m_temporaryStereoBus;
 
@@ -261,6 +264,11 @@ private:
     Mutex m_contextGraphMutex;
     volatile ThreadIdentifier m_audioThread;
     volatile ThreadIdentifier m_graphOwnerThread; // if the lock is held then this is the thread which owns it, otherwise == UndefinedThreadIdentifier
+
+    // Only written when the graph lock is held, but read by the audio thread without it so that render quanta
+    // with nothing to publish skip the lock entirely. A stale read only delays the changes by one quantum,
+    // since everything the flag guards is re-read after the lock is acquired.
+    volatile bool m_hasPendingGraphChanges;
     
     // Deferred de-referencing.
     struct RefInfo {
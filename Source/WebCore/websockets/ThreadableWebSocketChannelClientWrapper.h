@@ -102,6 +102,13 @@ public:
             processPendingEvents();
     }
 
+    void didReceiveMessages(const Vector<String>& messages)
+    {
+        m_pendingMessages.append(messages);
+        if (!m_suspended)
+            processPendingEvents();
+    }
+
     void didClose(unsigned long unhandledBufferedAmount)
     {
         m_pendingClosed = true;
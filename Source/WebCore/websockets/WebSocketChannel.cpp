@@ -51,18 +51,30 @@
 #include <wtf/text/CString.h>
 #include <wtf/text/StringConcatenate.h>
 #include <wtf/text/StringHash.h>
+#include <wtf/CurrentTime.h>
 #include <wtf/Deque.h>
 #include <wtf/FastMalloc.h>
 #include <wtf/HashMap.h>
 
 namespace WebCore {
 
+// Longest stretch spent parsing and delivering frames before yielding back to
+// the run loop, so that a high-frequency feed cannot starve layout and timers.
+static const double processingTimeSlice = 0.008;
+
+// Parsed messages are handed to the client in batches of at most this many, so
+// that their delivery counts against the time slice too.
+static const size_t maxMessagesPerBatch = 64;
+
+// Receive buffers above this size are released once drained instead of being
+// kept around for the next frame.
+static const size_t maxRetainedBufferCapacity = 64 * 1024;
+
 WebSocketChannel::WebSocketChannel(ScriptExecutionContext* context, WebSocketChannelClient* client, const KURL& url, const String& protocol)
     : m_context(context)
     , m_client(client)
     , m_handshake(url, protocol, context)
-    , m_buffer(0)
-    , m_bufferSize(0)
+    , m_bufferOffset(0)
     , m_resumeTimer(this, &WebSocketChannel::resumeTimerFired)
     , m_suspended(false)
     , m_closed(false)
@@ -80,7 +92,6 @@ WebSocketChannel::WebSocketChannel(ScriptExecutionContext* context, WebSocketCha
 
 WebSocketChannel::~WebSocketChannel()
 {
-    fastFree(m_buffer);
 }
 
 void WebSocketChannel::connect()
@@ -142,7 +153,7 @@ void WebSocketChannel::suspend()
 void WebSocketChannel::resume()
 {
     m_suspended = false;
-    if ((m_buffer || m_closed) && m_client && !m_resumeTimer.isActive())
+    if ((hasBufferedData() || m_closed) && m_client && !m_resumeTimer.isActive())
         m_resumeTimer.startOneShot(0);
 }
 
@@ -170,7 +181,9 @@ void WebSocketChannel::didClose(SocketStreamHandle* handle)
     m_closed = true;
     if (m_handle) {
         m_unhandledBufferedAmount = m_handle->bufferedAmount();
-        if (m_suspended)
+        // If frame processing yielded, the resume timer delivers the close
+        // after the remaining messages.
+        if (m_suspended || m_resumeTimer.isActive())
             return;
         WebSocketChannelClient* client = m_client;
         m_client = 0;
@@ -202,9 +215,10 @@ void WebSocketChannel::didReceiveData(SocketStreamHandle* handle, const char* da
         handle->close();
         return;
     }
-    while (!m_suspended && m_client && m_buffer)
-        if (!processBuffer())
-            break;
+    // A pending resume timer picks the new data up after what is already queued.
+    if (m_resumeTimer.isActive())
+        return;
+    processBufferedFrames();
 }
 
 void WebSocketChannel::didFail(SocketStreamHandle* handle, const SocketStreamError& error)
@@ -235,47 +249,75 @@ void WebSocketChannel::didCancelAuthenticationChallenge(SocketStreamHandle*, con
 
 bool WebSocketChannel::appendToBuffer(const char* data, size_t len)
 {
-    size_t newBufferSize = m_bufferSize + len;
-    if (newBufferSize < m_bufferSize) {
-        LOG(Network, "WebSocket buffer overflow (%lu+%lu)", static_cast<unsigned long>(m_bufferSize), static_cast<unsigned long>(len));
+    size_t newBufferSize = bufferedSize() + len;
+    if (newBufferSize < bufferedSize()) {
+        LOG(Network, "WebSocket buffer overflow (%lu+%lu)", static_cast<unsigned long>(bufferedSize()), static_cast<unsigned long>(len));
         return false;
     }
-    char* newBuffer = 0;
-    if (tryFastMalloc(newBufferSize).getValue(newBuffer)) {
-        if (m_buffer)
-            memcpy(newBuffer, m_buffer, m_bufferSize);
-        memcpy(newBuffer + m_bufferSize, data, len);
-        fastFree(m_buffer);
-        m_buffer = newBuffer;
-        m_bufferSize = newBufferSize;
-        return true;
+    if (m_bufferOffset) {
+        size_t remaining = bufferedSize();
+        memmove(m_buffer.data(), bufferedData(), remaining);
+        m_buffer.shrink(remaining);
+        m_bufferOffset = 0;
     }
+    if (m_buffer.tryAppend(data, len))
+        return true;
     m_context->addMessage(JSMessageSource, LogMessageType, ErrorMessageLevel, makeString("WebSocket frame (at ", String::number(static_cast<unsigned long>(newBufferSize)), " bytes) is too long."), 0, m_handshake.clientOrigin(), 0);
     return false;
 }
 
 void WebSocketChannel::skipBuffer(size_t len)
 {
-    ASSERT(len <= m_bufferSize);
-    m_bufferSize -= len;
-    if (!m_bufferSize) {
-        fastFree(m_buffer);
-        m_buffer = 0;
+    ASSERT(len <= bufferedSize());
+    m_bufferOffset += len;
+    if (m_bufferOffset < m_buffer.size())
         return;
+    m_bufferOffset = 0;
+    if (m_buffer.capacity() > maxRetainedBufferCapacity)
+        m_buffer.clear();
+    else
+        m_buffer.shrink(0);
+}
+
+bool WebSocketChannel::processBufferedFrames()
+{
+    double deadline = currentTime() + processingTimeSlice;
+    while (!m_suspended && m_client && hasBufferedData()) {
+        if (!processBuffer())
+            break;
+        if (m_pendingMessages.size() >= maxMessagesPerBatch)
+            flushPendingMessages();
+        if (hasBufferedData() && currentTime() >= deadline) {
+            flushPendingMessages();
+            if (m_client && !m_suspended && !m_resumeTimer.isActive())
+                m_resumeTimer.startOneShot(0);
+            return false;
+        }
     }
-    memmove(m_buffer, m_buffer + len, m_bufferSize);
+    flushPendingMessages();
+    return true;
+}
+
+void WebSocketChannel::flushPendingMessages()
+{
+    if (m_pendingMessages.isEmpty())
+        return;
+    Vector<String> messages;
+    messages.swap(m_pendingMessages);
+    if (m_client)
+        m_client->didReceiveMessages(messages);
 }
 
 bool WebSocketChannel::processBuffer()
 {
     ASSERT(!m_suspended);
     ASSERT(m_client);
-    ASSERT(m_buffer);
+    ASSERT(hasBufferedData());
     if (m_shouldDiscardReceivedData)
         return false;
 
     if (m_handshake.mode() == WebSocketHandshake::Incomplete) {
-        int headerLength = m_handshake.readServerHandshake(m_buffer, m_bufferSize);
+        int headerLength = m_handshake.readServerHandshake(bufferedData(), bufferedSize());
         if (headerLength <= 0)
             return false;
         if (m_handshake.mode() == WebSocketHandshake::Connected) {
@@ -294,8 +336,8 @@ bool WebSocketChannel::processBuffer()
             LOG(Network, "WebSocketChannel %p connected", this);
             skipBuffer(headerLength);
             m_client->didConnect();
-            LOG(Network, "remaining in read buf %lu", static_cast<unsigned long>(m_bufferSize));
-            return m_buffer;
+            LOG(Network, "remaining in read buf %lu", static_cast<unsigned long>(bufferedSize()));
+            return hasBufferedData();
         }
         LOG(Network, "WebSocketChannel %p connection failed", this);
         skipBuffer(headerLength);
@@ -307,9 +349,9 @@ bool WebSocketChannel::processBuffer()
     if (m_handshake.mode() != WebSocketHandshake::Connected)
         return false;
 
-    const char* nextFrame = m_buffer;
-    const char* p = m_buffer;
-    const char* end = p + m_bufferSize;
+    const char* nextFrame = bufferedData();
+    const char* p = bufferedData();
+    const char* end = p + bufferedSize();
 
     unsigned char frameByte = static_cast<unsigned char>(*p++);
     if ((frameByte & 0x80) == 0x80) {
@@ -345,8 +387,11 @@ bool WebSocketChannel::processBuffer()
             errorFrame = true;
         }
         if (errorFrame) {
-            skipBuffer(m_bufferSize); // Save memory.
+            skipBuffer(bufferedSize()); // Save memory.
             m_shouldDiscardReceivedData = true;
+            flushPendingMessages();
+            if (!m_client)
+                return false;
             m_client->didReceiveMessageError();
             if (!m_client)
                 return false;
@@ -358,10 +403,12 @@ bool WebSocketChannel::processBuffer()
         if (p + length < end) {
             p += length;
             nextFrame = p;
-            ASSERT(nextFrame > m_buffer);
-            skipBuffer(nextFrame - m_buffer);
-            m_client->didReceiveMessageError();
-            return m_buffer;
+            ASSERT(nextFrame > bufferedData());
+            skipBuffer(nextFrame - bufferedData());
+            flushPendingMessages();
+            if (m_client)
+                m_client->didReceiveMessageError();
+            return hasBufferedData();
         }
         return false;
     }
@@ -374,14 +421,15 @@ bool WebSocketChannel::processBuffer()
         ++p;
         nextFrame = p;
         if (frameByte == 0x00) {
-            String msg = String::fromUTF8(msgStart, msgLength);
-            skipBuffer(nextFrame - m_buffer);
-            m_client->didReceiveMessage(msg);
+            m_pendingMessages.append(String::fromUTF8(msgStart, msgLength));
+            skipBuffer(nextFrame - bufferedData());
         } else {
-            skipBuffer(nextFrame - m_buffer);
-            m_client->didReceiveMessageError();
+            skipBuffer(nextFrame - bufferedData());
+            flushPendingMessages();
+            if (m_client)
+                m_client->didReceiveMessageError();
         }
-        return m_buffer;
+        return hasBufferedData();
     }
     return false;
 }
@@ -391,9 +439,8 @@ void WebSocketChannel::resumeTimerFired(Timer<WebSocketChannel>* timer)
     ASSERT_UNUSED(timer, timer == &m_resumeTimer);
 
     RefPtr<WebSocketChannel> protect(this); // The client can close the channel, potentially removing the last reference.
-    while (!m_suspended && m_client && m_buffer)
-        if (!processBuffer())
-            break;
+    if (!processBufferedFrames())
+        return;
     if (!m_suspended && m_client && m_closed && m_handle)
         didClose(m_handle.get());
 }
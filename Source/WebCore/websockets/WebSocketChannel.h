@@ -82,15 +82,23 @@ namespace WebCore {
 
         bool appendToBuffer(const char* data, size_t len);
         void skipBuffer(size_t len);
+        const char* bufferedData() const { return m_buffer.data() + m_bufferOffset; }
+        size_t bufferedSize() const { return m_buffer.size() - m_bufferOffset; }
+        bool hasBufferedData() const { return m_bufferOffset < m_buffer.size(); }
         bool processBuffer();
+        bool processBufferedFrames();
+        void flushPendingMessages();
         void resumeTimerFired(Timer<WebSocketChannel>* timer);
 
         ScriptExecutionContext* m_context;
         WebSocketChannelClient* m_client;
         WebSocketHandshake m_handshake;
         RefPtr<SocketStreamHandle> m_handle;
-        char* m_buffer;
-        size_t m_bufferSize;
+        // Received bytes; everything before m_bufferOffset has already been parsed
+        // and is only dropped when more data is appended.
+        Vector<char> m_buffer;
+        size_t m_bufferOffset;
+        Vector<String> m_pendingMessages;
 
         Timer<WebSocketChannel> m_resumeTimer;
         bool m_suspended;
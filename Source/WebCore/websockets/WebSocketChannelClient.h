@@ -33,6 +33,9 @@
 
 #if ENABLE(WEB_SOCKETS)
 
+#include <wtf/Forward.h>
+#include <wtf/Vector.h>
+
 namespace WebCore {
 
     class WebSocketChannelClient {
@@ -40,6 +43,12 @@ namespace WebCore {
         virtual ~WebSocketChannelClient() { }
         virtual void didConnect() { }
         virtual void didReceiveMessage(const String&) { }
+        // Messages parsed from the same burst of network data are handed over together.
+        virtual void didReceiveMessages(const Vector<String>& messages)
+        {
+            for (size_t i = 0; i < messages.size(); ++i)
+                didReceiveMessage(messages[i]);
+        }
         virtual void didReceiveMessageError() { }
         virtual void didClose(unsigned long /* unhandledBufferedAmount */) { }
 
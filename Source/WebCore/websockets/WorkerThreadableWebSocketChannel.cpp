@@ -45,6 +45,8 @@
 #include "WorkerRunLoop.h"
 #include "WorkerThread.h"
 
+#include <wtf/OwnPtr.h>
+#include <wtf/PassOwnPtr.h>
 #include <wtf/PassRefPtr.h>
 
 namespace WebCore {
@@ -220,6 +222,27 @@ void WorkerThreadableWebSocketChannel::Peer::didReceiveMessage(const String& mes
     m_loaderProxy.postTaskForModeToWorkerContext(createCallbackTask(&workerContextDidReceiveMessage, m_workerClientWrapper, message), m_taskMode);
 }
 
+static void workerContextDidReceiveMessages(ScriptExecutionContext* context, RefPtr<ThreadableWebSocketChannelClientWrapper> workerClientWrapper, PassOwnPtr<Vector<String> > messages)
+{
+    ASSERT_UNUSED(context, context->isWorkerContext());
+    workerClientWrapper->didReceiveMessages(*messages);
+}
+
+void WorkerThreadableWebSocketChannel::Peer::didReceiveMessages(const Vector<String>& messages)
+{
+    ASSERT(isMainThread());
+    if (messages.size() == 1) {
+        didReceiveMessage(messages[0]);
+        return;
+    }
+    // Post the whole batch as one task rather than one per message.
+    OwnPtr<Vector<String> > copies = adoptPtr(new Vector<String>);
+    copies->reserveInitialCapacity(messages.size());
+    for (size_t i = 0; i < messages.size(); ++i)
+        copies->uncheckedAppend(messages[i].crossThreadString());
+    m_loaderProxy.postTaskForModeToWorkerContext(createCallbackTask(&workerContextDidReceiveMessages, m_workerClientWrapper, copies.release()), m_taskMode);
+}
+
 static void workerContextDidClose(ScriptExecutionContext* context, RefPtr<ThreadableWebSocketChannelClientWrapper> workerClientWrapper, unsigned long unhandledBufferedAmount)
 {
     ASSERT_UNUSED(context, context->isWorkerContext());
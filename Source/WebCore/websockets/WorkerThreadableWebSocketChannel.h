@@ -97,6 +97,7 @@ private:
 
         virtual void didConnect();
         virtual void didReceiveMessage(const String& message);
+        virtual void didReceiveMessages(const Vector<String>& messages);
         virtual void didClose(unsigned long unhandledBufferedAmount);
 
     private:
@@ -38,10 +38,13 @@
 #include "Document.h"
 #include "ErrorEvent.h"
 #include "ExceptionCode.h"
+#include "Logging.h"
 #include "MessageEvent.h"
 #include "ScriptCallStack.h"
 #include "ScriptExecutionContext.h"
 #include "Worker.h"
+#include <wtf/CurrentTime.h>
+#include <wtf/text/CString.h>
 
 namespace WebCore {
 
@@ -221,6 +224,8 @@ WorkerMessagingProxy::WorkerMessagingProxy(Worker* workerObject)
     , m_unconfirmedMessageCount(0)
     , m_workerThreadHadPendingActivity(false)
     , m_askedToTerminate(false)
+    , m_creationTime(currentTime())
+    , m_firstMessageConfirmed(false)
 {
     ASSERT(m_workerObject);
     ASSERT((m_scriptExecutionContext->isDocument() && isMainThread())
@@ -236,6 +241,7 @@ WorkerMessagingProxy::~WorkerMessagingProxy()
 
 void WorkerMessagingProxy::startWorkerContext(const KURL& scriptURL, const String& userAgent, const String& sourceCode)
 {
+    LOG(Threading, "Worker %p loaded %s in %.1fms", this, scriptURL.string().utf8().data(), (currentTime() - m_creationTime) * 1000);
     RefPtr<DedicatedWorkerThread> thread = DedicatedWorkerThread::create(scriptURL, userAgent, sourceCode, *this, *this);
     workerThreadCreated(thread);
     thread->start();
@@ -368,6 +374,10 @@ void WorkerMessagingProxy::reportPendingActivityInternal(bool confirmingMessage,
     if (confirmingMessage && !m_askedToTerminate) {
         ASSERT(m_unconfirmedMessageCount);
         --m_unconfirmedMessageCount;
+        if (!m_firstMessageConfirmed) {
+            m_firstMessageConfirmed = true;
+            LOG(Threading, "Worker %p handled its first message %.1fms after creation", this, (currentTime() - m_creationTime) * 1000);
+        }
     }
 
     m_workerThreadHadPendingActivity = hasPendingActivity;
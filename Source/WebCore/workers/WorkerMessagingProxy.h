@@ -101,6 +101,11 @@ namespace WebCore {
 
         bool m_askedToTerminate;
 
+        // Startup timing, logged on the Threading channel: from new Worker() to the script being loaded
+        // and to the worker confirming that it handled its first message.
+        double m_creationTime;
+        bool m_firstMessageConfirmed;
+
         Vector<OwnPtr<ScriptExecutionContext::Task> > m_queuedEarlyTasks; // Tasks are queued here until there's a thread object created.
     };
 
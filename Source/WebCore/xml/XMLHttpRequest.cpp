@@ -29,6 +29,7 @@
 #include "DOMFormData.h"
 #include "DOMImplementation.h"
 #include "Document.h"
+#include "DocumentParser.h"
 #include "Event.h"
 #include "EventException.h"
 #include "EventListener.h"
@@ -260,6 +261,38 @@ Document* XMLHttpRequest::responseXML(ExceptionCode& ec)
     return m_responseXML.get();
 }
 
+bool XMLHttpRequest::shouldParseResponseXMLIncrementally() const
+{
+    // responseText is not exposed for the "document" response type, so the
+    // only consumer of the decoded text is the parser and it can be fed as the
+    // data arrives instead of re-parsing the whole response at the end.
+    if (responseTypeCode() != ResponseTypeDocument || m_createdDocument)
+        return false;
+    if (scriptExecutionContext()->isWorkerContext())
+        return false;
+    return !m_response.isHTTP() || responseIsXML();
+}
+
+void XMLHttpRequest::appendToIncrementalResponseXML(const String& decoded)
+{
+    if (!m_responseXML) {
+        m_responseXML = Document::create(0, m_url);
+        m_responseXML->setSecurityOrigin(document()->securityOrigin());
+        m_responseXML->open();
+    }
+    if (!decoded.isEmpty() && m_responseXML->parser())
+        m_responseXML->parser()->append(decoded);
+}
+
+void XMLHttpRequest::finishIncrementalResponseXML(const String& remainder)
+{
+    appendToIncrementalResponseXML(remainder);
+    m_responseXML->close();
+    if (!m_responseXML->wellFormed())
+        m_responseXML = 0;
+    m_createdDocument = true;
+}
+
 #if ENABLE(XHR_RESPONSE_BLOB)
 Blob* XMLHttpRequest::responseBlob(ExceptionCode& ec) const
 {
@@ -985,8 +1018,12 @@ void XMLHttpRequest::didFinishLoading(unsigned long identifier, double)
     if (m_state < HEADERS_RECEIVED)
         changeState(HEADERS_RECEIVED);
 
-    if (m_decoder)
-        m_responseBuilder.append(m_decoder->flush());
+    if (m_decoder) {
+        String remainder = m_decoder->flush();
+        m_responseBuilder.append(remainder);
+        if (m_responseXML && !m_createdDocument)
+            finishIncrementalResponseXML(remainder);
+    }
 
     m_responseBuilder.shrinkToFit();
 
@@ -994,7 +1031,8 @@ void XMLHttpRequest::didFinishLoading(unsigned long identifier, double)
     // FIXME: Set m_responseBlob to something here in the ResponseTypeBlob case.
 #endif
 
-    InspectorInstrumentation::resourceRetrievedByXMLHttpRequest(scriptExecutionContext(), identifier, m_responseBuilder.toStringPreserveCapacity(), m_url, m_lastSendURL, m_lastSendLineNumber);
+    if (InspectorInstrumentation::hasFrontends())
+        InspectorInstrumentation::resourceRetrievedByXMLHttpRequest(scriptExecutionContext(), identifier, m_responseBuilder.toStringPreserveCapacity(), m_url, m_lastSendURL, m_lastSendLineNumber);
 
     bool hadLoader = m_loader;
     m_loader = 0;
@@ -1064,9 +1102,12 @@ void XMLHttpRequest::didReceiveData(const char* data, int len)
     if (len == -1)
         len = strlen(data);
 
-    if (useDecoder)
-        m_responseBuilder.append(m_decoder->decode(data, len));
-    else if (responseTypeCode() == ResponseTypeArrayBuffer) {
+    if (useDecoder) {
+        String decoded = m_decoder->decode(data, len);
+        m_responseBuilder.append(decoded);
+        if (shouldParseResponseXMLIncrementally())
+            appendToIncrementalResponseXML(decoded);
+    } else if (responseTypeCode() == ResponseTypeArrayBuffer) {
         // Buffer binary data.
         if (!m_binaryResponseBuilder)
             m_binaryResponseBuilder = SharedBuffer::create();
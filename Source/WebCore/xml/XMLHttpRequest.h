@@ -172,6 +172,10 @@ private:
     void clearResponseBuffers();
     void clearRequest();
 
+    bool shouldParseResponseXMLIncrementally() const;
+    void appendToIncrementalResponseXML(const String&);
+    void finishIncrementalResponseXML(const String& remainder);
+
     void createRequest(ExceptionCode&);
 
     void genericError();
@@ -26,7 +26,9 @@ LOCAL_SRC_FILES := \
 	android/WebCoreSupport/FrameLoaderClientAndroid.cpp \
 	android/WebCoreSupport/FrameNetworkingContextAndroid.cpp \
 	android/WebCoreSupport/GeolocationPermissions.cpp \
+	android/WebCoreSupport/IdleWork.cpp \
 	android/WebCoreSupport/MediaPlayerPrivateAndroid.cpp \
+	android/WebCoreSupport/MemoryPressure.cpp \
 	android/WebCoreSupport/MemoryUsage.cpp \
 	android/WebCoreSupport/PlatformBridge.cpp \
 	android/WebCoreSupport/ResourceLoaderAndroid.cpp \
@@ -37,11 +39,13 @@ ifeq ($(HTTP_STACK),chrome)
 LOCAL_SRC_FILES += \
 	android/WebCoreSupport/ChromiumInit.cpp \
 	android/WebCoreSupport/CacheResult.cpp \
+	android/WebCoreSupport/NetworkPredictor.cpp \
 	android/WebCoreSupport/WebCache.cpp \
 	android/WebCoreSupport/WebCookieJar.cpp \
 	android/WebCoreSupport/WebUrlLoader.cpp \
 	android/WebCoreSupport/WebUrlLoaderClient.cpp \
 	android/WebCoreSupport/WebRequest.cpp \
+	android/WebCoreSupport/WebRequestArchive.cpp \
 	android/WebCoreSupport/WebRequestContext.cpp \
 	android/WebCoreSupport/WebResourceRequest.cpp \
 	android/WebCoreSupport/WebResponse.cpp \
@@ -94,6 +98,7 @@ LOCAL_SRC_FILES += \
 	android/nav/CachedNode.cpp \
 	android/nav/CachedRoot.cpp \
 	android/nav/FindCanvas.cpp \
+	android/nav/FindSearch.cpp \
 	android/nav/SelectText.cpp \
 	android/nav/WebView.cpp \
 	\
@@ -95,6 +95,7 @@ static const char* timeCounterNames[] = {
     "Java callback (frame bridge)",
     "parsing (may include calcStyle, Java callback or inline script execution)",
     "layout", 
+    "event dispatch",
     "native 1 (frame bridge)",
     "native 2 (resource load)", 
     "native 3 (shared timer)", 
@@ -53,6 +53,7 @@ public:
         JavaCallbackTimeCounter,
         ParsingTimeCounter,
         LayoutTimeCounter,
+        EventDispatchTimeCounter,
         // file base counters
         NativeCallbackTimeCounter,  // WebCoreFrameBridge.cpp
         ResourceTimeCounter,        // WebCoreResourceLoader.cpp
@@ -48,6 +48,7 @@
 #include "HistoryItem.h"
 #include "IconDatabase.h"
 #include "MIMETypeRegistry.h"
+#include "MemoryUsage.h"
 #include "NotImplemented.h"
 #include "PackageNotifier.h"
 #include "Page.h"
@@ -887,6 +888,11 @@ void FrameLoaderClientAndroid::didFinishLoad() {
     ASSERT(m_frame);
     m_frame->document()->setExtraLayoutDelay(0);
     m_webFrame->didFinishLoad(m_frame);
+    // Keeps a snapshot per page load, so that the last two can be compared.
+    if (!m_frame->tree()->parent()) {
+        MemoryUsageSnapshot snapshot;
+        MemoryUsage::takeSnapshot(m_frame, &snapshot);
+    }
 }
 
 void FrameLoaderClientAndroid::prepareForDataSourceReplacement() {
@@ -909,6 +915,14 @@ String FrameLoaderClientAndroid::userAgent(const KURL& u) {
     return m_webFrame->userAgentForURL(&u);
 }
 
+void FrameLoaderClientAndroid::setStaleWhileRevalidate(const KURL& origin, bool enabled) {
+#if USE(CHROME_NETWORK_STACK)
+    WebViewCore* core = WebViewCore::getWebViewCore(m_frame->view());
+    if (core)
+        core->webRequestContext()->setStaleWhileRevalidate(GURL(origin.string().utf8().data()), enabled);
+#endif
+}
+
 void FrameLoaderClientAndroid::savePlatformDataToCachedFrame(WebCore::CachedFrame* cachedFrame) {
     CachedFramePlatformDataAndroid* platformData = new CachedFramePlatformDataAndroid(m_frame->settings());
     cachedFrame->setCachedFramePlatformData(platformData);
@@ -1016,7 +1030,8 @@ WTF::PassRefPtr<WebCore::Frame> FrameLoaderClientAndroid::createFrame(const KURL
     newFrame->setView(frameView);
     newFrame->init();
     newFrame->selection()->setFocused(true);
-    LOGV("::WebCore:: createSubFrame returning %p", newFrame);
+    LOGV("::WebCore:: createSubFrame returning %p (%d frames still deferred)", newFrame,
+            ownerElement->document()->deferredFrameElements().size());
 
     // The creation of the frame may have run arbitrary JavaScript that removed it from the page already.
     if (!pFrame->page())
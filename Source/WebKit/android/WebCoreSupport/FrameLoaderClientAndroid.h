@@ -176,6 +176,11 @@ namespace android {
         // ResourceRequest.
         virtual String userAgent(const KURL&);
 
+        // Lets the embedder have loads from origin served straight from the
+        // cache, with stale entries revalidated in the background. Applies to
+        // every frame of the WebView.
+        void setStaleWhileRevalidate(const KURL& origin, bool enabled);
+
         virtual void savePlatformDataToCachedFrame(WebCore::CachedFrame*);
         virtual void transitionToCommittedFromCachedFrame(WebCore::CachedFrame*);
         virtual void transitionToCommittedForNewPage();
@@ -0,0 +1,177 @@
+/*
+ * Copyright 2012, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#define LOG_TAG "IdleWork"
+
+#include "config.h"
+#include "IdleWork.h"
+
+#include "MemoryCache.h"
+#include "PageCache.h"
+#include "Timer.h"
+
+#include <cutils/log.h>
+#include <wtf/CurrentTime.h>
+#include <wtf/MainThread.h>
+#include <wtf/StdLibExtras.h>
+
+#if USE(JSC)
+#include "GCController.h"
+#include "JSDOMWindow.h"
+#include <runtime/JSLock.h>
+#elif USE(V8)
+#include <v8.h>
+#endif
+
+// Seconds without activity before the work starts
+#define IDLE_DELAY 1.0
+// Longest the work runs before yielding to the event loop, in seconds. A
+// single step, such as a full JSC collection, may take longer.
+#define IDLE_SLICE 0.010
+// Pause between two slices, in seconds
+#define IDLE_SLICE_INTERVAL 0.050
+// With JSC, the heap is only collected when it grew by this many bytes since
+// the last idle collection
+#define IDLE_GC_MIN_GROWTH (1024 * 1024)
+
+namespace android {
+
+class IdleWorkScheduler {
+public:
+    enum Step {
+        CollectJavaScript,
+        ReleasePageCache,
+        PruneMemoryCache,
+        Done
+    };
+
+    IdleWorkScheduler()
+        : m_timer(this, &IdleWorkScheduler::timerFired)
+        , m_lastActivity(currentTime())
+        , m_step(Done)
+#if USE(JSC)
+        , m_heapSizeAfterCollection(0)
+#endif
+    {
+    }
+
+    void noteActivity()
+    {
+        m_lastActivity = currentTime();
+        m_step = CollectJavaScript;
+        if (!m_timer.isActive())
+            m_timer.startOneShot(IDLE_DELAY);
+    }
+
+    double idleTime() { return currentTime() - m_lastActivity; }
+
+private:
+    void timerFired(WebCore::Timer<IdleWorkScheduler>*)
+    {
+        double idle = idleTime();
+        if (idle < IDLE_DELAY) {
+            m_timer.startOneShot(IDLE_DELAY - idle);
+            return;
+        }
+
+        double deadline = currentTime() + IDLE_SLICE;
+        while (m_step != Done && currentTime() < deadline) {
+            if (!runStep(m_step))
+                m_step = static_cast<Step>(m_step + 1);
+        }
+        if (m_step != Done)
+            m_timer.startOneShot(IDLE_SLICE_INTERVAL);
+    }
+
+    // Returns true if the step has more to do.
+    bool runStep(Step step)
+    {
+        switch (step) {
+        case CollectJavaScript:
+            return collectJavaScript();
+        case ReleasePageCache:
+            // Pages evicted from the page cache wait for the user to be idle
+            // too, see userIdleTime().
+            WebCore::pageCache()->releaseAutoreleasedPagesNow();
+            return false;
+        case PruneMemoryCache:
+            WebCore::memoryCache()->prune();
+            return false;
+        case Done:
+            break;
+        }
+        return false;
+    }
+
+    bool collectJavaScript()
+    {
+#if USE(JSC)
+        // JSC has no incremental collector, so this is one full collection
+        // at most per idle window, and only if the heap grew enough for the
+        // next allocation triggered collection to be close.
+        JSC::JSLock lock(JSC::SilenceAssertionsOnly);
+        JSC::Heap& heap = WebCore::JSDOMWindow::commonJSGlobalData()->heap;
+        if (heap.size() < m_heapSizeAfterCollection + IDLE_GC_MIN_GROWTH)
+            return false;
+        WebCore::gcController().garbageCollectNow();
+        m_heapSizeAfterCollection = heap.size();
+        LOGV("Collected the JavaScript heap, %u bytes left",
+             static_cast<unsigned>(m_heapSizeAfterCollection));
+        return false;
+#elif USE(V8)
+        // V8 paces itself and says when it has nothing left to do.
+        return !v8::V8::IdleNotification();
+#else
+        return false;
+#endif
+    }
+
+    WebCore::Timer<IdleWorkScheduler> m_timer;
+    double m_lastActivity;
+    Step m_step;
+#if USE(JSC)
+    size_t m_heapSizeAfterCollection;
+#endif
+};
+
+static IdleWorkScheduler& scheduler()
+{
+    DEFINE_STATIC_LOCAL(IdleWorkScheduler, idleWorkScheduler, ());
+    return idleWorkScheduler;
+}
+
+void IdleWork::noteActivity()
+{
+    ASSERT(isMainThread());
+    scheduler().noteActivity();
+}
+
+double IdleWork::idleTime()
+{
+    ASSERT(isMainThread());
+    return scheduler().idleTime();
+}
+
+} // namespace android
@@ -0,0 +1,190 @@
+/*
+ * Copyright 2012, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#define LOG_TAG "MemoryPressure"
+
+#include "config.h"
+#include "MemoryPressure.h"
+
+#include "BitmapAllocatorAndroid.h"
+#include "FontCache.h"
+#include "GlyphMapAndroid.h"
+#include "MemoryCache.h"
+#include "Page.h"
+#include "PageCache.h"
+
+#include <cutils/log.h>
+#include <wtf/FastMalloc.h>
+#include <wtf/MainThread.h>
+#include <wtf/StdLibExtras.h>
+
+#if USE(JSC)
+#include "GCController.h"
+#include "JSDOMWindow.h"
+#include "StringSourceProvider.h"
+#include <jit/ExecutableAllocator.h>
+#include <runtime/JSLock.h>
+#elif USE(V8)
+#include <v8.h>
+#endif
+
+namespace android {
+
+static void releaseMemoryCache(MemoryPressure::Level level)
+{
+    // The decoded data of live resources is only dropped when critical, it
+    // would have to be decoded again as soon as the page is painted.
+    bool includeLive = level >= MemoryPressure::Critical;
+    unsigned freed = WebCore::memoryCache()->pruneToMinimum(includeLive);
+    LOGD("MemoryCache: freed %u bytes", freed);
+}
+
+static void releaseFontCache()
+{
+    // This also prunes the glyph page trees of the fonts it releases.
+    size_t inactive = WebCore::fontCache()->inactiveFontDataCount();
+    WebCore::fontCache()->purgeInactiveFontData();
+    WebCore::purgeRecentGlyphPages();
+    LOGD("FontCache: released %u of %u font data", static_cast<unsigned>(inactive),
+         static_cast<unsigned>(WebCore::fontCache()->fontDataCount() + inactive));
+}
+
+static void releasePageCache()
+{
+    int pageCount = WebCore::pageCache()->pageCount();
+    int capacity = WebCore::pageCache()->capacity();
+    // Setting size to 0, makes all pages be released.
+    WebCore::pageCache()->setCapacity(0);
+    WebCore::pageCache()->releaseAutoreleasedPagesNow();
+    WebCore::pageCache()->setCapacity(capacity);
+    LOGD("PageCache: released %d pages", pageCount);
+}
+
+static void releaseJavaScriptHeap(MemoryPressure::Level level)
+{
+#if USE(JSC)
+    JSC::JSLock lock(JSC::SilenceAssertionsOnly);
+    JSC::JSGlobalData* globalData = WebCore::JSDOMWindow::commonJSGlobalData();
+    JSC::Heap& heap = globalData->heap;
+    size_t heapBefore = heap.size();
+#if ENABLE(JIT)
+    size_t codeBefore = JSC::ExecutableAllocator::committedByteCount();
+    // Code is only thrown away between scripts. In the background only the
+    // code that has not run lately goes, it is all compiled again on demand.
+    if (!globalData->dynamicGlobalObject) {
+        if (level >= MemoryPressure::Critical)
+            globalData->recompileAllJSFunctions();
+        else
+            globalData->releaseColdJITCode(codeBefore / 2);
+    }
+#endif
+    WebCore::gcController().garbageCollectNow();
+    LOGD("JavaScript heap: freed %d bytes", static_cast<int>(heapBefore - heap.size()));
+    WebCore::StringSourceProvider::clearSharedCaches();
+    LOGD("Shared parser caches: cleared");
+#if ENABLE(JIT)
+    JSC::ExecutableAllocator::Statistics code = JSC::ExecutableAllocator::statistics();
+    LOGD("JIT executable pools: freed %d bytes, %u of %u bytes committed, largest free block %u bytes",
+         static_cast<int>(codeBefore - code.committedBytes), static_cast<unsigned>(code.committedBytes),
+         static_cast<unsigned>(code.reservedBytes), static_cast<unsigned>(code.largestFreeBlock));
+#endif
+#elif USE(V8)
+    v8::HeapStatistics before;
+    v8::V8::GetHeapStatistics(&before);
+    // V8 keeps its generated code in the heap, this releases both.
+    v8::V8::LowMemoryNotification();
+    v8::HeapStatistics after;
+    v8::V8::GetHeapStatistics(&after);
+    LOGD("JavaScript heap: freed %d bytes",
+         static_cast<int>(before.used_heap_size() - after.used_heap_size()));
+#endif
+#if !USE(JSC) || !ENABLE(JIT)
+    UNUSED_PARAM(level);
+#endif
+}
+
+static void releaseFastMallocMemory()
+{
+#if !defined(USE_SYSTEM_MALLOC) || !USE_SYSTEM_MALLOC
+    // Only the free pages and this thread's cache are returned, the caches of
+    // the other threads are small and get scavenged as they free.
+    size_t committedBefore = WTF::fastMallocStatistics().committedVMBytes;
+    WTF::releaseFastMallocFreeMemory();
+    WTF::FastMallocStatistics statistics = WTF::fastMallocStatistics();
+    LOGD("FastMalloc: freed %d bytes, %u of %u bytes committed, %u bytes in thread caches",
+         static_cast<int>(committedBefore - statistics.committedVMBytes),
+         static_cast<unsigned>(statistics.committedVMBytes),
+         static_cast<unsigned>(statistics.reservedVMBytes),
+         static_cast<unsigned>(statistics.freeListBytes));
+
+    WTF::FastMallocThreadStatistics threads[8];
+    size_t threadCount = WTF::fastMallocThreadStatistics(threads, WTF_ARRAY_LENGTH(threads));
+    for (size_t i = 0; i < std::min(threadCount, WTF_ARRAY_LENGTH(threads)); ++i) {
+        LOGD("FastMalloc: thread cache %u holds %u bytes, %u central fetches, %u central releases",
+             static_cast<unsigned>(i), static_cast<unsigned>(threads[i].cacheBytes),
+             static_cast<unsigned>(threads[i].centralCacheFetches),
+             static_cast<unsigned>(threads[i].centralCacheReleases));
+    }
+#endif
+}
+
+void MemoryPressure::release(Level level)
+{
+    ASSERT(isMainThread());
+    LOGD("Releasing memory, level %d", level);
+
+#if ENABLE(LINK_PREFETCH)
+    // A prefetched document would otherwise sit in the memory cache until
+    // the navigation it was fetched for, which may never come.
+    WebCore::Page::cancelSpeculativeLoadsForAllPages();
+#endif
+    releaseMemoryCache(level);
+    releaseFontCache();
+    if (level < Background)
+        return;
+
+    releasePageCache();
+    releaseJavaScriptHeap(level);
+    // After the collection, so the cells it freed go back to the system too.
+    releaseFastMallocMemory();
+    if (level < Critical)
+        return;
+
+    // Anything not on screen can be decoded again when it is next drawn.
+    WebCore::BitmapAllocatorAndroid::purgeCache();
+    LOGD("Decoded images: purged");
+}
+
+static void releaseOnMainThread(void* level)
+{
+    MemoryPressure::release(static_cast<MemoryPressure::Level>(reinterpret_cast<intptr_t>(level)));
+}
+
+void MemoryPressure::notify(Level level)
+{
+    callOnMainThread(releaseOnMainThread, reinterpret_cast<void*>(static_cast<intptr_t>(level)));
+}
+
+} // namespace android
@@ -0,0 +1,61 @@
+/*
+ * Copyright 2012, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef MemoryPressure_h
+#define MemoryPressure_h
+
+namespace android {
+
+// Single entry point for the platform's low memory signals. Each level frees
+// what the one below it does, and then some; the caches are released in
+// order, from the cheapest to rebuild to the most expensive, and each of them
+// logs what it gave back.
+//
+// The textures are owned by the UI thread and are trimmed there by WebView,
+// everything else is only touched on the WebCore thread.
+class MemoryPressure {
+public:
+    enum Level {
+        // The WebView is no longer visible: drop what a repaint won't need.
+        UIHidden,
+        // The process is in the background: also drop the page cache and
+        // collect the JavaScript heap.
+        Background,
+        // The system is about to kill background processes: drop the decoded
+        // data of live resources and images too.
+        Critical
+    };
+
+    // Must be called on the WebCore thread.
+    static void release(Level);
+
+    // Can be called from any thread, the release happens on the WebCore
+    // thread.
+    static void notify(Level);
+};
+
+} // namespace android
+
+#endif // MemoryPressure_h
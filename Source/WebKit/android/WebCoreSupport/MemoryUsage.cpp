@@ -26,10 +26,28 @@
 #include "config.h"
 #include "MemoryUsage.h"
 
+#include "Document.h"
+#include "FontCache.h"
+#include "Frame.h"
+#include "FrameTree.h"
+#include "MemoryCache.h"
+#include "RenderArena.h"
+#include "WebViewCore.h"
+
 #include <malloc.h>
 #include <wtf/CurrentTime.h>
+#include <wtf/FastMalloc.h>
+#include <wtf/Threading.h>
 
-#if USE(V8)
+#if USE(ACCELERATED_COMPOSITING)
+#include "TilesManager.h"
+#endif
+
+#if USE(JSC)
+#include "JSDOMWindow.h"
+#include <jit/ExecutableAllocator.h>
+#include <runtime/JSLock.h>
+#elif USE(V8)
 #include <v8.h>
 #endif // USE(V8)
 
@@ -57,7 +75,10 @@ int MemoryUsageCache::getCachedMemoryUsage(bool forceFresh)
         return m_cachedMemoryUsage;
 
     struct mallinfo minfo = mallinfo();
-    m_cachedMemoryUsage = (minfo.hblkhd + minfo.arena) >> 20;
+    size_t usage = minfo.hblkhd + minfo.arena;
+    // FastMalloc maps its own spans, mallinfo does not see them.
+    usage += WTF::fastMallocStatistics().committedVMBytes;
+    m_cachedMemoryUsage = usage >> 20;
 
 #if USE(V8)
     v8::HeapStatistics stat;
@@ -79,3 +100,126 @@ int MemoryUsage::memoryUsageMb(bool forceFresh)
 int MemoryUsage::m_lowMemoryUsageMb = 0;
 int MemoryUsage::m_highMemoryUsageMb = 0;
 int MemoryUsage::m_highUsageDeltaMb = 0;
+
+void MemoryUsageSnapshot::add(const char* name, int64_t value)
+{
+    Entry entry = { name, value };
+    m_entries.append(entry);
+}
+
+String MemoryUsageSnapshot::dump(const MemoryUsageSnapshot* previous) const
+{
+    String result;
+    for (size_t i = 0; i < m_entries.size(); ++i) {
+        const Entry& entry = m_entries[i];
+        result += String::format("%s %lld", entry.name, static_cast<long long>(entry.value));
+        // Snapshots are always taken in the same order, but the entries that
+        // depend on the build or on the GL state may come and go.
+        if (previous) {
+            for (size_t j = 0; j < previous->m_entries.size(); ++j) {
+                if (!strcmp(previous->m_entries[j].name, entry.name)) {
+                    result += String::format(" (%+lld)",
+                        static_cast<long long>(entry.value - previous->m_entries[j].value));
+                    break;
+                }
+            }
+        }
+        result += "\n";
+    }
+    return result;
+}
+
+struct SnapshotHistory {
+    Mutex mutex;
+    MemoryUsageSnapshot last;
+    MemoryUsageSnapshot previous;
+};
+
+static SnapshotHistory& snapshotHistory()
+{
+    AtomicallyInitializedStatic(SnapshotHistory&, history = *new SnapshotHistory);
+    return history;
+}
+
+void MemoryUsage::takeSnapshot(WebCore::Frame* mainFrame, MemoryUsageSnapshot* snapshot)
+{
+    struct mallinfo minfo = mallinfo();
+    snapshot->add("malloc_in_use_bytes", minfo.uordblks);
+    snapshot->add("malloc_mapped_bytes", minfo.hblkhd + minfo.arena);
+    FastMallocStatistics fastMalloc = fastMallocStatistics();
+    snapshot->add("fastmalloc_committed_bytes", fastMalloc.committedVMBytes);
+    snapshot->add("fastmalloc_free_list_bytes", fastMalloc.freeListBytes);
+
+#if USE(JSC)
+    {
+        JSC::JSLock lock(JSC::SilenceAssertionsOnly);
+        JSC::Heap& heap = WebCore::JSDOMWindow::commonJSGlobalData()->heap;
+        snapshot->add("js_heap_used_bytes", heap.size());
+        snapshot->add("js_heap_capacity_bytes", heap.capacity());
+        snapshot->add("js_heap_objects", heap.objectCount());
+    }
+#if ENABLE(JIT)
+    snapshot->add("jit_code_committed_bytes", JSC::ExecutableAllocator::committedByteCount());
+#endif
+#elif USE(V8)
+    // The generated code lives in the V8 heap, it has no entry of its own.
+    v8::HeapStatistics heap;
+    v8::V8::GetHeapStatistics(&heap);
+    snapshot->add("js_heap_used_bytes", heap.used_heap_size());
+    snapshot->add("js_heap_capacity_bytes", heap.total_heap_size());
+#endif
+
+    int documents = 0;
+    int nodes = 0;
+    size_t renderArenaBytes = 0;
+    for (WebCore::Frame* frame = mainFrame; frame; frame = frame->tree()->traverseNext()) {
+        WebCore::Document* document = frame->document();
+        if (!document)
+            continue;
+        ++documents;
+        for (WebCore::Node* node = document; node; node = node->traverseNextNode())
+            ++nodes;
+        if (document->renderArena())
+            renderArenaBytes += document->renderArena()->reportPoolSize(false);
+    }
+    snapshot->add("dom_documents", documents);
+    snapshot->add("dom_nodes", nodes);
+    snapshot->add("render_arena_bytes", renderArenaBytes);
+
+    WebCore::MemoryCache::Statistics cache = WebCore::memoryCache()->getStatistics();
+    snapshot->add("cache_live_bytes", WebCore::memoryCache()->getLiveSize());
+    snapshot->add("cache_dead_bytes", WebCore::memoryCache()->getDeadSize());
+    snapshot->add("cache_images", cache.images.count);
+    snapshot->add("cache_decoded_image_bytes", cache.images.decodedSize);
+
+    snapshot->add("font_data", WebCore::fontCache()->fontDataCount());
+    snapshot->add("font_data_inactive", WebCore::fontCache()->inactiveFontDataCount());
+
+    if (mainFrame && mainFrame->view())
+        snapshot->add("picture_set_pictures", android::WebViewCore::getWebViewCore(mainFrame->view())->pictureCount());
+
+#if USE(ACCELERATED_COMPOSITING)
+    // The counters are atomic, but TilesManager itself only exists once the
+    // UI thread has drawn with GL.
+    if (WebCore::TilesManager::hardwareAccelerationEnabled()) {
+        WebCore::TextureBudget* budget = WebCore::TilesManager::instance()->textureBudget();
+        snapshot->add("texture_base_tile_bytes", budget->usedBytes(WebCore::TextureBudget::BaseTileTextures));
+        snapshot->add("texture_layer_tile_bytes", budget->usedBytes(WebCore::TextureBudget::LayerTileTextures));
+        snapshot->add("texture_media_bytes", budget->usedBytes(WebCore::TextureBudget::MediaTextures));
+        snapshot->add("texture_atlas_bytes", budget->usedBytes(WebCore::TextureBudget::AtlasTextures));
+    }
+#endif
+
+    SnapshotHistory& history = snapshotHistory();
+    MutexLocker locker(history.mutex);
+    history.previous = history.last;
+    history.last = *snapshot;
+}
+
+void MemoryUsage::lastSnapshots(MemoryUsageSnapshot* last, MemoryUsageSnapshot* previous)
+{
+    SnapshotHistory& history = snapshotHistory();
+    MutexLocker locker(history.mutex);
+    *last = history.last;
+    *previous = history.previous;
+}
@@ -26,8 +26,41 @@
 #ifndef MemoryUsage_h
 #define MemoryUsage_h
 
+#include <wtf/Vector.h>
+#include <wtf/text/WTFString.h>
+
+namespace WebCore {
+class Frame;
+}
+
+// A breakdown of the process memory by subsystem, made of "name value"
+// entries. It is plain data and can be handed to another thread once taken.
+class MemoryUsageSnapshot {
+public:
+    void add(const char* name, int64_t value);
+    bool isEmpty() const { return m_entries.isEmpty(); }
+
+    // One line per entry. With a previous snapshot, each line also shows what
+    // changed since then.
+    WTF::String dump(const MemoryUsageSnapshot* previous = 0) const;
+
+private:
+    struct Entry {
+        // always a literal, so it can outlive the thread that added it
+        const char* name;
+        int64_t value;
+    };
+    WTF::Vector<Entry> m_entries;
+};
+
 class MemoryUsage {
 public:
+    // Walks the frames and caches, so must be called on the WebCore thread.
+    // The snapshot is also kept as the last one taken.
+    static void takeSnapshot(WebCore::Frame* mainFrame, MemoryUsageSnapshot* snapshot);
+    // May be called from any thread.
+    static void lastSnapshots(MemoryUsageSnapshot* last, MemoryUsageSnapshot* previous);
+
     static int memoryUsageMb(bool forceFresh);
     static int lowMemoryUsageMb() { return m_lowMemoryUsageMb; }
     static int highMemoryUsageMb() { return m_highMemoryUsageMb; }
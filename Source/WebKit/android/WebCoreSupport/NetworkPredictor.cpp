@@ -0,0 +1,163 @@
+/*
+ * Copyright 2012, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#define LOG_TAG "NetworkPredictor"
+
+#include "config.h"
+#include "NetworkPredictor.h"
+
+#include "WebCache.h"
+#include "WebUrlLoaderClient.h"
+
+#include <cutils/log.h>
+#include <wtf/CurrentTime.h>
+#include <wtf/MainThread.h>
+
+namespace android {
+
+// Chromium's host cache keeps entries for a minute, no point asking again
+// before then.
+static const double kLookupInterval = 60;
+static const size_t kMaxRecentLookups = 256;
+static const size_t kMaxLearnedOrigins = 64;
+static const size_t kMaxLearnedHostsPerOrigin = 16;
+
+namespace {
+// A lookup nobody waits for. Owns itself and is deleted once the result is
+// in the host cache.
+class SpeculativeLookup {
+public:
+    SpeculativeLookup(const std::string& host)
+        : m_info(net::HostPortPair(host, 80))
+        , m_callback(this, &SpeculativeLookup::done)
+    {
+        m_info.set_priority(net::IDLE);
+        m_info.set_is_speculative(true);
+    }
+
+    void start(net::HostResolver* resolver)
+    {
+        int result = resolver->Resolve(m_info, &m_addresses, &m_callback, 0, net::BoundNetLog());
+        if (result != net::ERR_IO_PENDING)
+            done(result);
+    }
+
+private:
+    void done(int) { delete this; }
+
+    net::HostResolver::RequestInfo m_info;
+    net::AddressList m_addresses;
+    net::CompletionCallbackImpl<SpeculativeLookup> m_callback;
+};
+}
+
+NetworkPredictor* NetworkPredictor::instance()
+{
+    static NetworkPredictor* predictor = new NetworkPredictor();
+    return predictor;
+}
+
+NetworkPredictor::NetworkPredictor()
+    : m_lookups(0)
+    , m_learnedLookups(0)
+    , m_hits(0)
+{
+}
+
+void NetworkPredictor::preresolve(const std::string& host)
+{
+    ASSERT(isMainThread());
+    if (host.empty())
+        return;
+
+    double now = WTF::currentTime();
+    std::map<std::string, double>::iterator it = m_recentLookups.find(host);
+    if (it != m_recentLookups.end() && now - it->second < kLookupInterval)
+        return;
+    if (m_recentLookups.size() >= kMaxRecentLookups) {
+        m_recentLookups.clear();
+        m_unusedLookups.clear();
+    }
+    m_recentLookups[host] = now;
+    m_unusedLookups.insert(host);
+
+    base::Thread* thread = WebUrlLoaderClient::ioThread();
+    if (!thread)
+        return;
+    m_lookups++;
+    thread->message_loop()->PostTask(FROM_HERE, NewRunnableFunction(&NetworkPredictor::resolveOnIOThread, host));
+}
+
+void NetworkPredictor::resolveOnIOThread(std::string host)
+{
+    (new SpeculativeLookup(host))->start(WebCache::get(false)->hostResolver());
+}
+
+void NetworkPredictor::willStartRequest(const GURL& url, const std::string& firstPartyHost, bool isMainFrameNavigation, bool isPrivateBrowsing)
+{
+    ASSERT(isMainThread());
+    if (isPrivateBrowsing || (!url.SchemeIs("http") && !url.SchemeIs("https")))
+        return;
+    std::string host = url.host();
+
+    // Only the first request to a host benefits from the lookup.
+    if (m_unusedLookups.erase(host))
+        m_hits++;
+
+    if (isMainFrameNavigation) {
+        std::map<std::string, std::vector<std::string> >::const_iterator learned = m_learnedHosts.find(host);
+        if (learned == m_learnedHosts.end())
+            return;
+        for (size_t i = 0; i < learned->second.size(); i++) {
+            unsigned lookups = m_lookups;
+            preresolve(learned->second[i]);
+            m_learnedLookups += m_lookups - lookups;
+        }
+    } else if (!firstPartyHost.empty() && host != firstPartyHost)
+        learn(firstPartyHost, host);
+}
+
+void NetworkPredictor::learn(const std::string& originHost, const std::string& host)
+{
+    std::map<std::string, std::vector<std::string> >::iterator it = m_learnedHosts.find(originHost);
+    if (it == m_learnedHosts.end()) {
+        if (m_learnedHosts.size() >= kMaxLearnedOrigins)
+            m_learnedHosts.erase(m_learnedHosts.begin());
+        it = m_learnedHosts.insert(std::make_pair(originHost, std::vector<std::string>())).first;
+    }
+    std::vector<std::string>& hosts = it->second;
+    if (hosts.size() >= kMaxLearnedHostsPerOrigin)
+        return;
+    if (std::find(hosts.begin(), hosts.end(), host) == hosts.end())
+        hosts.push_back(host);
+}
+
+void NetworkPredictor::dumpStats() const
+{
+    LOGD("%u speculative lookups (%u from learned hosts), %u requests found their host looked up",
+         m_lookups, m_learnedLookups, m_hits);
+}
+
+} // namespace android
@@ -0,0 +1,82 @@
+/*
+ * Copyright 2012, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef NetworkPredictor_h
+#define NetworkPredictor_h
+
+#include "ChromiumIncludes.h"
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace android {
+
+// Resolves hosts ahead of the requests that will need them. Hosts come from
+// the preload scanners (through WebCore::prefetchDNS) as soon as a URL is
+// seen, and from the subresource hosts learned on earlier visits to the same
+// origin when a main frame navigation starts.
+//
+// All methods must be called on the WebCore thread. The lookups themselves
+// run on the network thread, and are never issued for private browsing.
+class NetworkPredictor {
+public:
+    static NetworkPredictor* instance();
+
+    // Requests a speculative lookup of host, unless one was made recently.
+    void preresolve(const std::string& host);
+
+    // Called by WebUrlLoaderClient as each request starts. firstPartyHost is
+    // the host of the main document the request is made for. Nothing is
+    // learned from private browsing requests.
+    void willStartRequest(const GURL& url, const std::string& firstPartyHost, bool isMainFrameNavigation, bool isPrivateBrowsing);
+
+    void dumpStats() const;
+
+private:
+    NetworkPredictor();
+
+    void learn(const std::string& originHost, const std::string& host);
+    static void resolveOnIOThread(std::string host);
+
+    // When each host was last looked up, so the same host isn't sent to the
+    // resolver for every URL on the page.
+    std::map<std::string, double> m_recentLookups;
+    // Hosts looked up that no request has been made to yet.
+    std::set<std::string> m_unusedLookups;
+    // Cross-host subresources seen for each main document host.
+    std::map<std::string, std::vector<std::string> > m_learnedHosts;
+
+    unsigned m_lookups;
+    unsigned m_learnedLookups;
+    // Requests to a host that had been looked up ahead of them.
+    unsigned m_hits;
+};
+
+} // namespace android
+
+#endif // NetworkPredictor_h
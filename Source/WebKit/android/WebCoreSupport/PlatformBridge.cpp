@@ -30,12 +30,15 @@
 #include "Document.h"
 #include "FileSystemClient.h"
 #include "FrameView.h"
+#include "IdleWork.h"
 #include "JNIUtility.h"
 #include "JavaSharedClient.h"
 #include "KeyGeneratorClient.h"
 #include "MemoryUsage.h"
+#include "NetworkPredictor.h"
 #include "PluginView.h"
 #include "Settings.h"
+#include "WebCache.h"
 #include "WebCookieJar.h"
 #include "WebRequestContext.h"
 #include "WebViewCore.h"
@@ -75,7 +78,7 @@ void PlatformBridge::setCookies(const Document* document, const KURL& url, const
     std::string cookieValue(value.utf8().data());
     GURL cookieGurl(url.string().utf8().data());
     bool isPrivateBrowsing = document->settings() && document->settings()->privateBrowsingEnabled();
-    WebCookieJar::get(isPrivateBrowsing)->cookieStore()->SetCookie(cookieGurl, cookieValue);
+    WebCookieJar::get(isPrivateBrowsing)->setCookieFromDocument(cookieGurl, cookieValue);
 #else
     CookieClient* client = JavaSharedClient::GetCookieClient();
     if (!client)
@@ -90,7 +93,7 @@ String PlatformBridge::cookies(const Document* document, const KURL& url)
 #if USE(CHROME_NETWORK_STACK)
     GURL cookieGurl(url.string().utf8().data());
     bool isPrivateBrowsing = document->settings() && document->settings()->privateBrowsingEnabled();
-    std::string cookies = WebCookieJar::get(isPrivateBrowsing)->cookieStore()->GetCookies(cookieGurl);
+    std::string cookies = WebCookieJar::get(isPrivateBrowsing)->cookiesForDocument(cookieGurl);
     String cookieString(cookies.c_str());
     return cookieString;
 #else
@@ -140,6 +143,20 @@ bool PlatformBridge::popupsAllowed(NPP)
     return false;
 }
 
+void PlatformBridge::prefetchDNS(const String& hostname)
+{
+#if USE(CHROME_NETWORK_STACK)
+    NetworkPredictor::instance()->preresolve(hostname.utf8().data());
+#endif
+}
+
+void PlatformBridge::cacheMetadata(const KURL& url, double responseTime, const Vector<char>& data)
+{
+#if USE(CHROME_NETWORK_STACK)
+    WebCache::get(false)->cacheMetadata(url.string().utf8().data(), responseTime, data.data(), data.size());
+#endif
+}
+
 String PlatformBridge::resolveFilePathForContentUri(const String& contentUri)
 {
     FileSystemClient* client = JavaSharedClient::GetFileSystemClient();
@@ -230,6 +247,11 @@ int PlatformBridge::actualMemoryUsageMB()
     return MemoryUsage::memoryUsageMb(true);
 }
 
+double PlatformBridge::userIdleTime()
+{
+    return IdleWork::idleTime();
+}
+
 bool PlatformBridge::canSatisfyMemoryAllocation(long bytes)
 {
     JNIEnv* env = JSC::Bindings::getJNIEnv();
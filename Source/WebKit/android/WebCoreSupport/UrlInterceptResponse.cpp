@@ -30,23 +30,31 @@
 #include "UrlInterceptResponse.h"
 #include "WebCoreJni.h"
 
+#include <algorithm>
 #include <utils/Log.h>
 
 namespace android {
 
+// Size of the Java array each InputStream.read() fills
+static const int kJavaReadBufSize = 32768;
+
 class JavaInputStreamWrapper {
 public:
     JavaInputStreamWrapper(JNIEnv* env, jobject inputStream)
             : m_inputStream(env->NewGlobalRef(inputStream))
             , m_buffer(0) {
         LOG_ALWAYS_FATAL_IF(!inputStream);
-        jclass inputStreamClass = env->FindClass("java/io/InputStream");
-        LOG_ALWAYS_FATAL_IF(!inputStreamClass);
-        m_read = env->GetMethodID(inputStreamClass, "read", "([B)I");
-        LOG_ALWAYS_FATAL_IF(!m_read);
-        m_close = env->GetMethodID(inputStreamClass, "close", "()V");
-        LOG_ALWAYS_FATAL_IF(!m_close);
-        env->DeleteLocalRef(inputStreamClass);
+        if (!m_read) {
+            jclass inputStreamClass = env->FindClass("java/io/InputStream");
+            LOG_ALWAYS_FATAL_IF(!inputStreamClass);
+            m_read = env->GetMethodID(inputStreamClass, "read", "([BII)I");
+            LOG_ALWAYS_FATAL_IF(!m_read);
+            m_available = env->GetMethodID(inputStreamClass, "available", "()I");
+            LOG_ALWAYS_FATAL_IF(!m_available);
+            m_close = env->GetMethodID(inputStreamClass, "close", "()V");
+            LOG_ALWAYS_FATAL_IF(!m_close);
+            env->DeleteLocalRef(inputStreamClass);
+        }
     }
 
     ~JavaInputStreamWrapper() {
@@ -59,28 +67,50 @@ public:
             env->DeleteGlobalRef(m_buffer);
     }
 
+    // Fills out up to its capacity. After the first read, keeps reading only
+    // while the stream says it won't block, so that an asset served from
+    // memory or a file arrives in a few large chunks, while a slow stream
+    // still delivers what it has straight away.
     void read(std::vector<char>* out) {
         JNIEnv* env = JSC::Bindings::getJNIEnv();
-        // Initialize our read buffer to the capacity of out.
         if (!m_buffer) {
-            m_buffer = env->NewByteArray(out->capacity());
-            m_buffer = (jbyteArray) env->NewGlobalRef(m_buffer);
+            jbyteArray buffer = env->NewByteArray(kJavaReadBufSize);
+            m_buffer = (jbyteArray) env->NewGlobalRef(buffer);
+            env->DeleteLocalRef(buffer);
         }
-        int size = (int) env->CallIntMethod(m_inputStream, m_read, m_buffer);
-        if (checkException(env) || size < 0)
-            return;
-        // Copy from m_buffer to out.
-        out->resize(size);
-        env->GetByteArrayRegion(m_buffer, 0, size, (jbyte*)&out->front());
+        int capacity = out->capacity();
+        int total = 0;
+        out->clear();
+        do {
+            int size = (int) env->CallIntMethod(m_inputStream, m_read, m_buffer,
+                    0, std::min(kJavaReadBufSize, capacity - total));
+            if (checkException(env) || size <= 0)
+                break;
+            // Copy from m_buffer straight into out, which doesn't reallocate
+            // as it stays within its reserved capacity.
+            out->resize(total + size);
+            env->GetByteArrayRegion(m_buffer, 0, size, (jbyte*)&(*out)[total]);
+            total += size;
+        } while (total < capacity && available(env));
     }
 
 private:
+    bool available(JNIEnv* env) {
+        int available = (int) env->CallIntMethod(m_inputStream, m_available);
+        return !checkException(env) && available > 0;
+    }
+
     jobject    m_inputStream;
     jbyteArray m_buffer;
-    jmethodID  m_read;
-    jmethodID  m_close;
+    static jmethodID m_read;
+    static jmethodID m_available;
+    static jmethodID m_close;
 };
 
+jmethodID JavaInputStreamWrapper::m_read = 0;
+jmethodID JavaInputStreamWrapper::m_available = 0;
+jmethodID JavaInputStreamWrapper::m_close = 0;
+
 UrlInterceptResponse::UrlInterceptResponse(JNIEnv* env, jobject response) {
     jclass javaResponse = env->FindClass("android/webkit/WebResourceResponse");
     LOG_ALWAYS_FATAL_IF(!javaResponse);
@@ -150,6 +150,21 @@ void WebCache::closeIdleImpl()
     m_cache->CloseIdleConnections();
 }
 
+void WebCache::cacheMetadata(const string& url, double responseTime, const char* data, int size)
+{
+    base::Thread* thread = WebUrlLoaderClient::ioThread();
+    if (!thread || !size)
+        return;
+    scoped_refptr<IOBuffer> buffer(new IOBuffer(size));
+    memcpy(buffer->data(), data, size);
+    thread->message_loop()->PostTask(FROM_HERE, NewRunnableMethod(this, &WebCache::cacheMetadataImpl, url, responseTime, buffer, size));
+}
+
+void WebCache::cacheMetadataImpl(string url, double responseTime, scoped_refptr<IOBuffer> buffer, int size)
+{
+    m_cache->WriteMetadata(GURL(url), base::Time::FromDoubleT(responseTime), buffer, size);
+}
+
 void WebCache::clearImpl()
 {
     if (m_isClearInProgress)
@@ -34,6 +34,8 @@
 #include <platform/text/PlatformString.h>
 #include <wtf/ThreadingPrimitives.h>
 
+#include <string>
+
 namespace android {
 
 // This class is not generally threadsafe. However, get() and cleanup() are
@@ -49,6 +51,9 @@ public:
     net::HttpCache* cache() { return m_cache.get(); }
     net::ProxyConfigServiceAndroid* proxy() { return m_proxyConfigService; }
     void closeIdleConnections();
+    // Called on the WebCore thread. The write is dropped if the cache entry
+    // has been replaced since responseTime.
+    void cacheMetadata(const std::string& url, double responseTime, const char* data, int size);
 
 
 private:
@@ -62,6 +67,9 @@ private:
     // For closeIdleConnections
     void closeIdleImpl();
 
+    // For cacheMetadata
+    void cacheMetadataImpl(std::string url, double responseTime, scoped_refptr<net::IOBuffer>, int size);
+
     // For getEntry()
     void getEntryImpl();
     void openEntry(int);
@@ -33,6 +33,8 @@
 
 #include <cutils/log.h>
 #include <dirent.h>
+#include <wtf/Atomics.h>
+#include <wtf/CurrentTime.h>
 
 #undef ASSERT
 #define ASSERT(assertion, ...) do \
@@ -142,7 +144,60 @@ WebCookieJar::WebCookieJar(const std::string& databaseFilePath)
 
     FilePath cookiePath(databaseFilePath.c_str());
     m_cookieDb = new SQLitePersistentCookieStore(cookiePath);
-    m_cookieStore = new net::CookieMonster(m_cookieDb.get(), 0);
+    m_changeObserver = new ChangeObserver();
+    m_cookieStore = new net::CookieMonster(m_cookieDb.get(), m_changeObserver.get());
+}
+
+void WebCookieJar::ChangeObserver::OnCookieChanged(const net::CookieMonster::CanonicalCookie&, bool)
+{
+    atomicIncrement(&m_generation);
+}
+
+static std::string snapshotKey(const GURL& url)
+{
+    GURL::Replacements replacements;
+    replacements.ClearQuery();
+    replacements.ClearRef();
+    return url.ReplaceComponents(replacements).spec();
+}
+
+std::string WebCookieJar::cookiesForDocument(const GURL& url)
+{
+    // Expiry isn't a change the cookie store tells us about, so don't keep
+    // answering from a snapshot for long.
+    static const double kMaxSnapshotAge = 2;
+    static const size_t kMaxSnapshots = 64;
+
+    std::string key = snapshotKey(url);
+    int generation = m_changeObserver->generation();
+    double now = WTF::currentTime();
+    {
+        MutexLocker lock(m_snapshotsMutex);
+        std::map<std::string, CookieSnapshot>::const_iterator it = m_snapshots.find(key);
+        if (it != m_snapshots.end() && it->second.generation == generation && now - it->second.time < kMaxSnapshotAge)
+            return it->second.cookies;
+    }
+
+    std::string cookies = m_cookieStore->GetCookies(url);
+
+    MutexLocker lock(m_snapshotsMutex);
+    if (m_snapshots.size() >= kMaxSnapshots)
+        m_snapshots.clear();
+    CookieSnapshot& snapshot = m_snapshots[key];
+    snapshot.cookies = cookies;
+    // The generation read before the lookup, so a change made meanwhile
+    // invalidates this snapshot rather than being hidden by it.
+    snapshot.generation = generation;
+    snapshot.time = now;
+    return cookies;
+}
+
+void WebCookieJar::setCookieFromDocument(const GURL& url, const std::string& cookieLine)
+{
+    // The write goes straight to the cookie store so that script reading
+    // document.cookie back sees it. The change notification retires the
+    // snapshots it affects.
+    m_cookieStore->SetCookie(url, cookieLine);
 }
 
 bool WebCookieJar::allowCookies()
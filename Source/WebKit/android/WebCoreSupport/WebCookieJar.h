@@ -30,6 +30,9 @@
 
 #include <wtf/ThreadingPrimitives.h>
 
+#include <map>
+#include <string>
+
 namespace android {
 
 // This class is threadsafe. It is used from the IO, WebCore and Chromium IO
@@ -60,6 +63,12 @@ public:
     net::CookieStore* cookieStore() { return m_cookieStore.get(); }
     net::CookiePolicy* cookiePolicy() { return this; }
 
+    // document.cookie. Reads are answered from a snapshot of the cookies for
+    // the URL until the cookie store reports a change, so script polling the
+    // cookie string doesn't contend for the cookie monster's lock.
+    std::string cookiesForDocument(const GURL&);
+    void setCookieFromDocument(const GURL&, const std::string& cookieLine);
+
     // Get the number of cookies that have actually been saved to flash.
     // (This is used to implement CookieManager.hasCookies() in the Java framework.)
     int getNumCookiesInDatabase();
@@ -67,8 +76,29 @@ public:
 private:
     WebCookieJar(const std::string& databaseFilePath);
 
+    // Bumps a generation count on every cookie change, from whichever thread
+    // made it. Owned by the cookie monster as well as by us.
+    class ChangeObserver : public net::CookieMonster::Delegate {
+    public:
+        ChangeObserver() : m_generation(0) { }
+        virtual void OnCookieChanged(const net::CookieMonster::CanonicalCookie&, bool removed);
+        int generation() const { return m_generation; }
+    private:
+        volatile int m_generation;
+    };
+
+    struct CookieSnapshot {
+        std::string cookies;
+        int generation;
+        double time;
+    };
+
     scoped_refptr<SQLitePersistentCookieStore> m_cookieDb;
+    scoped_refptr<ChangeObserver> m_changeObserver;
     scoped_refptr<net::CookieStore> m_cookieStore;
+    // Keyed by URL without query or fragment, the parts cookies depend on.
+    std::map<std::string, CookieSnapshot> m_snapshots;
+    WTF::Mutex m_snapshotsMutex;
     bool m_allowCookies;
     mutable WTF::Mutex m_allowCookiesMutex;
 };
@@ -0,0 +1,74 @@
+/*
+ * Copyright 2012, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef WebLoadTiming_h
+#define WebLoadTiming_h
+
+#include <string>
+
+namespace android {
+
+// Milestones of a single network load, in seconds on the WTF::currentTime()
+// clock. A milestone that was not reached is 0. Only recorded for requests
+// that ask for load timing (the main resource of every frame, anything the
+// Inspector is watching, and everything while a LoadTimingObserver is set),
+// so that other loads pay nothing for it.
+struct WebLoadTiming {
+    WebLoadTiming()
+        : requestStart(0)
+        , headersReceived(0)
+        , firstByte(0)
+        , bodyComplete(0)
+        , responseDelivered(0)
+        , finishDelivered(0)
+        , wasCached(false)
+    {
+    }
+
+    bool isRecorded() const { return requestStart; }
+
+    // Set on the IO thread, by WebRequest.
+    double requestStart;
+    double headersReceived;
+    double firstByte;
+    double bodyComplete;
+    // Set on the WebCore thread, by WebUrlLoaderClient. The gap between these
+    // and their IO thread counterparts is time spent queued for WebCore.
+    double responseDelivered;
+    double finishDelivered;
+    bool wasCached;
+};
+
+// Receives the timeline of every completed load of one WebViewCore, on the
+// WebCore thread.
+class LoadTimingObserver {
+public:
+    virtual ~LoadTimingObserver() { }
+    virtual void didFinishLoad(const std::string& url, const WebLoadTiming&) = 0;
+};
+
+} // namespace android
+
+#endif
@@ -40,6 +40,7 @@
 #include <openssl/x509.h>
 #include <string>
 #include <utils/AssetManager.h>
+#include <wtf/CurrentTime.h>
 #include <cutils/properties.h>
 
 extern android::AssetManager* globalAssetManager();
@@ -61,6 +62,12 @@ namespace android {
 
 namespace {
     const int kInitialReadBufSize = 32768;
+    // Intercepted responses are usually local assets, which are read in
+    // larger chunks to cut down on the copies and WebCore thread hops
+    const int kInterceptReadBufSize = 262144;
+    // How often, in ms, the progress of a request body is reported to WebCore
+    // while it is being uploaded
+    const int kUploadProgressIntervalMs = 100;
 }
 
 static bool ShouldSetRequestPriority()
@@ -90,6 +97,12 @@ WebRequest::WebRequest(WebUrlLoaderClient* loader, const WebResourceRequest& web
     , m_loadState(Created)
     , m_authRequestCount(0)
     , m_cacheMode(0)
+    , m_staleWhileRevalidate(false)
+    , m_reportLoadTiming(webResourceRequest.reportLoadTiming())
+    , m_uploadPosition(0)
+    , m_archiveRequestStart(0)
+    , m_replayEntry(0)
+    , m_replayOffset(0)
     , m_runnableFactory(this)
     , m_wantToPause(false)
     , m_isPaused(false)
@@ -106,8 +119,7 @@ WebRequest::WebRequest(WebUrlLoaderClient* loader, const WebResourceRequest& web
 
     if (ShouldSetRequestPriority())
     {
-        ResourceType::Type chromiumTargetType = convertWebkitTargetTypeToChromiumTargetType(webResourceRequest.target_type());
-        m_request->set_priority(net::DetermineRequestPriority(chromiumTargetType));
+        m_request->set_priority(requestPriority(webResourceRequest));
     }
 }
 
@@ -122,6 +134,12 @@ WebRequest::WebRequest(WebUrlLoaderClient* loader, const WebResourceRequest& web
     , m_loadState(Created)
     , m_authRequestCount(0)
     , m_cacheMode(0)
+    , m_staleWhileRevalidate(false)
+    , m_reportLoadTiming(webResourceRequest.reportLoadTiming())
+    , m_uploadPosition(0)
+    , m_archiveRequestStart(0)
+    , m_replayEntry(0)
+    , m_replayOffset(0)
     , m_runnableFactory(this)
     , m_wantToPause(false)
     , m_isPaused(false)
@@ -172,10 +190,17 @@ void WebRequest::finish(bool success)
     // Make sure WebUrlLoaderClient doesn't delete us in the middle of this method.
     scoped_refptr<WebRequest> guard(this);
 
+    if (success && m_archiveEntry && m_loadState != Cancelled)
+        WebRequestArchive::recording()->record(*m_archiveEntry);
+    m_archiveEntry.clear();
+
     m_loadState = Finished;
     if (success) {
+        maybeRevalidateInBackground();
+        if (m_loadTiming.isRecorded())
+            m_loadTiming.bodyComplete = WTF::currentTime();
         m_urlLoader->maybeCallOnMainThread(NewRunnableMethod(
-                m_urlLoader.get(), &WebUrlLoaderClient::didFinishLoading));
+                m_urlLoader.get(), &WebUrlLoaderClient::didFinishLoading, m_loadTiming));
     } else {
         if (m_interceptResponse == NULL) {
             OwnPtr<WebResponse> webResponse(new WebResponse(m_request.get()));
@@ -212,6 +237,7 @@ void WebRequest::appendBytesToUpload(WTF::Vector<char>* data)
 void WebRequest::setRequestContext(WebRequestContext* context)
 {
     m_cacheMode = context->getCacheMode();
+    m_staleWhileRevalidate = !m_androidUrl && context->staleWhileRevalidate(GURL(m_url));
     if (m_request)
         m_request->set_context(context);
 }
@@ -229,6 +255,93 @@ void WebRequest::updateLoadFlags(int& loadFlags)
 
     if (m_isSync)
         loadFlags |= net::LOAD_IGNORE_LIMITS;
+
+    // Only plain loads are answered stale, reloads and the WebSettings cache
+    // modes keep their meaning.
+    static const int kCachePolicyFlags = net::LOAD_VALIDATE_CACHE | net::LOAD_BYPASS_CACHE
+        | net::LOAD_PREFERRING_CACHE | net::LOAD_ONLY_FROM_CACHE | net::LOAD_DISABLE_CACHE;
+    if (m_staleWhileRevalidate && (m_cacheMode || (loadFlags & kCachePolicyFlags) || m_request->method() != "GET"))
+        m_staleWhileRevalidate = false;
+    if (m_staleWhileRevalidate)
+        loadFlags |= net::LOAD_PREFERRING_CACHE;
+}
+
+namespace {
+// Refreshes a cache entry that was just served stale. Nobody consumes the
+// body, reading it to the end is what gets the new response into the cache.
+// Owns itself, and runs entirely on the network thread.
+class BackgroundRevalidation : public net::URLRequest::Delegate {
+public:
+    BackgroundRevalidation(const GURL& url, const std::string& referrer, net::URLRequestContext* context)
+        : m_request(url, this)
+        , m_buffer(new net::IOBuffer(kInitialReadBufSize))
+    {
+        m_request.set_referrer(referrer);
+        m_request.set_context(context);
+        m_request.set_load_flags(net::LOAD_VALIDATE_CACHE | net::LOAD_DO_NOT_PROMPT_FOR_LOGIN);
+        m_request.set_priority(net::IDLE);
+    }
+
+    void start() { m_request.Start(); }
+
+    virtual void OnResponseStarted(net::URLRequest* request)
+    {
+        if (!request->status().is_success())
+            return done();
+        readToEnd();
+    }
+
+    virtual void OnReadCompleted(net::URLRequest* request, int bytesRead)
+    {
+        if (!request->status().is_success() || bytesRead <= 0)
+            return done();
+        readToEnd();
+    }
+
+    virtual void OnAuthRequired(net::URLRequest* request, net::AuthChallengeInfo*)
+    {
+        request->CancelAuth();
+    }
+
+    virtual void OnCertificateRequested(net::URLRequest* request, net::SSLCertRequestInfo*)
+    {
+        request->Cancel();
+    }
+
+    virtual void OnSSLCertificateError(net::URLRequest* request, int, net::X509Certificate*)
+    {
+        request->Cancel();
+    }
+
+private:
+    void readToEnd()
+    {
+        int bytesRead = 0;
+        while (m_request.Read(m_buffer, kInitialReadBufSize, &bytesRead)) {
+            if (!bytesRead)
+                return done();
+        }
+        if (!m_request.status().is_io_pending())
+            done();
+    }
+
+    void done() { MessageLoop::current()->DeleteSoon(FROM_HERE, this); }
+
+    net::URLRequest m_request;
+    scoped_refptr<net::IOBuffer> m_buffer;
+};
+}
+
+// Called as a successful load finishes. If it was served from the cache and
+// the entry needed validating, validate it now so the next load is fresh.
+void WebRequest::maybeRevalidateInBackground()
+{
+    if (!m_staleWhileRevalidate || !m_request || !m_request->was_cached())
+        return;
+    const net::HttpResponseInfo& info = m_request->response_info();
+    if (!info.headers || !info.headers->RequiresValidation(info.request_time, info.response_time, base::Time::Now()))
+        return;
+    (new BackgroundRevalidation(m_request->url(), m_request->referrer(), m_request->context()))->start();
 }
 
 void WebRequest::start()
@@ -251,12 +364,46 @@ void WebRequest::start()
     if (m_request->url().SchemeIs("browser"))
         return handleBrowserURL(m_request->url());
 
+    if (m_reportLoadTiming)
+        m_loadTiming.requestStart = WTF::currentTime();
+
+    bool isHTTP = m_request->url().SchemeIs("http") || m_request->url().SchemeIs("https");
+    if (isHTTP && WebRequestArchive::replaying()) {
+        m_replayUrl = m_url;
+        return replayFromArchive();
+    }
+    if (isHTTP && WebRequestArchive::recording())
+        m_archiveRequestStart = WTF::currentTime();
+
     // Update load flags with settings from WebSettings
     int loadFlags = m_request->load_flags();
     updateLoadFlags(loadFlags);
     m_request->set_load_flags(loadFlags);
 
     m_request->Start();
+
+    // The body itself is streamed from memory and disk by the network stack
+    // as the socket drains, all WebCore needs is to hear how far it got.
+    if (m_request->has_upload())
+        MessageLoop::current()->PostDelayedTask(FROM_HERE, m_runnableFactory.NewRunnableMethod(&WebRequest::pollUploadProgress), kUploadProgressIntervalMs);
+}
+
+void WebRequest::pollUploadProgress()
+{
+    if (m_loadState != Started)
+        return;
+    reportUploadProgress();
+    MessageLoop::current()->PostDelayedTask(FROM_HERE, m_runnableFactory.NewRunnableMethod(&WebRequest::pollUploadProgress), kUploadProgressIntervalMs);
+}
+
+void WebRequest::reportUploadProgress()
+{
+    uint64 position = m_request->GetUploadProgress();
+    if (position == m_uploadPosition)
+        return;
+    m_uploadPosition = position;
+    m_urlLoader->maybeCallOnMainThread(NewRunnableMethod(
+            m_urlLoader.get(), &WebUrlLoaderClient::didSendData, position, m_request->get_upload()->GetContentLength()));
 }
 
 void WebRequest::cancel()
@@ -324,7 +471,7 @@ void WebRequest::handleInterceptedURL()
         // data is deleted in WebUrlLoaderClient::didReceiveAndroidFileData
         // data is sent to the webcore thread
         OwnPtr<std::vector<char> > data(new std::vector<char>);
-        data->reserve(kInitialReadBufSize);
+        data->reserve(kInterceptReadBufSize);
 
         // Read returns false on error and size of 0 on eof.
         if (!m_interceptResponse->readStream(data.get()) || data->size() == 0)
@@ -338,6 +485,88 @@ void WebRequest::handleInterceptedURL()
     finish(m_interceptResponse->status() == 200);
 }
 
+// Answers the request for m_replayUrl from the archive being replayed once
+// the configured latency has passed. Urls that were not recorded get an
+// empty 404, the network is never used.
+void WebRequest::replayFromArchive()
+{
+    WebRequestArchive* archive = WebRequestArchive::replaying();
+    m_replayEntry = archive->find(m_request->method(), m_replayUrl);
+    m_replayOffset = 0;
+    int delay = m_replayEntry ? archive->responseDelayMs(*m_replayEntry) : 0;
+    MessageLoop::current()->PostDelayedTask(FROM_HERE, m_runnableFactory.NewRunnableMethod(&WebRequest::replayResponse), delay);
+}
+
+void WebRequest::replayResponse()
+{
+    if (!m_replayEntry) {
+        m_loadState = Response;
+        OwnPtr<WebResponse> webResponse(new WebResponse(m_replayUrl, "text/html", 0, "", 404));
+        m_urlLoader->maybeCallOnMainThread(NewRunnableMethod(
+                m_urlLoader.get(), &WebUrlLoaderClient::didReceiveResponse, webResponse.release()));
+        return finish(true);
+    }
+
+    scoped_refptr<net::HttpResponseHeaders> headers(new net::HttpResponseHeaders(m_replayEntry->rawHeaders));
+    std::string location;
+    if (headers->IsRedirect(&location)) {
+        // Continues in followDeferredRedirect(), like a network redirect.
+        m_replayRedirectUrl = GURL(m_replayUrl).Resolve(location).spec();
+        OwnPtr<WebResponse> webResponse(new WebResponse(m_replayUrl, headers.get(), 0));
+        webResponse->setUrl(m_replayRedirectUrl);
+        m_urlLoader->maybeCallOnMainThread(NewRunnableMethod(
+                m_urlLoader.get(), &WebUrlLoaderClient::willSendRequest, webResponse.release()));
+        return;
+    }
+
+    m_loadState = Response;
+    OwnPtr<WebResponse> webResponse(new WebResponse(m_replayUrl, headers.get(), m_replayEntry->body.size()));
+    if (m_loadTiming.isRecorded()) {
+        m_loadTiming.headersReceived = WTF::currentTime();
+        webResponse->setLoadTiming(m_loadTiming);
+    }
+    m_urlLoader->maybeCallOnMainThread(NewRunnableMethod(
+            m_urlLoader.get(), &WebUrlLoaderClient::didReceiveResponse, webResponse.release()));
+    startReading();
+}
+
+// Stands in for read() when replaying, the body is handed out in network
+// sized chunks paced to the configured bandwidth.
+void WebRequest::replayNextChunk()
+{
+    const std::string& body = m_replayEntry->body;
+    if (m_replayOffset >= body.size())
+        return finish(true);
+
+    int bytes = std::min(body.size() - m_replayOffset, static_cast<size_t>(kInitialReadBufSize));
+    scoped_refptr<net::IOBuffer> buffer(new net::IOBuffer(bytes));
+    memcpy(buffer->data(), body.data() + m_replayOffset, bytes);
+    m_replayOffset += bytes;
+
+    m_loadState = GotData;
+    recordFirstByte();
+    m_urlLoader->maybeCallOnMainThreadWithData(buffer, bytes);
+    MessageLoop::current()->PostDelayedTask(FROM_HERE, m_runnableFactory.NewRunnableMethod(&WebRequest::startReading),
+            WebRequestArchive::replaying()->chunkDelayMs(bytes));
+}
+
+void WebRequest::beginArchiveEntry(net::URLRequest* request)
+{
+    if (!m_archiveRequestStart || !request->response_headers())
+        return;
+    m_archiveEntry.set(new WebRequestArchive::Entry);
+    m_archiveEntry->method = request->method();
+    m_archiveEntry->url = request->url().spec();
+    m_archiveEntry->rawHeaders = request->response_headers()->raw_headers();
+    m_archiveEntry->timeToFirstByteMs = static_cast<int>((WTF::currentTime() - m_archiveRequestStart) * 1000);
+}
+
+void WebRequest::appendToArchiveEntry(int bytesRead)
+{
+    if (m_archiveEntry && bytesRead > 0)
+        m_archiveEntry->body.append(m_networkBuffer->data(), bytesRead);
+}
+
 void WebRequest::handleDataURL(GURL url)
 {
     OwnPtr<std::string> data(new std::string);
@@ -400,6 +629,15 @@ void WebRequest::OnReceivedRedirect(net::URLRequest* newRequest, const GURL& new
     ASSERT(m_loadState < Response, "Redirect after receiving response");
     ASSERT(newRequest && newRequest->status().is_success(), "Invalid redirect");
 
+    // Redirects are archived as responses of their own, the next hop is
+    // timed from here.
+    beginArchiveEntry(newRequest);
+    if (m_archiveEntry) {
+        WebRequestArchive::recording()->record(*m_archiveEntry);
+        m_archiveEntry.clear();
+        m_archiveRequestStart = WTF::currentTime();
+    }
+
     OwnPtr<WebResponse> webResponse(new WebResponse(newRequest));
     webResponse->setUrl(newUrl.spec());
     m_urlLoader->maybeCallOnMainThread(NewRunnableMethod(
@@ -457,9 +695,29 @@ void WebRequest::OnResponseStarted(net::URLRequest* request)
 
     m_loadState = Response;
     if (request && request->status().is_success()) {
+        // Make sure the last of the body has been reported before the response.
+        if (request->has_upload())
+            reportUploadProgress();
+
         OwnPtr<WebResponse> webResponse(new WebResponse(request));
+        if (m_loadTiming.isRecorded()) {
+            m_loadTiming.headersReceived = WTF::currentTime();
+            m_loadTiming.wasCached = request->was_cached();
+            webResponse->setLoadTiming(m_loadTiming);
+        }
         m_urlLoader->maybeCallOnMainThread(NewRunnableMethod(
                 m_urlLoader.get(), &WebUrlLoaderClient::didReceiveResponse, webResponse.release()));
+        beginArchiveEntry(request);
+
+        // Anything WebCore stored alongside a cached response (V8 preparse
+        // data for scripts) must arrive before the body.
+        net::IOBufferWithSize* metadata = request->response_info().metadata;
+        if (metadata && metadata->size()) {
+            // metadataCopy is deleted in WebUrlLoaderClient::didReceiveCachedMetadata
+            OwnPtr<std::vector<char> > metadataCopy(new std::vector<char>(metadata->data(), metadata->data() + metadata->size()));
+            m_urlLoader->maybeCallOnMainThread(NewRunnableMethod(
+                    m_urlLoader.get(), &WebUrlLoaderClient::didReceiveCachedMetadata, metadataCopy.release()));
+        }
 
         // Start reading the response
         startReading();
@@ -486,6 +744,11 @@ void WebRequest::followDeferredRedirect()
 {
     ASSERT(m_loadState < Response, "Redirect after receiving response");
 
+    if (m_replayEntry) {
+        m_replayUrl = m_replayRedirectUrl;
+        return replayFromArchive();
+    }
+
     m_request->FollowDeferredRedirect();
 }
 
@@ -524,6 +787,9 @@ void WebRequest::startReading()
         return;
     }
 
+    if (m_replayEntry)
+        return replayNextChunk();
+
     int bytesRead = 0;
 
     if (!read(&bytesRead)) {
@@ -537,12 +803,20 @@ void WebRequest::startReading()
         return finish(true);
 
     m_loadState = GotData;
+    recordFirstByte();
+    appendToArchiveEntry(bytesRead);
     // Read ok, forward buffer to webcore
-    m_urlLoader->maybeCallOnMainThread(NewRunnableMethod(m_urlLoader.get(), &WebUrlLoaderClient::didReceiveData, m_networkBuffer, bytesRead));
+    m_urlLoader->maybeCallOnMainThreadWithData(m_networkBuffer, bytesRead);
     m_networkBuffer = 0;
     MessageLoop::current()->PostTask(FROM_HERE, m_runnableFactory.NewRunnableMethod(&WebRequest::startReading));
 }
 
+void WebRequest::recordFirstByte()
+{
+    if (m_loadTiming.isRecorded() && !m_loadTiming.firstByte)
+        m_loadTiming.firstByte = WTF::currentTime();
+}
+
 bool WebRequest::read(int* bytesRead)
 {
     ASSERT(m_loadState == Response || m_loadState == GotData, "read in state other than RESPONSE and GOTDATA");
@@ -568,8 +842,9 @@ void WebRequest::OnReadCompleted(net::URLRequest* request, int bytesRead)
 
     if (request->status().is_success()) {
         m_loadState = GotData;
-        m_urlLoader->maybeCallOnMainThread(NewRunnableMethod(
-                m_urlLoader.get(), &WebUrlLoaderClient::didReceiveData, m_networkBuffer, bytesRead));
+        recordFirstByte();
+        appendToArchiveEntry(bytesRead);
+        m_urlLoader->maybeCallOnMainThreadWithData(m_networkBuffer, bytesRead);
         m_networkBuffer = 0;
 
         // Get the rest of the data
@@ -626,4 +901,35 @@ ResourceType::Type WebRequest::convertWebkitTargetTypeToChromiumTargetType(WebCo
     }
 }
 
+// Subresources loaded through the memory cache carry the priority
+// CachedResourceLoader gave them, which is what ResourceLoadScheduler orders
+// them by too: render blocking stylesheets, then scripts and fonts, then
+// images, then prefetches. Everything else keeps Chromium's per type default.
+net::RequestPriority WebRequest::requestPriority(const WebResourceRequest& webResourceRequest)
+{
+    switch (webResourceRequest.target_type()) {
+    case WebCore::ResourceRequestBase::TargetIsStyleSheet:
+    case WebCore::ResourceRequestBase::TargetIsScript:
+    case WebCore::ResourceRequestBase::TargetIsFontResource:
+    case WebCore::ResourceRequestBase::TargetIsImage:
+    case WebCore::ResourceRequestBase::TargetIsPrefetch:
+        switch (webResourceRequest.priority()) {
+        case WebCore::ResourceLoadPriorityHigh:
+            return net::HIGHEST;
+        case WebCore::ResourceLoadPriorityMedium:
+            return net::MEDIUM;
+        case WebCore::ResourceLoadPriorityLow:
+            return net::LOW;
+        case WebCore::ResourceLoadPriorityVeryLow:
+            return net::IDLE;
+        default:
+            break;
+        }
+        break;
+    default:
+        break;
+    }
+    return net::DetermineRequestPriority(convertWebkitTargetTypeToChromiumTargetType(webResourceRequest.target_type()));
+}
+
 } // namespace android
@@ -29,6 +29,8 @@
 
 #include "ChromiumIncludes.h"
 #include "ResourceRequestBase.h"
+#include "WebLoadTiming.h"
+#include "WebRequestArchive.h"
 #include <wtf/Vector.h>
 
 class MessageLoop;
@@ -104,8 +106,18 @@ private:
     void handleInterceptedURL();
     void finish(bool success);
     void updateLoadFlags(int& loadFlags);
+    void maybeRevalidateInBackground();
+    void recordFirstByte();
+    void beginArchiveEntry(net::URLRequest*);
+    void appendToArchiveEntry(int bytesRead);
+    void replayFromArchive();
+    void replayResponse();
+    void replayNextChunk();
+    void pollUploadProgress();
+    void reportUploadProgress();
 
     ResourceType::Type convertWebkitTargetTypeToChromiumTargetType(WebCore::ResourceRequestBase::TargetType webkitType);
+    net::RequestPriority requestPriority(const WebResourceRequest&);
 
     scoped_refptr<WebUrlLoaderClient> m_urlLoader;
     OwnPtr<net::URLRequest> m_request;
@@ -117,6 +129,22 @@ private:
     LoadState m_loadState;
     int m_authRequestCount;
     int m_cacheMode;
+    // Set from WebRequestContext::staleWhileRevalidate() for the request URL.
+    bool m_staleWhileRevalidate;
+    // Milestones are only taken when WebCore asked for load timing.
+    bool m_reportLoadTiming;
+    WebLoadTiming m_loadTiming;
+    // Bytes of the request body last reported to WebCore.
+    uint64 m_uploadPosition;
+    // The response being written to the WebRequestArchive when recording.
+    OwnPtr<WebRequestArchive::Entry> m_archiveEntry;
+    double m_archiveRequestStart;
+    // When replaying, the archived response being delivered for m_replayUrl,
+    // or 0 if the archive does not have one.
+    const WebRequestArchive::Entry* m_replayEntry;
+    std::string m_replayUrl;
+    std::string m_replayRedirectUrl;
+    size_t m_replayOffset;
     ScopedRunnableMethodFactory<WebRequest> m_runnableFactory;
     bool m_wantToPause;
     bool m_isPaused;
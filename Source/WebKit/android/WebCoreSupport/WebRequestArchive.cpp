@@ -0,0 +1,188 @@
+/*
+ * Copyright 2012, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "WebRequestArchive.h"
+
+#include <algorithm>
+#include <cutils/log.h>
+#include <cutils/properties.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace android {
+
+namespace {
+    const char kArchiveMagic[] = "WebRequestArchive1";
+
+    std::string entryKey(const std::string& method, const std::string& url)
+    {
+        return method + ' ' + url;
+    }
+
+    // Every field is stored as a 32 bit length in host byte order followed
+    // by that many bytes. Archives are only meant to be replayed on the
+    // kind of device they were recorded on.
+    bool readString(FILE* file, std::string* string)
+    {
+        uint32_t length;
+        if (fread(&length, sizeof(length), 1, file) != 1)
+            return false;
+        string->resize(length);
+        return !length || fread(&(*string)[0], 1, length, file) == length;
+    }
+
+    void writeString(FILE* file, const std::string& string)
+    {
+        uint32_t length = string.size();
+        fwrite(&length, sizeof(length), 1, file);
+        fwrite(string.data(), 1, length, file);
+    }
+
+    int intProperty(const char* name)
+    {
+        char value[PROPERTY_VALUE_MAX];
+        if (property_get(name, value, 0) <= 0)
+            return -1;
+        return atoi(value);
+    }
+}
+
+WebRequestArchive::WebRequestArchive(const char* path, bool replay)
+    : m_recordFile(0)
+    , m_replay(replay)
+    , m_latencyMs(intProperty("net.webkit.archive.latency"))
+    , m_bandwidthKbps(std::max(intProperty("net.webkit.archive.bandwidth"), 0))
+{
+    if (replay) {
+        load(path);
+        return;
+    }
+
+    m_recordFile = fopen(path, "ab");
+    if (!m_recordFile) {
+        android_printLog(ANDROID_LOG_ERROR, "WebRequestArchive", "Cannot record to %s", path);
+        return;
+    }
+    fseek(m_recordFile, 0, SEEK_END);
+    if (!ftell(m_recordFile))
+        writeString(m_recordFile, kArchiveMagic);
+}
+
+WebRequestArchive* WebRequestArchive::instance()
+{
+    static bool isInitialized = false;
+    static WebRequestArchive* archive = 0;
+    if (!isInitialized) {
+        isInitialized = true;
+        char path[PROPERTY_VALUE_MAX];
+        if (property_get("net.webkit.archive.replay", path, 0) > 0)
+            archive = new WebRequestArchive(path, true);
+        else if (property_get("net.webkit.archive.record", path, 0) > 0)
+            archive = new WebRequestArchive(path, false);
+    }
+    return archive;
+}
+
+WebRequestArchive* WebRequestArchive::recording()
+{
+    WebRequestArchive* archive = instance();
+    return archive && archive->m_recordFile ? archive : 0;
+}
+
+WebRequestArchive* WebRequestArchive::replaying()
+{
+    WebRequestArchive* archive = instance();
+    return archive && archive->m_replay ? archive : 0;
+}
+
+void WebRequestArchive::load(const char* path)
+{
+    FILE* file = fopen(path, "rb");
+    std::string magic;
+    if (!file || !readString(file, &magic) || magic != kArchiveMagic) {
+        android_printLog(ANDROID_LOG_ERROR, "WebRequestArchive", "Cannot replay %s, every request will fail", path);
+        if (file)
+            fclose(file);
+        return;
+    }
+
+    while (true) {
+        Entry* entry = new Entry;
+        std::string timeToFirstByte;
+        if (!readString(file, &entry->method) || !readString(file, &entry->url)
+            || !readString(file, &entry->rawHeaders) || !readString(file, &entry->body)
+            || !readString(file, &timeToFirstByte)) {
+            delete entry;
+            break;
+        }
+        entry->timeToFirstByteMs = atoi(timeToFirstByte.c_str());
+
+        // A url recorded more than once replays its latest response.
+        Entry*& slot = m_entries[entryKey(entry->method, entry->url)];
+        delete slot;
+        slot = entry;
+    }
+    fclose(file);
+    android_printLog(ANDROID_LOG_INFO, "WebRequestArchive", "Replaying %d responses from %s", static_cast<int>(m_entries.size()), path);
+}
+
+void WebRequestArchive::record(const Entry& entry)
+{
+    if (!m_recordFile)
+        return;
+    char timeToFirstByte[16];
+    snprintf(timeToFirstByte, sizeof(timeToFirstByte), "%d", entry.timeToFirstByteMs);
+
+    writeString(m_recordFile, entry.method);
+    writeString(m_recordFile, entry.url);
+    writeString(m_recordFile, entry.rawHeaders);
+    writeString(m_recordFile, entry.body);
+    writeString(m_recordFile, timeToFirstByte);
+    // The process is usually killed rather than shut down once recording
+    // is over.
+    fflush(m_recordFile);
+}
+
+const WebRequestArchive::Entry* WebRequestArchive::find(const std::string& method, const std::string& url) const
+{
+    EntryMap::const_iterator it = m_entries.find(entryKey(method, url));
+    return it == m_entries.end() ? 0 : it->second;
+}
+
+int WebRequestArchive::responseDelayMs(const Entry& entry) const
+{
+    return m_latencyMs >= 0 ? m_latencyMs : entry.timeToFirstByteMs;
+}
+
+int WebRequestArchive::chunkDelayMs(int bytes) const
+{
+    if (!m_bandwidthKbps)
+        return 0;
+    return static_cast<int>(static_cast<long long>(bytes) * 8 / m_bandwidthKbps);
+}
+
+} // namespace android
@@ -0,0 +1,87 @@
+/*
+ * Copyright 2012, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef WebRequestArchive_h
+#define WebRequestArchive_h
+
+#include <stdio.h>
+#include <map>
+#include <string>
+
+namespace android {
+
+// Records the HTTP responses WebRequest receives to an archive file, or
+// answers requests from such a file without touching the network, so that
+// page load benchmarks can be rerun against the same bytes across builds.
+// Selected with system properties:
+//   net.webkit.archive.record <file>      append every completed response
+//   net.webkit.archive.replay <file>      serve http(s) requests from <file>
+//   net.webkit.archive.latency <ms>       replace the recorded time to first byte
+//   net.webkit.archive.bandwidth <kbit/s> pace the bodies of replayed responses
+// Must only be used on the network thread.
+class WebRequestArchive {
+public:
+    struct Entry {
+        Entry() : timeToFirstByteMs(0) {}
+
+        std::string method;
+        std::string url;
+        // As returned by net::HttpResponseHeaders::raw_headers().
+        std::string rawHeaders;
+        // The decoded body, as WebCore saw it.
+        std::string body;
+        int timeToFirstByteMs;
+    };
+
+    // Return 0 unless recording, respectively replaying, is configured.
+    static WebRequestArchive* recording();
+    static WebRequestArchive* replaying();
+
+    void record(const Entry&);
+    const Entry* find(const std::string& method, const std::string& url) const;
+
+    // Delay before the response headers of a replayed entry are delivered.
+    int responseDelayMs(const Entry&) const;
+    // Delay after delivering a replayed body chunk of the given size.
+    int chunkDelayMs(int bytes) const;
+
+private:
+    WebRequestArchive(const char* path, bool replay);
+    static WebRequestArchive* instance();
+    void load(const char* path);
+
+    typedef std::map<std::string, Entry*> EntryMap;
+    EntryMap m_entries;
+    FILE* m_recordFile;
+    bool m_replay;
+    // Negative when the recorded time to first byte is used.
+    int m_latencyMs;
+    // 0 when bandwidth is not limited.
+    int m_bandwidthKbps;
+};
+
+} // namespace android
+
+#endif
@@ -92,6 +92,23 @@ void WebRequestContext::setUserAgent(const String& string)
     m_userAgent = string.utf8().data();
 }
 
+void WebRequestContext::setStaleWhileRevalidate(const GURL& origin, bool enabled)
+{
+    MutexLocker lock(m_staleWhileRevalidateMutex);
+    if (enabled)
+        m_staleWhileRevalidateOrigins.insert(origin.GetOrigin().spec());
+    else
+        m_staleWhileRevalidateOrigins.erase(origin.GetOrigin().spec());
+}
+
+bool WebRequestContext::staleWhileRevalidate(const GURL& url) const
+{
+    MutexLocker lock(m_staleWhileRevalidateMutex);
+    if (m_staleWhileRevalidateOrigins.empty())
+        return false;
+    return m_staleWhileRevalidateOrigins.count(url.GetOrigin().spec());
+}
+
 void WebRequestContext::setCacheMode(int mode)
 {
     m_cacheMode = mode;
@@ -31,6 +31,9 @@
 
 #include <wtf/ThreadingPrimitives.h>
 
+#include <set>
+#include <string>
+
 namespace android {
 
 // This class is generally not threadsafe.
@@ -46,6 +49,12 @@ public:
     void setUserAgent(const WTF::String&);
     void setCacheMode(int);
     int getCacheMode();
+    bool isPrivateBrowsing() const { return m_isPrivateBrowsing; }
+    // Requests to an origin with stale-while-revalidate enabled are answered
+    // from the cache without waiting for validation. A stale copy is then
+    // revalidated in the background for the next load.
+    void setStaleWhileRevalidate(const GURL& origin, bool enabled);
+    bool staleWhileRevalidate(const GURL&) const;
     static void setAcceptLanguage(const WTF::String&);
     static const WTF::String& acceptLanguage();
 
@@ -57,6 +66,8 @@ private:
     int m_cacheMode;
     mutable WTF::Mutex m_userAgentMutex;
     bool m_isPrivateBrowsing;
+    std::set<std::string> m_staleWhileRevalidateOrigins;
+    mutable WTF::Mutex m_staleWhileRevalidateMutex;
 };
 
 } // namespace android
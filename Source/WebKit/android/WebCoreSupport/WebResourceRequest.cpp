@@ -115,6 +115,8 @@ WebResourceRequest::WebResourceRequest(const WebCore::ResourceRequest& resourceR
 
     m_url = resourceRequest.url().string().utf8().data();
     m_type = resourceRequest.targetType();
+    m_priority = resourceRequest.priority();
+    m_reportLoadTiming = resourceRequest.reportLoadTiming();
 }
 
 } // namespace android
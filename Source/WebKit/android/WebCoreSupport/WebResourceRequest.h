@@ -78,6 +78,21 @@ public:
         return m_type;
     }
 
+    WebCore::ResourceLoadPriority priority() const
+    {
+        return m_priority;
+    }
+
+    bool reportLoadTiming() const
+    {
+        return m_reportLoadTiming;
+    }
+
+    void setReportLoadTiming(bool reportLoadTiming)
+    {
+        m_reportLoadTiming = reportLoadTiming;
+    }
+
 private:
     std::string m_method;
     std::string m_referrer;
@@ -86,6 +101,8 @@ private:
     std::string m_url;
     int m_loadFlags;
     WebCore::ResourceRequestBase::TargetType m_type;
+    WebCore::ResourceLoadPriority m_priority;
+    bool m_reportLoadTiming;
 };
 
 } // namespace android
@@ -39,6 +39,8 @@ namespace android {
 
 WebResponse::WebResponse(net::URLRequest* request)
     : m_httpStatusCode(0)
+    , m_responseTime(0)
+    , m_wasFetchedViaSpdy(false)
 {
     // The misleadingly-named os_error() is actually a net::Error enum constant.
     m_error = net::Error(request->status().os_error());
@@ -51,11 +53,29 @@ WebResponse::WebResponse(net::URLRequest* request)
     m_expectedSize = request->GetExpectedContentSize();
 
     m_sslInfo = request->ssl_info();
+    m_responseTime = request->response_info().response_time.ToDoubleT();
+    m_wasFetchedViaSpdy = request->response_info().was_fetched_via_spdy;
 
     net::HttpResponseHeaders* responseHeaders = request->response_headers();
-    if (!responseHeaders)
-        return;
+    if (responseHeaders)
+        setHeaders(responseHeaders);
+}
 
+WebResponse::WebResponse(const string& url, net::HttpResponseHeaders* responseHeaders, long long expectedSize)
+    : m_error(net::OK)
+    , m_httpStatusCode(0)
+    , m_expectedSize(expectedSize)
+    , m_url(url)
+    , m_responseTime(0)
+    , m_wasFetchedViaSpdy(false)
+{
+    m_host = GURL(url).HostNoBrackets();
+    responseHeaders->GetMimeTypeAndCharset(&m_mime, &m_encoding);
+    setHeaders(responseHeaders);
+}
+
+void WebResponse::setHeaders(net::HttpResponseHeaders* responseHeaders)
+{
     m_httpStatusCode = responseHeaders->response_code();
     m_httpStatusText = responseHeaders->GetStatusText();
 
@@ -73,6 +93,8 @@ WebResponse::WebResponse(const string &url, const string &mimeType, long long ex
     , m_expectedSize(expectedSize)
     , m_mime(mimeType)
     , m_url(url)
+    , m_responseTime(0)
+    , m_wasFetchedViaSpdy(false)
 {
 }
 
@@ -81,6 +103,18 @@ WebCore::ResourceResponse WebResponse::createResourceResponse()
     WebCore::ResourceResponse resourceResponse(createKurl(), getMimeType().c_str(), m_expectedSize, m_encoding.c_str(), "");
     resourceResponse.setHTTPStatusCode(m_httpStatusCode);
     resourceResponse.setHTTPStatusText(m_httpStatusText.c_str());
+    resourceResponse.setResponseTime(m_responseTime);
+    resourceResponse.setWasFetchedViaSPDY(m_wasFetchedViaSpdy);
+
+    if (m_loadTiming.isRecorded()) {
+        // The network stack does not report the individual socket phases,
+        // so DNS, connect and SSL stay unknown and the whole wait for the
+        // headers is accounted to receiveHeadersEnd.
+        RefPtr<WebCore::ResourceLoadTiming> timing = WebCore::ResourceLoadTiming::create();
+        timing->requestTime = m_loadTiming.requestStart;
+        timing->receiveHeadersEnd = static_cast<int>((m_loadTiming.headersReceived - m_loadTiming.requestStart) * 1000);
+        resourceResponse.setResourceLoadTiming(timing.release());
+    }
 
     map<string, string>::const_iterator it;
     for (it = m_headerFields.begin(); it != m_headerFields.end(); ++it)
@@ -28,6 +28,7 @@
 
 #include "ChromiumIncludes.h"
 #include "KURL.h"
+#include "WebLoadTiming.h"
 #include "WebViewClientError.h"
 
 #include <map>
@@ -43,9 +44,12 @@ namespace android {
 class WebResponse {
 
 public:
-    WebResponse() {}
+    WebResponse() : m_responseTime(0), m_wasFetchedViaSpdy(false) {}
     WebResponse(net::URLRequest*);
     WebResponse(const std::string &url, const std::string &mimeType, long long expectedSize, const std::string &encoding, int httpStatusCode);
+    // For responses that did not come from a URLRequest, such as ones
+    // replayed from a WebRequestArchive.
+    WebResponse(const std::string& url, net::HttpResponseHeaders*, long long expectedSize);
 
     const std::string& getUrl() const;
     void setUrl(const std::string&);
@@ -56,6 +60,9 @@ public:
 
     const net::SSLInfo& getSslInfo() const { return m_sslInfo; }
 
+    const WebLoadTiming& loadTiming() const { return m_loadTiming; }
+    void setLoadTiming(const WebLoadTiming& loadTiming) { m_loadTiming = loadTiming; }
+
     // The create() methods create WebCore objects. They must only be called on the WebKit thread.
     WebCore::KURL createKurl();
     WebCore::ResourceResponse createResourceResponse();
@@ -64,6 +71,8 @@ public:
     static const std::string resolveMimeType(const std::string& url, const std::string& old_mime);
 
 private:
+    void setHeaders(net::HttpResponseHeaders*);
+
     net::Error m_error;
     std::string m_encoding;
     int m_httpStatusCode;
@@ -73,6 +82,11 @@ private:
     std::string m_mime;
     std::string m_url;
     net::SSLInfo m_sslInfo;
+    // When the response was received from the network, even if it is now
+    // being served from the cache. Keys the entry's cached metadata.
+    double m_responseTime;
+    bool m_wasFetchedViaSpdy;
+    WebLoadTiming m_loadTiming;
 
     struct CaseInsensitiveLessThan {
         bool operator()(const std::string& lhs, const std::string& rhs) const {
@@ -29,14 +29,19 @@
 #include "WebUrlLoaderClient.h"
 
 #include "ChromiumIncludes.h"
+#include "Frame.h"
+#include "NetworkPredictor.h"
 #include "OwnPtr.h"
+#include "Page.h"
 #include "ResourceHandle.h"
 #include "ResourceHandleClient.h"
 #include "ResourceResponse.h"
 #include "WebCoreFrameBridge.h"
 #include "WebRequest.h"
 #include "WebResourceRequest.h"
+#include "WebViewCore.h"
 
+#include <wtf/CurrentTime.h>
 #include <wtf/text/CString.h>
 
 using base::Lock;
@@ -44,6 +49,13 @@ using base::AutoLock;
 
 namespace android {
 
+// Queued data chunks are merged into a single didReceiveData() until they
+// reach this size.
+static const int kMaxCoalescedDataSize = 256 * 1024;
+// A drain hands the main thread back after this long (in seconds) and posts
+// itself again, so a fast connection can't starve input and layout.
+static const double kMaxDrainTime = 0.01;
+
 base::Thread* WebUrlLoaderClient::ioThread()
 {
     static base::Thread* networkThread = 0;
@@ -109,9 +121,14 @@ WebUrlLoaderClient::WebUrlLoaderClient(WebFrame* webFrame, WebCore::ResourceHand
     , m_cancelling(false)
     , m_sync(false)
     , m_finished(false)
+    , m_firstPartyHost(resourceRequest.firstPartyForCookies().host().utf8().data())
+    , m_responseDelivered(0)
+    , m_drainScheduled(false)
 {
     bool block = webFrame->blockNetworkLoads() && (resourceRequest.url().protocolIs("http") || resourceRequest.url().protocolIs("https"));
     WebResourceRequest webResourceRequest(resourceRequest, block);
+    if (!webResourceRequest.reportLoadTiming() && loadTimingObserver())
+        webResourceRequest.setReportLoadTiming(true);
     UrlInterceptResponse* intercept = webFrame->shouldInterceptRequest(resourceRequest.url().string());
     if (intercept) {
         m_request = new WebRequest(this, webResourceRequest, intercept);
@@ -177,6 +194,8 @@ bool WebUrlLoaderClient::start(bool isMainResource, bool isMainFrame, bool sync,
     m_isMainResource = isMainResource;
     m_isMainFrame = isMainFrame;
     m_sync = sync;
+    NetworkPredictor::instance()->willStartRequest(GURL(m_request->getUrl()), m_firstPartyHost,
+                                                   isMainResource && isMainFrame, context->isPrivateBrowsing());
     if (m_sync) {
         AutoLock autoLock(*syncLock());
         m_request->setSync(sync);
@@ -335,14 +354,6 @@ void WebUrlLoaderClient::finish()
     m_request = 0;
 }
 
-namespace {
-// Trampoline to wrap a Chromium Task* in a WebKit-style static function + void*.
-static void RunTask(void* v) {
-    OwnPtr<Task> task(static_cast<Task*>(v));
-    task->Run();
-}
-}
-
 // This is called from the IO thread, and dispatches the callback to the main thread.
 void WebUrlLoaderClient::maybeCallOnMainThread(Task* task)
 {
@@ -352,10 +363,91 @@ void WebUrlLoaderClient::maybeCallOnMainThread(Task* task)
             syncCondition()->Broadcast();
         }
         m_queue.push_back(task);
-    } else {
-        // Let WebKit handle it.
-        callOnMainThread(RunTask, task);
+    } else
+        queueForMainThread(QueuedCallback(task));
+}
+
+// This is called from the IO thread, and dispatches the data to the main thread.
+void WebUrlLoaderClient::maybeCallOnMainThreadWithData(scoped_refptr<net::IOBuffer> buf, int size)
+{
+    if (m_sync)
+        maybeCallOnMainThread(NewRunnableMethod(this, &WebUrlLoaderClient::didReceiveData, buf, size));
+    else
+        queueForMainThread(QueuedCallback(buf, size));
+}
+
+void WebUrlLoaderClient::queueForMainThread(const QueuedCallback& callback)
+{
+    AutoLock autoLock(m_mainThreadQueueLock);
+    m_mainThreadQueue.push_back(callback);
+    if (m_drainScheduled)
+        return;
+    m_drainScheduled = true;
+    // Keep ourselves alive until the drain has run, the last queued task may
+    // hold the last reference.
+    AddRef();
+    callOnMainThread(drainMainThreadQueue, this);
+}
+
+void WebUrlLoaderClient::drainMainThreadQueue(void* v)
+{
+    WebUrlLoaderClient* client = static_cast<WebUrlLoaderClient*>(v);
+    client->runMainThreadQueue();
+    client->Release();
+}
+
+void WebUrlLoaderClient::runMainThreadQueue()
+{
+    std::deque<QueuedCallback> callbacks;
+    {
+        AutoLock autoLock(m_mainThreadQueueLock);
+        callbacks.swap(m_mainThreadQueue);
+    }
+
+    double deadline = WTF::currentTime() + kMaxDrainTime;
+    std::vector<char> coalesced;
+    while (!callbacks.empty()) {
+        QueuedCallback callback = callbacks.front();
+        callbacks.pop_front();
+        if (callback.task) {
+            OwnPtr<Task> task(callback.task);
+            task->Run();
+        } else if (callbacks.empty() || callbacks.front().task
+                || callback.size + callbacks.front().size > kMaxCoalescedDataSize) {
+            didReceiveData(callback.data, callback.size);
+        } else {
+            coalesced.clear();
+            coalesced.insert(coalesced.end(), callback.data->data(), callback.data->data() + callback.size);
+            while (!callbacks.empty() && !callbacks.front().task
+                    && static_cast<int>(coalesced.size()) + callbacks.front().size <= kMaxCoalescedDataSize) {
+                const QueuedCallback& next = callbacks.front();
+                coalesced.insert(coalesced.end(), next.data->data(), next.data->data() + next.size);
+                callbacks.pop_front();
+            }
+            deliverData(&coalesced[0], coalesced.size());
+        }
+        if (!callbacks.empty() && WTF::currentTime() > deadline)
+            break;
     }
+
+    AutoLock autoLock(m_mainThreadQueueLock);
+    if (callbacks.empty() && m_mainThreadQueue.empty()) {
+        m_drainScheduled = false;
+        return;
+    }
+    // Put back what we didn't get to ahead of anything queued meanwhile, and
+    // come back on the next turn.
+    m_mainThreadQueue.insert(m_mainThreadQueue.begin(), callbacks.begin(), callbacks.end());
+    AddRef();
+    callOnMainThread(drainMainThreadQueue, this);
+}
+
+void WebUrlLoaderClient::didSendData(uint64 bytesSent, uint64 totalBytesToBeSent)
+{
+    if (!isActive())
+        return;
+
+    m_resourceHandle->client()->didSendData(m_resourceHandle.get(), bytesSent, totalBytesToBeSent);
 }
 
 // Response methods
@@ -365,6 +457,8 @@ void WebUrlLoaderClient::didReceiveResponse(PassOwnPtr<WebResponse> webResponse)
         return;
 
     m_response = webResponse;
+    if (m_response->loadTiming().isRecorded())
+        m_responseDelivered = WTF::currentTime();
     m_resourceHandle->client()->didReceiveResponse(m_resourceHandle.get(), m_response->createResourceResponse());
 
     // Set the main page's certificate to WebView.
@@ -384,9 +478,14 @@ void WebUrlLoaderClient::didReceiveResponse(PassOwnPtr<WebResponse> webResponse)
 }
 
 void WebUrlLoaderClient::didReceiveData(scoped_refptr<net::IOBuffer> buf, int size)
+{
+    deliverData(buf->data(), size);
+}
+
+void WebUrlLoaderClient::deliverData(const char* data, int size)
 {
     if (m_isMainResource && m_isCertMimeType) {
-        m_webFrame->didReceiveData(buf->data(), size);
+        m_webFrame->didReceiveData(data, size);
     }
 
     if (!isActive() || !size)
@@ -394,7 +493,7 @@ void WebUrlLoaderClient::didReceiveData(scoped_refptr<net::IOBuffer> buf, int si
 
     // didReceiveData will take a copy of the data
     if (m_resourceHandle && m_resourceHandle->client())
-        m_resourceHandle->client()->didReceiveData(m_resourceHandle.get(), buf->data(), size, size);
+        m_resourceHandle->client()->didReceiveData(m_resourceHandle.get(), data, size, size);
 }
 
 // For data url's
@@ -417,6 +516,14 @@ void WebUrlLoaderClient::didReceiveAndroidFileData(PassOwnPtr<std::vector<char>
     m_resourceHandle->client()->didReceiveData(m_resourceHandle.get(), vector->begin(), vector->size(), vector->size());
 }
 
+void WebUrlLoaderClient::didReceiveCachedMetadata(PassOwnPtr<std::vector<char> > metadata)
+{
+    if (!isActive() || metadata->empty())
+        return;
+
+    m_resourceHandle->client()->didReceiveCachedMetadata(m_resourceHandle.get(), &metadata->front(), metadata->size());
+}
+
 void WebUrlLoaderClient::didFail(PassOwnPtr<WebResponse> webResponse)
 {
     if (isActive())
@@ -447,7 +554,7 @@ void WebUrlLoaderClient::willSendRequest(PassOwnPtr<WebResponse> webResponse)
     }
 }
 
-void WebUrlLoaderClient::didFinishLoading()
+void WebUrlLoaderClient::didFinishLoading(WebLoadTiming loadTiming)
 {
     if (isActive())
         m_resourceHandle->client()->didFinishLoading(m_resourceHandle.get(), 0);
@@ -456,10 +563,27 @@ void WebUrlLoaderClient::didFinishLoading()
         m_webFrame->didFinishLoading();
     }
 
+    if (loadTiming.isRecorded()) {
+        if (LoadTimingObserver* observer = loadTimingObserver()) {
+            loadTiming.responseDelivered = m_responseDelivered;
+            loadTiming.finishDelivered = WTF::currentTime();
+            observer->didFinishLoad(m_request->getUrl(), loadTiming);
+        }
+    }
+
     // Always finish a request, if not it will leak
     finish();
 }
 
+LoadTimingObserver* WebUrlLoaderClient::loadTimingObserver() const
+{
+    WebCore::Page* page = m_webFrame->page();
+    if (!page)
+        return 0;
+    WebViewCore* webViewCore = WebViewCore::getWebViewCore(page->mainFrame()->view());
+    return webViewCore ? webViewCore->loadTimingObserver() : 0;
+}
+
 void WebUrlLoaderClient::authRequired(scoped_refptr<net::AuthChallengeInfo> authChallengeInfo, bool firstTime, bool suppressDialog)
 {
     if (!isActive())
@@ -50,6 +50,7 @@ class AuthChallengeInfo;
 
 namespace android {
 
+class LoadTimingObserver;
 class WebFrame;
 class WebRequest;
 class WebRequestContext;
@@ -80,13 +81,18 @@ public:
     // This is called from the IO thread, and dispatches the callback to the main thread.
     // (For asynchronous calls, we just delegate to WebKit's callOnMainThread.)
     void maybeCallOnMainThread(Task* task);
+    // Also called from the IO thread. Consecutive chunks that are still queued
+    // when the main thread gets to them are handed to WebCore as one.
+    void maybeCallOnMainThreadWithData(scoped_refptr<net::IOBuffer>, int size);
 
     // Called by WebRequest (using maybeCallOnMainThread), should be forwarded to WebCore.
+    void didSendData(uint64 bytesSent, uint64 totalBytesToBeSent);
     void didReceiveResponse(PassOwnPtr<WebResponse>);
     void didReceiveData(scoped_refptr<net::IOBuffer>, int size);
     void didReceiveDataUrl(PassOwnPtr<std::string>);
     void didReceiveAndroidFileData(PassOwnPtr<std::vector<char> >);
-    void didFinishLoading();
+    void didReceiveCachedMetadata(PassOwnPtr<std::vector<char> >);
+    void didFinishLoading(WebLoadTiming);
     void didFail(PassOwnPtr<WebResponse>);
     void willSendRequest(PassOwnPtr<WebResponse>);
     void authRequired(scoped_refptr<net::AuthChallengeInfo>, bool firstTime, bool suppressDialog);
@@ -104,6 +110,22 @@ private:
 
     void finish();
 
+    // Callbacks queued for the main thread when the load is asynchronous. A
+    // null task means the entry carries a chunk of response data.
+    struct QueuedCallback {
+        QueuedCallback(Task* t) : task(t), size(0) { }
+        QueuedCallback(scoped_refptr<net::IOBuffer> buf, int s) : task(0), data(buf), size(s) { }
+        Task* task;
+        scoped_refptr<net::IOBuffer> data;
+        int size;
+    };
+
+    void queueForMainThread(const QueuedCallback&);
+    static void drainMainThreadQueue(void*);
+    void runMainThreadQueue();
+    void deliverData(const char* data, int size);
+    LoadTimingObserver* loadTimingObserver() const;
+
     WebFrame* m_webFrame;
     RefPtr<WebCore::ResourceHandle> m_resourceHandle;
     bool m_isMainResource;
@@ -112,9 +134,13 @@ private:
     bool m_cancelling;
     bool m_sync;
     volatile bool m_finished;
+    // Host of the main document, for NetworkPredictor.
+    std::string m_firstPartyHost;
 
     scoped_refptr<WebRequest> m_request;
     OwnPtr<WebResponse> m_response; // NULL until didReceiveResponse is called.
+    // When WebCore got the response, if the load is being timed.
+    double m_responseDelivered;
 
     // Check if a request is active
     bool isActive() const;
@@ -126,6 +152,12 @@ private:
 
     // Queue of callbacks to be executed by the main thread. Must only be accessed inside mutex.
     std::deque<Task*> m_queue;
+
+    // Asynchronous loads: at most one drain task is posted to the main thread
+    // at a time, and it runs everything queued up to that point.
+    base::Lock m_mainThreadQueueLock;
+    std::deque<QueuedCallback> m_mainThreadQueue;
+    bool m_drainScheduled;
 };
 
 } // namespace android
@@ -46,6 +46,7 @@
 #include "FormAssociatedElement.h"
 #include "QualifiedName.h"
 #include "StringUtils.h"
+#include <wtf/HashFunctions.h>
 
 // TODO: This file is taken from chromium/chrome/renderer/form_manager.cc and
 // customised to use WebCore types rather than WebKit API types. It would be
@@ -346,6 +347,11 @@ const string16 GetFormIdentifier(const HTMLFormElement& form) {
     return identifier;
 }
 
+// Mixes |pointer| into the running form structure |signature|.
+unsigned CombineHash(unsigned signature, const void* pointer) {
+    return WTF::intHash((static_cast<uint64_t>(signature) << 32) | WTF::PtrHash<const void*>::hash(pointer));
+}
+
 }  // namespace
 
 namespace android {
@@ -354,6 +360,9 @@ struct FormManager::FormElement {
     RefPtr<HTMLFormElement> form_element;
     std::vector<RefPtr<HTMLFormControlElement> > control_elements;
     std::vector<string16> control_values;
+    // Filled the first time the form is extracted with labels, and dropped
+    // with the rest of the cache when the form structure changes.
+    LabelMap labels;
 };
 
 FormManager::FormManager() {
@@ -445,7 +454,7 @@ string16 FormManager::LabelForElement(const HTMLFormControlElement& element) {
 }
 
 // static
-bool FormManager::HTMLFormElementToFormData(HTMLFormElement* element, RequirementsMask requirements, ExtractMask extract_mask, FormData* form) {
+bool FormManager::HTMLFormElementToFormData(HTMLFormElement* element, RequirementsMask requirements, ExtractMask extract_mask, FormData* form, LabelMap* labels) {
     DCHECK(form);
 
     Frame* frame = element->document()->frame();
@@ -511,6 +520,25 @@ bool FormManager::HTMLFormElementToFormData(HTMLFormElement* element, Requiremen
     if (form_fields.empty())
         return false;
 
+    // Reuse the labels scraped the last time this form was extracted.
+    if (labels && !labels->empty()) {
+        for (size_t i = 0, field_idx = 0; i < control_elements.size() && field_idx < form_fields.size(); ++i) {
+            if (!fields_extracted[i])
+                continue;
+
+            LabelMap::const_iterator iter = labels->find(static_cast<HTMLFormControlElement*>(control_elements[i]));
+            if (iter != labels->end())
+                form_fields[field_idx]->label = iter->second;
+            else
+                form_fields[field_idx]->label = InferLabelForElement(*static_cast<HTMLFormControlElement*>(control_elements[i]));
+            ++field_idx;
+        }
+
+        for (ScopedVector<FormField>::const_iterator iter = form_fields.begin(); iter != form_fields.end(); ++iter)
+            form->fields.push_back(**iter);
+        return true;
+    }
+
     // Loop through the label elements inside the form element.  For each label
     // element, get the corresponding form control element, use the form control
     // element's name as a key into the <name, FormField> map to find the
@@ -547,6 +575,8 @@ bool FormManager::HTMLFormElementToFormData(HTMLFormElement* element, Requiremen
         const HTMLFormControlElement* control_element = static_cast<HTMLFormControlElement*>(control_elements[i]);
         if (form_fields[field_idx]->label.empty())
             form_fields[field_idx]->label = InferLabelForElement(*control_element);
+        if (labels)
+            (*labels)[control_element] = form_fields[field_idx]->label;
 
         ++field_idx;
 
@@ -616,7 +646,7 @@ void FormManager::GetFormsInFrame(const Frame* frame, RequirementsMask requireme
             continue;
 
         FormData form;
-        HTMLFormElementToFormData(form_element->form_element.get(), requirements, EXTRACT_VALUE, &form);
+        HTMLFormElementToFormData(form_element->form_element.get(), requirements, EXTRACT_VALUE, &form, &form_element->labels);
 
         num_fields_seen += form.fields.size();
         if (num_fields_seen > kMaxParseableFields)
@@ -634,8 +664,8 @@ bool FormManager::FindFormWithFormControlElement(HTMLFormControlElement* element
     if (!frame)
         return false;
 
-    for (FormElementList::const_iterator iter = form_elements_.begin(); iter != form_elements_.end(); ++iter) {
-        const FormElement* form_element = *iter;
+    for (FormElementList::iterator iter = form_elements_.begin(); iter != form_elements_.end(); ++iter) {
+        FormElement* form_element = *iter;
 
         if (form_element->form_element->document()->frame() != frame)
             continue;
@@ -644,7 +674,7 @@ bool FormManager::FindFormWithFormControlElement(HTMLFormControlElement* element
             HTMLFormControlElement* candidate = iter->get();
             if (nameForAutofill(*candidate) == nameForAutofill(*element)) {
                 ExtractMask extract_mask = static_cast<ExtractMask>(EXTRACT_VALUE | EXTRACT_OPTIONS);
-                return HTMLFormElementToFormData(form_element->form_element.get(), requirements, extract_mask, form);
+                return HTMLFormElementToFormData(form_element->form_element.get(), requirements, extract_mask, form, &form_element->labels);
             }
         }
     }
@@ -787,6 +817,41 @@ bool FormManager::FormWithNodeIsAutofilled(Node* node) {
     return false;
 }
 
+bool FormManager::CachedLabelForElement(const HTMLFormControlElement* element, string16* label) const {
+    for (FormElementList::const_iterator iter = form_elements_.begin(); iter != form_elements_.end(); ++iter) {
+        LabelMap::const_iterator label_iter = (*iter)->labels.find(element);
+        if (label_iter != (*iter)->labels.end()) {
+            *label = label_iter->second;
+            return true;
+        }
+    }
+    return false;
+}
+
+// static
+unsigned FormManager::FormStructureSignature(const Frame* frame) {
+    unsigned signature = 0;
+    RefPtr<HTMLCollection> forms = frame->document()->forms();
+    for (unsigned i = 0; i < forms->length(); ++i) {
+        HTMLFormElement* form = static_cast<HTMLFormElement*>(forms->item(i));
+        signature = CombineHash(signature, form);
+
+        const WTF::Vector<FormAssociatedElement*>& control_elements = form->associatedElements();
+        for (size_t j = 0; j < control_elements.size(); ++j) {
+            if (!control_elements[j]->isFormControlElement())
+                continue;
+
+            HTMLFormControlElement* element = static_cast<HTMLFormControlElement*>(control_elements[j]);
+            signature = CombineHash(signature, element);
+            // Names and types are atomic, so comparing their impls is enough.
+            signature = CombineHash(signature, element->formControlName().impl());
+            signature = CombineHash(signature, element->getIdAttribute().impl());
+            signature = CombineHash(signature, element->formControlType().impl());
+        }
+    }
+    return signature ? signature : 1;
+}
+
 bool FormManager::FindCachedFormElementWithNode(Node* node, FormElement** form_element) {
     for (FormElementList::const_iterator form_iter = form_elements_.begin(); form_iter != form_elements_.end(); ++form_iter) {
         for (std::vector<RefPtr<HTMLFormControlElement> >::const_iterator iter = (*form_iter)->control_elements.begin(); iter != (*form_iter)->control_elements.end(); ++iter) {
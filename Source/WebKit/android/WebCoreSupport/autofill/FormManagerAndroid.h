@@ -74,6 +74,9 @@ public:
         EXTRACT_OPTIONS     = 1 << 2, // Extract options from HTMLFormControlElement.
     };
 
+    // Labels already scraped for the fields of a form, keyed by field.
+    typedef std::map<const HTMLFormControlElement*, string16> LabelMap;
+
     FormManager();
     virtual ~FormManager();
 
@@ -90,10 +93,18 @@ public:
     // is true, the fields in |form| will have the values filled out.  Returns
     // true if |form| is filled out; it's possible that |element| won't meet the
     // requirements in |requirements|.  This also returns false if there are no
-    // fields in |form|.
+    // fields in |form|.  If |labels| is non-empty the field labels are taken
+    // from it rather than scraped from the DOM; if it is empty it is filled
+    // with the labels that were scraped.
     // TODO: Remove the user of this in RenderView and move this to
     // private.
-    static bool HTMLFormElementToFormData(HTMLFormElement* element, RequirementsMask requirements, ExtractMask extract_mask, webkit_glue::FormData* form);
+    static bool HTMLFormElementToFormData(HTMLFormElement* element, RequirementsMask requirements, ExtractMask extract_mask, webkit_glue::FormData* form, LabelMap* labels = 0);
+
+    // Returns a hash of the forms in |frame|, their form control elements and
+    // the names and types of those elements.  It only changes when the
+    // structure of a form does, so unlike the DOM tree version it is not
+    // affected by mutations elsewhere in the document.  Never returns 0.
+    static unsigned FormStructureSignature(const Frame* frame);
 
     // Scans the DOM in |frame| extracting and storing forms.
     void ExtractForms(Frame* frame);
@@ -132,6 +143,10 @@ public:
     // Returns true if |form| has any auto-filled fields.
     bool FormWithNodeIsAutofilled(Node* node);
 
+    // Sets |label| to the label scraped for |element| when its form was last
+    // extracted.  Returns false if the label has not been scraped yet.
+    bool CachedLabelForElement(const HTMLFormControlElement* element, string16* label) const;
+
 private:
     // Stores the HTMLFormElement and the form control elements for a form.
     // Original form values are stored so when we clear a form we can reset
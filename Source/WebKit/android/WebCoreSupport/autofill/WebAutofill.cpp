@@ -51,7 +51,7 @@ namespace android
 WebAutofill::WebAutofill()
     : mQueryId(1)
     , mWebViewCore(0)
-    , mLastSearchDomVersion(0)
+    , mLastSearchFormSignature(0)
     , mParsingForms(false)
 {
     mTabContents = new TabContents();
@@ -147,25 +147,27 @@ void WebAutofill::formFieldFocused(WebCore::HTMLFormControlElement* formFieldEle
     if (frame != frame->page()->mainFrame())
         return;
 
-    unsigned domVersion = doc->domTreeVersion();
-    ASSERT(domVersion > 0);
+    unsigned formSignature = FormManager::FormStructureSignature(frame);
 
-    if (mLastSearchDomVersion != domVersion) {
-        // Need to extract forms as DOM version has changed since the last time
-        // we searched.
-        searchDocument(formFieldElement->document()->frame());
-        mLastSearchDomVersion = domVersion;
+    if (mLastSearchFormSignature != formSignature) {
+        // Need to extract forms as a form has changed since the last time we
+        // searched. Changes to the DOM outside of forms don't matter here.
+        searchDocument(frame);
+        mLastSearchFormSignature = formSignature;
     }
 
     ASSERT(mFormManager);
 
-    // Get the FormField from the Node.
-    webkit_glue::FormField* formField = new webkit_glue::FormField;
-    FormManager::HTMLFormControlElementToFormField(formFieldElement, FormManager::EXTRACT_NONE, formField);
-    formField->label = FormManager::LabelForElement(*formFieldElement);
-
     webkit_glue::FormData* form = new webkit_glue::FormData;
     mFormManager->FindFormWithFormControlElement(formFieldElement, FormManager::REQUIRE_AUTOCOMPLETE, form);
+
+    // Get the FormField from the Node. Finding the form has scraped the labels
+    // of its fields, so only fall back to searching the whole document for a
+    // label when the field is not part of a cached form.
+    webkit_glue::FormField* formField = new webkit_glue::FormField;
+    FormManager::HTMLFormControlElementToFormField(formFieldElement, FormManager::EXTRACT_NONE, formField);
+    if (!mFormManager->CachedLabelForElement(formFieldElement, &formField->label))
+        formField->label = FormManager::LabelForElement(*formFieldElement);
     mQueryMap[mQueryId] = new FormDataAndField(form, formField);
 
     bool suggestions = mAutofillManager->OnQueryFormFieldAutoFillWrapper(*form, *formField);
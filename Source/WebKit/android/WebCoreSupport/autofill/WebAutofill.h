@@ -86,7 +86,7 @@ public:
 
     bool updateProfileLabel();
 
-    void reset() { mLastSearchDomVersion = 0; }
+    void reset() { mLastSearchFormSignature = 0; }
 
 private:
     void init();
@@ -113,7 +113,7 @@ private:
 
     WebViewCore* mWebViewCore;
 
-    unsigned mLastSearchDomVersion;
+    unsigned mLastSearchFormSignature;
 
     WTF::Mutex mFormsSeenMutex; // Guards mFormsSeenCondition and mParsingForms.
     WTF::ThreadCondition mFormsSeenCondition;
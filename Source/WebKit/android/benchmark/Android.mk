@@ -39,3 +39,19 @@ LOCAL_MODULE := webcore_test
 LOCAL_MODULE_TAGS := optional
 
 include $(BUILD_EXECUTABLE)
+
+# Runs JavaScript suites such as SunSpider against the engine libwebcore was
+# built with.
+include $(CLEAR_VARS)
+
+LOCAL_SRC_FILES := \
+	script_main.cpp
+
+LOCAL_SHARED_LIBRARIES := libwebcore $(WEBKIT_SHARED_LIBRARIES)
+LOCAL_LDLIBS := $(WEBKIT_LDLIBS)
+
+LOCAL_MODULE := webcore_script_test
+
+LOCAL_MODULE_TAGS := optional
+
+include $(BUILD_EXECUTABLE)
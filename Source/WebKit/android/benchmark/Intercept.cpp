@@ -128,6 +128,10 @@ static String mimeTypeForExtension(const String& file)
         extensionToMime.set("gif", "image/gif");
         extensionToMime.set("ico", "image/x-icon");
         extensionToMime.set("js", "text/javascript");
+        extensionToMime.set("css", "text/css");
+        extensionToMime.set("svg", "image/svg+xml");
+        extensionToMime.set("xml", "text/xml");
+        extensionToMime.set("xhtml", "application/xhtml+xml");
     }
     int dot = file.reverseFind('.');
     String mime("text/plain");
@@ -172,7 +176,7 @@ PassRefPtr<WebCore::ResourceLoaderAndroid> MyWebFrame::startLoadingResource(
             MyResourceLoader::create(handle, req.url().string());
     m_requests.append(loader);
     if (!m_timer.isActive())
-        m_timer.startOneShot(0);
+        m_timer.startOneShot(m_latency);
     return loader.release();
 }
 
@@ -66,7 +66,12 @@ class MyWebFrame : public WebFrame {
 public:
     MyWebFrame(Page* page)
         : WebFrame(JSC::Bindings::getJNIEnv(), MY_JOBJECT, MY_JOBJECT, page)
-        , m_timer(this, &MyWebFrame::timerFired) {}
+        , m_timer(this, &MyWebFrame::timerFired)
+        , m_latency(0) {}
+
+    // Every batch of requests is answered after this fixed delay so that
+    // repeated runs see the same network timing.
+    void setNetworkLatency(double seconds) { m_latency = seconds; }
 
     virtual PassRefPtr<WebCore::ResourceLoaderAndroid> startLoadingResource(
             ResourceHandle* handle, const ResourceRequest& req, bool, bool);
@@ -77,6 +82,7 @@ private:
     void timerFired(Timer<MyWebFrame>*);
     Vector<RefPtr<WebCore::ResourceLoaderAndroid> > m_requests;
     Timer<MyWebFrame> m_timer;
+    double m_latency;
 };
 
 #endif
@@ -25,21 +25,49 @@
 
 #define LOG_TAG "webcore_test"
 
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <getopt.h>
 #include <utils/Log.h>
 
 namespace android {
-extern void benchmark(const char*, int, int ,int);
+extern void benchmark(const char**, int, int, int, int, int, int, FILE*, const char*);
+}
+
+static const int maxUrls = 256;
+
+// Reads one url per line from listFile, skipping blank lines and lines
+// starting with '#'.
+static int readUrlList(const char* listFile, char** urls, int urlCount) {
+    FILE* list = fopen(listFile, "r");
+    if (!list) {
+        LOGE("Could not open url list %s", listFile);
+        return urlCount;
+    }
+    char line[1024];
+    while (urlCount < maxUrls && fgets(line, sizeof(line), list)) {
+        line[strcspn(line, "\r\n")] = 0;
+        if (!line[0] || line[0] == '#')
+            continue;
+        urls[urlCount++] = strdup(line);
+    }
+    fclose(list);
+    return urlCount;
 }
 
 int main(int argc, char** argv) {
     int width = 800;
     int height = 600;
     int reloadCount = 0;
+    int scrollSteps = 10;
+    int latencyMS = 0;
+    const char* outFile = 0;
+    const char* traceFile = 0;
+    char* urls[maxUrls];
+    int urlCount = 0;
     while (true) {
-        int c = getopt(argc, argv, "d:r:");
+        int c = getopt(argc, argv, "d:r:f:s:l:o:t:");
         if (c == -1)
             break;
         else if (c == 'd') {
@@ -54,12 +82,40 @@ int main(int argc, char** argv) {
             if (reloadCount < 0)
                 reloadCount = 0;
             LOGD("Reloading %d times", reloadCount);
-        }
+        } else if (c == 'f') {
+            urlCount = readUrlList(optarg, urls, urlCount);
+        } else if (c == 's') {
+            scrollSteps = atoi(optarg);
+            if (scrollSteps < 0)
+                scrollSteps = 0;
+        } else if (c == 'l') {
+            latencyMS = atoi(optarg);
+            if (latencyMS < 0)
+                latencyMS = 0;
+            LOGD("Delaying each response by %dms", latencyMS);
+        } else if (c == 'o')
+            outFile = optarg;
+        else if (c == 't')
+            traceFile = optarg;
     }
-    if (optind >= argc) {
+    for (int i = optind; i < argc && urlCount < maxUrls; ++i)
+        urls[urlCount++] = argv[i];
+    if (!urlCount) {
         LOGE("Please supply a file to read\n");
         return 1;
     }
 
-    android::benchmark(argv[optind], reloadCount, width, height);
+    FILE* out = stdout;
+    if (outFile) {
+        out = fopen(outFile, "w");
+        if (!out) {
+            LOGE("Could not open %s for writing", outFile);
+            return 1;
+        }
+    }
+
+    android::benchmark(const_cast<const char**>(urls), urlCount, reloadCount, width, height, scrollSteps, latencyMS, out, traceFile);
+
+    if (out != stdout)
+        fclose(out);
 }
@@ -0,0 +1,86 @@
+/*
+ * Copyright 2012, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE COMPUTER, INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#define LOG_TAG "webcore_script_test"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <utils/Log.h>
+
+namespace android {
+extern void scriptBenchmark(const char**, int, const char**, int, int, const char*, FILE*);
+}
+
+static const int maxPreludes = 16;
+
+// Usage: webcore_script_test [-n iterations] [-p prelude.js]... [-j engine flags] [-o out.csv] test.js...
+// The suites under PerformanceTests/SunSpider/tests run as they are, e.g.
+//   webcore_script_test -n 5 /sdcard/sunspider-0.9.1/*.js
+//   webcore_script_test -j --nocrankshaft /sdcard/v8-v6/*.js
+// -p loads scripts every test depends on, such as a harness, before each test.
+int main(int argc, char** argv) {
+    int iterations = 1;
+    const char* preludes[maxPreludes];
+    int preludeCount = 0;
+    const char* engineFlags = 0;
+    const char* outFile = 0;
+    while (true) {
+        int c = getopt(argc, argv, "n:p:j:o:");
+        if (c == -1)
+            break;
+        else if (c == 'n') {
+            iterations = atoi(optarg);
+            if (iterations < 1)
+                iterations = 1;
+        } else if (c == 'p') {
+            if (preludeCount < maxPreludes)
+                preludes[preludeCount++] = optarg;
+        } else if (c == 'j')
+            engineFlags = optarg;
+        else if (c == 'o')
+            outFile = optarg;
+    }
+    if (optind >= argc) {
+        LOGE("Please supply a script to run\n");
+        return 1;
+    }
+
+    FILE* out = stdout;
+    if (outFile) {
+        out = fopen(outFile, "w");
+        if (!out) {
+            LOGE("Could not open %s for writing", outFile);
+            return 1;
+        }
+    }
+
+    android::scriptBenchmark(preludes, preludeCount, const_cast<const char**>(argv + optind), argc - optind,
+                             iterations, engineFlags, out);
+
+    if (out != stdout)
+        fclose(out);
+}
@@ -29,6 +29,7 @@
 #include "config.h"
 
 #include "MemoryCache.h"
+#include "BitmapAllocatorAndroid.h"
 #include "Connection.h"
 #include "CookieClient.h"
 #include "FileSystemClient.h"
@@ -407,6 +408,9 @@ void JavaBridge::SetCacheSize(JNIEnv* env, jobject obj, jint bytes)
         }
     }
     WebCore::memoryCache()->setCapacities(minDeadSize, maxDeadSize, bytes);
+    // The memory cache only drops its references to decoded images, the
+    // pixels themselves are kept within this budget.
+    WebCore::BitmapAllocatorAndroid::setCacheBudget(bytes / 4);
 }
 
 void JavaBridge::SetNetworkOnLine(JNIEnv* env, jobject obj, jboolean online)
@@ -42,6 +42,9 @@
 #define MIN_SPLITTABLE 400
 #define MAX_ADDITIONAL_AREA 0.65
 #define MAX_ADDITIONAL_PICTURES 32
+// Pictures to record are split along a grid of this size (a multiple of the
+// tile size), so a tile only replays the content recorded for its cells
+#define PICTURE_CELL_SIZE 512
 
 #define BUCKET_SIZE 1024
 #define MAX_BUCKET_COUNT_X 16
@@ -527,9 +530,15 @@ void PictureSet::add(const SkRegion& area, SkPicture* picture,
 
     // Then, let's see if we have to clear up the pictures in order to keep
     // the total number of pictures under our limit
+    // the bases don't count, as large bases are split into many cells
+    int additionalPictures = 0;
+    for (Pictures* working = first; working != last; working++) {
+        if (!working->mBase)
+            additionalPictures++;
+    }
     bool clearUp = false;
-    if (last - first > MAX_ADDITIONAL_PICTURES) {
-        XLOG("--- too many pictures, only keeping the bases : %d", last - first);
+    if (additionalPictures > MAX_ADDITIONAL_PICTURES) {
+        XLOG("--- too many pictures, only keeping the bases : %d", additionalPictures);
         clearUp = true;
     }
 
@@ -745,9 +754,12 @@ bool PictureSet::draw(SkCanvas* canvas)
         return false;
     SkIRect irect;
     bounds.roundOut(&irect);
+    // pictures still waiting to be recorded (see
+    // WebViewCore::rebuildPictureSet) draw nothing, whatever is underneath
+    // them shows through until they are
     for (working = last; working != first; ) {
         --working;
-        if (working->mArea.contains(irect)) {
+        if (working->mPicture && working->mArea.contains(irect)) {
 #if PICTURE_SET_DEBUG
             const SkIRect& b = working->mArea.getBounds();
             DBG_SET_LOGD("contains working->mArea={%d,%d,%d,%d}"
@@ -774,6 +786,8 @@ bool PictureSet::draw(SkCanvas* canvas)
             working->mElapsed = 0;
             continue;
         }
+        if (!working->mPicture)
+            continue;
         int saved = canvas->save();
         SkRect pathBounds;
         if (area.isComplex()) {
@@ -1166,6 +1180,55 @@ void PictureSet::split(PictureSet* out) const
     out->dump("split-out");
 }
 
+// Replaces each picture waiting to be recorded that spans more than one cell
+// of the PICTURE_CELL_SIZE grid by one picture per cell. WebCore only paints
+// what intersects the area being recorded, so every cell picture holds just
+// the drawing operations of its cell, and draw() rejects the cells outside
+// of the tile being painted -- instead of replaying the whole picture
+// under a clip for every tile.
+void PictureSet::splitIntoCells()
+{
+    bool needsSplit = false;
+    Pictures* last = mPictures.end();
+    for (Pictures* working = mPictures.begin(); working != last; working++) {
+        const SkIRect& bounds = working->mArea.getBounds();
+        if (!working->mPicture && working->mArea.isRect()
+                && (bounds.fLeft / PICTURE_CELL_SIZE != (bounds.fRight - 1) / PICTURE_CELL_SIZE
+                    || bounds.fTop / PICTURE_CELL_SIZE != (bounds.fBottom - 1) / PICTURE_CELL_SIZE)) {
+            needsSplit = true;
+            break;
+        }
+    }
+    if (!needsSplit)
+        return;
+
+    WTF::Vector<Pictures> cells;
+    for (Pictures* working = mPictures.begin(); working != last; working++) {
+        const SkIRect bounds = working->mArea.getBounds();
+        if (working->mPicture || !working->mArea.isRect()) {
+            cells.append(*working);
+            continue;
+        }
+        // keep the draw order: the cells take the place of the picture
+        for (int top = bounds.fTop; top < bounds.fBottom; ) {
+            int bottom = SkMin32(bounds.fBottom, (top / PICTURE_CELL_SIZE + 1) * PICTURE_CELL_SIZE);
+            for (int left = bounds.fLeft; left < bounds.fRight; ) {
+                int right = SkMin32(bounds.fRight, (left / PICTURE_CELL_SIZE + 1) * PICTURE_CELL_SIZE);
+                SkIRect cellBounds;
+                cellBounds.set(left, top, right, bottom);
+                Pictures cell = {SkRegion(cellBounds), 0, cellBounds, 0,
+                    true, false, working->mBase, false};
+                cells.append(cell);
+                left = right;
+            }
+            top = bottom;
+        }
+    }
+    DBG_SET_LOGD("%p split %d pictures into %d", this, mPictures.size(), cells.size());
+    mPictures.swap(cells);
+    validate(__FUNCTION__);
+}
+
 #endif // FAST_PICTURESET
 
 bool PictureSet::validate(const char* funct) const
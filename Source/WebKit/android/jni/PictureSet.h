@@ -106,6 +106,7 @@ namespace android {
         void setDrawTimes(const PictureSet& );
         size_t size() const { return mPictures.size(); }
         void split(PictureSet* result) const;
+        void splitIntoCells();
         bool upToDate(size_t i) const { return mPictures[i].mPicture != NULL; }
 #endif
         int width() const { return mWidth; }
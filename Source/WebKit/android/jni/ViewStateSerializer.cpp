@@ -33,6 +33,7 @@
 #include "PictureSet.h"
 #include "ScrollableLayerAndroid.h"
 #include "SkPicture.h"
+#include "SkStream.h"
 #include "TilesManager.h"
 
 #include <JNIUtility.h>
@@ -59,6 +60,18 @@ enum LayerTypes {
     LTScrollableLayerAndroid = 2,
 };
 
+// Saved states start with VIEW_STATE_MAGIC and the format version; states
+// saved before the format was versioned start with the background color
+// instead, and are read as version 0.
+// Version 1 prefixes the fields and picture of each layer with their size,
+// so that a layer of a type this build doesn't know is skipped instead of
+// derailing the rest of the tree.
+#define VIEW_STATE_MAGIC 0x00575653 // "WVS" with a zero alpha, not a likely color
+#define VIEW_STATE_VERSION 1
+
+// Size of the reads that bring a saved state in from Java
+#define VIEW_STATE_READ_CHUNK 65536
+
 static bool nativeSerializeViewState(JNIEnv* env, jobject, jint jbaseLayer,
                                      jobject jstream, jbyteArray jstorage)
 {
@@ -67,6 +80,10 @@ static bool nativeSerializeViewState(JNIEnv* env, jobject, jint jbaseLayer,
         return false;
 
     SkWStream *stream = CreateJavaOutputStreamAdaptor(env, jstream, jstorage);
+    if (!stream)
+        return false;
+    stream->write32(VIEW_STATE_MAGIC);
+    stream->write32(VIEW_STATE_VERSION);
 #if USE(ACCELERATED_COMPOSITING)
     stream->write32(baseLayer->getBackgroundColor().rgb());
 #else
@@ -77,8 +94,6 @@ static bool nativeSerializeViewState(JNIEnv* env, jobject, jint jbaseLayer,
     baseLayer->drawCanvas(picture.beginRecording(content->width(), content->height(),
             SkPicture::kUsePathBoundsForClip_RecordingFlag));
     picture.endRecording();
-    if (!stream)
-        return false;
     picture.serialize(stream);
     int childCount = baseLayer->countChildren();
     XLOG("BaseLayer has %d child(ren)", childCount);
@@ -94,24 +109,46 @@ static bool nativeSerializeViewState(JNIEnv* env, jobject, jint jbaseLayer,
 static BaseLayerAndroid* nativeDeserializeViewState(JNIEnv* env, jobject, jobject jstream,
                                       jbyteArray jstorage)
 {
-    SkStream* stream = CreateJavaInputStreamAdaptor(env, jstream, jstorage);
-    if (!stream)
+    SkStream* javaStream = CreateJavaInputStreamAdaptor(env, jstream, jstorage);
+    if (!javaStream)
+        return 0;
+    // Bring the whole state in with a few large reads, rather than going
+    // back to Java for each of the many small reads decoding makes
+    SkDynamicMemoryWStream buffer;
+    SkAutoMalloc chunk(VIEW_STATE_READ_CHUNK);
+    while (size_t read = javaStream->read(chunk.get(), VIEW_STATE_READ_CHUNK))
+        buffer.write(chunk.get(), read);
+    delete javaStream;
+    size_t size = buffer.getOffset();
+    if (size < sizeof(uint32_t))
         return 0;
+    SkAutoMalloc storage(size);
+    buffer.copyTo(storage.get());
+    SkMemoryStream stream(storage.get(), size, false);
+
+    int version = 0;
+    Color color = stream.readU32();
+    if (color.rgb() == VIEW_STATE_MAGIC) {
+        version = stream.readS32();
+        if (version > VIEW_STATE_VERSION) {
+            XLOG("Saved view state has version %d, aborting!", version);
+            return 0;
+        }
+        color = stream.readU32();
+    }
     BaseLayerAndroid* layer = new BaseLayerAndroid();
-    Color color = stream->readU32();
 #if USE(ACCELERATED_COMPOSITING)
     layer->setBackgroundColor(color);
 #endif
-    SkPicture* picture = new SkPicture(stream);
+    SkPicture* picture = new SkPicture(&stream);
     layer->setContent(picture);
     SkSafeUnref(picture);
-    int childCount = stream->readS32();
+    int childCount = stream.readS32();
     for (int i = 0; i < childCount; i++) {
-        LayerAndroid* childLayer = deserializeLayer(stream);
+        LayerAndroid* childLayer = deserializeLayer(&stream, version);
         if (childLayer)
             layer->addChild(childLayer);
     }
-    delete stream;
     return layer;
 }
 
@@ -258,42 +295,46 @@ void serializeLayer(LayerAndroid* layer, SkWStream* stream)
             : LTLayerAndroid;
     stream->write8(type);
 
+    // The layer's own fields and picture form one record, prefixed with
+    // its size; the children follow it
+    SkDynamicMemoryWStream record;
+
     // Start with Layer fields
-    stream->writeBool(layer->shouldInheritFromRootTransform());
-    stream->writeScalar(layer->getOpacity());
-    stream->writeScalar(layer->getSize().width());
-    stream->writeScalar(layer->getSize().height());
-    stream->writeScalar(layer->getPosition().x());
-    stream->writeScalar(layer->getPosition().y());
-    stream->writeScalar(layer->getAnchorPoint().x());
-    stream->writeScalar(layer->getAnchorPoint().y());
-    writeMatrix(stream, layer->getMatrix());
-    writeMatrix(stream, layer->getChildrenMatrix());
+    record.writeBool(layer->shouldInheritFromRootTransform());
+    record.writeScalar(layer->getOpacity());
+    record.writeScalar(layer->getSize().width());
+    record.writeScalar(layer->getSize().height());
+    record.writeScalar(layer->getPosition().x());
+    record.writeScalar(layer->getPosition().y());
+    record.writeScalar(layer->getAnchorPoint().x());
+    record.writeScalar(layer->getAnchorPoint().y());
+    writeMatrix(&record, layer->getMatrix());
+    writeMatrix(&record, layer->getChildrenMatrix());
 
     // Next up, LayerAndroid fields
-    stream->writeBool(layer->m_haveClip);
-    stream->writeBool(layer->m_isFixed);
-    stream->writeBool(layer->m_backgroundColorSet);
-    stream->writeBool(layer->m_isIframe);
-    writeSkLength(stream, layer->m_fixedLeft);
-    writeSkLength(stream, layer->m_fixedTop);
-    writeSkLength(stream, layer->m_fixedRight);
-    writeSkLength(stream, layer->m_fixedBottom);
-    writeSkLength(stream, layer->m_fixedMarginLeft);
-    writeSkLength(stream, layer->m_fixedMarginTop);
-    writeSkLength(stream, layer->m_fixedMarginRight);
-    writeSkLength(stream, layer->m_fixedMarginBottom);
-    writeSkRect(stream, layer->m_fixedRect);
-    stream->write32(layer->m_renderLayerPos.x());
-    stream->write32(layer->m_renderLayerPos.y());
-    stream->writeBool(layer->m_backfaceVisibility);
-    stream->writeBool(layer->m_visible);
-    stream->write32(layer->m_backgroundColor);
-    stream->writeBool(layer->m_preserves3D);
-    stream->writeScalar(layer->m_anchorPointZ);
-    stream->writeScalar(layer->m_drawOpacity);
+    record.writeBool(layer->m_haveClip);
+    record.writeBool(layer->m_isFixed);
+    record.writeBool(layer->m_backgroundColorSet);
+    record.writeBool(layer->m_isIframe);
+    writeSkLength(&record, layer->m_fixedLeft);
+    writeSkLength(&record, layer->m_fixedTop);
+    writeSkLength(&record, layer->m_fixedRight);
+    writeSkLength(&record, layer->m_fixedBottom);
+    writeSkLength(&record, layer->m_fixedMarginLeft);
+    writeSkLength(&record, layer->m_fixedMarginTop);
+    writeSkLength(&record, layer->m_fixedMarginRight);
+    writeSkLength(&record, layer->m_fixedMarginBottom);
+    writeSkRect(&record, layer->m_fixedRect);
+    record.write32(layer->m_renderLayerPos.x());
+    record.write32(layer->m_renderLayerPos.y());
+    record.writeBool(layer->m_backfaceVisibility);
+    record.writeBool(layer->m_visible);
+    record.write32(layer->m_backgroundColor);
+    record.writeBool(layer->m_preserves3D);
+    record.writeScalar(layer->m_anchorPointZ);
+    record.writeScalar(layer->m_drawOpacity);
     bool hasContentsImage = layer->m_imageCRC != 0;
-    stream->writeBool(hasContentsImage);
+    record.writeBool(hasContentsImage);
     if (hasContentsImage) {
         SkFlattenableWriteBuffer buffer(1024);
         buffer.setFlags(SkFlattenableWriteBuffer::kCrossProcess_Flag);
@@ -302,83 +343,110 @@ void serializeLayer(LayerAndroid* layer, SkWStream* stream)
         if (imagetexture && imagetexture->bitmap())
             imagetexture->bitmap()->flatten(buffer);
         ImagesManager::instance()->releaseImage(layer->m_imageCRC);
-        stream->write32(buffer.size());
-        buffer.writeToStream(stream);
+        record.write32(buffer.size());
+        buffer.writeToStream(&record);
     }
     bool hasRecordingPicture = layer->m_recordingPicture != 0;
-    stream->writeBool(hasRecordingPicture);
+    record.writeBool(hasRecordingPicture);
     if (hasRecordingPicture)
-        layer->m_recordingPicture->serialize(stream);
+        layer->m_recordingPicture->serialize(&record);
     // TODO: support m_animations (maybe?)
-    stream->write32(0); // placeholder for m_animations.size();
-    writeTransformationMatrix(stream, layer->m_transform);
-    writeTransformationMatrix(stream, layer->m_childrenTransform);
+    record.write32(0); // placeholder for m_animations.size();
+    writeTransformationMatrix(&record, layer->m_transform);
+    writeTransformationMatrix(&record, layer->m_childrenTransform);
     if (type == LTScrollableLayerAndroid) {
         ScrollableLayerAndroid* scrollableLayer =
                 static_cast<ScrollableLayerAndroid*>(layer);
-        stream->writeScalar(scrollableLayer->m_scrollLimits.fLeft);
-        stream->writeScalar(scrollableLayer->m_scrollLimits.fTop);
-        stream->writeScalar(scrollableLayer->m_scrollLimits.width());
-        stream->writeScalar(scrollableLayer->m_scrollLimits.height());
+        record.writeScalar(scrollableLayer->m_scrollLimits.fLeft);
+        record.writeScalar(scrollableLayer->m_scrollLimits.fTop);
+        record.writeScalar(scrollableLayer->m_scrollLimits.width());
+        record.writeScalar(scrollableLayer->m_scrollLimits.height());
     }
+    size_t recordSize = record.getOffset();
+    SkAutoMalloc recordStorage(recordSize);
+    record.copyTo(recordStorage.get());
+    stream->write32(recordSize);
+    stream->write(recordStorage.get(), recordSize);
     int childCount = layer->countChildren();
     stream->write32(childCount);
     for (int i = 0; i < childCount; i++)
         serializeLayer(layer->getChild(i), stream);
 }
 
-LayerAndroid* deserializeLayer(SkStream* stream)
+LayerAndroid* deserializeLayer(SkStream* stream, int version)
 {
     int type = stream->readU8();
     if (type == LTNone)
         return 0;
     // Cast is to disambiguate between ctors.
-    LayerAndroid *layer;
+    LayerAndroid *layer = 0;
     if (type == LTLayerAndroid)
         layer = new LayerAndroid((RenderLayer*) 0);
     else if (type == LTScrollableLayerAndroid)
         layer = new ScrollableLayerAndroid((RenderLayer*) 0);
-    else {
-        XLOG("Unexpected layer type: %d, aborting!", type);
+
+    // From version 1 on, the fields are read from their own record, which
+    // is skipped as a whole for an unknown type
+    SkStream* fields = stream;
+    size_t recordSize = version >= 1 ? stream->readU32() : 0;
+    SkAutoMalloc recordStorage(recordSize);
+    SkMemoryStream record;
+    if (version >= 1) {
+        if (stream->read(recordStorage.get(), recordSize) != recordSize) {
+            XLOG("Truncated layer record, aborting!");
+            SkSafeUnref(layer);
+            return 0;
+        }
+        record.setMemory(recordStorage.get(), recordSize, false);
+        fields = &record;
+    }
+    if (!layer) {
+        XLOG("Unexpected layer type: %d, %s!", type,
+             version >= 1 ? "skipping it" : "aborting");
+        if (version < 1)
+            return 0;
+        int childCount = stream->readU32();
+        for (int i = 0; i < childCount; i++)
+            SkSafeUnref(deserializeLayer(stream, version));
         return 0;
     }
 
     // Layer fields
-    layer->setShouldInheritFromRootTransform(stream->readBool());
-    layer->setOpacity(stream->readScalar());
-    layer->setSize(stream->readScalar(), stream->readScalar());
-    layer->setPosition(stream->readScalar(), stream->readScalar());
-    layer->setAnchorPoint(stream->readScalar(), stream->readScalar());
-    layer->setMatrix(readMatrix(stream));
-    layer->setChildrenMatrix(readMatrix(stream));
+    layer->setShouldInheritFromRootTransform(fields->readBool());
+    layer->setOpacity(fields->readScalar());
+    layer->setSize(fields->readScalar(), fields->readScalar());
+    layer->setPosition(fields->readScalar(), fields->readScalar());
+    layer->setAnchorPoint(fields->readScalar(), fields->readScalar());
+    layer->setMatrix(readMatrix(fields));
+    layer->setChildrenMatrix(readMatrix(fields));
 
     // LayerAndroid fields
-    layer->m_haveClip = stream->readBool();
-    layer->m_isFixed = stream->readBool();
-    layer->m_backgroundColorSet = stream->readBool();
-    layer->m_isIframe = stream->readBool();
-    layer->m_fixedLeft = readSkLength(stream);
-    layer->m_fixedTop = readSkLength(stream);
-    layer->m_fixedRight = readSkLength(stream);
-    layer->m_fixedBottom = readSkLength(stream);
-    layer->m_fixedMarginLeft = readSkLength(stream);
-    layer->m_fixedMarginTop = readSkLength(stream);
-    layer->m_fixedMarginRight = readSkLength(stream);
-    layer->m_fixedMarginBottom = readSkLength(stream);
-    layer->m_fixedRect = readSkRect(stream);
-    layer->m_renderLayerPos.setX(stream->readS32());
-    layer->m_renderLayerPos.setY(stream->readS32());
-    layer->m_backfaceVisibility = stream->readBool();
-    layer->m_visible = stream->readBool();
-    layer->m_backgroundColor = stream->readU32();
-    layer->m_preserves3D = stream->readBool();
-    layer->m_anchorPointZ = stream->readScalar();
-    layer->m_drawOpacity = stream->readScalar();
-    bool hasContentsImage = stream->readBool();
+    layer->m_haveClip = fields->readBool();
+    layer->m_isFixed = fields->readBool();
+    layer->m_backgroundColorSet = fields->readBool();
+    layer->m_isIframe = fields->readBool();
+    layer->m_fixedLeft = readSkLength(fields);
+    layer->m_fixedTop = readSkLength(fields);
+    layer->m_fixedRight = readSkLength(fields);
+    layer->m_fixedBottom = readSkLength(fields);
+    layer->m_fixedMarginLeft = readSkLength(fields);
+    layer->m_fixedMarginTop = readSkLength(fields);
+    layer->m_fixedMarginRight = readSkLength(fields);
+    layer->m_fixedMarginBottom = readSkLength(fields);
+    layer->m_fixedRect = readSkRect(fields);
+    layer->m_renderLayerPos.setX(fields->readS32());
+    layer->m_renderLayerPos.setY(fields->readS32());
+    layer->m_backfaceVisibility = fields->readBool();
+    layer->m_visible = fields->readBool();
+    layer->m_backgroundColor = fields->readU32();
+    layer->m_preserves3D = fields->readBool();
+    layer->m_anchorPointZ = fields->readScalar();
+    layer->m_drawOpacity = fields->readScalar();
+    bool hasContentsImage = fields->readBool();
     if (hasContentsImage) {
-        int size = stream->readU32();
+        int size = fields->readU32();
         SkAutoMalloc storage(size);
-        stream->read(storage.get(), size);
+        fields->read(storage.get(), size);
         SkFlattenableReadBuffer buffer(storage.get(), size);
         SkBitmap contentsImage;
         contentsImage.unflatten(buffer);
@@ -386,25 +454,25 @@ LayerAndroid* deserializeLayer(SkStream* stream)
         layer->setContentsImage(imageRef);
         delete imageRef;
     }
-    bool hasRecordingPicture = stream->readBool();
+    bool hasRecordingPicture = fields->readBool();
     if (hasRecordingPicture) {
-        layer->m_recordingPicture = new SkPicture(stream);
+        layer->m_recordingPicture = new SkPicture(fields);
     }
-    int animationCount = stream->readU32(); // TODO: Support (maybe?)
-    readTransformationMatrix(stream, layer->m_transform);
-    readTransformationMatrix(stream, layer->m_childrenTransform);
+    int animationCount = fields->readU32(); // TODO: Support (maybe?)
+    readTransformationMatrix(fields, layer->m_transform);
+    readTransformationMatrix(fields, layer->m_childrenTransform);
     if (type == LTScrollableLayerAndroid) {
         ScrollableLayerAndroid* scrollableLayer =
                 static_cast<ScrollableLayerAndroid*>(layer);
         scrollableLayer->m_scrollLimits.set(
-                stream->readScalar(),
-                stream->readScalar(),
-                stream->readScalar(),
-                stream->readScalar());
+                fields->readScalar(),
+                fields->readScalar(),
+                fields->readScalar(),
+                fields->readScalar());
     }
     int childCount = stream->readU32();
     for (int i = 0; i < childCount; i++) {
-        LayerAndroid *childLayer = deserializeLayer(stream);
+        LayerAndroid *childLayer = deserializeLayer(stream, version);
         if (childLayer)
             layer->addChild(childLayer);
     }
@@ -101,10 +101,12 @@
 #include <utils/misc.h>
 #include <utils/AssetManager.h>
 #include <wtf/CurrentTime.h>
+#include <wtf/HashMap.h>
 #include <wtf/Platform.h>
 #include <wtf/text/AtomicString.h>
 #include <wtf/text/CString.h>
 #include <wtf/text/StringBuilder.h>
+#include <wtf/text/StringHash.h>
 
 #if USE(JSC)
 #include "GCController.h"
@@ -342,6 +344,7 @@ WebFrame::WebFrame(JNIEnv* env, jobject obj, jobject historyList, WebCore::Page*
     mUserAgent = WTF::String();
     mUserInitiatedAction = false;
     mBlockNetworkLoads = false;
+    mLastProgress = -1;
     m_renderSkins = 0;
 }
 
@@ -364,33 +367,62 @@ WebFrame* WebFrame::getWebFrame(const WebCore::Frame* frame)
     return client->webFrame();
 }
 
+// java.util classes and methods used on every load, resolved once in
+// registerWebFrame
+static struct {
+    jclass      mHashMapClass; // global ref
+    jmethodID   mHashMapInit;
+    jmethodID   mHashMapPut;
+    jmethodID   mMapEntrySet;
+    jmethodID   mSetIterator;
+    jmethodID   mIteratorHasNext;
+    jmethodID   mIteratorNext;
+    jmethodID   mEntryGetKey;
+    jmethodID   mEntryGetValue;
+} gJavaUtil;
+
+// Methods and header names sent with nearly every request share one jstring
+// each; Java strings are immutable, so handing the same object to every call
+// is safe. Filled in registerWebFrame and only read afterwards.
+static const char* const gInternedStrings[] = {
+    "GET", "POST", "HEAD", "Accept", "Accept-Charset", "Accept-Encoding",
+    "Accept-Language", "Cache-Control", "Content-Type", "If-Modified-Since",
+    "If-None-Match", "Origin", "Pragma", "Range", "Referer", "User-Agent",
+    "X-Requested-With"
+};
+static WTF::HashMap<WTF::String, jstring>* gInternedJstrings;
+
+// Returns a global ref to the shared jstring for str, which must not be
+// deleted, or 0 if str isn't one of gInternedStrings
+static jstring internedJstring(const WTF::String& str)
+{
+    if (!gInternedJstrings || str.isEmpty())
+        return 0;
+    WTF::HashMap<WTF::String, jstring>::const_iterator it = gInternedJstrings->find(str);
+    return it != gInternedJstrings->end() ? it->second : 0;
+}
+
 static jobject createJavaMapFromHTTPHeaders(JNIEnv* env, const WebCore::HTTPHeaderMap& map)
 {
-    jclass mapClass = env->FindClass("java/util/HashMap");
-    LOG_ASSERT(mapClass, "Could not find HashMap class!");
-    jmethodID init = env->GetMethodID(mapClass, "<init>", "(I)V");
-    LOG_ASSERT(init, "Could not find constructor for HashMap");
-    jobject hashMap = env->NewObject(mapClass, init, map.size());
+    jobject hashMap = env->NewObject(gJavaUtil.mHashMapClass,
+            gJavaUtil.mHashMapInit, map.size());
     LOG_ASSERT(hashMap, "Could not create a new HashMap");
-    jmethodID put = env->GetMethodID(mapClass, "put",
-            "(Ljava/lang/Object;Ljava/lang/Object;)Ljava/lang/Object;");
-    LOG_ASSERT(put, "Could not find put method on HashMap");
 
     WebCore::HTTPHeaderMap::const_iterator end = map.end();
     for (WebCore::HTTPHeaderMap::const_iterator i = map.begin(); i != end; ++i) {
         if (i->first.length() == 0 || i->second.length() == 0)
             continue;
-        jstring key = wtfStringToJstring(env, i->first);
+        jstring internedKey = internedJstring(i->first);
+        jstring key = internedKey ? internedKey : wtfStringToJstring(env, i->first);
         jstring val = wtfStringToJstring(env, i->second);
         if (key && val) {
-            env->CallObjectMethod(hashMap, put, key, val);
+            env->CallObjectMethod(hashMap, gJavaUtil.mHashMapPut, key, val);
         }
-        env->DeleteLocalRef(key);
+        if (!internedKey)
+            env->DeleteLocalRef(key);
         env->DeleteLocalRef(val);
     }
 
-    env->DeleteLocalRef(mapClass);
-
     return hashMap;
 }
 
@@ -456,8 +488,9 @@ WebFrame::startLoadingResource(WebCore::ResourceHandle* loader,
     }
     LOGV("%s lower=%s", __FUNCTION__, urlStr.latin1().data());
     jstring jUrlStr = wtfStringToJstring(env, urlStr);
-    jstring jMethodStr = NULL;
-    if (!method.isEmpty())
+    jstring jMethodStr = internedJstring(method);
+    bool internedMethod = jMethodStr;
+    if (!jMethodStr && !method.isEmpty())
         jMethodStr = wtfStringToJstring(env, method);
     WebCore::FormData* formdata = request.httpBody();
     jbyteArray jPostDataStr = getPostData(request);
@@ -497,7 +530,8 @@ WebFrame::startLoadingResource(WebCore::ResourceHandle* loader,
                 synchronous, jUsernameString, jPasswordString);
 
     env->DeleteLocalRef(jUrlStr);
-    env->DeleteLocalRef(jMethodStr);
+    if (!internedMethod)
+        env->DeleteLocalRef(jMethodStr);
     env->DeleteLocalRef(jPostDataStr);
     env->DeleteLocalRef(jHeaderMap);
     env->DeleteLocalRef(jUsernameString);
@@ -581,6 +615,7 @@ WebFrame::loadStarted(WebCore::Frame* frame)
 #ifdef ANDROID_INSTRUMENT
     TimeCounterAuto counter(TimeCounter::JavaCallbackTimeCounter);
 #endif
+    mLastProgress = -1;
     JNIEnv* env = getJNIEnv();
     AutoJObject javaFrame = mJavaFrame->frame(env);
     if (!javaFrame.get())
@@ -664,6 +699,7 @@ WebFrame::didFinishLoad(WebCore::Frame* frame)
 #ifdef ANDROID_INSTRUMENT
     TimeCounterAuto counter(TimeCounter::JavaCallbackTimeCounter);
 #endif
+    mLastProgress = -1;
     JNIEnv* env = getJNIEnv();
     AutoJObject javaFrame = mJavaFrame->frame(env);
     if (!javaFrame.get())
@@ -771,12 +807,17 @@ WebFrame::setProgress(float newProgress)
 #ifdef ANDROID_INSTRUMENT
     TimeCounterAuto counter(TimeCounter::JavaCallbackTimeCounter);
 #endif
+    // WebCore estimates progress for every chunk received; Java only shows
+    // whole percents, so skip the JNI call when that doesn't change
+    int progress = static_cast<int>(100 * newProgress);
+    if (progress == mLastProgress)
+        return;
     JNIEnv* env = getJNIEnv();
     AutoJObject javaFrame = mJavaFrame->frame(env);
     if (!javaFrame.get())
         return;
 
-    int progress = static_cast<int>(100 * newProgress);
+    mLastProgress = progress;
     env->CallVoidMethod(javaFrame.get(), mJavaFrame->mSetProgress, progress);
     checkException(env);
 }
@@ -1442,43 +1483,20 @@ static void LoadUrl(JNIEnv *env, jobject obj, jstring url, jobject headers)
     WebCore::KURL kurl(WebCore::KURL(), webcoreUrl);
     WebCore::ResourceRequest request(kurl);
     if (headers) {
-        // dalvikvm will raise exception if any of these fail
-        jclass mapClass = env->FindClass("java/util/Map");
-        jmethodID entrySet = env->GetMethodID(mapClass, "entrySet",
-                "()Ljava/util/Set;");
-        jobject set = env->CallObjectMethod(headers, entrySet);
-
-        jclass setClass = env->FindClass("java/util/Set");
-        jmethodID iterator = env->GetMethodID(setClass, "iterator",
-                "()Ljava/util/Iterator;");
-        jobject iter = env->CallObjectMethod(set, iterator);
-
-        jclass iteratorClass = env->FindClass("java/util/Iterator");
-        jmethodID hasNext = env->GetMethodID(iteratorClass, "hasNext", "()Z");
-        jmethodID next = env->GetMethodID(iteratorClass, "next",
-                "()Ljava/lang/Object;");
-        jclass entryClass = env->FindClass("java/util/Map$Entry");
-        jmethodID getKey = env->GetMethodID(entryClass, "getKey",
-                "()Ljava/lang/Object;");
-        jmethodID getValue = env->GetMethodID(entryClass, "getValue",
-                "()Ljava/lang/Object;");
-
-        while (env->CallBooleanMethod(iter, hasNext)) {
-            jobject entry = env->CallObjectMethod(iter, next);
-            jstring key = (jstring) env->CallObjectMethod(entry, getKey);
-            jstring value = (jstring) env->CallObjectMethod(entry, getValue);
+        jobject set = env->CallObjectMethod(headers, gJavaUtil.mMapEntrySet);
+        jobject iter = env->CallObjectMethod(set, gJavaUtil.mSetIterator);
+        while (env->CallBooleanMethod(iter, gJavaUtil.mIteratorHasNext)) {
+            jobject entry = env->CallObjectMethod(iter, gJavaUtil.mIteratorNext);
+            jstring key = (jstring) env->CallObjectMethod(entry, gJavaUtil.mEntryGetKey);
+            jstring value = (jstring) env->CallObjectMethod(entry, gJavaUtil.mEntryGetValue);
             request.setHTTPHeaderField(jstringToWtfString(env, key), jstringToWtfString(env, value));
             env->DeleteLocalRef(entry);
             env->DeleteLocalRef(key);
             env->DeleteLocalRef(value);
         }
 
-        env->DeleteLocalRef(entryClass);
-        env->DeleteLocalRef(iteratorClass);
         env->DeleteLocalRef(iter);
-        env->DeleteLocalRef(setClass);
         env->DeleteLocalRef(set);
-        env->DeleteLocalRef(mapClass);
     }
     LOGV("LoadUrl %s", kurl.string().latin1().data());
     pFrame->loader()->load(request, false);
@@ -2087,15 +2105,9 @@ WebFrame::saveFormData(HTMLFormElement* form)
 
     if (form->autoComplete()) {
         JNIEnv* env = getJNIEnv();
-        jclass mapClass = env->FindClass("java/util/HashMap");
-        LOG_ASSERT(mapClass, "Could not find HashMap class!");
-        jmethodID init = env->GetMethodID(mapClass, "<init>", "(I)V");
-        LOG_ASSERT(init, "Could not find constructor for HashMap");
-        jobject hashMap = env->NewObject(mapClass, init, 1);
+        jobject hashMap = env->NewObject(gJavaUtil.mHashMapClass,
+                gJavaUtil.mHashMapInit, 1);
         LOG_ASSERT(hashMap, "Could not create a new HashMap");
-        jmethodID put = env->GetMethodID(mapClass, "put",
-                "(Ljava/lang/Object;Ljava/lang/Object;)Ljava/lang/Object;");
-        LOG_ASSERT(put, "Could not find put method on HashMap");
         WTF::Vector<WebCore::FormAssociatedElement*> elements = form->associatedElements();
         size_t size = elements.size();
         for (size_t i = 0; i < size; i++) {
@@ -2111,7 +2123,7 @@ WebFrame::saveFormData(HTMLFormElement* form)
                         jstring key = wtfStringToJstring(env, name);
                         jstring val = wtfStringToJstring(env, value);
                         LOG_ASSERT(key && val, "name or value not set");
-                        env->CallObjectMethod(hashMap, put, key, val);
+                        env->CallObjectMethod(hashMap, gJavaUtil.mHashMapPut, key, val);
                         env->DeleteLocalRef(key);
                         env->DeleteLocalRef(val);
                     }
@@ -2120,7 +2132,6 @@ WebFrame::saveFormData(HTMLFormElement* form)
         }
         env->CallVoidMethod(javaFrame.get(), mJavaFrame->mSaveFormData, hashMap);
         env->DeleteLocalRef(hashMap);
-        env->DeleteLocalRef(mapClass);
     }
 }
 
@@ -2363,6 +2374,40 @@ int registerWebFrame(JNIEnv* env)
     LOG_ASSERT(gFrameField, "Cannot find mNativeFrame on BrowserFrame");
     env->DeleteLocalRef(clazz);
 
+    // dalvikvm will raise exception if any of these fail
+    jclass mapClass = env->FindClass("java/util/HashMap");
+    LOG_ASSERT(mapClass, "Could not find HashMap class!");
+    gJavaUtil.mHashMapClass = (jclass) env->NewGlobalRef(mapClass);
+    gJavaUtil.mHashMapInit = env->GetMethodID(mapClass, "<init>", "(I)V");
+    LOG_ASSERT(gJavaUtil.mHashMapInit, "Could not find constructor for HashMap");
+    gJavaUtil.mHashMapPut = env->GetMethodID(mapClass, "put",
+            "(Ljava/lang/Object;Ljava/lang/Object;)Ljava/lang/Object;");
+    LOG_ASSERT(gJavaUtil.mHashMapPut, "Could not find put method on HashMap");
+    env->DeleteLocalRef(mapClass);
+
+    clazz = env->FindClass("java/util/Map");
+    gJavaUtil.mMapEntrySet = env->GetMethodID(clazz, "entrySet", "()Ljava/util/Set;");
+    env->DeleteLocalRef(clazz);
+    clazz = env->FindClass("java/util/Set");
+    gJavaUtil.mSetIterator = env->GetMethodID(clazz, "iterator", "()Ljava/util/Iterator;");
+    env->DeleteLocalRef(clazz);
+    clazz = env->FindClass("java/util/Iterator");
+    gJavaUtil.mIteratorHasNext = env->GetMethodID(clazz, "hasNext", "()Z");
+    gJavaUtil.mIteratorNext = env->GetMethodID(clazz, "next", "()Ljava/lang/Object;");
+    env->DeleteLocalRef(clazz);
+    clazz = env->FindClass("java/util/Map$Entry");
+    gJavaUtil.mEntryGetKey = env->GetMethodID(clazz, "getKey", "()Ljava/lang/Object;");
+    gJavaUtil.mEntryGetValue = env->GetMethodID(clazz, "getValue", "()Ljava/lang/Object;");
+    env->DeleteLocalRef(clazz);
+
+    gInternedJstrings = new WTF::HashMap<WTF::String, jstring>();
+    for (size_t i = 0; i < NELEM(gInternedStrings); i++) {
+        jstring str = env->NewStringUTF(gInternedStrings[i]);
+        gInternedJstrings->set(WTF::String(gInternedStrings[i]),
+                (jstring) env->NewGlobalRef(str));
+        env->DeleteLocalRef(str);
+    }
+
     return jniRegisterNativeMethods(env, "android/webkit/BrowserFrame",
             gBrowserFrameNativeMethods, NELEM(gBrowserFrameNativeMethods));
 }
@@ -170,6 +170,7 @@ class WebFrame : public WebCoreRefObject {
     WTF::String mUserAgent;
     bool mBlockNetworkLoads;
     bool mUserInitiatedAction;
+    int mLastProgress; // last value passed to Java, -1 after loadStarted
     WebCore::RenderSkinAndroid* m_renderSkins;
 };
 
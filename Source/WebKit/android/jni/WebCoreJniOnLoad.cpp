@@ -33,6 +33,7 @@
 #include "CookieClient.h"
 #include "DeviceMotionClientAndroid.h"
 #include "DeviceOrientationClientAndroid.h"
+#include "Document.h"
 #include "DragClientAndroid.h"
 #include "EditorClientAndroid.h"
 #include "FocusController.h"
@@ -45,10 +46,14 @@
 #include "InspectorClientAndroid.h"
 #include "IntRect.h"
 #include "JavaSharedClient.h"
+#include "KURL.h"
 #include "Page.h"
 #include "PlatformGraphicsContext.h"
+#include "RenderView.h"
 #include "ResourceRequest.h"
 #include "ScriptController.h"
+#include "ScriptGCEvent.h"
+#include "ScriptSourceCode.h"
 #include "SecurityOrigin.h"
 #include "SelectionController.h"
 #include "Settings.h"
@@ -56,9 +61,11 @@
 #include "SkBitmap.h"
 #include "SkCanvas.h"
 #include "SkImageEncoder.h"
+#include "SkPicture.h"
 #include "SubstituteData.h"
 #include "TimerClient.h"
 #include "TextEncoding.h"
+#include "TraceEventAndroid.h"
 #include "WebCoreViewBridge.h"
 #include "WebFrameView.h"
 #include "WebViewCore.h"
@@ -66,8 +73,16 @@
 #include "benchmark/MyJavaVM.h"
 
 #include <JNIUtility.h>
+#include <algorithm>
 #include <jni.h>
+#include <stdio.h>
 #include <utils/Log.h>
+#include <wtf/CurrentTime.h>
+#include <wtf/text/CString.h>
+
+#if USE(V8)
+#include <v8.h>
+#endif
 
 #define EXPORT __attribute__((visibility("default")))
 
@@ -187,7 +202,51 @@ static void historyItemChanged(HistoryItem* i) {
 
 namespace android {
 
-EXPORT void benchmark(const char* url, int reloadCount, int width, int height) {
+// Machine readable results, one "url,run,phase,milliseconds" line per measurement.
+static void reportPhase(FILE* out, const char* url, int run, const char* phase, double startMS)
+{
+    fprintf(out, "%s,%d,%s,%.3f\n", url, run, phase, currentTimeMS() - startMS);
+}
+
+static void serviceUntilIdle(Frame* frame, MyJavaSharedClient& client)
+{
+    // Layout the page and service the timer
+    frame->view()->layout();
+    while (client.m_hasTimer) {
+        client.m_func();
+        JavaSharedClient::ServiceFunctionPtrQueue();
+    }
+    JavaSharedClient::ServiceFunctionPtrQueue();
+
+    // Layout more if needed.
+    while (frame->view()->needsLayout())
+        frame->view()->layout();
+    JavaSharedClient::ServiceFunctionPtrQueue();
+}
+
+static void recordRect(SkPicture* picture, FrameView* view, const IntRect& rect)
+{
+    SkCanvas* canvas = picture->beginRecording(rect.width(), rect.height(), 0);
+    PlatformGraphicsContext ctx(canvas);
+    GraphicsContext gc(&ctx);
+    gc.translate(-rect.x(), -rect.y());
+    view->paintContents(&gc, rect);
+    picture->endRecording();
+}
+
+static void rasterPicture(SkPicture* picture, SkBitmap* bitmap, float scale)
+{
+    bitmap->eraseARGB(0, 0, 0, 0);
+    SkCanvas canvas(*bitmap);
+    canvas.scale(SkFloatToScalar(scale), SkFloatToScalar(scale));
+    canvas.drawPicture(*picture);
+}
+
+// Sets up a Page with a single Frame the size of the given viewport, wired to
+// fake Java clients and a MyWebFrame serving local files. The caller tears
+// it down with destroyBenchmarkFrame().
+static PassRefPtr<Frame> createBenchmarkFrame(MyJavaSharedClient* client, int width, int height, int latencyMS)
+{
     ScriptController::initializeThreading();
 
     // Setting this allows data: urls to load from a local file.
@@ -200,9 +259,8 @@ EXPORT void benchmark(const char* url, int reloadCount, int width, int height) {
     notifyHistoryItemChanged = historyItemChanged;
 
     // Implement the shared timer callback
-    MyJavaSharedClient client;
-    JavaSharedClient::SetTimerClient(&client);
-    JavaSharedClient::SetCookieClient(&client);
+    JavaSharedClient::SetTimerClient(client);
+    JavaSharedClient::SetCookieClient(client);
 
     // Create the page with all the various clients
     ChromeClientAndroid* chrome = new ChromeClientAndroid;
@@ -223,6 +281,7 @@ EXPORT void benchmark(const char* url, int reloadCount, int width, int height) {
     // Create MyWebFrame that intercepts network requests
     MyWebFrame* webFrame = new MyWebFrame(page);
     webFrame->setUserAgent("Performance testing"); // needs to be non-empty
+    webFrame->setNetworkLatency(latencyMS / 1000.0);
     chrome->setWebFrame(webFrame);
     // ChromeClientAndroid maintains the reference.
     Release(webFrame);
@@ -277,32 +336,99 @@ EXPORT void benchmark(const char* url, int reloadCount, int width, int height) {
     s->setUseWideViewport(false);
 #endif
 
-    // Finally, load the actual data
-    ResourceRequest req(url);
-    frame->loader()->load(req, false);
-
-    do {
-        // Layout the page and service the timer
-        frame->view()->layout();
-        while (client.m_hasTimer) {
-            client.m_func();
-            JavaSharedClient::ServiceFunctionPtrQueue();
-        }
-        JavaSharedClient::ServiceFunctionPtrQueue();
+    return frame.release();
+}
 
-        // Layout more if needed.
-        while (frame->view()->needsLayout())
-            frame->view()->layout();
-        JavaSharedClient::ServiceFunctionPtrQueue();
+static void destroyBenchmarkFrame(PassRefPtr<Frame> prpFrame)
+{
+    RefPtr<Frame> frame = prpFrame;
+    WebCore::Page* page = frame->page();
+    frame->loader()->detachFromParent();
+    delete page;
+}
 
-        if (reloadCount)
-            frame->loader()->reload(true);
-    } while (reloadCount--);
+EXPORT void benchmark(const char** urls, int urlCount, int reloadCount, int width, int height, int scrollSteps, int latencyMS, FILE* out, const char* tracePath) {
+    MyJavaSharedClient client;
+    RefPtr<Frame> frame = createBenchmarkFrame(&client, width, height, latencyMS);
+    RefPtr<FrameView> frameView = frame->view();
 
-    // Draw into an offscreen bitmap
+    // Scrolling rasters the recorded viewport at 1x and, to stand in for a
+    // pinch zoom, at 2x.
+    static const float zoomScale = 2;
     SkBitmap bmp;
     bmp.setConfig(SkBitmap::kARGB_8888_Config, width, height);
     bmp.allocPixels();
+    SkBitmap zoomedBmp;
+    zoomedBmp.setConfig(SkBitmap::kARGB_8888_Config, width * zoomScale, height * zoomScale);
+    zoomedBmp.allocPixels();
+
+    fprintf(out, "url,run,phase,ms\n");
+    if (tracePath)
+        TraceEventAndroid::setEnabled(true);
+
+    for (int i = 0; i < urlCount; ++i) {
+        const char* url = urls[i];
+        for (int run = 0; run <= reloadCount; ++run) {
+            // Parsing, loading subresources and the incremental style and
+            // layout that happen while the page comes in.
+            double start = currentTimeMS();
+            ResourceRequest req(url);
+            frame->loader()->load(req, false);
+            serviceUntilIdle(frame.get(), client);
+            reportPhase(out, url, run, "load", start);
+
+            Document* document = frame->document();
+            if (!document || !document->renderView())
+                continue;
+
+            // Full style recalc and full layout of the loaded page.
+            start = currentTimeMS();
+            document->styleSelectorChanged(RecalcStyleImmediately);
+            reportPhase(out, url, run, "style", start);
+
+            start = currentTimeMS();
+            for (RenderObject* renderer = document->renderView(); renderer; renderer = renderer->nextInPreOrder())
+                renderer->setNeedsLayout(true, false);
+            frameView->layout();
+            reportPhase(out, url, run, "layout", start);
+
+            // Scroll down the page half a viewport at a time, recording and
+            // rastering each viewport the way the tile pipeline would.
+            double recordMS = 0;
+            double rasterMS = 0;
+            double zoomedRasterMS = 0;
+            int contentsHeight = std::max(frameView->contentsHeight(), height);
+            for (int step = 0; step <= scrollSteps; ++step) {
+                int y = std::min(step * height / 2, contentsHeight - height);
+                SkPicture picture;
+
+                start = currentTimeMS();
+                recordRect(&picture, frameView.get(), IntRect(0, y, width, height));
+                recordMS += currentTimeMS() - start;
+
+                start = currentTimeMS();
+                rasterPicture(&picture, &bmp, 1);
+                rasterMS += currentTimeMS() - start;
+
+                start = currentTimeMS();
+                rasterPicture(&picture, &zoomedBmp, zoomScale);
+                zoomedRasterMS += currentTimeMS() - start;
+            }
+            fprintf(out, "%s,%d,record,%.3f\n", url, run, recordMS);
+            fprintf(out, "%s,%d,raster,%.3f\n", url, run, rasterMS);
+            fprintf(out, "%s,%d,raster_zoomed,%.3f\n", url, run, zoomedRasterMS);
+            fflush(out);
+        }
+    }
+
+    if (tracePath) {
+        TraceEventAndroid::setEnabled(false);
+        if (!TraceEventAndroid::writeTimeline(tracePath))
+            LOGE("Could not write the timeline to %s", tracePath);
+    }
+
+    // Draw the top of the last page into an offscreen bitmap
+    bmp.eraseARGB(0, 0, 0, 0);
     SkCanvas canvas(bmp);
     PlatformGraphicsContext ctx(&canvas);
     GraphicsContext gc(&ctx);
@@ -314,8 +440,88 @@ EXPORT void benchmark(const char* url, int reloadCount, int width, int height) {
     delete enc;
 
     // Tear down the world.
-    frame->loader()->detachFromParent();
-    delete page;
+    destroyBenchmarkFrame(frame.release());
+}
+
+static bool runScriptFile(Frame* frame, const char* path)
+{
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        LOGE("Could not open %s", path);
+        return false;
+    }
+    Vector<char> contents;
+    char buffer[4096];
+    size_t read;
+    while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0)
+        contents.append(buffer, read);
+    fclose(file);
+
+    String source = String::fromUTF8(contents.data(), contents.size());
+    frame->script()->executeScript(ScriptSourceCode(source, KURL(ParsedURLString, String("file://") + path)));
+    return true;
+}
+
+static String scriptEngineDescription(const char* engineFlags)
+{
+#if USE(V8)
+    return String::format("v8 %s flags '%s'", v8::V8::GetVersion(), engineFlags ? engineFlags : "");
+#else
+    // The JavaScriptCore tiers are chosen when building, see wtf/Platform.h.
+    String description("jsc");
+#if ENABLE(JIT)
+    description += " jit";
+#else
+    description += " interpreter";
+#endif
+#if ENABLE(DFG_JIT)
+    description += " dfg";
+#endif
+#if ENABLE(YARR_JIT)
+    description += " yarr-jit";
+#endif
+    return description;
+#endif
+}
+
+// Runs each test script in a fresh document, after the prelude scripts, and
+// reports its run time together with the script heap it left behind.
+// engineFlags are passed to V8 so one build can compare, for instance,
+// --nocrankshaft against the default.
+EXPORT void scriptBenchmark(const char** preludes, int preludeCount, const char** tests, int testCount, int iterations, const char* engineFlags, FILE* out) {
+#if USE(V8)
+    if (engineFlags)
+        v8::V8::SetFlagsFromString(engineFlags, strlen(engineFlags));
+#endif
+    MyJavaSharedClient client;
+    RefPtr<Frame> frame = createBenchmarkFrame(&client, 800, 600, 0);
+
+    fprintf(out, "# %s\n", scriptEngineDescription(engineFlags).utf8().data());
+    fprintf(out, "test,iteration,ms,used_heap_kb,total_heap_kb\n");
+    for (int iteration = 0; iteration < iterations; ++iteration) {
+        for (int i = 0; i < testCount; ++i) {
+            ResourceRequest req(KURL(ParsedURLString, "about:blank"));
+            frame->loader()->load(req, false);
+            serviceUntilIdle(frame.get(), client);
+            for (int j = 0; j < preludeCount; ++j)
+                runScriptFile(frame.get(), preludes[j]);
+
+            double start = currentTimeMS();
+            if (!runScriptFile(frame.get(), tests[i]))
+                continue;
+            double ms = currentTimeMS() - start;
+
+            size_t usedHeapSize = 0;
+            size_t totalHeapSize = 0;
+            size_t heapSizeLimit = 0;
+            ScriptGCEvent::getHeapSize(usedHeapSize, totalHeapSize, heapSizeLimit);
+            fprintf(out, "%s,%d,%.3f,%d,%d\n", tests[i], iteration, ms,
+                    static_cast<int>(usedHeapSize / 1024), static_cast<int>(totalHeapSize / 1024));
+            fflush(out);
+        }
+    }
+
+    destroyBenchmarkFrame(frame.release());
 }
 
 }  // namespace android
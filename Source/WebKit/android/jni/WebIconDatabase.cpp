@@ -41,6 +41,7 @@
 #include <JNIUtility.h>
 #include <SharedBuffer.h>
 #include <SkBitmap.h>
+#include <SkBitmapRef.h>
 #include <SkImageDecoder.h>
 #include <SkTemplates.h>
 #include <pthread.h>
@@ -55,6 +56,13 @@ jobject webcoreImageToJavaBitmap(JNIEnv* env, WebCore::Image* icon)
     if (!icon)
         return NULL;
     SkBitmap bm;
+    // Share the pixels the image cache has already decoded. The Java bitmap
+    // holds its own reference to them, so they outlive the WebCore image.
+    SkBitmapRef* decoded = icon->nativeImageForCurrentFrame();
+    if (decoded && decoded->bitmap().pixelRef()) {
+        bm = decoded->bitmap();
+        return GraphicsJNI::createBitmap(env, new SkBitmap(bm), false, NULL);
+    }
     WebCore::SharedBuffer* buffer = icon->data();
     if (!buffer || !SkImageDecoder::DecodeMemory(buffer->data(), buffer->size(),
                                                  &bm, SkBitmap::kNo_Config,
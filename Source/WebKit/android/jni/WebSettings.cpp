@@ -74,6 +74,10 @@ namespace android {
 
 static const int permissionFlags660 = S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP;
 
+// A couple of image heavy pages would otherwise pin most of the heap while
+// they sit in the back/forward cache.
+static const unsigned pageCacheMemoryCapacity = 16 * 1024 * 1024;
+
 struct FieldIds {
     FieldIds(JNIEnv* env, jclass clazz) {
         mLayoutAlgorithm = env->GetFieldID(clazz, "mLayoutAlgorithm",
@@ -148,6 +152,7 @@ struct FieldIds {
         mUseDoubleTree = env->GetFieldID(clazz, "mUseDoubleTree", "Z");
         mPageCacheCapacity = env->GetFieldID(clazz, "mPageCacheCapacity", "I");
         mWOFFEnabled = env->GetFieldID(clazz, "mWOFFEnabled", "Z");
+        mDeferOffscreenFrameLoads = env->GetFieldID(clazz, "mDeferOffscreenFrameLoads", "Z");
 #if ENABLE(WEBGL)
         mWebGLEnabled = env->GetFieldID(clazz, "mWebGLEnabled", "Z");
 #endif
@@ -214,6 +219,7 @@ struct FieldIds {
         LOG_ASSERT(mUseDoubleTree, "Could not find field mUseDoubleTree");
         LOG_ASSERT(mPageCacheCapacity, "Could not find field mPageCacheCapacity");
         LOG_ASSERT(mWOFFEnabled, "Could not find field mWOFFEnabled");
+        LOG_ASSERT(mDeferOffscreenFrameLoads, "Could not find field mDeferOffscreenFrameLoads");
 #if ENABLE(WEBGL)
         LOG_ASSERT(mWebGLEnabled, "Could not find field mWebGLEnabled");
 #endif
@@ -268,6 +274,7 @@ struct FieldIds {
     jfieldID mUseDoubleTree;
     jfieldID mPageCacheCapacity;
     jfieldID mWOFFEnabled;
+    jfieldID mDeferOffscreenFrameLoads;
 #if ENABLE(WEBGL)
     jfieldID mWebGLEnabled;
 #endif
@@ -582,12 +589,16 @@ public:
         if (size > 0) {
             s->setUsesPageCache(true);
             WebCore::pageCache()->setCapacity(size);
+            WebCore::pageCache()->setMemoryCapacity(pageCacheMemoryCapacity);
         } else
             s->setUsesPageCache(false);
 
         flag = env->GetBooleanField(obj, gFieldIds->mWOFFEnabled);
         s->setWOFFEnabled(flag);
 
+        flag = env->GetBooleanField(obj, gFieldIds->mDeferOffscreenFrameLoads);
+        s->setDeferOffscreenFrameLoads(flag);
+
 #if ENABLE(WEBGL)
         flag = env->GetBooleanField(obj, gFieldIds->mWebGLEnabled);
         s->setWebGLEnabled(flag);
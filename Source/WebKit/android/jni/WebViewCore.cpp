@@ -80,7 +80,9 @@
 #include "HistoryItem.h"
 #include "HitTestRequest.h"
 #include "HitTestResult.h"
+#include "IdleWork.h"
 #include "InlineTextBox.h"
+#include "MemoryPressure.h"
 #include "MemoryUsage.h"
 #include "NamedNodeMap.h"
 #include "Navigator.h"
@@ -116,6 +118,7 @@
 #include "SkPicture.h"
 #include "SkUtils.h"
 #include "Text.h"
+#include "TraceEventAndroid.h"
 #include "TypingCommand.h"
 #include "WebCache.h"
 #include "WebCoreFrameBridge.h"
@@ -128,12 +131,16 @@
 
 #include <JNIHelp.h>
 #include <JNIUtility.h>
+#include <algorithm>
 #include <ui/KeycodeLabels.h>
 #include <wtf/CurrentTime.h>
 #include <wtf/text/AtomicString.h>
 #include <wtf/text/StringImpl.h>
 
 #if USE(V8)
+#if ENABLE(JAVA_BRIDGE)
+#include "JavaNPObjectV8.h"
+#endif
 #include "ScriptController.h"
 #include "V8Counters.h"
 #include "V8Binding.h"
@@ -158,7 +165,11 @@ FILE* gRenderTreeFile = 0;
 #endif
 
 #ifdef ANDROID_INSTRUMENT
+#include "CSSStyleSelector.h"
 #include "TimeCounter.h"
+#if USE(CHROME_NETWORK_STACK)
+#include "NetworkPredictor.h"
+#endif
 #endif
 
 #if USE(ACCELERATED_COMPOSITING)
@@ -186,6 +197,11 @@ FILE* gRenderTreeFile = 0;
  */
 #define PICT_RECORD_FLAGS   SkPicture::kUsePathBoundsForClip_RecordingFlag
 
+// Once the pictures on screen are recorded, rebuilding the rest stops after
+// this long (in seconds): what is left is recorded after returning to the
+// message loop, see WebViewCore::rebuildPictureSet().
+#define PICTURE_SET_SLICE_TIME 0.03
+
 ////////////////////////////////////////////////////////////////////////////////////////////////
 
 namespace android {
@@ -398,6 +414,19 @@ WebViewCore::WebViewCore(JNIEnv* env, jobject javaWebViewCore, WebCore::Frame* m
     , m_cacheMode(0)
     , m_shouldPaintCaret(true)
     , m_pluginInvalTimer(this, &WebViewCore::pluginInvalTimerFired)
+    , m_frameCacheTimer(this, &WebViewCore::frameCacheTimerFired)
+    , m_frameCacheDeferredSince(0)
+    , m_coalescedInputTimer(this, &WebViewCore::coalescedInputTimerFired)
+    , m_touchMoveDispatched(false)
+    , m_touchMovePrevented(false)
+    , m_pendingTouchMove(false)
+    , m_pendingTouchMetaState(0)
+    , m_pendingScroll(false)
+    , m_pendingScrollEvent(false)
+    , m_pendingScrollVisibleScreen(false)
+    , m_pendingScrollGeneration(0)
+    , m_hitTestCacheGeneration(0)
+    , m_invalGeneration(0)
     , m_screenOnCounter(0)
     , m_currentNodeDomNavigationAxis(0)
     , m_deviceMotionAndOrientationManager(this)
@@ -406,6 +435,7 @@ WebViewCore::WebViewCore(JNIEnv* env, jobject javaWebViewCore, WebCore::Frame* m
 #endif
 #if USE(CHROME_NETWORK_STACK)
     , m_webRequestContext(0)
+    , m_loadTimingObserver(0)
 #endif
 {
     LOG_ASSERT(m_mainFrame, "Uh oh, somehow a frameview was made without an initial frame!");
@@ -566,6 +596,7 @@ WebCore::Node* WebViewCore::currentFocus()
 
 void WebViewCore::recordPicture(SkPicture* picture)
 {
+    ANDROID_TRACE_EVENT("webkit", "WebViewCore::recordPicture");
     // if there is no document yet, just return
     if (!m_mainFrame->document()) {
         DBG_NAV_LOG("no document");
@@ -592,12 +623,13 @@ void WebViewCore::recordPicture(SkPicture* picture)
 
 void WebViewCore::recordPictureSet(PictureSet* content)
 {
+    ANDROID_TRACE_EVENT("webkit", "WebViewCore::recordPictureSet");
     // if there is no document yet, just return
     if (!m_mainFrame->document()) {
         DBG_SET_LOG("!m_mainFrame->document()");
         return;
     }
-    if (m_addInval.isEmpty()) {
+    if (m_addInval.isEmpty() && m_deferredInval.isEmpty()) {
         DBG_SET_LOG("m_addInval.isEmpty()");
         return;
     }
@@ -710,7 +742,17 @@ void WebViewCore::recordPictureSet(PictureSet* content)
     content->setDimensions(width, height, &m_addInval);
 
     // Add the current inval rects to the PictureSet, and rebuild it.
-    content->add(m_addInval, 0, 0, false);
+    if (!m_addInval.isEmpty())
+        content->add(m_addInval, 0, 0, false);
+
+    // Rebuild the pictureset (webkit repaint)
+    SkRegion deferred;
+    rebuildPictureSet(content, &deferred);
+    // What an earlier slice left over and this one recorded is drawn now;
+    // what is still left over is drawn by the slice that records it
+    m_addInval.op(m_deferredInval, SkRegion::kUnion_Op);
+    m_addInval.op(deferred, SkRegion::kDifference_Op);
+    m_deferredInval.swap(deferred);
 
     // If we have too many invalidations, just get the area bounds
     SkRegion::Iterator iterator(m_addInval);
@@ -725,9 +767,6 @@ void WebViewCore::recordPictureSet(PictureSet* content)
         SkIRect r = m_addInval.getBounds();
         m_addInval.setRect(r);
     }
-
-    // Rebuild the pictureset (webkit repaint)
-    rebuildPictureSet(content);
     } // WebViewCoreRecordTimeCounter
 
     WebCore::Node* oldFocusNode = currentFocus();
@@ -774,6 +813,11 @@ void WebViewCore::recordPictureSet(PictureSet* content)
     {
         return;
     }
+    bool onlyDomChanged = m_lastFocused == oldFocusNode
+        && m_lastFocusedBounds == oldBounds
+        && m_lastFocusedSelStart == oldSelStart
+        && m_lastFocusedSelEnd == oldSelEnd
+        && !m_findIsUp;
     m_focusBoundsChanged |= m_lastFocused == oldFocusNode
         && m_lastFocusedBounds != oldBounds;
     m_lastFocused = oldFocusNode;
@@ -781,6 +825,12 @@ void WebViewCore::recordPictureSet(PictureSet* content)
     m_lastFocusedSelStart = oldSelStart;
     m_lastFocusedSelEnd = oldSelEnd;
     m_domtree_version = latestVersion;
+    if (onlyDomChanged) {
+        // nothing the user interacts with moved, the rebuild can wait for
+        // the page to stop mutating
+        scheduleFrameCacheUpdate();
+        return;
+    }
     DBG_NAV_LOG("call updateFrameCache");
     updateFrameCache();
     if (m_findIsUp) {
@@ -828,6 +878,7 @@ void WebViewCore::clearContent()
     DBG_SET_LOG("");
     m_content.clear();
     m_addInval.setEmpty();
+    m_deferredInval.setEmpty();
     m_rebuildInval.setEmpty();
 }
 
@@ -864,7 +915,24 @@ SkPicture* WebViewCore::rebuildPicture(const SkIRect& inval)
     return picture;
 }
 
-void WebViewCore::rebuildPictureSet(PictureSet* pictureSet)
+#ifndef FAST_PICTURESET
+namespace {
+struct PendingPicture {
+    int mDistance; // from the visible rect, 0 if on screen
+    size_t mIndex;
+    bool operator<(const PendingPicture& other) const {
+        return mDistance < other.mDistance
+            || (mDistance == other.mDistance && mIndex < other.mIndex);
+    }
+};
+}
+#endif
+
+// Without deferred, every picture out of date is recorded. Otherwise the
+// ones on screen are recorded first, then the others by distance from the
+// screen until PICTURE_SET_SLICE_TIME runs out; the bounds of the pictures
+// left unrecorded are added to deferred.
+void WebViewCore::rebuildPictureSet(PictureSet* pictureSet, SkRegion* deferred)
 {
     WebCore::FrameView* view = m_mainFrame->view();
 
@@ -883,15 +951,39 @@ void WebViewCore::rebuildPictureSet(PictureSet* pictureSet)
     }
     buckets->clear();
 #else
+    pictureSet->splitIntoCells();
+    SkIRect visible;
+    visible.set(m_scrollOffsetX, m_scrollOffsetY,
+        m_scrollOffsetX + m_screenWidth, m_scrollOffsetY + m_screenHeight);
+    WTF::Vector<PendingPicture> pending;
     size_t size = pictureSet->size();
     for (size_t index = 0; index < size; index++) {
         if (pictureSet->upToDate(index))
             continue;
+        const SkIRect& bounds = pictureSet->bounds(index);
+        int dx = std::max(visible.fLeft - bounds.fRight, bounds.fLeft - visible.fRight);
+        int dy = std::max(visible.fTop - bounds.fBottom, bounds.fTop - visible.fBottom);
+        PendingPicture picture = { std::max(0, std::max(dx, dy)), index };
+        pending.append(picture);
+    }
+    std::sort(pending.begin(), pending.end());
+
+    double deadline = WTF::currentTime() + PICTURE_SET_SLICE_TIME;
+    for (size_t i = 0; i < pending.size(); i++) {
+        size_t index = pending[i].mIndex;
         const SkIRect& inval = pictureSet->bounds(index);
+        if (deferred && pending[i].mDistance && WTF::currentTime() >= deadline) {
+            deferred->op(inval, SkRegion::kUnion_Op);
+            continue;
+        }
         DBG_SET_LOGD("pictSet=%p [%d] {%d,%d,w=%d,h=%d}", pictureSet, index,
             inval.fLeft, inval.fTop, inval.width(), inval.height());
         pictureSet->setPicture(index, rebuildPicture(inval));
     }
+    if (deferred && !deferred->isEmpty())
+        DBG_SET_LOGD("deferred {%d,%d,r=%d,b=%d}",
+            deferred->getBounds().fLeft, deferred->getBounds().fTop,
+            deferred->getBounds().fRight, deferred->getBounds().fBottom);
 
     pictureSet->validate(__FUNCTION__);
 #endif
@@ -971,6 +1063,8 @@ BaseLayerAndroid* WebViewCore::createBaseLayer(SkRegion* region)
 
 BaseLayerAndroid* WebViewCore::recordContent(SkRegion* region, SkIPoint* point)
 {
+    // Layout, animations and loading all end up recording new content.
+    IdleWork::noteActivity();
     DBG_SET_LOG("start");
     // If there is a pending style recalculation, just return.
     if (m_mainFrame->document()->isPendingStyleRecalc()) {
@@ -998,6 +1092,9 @@ BaseLayerAndroid* WebViewCore::recordContent(SkRegion* region, SkIPoint* point)
         region->getBounds().fBottom);
     DBG_SET_LOG("end");
 
+    // come back for the pictures left over once the queued messages ran
+    if (!m_deferredInval.isEmpty())
+        contentDraw();
     return createBaseLayer(region);
 }
 
@@ -1010,6 +1107,12 @@ void WebViewCore::splitContent(PictureSet* content)
     content->split(&m_content);
     rebuildPictureSet(&m_content);
     content->set(m_content);
+    // this recorded what earlier slices left over, which still needs drawing
+    if (!m_deferredInval.isEmpty()) {
+        m_addInval.op(m_deferredInval, SkRegion::kUnion_Op);
+        m_deferredInval.setEmpty();
+        contentDraw();
+    }
 #endif // FAST_PICTURESET
 }
 
@@ -1062,8 +1165,15 @@ void WebViewCore::contentDraw()
     checkException(env);
 }
 
+void WebViewCore::drawPendingInvals()
+{
+    if (!m_addInval.isEmpty() && !m_skipContentDraw)
+        contentDraw();
+}
+
 void WebViewCore::layersDraw()
 {
+    ++m_invalGeneration;
     JNIEnv* env = JSC::Bindings::getJNIEnv();
     AutoJObject javaObject = m_javaGlue->object(env);
     if (!javaObject.get())
@@ -1078,11 +1188,15 @@ void WebViewCore::contentInvalidate(const WebCore::IntRect &r)
     SkIRect rect(r);
     if (!rect.intersect(0, 0, INT_MAX, INT_MAX))
         return;
+    ++m_invalGeneration;
     m_addInval.op(rect, SkRegion::kUnion_Op);
     DBG_SET_LOGD("m_addInval={%d,%d,r=%d,b=%d}",
         m_addInval.getBounds().fLeft, m_addInval.getBounds().fTop,
         m_addInval.getBounds().fRight, m_addInval.getBounds().fBottom);
-    if (!m_skipContentDraw)
+    // While the page is hidden the inval accumulates in m_addInval and is
+    // recorded in one pass on resume, so there is no point waking the UI
+    // thread to record pictures nobody will see.
+    if (!m_skipContentDraw && m_mainFrame->page()->isVisible())
         contentDraw();
 }
 
@@ -1253,6 +1367,7 @@ void WebViewCore::doMaxScroll(CacheBuilder::Direction dir)
 
 void WebViewCore::setScrollOffset(int moveGeneration, bool sendScrollEvent, int dx, int dy)
 {
+    IdleWork::noteActivity();
     DBG_NAV_LOGD("{%d,%d} m_scrollOffset=(%d,%d), sendScrollEvent=%d", dx, dy,
         m_scrollOffsetX, m_scrollOffsetY, sendScrollEvent);
     if (m_scrollOffsetX != dx || m_scrollOffsetY != dy) {
@@ -1263,28 +1378,45 @@ void WebViewCore::setScrollOffset(int moveGeneration, bool sendScrollEvent, int
         // testing work correctly.
         m_mainFrame->view()->platformWidget()->setLocation(m_scrollOffsetX,
                 m_scrollOffsetY);
-        if (sendScrollEvent) {
-            m_mainFrame->eventHandler()->sendScrollEvent();
-
-            // Only update history position if it's user scrolled.
-            // Update history item to reflect the new scroll position.
-            // This also helps save the history information when the browser goes to
-            // background, so scroll position will be restored if browser gets
-            // killed while in background.
-            WebCore::HistoryController* history = m_mainFrame->loader()->history();
-            // Because the history item saving could be heavy for large sites and
-            // scrolling can generate lots of small scroll offset, the following code
-            // reduces the saving frequency.
-            static const int MIN_SCROLL_DIFF = 32;
-            if (history->currentItem()) {
-                WebCore::IntPoint currentPoint = history->currentItem()->scrollPoint();
-                if (std::abs(currentPoint.x() - dx) >= MIN_SCROLL_DIFF ||
-                    std::abs(currentPoint.y() - dy) >= MIN_SCROLL_DIFF) {
-                    history->saveScrollPositionAndViewStateToItem(history->currentItem());
-                }
+        m_pendingScrollEvent |= sendScrollEvent;
+        m_pendingScrollVisibleScreen = true;
+    }
+    // The scroll events, history update, plugin screen and cursor move are
+    // only needed for the latest offset, so a burst of scrolls queued behind
+    // a busy WebCore thread runs them once
+    m_pendingScroll = true;
+    m_pendingScrollGeneration = moveGeneration;
+    scheduleCoalescedInput();
+}
+
+void WebViewCore::scrollOffsetSettled()
+{
+    if (m_pendingScrollEvent) {
+        m_pendingScrollEvent = false;
+        m_mainFrame->eventHandler()->sendScrollEvent();
+        m_mainFrame->view()->loadDeferredFramesNearViewport();
+
+        // Only update history position if it's user scrolled.
+        // Update history item to reflect the new scroll position.
+        // This also helps save the history information when the browser goes to
+        // background, so scroll position will be restored if browser gets
+        // killed while in background.
+        WebCore::HistoryController* history = m_mainFrame->loader()->history();
+        // Because the history item saving could be heavy for large sites and
+        // scrolling can generate lots of small scroll offset, the following code
+        // reduces the saving frequency.
+        static const int MIN_SCROLL_DIFF = 32;
+        if (history->currentItem()) {
+            WebCore::IntPoint currentPoint = history->currentItem()->scrollPoint();
+            if (std::abs(currentPoint.x() - m_scrollOffsetX) >= MIN_SCROLL_DIFF ||
+                std::abs(currentPoint.y() - m_scrollOffsetY) >= MIN_SCROLL_DIFF) {
+                history->saveScrollPositionAndViewStateToItem(history->currentItem());
             }
         }
+    }
 
+    if (m_pendingScrollVisibleScreen) {
+        m_pendingScrollVisibleScreen = false;
         // update the currently visible screen
         sendPluginVisibleScreen();
     }
@@ -1295,8 +1427,50 @@ void WebViewCore::setScrollOffset(int moveGeneration, bool sendScrollEvent, int
     gCursorBoundsMutex.unlock();
     if (!hasCursorBounds)
         return;
-    moveMouseIfLatest(moveGeneration, frame, location.x(), location.y());
+    moveMouseIfLatest(m_pendingScrollGeneration, frame, location.x(), location.y());
+}
+
+void WebViewCore::scheduleCoalescedInput()
+{
+    if (!m_coalescedInputTimer.isActive())
+        m_coalescedInputTimer.startOneShot(0);
+}
+
+void WebViewCore::flushCoalescedInput()
+{
+    m_coalescedInputTimer.stop();
+    if (m_pendingScroll) {
+        m_pendingScroll = false;
+        scrollOffsetSettled();
+    }
+    if (m_pendingTouchMove) {
+        m_pendingTouchMove = false;
+        Vector<int> ids;
+        Vector<IntPoint> points;
+        ids.swap(m_pendingTouchIds);
+        points.swap(m_pendingTouchPoints);
+        m_touchMovePrevented = dispatchTouchEvent(2, ids, points, 0,
+            m_pendingTouchMetaState);
+    }
+}
+
+#ifdef ANDROID_LAYOUT
+// Marks the boxes that a text wrap width change can rewrap, so layout reaches
+// them without forcing every other block in the page to relayout its lines.
+static void markBoxesAffectedByTextWrapWidthChange(WebCore::Frame* mainFrame, int oldWidth, int newWidth)
+{
+    WebCore::Settings* settings = mainFrame->settings();
+    if (!settings || settings->layoutAlgorithm() != WebCore::Settings::kLayoutFitColumnToScreen)
+        return;
+
+    for (WebCore::Frame* frame = mainFrame; frame; frame = frame->tree()->traverseNext()) {
+        for (WebCore::RenderObject* renderer = frame->contentRenderer(); renderer; renderer = renderer->nextInPreOrder()) {
+            if (renderer->isBox() && WebCore::toRenderBox(renderer)->isAffectedByTextWrapWidthChange(oldWidth, newWidth))
+                renderer->setNeedsLayout(true);
+        }
+    }
 }
+#endif
 
 void WebViewCore::setGlobalBounds(int x, int y, int h, int v)
 {
@@ -1383,6 +1557,10 @@ void WebViewCore::setSizeScreenWidthAndScale(int width, int height,
                 m_mainFrame->view()->setFixedLayoutSize(IntSize(width, height));
             } else
                 m_mainFrame->view()->setUseFixedLayout(false);
+#ifdef ANDROID_LAYOUT
+            if (otw && textWrapWidth && otw != textWrapWidth)
+                markBoxesAffectedByTextWrapWidthChange(m_mainFrame, otw, textWrapWidth);
+#endif
             r->setNeedsLayoutAndPrefWidthsRecalc();
             if (m_mainFrame->view()->didFirstLayout())
                 m_mainFrame->view()->forceLayout();
@@ -1467,6 +1645,19 @@ void WebViewCore::dumpRenderTree(bool useFile)
         }
     }
 #endif
+#ifdef ANDROID_INSTRUMENT
+    // The most expensive selectors since the last dump, one per line.
+    WTF::CString selectorDump = WebCore::CSSStyleSelector::reportSelectorStatistics().utf8();
+    const char* selectorData = selectorDump.data();
+    int selectorLength = selectorDump.length();
+    for (int i = 0, last = 0; i < selectorLength; i++) {
+        if (selectorData[i] == '\n') {
+            if (i != last)
+                LOGD("%.*s", (i - last), &(selectorData[last]));
+            last = i + 1;
+        }
+    }
+#endif
 }
 
 void WebViewCore::dumpNavTree()
@@ -1476,13 +1667,59 @@ void WebViewCore::dumpNavTree()
 #endif
 }
 
+unsigned WebViewCore::hitTestGeneration() const
+{
+    // Scroll positions go both ways, so mix the values instead of summing
+    // them like the nav cache does with the DOM versions.
+    unsigned generation = m_invalGeneration;
+    for (Frame* frame = m_mainFrame; frame; frame = frame->tree()->traverseNext()) {
+        const Document* doc = frame->document();
+        if (!doc)
+            continue;
+        generation = generation * 31 + static_cast<unsigned>(doc->domTreeVersion());
+        generation = generation * 31 + doc->styleVersion();
+        if (FrameView* view = frame->view()) {
+            generation = generation * 31 + view->layoutCount();
+            generation = generation * 31 + view->scrollX();
+            generation = generation * 31 + view->scrollY();
+        }
+    }
+    return generation;
+}
+
+static const size_t maxCachedHitTests = 4;
+
+// ReadOnly hit tests have no side effects, so a cached result is as good as
+// walking the layers again.
+HitTestResult WebViewCore::rectBasedHitTest(const IntPoint& point, int padding)
+{
+    unsigned generation = hitTestGeneration();
+    if (generation != m_hitTestCacheGeneration) {
+        m_hitTestCache.clear();
+        m_hitTestCacheGeneration = generation;
+    }
+    for (size_t i = 0; i < m_hitTestCache.size(); ++i) {
+        if (m_hitTestCache[i].m_point == point && m_hitTestCache[i].m_padding == padding)
+            return m_hitTestCache[i].m_result;
+    }
+
+    HitTestResult result = m_mainFrame->eventHandler()->hitTestResultAtPoint(point,
+            false, false, DontHitTestScrollbars, HitTestRequest::Active | HitTestRequest::ReadOnly,
+            IntSize(padding, padding));
+    if (m_hitTestCache.size() == maxCachedHitTests)
+        m_hitTestCache.remove(0);
+    CachedHitTest entry;
+    entry.m_point = point;
+    entry.m_padding = padding;
+    entry.m_result = result;
+    m_hitTestCache.append(entry);
+    return result;
+}
+
 HTMLElement* WebViewCore::retrieveElement(int x, int y,
     const QualifiedName& tagName)
 {
-    HitTestResult hitTestResult = m_mainFrame->eventHandler()
-        ->hitTestResultAtPoint(IntPoint(x, y), false, false,
-        DontHitTestScrollbars, HitTestRequest::Active | HitTestRequest::ReadOnly,
-        IntSize(1, 1));
+    HitTestResult hitTestResult = rectBasedHitTest(IntPoint(x, y), 1);
     if (!hitTestResult.innerNode() || !hitTestResult.innerNode()->inDocument()) {
         LOGE("Should not happen: no in document Node found");
         return 0;
@@ -1617,8 +1854,31 @@ void WebViewCore::updateCacheOnNodeChange()
     updateFrameCache();
 }
 
+// Delay after the last DOM change before the nav cache is rebuilt...
+#define FRAME_CACHE_DELAY 0.1
+// ...unless a rebuild has been pending for that long
+#define FRAME_CACHE_MAX_DELAY 0.5
+
+void WebViewCore::scheduleFrameCacheUpdate()
+{
+    double now = WTF::currentTime();
+    if (!m_frameCacheDeferredSince)
+        m_frameCacheDeferredSince = now;
+    else if (now - m_frameCacheDeferredSince >= FRAME_CACHE_MAX_DELAY) {
+        DBG_NAV_LOG("deferred updateFrameCache for too long");
+        updateFrameCache();
+        return;
+    }
+    DBG_NAV_LOG("defer updateFrameCache");
+    m_frameCacheTimer.startOneShot(FRAME_CACHE_DELAY);
+}
+
 void WebViewCore::updateFrameCache()
 {
+    // any caller needing the cache also takes care of a deferred rebuild
+    m_frameCacheTimer.stop();
+    m_frameCacheDeferredSince = 0;
+
     if (!m_frameCacheOutOfDate) {
         DBG_NAV_LOG("!m_frameCacheOutOfDate");
         return;
@@ -1715,8 +1975,7 @@ Vector<IntRect> WebViewCore::getTouchHighlightRects(int x, int y, int slop)
 {
     Vector<IntRect> rects;
     m_mousePos = IntPoint(x - m_scrollOffsetX, y - m_scrollOffsetY);
-    HitTestResult hitTestResult = m_mainFrame->eventHandler()->hitTestResultAtPoint(IntPoint(x, y),
-            false, false, DontHitTestScrollbars, HitTestRequest::Active | HitTestRequest::ReadOnly, IntSize(slop, slop));
+    HitTestResult hitTestResult = rectBasedHitTest(IntPoint(x, y), slop);
     if (!hitTestResult.innerNode() || !hitTestResult.innerNode()->inDocument()) {
         LOGE("Should not happen: no in document Node found");
         return rects;
@@ -1977,10 +2236,15 @@ void WebViewCore::drawPlugins()
 
     for (; iter < stop; ++iter) {
         PluginWidgetAndroid* w = *iter;
+        // off screen plugins stay dirty and are redrawn once scrolled into view
+        if (!w->isOnScreen())
+            continue;
         SkIRect dirty;
         if (w->isDirty(&dirty)) {
             w->draw();
-            inval.op(dirty, SkRegion::kUnion_Op);
+            // composited plugins update their layer directly
+            if (!w->getLayer())
+                inval.op(dirty, SkRegion::kUnion_Op);
         }
     }
 
@@ -2215,20 +2479,25 @@ String WebViewCore::modifySelection(const int direction, const int axis)
         return String();
     if (selection->rangeCount() > 1)
         selection->removeAllRanges();
+    String markup;
     switch (axis) {
         case AXIS_CHARACTER:
         case AXIS_WORD:
         case AXIS_SENTENCE:
-            return modifySelectionTextNavigationAxis(selection, direction, axis);
+            markup = modifySelectionTextNavigationAxis(selection, direction, axis);
+            break;
         case AXIS_HEADING:
         case AXIS_SIBLING:
         case AXIS_PARENT_FIRST_CHILD:
         case AXIS_DOCUMENT:
-            return modifySelectionDomNavigationAxis(selection, direction, axis);
+            markup = modifySelectionDomNavigationAxis(selection, direction, axis);
+            break;
         default:
             LOGE("Invalid navigation axis: %d", axis);
-            return String();
+            break;
     }
+    m_hiddenByStyleCache.clear();
+    return markup;
 }
 
 void WebViewCore::scrollNodeIntoView(Frame* frame, Node* node)
@@ -2612,11 +2881,11 @@ void WebViewCore::advanceAnchorNode(DOMSelection* selection, int direction,
 
 bool WebViewCore::isContentInputElement(Node* node)
 {
-  return (isVisible(node)
-          && (node->hasTagName(WebCore::HTMLNames::selectTag)
+  return ((node->hasTagName(WebCore::HTMLNames::selectTag)
           || node->hasTagName(WebCore::HTMLNames::aTag)
           || node->hasTagName(WebCore::HTMLNames::inputTag)
-          || node->hasTagName(WebCore::HTMLNames::buttonTag)));
+          || node->hasTagName(WebCore::HTMLNames::buttonTag))
+          && isVisible(node));
 }
 
 bool WebViewCore::isContentTextNode(Node* node)
@@ -2624,7 +2893,7 @@ bool WebViewCore::isContentTextNode(Node* node)
    if (!node || !node->isTextNode())
        return false;
    Text* textNode = static_cast<Text*>(node);
-   return (isVisible(textNode) && textNode->length() > 0
+   return (textNode->length() > 0 && isVisible(textNode)
        && !textNode->containsOnlyWhitespace());
 }
 
@@ -2712,7 +2981,7 @@ String WebViewCore::modifySelectionDomNavigationAxis(DOMSelection* selection, in
             else
                 currentNode = currentNode->traversePreviousNode(body);
         } while (currentNode && (currentNode->isTextNode()
-            || !isVisible(currentNode) || !isHeading(currentNode)));
+            || !isHeading(currentNode) || !isVisible(currentNode)));
     } else if (axis == AXIS_PARENT_FIRST_CHILD) {
         if (direction == DIRECTION_FORWARD) {
             currentNode = currentNode->firstChild();
@@ -2794,18 +3063,35 @@ bool WebViewCore::isVisible(Node* node)
     if (element->offsetHeight() == 0 || element->offsetWidth() == 0) {
         return false;
     }
-    // check style
+    return !isHiddenByStyle(element);
+}
+
+bool WebViewCore::isHiddenByStyle(Node* node)
+{
+    // Walk up until an ancestor with a known answer, then record the
+    // answer for every node on the way so that siblings and descendants
+    // visited later stop at their parent.
     Node* body = m_mainFrame->document()->body();
-    Node* currentNode = element;
-    while (currentNode && currentNode != body) {
+    Vector<Node*, 32> path;
+    bool hidden = false;
+    for (Node* currentNode = node; currentNode && currentNode != body;
+            currentNode = currentNode->parentNode()) {
+        HashMap<Node*, bool>::iterator it = m_hiddenByStyleCache.find(currentNode);
+        if (it != m_hiddenByStyleCache.end()) {
+            hidden = it->second;
+            break;
+        }
+        path.append(currentNode);
         RenderStyle* style = currentNode->computedStyle();
         if (style &&
                 (style->display() == NONE || style->visibility() == HIDDEN)) {
-            return false;
+            hidden = true;
+            break;
         }
-        currentNode = currentNode->parentNode();
     }
-    return true;
+    for (size_t i = 0; i < path.size(); ++i)
+        m_hiddenByStyleCache.set(path[i], hidden);
+    return hidden;
 }
 
 String WebViewCore::formatMarkup(DOMSelection* selection)
@@ -2945,11 +3231,26 @@ void WebViewCore::passToJs(int generation, const WTF::String& current,
     // selection.
     EditorClientAndroid* client = static_cast<EditorClientAndroid*>(
             m_mainFrame->editor()->client());
+    RefPtr<WebCore::Document> document = focus->document();
+    uint64_t domTreeVersion = document->domTreeVersion();
     client->setUiGeneratedSelectionChange(true);
     key(event);
     client->setUiGeneratedSelectionChange(false);
     m_blockTextfieldUpdates = false;
     m_textGeneration = generation;
+    // Collecting the text walks every node of the control, which is slow
+    // for large textareas; skip it when the key did not touch the DOM.
+    if (document->domTreeVersion() == domTreeVersion) {
+        DBG_NAV_LOG("dom unchanged");
+        updateTextSelection();
+        m_shouldPaintCaret = true;
+        return;
+    }
+    renderer = focus->renderer();
+    if (!renderer || (!renderer->isTextField() && !renderer->isTextArea())) {
+        clearTextEntry();
+        return;
+    }
     WebCore::RenderTextControl* renderText =
         static_cast<WebCore::RenderTextControl*>(renderer);
     WTF::String test = renderText->text();
@@ -3109,6 +3410,7 @@ void WebViewCore::listBoxRequest(WebCoreReply* reply, const uint16_t** labels, s
 
 bool WebViewCore::key(const PlatformKeyboardEvent& event)
 {
+    IdleWork::noteActivity();
     WebCore::EventHandler* eventHandler;
     WebCore::Node* focusNode = currentFocus();
     DBG_NAV_LOGD("keyCode=%s unichar=%d focusNode=%p",
@@ -3169,6 +3471,29 @@ GraphicsLayerAndroid* WebViewCore::graphicsRootLayer() const
 #endif
 
 bool WebViewCore::handleTouchEvent(int action, Vector<int>& ids, Vector<IntPoint>& points, int actionIndex, int metaState)
+{
+    IdleWork::noteActivity();
+    if (action == 2 && m_touchMoveDispatched) { // MotionEvent.ACTION_MOVE
+        if (m_pendingTouchMove)
+            DBG_NAV_LOG("coalesced touch move");
+        m_pendingTouchIds = ids;
+        m_pendingTouchPoints = points;
+        m_pendingTouchMetaState = metaState;
+        m_pendingTouchMove = true;
+        scheduleCoalescedInput();
+        return m_touchMovePrevented;
+    }
+    flushCoalescedInput();
+    bool preventDefault = dispatchTouchEvent(action, ids, points, actionIndex, metaState);
+    if (action == 2) {
+        m_touchMoveDispatched = true;
+        m_touchMovePrevented = preventDefault;
+    } else if (action == 0 || action == 1 || action == 3) // down, up, cancel
+        m_touchMoveDispatched = false;
+    return preventDefault;
+}
+
+bool WebViewCore::dispatchTouchEvent(int action, Vector<int>& ids, Vector<IntPoint>& points, int actionIndex, int metaState)
 {
     bool preventDefault = false;
 
@@ -4068,7 +4393,9 @@ static jboolean Key(JNIEnv *env, jobject obj, jint keyCode, jint unichar,
 #ifdef ANDROID_INSTRUMENT
     TimeCounterAuto counter(TimeCounter::WebViewCoreTimeCounter);
 #endif
-    return GET_NATIVE_VIEW(env, obj)->key(PlatformKeyboardEvent(keyCode,
+    WebViewCore* viewImpl = GET_NATIVE_VIEW(env, obj);
+    viewImpl->flushCoalescedInput();
+    return viewImpl->key(PlatformKeyboardEvent(keyCode,
         unichar, repeatCount, isDown, isShift, isAlt, isSym));
 }
 
@@ -4080,6 +4407,7 @@ static void Click(JNIEnv *env, jobject obj, int framePtr, int nodePtr, jboolean
     WebViewCore* viewImpl = GET_NATIVE_VIEW(env, obj);
     LOG_ASSERT(viewImpl, "viewImpl not set in Click");
 
+    viewImpl->flushCoalescedInput();
     viewImpl->click(reinterpret_cast<WebCore::Frame*>(framePtr),
         reinterpret_cast<WebCore::Node*>(nodePtr), fake);
 }
@@ -4175,10 +4503,10 @@ static void SaveDocumentState(JNIEnv *env, jobject obj, jint frame)
     viewImpl->saveDocumentState((WebCore::Frame*) frame);
 }
 
-void WebViewCore::addVisitedLink(const UChar* string, int length)
+void WebViewCore::addVisitedLinkHashes(const WTF::Vector<WebCore::LinkHash>& hashes)
 {
     if (m_groupForVisitedLinks)
-        m_groupForVisitedLinks->addVisitedLink(string, length);
+        m_groupForVisitedLinks->addVisitedLinkHashes(hashes);
 }
 
 static bool UpdateLayers(JNIEnv *env, jobject obj, jint nativeClass, jint jbaseLayer)
@@ -4314,6 +4642,7 @@ static void TouchUp(JNIEnv *env, jobject obj, jint touchGeneration,
 #endif
     WebViewCore* viewImpl = GET_NATIVE_VIEW(env, obj);
     LOG_ASSERT(viewImpl, "viewImpl not set in %s", __FUNCTION__);
+    viewImpl->flushCoalescedInput();
     viewImpl->touchUp(touchGeneration,
         (WebCore::Frame*) frame, (WebCore::Node*) node, x, y);
 }
@@ -4362,6 +4691,7 @@ static void MoveFocus(JNIEnv *env, jobject obj, jint framePtr, jint nodePtr)
 #endif
     WebViewCore* viewImpl = GET_NATIVE_VIEW(env, obj);
     LOG_ASSERT(viewImpl, "viewImpl not set in %s", __FUNCTION__);
+    viewImpl->flushCoalescedInput();
     viewImpl->moveFocus((WebCore::Frame*) framePtr, (WebCore::Node*) nodePtr);
 }
 
@@ -4373,6 +4703,7 @@ static void MoveMouse(JNIEnv *env, jobject obj, jint frame,
 #endif
     WebViewCore* viewImpl = GET_NATIVE_VIEW(env, obj);
     LOG_ASSERT(viewImpl, "viewImpl not set in %s", __FUNCTION__);
+    viewImpl->flushCoalescedInput();
     viewImpl->moveMouse((WebCore::Frame*) frame, x, y);
 }
 
@@ -4384,6 +4715,7 @@ static void MoveMouseIfLatest(JNIEnv *env, jobject obj, jint moveGeneration,
 #endif
     WebViewCore* viewImpl = GET_NATIVE_VIEW(env, obj);
     LOG_ASSERT(viewImpl, "viewImpl not set in %s", __FUNCTION__);
+    viewImpl->flushCoalescedInput();
     viewImpl->moveMouseIfLatest(moveGeneration,
         (WebCore::Frame*) frame, x, y);
 }
@@ -4482,7 +4814,12 @@ static void DumpV8Counters(JNIEnv*, jobject)
 #if USE(V8)
 #ifdef ANDROID_INSTRUMENT
     V8Counters::dumpCounters();
+#if ENABLE(JAVA_BRIDGE)
+    JSC::Bindings::dumpJavaBridgeProfile();
+#endif
 #endif
+#if USE(CHROME_NETWORK_STACK) && defined(ANDROID_INSTRUMENT)
+    NetworkPredictor::instance()->dumpStats();
 #endif
 }
 
@@ -4599,6 +4936,8 @@ static void Pause(JNIEnv* env, jobject obj)
 
     GET_NATIVE_VIEW(env, obj)->deviceMotionAndOrientationManager()->maybeSuspendClients();
 
+    mainFrame->page()->setIsVisible(false);
+
     ANPEvent event;
     SkANP::InitEvent(&event, kLifecycle_ANPEventType);
     event.data.lifecycle.action = kPause_ANPLifecycleAction;
@@ -4631,6 +4970,9 @@ static void Resume(JNIEnv* env, jobject obj)
 
     GET_NATIVE_VIEW(env, obj)->deviceMotionAndOrientationManager()->maybeResumeClients();
 
+    mainFrame->page()->setIsVisible(true);
+    GET_NATIVE_VIEW(env, obj)->drawPendingInvals();
+
     ANPEvent event;
     SkANP::InitEvent(&event, kLifecycle_ANPEventType);
     event.data.lifecycle.action = kResume_ANPLifecycleAction;
@@ -4645,6 +4987,8 @@ static void FreeMemory(JNIEnv* env, jobject obj)
     SkANP::InitEvent(&event, kLifecycle_ANPEventType);
     event.data.lifecycle.action = kFreeMemory_ANPLifecycleAction;
     GET_NATIVE_VIEW(env, obj)->sendPluginEvent(event);
+
+    MemoryPressure::release(MemoryPressure::Critical);
 }
 
 static void ProvideVisitedHistory(JNIEnv *env, jobject obj, jobject hist)
@@ -4654,15 +4998,20 @@ static void ProvideVisitedHistory(JNIEnv *env, jobject obj, jobject hist)
 
     jobjectArray array = static_cast<jobjectArray>(hist);
 
+    // The whole history arrives at once, so hand it over as one batch and
+    // let every document restyle its links a single time.
     jsize len = env->GetArrayLength(array);
+    WTF::Vector<WebCore::LinkHash> hashes;
+    hashes.reserveCapacity(len);
     for (jsize i = 0; i < len; i++) {
         jstring item = static_cast<jstring>(env->GetObjectArrayElement(array, i));
         const UChar* str = static_cast<const UChar*>(env->GetStringChars(item, 0));
         jsize len = env->GetStringLength(item);
-        viewImpl->addVisitedLink(str, len);
+        hashes.append(WebCore::visitedLinkHash(str, len));
         env->ReleaseStringChars(item, str);
         env->DeleteLocalRef(item);
     }
+    viewImpl->addVisitedLinkHashes(hashes);
 }
 
 static void PluginSurfaceReady(JNIEnv* env, jobject obj)
@@ -32,6 +32,8 @@
 #include "DeviceMotionAndOrientationManager.h"
 #include "DOMSelection.h"
 #include "FileChooser.h"
+#include "HitTestResult.h"
+#include "LinkHash.h"
 #include "PictureSet.h"
 #include "PlatformGraphicsContext.h"
 #include "SkColor.h"
@@ -47,6 +49,7 @@
 #include <ui/KeycodeLabels.h>
 #include <ui/PixelFormat.h>
 #include <utils/threads.h>
+#include <wtf/HashMap.h>
 
 namespace WebCore {
     class Color;
@@ -99,6 +102,7 @@ namespace android {
 
     class CachedFrame;
     class CachedNode;
+    class LoadTimingObserver;
     class CachedRoot;
     class ListBoxReply;
 
@@ -162,6 +166,11 @@ namespace android {
          */
         void contentDraw();
 
+        /**
+         * Ask for a draw if invalidates piled up while the page was hidden
+         */
+        void drawPendingInvals();
+
         /**
          * copy the layers to the UI side
          */
@@ -342,10 +351,18 @@ namespace android {
         void click(WebCore::Frame* frame, WebCore::Node* node, bool fake);
 
         /**
-         * Handle touch event
+         * Handle touch event. Once a move of the current gesture has been
+         * dispatched, later moves are coalesced and handed to WebCore from a
+         * zero-delay timer, returning the previous move's preventDefault.
          */
         bool handleTouchEvent(int action, Vector<int>& ids, Vector<IntPoint>& points, int actionIndex, int metaState);
 
+        /**
+         * Deliver any coalesced touch move and deferred scroll work now.
+         * Called before input that must not overtake them.
+         */
+        void flushCoalescedInput();
+
         /**
          * Handle motionUp event from the UI thread (called touchUp in the
          * WebCore thread).
@@ -429,7 +446,7 @@ namespace android {
 
         void saveDocumentState(WebCore::Frame* frame);
 
-        void addVisitedLink(const UChar*, int);
+        void addVisitedLinkHashes(const WTF::Vector<WebCore::LinkHash>&);
 
         // TODO: I don't like this hack but I need to access the java object in
         // order to send it as a parameter to java
@@ -442,6 +459,8 @@ namespace android {
         void setBackgroundColor(SkColor c);
         void updateFrameCache();
         void updateCacheOnNodeChange();
+        // number of pictures in the recorded content, for MemoryUsage
+        size_t pictureCount() const { return m_content.size(); }
         void dumpDomTree(bool);
         void dumpRenderTree(bool);
         void dumpNavTree();
@@ -583,6 +602,10 @@ namespace android {
         void setWebRequestContextUserAgent();
         void setWebRequestContextCacheMode(int mode);
         WebRequestContext* webRequestContext();
+        // Native embedders can watch the load timeline of this page. Loads
+        // are only timed while an observer is set; it is not owned.
+        void setLoadTimingObserver(LoadTimingObserver* observer) { m_loadTimingObserver = observer; }
+        LoadTimingObserver* loadTimingObserver() const { return m_loadTimingObserver; }
 #endif
         // Attempts to scroll the layer to the x,y coordinates of rect. The
         // layer is the id of the LayerAndroid.
@@ -624,7 +647,7 @@ namespace android {
 
         void doMaxScroll(CacheBuilder::Direction dir);
         SkPicture* rebuildPicture(const SkIRect& inval);
-        void rebuildPictureSet(PictureSet* );
+        void rebuildPictureSet(PictureSet* , SkRegion* deferred = 0);
         void sendNotifyProgressFinished();
         /*
          * Handle a mouse click, either from a touch or trackball press.
@@ -638,11 +661,14 @@ namespace android {
         WebCore::HTMLElement* retrieveElement(int x, int y,
             const WebCore::QualifiedName& );
         WebCore::HTMLImageElement* retrieveImageElement(int x, int y);
+        WebCore::HitTestResult rectBasedHitTest(const WebCore::IntPoint&, int padding);
+        unsigned hitTestGeneration() const;
         // below are members responsible for accessibility support
         String modifySelectionTextNavigationAxis(DOMSelection* selection, int direction, int granularity);
         String modifySelectionDomNavigationAxis(DOMSelection* selection, int direction, int granularity);
         Text* traverseNextContentTextNode(Node* fromNode, Node* toNode ,int direction);
         bool isVisible(Node* node);
+        bool isHiddenByStyle(Node* node);
         bool isHeading(Node* node);
         String formatMarkup(DOMSelection* selection);
         void selectAt(int x, int y);
@@ -673,6 +699,7 @@ namespace android {
         int m_lastFocusedSelEnd;
         PictureSet m_content; // the set of pictures to draw
         SkRegion m_addInval; // the accumulated inval region (not yet drawn)
+        SkRegion m_deferredInval; // pictures left over by the last rebuild
         SkRegion m_rebuildInval; // the accumulated region for rebuilt pictures
         // Used in passToJS to avoid updating the UI text field until after the
         // key event has been processed.
@@ -709,8 +736,53 @@ namespace android {
             this->drawPlugins();
         }
 
+        // Rebuilds of the nav cache caused only by DOM changes are coalesced,
+        // so that a page appending content in a loop rebuilds it once
+        void scheduleFrameCacheUpdate();
+        WebCore::Timer<WebViewCore> m_frameCacheTimer;
+        void frameCacheTimerFired(WebCore::Timer<WebViewCore>*) {
+            this->updateFrameCache();
+        }
+        double m_frameCacheDeferredSince; // 0 if no rebuild is pending
+
+        // Touch moves and the side effects of scrolling arrive once per
+        // message; when the WebCore thread falls behind, only the latest is
+        // delivered, from a timer that runs after the messages already queued
+        bool dispatchTouchEvent(int action, Vector<int>& ids, Vector<IntPoint>& points, int actionIndex, int metaState);
+        void scrollOffsetSettled();
+        void scheduleCoalescedInput();
+        WebCore::Timer<WebViewCore> m_coalescedInputTimer;
+        void coalescedInputTimerFired(WebCore::Timer<WebViewCore>*) {
+            this->flushCoalescedInput();
+        }
+        bool m_touchMoveDispatched; // a move of this gesture reached WebCore
+        bool m_touchMovePrevented; // result of that move
+        bool m_pendingTouchMove;
+        Vector<int> m_pendingTouchIds;
+        Vector<IntPoint> m_pendingTouchPoints;
+        int m_pendingTouchMetaState;
+        bool m_pendingScroll;
+        bool m_pendingScrollEvent;
+        bool m_pendingScrollVisibleScreen;
+        int m_pendingScrollGeneration;
+
+        // A tap hit tests the same point several times: the highlight on
+        // touch down, then the anchor or image for a long press. The results
+        // stay valid until the DOM, style, layout, scroll position or painted
+        // content changes.
+        struct CachedHitTest {
+            WebCore::IntPoint m_point;
+            int m_padding;
+            WebCore::HitTestResult m_result;
+        };
+        Vector<CachedHitTest, 4> m_hitTestCache;
+        unsigned m_hitTestCacheGeneration;
+        unsigned m_invalGeneration; // bumped by every content or layer inval
+
         int m_screenOnCounter;
         Node* m_currentNodeDomNavigationAxis;
+        // Style visibility of the nodes visited by one modifySelection() call.
+        HashMap<Node*, bool> m_hiddenByStyleCache;
         DeviceMotionAndOrientationManager m_deviceMotionAndOrientationManager;
 
 #if ENABLE(TOUCH_EVENTS)
@@ -719,6 +791,7 @@ namespace android {
 
 #if USE(CHROME_NETWORK_STACK)
         scoped_refptr<WebRequestContext> m_webRequestContext;
+        LoadTimingObserver* m_loadTimingObserver;
 #endif
 
     };
@@ -31,10 +31,17 @@
 
 #include "CachedFrame.h"
 
+#include <algorithm>
+
 #define OFFSETOF(type, field) ((char*)&(((type*)1)->field) - (char*)1) // avoids gnu warning
 
 #define MIN_OVERLAP 3 // if rects overlap by 2 pixels or fewer, treat them as non-intersecting
 
+#define GRID_MIN_NODES 64 // frames with fewer nodes are searched linearly
+#define GRID_CELL_SIZE 256 // smallest edge of a hit-test grid cell, in pixels
+#define GRID_MAX_SPAN 128 // most cells along either edge of the grid
+#define GRID_MAX_NODE_CELLS 64 // nodes covering more cells are always checked
+
 namespace android {
 
 WebCore::IntRect CachedFrame::adjustBounds(const CachedNode* node,
@@ -65,6 +72,65 @@ WebCore::IntRect CachedFrame::adjustBounds(const CachedNode* node,
     return rect;
 }
 
+// Buckets the nodes by the grid cells their rings and hit bounds touch, so
+// that point queries only look at the nodes near the point. Nodes in layers
+// move with their layer, and nodes spanning much of the page gain nothing
+// from the grid, so both are kept in a list that every query visits.
+void CachedFrame::buildGrid()
+{
+    mGridCells.clear();
+    mGridLoose.clear();
+    mGridBounds = WebCore::IntRect();
+    mGridColumns = mGridRows = 0;
+    size_t count = mCachedNodes.size();
+    if (count < GRID_MIN_NODES)
+        return;
+    WTF::Vector<WebCore::IntRect> extents(count);
+    for (size_t index = 0; index < count; index++) {
+        const CachedNode* node = &mCachedNodes[index];
+        if (node->isInLayer())
+            continue;
+        WebCore::IntRect& extent = extents[index];
+        extent = node->rawBounds();
+        extent.unite(node->hitBounds(this));
+        size_t parts = node->navableRects();
+        for (size_t part = 0; part < parts; part++)
+            extent.unite(node->ring(this, part));
+        mGridBounds.unite(extent);
+    }
+    if (mGridBounds.isEmpty())
+        return;
+    int longest = std::max(mGridBounds.width(), mGridBounds.height());
+    mGridCellSize = std::max(GRID_CELL_SIZE,
+        (longest + GRID_MAX_SPAN - 1) / GRID_MAX_SPAN);
+    mGridColumns = (mGridBounds.width() + mGridCellSize - 1) / mGridCellSize;
+    mGridRows = (mGridBounds.height() + mGridCellSize - 1) / mGridCellSize;
+    mGridCells.resize(mGridColumns * mGridRows);
+    for (size_t index = 0; index < count; index++) {
+        if (mCachedNodes[index].isInLayer()) {
+            mGridLoose.append(index);
+            continue;
+        }
+        const WebCore::IntRect& extent = extents[index];
+        if (extent.isEmpty())
+            continue; // empty rects intersect nothing
+        int left = (extent.x() - mGridBounds.x()) / mGridCellSize;
+        int top = (extent.y() - mGridBounds.y()) / mGridCellSize;
+        int right = (extent.maxX() - 1 - mGridBounds.x()) / mGridCellSize;
+        int bottom = (extent.maxY() - 1 - mGridBounds.y()) / mGridCellSize;
+        if ((right - left + 1) * (bottom - top + 1) > GRID_MAX_NODE_CELLS) {
+            mGridLoose.append(index);
+            continue;
+        }
+        for (int row = top; row <= bottom; row++) {
+            for (int column = left; column <= right; column++)
+                mGridCells[row * mGridColumns + column].append(index);
+        }
+    }
+    DBG_NAV_LOGD("nodes=%d grid=%dx%d cell=%d loose=%d", count, mGridColumns,
+        mGridRows, mGridCellSize, mGridLoose.size());
+}
+
 bool CachedFrame::CheckBetween(Direction direction, const WebCore::IntRect& bestRect,
         const WebCore::IntRect& prior, WebCore::IntRect* result)
 {
@@ -380,7 +446,11 @@ const CachedNode* CachedFrame::findBestAt(const WebCore::IntRect& rect,
     WebCore::IntPoint center = WebCore::IntPoint(rect.x() + (rectWidth >> 1),
         rect.y() + (rect.height() >> 1));
     mRoot->setupScrolledBounds();
-    for (const CachedNode* test = mCachedNodes.begin(); test != mCachedNodes.end(); test++) {
+    WTF::Vector<int> candidates;
+    bool useGrid = gridCandidates(rect, &candidates);
+    size_t count = useGrid ? candidates.size() : mCachedNodes.size();
+    for (size_t index = 0; index < count; index++) {
+        const CachedNode* test = &mCachedNodes[useGrid ? candidates[index] : index];
         if (test->disabled())
             continue;
         size_t parts = test->navableRects();
@@ -506,8 +576,11 @@ const CachedNode* CachedFrame::findBestHitAt(const WebCore::IntRect& rect,
         if (NULL != frameResult)
             return frameResult;
     }
-    for (const CachedNode* test = mCachedNodes.end() - 1;
-            test != mCachedNodes.begin() - 1; test--) {
+    WTF::Vector<int> candidates;
+    bool useGrid = gridCandidates(rect, &candidates);
+    size_t count = useGrid ? candidates.size() : mCachedNodes.size();
+    for (size_t index = count; index-- > 0; ) {
+        const CachedNode* test = &mCachedNodes[useGrid ? candidates[index] : index];
         if (test->disabled())
             continue;
         WebCore::IntRect testRect = test->hitBounds(this);
@@ -659,6 +732,7 @@ void CachedFrame::finishInit()
         child->finishInit();
         child++;
     }
+    buildGrid();
     CachedFrame* frameParent;
     if (mFocusIndex >= 0 && (frameParent = parent()))
         frameParent->setFocusIndex(indexInParent());
@@ -910,6 +984,33 @@ const CachedNode* CachedFrame::frameUp(const CachedNode* test,
     return bestData->mNode;
 }
 
+// Collects the indices of the nodes that may intersect rect, in document
+// order. Returns false if the frame has no grid and all nodes must be checked.
+bool CachedFrame::gridCandidates(const WebCore::IntRect& rect,
+    WTF::Vector<int>* candidates) const
+{
+    if (!mGridColumns)
+        return false;
+    candidates->clear();
+    candidates->append(mGridLoose);
+    WebCore::IntRect area = rect;
+    area.intersect(mGridBounds);
+    if (!area.isEmpty()) {
+        int left = (area.x() - mGridBounds.x()) / mGridCellSize;
+        int top = (area.y() - mGridBounds.y()) / mGridCellSize;
+        int right = (area.maxX() - 1 - mGridBounds.x()) / mGridCellSize;
+        int bottom = (area.maxY() - 1 - mGridBounds.y()) / mGridCellSize;
+        for (int row = top; row <= bottom; row++) {
+            for (int column = left; column <= right; column++)
+                candidates->append(mGridCells[row * mGridColumns + column]);
+        }
+    }
+    std::sort(candidates->begin(), candidates->end());
+    int* end = std::unique(candidates->begin(), candidates->end());
+    candidates->shrink(end - candidates->begin());
+    return true;
+}
+
 CachedFrame* CachedFrame::hasFrame(const CachedNode* node)
 {
     return node->isFrame() ? &mCachedFrames[node->childFrameIndex()] : NULL;
@@ -941,6 +1042,7 @@ void CachedFrame::init(const CachedRoot* root, int childFrameIndex,
     mFrame = frame;
     mParent = NULL; // set up parents after stretchy arrays are set up
     mIndexInParent = childFrameIndex;
+    mGridColumns = mGridRows = 0;
 }
 
 #if USE(ACCELERATED_COMPOSITING)
@@ -208,12 +208,15 @@ private: // since computing these is complicated, protect them so that the
     typedef const CachedNode* (CachedFrame::*MoveInDirection)(
         const CachedNode* test, const CachedNode* limit, BestData* ) const;
     void adjustToTextColumn(int* delta) const;
+    void buildGrid();
     static bool CheckBetween(Direction , const WebCore::IntRect& bestRect, 
         const WebCore::IntRect& prior, WebCore::IntRect* result);
     bool checkBetween(BestData* , Direction );
     int compare(BestData& testData, const BestData& bestData) const;
     void findClosest(BestData* , Direction original, Direction test,
         WebCore::IntRect* clip) const;
+    bool gridCandidates(const WebCore::IntRect& ,
+        WTF::Vector<int>* candidates) const;
     int frameNodeCommon(BestData& testData, const CachedNode* test, 
         BestData* bestData, BestData* originalData) const;
     int framePartCommon(BestData& testData, const CachedNode* test, 
@@ -242,6 +245,13 @@ private: // since computing these is complicated, protect them so that the
 #if USE(ACCELERATED_COMPOSITING)
     WTF::Vector<CachedLayer> mCachedLayers;
 #endif
+    // hit-test grid over mCachedNodes, built once the frame is complete
+    WTF::Vector<WTF::Vector<int> > mGridCells;
+    WTF::Vector<int> mGridLoose; // nodes checked by every query
+    WebCore::IntRect mGridBounds;
+    int mGridCellSize;
+    int mGridColumns; // 0 if the frame is searched linearly
+    int mGridRows;
     void* mFrame; // WebCore::Frame*, used only to compare pointers
     CachedFrame* mParent;
     int mCursorIndex;
@@ -48,6 +48,7 @@ class CachedRoot : public CachedFrame {
 public:
     bool adjustForScroll(BestData* , Direction , WebCore::IntPoint* scrollPtr,
         bool findClosest);
+    SkPicture* basePicture() const { return mPicture; }
     const SkRegion& baseUncovered() const { return mBaseUncovered; }
     void calcBitBounds(const IntRect& , IntRect* ) const;
     int checkForCenter(int x, int y) const;
@@ -155,6 +155,7 @@ FindCanvas::FindCanvas(int width, int height, const UChar* lower,
     mWorkingIndex = 0;
     mWorkingCanvas = 0;
     mWorkingPicture = 0;
+    mCancelled = 0;
 }
 
 FindCanvas::~FindCanvas() {
@@ -314,6 +315,8 @@ void FindCanvas::findHelper(const void* text, size_t byteLength,
                           const SkScalar positions[], SkScalar y)) {
     SkASSERT(paint.getTextEncoding() == SkPaint::kGlyphID_TextEncoding);
     SkASSERT(mMatches);
+    if (mCancelled && *mCancelled)
+        return;
     GlyphSet* glyphSet = getGlyphs(paint);
     const int count = glyphSet->getCount();
     int numCharacters = byteLength >> 1;
@@ -498,6 +501,12 @@ void FindCanvas::insertMatchInfo(const SkRegion& region) {
     LOGD("%s region=%p pict=%p layer=%d", __FUNCTION__,
         &region, mWorkingPicture, mLayerId);
     mMatches->last().set(region, mWorkingPicture, mLayerId);
+    matchFound();
+}
+
+void FindCanvas::takeMatches(WTF::Vector<MatchInfo>* matches) {
+    matches->append(*mMatches);
+    mMatches->clear();
 }
 
 void FindCanvas::resetWorkingCanvas() {
@@ -527,6 +536,21 @@ void FindOnPage::setUpFindPaint() {
     m_isFindPaintSetUp = true;
 }
 
+// Adds matches found by a search that is still running. The current match
+// stays where it is, or becomes the first match if there was none.
+void FindOnPage::appendMatches(const WTF::Vector<MatchInfo>& matches) {
+    if (!matches.size())
+        return;
+    if (!m_matches)
+        m_matches = new WTF::Vector<MatchInfo>();
+    bool hadMatches = m_matches->size();
+    m_matches->append(matches);
+    if (!hadMatches || !m_hasCurrentLocation) {
+        m_findIndex = 0;
+        storeCurrentMatchLocation();
+    }
+}
+
 IntRect FindOnPage::currentMatchBounds() const {
     IntRect noBounds = IntRect(0, 0, 0, 0);
     if (!m_matches || !m_matches->size())
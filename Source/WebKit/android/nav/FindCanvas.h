@@ -143,8 +143,15 @@ public:
 
     void drawLayers(LayerAndroid*);
     int found() const { return mNumFound; }
+    // Text drawn after *cancelled becomes non-zero is no longer searched, so
+    // that a search running on another thread can be abandoned quickly.
+    void setCancelFlag(const volatile int32_t* cancelled) { mCancelled = cancelled; }
     void setLayerId(int layerId) { mLayerId = layerId; }
 
+    // Moves the matches found so far to the end of matches; the search can
+    // carry on afterwards.
+    void takeMatches(WTF::Vector<MatchInfo>* matches);
+
     // This method detaches our array of matches and passes ownership to
     // the caller, who is then responsible for deleting them.
     WTF::Vector<MatchInfo>* detachMatches() {
@@ -153,6 +160,10 @@ public:
         return array;
     }
 
+protected:
+    // Called after each match is stored.
+    virtual void matchFound() { }
+
 private:
     // These calls are made by findHelper to store information about each match
     // that is found.  They return a rectangle which is used to highlight the
@@ -212,6 +223,7 @@ private:
     SkRegion                mWorkingRegion;
     int                     mWorkingIndex;
     int                     mLayerId;
+    const volatile int32_t* mCancelled;
 };
 
 class FindOnPage : public DrawExtra {
@@ -223,6 +235,7 @@ public:
         m_lastBounds.setEmpty();
     }
     virtual ~FindOnPage() { if (m_matches) delete m_matches; }
+    void appendMatches(const WTF::Vector<MatchInfo>& matches);
     void clearCurrentLocation() { m_hasCurrentLocation = false; }
     IntRect currentMatchBounds() const;
     int currentMatchIndex() const { return m_findIndex; }
@@ -0,0 +1,294 @@
+/*
+ * Copyright 2012, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "FindSearch.h"
+
+#include "CachedRoot.h"
+#include "LayerAndroid.h"
+#include "SkBitmap.h"
+#include "SkPicture.h"
+
+#include <cutils/atomic.h>
+
+// Matches outside the visible rect are handed to the UI thread this many at
+// a time
+#define FIND_BATCH_SIZE 32
+
+namespace android {
+
+struct FindSearch::Request {
+    Request() : picture(0) { }
+    ~Request()
+    {
+        SkSafeUnref(picture);
+        for (size_t i = 0; i < layerPictures.size(); i++)
+            layerPictures[i]->unref();
+    }
+
+    void addLayers(const WebCore::LayerAndroid* layer)
+    {
+#if USE(ACCELERATED_COMPOSITING)
+        if (layer->picture()) {
+            layerPictures.append(new SkPicture(*layer->picture()));
+            layerIds.append(layer->uniqueId());
+        }
+        for (int i = 0; i < layer->countChildren(); i++)
+            addLayers(layer->getChild(i));
+#endif
+    }
+
+    int generation;
+    int width;
+    int height;
+    SkIRect visible;
+    WTF::Vector<UChar> lower;
+    WTF::Vector<UChar> upper;
+    SkPicture* picture;
+    // in the order CachedRoot::draw() visits them
+    WTF::Vector<SkPicture*> layerPictures;
+    WTF::Vector<int> layerIds;
+};
+
+// While streaming, every match is moved out of the FindCanvas as soon as it
+// is stored: all of them are kept for the final list, and the ones that the
+// visible pass could not have found are also batched for the UI thread.
+class FindSearch::SearchCanvas : public FindCanvas {
+public:
+    SearchCanvas(FindSearch* search, const Request* request, bool streaming)
+        : FindCanvas(request->width, request->height, request->lower.data(),
+            request->upper.data(), request->lower.size() << 1)
+        , m_search(search)
+        , m_request(request)
+        , m_streaming(streaming)
+    {
+        setCancelFlag(&search->m_cancelled);
+    }
+
+    WTF::Vector<MatchInfo>& allMatches() { return m_all; }
+
+protected:
+    virtual void matchFound()
+    {
+        if (!m_streaming)
+            return;
+        size_t index = m_all.size();
+        takeMatches(&m_all);
+        const MatchInfo& match = m_all[index];
+        if (match.isInLayer()
+                || !SkIRect::Intersects(match.getLocation().getBounds(),
+                    m_request->visible))
+            m_batch.append(match);
+        if (m_batch.size() >= FIND_BATCH_SIZE)
+            m_search->publish(m_request->generation, &m_batch, MoreMatches);
+    }
+
+private:
+    FindSearch* m_search;
+    const Request* m_request;
+    bool m_streaming;
+    WTF::Vector<MatchInfo> m_all;
+    WTF::Vector<MatchInfo> m_batch;
+};
+
+FindSearch::FindSearch()
+    : Thread(false)
+    , m_request(0)
+    , m_generation(0)
+    , m_searching(false)
+    , m_visibleDone(true)
+    , m_pending(0)
+    , m_pendingComplete(false)
+    , m_cancelled(0)
+{
+}
+
+FindSearch::~FindSearch()
+{
+    delete m_request;
+    delete m_pending;
+}
+
+void FindSearch::start(const CachedRoot* root, const SkIRect& visible,
+    const UChar* lower, const UChar* upper, int length)
+{
+    // copying a picture only shares its recorded data, so this stays cheap
+    Request* request = new Request();
+    request->width = root->documentWidth();
+    request->height = root->documentHeight();
+    request->visible = visible;
+    request->lower.append(lower, length);
+    request->upper.append(upper, length);
+    if (root->basePicture())
+        request->picture = new SkPicture(*root->basePicture());
+    if (root->rootLayer())
+        request->addLayers(root->rootLayer());
+
+    android::Mutex::Autolock lock(m_lock);
+    android_atomic_release_store(1, &m_cancelled);
+    delete m_request;
+    request->generation = ++m_generation;
+    m_request = request;
+    delete m_pending;
+    m_pending = 0;
+    m_pendingComplete = false;
+    m_searching = true;
+    m_visibleDone = false;
+    m_requestCond.signal();
+}
+
+void FindSearch::cancel()
+{
+    android::Mutex::Autolock lock(m_lock);
+    android_atomic_release_store(1, &m_cancelled);
+    m_generation++;
+    delete m_request;
+    m_request = 0;
+    delete m_pending;
+    m_pending = 0;
+    m_pendingComplete = false;
+    m_searching = false;
+    m_visibleDone = true;
+    m_visibleCond.broadcast();
+}
+
+void FindSearch::stop()
+{
+    requestExit();
+    cancel();
+    android::Mutex::Autolock lock(m_lock);
+    m_requestCond.signal();
+}
+
+bool FindSearch::isSearching()
+{
+    android::Mutex::Autolock lock(m_lock);
+    return m_searching;
+}
+
+WTF::Vector<MatchInfo>* FindSearch::takeMatches(bool* complete)
+{
+    android::Mutex::Autolock lock(m_lock);
+    WTF::Vector<MatchInfo>* matches = m_pending;
+    *complete = m_pendingComplete;
+    if (m_pendingComplete)
+        m_searching = false;
+    m_pending = 0;
+    m_pendingComplete = false;
+    return matches;
+}
+
+void FindSearch::waitForVisible(nsecs_t timeout)
+{
+    android::Mutex::Autolock lock(m_lock);
+    if (!m_visibleDone)
+        m_visibleCond.waitRelative(m_lock, timeout);
+}
+
+void FindSearch::publish(int generation, WTF::Vector<MatchInfo>* matches,
+    Stage stage)
+{
+    android::Mutex::Autolock lock(m_lock);
+    if (generation == m_generation) {
+        if (stage == AllMatches) {
+            // supersedes any batch the UI thread has not picked up yet
+            delete m_pending;
+            m_pending = new WTF::Vector<MatchInfo>();
+            m_pendingComplete = true;
+        } else if (!m_pending)
+            m_pending = new WTF::Vector<MatchInfo>();
+        m_pending->append(*matches);
+        if (stage == VisibleMatches) {
+            m_visibleDone = true;
+            m_visibleCond.broadcast();
+        }
+    }
+    matches->clear();
+}
+
+void FindSearch::search(Request* request)
+{
+    int generation = request->generation;
+    SkBitmap bitmap;
+    bitmap.setConfig(SkBitmap::kARGB_8888_Config, request->width,
+        request->height);
+
+    // Text ops recorded with their vertical bounds are skipped by the
+    // playback when they fall outside the clip, so this pass is quick
+    WTF::Vector<MatchInfo> visibleMatches;
+    if (request->picture && !request->visible.isEmpty()) {
+        SearchCanvas canvas(this, request, false);
+        canvas.setBitmapDevice(bitmap);
+        SkRect clip;
+        clip.set(request->visible);
+        canvas.clipRect(clip);
+        canvas.setLayerId(-1);
+        canvas.drawPicture(*request->picture);
+        WTF::Vector<MatchInfo> matches;
+        canvas.takeMatches(&matches);
+        for (size_t i = 0; i < matches.size(); i++) {
+            if (SkIRect::Intersects(matches[i].getLocation().getBounds(),
+                    request->visible))
+                visibleMatches.append(matches[i]);
+        }
+    }
+    publish(generation, &visibleMatches, VisibleMatches);
+
+    SearchCanvas canvas(this, request, true);
+    canvas.setBitmapDevice(bitmap);
+    canvas.setLayerId(-1);
+    if (request->picture)
+        canvas.drawPicture(*request->picture);
+    for (size_t i = 0; i < request->layerPictures.size(); i++) {
+        if (m_cancelled)
+            return;
+        canvas.setLayerId(request->layerIds[i]);
+        canvas.drawPicture(*request->layerPictures[i]);
+    }
+    if (m_cancelled)
+        return;
+    publish(generation, &canvas.allMatches(), AllMatches);
+}
+
+bool FindSearch::threadLoop()
+{
+    Request* request;
+    {
+        android::Mutex::Autolock lock(m_lock);
+        while (!m_request && !exitPending())
+            m_requestCond.wait(m_lock);
+        request = m_request;
+        m_request = 0;
+        if (request)
+            android_atomic_release_store(0, &m_cancelled);
+    }
+    if (request) {
+        search(request);
+        delete request;
+    }
+    return !exitPending();
+}
+
+} // namespace android
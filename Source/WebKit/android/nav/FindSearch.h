@@ -0,0 +1,94 @@
+/*
+ * Copyright 2012, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef FindSearch_h
+#define FindSearch_h
+
+#include "FindCanvas.h"
+#include "SkRect.h"
+
+#include <utils/threads.h>
+#include <wtf/Vector.h>
+
+namespace android {
+
+class CachedRoot;
+
+// Runs find-all on a background thread over copies of the root and layer
+// pictures, so that searching a long document does not block input on the
+// UI thread. The visible rect is searched first; the other matches are
+// handed out in batches as they are found, and the complete list, in
+// document order, replaces the batches once the search is done. Starting a
+// new search cancels the one in flight.
+class FindSearch : public Thread {
+public:
+    FindSearch();
+    virtual ~FindSearch();
+
+    // Called from the UI thread. The pictures of root and the strings are
+    // copied, so they may change or go away while the search runs.
+    void start(const CachedRoot* root, const SkIRect& visible,
+        const UChar* lower, const UChar* upper, int length);
+    void cancel();
+    // Asks the thread to exit once the current search is cancelled
+    void stop();
+
+    // Returns true until the last result of the current search is taken
+    bool isSearching();
+    // Returns the matches found since the last call, or 0 if there are none.
+    // The caller takes ownership. *complete is set when the vector holds all
+    // the matches of the search, and replaces the ones returned before.
+    WTF::Vector<MatchInfo>* takeMatches(bool* complete);
+    // Blocks for at most timeout until the visible rect has been searched
+    void waitForVisible(nsecs_t timeout);
+
+private:
+    struct Request;
+    class SearchCanvas;
+    enum Stage {
+        VisibleMatches,
+        MoreMatches,
+        AllMatches
+    };
+
+    void publish(int generation, WTF::Vector<MatchInfo>* matches, Stage stage);
+    void search(Request* request);
+    virtual bool threadLoop();
+
+    android::Mutex m_lock;
+    android::Condition m_requestCond;
+    android::Condition m_visibleCond;
+    Request* m_request; // next search to run
+    int m_generation; // bumped on each start or cancel
+    bool m_searching;
+    bool m_visibleDone;
+    WTF::Vector<MatchInfo>* m_pending;
+    bool m_pendingComplete;
+    volatile int32_t m_cancelled; // read by SearchCanvas without the lock
+};
+
+} // namespace android
+
+#endif // FindSearch_h
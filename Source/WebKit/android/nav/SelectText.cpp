@@ -228,6 +228,17 @@ public:
         return mArea;
     }
 
+    // let TextIndex make the calls the picture playback would make
+    bool indexedGlyph(const SkIRect& rect, const SkBounder::GlyphRec& rec)
+    {
+        return onIRectGlyph(rect, rec);
+    }
+
+    bool indexedRect(const SkIRect& rect)
+    {
+        return onIRect(rect);
+    }
+
     /* called only while the picture is parsed */
     SkUnichar getUniChar(const SkBounder::GlyphRec& rec)
     {
@@ -328,8 +339,8 @@ public:
         mLastPaint = check.mLastPaint;
     }
 
-    void setUp(const SkPaint& paint, const SkMatrix& matrix, SkScalar y,
-            const void* text)
+    virtual void setUp(const SkPaint& paint, const SkMatrix& matrix,
+            SkScalar y, const void* text)
     {
         mMatrix = matrix;
         mPaint = paint;
@@ -1259,7 +1270,166 @@ private:
     typedef ParseCanvas INHERITED;
 };
 
-static bool buildSelection(const SkPicture& picture, const SkIRect& area,
+// Records what a TextCanvas reports to its check while a picture plays back:
+// the text set up by each draw call, and the clipped bounds of each glyph (or
+// of the path standing in for a large glyph), in picture coordinates. A
+// replay into a check offsets and clips the records to the check's area and
+// makes the same calls as parsing the picture would, without decoding the
+// picture and measuring its glyphs again each time the selection moves.
+class TextIndex {
+public:
+    TextIndex()
+        : m_picture(0)
+    {
+    }
+
+    ~TextIndex()
+    {
+        SkSafeUnref(m_picture);
+    }
+
+    void build(const SkPicture& picture);
+    int height() const { return m_height; }
+    bool indexes(const SkPicture& picture) const
+    {
+        return m_picture == &picture && m_width == picture.width()
+            && m_height == picture.height();
+    }
+    void replay(CommonCheck* check) const;
+    int width() const { return m_width; }
+
+private:
+    class Builder;
+    enum EntryType {
+        SetUpEntry,
+        RectEntry,
+        GlyphEntry
+    };
+    struct Entry {
+        EntryType type;
+        int setUp; // index in m_setUps, for SetUpEntry
+        SkIRect rect;
+        SkBounder::GlyphRec rec; // for GlyphEntry
+    };
+    struct SetUp {
+        SkPaint paint;
+        SkMatrix matrix;
+        SkScalar y;
+    };
+
+    WTF::Vector<Entry> m_entries;
+    WTF::Vector<SetUp> m_setUps;
+    const SkPicture* m_picture; // reffed so that its address isn't reused
+    int m_width;
+    int m_height;
+};
+
+class TextIndex::Builder : public CommonCheck {
+public:
+    Builder(TextIndex* index, const SkIRect& area)
+        : INHERITED(area)
+        , mIndex(index)
+    {
+    }
+
+    virtual void setUp(const SkPaint& paint, const SkMatrix& matrix,
+            SkScalar y, const void* text)
+    {
+        INHERITED::setUp(paint, matrix, y, text);
+        SetUp setUp;
+        setUp.paint = paint;
+        setUp.matrix = matrix;
+        setUp.y = y;
+        mIndex->m_setUps.append(setUp);
+        Entry entry;
+        entry.type = SetUpEntry;
+        entry.setUp = mIndex->m_setUps.size() - 1;
+        mIndex->m_entries.append(entry);
+    }
+
+protected:
+    virtual bool onIRect(const SkIRect& rect)
+    {
+        Entry entry;
+        entry.type = RectEntry;
+        entry.rect = rect;
+        mIndex->m_entries.append(entry);
+        return false;
+    }
+
+    virtual bool onIRectGlyph(const SkIRect& rect,
+        const SkBounder::GlyphRec& rec)
+    {
+        Entry entry;
+        entry.type = GlyphEntry;
+        entry.rect = rect;
+        entry.rec = rec;
+        mIndex->m_entries.append(entry);
+        return false;
+    }
+
+private:
+    TextIndex* mIndex;
+    typedef CommonCheck INHERITED;
+};
+
+void TextIndex::build(const SkPicture& picture)
+{
+    m_entries.clear();
+    m_setUps.clear();
+    SkSafeUnref(m_picture);
+    m_picture = &picture;
+    m_picture->ref();
+    m_width = picture.width();
+    m_height = picture.height();
+    SkIRect area;
+    area.set(0, 0, m_width, m_height);
+    Builder builder(this, area);
+    TextCanvas checker(&builder);
+    checker.drawPicture(const_cast<SkPicture&>(picture));
+    m_entries.shrinkToFit();
+    m_setUps.shrinkToFit();
+    DBG_NAV_LOGD("picture=%p entries=%d setUps=%d", &picture,
+        m_entries.size(), m_setUps.size());
+}
+
+void TextIndex::replay(CommonCheck* check) const
+{
+    // a TextCanvas for the check's area is translated by the area's origin
+    // and clipped to its size
+    const SkIRect& area = check->getArea();
+    SkIRect clip;
+    clip.set(0, 0, area.width(), area.height());
+    SkFixed dx = SkIntToFixed(area.fLeft);
+    SkFixed dy = SkIntToFixed(area.fTop);
+    const Entry* end = m_entries.end();
+    for (const Entry* entry = m_entries.begin(); entry != end; entry++) {
+        if (entry->type == SetUpEntry) {
+            const SetUp& setUp = m_setUps[entry->setUp];
+            SkMatrix matrix = setUp.matrix;
+            matrix.postTranslate(SkIntToScalar(-area.fLeft),
+                SkIntToScalar(-area.fTop));
+            check->setUp(setUp.paint, matrix, setUp.y, 0);
+            continue;
+        }
+        SkIRect rect = entry->rect;
+        rect.offset(-area.fLeft, -area.fTop);
+        if (!rect.intersect(clip))
+            continue;
+        if (entry->type == RectEntry) {
+            check->indexedRect(rect);
+            continue;
+        }
+        SkBounder::GlyphRec rec = entry->rec;
+        rec.fLSB.fX -= dx;
+        rec.fLSB.fY -= dy;
+        rec.fRSB.fX -= dx;
+        rec.fRSB.fY -= dy;
+        check->indexedGlyph(rect, rec);
+    }
+}
+
+static bool buildSelection(const TextIndex& index, const SkIRect& area,
         const SkIRect& selStart, int startBase,
         const SkIRect& selEnd, int endBase, SkRegion* region)
 {
@@ -1269,45 +1439,39 @@ static bool buildSelection(const SkPicture& picture, const SkIRect& area,
         selStart.fLeft, selStart.fTop, selStart.fRight, selStart.fBottom,
         selEnd.fLeft, selEnd.fTop, selEnd.fRight, selEnd.fBottom);
     MultilineBuilder builder(selStart, startBase, selEnd, endBase, area, region);
-    TextCanvas checker(&builder);
-    checker.drawPicture(const_cast<SkPicture&>(picture));
+    index.replay(&builder);
     bool flipped = builder.flipped();
-    if (flipped) {
-        TextCanvas checker(&builder);
-        checker.drawPicture(const_cast<SkPicture&>(picture));
-    }
+    if (flipped)
+        index.replay(&builder);
     builder.finish();
     region->translate(area.fLeft, area.fTop);
     return flipped;
 }
 
-static SkIRect findFirst(const SkPicture& picture, int* base)
+static SkIRect findFirst(const TextIndex& index, int* base)
 {
     SkIRect area;
-    area.set(0, 0, picture.width(), picture.height());
+    area.set(0, 0, index.width(), index.height());
     FindFirst finder(area);
-    TextCanvas checker(&finder);
-    checker.drawPicture(const_cast<SkPicture&>(picture));
+    index.replay(&finder);
     return finder.bestBounds(base);
 }
 
-static SkIRect findLast(const SkPicture& picture, int* base)
+static SkIRect findLast(const TextIndex& index, int* base)
 {
     SkIRect area;
-    area.set(0, 0, picture.width(), picture.height());
+    area.set(0, 0, index.width(), index.height());
     FindLast finder(area);
-    TextCanvas checker(&finder);
-    checker.drawPicture(const_cast<SkPicture&>(picture));
+    index.replay(&finder);
     return finder.bestBounds(base);
 }
 
-static WTF::String text(const SkPicture& picture, const SkIRect& area,
+static WTF::String text(const TextIndex& index, const SkIRect& area,
         const SkIRect& start, int startBase, const SkIRect& end,
         int endBase, bool flipped)
 {
     TextExtractor extractor(start, startBase, end, endBase, area, flipped);
-    TextCanvas checker(&extractor);
-    checker.drawPicture(const_cast<SkPicture&>(picture));
+    index.replay(&extractor);
     return extractor.text();
 }
 
@@ -1330,6 +1494,7 @@ SelectText::SelectText()
     , m_controlSlop(CONTROL_SLOP)
 {
     m_picture = 0;
+    m_textIndex = 0;
     reset();
     SkPaint paint;
     SkRect oval;
@@ -1408,6 +1573,7 @@ SelectText::SelectText()
 SelectText::~SelectText()
 {
     SkSafeUnref(m_picture);
+    delete m_textIndex;
 }
 
 void SelectText::draw(SkCanvas* canvas, LayerAndroid* layer, IntRect* inval)
@@ -1492,7 +1658,7 @@ void SelectText::getSelectionRegion(const IntRect& vis, SkRegion *region,
     ivisBounds.join(m_selStart);
     ivisBounds.join(m_selEnd);
     region->setEmpty();
-    buildSelection(*m_picture, ivisBounds, m_selStart, m_startBase,
+    buildSelection(textIndex(*m_picture), ivisBounds, m_selStart, m_startBase,
         m_selEnd, m_endBase, region);
     if (root && m_layerId) {
         Layer* layer = root->findById(m_layerId);
@@ -1520,8 +1686,8 @@ void SelectText::drawSelectionRegion(SkCanvas* canvas, IntRect* inval)
         m_lastSelRegion.set(m_selRegion);
     SkRegion diff(m_lastSelRegion);
     m_selRegion.setEmpty();
-    m_flipped = buildSelection(*m_picture, ivisBounds, m_selStart, m_startBase,
-        m_selEnd, m_endBase, &m_selRegion);
+    m_flipped = buildSelection(textIndex(*m_picture), ivisBounds, m_selStart,
+        m_startBase, m_selEnd, m_endBase, &m_selRegion);
     SkPath path;
     m_selRegion.getBoundaryPath(&path);
     path.setFillType(SkPath::kEvenOdd_FillType);
@@ -1611,7 +1777,7 @@ void SelectText::extendSelection(const IntRect& vis, int x, int y)
             clipRect.inset(-m_visibleRect.width(), -m_visibleRect.height());
         }
         FirstCheck center(m_original.fX, m_original.fY, clipRect);
-        m_selStart = m_selEnd = findClosest(center, *m_picture, &base);
+        m_selStart = m_selEnd = findClosest(center, textIndex(*m_picture), &base);
         if (m_selStart.isEmpty())
             return;
         DBG_NAV_LOGD("selStart clip=(%d,%d,%d,%d) m_original=%d,%d"
@@ -1636,7 +1802,7 @@ void SelectText::extendSelection(const IntRect& vis, int x, int y)
         clipRect.fLeft, clipRect.fTop, clipRect.fRight, clipRect.fBottom, x, y,
         m_wordSelection ? "true" : "false", m_outsideWord ? "true" : "false");
     FirstCheck extension(x, y, clipRect);
-    SkIRect found = findClosest(extension, *m_picture, &base);
+    SkIRect found = findClosest(extension, textIndex(*m_picture), &base);
     if (m_wordSelection) {
         SkIRect wordBounds = m_wordBounds;
         if (!m_outsideWord)
@@ -1675,21 +1841,19 @@ void SelectText::extendSelection(const IntRect& vis, int x, int y)
     swapAsNeeded();
 }
 
-SkIRect SelectText::findClosest(FirstCheck& check, const SkPicture& picture,
+SkIRect SelectText::findClosest(FirstCheck& check, const TextIndex& index,
         int* base)
 {
     LineCheck lineCheck(check.focusX(), check.focusY(), check.getArea());
-    TextCanvas lineChecker(&lineCheck);
-    lineChecker.drawPicture(const_cast<SkPicture&>(picture));
+    index.replay(&lineCheck);
     lineCheck.finish(m_selRegion);
     check.setLines(&lineCheck);
-    TextCanvas checker(&check);
-    checker.drawPicture(const_cast<SkPicture&>(picture));
+    index.replay(&check);
     check.finishGlyph();
     return check.adjustedBounds(base);
 }
 
-SkIRect SelectText::findEdge(const SkPicture& picture, const SkIRect& area,
+SkIRect SelectText::findEdge(const TextIndex& index, const SkIRect& area,
         int x, int y, bool left, int* base)
 {
     SkIRect result;
@@ -1697,7 +1861,7 @@ SkIRect SelectText::findEdge(const SkPicture& picture, const SkIRect& area,
     FirstCheck center(x, y, area);
     center.setRecordGlyph();
     int closestBase;
-    SkIRect closest = findClosest(center, picture, &closestBase);
+    SkIRect closest = findClosest(center, index, &closestBase);
     SkIRect sloppy = closest;
     sloppy.inset(-TOUCH_SLOP, -TOUCH_SLOP);
     if (!sloppy.contains(x, y)) {
@@ -1708,10 +1872,9 @@ SkIRect SelectText::findEdge(const SkPicture& picture, const SkIRect& area,
     }
     EdgeCheck edge(x, y, area, center, left);
     do { // detect left or right until there's a gap
-        DBG_NAV_LOGD("edge=%p picture=%p area=%d,%d,%d,%d",
-            &edge, &picture, area.fLeft, area.fTop, area.fRight, area.fBottom);
-        TextCanvas checker(&edge);
-        checker.drawPicture(const_cast<SkPicture&>(picture));
+        DBG_NAV_LOGD("edge=%p index=%p area=%d,%d,%d,%d",
+            &edge, &index, area.fLeft, area.fTop, area.fRight, area.fBottom);
+        index.replay(&edge);
         edge.finishGlyph();
         if (!edge.adjacent()) {
             if (result.isEmpty()) {
@@ -1744,16 +1907,16 @@ SkIRect SelectText::findEdge(const SkPicture& picture, const SkIRect& area,
     return result;
 }
 
-SkIRect SelectText::findLeft(const SkPicture& picture, const SkIRect& area,
+SkIRect SelectText::findLeft(const TextIndex& index, const SkIRect& area,
         int x, int y, int* base)
 {
-    return findEdge(picture, area, x, y, true, base);
+    return findEdge(index, area, x, y, true, base);
 }
 
-SkIRect SelectText::findRight(const SkPicture& picture, const SkIRect& area,
+SkIRect SelectText::findRight(const TextIndex& index, const SkIRect& area,
         int x, int y, int* base)
 {
-    return findEdge(picture, area, x, y, false, base);
+    return findEdge(index, area, x, y, false, base);
 }
 
 const String SelectText::getSelection()
@@ -1762,7 +1925,7 @@ const String SelectText::getSelection()
         return String();
     SkIRect clipRect;
     clipRect.set(0, 0, m_picture->width(), m_picture->height());
-    String result = text(*m_picture, clipRect, m_selStart, m_startBase,
+    String result = text(textIndex(*m_picture), clipRect, m_selStart, m_startBase,
         m_selEnd, m_endBase, m_flipped);
     DBG_NAV_LOGD("clip=(%d,%d,%d,%d)"
         " m_selStart=(%d, %d, %d, %d) m_selEnd=(%d, %d, %d, %d)",
@@ -1860,7 +2023,7 @@ void SelectText::moveSelection(const IntRect& vis, int x, int y)
     clipRect.join(m_selEnd);
     FirstCheck center(x, y, clipRect);
     int base;
-    SkIRect found = findClosest(center, *m_picture, &base);
+    SkIRect found = findClosest(center, textIndex(*m_picture), &base);
     if (m_hitTopLeft || !m_extendSelection) {
         m_startBase = base;
         m_selStart = found;
@@ -1906,7 +2069,7 @@ IntPoint SelectText::selectableText(const CachedRoot* root)
     IntRect vis(0, 0, width, height);
     FirstCheck center(width >> 1, height >> 1, vis);
     int base;
-    const SkIRect& closest = findClosest(center, *picture, &base);
+    const SkIRect& closest = findClosest(center, textIndex(*picture), &base);
     return IntPoint((closest.fLeft + closest.fRight) >> 1,
         (closest.fTop + closest.fBottom) >> 1);
 }
@@ -1915,8 +2078,8 @@ void SelectText::selectAll()
 {
     if (!m_picture)
         return;
-    m_selStart = findFirst(*m_picture, &m_startBase);
-    m_selEnd = findLast(*m_picture, &m_endBase);
+    m_selStart = findFirst(textIndex(*m_picture), &m_startBase);
+    m_selEnd = findLast(textIndex(*m_picture), &m_endBase);
     m_extendSelection = true;
 }
 
@@ -2016,7 +2179,7 @@ bool SelectText::wordSelection(const CachedRoot* root, const IntRect& vis,
         m_selEnd.fLeft, m_selEnd.fTop, m_selEnd.fRight, m_selEnd.fBottom,
         ivisBounds.fLeft, ivisBounds.fTop, ivisBounds.fRight, ivisBounds.fBottom);
     m_selRegion.setEmpty();
-    buildSelection(*m_picture, ivisBounds, m_selStart, m_startBase,
+    buildSelection(textIndex(*m_picture), ivisBounds, m_selStart, m_startBase,
         m_selEnd, m_endBase, &m_selRegion);
     x = m_selStart.fLeft;
     y = (m_selStart.fTop + m_selStart.fBottom) >> 1;
@@ -2024,7 +2187,7 @@ bool SelectText::wordSelection(const CachedRoot* root, const IntRect& vis,
     clipRect.fLeft -= m_visibleRect.width() >> 1;
     clipRect.fLeft = std::max(clipRect.fLeft, 0);
     int base;
-    SkIRect left = findLeft(*m_picture, clipRect, x, y, &base);
+    SkIRect left = findLeft(textIndex(*m_picture), clipRect, x, y, &base);
     if (!left.isEmpty()) {
         m_startBase = base;
         m_selStart = left;
@@ -2033,7 +2196,7 @@ bool SelectText::wordSelection(const CachedRoot* root, const IntRect& vis,
     y = (m_selEnd.fTop + m_selEnd.fBottom) >> 1;
     clipRect = m_visibleRect;
     clipRect.fRight += m_visibleRect.width() >> 1;
-    SkIRect right = findRight(*m_picture, clipRect, x, y, &base);
+    SkIRect right = findRight(textIndex(*m_picture), clipRect, x, y, &base);
     if (!right.isEmpty()) {
         m_endBase = base;
         m_selEnd = right;
@@ -2051,6 +2214,17 @@ bool SelectText::wordSelection(const CachedRoot* root, const IntRect& vis,
     return false;
 }
 
+// Selection gestures parse the same picture over and over; index its text
+// the first time and replay the index afterwards.
+const TextIndex& SelectText::textIndex(const SkPicture& picture)
+{
+    if (!m_textIndex)
+        m_textIndex = new TextIndex();
+    if (!m_textIndex->indexes(picture))
+        m_textIndex->build(picture);
+    return *m_textIndex;
+}
+
 void SelectText::swapAsNeeded()
 {
     if (m_selStart.fTop >= (m_selEnd.fTop + m_selEnd.fBottom) >> 1
@@ -38,6 +38,7 @@
 namespace android {
 
 class CachedRoot;
+class TextIndex;
 
 class SelectText : public DrawExtra {
 public:
@@ -72,12 +73,12 @@ private:
     class EdgeCheck;
     void drawSelectionPointer(SkCanvas* , IntRect* );
     void drawSelectionRegion(SkCanvas* , IntRect* );
-    SkIRect findClosest(FirstCheck& , const SkPicture& , int* base);
-    SkIRect findEdge(const SkPicture& , const SkIRect& area,
+    SkIRect findClosest(FirstCheck& , const TextIndex& , int* base);
+    SkIRect findEdge(const TextIndex& , const SkIRect& area,
         int x, int y, bool left, int* base);
-    SkIRect findLeft(const SkPicture& picture, const SkIRect& area,
+    SkIRect findLeft(const TextIndex& index, const SkIRect& area,
         int x, int y, int* base);
-    SkIRect findRight(const SkPicture& picture, const SkIRect& area,
+    SkIRect findRight(const TextIndex& index, const SkIRect& area,
         int x, int y, int* base);
     static void getSelectionArrow(SkPath* );
     void getSelectionCaret(SkPath* );
@@ -86,6 +87,7 @@ private:
     bool hitEndHandle(int x, int y) const;
     void setVisibleRect(const IntRect& );
     void swapAsNeeded();
+    const TextIndex& textIndex(const SkPicture& );
     SkIPoint m_original; // computed start of extend selection
     SkIPoint m_startOffset; // difference from global to layer
     SkIRect m_selStart;
@@ -104,6 +106,7 @@ private:
     SkPicture m_startControl;
     SkPicture m_endControl;
     const SkPicture* m_picture;
+    TextIndex* m_textIndex; // text of the last picture parsed
     bool m_drawPointer;
     bool m_extendSelection; // false when trackball is moving pointer
     bool m_flipped;
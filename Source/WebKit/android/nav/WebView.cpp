@@ -35,12 +35,15 @@
 #include "CachedRoot.h"
 #include "DrawExtra.h"
 #include "FindCanvas.h"
+#include "FindSearch.h"
 #include "Frame.h"
 #include "GraphicsJNI.h"
 #include "HTMLInputElement.h"
 #include "IntPoint.h"
 #include "IntRect.h"
 #include "LayerAndroid.h"
+#include "MemoryPressure.h"
+#include "MemoryUsage.h"
 #include "Node.h"
 #include "utils/Functor.h"
 #include "private/hwui/DrawGlInfo.h"
@@ -89,6 +92,10 @@
 #define TRIM_MEMORY_UI_HIDDEN 20
 // Duration to show the pressed cursor ring
 #define PRESSED_STATE_DURATION 400
+// How long find-all waits for the matches of the visible rect, in ns
+#define FIND_VISIBLE_TIMEOUT 100000000
+// How often the results of a background find are merged while it runs, in ms
+#define FIND_POLL_DELAY 50
 
 namespace android {
 
@@ -209,6 +216,9 @@ WebView(JNIEnv* env, jobject javaWebView, int viewImpl, WTF::String drawableDir,
     m_baseLayer = 0;
     m_glDrawFunctor = 0;
     m_isDrawingPaused = false;
+    m_findInBackground = false;
+    m_findSameAsLastSearch = false;
+    m_findShownFirst = false;
     m_buttonSkin = drawableDir.isEmpty() ? 0 : new RenderSkinButton(drawableDir);
 #if USE(ACCELERATED_COMPOSITING)
     m_glWebViewState = 0;
@@ -234,6 +244,8 @@ WebView(JNIEnv* env, jobject javaWebView, int viewImpl, WTF::String drawableDir,
     // deallocated base layer.
     stopGL();
 #endif
+    if (m_findSearch.get())
+        m_findSearch->stop();
     delete m_frameCacheUI;
     delete m_navPictureUI;
     SkSafeUnref(m_baseLayer);
@@ -489,6 +501,7 @@ bool drawGL(WebCore::IntRect& viewRect, WebCore::IntRect* invalRect,
     DrawExtra* extra = 0;
     switch (extras) {
         case DrawExtrasFind:
+            updateFindResults();
             extra = &m_findOnPage;
             break;
         case DrawExtrasSelection:
@@ -578,6 +591,7 @@ PictureSet* draw(SkCanvas* canvas, SkColor bgColor, int extras, bool split)
     DrawExtra* extra = 0;
     switch (extras) {
         case DrawExtrasFind:
+            updateFindResults();
             extra = &m_findOnPage;
             break;
         case DrawExtrasSelection:
@@ -1146,14 +1160,91 @@ void setFindIsUp(bool up)
 {
     DBG_NAV_LOGD("up=%d", up);
     m_viewImpl->m_findIsUp = up;
+    if (!up && m_findSearch.get())
+        m_findSearch->cancel();
 }
 
 void setFindIsEmpty()
 {
     DBG_NAV_LOG("");
+    if (m_findSearch.get())
+        m_findSearch->cancel();
     m_findOnPage.clearCurrentLocation();
 }
 
+bool findInBackground() const { return m_findInBackground; }
+
+void setFindInBackground(bool background)
+{
+    m_findInBackground = background;
+    if (!background && m_findSearch.get())
+        m_findSearch->cancel();
+}
+
+// Starts a find-all on the FindSearch thread, and waits briefly for the
+// matches in the visible rect so that the first one shows right away. The
+// other matches are merged in by updateFindResults() as the view redraws.
+int findAllInBackground(CachedRoot* root, const UChar* lower,
+    const UChar* upper, int length, bool sameAsLastSearch)
+{
+    if (!m_findSearch.get()) {
+        m_findSearch = new FindSearch();
+        m_findSearch->run("FindSearch", PRIORITY_BACKGROUND);
+    }
+    // a different search must not leave the old matches up meanwhile
+    if (!sameAsLastSearch)
+        m_findOnPage.setMatches(new WTF::Vector<MatchInfo>());
+    m_findSameAsLastSearch = sameAsLastSearch;
+    m_findShownFirst = false;
+    IntRect visible = setVisibleRect(root);
+    m_findSearch->start(root, visible, lower, upper, length);
+    m_findSearch->waitForVisible(FIND_VISIBLE_TIMEOUT);
+    updateFindResults();
+    return findMatchCount();
+}
+
+int findMatchCount()
+{
+    if (findIsSearching() && !m_findShownFirst)
+        return 0;
+    WTF::Vector<MatchInfo>* matches = m_findOnPage.matches();
+    return matches ? matches->size() : 0;
+}
+
+bool findIsSearching()
+{
+    return m_findSearch.get() && m_findSearch->isSearching();
+}
+
+// Merges the matches a background find has streamed in since the last call,
+// and keeps the view redrawing until it is done.
+void updateFindResults()
+{
+    if (!findIsSearching())
+        return;
+    bool complete;
+    WTF::Vector<MatchInfo>* matches = m_findSearch->takeMatches(&complete);
+    if (matches) {
+        if (!m_findShownFirst && (complete || matches->size())) {
+            // replaces the matches of the previous search
+            m_findShownFirst = true;
+            setMatches(matches, m_findSameAsLastSearch);
+        } else if (complete) {
+            // the full list is in document order, and keeps the current match
+            m_findOnPage.setMatches(matches);
+            viewInvalidate();
+        } else {
+            m_findOnPage.appendMatches(*matches);
+            delete matches;
+            viewInvalidate();
+        }
+    }
+    if (m_findSearch->isSearching()) {
+        // views assume that inval bounds coordinates are non-negative
+        postInvalidateDelayed(FIND_POLL_DELAY, WebCore::IntRect(0, 0, INT_MAX, INT_MAX));
+    }
+}
+
 void showCursorTimed()
 {
     DBG_NAV_LOG("");
@@ -1306,6 +1397,7 @@ void sendMotionUp(WebCore::Frame* framePtr, WebCore::Node* nodePtr, int x, int y
 
 void findNext(bool forward)
 {
+    updateFindResults();
     m_findOnPage.findNext(forward);
     scrollToCurrentMatch();
     viewInvalidate();
@@ -1606,6 +1698,10 @@ private: // local state for WebView
     SkMSec m_lastDxTime;
     SelectText m_selectText;
     FindOnPage m_findOnPage;
+    sp<FindSearch> m_findSearch; // created by the first background find-all
+    bool m_findInBackground;
+    bool m_findSameAsLastSearch;
+    bool m_findShownFirst; // the current background find has shown results
     CursorRing m_ring;
     BaseLayerAndroid* m_baseLayer;
     Functor* m_glDrawFunctor;
@@ -2396,6 +2492,15 @@ static int nativeFindAll(JNIEnv *env, jobject obj, jstring findLower,
         checkException(env);
         return 0;
     }
+    if (view->findInBackground()) {
+        int found = view->findAllInBackground(root,
+            (const UChar*) findLowerChars, (const UChar*) findUpperChars,
+            length, sameAsLastSearch);
+        env->ReleaseStringChars(findLower, findLowerChars);
+        env->ReleaseStringChars(findUpper, findUpperChars);
+        checkException(env);
+        return found;
+    }
     int width = root->documentWidth();
     int height = root->documentHeight();
     // Create a FindCanvas, which allows us to fake draw into it so we can
@@ -2664,24 +2769,119 @@ static bool nativeSetProperty(JNIEnv *env, jobject obj, jstring jkey, jstring jv
             value == "true" ? CpuUpload : GpuUpload);
         return true;
     }
+    else if (key == "enable_direct_upload_path") {
+        TilesManager::instance()->transferQueue()->setTextureUploadType(
+            value == "true" ? DirectUpload : GpuUpload);
+        return true;
+    }
+    else if (key == "enable_compressed_tiles") {
+        TilesManager::instance()->transferQueue()->setTileCompression(value == "true");
+        return true;
+    }
     else if (key == "use_minimal_memory") {
         TilesManager::instance()->setUseMinimalMemory(value == "true");
         return true;
     }
+    else if (key == "ganesh_layer_text") {
+        TilesManager::instance()->setUseGaneshForLayerText(value == "true");
+        return true;
+    }
+    else if (key == "tile_paint_threads") {
+        TilesManager::instance()->setPaintThreadCount(value.toInt());
+        return true;
+    }
+    else if (key == "texture_budget_mb") {
+        TilesManager::instance()->textureBudget()->setLimit(value.toInt() * 1024 * 1024);
+        return true;
+    }
+    else if (key == "tile_prefetch_distance") {
+        TilesManager::instance()->setPrefetchDistance(value.toInt());
+        return true;
+    }
+    else if (key == "frame_timings" && value == "clear") {
+        TilesManager::instance()->frameTimings()->clear();
+        return true;
+    }
+    else if (key == "renderer_stats" && value == "clear") {
+        BaseRenderer::clearStats();
+        return true;
+    }
+    else if (key == "find_in_background") {
+        GET_NATIVE_VIEW(env, obj)->setFindInBackground(value == "true");
+        return true;
+    }
     return false;
 }
 
-static jstring nativeGetProperty(JNIEnv *env, jobject obj, jstring key)
+static jstring nativeGetProperty(JNIEnv *env, jobject obj, jstring jkey)
 {
+    WTF::String key = jstringToWtfString(env, jkey);
+    if (key == "tile_queue_stats") {
+        OperationQueueStats stats = TilesManager::instance()->gatherOperationQueueStats();
+        double averageLatency = stats.processed ? stats.totalLatency / stats.processed : 0;
+        WTF::String value = WTF::String::format(
+            "depth %d max depth %d processed %d average latency %.2fms max latency %.2fms reordered %d",
+            stats.depth, stats.maxDepth, stats.processed, averageLatency * 1000,
+            stats.maxLatency * 1000, stats.reprioritizations);
+        return wtfStringToJstring(env, value);
+    }
+    if (key == "texture_budget_stats") {
+        TextureBudget* budget = TilesManager::instance()->textureBudget();
+        WTF::String value = WTF::String::format(
+            "used %dKb (base tiles %dKb layer tiles %dKb media %dKb atlas %dKb) budget %dKb limit %dKb",
+            budget->usedBytes() / 1024,
+            budget->usedBytes(TextureBudget::BaseTileTextures) / 1024,
+            budget->usedBytes(TextureBudget::LayerTileTextures) / 1024,
+            budget->usedBytes(TextureBudget::MediaTextures) / 1024,
+            budget->usedBytes(TextureBudget::AtlasTextures) / 1024,
+            budget->budget() / 1024, budget->limit() / 1024);
+        return wtfStringToJstring(env, value);
+    }
+    if (key == "frame_timings")
+        return wtfStringToJstring(env, TilesManager::instance()->frameTimings()->dump());
+    if (key == "tile_profiling_report")
+        return wtfStringToJstring(env, TilesManager::instance()->getProfiler()->report());
+    if (key == "memory_usage") {
+        // Taken by the WebCore thread at the end of each page load.
+        MemoryUsageSnapshot last;
+        MemoryUsageSnapshot previous;
+        MemoryUsage::lastSnapshots(&last, &previous);
+        return wtfStringToJstring(env, last.dump(previous.isEmpty() ? 0 : &previous));
+    }
+    if (key == "renderer_stats")
+        return wtfStringToJstring(env, BaseRenderer::dumpStats());
+    if (key == "texture_pool")
+        return wtfStringToJstring(env, TilesManager::instance()->texturePool()->dump());
+    if (key == "find_matches") {
+        WebView* view = GET_NATIVE_VIEW(env, obj);
+        WTF::String value = WTF::String::format("%d %s", view->findMatchCount(),
+            view->findIsSearching() ? "searching" : "done");
+        return wtfStringToJstring(env, value);
+    }
     return 0;
 }
 
 static void nativeOnTrimMemory(JNIEnv *env, jobject obj, jint level)
 {
     if (TilesManager::hardwareAccelerationEnabled()) {
+        TextureBudget::Pressure pressure = TextureBudget::HiddenPressure;
+        if (level >= TRIM_MEMORY_MODERATE)
+            pressure = TextureBudget::CriticalPressure;
+        else if (level >= TRIM_MEMORY_BACKGROUND)
+            pressure = TextureBudget::BackgroundPressure;
+        TilesManager::instance()->textureBudget()->setPressure(pressure);
+
         bool freeAllTextures = (level > TRIM_MEMORY_UI_HIDDEN);
         TilesManager::instance()->deallocateTextures(freeAllTextures);
+        TilesManager::instance()->enforceTextureBudget();
     }
+
+    if (level >= TRIM_MEMORY_MODERATE)
+        MemoryPressure::notify(MemoryPressure::Critical);
+    else if (level >= TRIM_MEMORY_BACKGROUND)
+        MemoryPressure::notify(MemoryPressure::Background);
+    else if (level >= TRIM_MEMORY_UI_HIDDEN)
+        MemoryPressure::notify(MemoryPressure::UIHidden);
 }
 
 static void nativeDumpDisplayTree(JNIEnv* env, jobject jwebview, jstring jurl)
@@ -31,6 +31,8 @@
 #include "PluginWidgetAndroid.h"
 
 #include "JavaSharedClient.h"
+#include <wtf/Threading.h>
+#include <wtf/Vector.h>
 
 using namespace android;
 
@@ -40,36 +42,62 @@ struct WrappedANPEvent {
     ANPEvent                fEvent;
 };
 
+/*  Plugins may post events from any thread, often many at a time. Events are
+    queued here and delivered in one batch per hop to the WebCore thread,
+    rather than scheduling a separate function call for each of them.
+ */
+struct PendingANPEvents {
+    WTF::Mutex                  fLock;
+    Vector<WrappedANPEvent>     fEvents;
+};
+
+static PendingANPEvents& pendingEvents() {
+    AtomicallyInitializedStatic(PendingANPEvents&, pending = *new PendingANPEvents);
+    return pending;
+}
+
 /*  Its possible we may be called after the plugin that initiated the event
     has been torn-down. Thus we check that the assicated webviewcore and
-    pluginwidget are still active before dispatching the event.
+    pluginwidget are still active before dispatching each event.
  */
-static void send_anpevent(void* data) {
-    WrappedANPEvent* wrapper = static_cast<WrappedANPEvent*>(data);
-    WebViewCore* core = wrapper->fWVC;
-    PluginWidgetAndroid* widget = wrapper->fPWA;
-
-    // be sure we're still alive before delivering the event
-    if (WebViewCore::isInstance(core) && core->isPlugin(widget)) {
-        widget->sendEvent(wrapper->fEvent);
+static void send_anpevents(void*) {
+    Vector<WrappedANPEvent> events;
+    {
+        PendingANPEvents& pending = pendingEvents();
+        MutexLocker locker(pending.fLock);
+        events.swap(pending.fEvents);
+    }
+
+    for (size_t i = 0; i < events.size(); ++i) {
+        WebViewCore* core = events[i].fWVC;
+        PluginWidgetAndroid* widget = events[i].fPWA;
+
+        // be sure we're still alive before delivering the event
+        if (WebViewCore::isInstance(core) && core->isPlugin(widget)) {
+            widget->sendEvent(events[i].fEvent);
+        }
     }
-    delete wrapper;
 }
 
 static void anp_postEvent(NPP instance, const ANPEvent* event) {
     if (instance && instance->ndata && event) {
         PluginView* pluginView = static_cast<PluginView*>(instance->ndata);
         PluginWidgetAndroid* pluginWidget = pluginView->platformPluginWidget();
-        WebViewCore* wvc = pluginWidget->webViewCore();
 
-        WrappedANPEvent* wrapper = new WrappedANPEvent;
+        WrappedANPEvent wrapper;
         // recored these, and recheck that they are valid before delivery
-        // in send_anpevent
-        wrapper->fWVC = pluginWidget->webViewCore();
-        wrapper->fPWA = pluginWidget;
+        // in send_anpevents
+        wrapper.fWVC = pluginWidget->webViewCore();
+        wrapper.fPWA = pluginWidget;
         // make a copy of the event
-        wrapper->fEvent = *event;
-        JavaSharedClient::EnqueueFunctionPtr(send_anpevent, wrapper);
+        wrapper.fEvent = *event;
+
+        PendingANPEvents& pending = pendingEvents();
+        MutexLocker locker(pending.fLock);
+        // only the first event of a batch needs to schedule the delivery
+        if (pending.fEvents.isEmpty())
+            JavaSharedClient::EnqueueFunctionPtr(send_anpevents, 0);
+        pending.fEvents.append(wrapper);
     }
 }
 
@@ -23,10 +23,14 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include "config.h"
 #include "PluginDebugAndroid.h"
+
+#include "PluginWidgetAndroid.h"
 #include "utils/Log.h"
 #include "utils/SystemClock.h"
 #include <stdarg.h>
+#include <time.h>
 
 #define ARRAY_COUNT(array) static_cast<int32_t>(sizeof(array) / sizeof(array[0]))
 
@@ -53,6 +57,20 @@ static const char* const lifecycleActions[] = {
     "kOffScreen_ANPLifecycleAction"
 };
 
+double anp_threadCpuTime() {
+    struct timespec ts;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts))
+        return 0;
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+void anp_logPluginCpuUsage(void* npp, const ANPCpuUsage& usage) {
+    LOG_PRI(ANDROID_LOG_DEBUG, "webkit_plugin",
+            "%p CPU events=%u (%.1fms) timers=%u (%.1fms)", npp,
+            usage.eventCount, usage.eventTime * 1000,
+            usage.timerCount, usage.timerTime * 1000);
+}
+
 void anp_logPlugin(const char format[], ...) {
     va_list args;
     va_start(args, format);
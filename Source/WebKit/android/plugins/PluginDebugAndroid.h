@@ -28,6 +28,16 @@
 
 #include "android_npapi.h"
 
+struct ANPCpuUsage;
+
+/* Returns the CPU time consumed by the calling thread, in seconds.
+ */
+double anp_threadCpuTime();
+/* Logs the accumulated CPU usage of a plugin instance. Unlike the functions
+   below this is always available, so it can be used from release builds.
+ */
+void anp_logPluginCpuUsage(void* npp, const ANPCpuUsage& usage);
+
 // Define PLUGIN_DEBUG_LOCAL in an individual C++ file to enable for
 // that file only.
 
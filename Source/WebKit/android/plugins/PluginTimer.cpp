@@ -26,17 +26,38 @@
 
 #include "config.h"
 #include "PluginTimer.h"
+
+#include "PluginDebugAndroid.h"
+#include "PluginView.h"
+#include "PluginWidgetAndroid.h"
 #include "RefPtr.h"
+#include <wtf/CurrentTime.h>
+#include <math.h>
 
 namespace WebCore {
 
     static uint32_t gTimerID;
 
+    // Plugin timers are rounded up to a multiple of this many seconds so that
+    // a plugin juggling many short timers wakes the WebCore thread once per
+    // window rather than once per timer.
+    static const double gTimerSlack = 0.010;
+
+    static double coalescedInterval(double interval)
+    {
+        if (interval <= 0)
+            return 0;
+        double now = currentTime();
+        double fireTime = ceil((now + interval) / gTimerSlack) * gTimerSlack;
+        return fireTime - now;
+    }
+
     PluginTimer::PluginTimer(PluginTimer** list, NPP instance, bool repeat,
                              void (*timerFunc)(NPP npp, uint32_t timerID))
                 : m_list(list),
                   m_instance(instance),
                   m_timerFunc(timerFunc),
+                  m_interval(0),
                   m_repeat(repeat),
                   m_unscheduled(false)
     {
@@ -68,8 +89,22 @@ namespace WebCore {
         // ensure the timer cannot be deleted until this method completes
         RefPtr<PluginTimer> protector(this);
 
-        if (!m_unscheduled)
+        if (!m_unscheduled) {
+            double startTime = anp_threadCpuTime();
             m_timerFunc(m_instance, m_timerID);
+            // the plugin may have been destroyed by the callback, in which
+            // case the list has already dropped its reference
+            if (refCount() > 1) {
+                PluginView* view = static_cast<PluginView*>(m_instance->ndata);
+                if (view && view->platformPluginWidget())
+                    view->platformPluginWidget()->addTimerCpuTime(anp_threadCpuTime() - startTime);
+            }
+        }
+
+        // re-align repeating timers to the slack window so that they keep
+        // firing together instead of drifting apart
+        if (m_repeat && !m_unscheduled && refCount() > 1)
+            start(coalescedInterval(m_interval), m_interval);
 
         // remove the timer if it is a one-shot timer (!m_repeat) or if is a
         // repeating timer that has been unscheduled. In either case we must
@@ -81,6 +116,12 @@ namespace WebCore {
     }
     
     // may return null if timerID is not found
+    void PluginTimer::schedule(double interval)
+    {
+        m_interval = interval;
+        start(coalescedInterval(interval), m_repeat ? interval : 0);
+    }
+
     PluginTimer* PluginTimer::Find(PluginTimer* list, uint32_t timerID)
     {
         PluginTimer* curr = list;
@@ -110,13 +151,7 @@ namespace WebCore {
                                      void (*proc)(NPP npp, uint32_t timerID))
     {        
         PluginTimer* timer = new PluginTimer(&m_list, instance, repeat, proc);
-        
-        double dinterval = interval * 0.001;    // milliseconds to seconds
-        if (repeat) {
-            timer->startRepeating(dinterval);
-        } else {
-            timer->startOneShot(dinterval);
-        }
+        timer->schedule(interval * 0.001);    // milliseconds to seconds
         return timer->timerID();
     }
     
@@ -45,6 +45,9 @@ namespace WebCore {
     
         uint32_t timerID() const { return m_timerID; }
 
+        // starts the timer, firing at the end of the slack window that the
+        // interval (in seconds) falls into
+        void schedule(double interval);
         void unschedule() { m_unscheduled = true; }
 
         static PluginTimer* Find(PluginTimer* list, uint32_t timerID);
@@ -62,6 +65,7 @@ namespace WebCore {
         NPP             m_instance;
         void            (*m_timerFunc)(NPP, uint32_t);
         uint32_t          m_timerID;
+        double          m_interval;
         bool            m_repeat;
         bool            m_unscheduled;
     };
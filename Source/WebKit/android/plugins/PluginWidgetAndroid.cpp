@@ -44,6 +44,7 @@
 #include "WebViewCore.h"
 #include "android_graphics.h"
 #include <JNIUtility.h>
+#include <android/native_window.h>
 
 //#define PLUGIN_DEBUG_LOCAL // controls the printing of log messages
 #define DEBUG_EVENTS 0 // logs event contents, return value, and processing time
@@ -81,6 +82,8 @@ PluginWidgetAndroid::PluginWidgetAndroid(WebCore::PluginView* view)
 
 PluginWidgetAndroid::~PluginWidgetAndroid() {
     PLUGIN_LOG("%p Deleting Plugin", m_pluginView->instance());
+    if (m_cpuUsage.eventCount || m_cpuUsage.timerCount)
+        anp_logPluginCpuUsage(m_pluginView->instance(), m_cpuUsage);
     m_acceptEvents = false;
     if (m_core) {
         setPowerState(kDefault_ANPPowerState);
@@ -107,6 +110,9 @@ void PluginWidgetAndroid::init(android::WebViewCore* core) {
     m_core = core;
     m_core->addPlugin(this);
     m_acceptEvents = true;
+    updateLayer();
+    if (m_layer)
+        m_pluginView->getElement()->setNeedsStyleRecalc(SyntheticStyleChange);
     PLUGIN_LOG("%p Initialized Plugin", m_pluginView->instance());
 }
 
@@ -158,22 +164,32 @@ void PluginWidgetAndroid::setWindow(NPWindow* window, bool isTransparent) {
 
 bool PluginWidgetAndroid::setDrawingModel(ANPDrawingModel model) {
 
-    if (model == kOpenGL_ANPDrawingModel && m_layer == 0) {
+    if (m_drawingModel != model) {
+        m_drawingModel = model;
+        updateLayer();
+        // Trigger layer computation in RenderLayerCompositor
+        m_pluginView->getElement()->setNeedsStyleRecalc(SyntheticStyleChange);
+    }
+    return true;
+}
+
+// Bitmap and OpenGL plugins are composited into their own layer so that their
+// frames never have to be recorded into the page's picture. Surface plugins
+// are a separate java view and don't need one.
+void PluginWidgetAndroid::updateLayer() {
+    if (!m_core)
+        return;
+
+    bool needsLayer = m_drawingModel == kBitmap_ANPDrawingModel
+                      || m_drawingModel == kOpenGL_ANPDrawingModel;
+    if (needsLayer && m_layer == 0) {
         jobject webview = m_core->getWebViewJavaObject();
         m_layer = new WebCore::MediaLayer(webview);
     }
-    else if (model != kOpenGL_ANPDrawingModel && m_layer != 0) {
+    else if (!needsLayer && m_layer != 0) {
         m_layer->unref();
         m_layer = 0;
     }
-
-    if (m_drawingModel != model) {
-        // Trigger layer computation in RenderLayerCompositor
-        m_pluginView->getElement()->setNeedsStyleRecalc(SyntheticStyleChange);
-    }
-
-    m_drawingModel = model;
-    return true;
 }
 
 void PluginWidgetAndroid::checkSurfaceReady() {
@@ -182,6 +198,13 @@ void PluginWidgetAndroid::checkSurfaceReady() {
 
     m_drawEventDelayed = false;
     sendSizeAndVisibilityEvents(true);
+
+    // a bitmap frame was dropped while the layer had no content window, so
+    // ask the plugin for a fresh one
+    if (m_drawingModel == kBitmap_ANPDrawingModel && m_pluginWindow) {
+        inval(WebCore::IntRect(0, 0, m_pluginWindow->width,
+                               m_pluginWindow->height), true);
+    }
 }
 
 // returned rect is in the page coordinate
@@ -244,11 +267,20 @@ void PluginWidgetAndroid::draw(SkCanvas* canvas) {
             WebCore::PluginPackage* pkg = m_pluginView->plugin();
             NPP instance = m_pluginView->instance();
 
-            if (SkANP::SetBitmap(&event.data.draw.data.bitmap,
-                                 bitmap) &&
-                    pkg->pluginFuncs()->event(instance, &event)) {
+            if (!SkANP::SetBitmap(&event.data.draw.data.bitmap, bitmap))
+                break;
+
+            double cpuStartTime = anp_threadCpuTime();
+            int16_t handled = pkg->pluginFuncs()->event(instance, &event);
+            m_cpuUsage.eventTime += anp_threadCpuTime() - cpuStartTime;
+            m_cpuUsage.eventCount++;
 
-                if (canvas && m_pluginWindow) {
+            if (handled) {
+
+                if (m_layer) {
+                    if (!postBitmapToLayer(bitmap))
+                        m_drawEventDelayed = true;
+                } else if (canvas && m_pluginWindow) {
                     SkBitmap bm(bitmap);
                     bm.setPixelRef(m_flipPixelRef);
                     canvas->drawBitmap(bm, 0, 0);
@@ -261,6 +293,44 @@ void PluginWidgetAndroid::draw(SkCanvas* canvas) {
     }
 }
 
+bool PluginWidgetAndroid::postBitmapToLayer(const SkBitmap& bitmap) {
+    // the content window is created by the UI thread the first time the
+    // layer is drawn, so it may not exist yet
+    ANativeWindow* window = m_layer->acquireNativeWindowForContent();
+    if (!window)
+        return false;
+
+    int format = bitmap.config() == SkBitmap::kRGB_565_Config
+                 ? WINDOW_FORMAT_RGB_565 : WINDOW_FORMAT_RGBA_8888;
+    if (ANativeWindow_setBuffersGeometry(window, bitmap.width(),
+                                         bitmap.height(), format))
+        return false;
+
+    ANativeWindow_Buffer buffer;
+    if (ANativeWindow_lock(window, &buffer, 0))
+        return false;
+
+    SkAutoLockPixels lock(bitmap);
+    const int bytesPerPixel = bitmap.bytesPerPixel();
+    const int width = SkMin32(bitmap.width(), buffer.width);
+    const int height = SkMin32(bitmap.height(), buffer.height);
+    const uint8_t* src = static_cast<const uint8_t*>(bitmap.getPixels());
+    uint8_t* dst = static_cast<uint8_t*>(buffer.bits);
+    for (int row = 0; row < height; row++) {
+        memcpy(dst, src, width * bytesPerPixel);
+        src += bitmap.rowBytes();
+        dst += buffer.stride * bytesPerPixel;
+    }
+
+    ANativeWindow_unlockAndPost(window);
+    return true;
+}
+
+void PluginWidgetAndroid::addTimerCpuTime(double seconds) {
+    m_cpuUsage.timerTime += seconds;
+    m_cpuUsage.timerCount++;
+}
+
 void PluginWidgetAndroid::setSurfaceClip(const SkIRect& clip) {
 
     if (m_drawingModel != kSurface_ANPDrawingModel)
@@ -348,7 +418,10 @@ int16_t PluginWidgetAndroid::sendEvent(const ANPEvent& evt) {
         // make a localCopy since the actual plugin may not respect its constness,
         // and so we don't want our caller to have its param modified
         ANPEvent localCopy = evt;
+        double cpuStartTime = anp_threadCpuTime();
         int16_t result = pkg->pluginFuncs()->event(instance, &localCopy);
+        m_cpuUsage.eventTime += anp_threadCpuTime() - cpuStartTime;
+        m_cpuUsage.eventCount++;
 
 #if DEBUG_EVENTS
         SkMSec endTime = SkTime::GetMSecs();
@@ -425,6 +498,10 @@ void PluginWidgetAndroid::sendSizeAndVisibilityEvents(const bool updateDimension
 
         // change the visibility
         m_visible = visible;
+        // WebViewCore holds back redraws of off screen plugins, so catch up
+        // on anything the plugin invalidated while it was hidden
+        if (visible && isDirty())
+            m_core->invalPlugin(this);
         // send the event
         ANPEvent event;
         SkANP::InitEvent(&event, kLifecycle_ANPEventType);
@@ -43,9 +43,23 @@ namespace android {
     class WebViewCore;
 }
 
+class SkBitmap;
 class SkCanvas;
 class SkFlipPixelRef;
 
+/*
+    Time a plugin instance has kept the WebCore thread busy, split between its
+    event handler and its timer callbacks. Times are thread CPU seconds.
+ */
+struct ANPCpuUsage {
+    ANPCpuUsage() : eventTime(0), timerTime(0), eventCount(0), timerCount(0) {}
+
+    double      eventTime;
+    double      timerTime;
+    uint32_t    eventCount;
+    uint32_t    timerCount;
+};
+
 /*
     This is our extended state in a PluginView. This object is created and
     kept insync with the PluginView, but is also available to WebViewCore
@@ -83,6 +97,11 @@ struct PluginWidgetAndroid {
 
     bool isOpenGLDrawingModel() const { return kOpenGL_ANPDrawingModel == m_drawingModel; }
 
+    /*  Returns true if any part of the plugin intersects the visible portion
+        of the document.
+     */
+    bool isOnScreen() const { return m_visible; }
+
     void checkSurfaceReady();
 
     /*  Returns true (and optionally updates rect with the dirty bounds in the
@@ -95,8 +114,9 @@ struct PluginWidgetAndroid {
      */
     void inval(const WebCore::IntRect&, bool signalRedraw);
 
-    /*  Called to draw into the plugin's bitmap. If canvas is non-null, the
-        bitmap itself is then drawn into the canvas.
+    /*  Called to draw into the plugin's bitmap. If the plugin is composited
+        the bitmap is posted to its layer and canvas is ignored, otherwise if
+        canvas is non-null the bitmap itself is then drawn into the canvas.
      */
     void draw(SkCanvas* canvas = NULL);
 
@@ -183,10 +203,18 @@ struct PluginWidgetAndroid {
 
     void viewInvalidate();
 
+    /** Called by PluginTimer after running one of the plugin's timer callbacks.
+     */
+    void addTimerCpuTime(double seconds);
+
+    const ANPCpuUsage& cpuUsage() const { return m_cpuUsage; }
+
 private:
     void computeVisiblePluginRect();
     void scrollToVisiblePluginRect();
     void sendSizeAndVisibilityEvents(const bool updateDimensions);
+    void updateLayer();
+    bool postBitmapToLayer(const SkBitmap&);
 
     WebCore::MediaLayer*   m_layer;
 
@@ -210,6 +238,7 @@ private:
     ANPPowerState           m_powerState;
     int                     m_fullScreenOrientation;
     bool                    m_drawEventDelayed;
+    ANPCpuUsage             m_cpuUsage;
 
     /* We limit the number of rectangles to minimize storage and ensure adequate
        speed.
@@ -27,14 +27,23 @@
 #include "config.h"
 
 #include "AndroidLog.h"
+#include "BitmapAllocatorAndroid.h"
 #include "Command.h"
 #include "Connection.h"
 #include "DebugServer.h"
 #include "Frame.h"
+#include "MemoryUsage.h"
 #include "RenderTreeAsText.h"
 #include "RenderView.h"
+#include "TilesManager.h"
+#include "TraceEventAndroid.h"
 #include "WebViewCore.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
 #include <utils/Log.h>
+#include <wtf/CurrentTime.h>
 #include <wtf/text/CString.h>
 
 #if ENABLE(WDS)
@@ -73,6 +82,163 @@ static bool callDumpDomTree(const Frame* frame, const Connection* conn) {
     return true;
 }
 
+static bool callDumpFrameTimings(const Frame*, const Connection* conn) {
+#if USE(ACCELERATED_COMPOSITING)
+    CString str = TilesManager::instance()->frameTimings()->dump().latin1();
+    conn->write(str.data(), str.length());
+    return true;
+#else
+    return false;
+#endif
+}
+
+static bool callDumpMemory(const Frame* frame, const Connection* conn) {
+    MemoryUsageSnapshot snapshot;
+    MemoryUsage::takeSnapshot(const_cast<Frame*>(frame), &snapshot);
+    MemoryUsageSnapshot last;
+    MemoryUsageSnapshot previous;
+    MemoryUsage::lastSnapshots(&last, &previous);
+    CString str = snapshot.dump(previous.isEmpty() ? 0 : &previous).latin1();
+    conn->write(str.data(), str.length());
+    return true;
+}
+
+// Reads the line the client sends after the command. The client always
+// sends one, possibly empty.
+static bool readArgument(const Connection* conn, char* buf, size_t size) {
+    size_t length = 0;
+    char c;
+    while (length + 1 < size && conn->read(&c, 1) == 1 && c != '\n')
+        buf[length++] = c;
+    buf[length] = 0;
+    return length > 0;
+}
+
+static bool writeString(const Connection* conn, const String& str) {
+    CString data = str.latin1();
+    return conn->write(data.data(), data.length()) == static_cast<int>(data.length());
+}
+
+static String knobValues() {
+    String values;
+#if USE(ACCELERATED_COMPOSITING)
+    if (TilesManager::hardwareAccelerationEnabled()) {
+        TilesManager* manager = TilesManager::instance();
+        values += String::format("texture_budget_mb %d\n",
+                manager->textureBudget()->limit() / (1024 * 1024));
+        values += String::format("tile_prefetch_distance %d\n", manager->prefetchDistance());
+        values += String::format("tile_paint_threads %d\n", manager->paintThreadCount());
+    }
+#endif
+    return values;
+}
+
+// Argument "<name> <value>", the knobs are read again on the next frame or
+// decode. Without an argument, lists the current values.
+static bool callSetKnob(const Frame*, const Connection* conn) {
+    char arg[128];
+    char name[64];
+    int value;
+    if (!readArgument(conn, arg, sizeof(arg))
+            || sscanf(arg, "%63s %d", name, &value) != 2)
+        return writeString(conn, knobValues());
+
+    if (!strcmp(name, "image_cache_kb")) {
+        BitmapAllocatorAndroid::setCacheBudget(value * 1024);
+        return true;
+    }
+#if USE(ACCELERATED_COMPOSITING)
+    // The tiles knobs are plain values the UI thread reads as it draws.
+    if (!TilesManager::hardwareAccelerationEnabled())
+        return false;
+    TilesManager* manager = TilesManager::instance();
+    if (!strcmp(name, "texture_budget_mb"))
+        manager->textureBudget()->setLimit(value * 1024 * 1024);
+    else if (!strcmp(name, "tile_prefetch_distance"))
+        manager->setPrefetchDistance(value);
+    else if (!strcmp(name, "tile_paint_threads"))
+        manager->setPaintThreadCount(value);
+    else
+        return false;
+    return writeString(conn, knobValues());
+#else
+    return false;
+#endif
+}
+
+static void takeMemorySnapshot(void*) {
+    if (Frame* frame = server()->getFrame(0)) {
+        MemoryUsageSnapshot snapshot;
+        MemoryUsage::takeSnapshot(frame, &snapshot);
+    }
+}
+
+// Streams until the client disconnects, every interval (argument, in ms,
+// 500 by default) a batch of lines:
+//   trace <Chrome trace event JSON>, the V8 collections are "GC" in "v8"
+//   frame <FrameTimings record>
+//   memory <MemoryUsage entry>
+//   tick <ms since the stream started>
+// Tracing is turned on for as long as the stream runs.
+static bool callStream(const Frame*, const Connection* conn) {
+    char arg[32];
+    int intervalMs = readArgument(conn, arg, sizeof(arg)) ? atoi(arg) : 0;
+    if (intervalMs <= 0)
+        intervalMs = 500;
+
+    bool wasTracing = TraceEventAndroid::isEnabled();
+    TraceEventAndroid::setEnabled(true);
+    Vector<unsigned> traceCursor;
+    double lastFrameTime = currentTime();
+    double start = currentTimeMS();
+    bool connected = true;
+    while (connected) {
+        // The snapshot needs the WebCore thread, it is sent at the next tick.
+        callOnMainThread(takeMemorySnapshot, 0);
+        usleep(intervalMs * 1000);
+
+        String batch;
+        String events = TraceEventAndroid::takeNewEvents(&traceCursor);
+        for (unsigned begin = 0; begin < events.length(); ) {
+            size_t end = events.find('\n', begin);
+            batch += "trace ";
+            batch += events.substring(begin, end - begin + 1);
+            begin = end + 1;
+        }
+#if USE(ACCELERATED_COMPOSITING)
+        if (TilesManager::hardwareAccelerationEnabled()) {
+            FrameTimings* timings = TilesManager::instance()->frameTimings();
+            FrameTimingRecord record;
+            for (int i = 0; timings->frame(i, &record); i++) {
+                if (record.startTime <= lastFrameTime)
+                    continue;
+                lastFrameTime = record.startTime;
+                batch += String::format("frame %.3f draw %.2fms tiles %d missing %d painted %d"
+                                        " upload %dKb swap %d\n",
+                                        record.startTime, record.drawTime, record.tilesDrawn,
+                                        record.tilesMissing, record.tilesPainted,
+                                        record.uploadedBytes / 1024, record.treeSwapped);
+            }
+        }
+#endif
+        MemoryUsageSnapshot memory;
+        MemoryUsageSnapshot previous;
+        MemoryUsage::lastSnapshots(&memory, &previous);
+        String entries = memory.dump();
+        for (unsigned begin = 0; begin < entries.length(); ) {
+            size_t end = entries.find('\n', begin);
+            batch += "memory ";
+            batch += entries.substring(begin, end - begin + 1);
+            begin = end + 1;
+        }
+        batch += String::format("tick %.0f\n", currentTimeMS() - start);
+        connected = writeString(conn, batch);
+    }
+
+    TraceEventAndroid::setEnabled(wasTracing);
+    return true;
+}
+
 class WebCoreHandler : public Handler {
 public:
     virtual void post(TargetThreadFunction func, void* v) const {
@@ -81,6 +247,36 @@ public:
 };
 static WebCoreHandler s_webcoreHandler;
 
+// For the commands that block on the connection: each gets a thread of its
+// own, so that neither the WebCore thread nor the server loop waits on it.
+class DetachedThreadHandler : public Handler {
+public:
+    virtual void post(TargetThreadFunction func, void* v) const {
+        Task* task = new Task(func, v);
+        ThreadIdentifier thread = createThread(run, task, "WDS command");
+        if (thread)
+            detachThread(thread);
+        else {
+            delete task;
+            func(v);
+        }
+    }
+
+private:
+    struct Task {
+        Task(TargetThreadFunction func, void* v) : m_func(func), m_v(v) {}
+        TargetThreadFunction m_func;
+        void* m_v;
+    };
+    static void* run(void* v) {
+        Task* task = static_cast<Task*>(v);
+        task->m_func(task->m_v);
+        delete task;
+        return 0;
+    }
+};
+static DetachedThreadHandler s_detachedThreadHandler;
+
 //------------------------------------------------------------------------------
 // End command section
 //------------------------------------------------------------------------------
@@ -128,6 +324,14 @@ void Command::Init() {
                 callDumpDomTree, s_webcoreHandler));
     s_commands->append(new Command("DDRT", "Dump Render Tree",
                 callDumpRenderTree, s_webcoreHandler));
+    s_commands->append(new Command("DFTM", "Dump Frame Timings",
+                callDumpFrameTimings, s_webcoreHandler));
+    s_commands->append(new Command("DMEM", "Dump Memory Usage",
+                callDumpMemory, s_webcoreHandler));
+    s_commands->append(new Command("KNOB", "Set Runtime Knob",
+                callSetKnob, s_detachedThreadHandler));
+    s_commands->append(new Command("STRM", "Stream Performance Data",
+                callStream, s_detachedThreadHandler));
 }
 
 Command* Command::Find(const Connection* conn) {
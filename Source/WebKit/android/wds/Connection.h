@@ -57,7 +57,8 @@ public:
         return recv(m_socket.fd(), buf, length, 0);
     }
     int write(const char buf[], size_t length) const {
-        return send(m_socket.fd(), buf, length, 0);
+        // A client that went away must not kill the process with SIGPIPE.
+        return send(m_socket.fd(), buf, length, MSG_NOSIGNAL);
     }
     int write(const char buf[]) const {
         return write(buf, strlen(buf));
@@ -159,11 +159,23 @@ int main(int argc, char** argv) {
     // Send the command specified
     send(wdsFd, command, WDS_COMMAND_LENGTH, 0); // commands are 4 bytes
 
+    // Followed by its argument line, e.g. "KNOB texture_budget_mb 24" or
+    // "STRM 250". Commands without arguments ignore it.
+    for (int i = optind + 1; i < argc; i++) {
+        if (i > optind + 1)
+            send(wdsFd, " ", 1, 0);
+        send(wdsFd, argv[i], strlen(argv[i]), 0);
+    }
+    send(wdsFd, "\n", 1, 0);
+
     // Read and display the response
     char response[256];
     int res = 0;
-    while ((res = recv(wdsFd, response, sizeof(response), 0)) > 0)
+    while ((res = recv(wdsFd, response, sizeof(response), 0)) > 0) {
         printf("%.*s", res, response);
+        // STRM never ends, show its batches as they come
+        fflush(stdout);
+    }
     printf("\n\n");
 
     // Shutdown